@@ -28,7 +28,7 @@
 
 AIManager::AIManager()
 {
-
+	mPathingGraphView = std::make_shared<PathingGraphView>();
 } // LevelManager
 
 //-----------------------------------------------------------------------------
@@ -36,3 +36,16 @@ AIManager::~AIManager()
 {
 
 }// ~AIManager
+
+//-----------------------------------------------------------------------------
+void AIManager::BakePathingGraph(const std::shared_ptr<PathingGraph>& graph)
+{
+	// the view is replaced rather than rebuilt in place, so any simulation still
+	// running keeps the snapshot it loaded
+	std::shared_ptr<PathingGraphView> pathingGraphView;
+	if (graph)
+		pathingGraphView = std::make_shared<PathingGraphView>(graph);
+	else
+		pathingGraphView = std::make_shared<PathingGraphView>();
+	std::atomic_store(&mPathingGraphView, pathingGraphView);
+}// BakePathingGraph
@@ -19,6 +19,7 @@
 #include "GameEngineStd.h"
 
 #include "Pathing.h"
+#include "PathingGraphView.h"
 #include "KMeans.h"
 
 /*
@@ -37,11 +38,20 @@ public:
 
 	virtual void OnUpdate(unsigned long deltaMs) { }
 
-	const std::shared_ptr<PathingGraph>& GetPathingGraph() { return mPathingGraph; }
+	// the graph is published together with its view. Each call loads the current view, so
+	// threads which need both the graph and the view must take them from a single view.
+	std::shared_ptr<PathingGraph> GetPathingGraph() const { return GetPathingGraphView()->GetGraph(); }
+	// returns the current view of the pathing graph. It is republished by BakePathingGraph, so
+	// threads must hold on to the returned snapshot instead of reading the member again
+	std::shared_ptr<PathingGraphView> GetPathingGraphView() const { return std::atomic_load(&mPathingGraphView); }
 
 protected:
 
-	std::shared_ptr<PathingGraph> mPathingGraph;
+	// bakes the read-only view of the pathing graph used by the AI simulations and publishes
+	// the graph with it. It must be called whenever the pathing graph is loaded or modified.
+	void BakePathingGraph(const std::shared_ptr<PathingGraph>& graph);
+
+	std::shared_ptr<PathingGraphView> mPathingGraphView;
 
 };   // AIManager
 
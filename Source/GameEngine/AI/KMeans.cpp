@@ -39,104 +39,310 @@
 #include "KMeans.h"
 
 #include "Core/OS/OS.h"
+#include "Core/Threading/TaskScheduler.h"
 
-// return nearest cluster Id (uses euclidean distance)
-int KMeans::GetNearestClusterId(Point point)
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define KMEANS_SSE2
+#endif
+
+// number of points whose distances are computed together, two sse registers. The coordinate
+// arrays are padded to a multiple of it so that every block is full
+static const size_t KMEANS_BLOCK_SIZE = 8;
+
+// squared euclidean distances from a block of points to a center. The values of every dimension
+// are contiguous so each dimension of the block is loaded with two vector reads
+static void GetDistances(const float* values, size_t stride, size_t dimension,
+	const float* center, float* distances)
 {
-	float sum = 0.0;
-	for (int i = 0; i < (int)mDimension; i++)
-		sum += (float)pow(mClusters[0].GetCenter(i) - point.GetValue(i), 2.0);
+#if defined(KMEANS_SSE2)
+	__m128 distances0 = _mm_setzero_ps();
+	__m128 distances1 = _mm_setzero_ps();
+	for (size_t d = 0; d < dimension; d++)
+	{
+		const float* dimensionValues = values + d * stride;
+		__m128 centerValue = _mm_set1_ps(center[d]);
+		__m128 delta0 = _mm_sub_ps(_mm_loadu_ps(dimensionValues), centerValue);
+		__m128 delta1 = _mm_sub_ps(_mm_loadu_ps(dimensionValues + 4), centerValue);
+		distances0 = _mm_add_ps(distances0, _mm_mul_ps(delta0, delta0));
+		distances1 = _mm_add_ps(distances1, _mm_mul_ps(delta1, delta1));
+	}
+	_mm_storeu_ps(distances, distances0);
+	_mm_storeu_ps(distances + 4, distances1);
+#else
+	for (size_t p = 0; p < KMEANS_BLOCK_SIZE; p++)
+		distances[p] = 0.f;
 
-	int nearestClusterId = 0;
-	float minDist = sqrt(sum);
-	for (int i = 1; i < mK; i++)
+	for (size_t d = 0; d < dimension; d++)
 	{
-		sum = 0.0;
-		for (int j = 0; j < (int)mDimension; j++)
-			sum += (float)pow(mClusters[i].GetCenter(j) - point.GetValue(j), 2.0);
+		const float* dimensionValues = values + d * stride;
+		for (size_t p = 0; p < KMEANS_BLOCK_SIZE; p++)
+		{
+			float delta = dimensionValues[p] - center[d];
+			distances[p] += delta * delta;
+		}
+	}
+#endif
+}
 
-		float dist = sqrt(sum);
-		if (dist < minDist)
+// nearest center of each point of a block. The distances stay in registers while the centers
+// are visited and the comparison is done without branches, the first nearest center wins
+static void GetNearestCenters(const float* values, size_t stride, size_t dimension,
+	const float* centers, int totalCenters, int* nearestCenters)
+{
+#if defined(KMEANS_SSE2)
+	__m128 nearestDistances0 = _mm_set1_ps(FLT_MAX);
+	__m128 nearestDistances1 = _mm_set1_ps(FLT_MAX);
+	__m128i nearestCenters0 = _mm_setzero_si128();
+	__m128i nearestCenters1 = _mm_setzero_si128();
+	for (int c = 0; c < totalCenters; c++)
+	{
+		const float* center = centers + c * dimension;
+		__m128 distances0 = _mm_setzero_ps();
+		__m128 distances1 = _mm_setzero_ps();
+		for (size_t d = 0; d < dimension; d++)
 		{
-			minDist = dist;
-			nearestClusterId = i;
+			const float* dimensionValues = values + d * stride;
+			__m128 centerValue = _mm_set1_ps(center[d]);
+			__m128 delta0 = _mm_sub_ps(_mm_loadu_ps(dimensionValues), centerValue);
+			__m128 delta1 = _mm_sub_ps(_mm_loadu_ps(dimensionValues + 4), centerValue);
+			distances0 = _mm_add_ps(distances0, _mm_mul_ps(delta0, delta0));
+			distances1 = _mm_add_ps(distances1, _mm_mul_ps(delta1, delta1));
 		}
+
+		__m128i centerId = _mm_set1_epi32(c);
+		__m128i nearer0 = _mm_castps_si128(_mm_cmplt_ps(distances0, nearestDistances0));
+		__m128i nearer1 = _mm_castps_si128(_mm_cmplt_ps(distances1, nearestDistances1));
+		nearestCenters0 = _mm_or_si128(
+			_mm_and_si128(nearer0, centerId), _mm_andnot_si128(nearer0, nearestCenters0));
+		nearestCenters1 = _mm_or_si128(
+			_mm_and_si128(nearer1, centerId), _mm_andnot_si128(nearer1, nearestCenters1));
+		nearestDistances0 = _mm_min_ps(distances0, nearestDistances0);
+		nearestDistances1 = _mm_min_ps(distances1, nearestDistances1);
+	}
+	_mm_storeu_si128((__m128i*)nearestCenters, nearestCenters0);
+	_mm_storeu_si128((__m128i*)(nearestCenters + 4), nearestCenters1);
+#else
+	float nearestDistances[KMEANS_BLOCK_SIZE];
+	for (size_t p = 0; p < KMEANS_BLOCK_SIZE; p++)
+	{
+		nearestDistances[p] = FLT_MAX;
+		nearestCenters[p] = 0;
 	}
 
-	return nearestClusterId;
+	for (int c = 0; c < totalCenters; c++)
+	{
+		float distances[KMEANS_BLOCK_SIZE];
+		GetDistances(values, stride, dimension, centers + c * dimension, distances);
+		for (size_t p = 0; p < KMEANS_BLOCK_SIZE; p++)
+		{
+			bool nearer = distances[p] < nearestDistances[p];
+			nearestCenters[p] = nearer ? c : nearestCenters[p];
+			nearestDistances[p] = nearer ? distances[p] : nearestDistances[p];
+		}
+	}
+#endif
 }
 
-void KMeans::Run(std::vector<Point> & points)
+void KMeans::InitializeCenters()
 {
-	mTotalPoints = points.size();
-	mDimension = points[0].GetDimension();
+	size_t blocks = mStride / KMEANS_BLOCK_SIZE;
 
-	//Initializing Clusters
-	std::vector<int> usedPointIds;
+	// squared distance from each point to its nearest center and their sum per block
+	std::vector<float> distances(mStride, FLT_MAX);
+	std::vector<double> blockSums(blocks);
 
-	for (int i = 0; i < mK; i++)
+	// the first center is a random point, the next ones are points picked with a probability
+	// proportional to their squared distance to the nearest center already chosen
+	size_t index = Randomizer::Rand() % mTotalPoints;
+	for (int c = 0; c < mK; c++)
 	{
-		while (true)
+		float* center = &mCenters[c * mDimension];
+		for (size_t d = 0; d < mDimension; d++)
+			center[d] = mValues[d * mStride + index];
+
+		if (c + 1 == mK)
+			break;
+
+		ParallelFor(size_t(0), blocks, [&](size_t block)
 		{
-			int index = Randomizer::Rand() % mTotalPoints;
+			size_t first = block * KMEANS_BLOCK_SIZE;
+			size_t count = std::min(KMEANS_BLOCK_SIZE, mTotalPoints - first);
 
-			if (std::find(usedPointIds.begin(), usedPointIds.end(), index) == usedPointIds.end())
+			float blockDistances[KMEANS_BLOCK_SIZE];
+			GetDistances(&mValues[first], mStride, mDimension, center, blockDistances);
+
+			double sum = 0.0;
+			for (size_t p = 0; p < count; p++)
 			{
-				usedPointIds.push_back(index);
-				points[index].SetCluster(i);
-				Clustering cluster(i, points[index]);
-				mClusters.push_back(cluster);
-				break;
+				distances[first + p] = std::min(distances[first + p], blockDistances[p]);
+				sum += distances[first + p];
 			}
+			blockSums[block] = sum;
+		});
+
+		double sum = 0.0;
+		for (size_t block = 0; block < blocks; block++)
+			sum += blockSums[block];
+
+		if (sum <= 0.0)
+		{
+			// every point lies on a center already
+			index = Randomizer::Rand() % mTotalPoints;
+			continue;
 		}
+
+		double target = Randomizer::FRand() * sum;
+		size_t block = 0;
+		for (; block + 1 < blocks && target >= blockSums[block]; block++)
+			target -= blockSums[block];
+
+		size_t first = block * KMEANS_BLOCK_SIZE;
+		size_t last = std::min(first + KMEANS_BLOCK_SIZE, mTotalPoints);
+		for (index = first; index + 1 < last && target >= distances[index]; index++)
+			target -= distances[index];
+
+		// rounding may leave us on a point which is a center already
+		while (distances[index] <= 0.f && index > 0)
+			index--;
 	}
+}
 
-	printf("\nClusters initialized = %u", (unsigned int)mClusters.size());
-	printf("\nRunning K-Means Clustering..\n");
+size_t KMeans::AssignPoints()
+{
+	size_t blocks = mStride / KMEANS_BLOCK_SIZE;
+	size_t chunks = std::min(blocks, (size_t)(4 * TaskScheduler::Get()->GetConcurrency()));
+	size_t chunkBlocks = (blocks + chunks - 1) / chunks;
 
-	int iter = 1;
-	while (true)
+	// every chunk gathers the changes of the cluster sums and sizes of its points,
+	// they are merged once all the chunks are done
+	size_t sumSize = mK * mDimension;
+	std::vector<double> chunkSums(chunks * sumSize, 0.0);
+	std::vector<int> chunkSizes(chunks * mK, 0);
+	std::vector<size_t> chunkMoves(chunks, 0);
+
+	ParallelFor(size_t(0), chunks, [&](size_t chunk)
 	{
-		bool done = true;
+		double* sums = &chunkSums[chunk * sumSize];
+		int* sizes = &chunkSizes[chunk * mK];
 
-		// associates each point to the nearest center
-		for (int i = 0; i < (int)mTotalPoints; i++)
+		int nearestClusterIds[KMEANS_BLOCK_SIZE];
+		size_t lastBlock = std::min(blocks, (chunk + 1) * chunkBlocks);
+		for (size_t block = chunk * chunkBlocks; block < lastBlock; block++)
 		{
-			int currentClusterId = points[i].GetCluster();
-			int nearestClusterId = GetNearestClusterId(points[i]);
+			size_t first = block * KMEANS_BLOCK_SIZE;
+			size_t count = std::min(KMEANS_BLOCK_SIZE, mTotalPoints - first);
+			GetNearestCenters(&mValues[first], mStride, mDimension, &mCenters[0], mK, nearestClusterIds);
 
-			if (currentClusterId != nearestClusterId)
+			for (size_t p = 0; p < count; p++)
 			{
+				size_t point = first + p;
+				int currentClusterId = mAssignments[point];
+				int nearestClusterId = nearestClusterIds[p];
+				if (currentClusterId == nearestClusterId)
+					continue;
+
 				if (currentClusterId != -1)
-					mClusters[currentClusterId].RemovePoint(points[i].GetId());
+				{
+					sizes[currentClusterId]--;
+					for (size_t d = 0; d < mDimension; d++)
+						sums[currentClusterId * mDimension + d] -= mValues[d * mStride + point];
+				}
+
+				sizes[nearestClusterId]++;
+				for (size_t d = 0; d < mDimension; d++)
+					sums[nearestClusterId * mDimension + d] += mValues[d * mStride + point];
 
-				points[i].SetCluster(nearestClusterId);
-				mClusters[nearestClusterId].AddPoint(points[i]);
-				done = false;
+				mAssignments[point] = nearestClusterId;
+				chunkMoves[chunk]++;
 			}
 		}
+	}, 1);
 
-		// recalculating the center of each cluster
-		for (int i = 0; i < mK; i++)
+	size_t moves = 0;
+	for (size_t chunk = 0; chunk < chunks; chunk++)
+	{
+		for (size_t i = 0; i < sumSize; i++)
+			mSums[i] += chunkSums[chunk * sumSize + i];
+		for (int c = 0; c < mK; c++)
+			mSizes[c] += chunkSizes[chunk * mK + c];
+		moves += chunkMoves[chunk];
+	}
+	return moves;
+}
+
+void KMeans::UpdateCenters()
+{
+	// empty clusters keep their center
+	for (int c = 0; c < mK; c++)
+	{
+		if (mSizes[c] > 0)
 		{
-			int clusterSize = (int)mClusters[i].GetSize();
-			for (int j = 0; j < (int)mDimension; j++)
-			{
-				float sum = 0.0;
-				if (clusterSize > 0)
-				{
-					for (int p = 0; p < clusterSize; p++)
-						sum += mClusters[i].GetPoint(p).GetValue(j);
-					mClusters[i].SetCenter(j, sum / clusterSize);
-				}
-			}
+			for (size_t d = 0; d < mDimension; d++)
+				mCenters[c * mDimension + d] = (float)(mSums[c * mDimension + d] / mSizes[c]);
 		}
+	}
+}
+
+void KMeans::Run(std::vector<Point> & points)
+{
+	mClusters.clear();
 
-		if (done == true || iter >= mIterations)
+	mTotalPoints = points.size();
+	if (mTotalPoints == 0)
+		return;
+
+	mDimension = points[0].GetDimension();
+	if (mK > (int)mTotalPoints)
+	{
+		LogWarning("More clusters than points, the number of clusters is reduced");
+		mK = (int)mTotalPoints;
+	}
+
+	mStride = (mTotalPoints + KMEANS_BLOCK_SIZE - 1) / KMEANS_BLOCK_SIZE * KMEANS_BLOCK_SIZE;
+	mValues.assign(mDimension * mStride, 0.f);
+	for (size_t p = 0; p < mTotalPoints; p++)
+		for (size_t d = 0; d < mDimension; d++)
+			mValues[d * mStride + p] = points[p].GetValue((int)d);
+
+	mCenters.assign(mK * mDimension, 0.f);
+	mSums.assign(mK * mDimension, 0.0);
+	mSizes.assign(mK, 0);
+	mAssignments.assign(mTotalPoints, -1);
+
+	//Initializing Clusters
+	InitializeCenters();
+
+	printf("\nClusters initialized = %u", (unsigned int)mK);
+	printf("\nRunning K-Means Clustering..\n");
+
+	int iter = 1;
+	while (true)
+	{
+		// associates each point to the nearest center
+		size_t moves = AssignPoints();
+
+		// recalculating the center of each cluster
+		UpdateCenters();
+
+		if (moves == 0 || iter >= mIterations)
 		{
 			printf("Break in iteration %i\n\n", iter);
 			break;
 		}
 		iter++;
 	}
+
+	for (int c = 0; c < mK; c++)
+	{
+		std::vector<float> centers(
+			mCenters.begin() + c * mDimension, mCenters.begin() + (c + 1) * mDimension);
+		mClusters.push_back(Clustering(c, centers));
+	}
+
+	for (size_t p = 0; p < mTotalPoints; p++)
+	{
+		points[p].SetCluster(mAssignments[p]);
+		mClusters[mAssignments[p]].AddPoint(points[p]);
+	}
 }
\ No newline at end of file
@@ -58,11 +58,11 @@ public:
 		mClusterId = -1;
 	}
 
-	int GetId() { return mPointId; }
-	size_t GetDimension() { return mDimension; }
-	int GetCluster() { return mClusterId; }
+	int GetId() const { return mPointId; }
+	size_t GetDimension() const { return mDimension; }
+	int GetCluster() const { return mClusterId; }
 	void SetCluster(int clusterId) { mClusterId = clusterId; }
-	float GetValue(int index) { return mValues[index]; }
+	float GetValue(int index) const { return mValues[index]; }
 	void AddValue(float value) { mValues.push_back(value); }
 
 private:
@@ -86,9 +86,15 @@ public:
 		mPoints.push_back(point);
 	}
 
-	int GetId() { return mClusterId; }
+	Clustering(int clusterId, const std::vector<float>& centers)
+	{
+		mClusterId = clusterId;
+		mCenters = centers;
+	}
 
-	void AddPoint(Point point) { mPoints.push_back(point); }
+	int GetId() const { return mClusterId; }
+
+	void AddPoint(const Point& point) { mPoints.push_back(point); }
 	bool RemovePoint(int pointId)
 	{
 		for (unsigned int i = 0; i < mPoints.size(); i++)
@@ -102,11 +108,11 @@ public:
 		return false;
 	}
 
-	float GetCenter(int index) { return mCenters[index]; }
+	float GetCenter(int index) const { return mCenters[index]; }
 	void SetCenter(int index, float value) { mCenters[index] = value; }
 
-	Point GetPoint(int index) { return mPoints[index]; }
-	size_t GetSize() { return mPoints.size(); }
+	const Point& GetPoint(int index) const { return mPoints[index]; }
+	size_t GetSize() const { return mPoints.size(); }
 
 private:
 	int mClusterId;
@@ -115,6 +121,13 @@ private:
 
 };
 
+/*
+	KMeans clusters the points with Lloyd's algorithm. The coordinates are copied into a structure
+	of arrays, one contiguous array per dimension, so that the distances from a block of points to a
+	center are computed by loops the compiler vectorizes. The initial centers are picked with the
+	k-means++ seeding, the points are assigned in parallel and the centers are updated incrementally
+	from the points which changed cluster. The clusters are only built once the algorithm converges.
+*/
 class KMeans
 {
 
@@ -138,8 +151,27 @@ private:
 	int mIterations; 
 	std::vector<Clustering> mClusters;
 
-	// return nearest cluster Id (uses euclidean distance)
-	int GetNearestClusterId(Point point);
+	// point coordinates, the value of dimension d of point p is at d * mStride + p. The stride
+	// is the number of points rounded up to a whole block of the distance kernels
+	std::vector<float> mValues;
+	size_t mStride;
+
+	// cluster centers, the value of dimension d of cluster c is at c * mDimension + d
+	std::vector<float> mCenters;
+
+	// coordinate sums and sizes of the clusters, kept up to date as the points move
+	std::vector<double> mSums;
+	std::vector<unsigned int> mSizes;
+
+	std::vector<int> mAssignments;
+
+	// picks the initial centers with the k-means++ seeding
+	void InitializeCenters();
+
+	// associates each point to the nearest center and returns how many points moved
+	size_t AssignPoints();
+
+	void UpdateCenters();
 
 };
 
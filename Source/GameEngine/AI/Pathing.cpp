@@ -40,11 +40,8 @@
 #include "Pathing.h"
 
 #include "Core/OS/OS.h"
-
-#include <ppl.h>
-
-#include <concurrent_vector.h>
-#include <concurrent_unordered_map.h>
+#include "Core/Threading/TaskScheduler.h"
+#include "Core/Threading/ConcurrentContainers.h"
 
 //--------------------------------------------------------------------------------------------------------
 // Cluster
@@ -278,10 +275,10 @@ void PathingNode::GetClusters(unsigned int pathingType, PathingClusterVec& outCl
 void PathingNode::GetClusters(unsigned int pathingType, unsigned int clusterLimit, 
 	std::map<PathingCluster*, PathingArcVec>& clusterPaths, std::multimap<float, PathingCluster*>& clusterPathWeights)
 {
-	Concurrency::concurrent_unordered_multimap<float, PathingCluster*> clusterPathWeightsLimit;
-	Concurrency::concurrent_unordered_map<PathingCluster*, PathingArcVec> clusterPathsLimit;
+	ConcurrentUnorderedMultimap<float, PathingCluster*> clusterPathWeightsLimit;
+	ConcurrentUnorderedMap<PathingCluster*, PathingArcVec> clusterPathsLimit;
 
-	Concurrency::parallel_for_each(mClusters.begin(), mClusters.end(), [&](auto& cluster)
+	ParallelForEach(mClusters.begin(), mClusters.end(), [&](auto& cluster)
 	//for (itCluster = mClusters.begin(); itCluster != mClusters.end(); itCluster++)
 	{
 		if (cluster.second->GetType() != pathingType)
@@ -320,10 +317,10 @@ void PathingNode::GetClusters(unsigned int pathingType, unsigned int clusterLimi
 void PathingNode::GetClusters(unsigned int pathingType, unsigned int clusterLimit, 
 	std::map<PathingCluster*, PathingArcVec>& clusterPaths, std::map<PathingCluster*, float>& clusterPathWeights)
 {
-	Concurrency::concurrent_unordered_multimap<float, PathingCluster*> clusterPathWeightsLimit;
-	Concurrency::concurrent_unordered_map<PathingCluster*, PathingArcVec> clusterPathsLimit;
+	ConcurrentUnorderedMultimap<float, PathingCluster*> clusterPathWeightsLimit;
+	ConcurrentUnorderedMap<PathingCluster*, PathingArcVec> clusterPathsLimit;
 
-	Concurrency::parallel_for_each(mClusters.begin(), mClusters.end(), [&](auto& cluster)
+	ParallelForEach(mClusters.begin(), mClusters.end(), [&](auto& cluster)
 	//for (itCluster = mClusters.begin(); itCluster != mClusters.end(); itCluster++)
 	{
 		if (cluster.second->GetType() != pathingType)
@@ -493,6 +490,13 @@ void PathPlan::AddArc(PathingArc* pArc)
 //--------------------------------------------------------------------------------------------------------
 // PathPlanNode
 //--------------------------------------------------------------------------------------------------------
+PathPlanNode::PathPlanNode(void)
+	: mPrevNode(NULL), mPathingArc(NULL), mPathingNode(NULL), mGoalNode(NULL), 
+	mClosed(false), mGoal(0), mOpenIndex(-1), mSequence(0)
+{
+
+}
+
 PathPlanNode::PathPlanNode(PathingArc* pArc, PathPlanNode* pPrevNode, PathingNode* pGoalNode)
 {
 	LogAssert(pArc, "Invalid arc");
@@ -502,6 +506,8 @@ PathPlanNode::PathPlanNode(PathingArc* pArc, PathPlanNode* pPrevNode, PathingNod
 	mPrevNode = pPrevNode;  // NULL is a valid value, though it should only be NULL for the start node
 	mGoalNode = pGoalNode;
 	mClosed = false;
+	mOpenIndex = -1;
+	mSequence = 0;
 	UpdatePathCost();
 }
 
@@ -514,6 +520,8 @@ PathPlanNode::PathPlanNode(PathingNode* pNode, PathPlanNode* pPrevNode, PathingN
 	mPrevNode = pPrevNode;  // NULL is a valid value, though it should only be NULL for the start node
 	mGoalNode = pGoalNode;
 	mClosed = false;
+	mOpenIndex = -1;
+	mSequence = 0;
 	UpdatePathCost();
 }
 
@@ -541,6 +549,10 @@ void PathPlanNode::UpdatePathCost(void)
 //--------------------------------------------------------------------------------------------------------
 PathFinder::PathFinder(void)
 {
+	mGeneration = 0;
+	mPlanNodeCount = 0;
+	mSequence = 0;
+
 	mStartNode = NULL;
 	mGoalNode = NULL;
 }
@@ -552,19 +564,67 @@ PathFinder::~PathFinder(void)
 
 void PathFinder::Destroy(void)
 {
-	// destroy all the PathPlanNode objects and clear the map
-	for (PathingNodeToPathPlanNodeMap::iterator it = mNodes.begin(); it != mNodes.end(); ++it)
-		delete it->second;
-	mNodes.clear();
-	
+	// release the PathPlanNode pool and the search states
+	mPlanNodePool.clear();
+	mPlanNodeCount = 0;
+
+	mSearchStates.clear();
+	mGeneration = 0;
+
 	// clear the open set
 	mOpenSet.clear();
+	mSequence = 0;
 	
 	// clear the start & goal nodes
 	mStartNode = NULL;
 	mGoalNode = NULL;
 }
 
+void PathFinder::Reset(void)
+{
+	// starting a new generation invalidates every search state from the previous search,
+	// the pooled memory is kept for reuse
+	if (++mGeneration == 0)
+	{
+		for (SearchState& searchState : mSearchStates)
+			searchState.mGeneration = 0;
+		mGeneration = 1;
+	}
+	mPlanNodeCount = 0;
+
+	mOpenSet.clear();
+	mSequence = 0;
+
+	mStartNode = NULL;
+	mGoalNode = NULL;
+}
+
+PathPlanNode* PathFinder::FindPlanNode(PathingNode* pNode)
+{
+	unsigned int nodeId = pNode->GetId();
+	if (nodeId < mSearchStates.size() && mSearchStates[nodeId].mGeneration == mGeneration)
+		return mSearchStates[nodeId].mPlanNode;
+
+	return NULL;
+}
+
+PathPlanNode* PathFinder::CreatePlanNode(PathingNode* pNode)
+{
+	unsigned int chunk = mPlanNodeCount / PATHING_PLAN_NODE_POOL_CHUNK;
+	if (chunk == mPlanNodePool.size())
+		mPlanNodePool.emplace_back(new PathPlanNode[PATHING_PLAN_NODE_POOL_CHUNK]);
+	PathPlanNode* pPlanNode = &mPlanNodePool[chunk][mPlanNodeCount % PATHING_PLAN_NODE_POOL_CHUNK];
+	mPlanNodeCount++;
+
+	unsigned int nodeId = pNode->GetId();
+	if (nodeId >= mSearchStates.size())
+		mSearchStates.resize(nodeId + 1, SearchState{ 0, NULL });
+	mSearchStates[nodeId].mGeneration = mGeneration;
+	mSearchStates[nodeId].mPlanNode = pPlanNode;
+
+	return pPlanNode;
+}
+
 //
 // PathFinder::operator()					- Chapter 18, page 638
 //
@@ -578,6 +638,7 @@ PathPlan* PathFinder::operator()(PathingNode* pStartNode, PathingNode* pGoalNode
 		return NULL;
 
 	// set our members
+	Reset();
 	mStartNode = pStartNode;
 	mGoalNode = pGoalNode;
 		
@@ -596,27 +657,27 @@ PathPlan* PathFinder::operator()(PathingNode* pStartNode, PathingNode* pGoalNode
 			return RebuildPath(planNode);
 
 		// we're processing this node so remove it from the open set and add it to the closed set
-		mOpenSet.pop_front();
+		PopNode();
 		AddToClosedSet(planNode);
 
 		// get the neighboring nodes
-		PathingArcVec neighbors;
-		planNode->GetPathingNode()->GetArcs(AT_NORMAL, neighbors);
-		planNode->GetPathingNode()->GetArcs(AT_ACTION, neighbors);
+		mNeighbors.clear();
+		planNode->GetPathingNode()->GetArcs(AT_NORMAL, mNeighbors);
+		planNode->GetPathingNode()->GetArcs(AT_ACTION, mNeighbors);
 
 		// loop though all the neighboring nodes and evaluate each one
-		for (PathingArcVec::iterator it = neighbors.begin(); it != neighbors.end(); ++it)
+		for (PathingArcVec::iterator it = mNeighbors.begin(); it != mNeighbors.end(); ++it)
 		{
 			if (skipArc == (*it)->GetType()) continue;
 
 			PathingNode* pNodeToEvaluate = (*it)->GetNode();
 
 			// Try and find a PathPlanNode object for this node.
-			PathingNodeToPathPlanNodeMap::iterator findIt = mNodes.find(pNodeToEvaluate);
+			PathPlanNode* pPathPlanNodeToEvaluate = FindPlanNode(pNodeToEvaluate);
 			
 			// If one exists and it's in the closed list, we've already evaluated the node.  We can
 			// safely skip it.
-			if (findIt != mNodes.end() && findIt->second->IsClosed())
+			if (pPathPlanNodeToEvaluate && pPathPlanNodeToEvaluate->IsClosed())
 				continue;
 
 			// figure out the cost for this route through the node
@@ -626,11 +687,6 @@ PathPlan* PathFinder::operator()(PathingNode* pStartNode, PathingNode* pGoalNode
 
 			bool isPathBetter = false;
 
-			// Grab the PathPlanNode if there is one.
-			PathPlanNode* pPathPlanNodeToEvaluate = NULL;
-			if (findIt != mNodes.end())
-				pPathPlanNodeToEvaluate = findIt->second;
-
 			// No PathPlanNode means we've never evaluated this pathing node so we need to add it to 
 			// the open set, which has the side effect of setting all the cost data.
 			if (!pPathPlanNodeToEvaluate)
@@ -662,6 +718,7 @@ PathPlan* PathFinder::operator()(PathingNode* pStartNode, PathingNodeVec& search
 	LogAssert(pStartNode, "Invalid node");
 
 	// set our members
+	Reset();
 	mStartNode = pStartNode;
 	mGoalNode = NULL;
 
@@ -691,27 +748,27 @@ PathPlan* PathFinder::operator()(PathingNode* pStartNode, PathingNodeVec& search
 		}
 
 		// we're processing this node so remove it from the open set and add it to the closed set
-		mOpenSet.pop_front();
+		PopNode();
 		AddToClosedSet(planNode);
 
 		// get the neighboring nodes
-		PathingArcVec neighbors;
-		planNode->GetPathingNode()->GetArcs(AT_NORMAL, neighbors);
-		planNode->GetPathingNode()->GetArcs(AT_ACTION, neighbors);
+		mNeighbors.clear();
+		planNode->GetPathingNode()->GetArcs(AT_NORMAL, mNeighbors);
+		planNode->GetPathingNode()->GetArcs(AT_ACTION, mNeighbors);
 
 		// loop though all the neighboring nodes and evaluate each one
-		for (PathingArcVec::iterator it = neighbors.begin(); it != neighbors.end(); ++it)
+		for (PathingArcVec::iterator it = mNeighbors.begin(); it != mNeighbors.end(); ++it)
 		{
 			if (skipArc == (*it)->GetType()) continue;
 
 			PathingNode* pNodeToEvaluate = (*it)->GetNode();
 
 			// Try and find a PathPlanNode object for this node.
-			PathingNodeToPathPlanNodeMap::iterator findIt = mNodes.find(pNodeToEvaluate);
+			PathPlanNode* pPathPlanNodeToEvaluate = FindPlanNode(pNodeToEvaluate);
 
 			// If one exists and it's in the closed list, we've already evaluated the node.  We can
 			// safely skip it.
-			if (findIt != mNodes.end() && findIt->second->IsClosed())
+			if (pPathPlanNodeToEvaluate && pPathPlanNodeToEvaluate->IsClosed())
 				continue;
 
 			// figure out the cost for this route through the node
@@ -723,10 +780,6 @@ PathPlan* PathFinder::operator()(PathingNode* pStartNode, PathingNodeVec& search
 				continue;
 
 			bool isPathBetter = false;
-			// Grab the PathPlanNode if there is one.
-			PathPlanNode* pPathPlanNodeToEvaluate = NULL;
-			if (findIt != mNodes.end())
-				pPathPlanNodeToEvaluate = findIt->second;
 
 			// No PathPlanNode means we've never evaluated this pathing node so we need to add it to 
 			// the open set, which has the side effect of setting all the cost data.
@@ -757,6 +810,7 @@ void PathFinder::operator()(PathingNode* pStartNode,
 	LogAssert(pStartNode, "Invalid node");
 
 	// set our members
+	Reset();
 	mStartNode = pStartNode;
 	mGoalNode = NULL;
 
@@ -787,27 +841,27 @@ void PathFinder::operator()(PathingNode* pStartNode,
 		}
 
 		// we're processing this node so remove it from the open set and add it to the closed set
-		mOpenSet.pop_front();
+		PopNode();
 		AddToClosedSet(planNode);
 
 		// get the neighboring nodes
-		PathingArcVec neighbors;
-		planNode->GetPathingNode()->GetArcs(AT_NORMAL, neighbors);
-		planNode->GetPathingNode()->GetArcs(AT_ACTION, neighbors);
+		mNeighbors.clear();
+		planNode->GetPathingNode()->GetArcs(AT_NORMAL, mNeighbors);
+		planNode->GetPathingNode()->GetArcs(AT_ACTION, mNeighbors);
 
 		// loop though all the neighboring nodes and evaluate each one
-		for (PathingArcVec::iterator it = neighbors.begin(); it != neighbors.end(); ++it)
+		for (PathingArcVec::iterator it = mNeighbors.begin(); it != mNeighbors.end(); ++it)
 		{
 			if (skipArc == (*it)->GetType()) continue;
 
 			PathingNode* pNodeToEvaluate = (*it)->GetNode();
 
 			// Try and find a PathPlanNode object for this node.
-			PathingNodeToPathPlanNodeMap::iterator findIt = mNodes.find(pNodeToEvaluate);
+			PathPlanNode* pPathPlanNodeToEvaluate = FindPlanNode(pNodeToEvaluate);
 
 			// If one exists and it's in the closed list, we've already evaluated the node.  We can
 			// safely skip it.
-			if (findIt != mNodes.end() && findIt->second->IsClosed())
+			if (pPathPlanNodeToEvaluate && pPathPlanNodeToEvaluate->IsClosed())
 				continue;
 
 			// figure out the cost for this route through the node
@@ -816,10 +870,6 @@ void PathFinder::operator()(PathingNode* pStartNode,
 				continue;
 
 			bool isPathBetter = false;
-			// Grab the PathPlanNode if there is one.
-			PathPlanNode* pPathPlanNodeToEvaluate = NULL;
-			if (findIt != mNodes.end())
-				pPathPlanNodeToEvaluate = findIt->second;
 
 			// No PathPlanNode means we've never evaluated this pathing node so we need to add it to 
 			// the open set, which has the side effect of setting all the cost data.
@@ -851,6 +901,7 @@ void PathFinder::operator()(PathingNode* pStartNode,
 	LogAssert(pStartNode, "Invalid node");
 
 	// set our members
+	Reset();
 	mStartNode = pStartNode;
 	mGoalNode = NULL;
 
@@ -895,27 +946,27 @@ void PathFinder::operator()(PathingNode* pStartNode,
 		}
 
 		// we're processing this node so remove it from the open set and add it to the closed set
-		mOpenSet.pop_front();
+		PopNode();
 		AddToClosedSet(planNode);
 
 		// get the neighboring nodes
-		PathingArcVec neighbors;
-		planNode->GetPathingNode()->GetArcs(AT_NORMAL, neighbors);
-		planNode->GetPathingNode()->GetArcs(AT_ACTION, neighbors);
+		mNeighbors.clear();
+		planNode->GetPathingNode()->GetArcs(AT_NORMAL, mNeighbors);
+		planNode->GetPathingNode()->GetArcs(AT_ACTION, mNeighbors);
 
 		// loop though all the neighboring nodes and evaluate each one
-		for (PathingArcVec::iterator it = neighbors.begin(); it != neighbors.end(); ++it)
+		for (PathingArcVec::iterator it = mNeighbors.begin(); it != mNeighbors.end(); ++it)
 		{
 			if (skipArc == (*it)->GetType()) continue;
 
 			PathingNode* pNodeToEvaluate = (*it)->GetNode();
 
 			// Try and find a PathPlanNode object for this node.
-			PathingNodeToPathPlanNodeMap::iterator findIt = mNodes.find(pNodeToEvaluate);
+			PathPlanNode* pPathPlanNodeToEvaluate = FindPlanNode(pNodeToEvaluate);
 
 			// If one exists and it's in the closed list, we've already evaluated the node.  We can
 			// safely skip it.
-			if (findIt != mNodes.end() && findIt->second->IsClosed())
+			if (pPathPlanNodeToEvaluate && pPathPlanNodeToEvaluate->IsClosed())
 				continue;
 
 			// figure out the cost for this route through the node
@@ -924,10 +975,6 @@ void PathFinder::operator()(PathingNode* pStartNode,
 				continue;
 
 			bool isPathBetter = false;
-			// Grab the PathPlanNode if there is one.
-			PathPlanNode* pPathPlanNodeToEvaluate = NULL;
-			if (findIt != mNodes.end())
-				pPathPlanNodeToEvaluate = findIt->second;
 
 			// No PathPlanNode means we've never evaluated this pathing node so we need to add it to 
 			// the open set, which has the side effect of setting all the cost data.
@@ -962,6 +1009,7 @@ void PathFinder::operator()(PathingNode* pStartNode,
 {
 	LogAssert(pStartNode, "Invalid node");
 
+	Reset();
 	mStartNode = pStartNode;
 	mGoalNode = NULL;
 
@@ -992,27 +1040,27 @@ void PathFinder::operator()(PathingNode* pStartNode,
 		}
 
 		// we're processing this node so remove it from the open set and add it to the closed set
-		mOpenSet.pop_front();
+		PopNode();
 		AddToClosedSet(planNode);
 
 		// get the neighboring nodes
-		PathingArcVec neighbors;
-		planNode->GetPathingNode()->GetArcs(AT_NORMAL, neighbors);
-		planNode->GetPathingNode()->GetArcs(AT_ACTION, neighbors);
+		mNeighbors.clear();
+		planNode->GetPathingNode()->GetArcs(AT_NORMAL, mNeighbors);
+		planNode->GetPathingNode()->GetArcs(AT_ACTION, mNeighbors);
 
 		// loop though all the neighboring nodes and evaluate each one
-		for (PathingArcVec::iterator it = neighbors.begin(); it != neighbors.end(); ++it)
+		for (PathingArcVec::iterator it = mNeighbors.begin(); it != mNeighbors.end(); ++it)
 		{
 			if (skipArc == (*it)->GetType()) continue;
 
 			PathingNode* pNodeToEvaluate = (*it)->GetNode();
 
 			// Try and find a PathPlanNode object for this node.
-			PathingNodeToPathPlanNodeMap::iterator findIt = mNodes.find(pNodeToEvaluate);
+			PathPlanNode* pPathPlanNodeToEvaluate = FindPlanNode(pNodeToEvaluate);
 
 			// If one exists and it's in the closed list, we've already evaluated the node.  We can
 			// safely skip it.
-			if (findIt != mNodes.end() && findIt->second->IsClosed())
+			if (pPathPlanNodeToEvaluate && pPathPlanNodeToEvaluate->IsClosed())
 				continue;
 
 			// figure out the cost for this route through the node
@@ -1021,10 +1069,6 @@ void PathFinder::operator()(PathingNode* pStartNode,
 				continue;
 
 			bool isPathBetter = false;
-			// Grab the PathPlanNode if there is one.
-			PathPlanNode* pPathPlanNodeToEvaluate = NULL;
-			if (findIt != mNodes.end())
-				pPathPlanNodeToEvaluate = findIt->second;
 
 			// No PathPlanNode means we've never evaluated this pathing node so we need to add it to 
 			// the open set, which has the side effect of setting all the cost data.
@@ -1056,17 +1100,15 @@ PathPlanNode* PathFinder::AddToOpenSet(PathingArc* pArc, PathPlanNode* pPrevNode
 
 	// create a new PathPlanNode if necessary
 	PathingNode* pNode = pArc->GetNode();
-	PathingNodeToPathPlanNodeMap::iterator it = mNodes.find(pNode);
-	PathPlanNode* pThisNode = NULL;
-	if (it == mNodes.end())
+	PathPlanNode* pThisNode = FindPlanNode(pNode);
+	if (!pThisNode)
 	{
-		pThisNode = new PathPlanNode(pArc, pPrevNode, mGoalNode);
-		mNodes.insert(std::make_pair(pNode, pThisNode));
+		pThisNode = CreatePlanNode(pNode);
+		*pThisNode = PathPlanNode(pArc, pPrevNode, mGoalNode);
 	}
 	else
 	{
 		LogWarning("Adding existing PathPlanNode to open set");
-		pThisNode = it->second;
 		pThisNode->SetClosed(false);
 	}
 	
@@ -1081,17 +1123,15 @@ PathPlanNode* PathFinder::AddToOpenSet(PathingNode* pNode, PathPlanNode* pPrevNo
 	LogAssert(pNode, "Invalid node");
 
 	// create a new PathPlanNode if necessary
-	PathingNodeToPathPlanNodeMap::iterator it = mNodes.find(pNode);
-	PathPlanNode* pThisNode = NULL;
-	if (it == mNodes.end())
+	PathPlanNode* pThisNode = FindPlanNode(pNode);
+	if (!pThisNode)
 	{
-		pThisNode = new PathPlanNode(pNode, pPrevNode, mGoalNode);
-		mNodes.insert(std::make_pair(pNode, pThisNode));
+		pThisNode = CreatePlanNode(pNode);
+		*pThisNode = PathPlanNode(pNode, pPrevNode, mGoalNode);
 	}
 	else
 	{
 		LogWarning("Adding existing PathPlanNode to open set");
-		pThisNode = it->second;
 		pThisNode->SetClosed(false);
 	}
 
@@ -1114,40 +1154,25 @@ void PathFinder::InsertNode(PathPlanNode* pNode)
 {
 	LogAssert(pNode, "Invalid node");
 	
-	// just add the node if the open set is empty
-	if (mOpenSet.empty())
-	{
-		mOpenSet.push_back(pNode);
-		return;
-	}
-
-	// otherwise, perform an insertion sort	
-	PathPlanNodeList::iterator it = mOpenSet.begin();
-	PathPlanNode* pCompare = *it;
-	while (pCompare->IsBetterChoiceThan(pNode))
-	{
-		++it;
-		
-		if (it != mOpenSet.end())
-			pCompare = *it;
-		else
-			break;
-	}
-	mOpenSet.insert(it,pNode);
+	// the open set is a binary heap. The sequence keeps the ordering of the old sorted list, where
+	// a node was inserted ahead of the nodes with the same cost.
+	pNode->mSequence = ++mSequence;
+	pNode->mOpenIndex = (int)mOpenSet.size();
+	mOpenSet.push_back(pNode);
+	SiftUp(pNode->mOpenIndex);
 }
 
 void PathFinder::ReinsertNode(PathPlanNode* pNode)
 {
 	LogAssert(pNode, "Invalid node");
 
-	for (PathPlanNodeList::iterator it = mOpenSet.begin(); it != mOpenSet.end(); ++it)
+	if (pNode->mOpenIndex >= 0)
 	{
-		if (pNode == (*it))
-		{
-			mOpenSet.erase(it);
-			InsertNode(pNode);
-			return;
-		}
+		// the node cost can only decrease, so it either stays or moves up the heap
+		pNode->mSequence = ++mSequence;
+		SiftUp(pNode->mOpenIndex);
+		SiftDown(pNode->mOpenIndex);
+		return;
 	}
 
 	// if we get here, the node was never in the open set to begin with
@@ -1155,6 +1180,61 @@ void PathFinder::ReinsertNode(PathPlanNode* pNode)
 	InsertNode(pNode);
 }
 
+void PathFinder::PopNode(void)
+{
+	LogAssert(!mOpenSet.empty(), "Empty open set");
+
+	mOpenSet.front()->mOpenIndex = -1;
+	if (mOpenSet.size() > 1)
+	{
+		mOpenSet.front() = mOpenSet.back();
+		mOpenSet.front()->mOpenIndex = 0;
+		mOpenSet.pop_back();
+		SiftDown(0);
+	}
+	else mOpenSet.pop_back();
+}
+
+void PathFinder::SiftUp(int index)
+{
+	PathPlanNode* pNode = mOpenSet[index];
+	while (index > 0)
+	{
+		int parent = (index - 1) / 2;
+		if (!pNode->IsBetterChoiceThan(mOpenSet[parent]))
+			break;
+
+		mOpenSet[index] = mOpenSet[parent];
+		mOpenSet[index]->mOpenIndex = index;
+		index = parent;
+	}
+	mOpenSet[index] = pNode;
+	pNode->mOpenIndex = index;
+}
+
+void PathFinder::SiftDown(int index)
+{
+	int size = (int)mOpenSet.size();
+	PathPlanNode* pNode = mOpenSet[index];
+	while (true)
+	{
+		int child = 2 * index + 1;
+		if (child >= size)
+			break;
+
+		if (child + 1 < size && mOpenSet[child + 1]->IsBetterChoiceThan(mOpenSet[child]))
+			child++;
+		if (!mOpenSet[child]->IsBetterChoiceThan(pNode))
+			break;
+
+		mOpenSet[index] = mOpenSet[child];
+		mOpenSet[index]->mOpenIndex = index;
+		index = child;
+	}
+	mOpenSet[index] = pNode;
+	pNode->mOpenIndex = index;
+}
+
 PathPlan* PathFinder::RebuildPath(PathPlanNode* pGoalNode)
 {
 	LogAssert(pGoalNode, "Invalid node");
@@ -1173,9 +1253,315 @@ PathPlan* PathFinder::RebuildPath(PathPlanNode* pGoalNode)
 }
 
 
+//--------------------------------------------------------------------------------------------------------
+// PathingNodeGrid
+//--------------------------------------------------------------------------------------------------------
+PathingNodeGrid::PathingNodeGrid(float cellSize)
+	: mCellSize(cellSize)
+{
+	LogAssert(mCellSize > 0.f, "Invalid cell size");
+
+	Clear();
+}
+
+void PathingNodeGrid::Clear(void)
+{
+	mCells.clear();
+
+	mMinCell = Vector3<int>{ INT_MAX, INT_MAX, INT_MAX };
+	mMaxCell = Vector3<int>{ INT_MIN, INT_MIN, INT_MIN };
+}
+
+Vector3<int> PathingNodeGrid::GetCell(const Vector3<float>& pos) const
+{
+	return Vector3<int>{
+		(int)std::floor(pos[0] / mCellSize),
+		(int)std::floor(pos[1] / mCellSize),
+		(int)std::floor(pos[2] / mCellSize) };
+}
+
+long long PathingNodeGrid::GetCellKey(const Vector3<int>& cell) const
+{
+	// 21 bits per axis is more than enough for any map at the default cell size
+	const long long mask = 0x1FFFFF;
+	return (((long long)(cell[0] + 0x100000) & mask) << 42) |
+		(((long long)(cell[1] + 0x100000) & mask) << 21) |
+		((long long)(cell[2] + 0x100000) & mask);
+}
+
+float PathingNodeGrid::GetCellDistance(const Vector3<float>& pos, const Vector3<int>& cell) const
+{
+	// distance from the position to the closest point of the cell box
+	Vector3<float> diff = Vector3<float>::Zero();
+	for (int i = 0; i < 3; i++)
+	{
+		float cellMin = cell[i] * mCellSize;
+		float cellMax = cellMin + mCellSize;
+		if (pos[i] < cellMin)
+			diff[i] = cellMin - pos[i];
+		else if (pos[i] > cellMax)
+			diff[i] = pos[i] - cellMax;
+	}
+	return Length(diff);
+}
+
+template <typename Visitor>
+void PathingNodeGrid::VisitShell(const Vector3<int>& center, int radius, Visitor visitor) const
+{
+	// visits the occupied cells whose chebyshev distance to the center cell is exactly radius
+	int minX = std::max(center[0] - radius, mMinCell[0]), maxX = std::min(center[0] + radius, mMaxCell[0]);
+	int minY = std::max(center[1] - radius, mMinCell[1]), maxY = std::min(center[1] + radius, mMaxCell[1]);
+	int minZ = std::max(center[2] - radius, mMinCell[2]), maxZ = std::min(center[2] + radius, mMaxCell[2]);
+	for (int x = minX; x <= maxX; x++)
+	{
+		bool borderX = std::abs(x - center[0]) == radius;
+		for (int y = minY; y <= maxY; y++)
+		{
+			bool borderY = borderX || std::abs(y - center[1]) == radius;
+			int stepZ = borderY ? 1 : 2 * radius;
+			for (int z = borderY ? minZ : center[2] - radius; z <= maxZ; z += stepZ)
+			{
+				if (z < minZ)
+					continue;
+
+				CellMap::const_iterator it = mCells.find(GetCellKey(Vector3<int>{x, y, z}));
+				if (it != mCells.end())
+					visitor((*it).second);
+			}
+		}
+	}
+}
+
+void PathingNodeGrid::Insert(PathingNode* pNode)
+{
+	LogAssert(pNode, "Invalid node");
+
+	Vector3<int> cell = GetCell(pNode->GetPosition());
+	mCells[GetCellKey(cell)].push_back(pNode);
+
+	for (int i = 0; i < 3; i++)
+	{
+		mMinCell[i] = std::min(mMinCell[i], cell[i]);
+		mMaxCell[i] = std::max(mMaxCell[i], cell[i]);
+	}
+}
+
+void PathingNodeGrid::Remove(PathingNode* pNode)
+{
+	LogAssert(pNode, "Invalid node");
+
+	// the occupied bounds are left untouched, they are only used to bound the searches
+	CellMap::iterator it = mCells.find(GetCellKey(GetCell(pNode->GetPosition())));
+	if (it != mCells.end())
+	{
+		PathingNodeVec& cellNodes = (*it).second;
+		PathingNodeVec::iterator itNode = std::find(cellNodes.begin(), cellNodes.end(), pNode);
+		if (itNode != cellNodes.end())
+		{
+			*itNode = cellNodes.back();
+			cellNodes.pop_back();
+		}
+
+		if (cellNodes.empty())
+			mCells.erase(it);
+	}
+}
+
+PathingNode* PathingNodeGrid::FindClosestNode(const Vector3<float>& pos, bool skipIsolated) const
+{
+	PathingNode* pClosestNode = NULL;
+	float length = FLT_MAX;
+
+	auto visitCell = [&](const PathingNodeVec& cellNodes)
+	{
+		for (PathingNode* pNode : cellNodes)
+		{
+			//lets skip isolated nodes
+			if (skipIsolated && pNode->GetArcs().empty())
+				continue;
+
+			float nodeLength = Length(pos - pNode->GetPosition());
+			if (nodeLength < length)
+			{
+				pClosestNode = pNode;
+				length = nodeLength;
+			}
+		}
+	};
+
+	if (mCells.empty())
+		return pClosestNode;
+
+	// search outwards shell by shell. Any node in the shell at radius r is at least (r - 1) cells away
+	// from the query position, so we can stop as soon as the closest node found is nearer than that
+	Vector3<int> center = GetCell(pos);
+	int maxRadius = 0;
+	for (int i = 0; i < 3; i++)
+		maxRadius = std::max(maxRadius, std::max(center[i] - mMinCell[i], mMaxCell[i] - center[i]));
+
+	for (int radius = 0; radius <= maxRadius; radius++)
+	{
+		if (pClosestNode && (radius - 1) * mCellSize >= length)
+			break;
+
+		// once a shell holds more cells than the grid, visiting the remaining occupied cells directly
+		// is cheaper than probing the empty ones
+		long long shellCells = (long long)(2 * radius + 1) * (2 * radius + 1) * (2 * radius + 1);
+		if (shellCells - (long long)(2 * radius - 1) * (2 * radius - 1) * (2 * radius - 1) > (long long)mCells.size())
+		{
+			for (CellMap::const_iterator it = mCells.begin(); it != mCells.end(); ++it)
+			{
+				Vector3<int> cell = GetCell((*it).second.front()->GetPosition());
+				int cellRadius = std::max(std::abs(cell[0] - center[0]),
+					std::max(std::abs(cell[1] - center[1]), std::abs(cell[2] - center[2])));
+				if (cellRadius >= radius && GetCellDistance(pos, cell) < length)
+					visitCell((*it).second);
+			}
+			break;
+		}
+
+		VisitShell(center, radius, visitCell);
+	}
+
+	return pClosestNode;
+}
+
+void PathingNodeGrid::FindClosestNodes(PathingNodeVec& nodes,
+	const Vector3<float>& pos, unsigned int count, bool skipIsolated) const
+{
+	if (mCells.empty() || count == 0)
+		return;
+
+	// max heap which keeps the closest nodes found so far
+	std::priority_queue<std::pair<float, PathingNode*>> closestNodes;
+	auto visitCell = [&](const PathingNodeVec& cellNodes)
+	{
+		for (PathingNode* pNode : cellNodes)
+		{
+			//lets skip isolated nodes
+			if (skipIsolated && pNode->GetArcs().empty())
+				continue;
+
+			float nodeLength = Length(pos - pNode->GetPosition());
+			if (closestNodes.size() < count)
+			{
+				closestNodes.push({ nodeLength, pNode });
+			}
+			else if (nodeLength < closestNodes.top().first)
+			{
+				closestNodes.pop();
+				closestNodes.push({ nodeLength, pNode });
+			}
+		}
+	};
+
+	Vector3<int> center = GetCell(pos);
+	int maxRadius = 0;
+	for (int i = 0; i < 3; i++)
+		maxRadius = std::max(maxRadius, std::max(center[i] - mMinCell[i], mMaxCell[i] - center[i]));
+
+	for (int radius = 0; radius <= maxRadius; radius++)
+	{
+		if (closestNodes.size() == count && (radius - 1) * mCellSize >= closestNodes.top().first)
+			break;
+
+		long long shellCells = (long long)(2 * radius + 1) * (2 * radius + 1) * (2 * radius + 1);
+		if (shellCells - (long long)(2 * radius - 1) * (2 * radius - 1) * (2 * radius - 1) > (long long)mCells.size())
+		{
+			for (CellMap::const_iterator it = mCells.begin(); it != mCells.end(); ++it)
+			{
+				Vector3<int> cell = GetCell((*it).second.front()->GetPosition());
+				int cellRadius = std::max(std::abs(cell[0] - center[0]),
+					std::max(std::abs(cell[1] - center[1]), std::abs(cell[2] - center[2])));
+				if (cellRadius < radius)
+					continue;
+
+				if (closestNodes.size() < count || GetCellDistance(pos, cell) < closestNodes.top().first)
+					visitCell((*it).second);
+			}
+			break;
+		}
+
+		VisitShell(center, radius, visitCell);
+	}
+
+	// sorted from the closest to the furthest node
+	size_t offset = nodes.size();
+	nodes.resize(offset + closestNodes.size());
+	for (size_t idx = nodes.size(); idx > offset; idx--)
+	{
+		nodes[idx - 1] = closestNodes.top().second;
+		closestNodes.pop();
+	}
+}
+
+void PathingNodeGrid::FindNodes(PathingNodeVec& nodes,
+	const Vector3<float>& pos, float radius, bool skipIsolated) const
+{
+	auto visitCell = [&](const PathingNodeVec& cellNodes)
+	{
+		for (PathingNode* pNode : cellNodes)
+		{
+			//lets skip isolated nodes
+			if (skipIsolated && pNode->GetArcs().empty())
+				continue;
+
+			if (Length(pos - pNode->GetPosition()) <= radius)
+				nodes.push_back(pNode);
+		}
+	};
+
+	if (mCells.empty() || radius < 0.f)
+		return;
+
+	Vector3<int> minCell = GetCell(pos - Vector3<float>{radius, radius, radius});
+	Vector3<int> maxCell = GetCell(pos + Vector3<float>{radius, radius, radius});
+	long long boxCells = 1;
+	for (int i = 0; i < 3; i++)
+	{
+		minCell[i] = std::max(minCell[i], mMinCell[i]);
+		maxCell[i] = std::min(maxCell[i], mMaxCell[i]);
+		if (minCell[i] > maxCell[i])
+			return;
+
+		boxCells *= (long long)(maxCell[i] - minCell[i] + 1);
+	}
+
+	if (boxCells > (long long)mCells.size())
+	{
+		for (CellMap::const_iterator it = mCells.begin(); it != mCells.end(); ++it)
+			if (GetCellDistance(pos, GetCell((*it).second.front()->GetPosition())) <= radius)
+				visitCell((*it).second);
+	}
+	else
+	{
+		for (int x = minCell[0]; x <= maxCell[0]; x++)
+		{
+			for (int y = minCell[1]; y <= maxCell[1]; y++)
+			{
+				for (int z = minCell[2]; z <= maxCell[2]; z++)
+				{
+					CellMap::const_iterator it = mCells.find(GetCellKey(Vector3<int>{x, y, z}));
+					if (it != mCells.end())
+						visitCell((*it).second);
+				}
+			}
+		}
+	}
+}
+
+
 //--------------------------------------------------------------------------------------------------------
 // PathingGraph
 //--------------------------------------------------------------------------------------------------------
+// The path finder keeps its pooled plan nodes between searches. There is one per thread since
+// the pathing graph is searched concurrently by the AI.
+static PathFinder& GetPathFinder(void)
+{
+	static thread_local PathFinder pathFinder;
+	return pathFinder;
+}
+
 void PathingGraph::DestroyGraph(void)
 {
 	// destroy all the nodes
@@ -1197,33 +1583,18 @@ void PathingGraph::DestroyGraph(void)
 
 	mNodes.clear();
 	mClusters.clear();
+	mNodeGrid.Clear();
 }
 
 PathingNode* PathingGraph::FindClosestNode(const Vector3<float>& pos, bool skipIsolated)
 {
-	// This is a simple brute-force O(n) algorithm that could be made a LOT faster by utilizing
-	// spatial partitioning, like an octree (or quadtree for flat worlds) or something similar.
-	PathingNode* pClosestNode = NULL;
-	float length = FLT_MAX;
-	for (PathingNodeMap::iterator it = mNodes.begin(); it != mNodes.end(); ++it)
-	{
-		PathingNode* pNode = (*it).second;
-		if (skipIsolated)
-		{
-			//lets skip isolated nodes
-			if (pNode->GetArcs().empty())
-				continue;
-		}
+	return mNodeGrid.FindClosestNode(pos, skipIsolated);
+}
 
-		Vector3<float> diff = pos - pNode->GetPosition();
-		if (Length(diff) < length)
-		{
-			pClosestNode = pNode;
-			length = Length(diff);
-		}
-	}
-	
-	return pClosestNode;
+void PathingGraph::FindClosestNodes(
+	PathingNodeVec& nodes, const Vector3<float>& pos, unsigned int count, bool skipIsolated)
+{
+	mNodeGrid.FindClosestNodes(nodes, pos, count, skipIsolated);
 }
 
 PathingNode* PathingGraph::FindFurthestNode(const Vector3<float>& pos, bool skipIsolated)
@@ -1255,22 +1626,7 @@ PathingNode* PathingGraph::FindFurthestNode(const Vector3<float>& pos, bool skip
 
 void PathingGraph::FindNodes(PathingNodeVec& nodes, const Vector3<float>& pos, float radius, bool skipIsolated)
 {
-	// This is a simple brute-force O(n) algorithm that could be made a LOT faster by utilizing
-	// spatial partitioning, like an octree (or quadtree for flat worlds) or something similar.
-	for (PathingNodeMap::iterator it = mNodes.begin(); it != mNodes.end(); ++it)
-	{
-		PathingNode* pNode = (*it).second;
-		if (skipIsolated)
-		{
-			//lets skip isolated nodes
-			if (pNode->GetArcs().empty())
-				continue;
-		}
-
-		Vector3<float> diff = pos - pNode->GetPosition();
-		if (Length(diff) <= radius)
-			nodes.push_back(pNode);
-	}
+	mNodeGrid.FindNodes(nodes, pos, radius, skipIsolated);
 }
 
 PathingNode* PathingGraph::FindNode(unsigned int nodeId)
@@ -1298,24 +1654,14 @@ PathingNode* PathingGraph::FindRandomNode(void)
 	
 	// choose a random node
 	unsigned int node = (int)(Randomizer::FRand() * numNodes);
+	if (node >= numNodes)
+		node = numNodes - 1;
 	
-	// if we're in the lower half of the node list, start from the bottom
-	if (node <= numNodes / 2)
-	{
-		PathingNodeMap::iterator it = mNodes.begin();
-		for (unsigned int i = 0; i < node; i++)
-			++it;
-		return (*it).second;
-	}
-
-	// otherwise, start from the top
-	else
-	{
-		PathingNodeMap::iterator it = mNodes.end();
-		for (unsigned int i = numNodes; i >= node; i--)
-			--it;
-		return (*it).second;
-	}
+	// the node map can only be walked forward
+	PathingNodeMap::iterator it = mNodes.begin();
+	for (unsigned int i = 0; i < node; i++)
+		++it;
+	return (*it).second;
 }
 
 PathingArc* PathingGraph::FindArc(unsigned int arcId)
@@ -1334,7 +1680,7 @@ void PathingGraph::FindPathPlans(PathingNode* pStartNode,
 	std::map<unsigned short, PathingNode*>& searchClusters, ClusterPlanMap& plans, int skipArc, float threshold)
 {
 	// find the best path using an A* search algorithm
-	PathFinder pathFinder;
+	PathFinder& pathFinder = GetPathFinder();
 	pathFinder(pStartNode, searchClusters, plans, skipArc, threshold);
 }
 
@@ -1342,7 +1688,7 @@ void PathingGraph::FindPathPlans(PathingNode* pStartNode,
 	std::vector<ActorId>& searchActors, ActorPlanMap& actorPlans, int skipArc, float threshold)
 {
 	// find the best path using an A* search algorithm
-	PathFinder pathFinder;
+	PathFinder& pathFinder = GetPathFinder();
 	pathFinder(pStartNode, searchActors, actorPlans, skipArc, threshold);
 }
 
@@ -1350,7 +1696,7 @@ void PathingGraph::FindPathPlans(PathingNode* pStartNode,
 	PathingNodeVec& searchNodes, PathPlanMap& plans, int skipArc, float threshold)
 {
 	// find the best path using an A* search algorithm
-	PathFinder pathFinder;
+	PathFinder& pathFinder = GetPathFinder();
 	pathFinder(pStartNode, searchNodes, plans, skipArc, threshold);
 }
 
@@ -1366,7 +1712,7 @@ PathPlan* PathingGraph::FindPath(
 	PathingNode* pStartNode, PathingNodeVec& searchNodes, int skipArc, float threshold)
 {
 	// find the best path using an A* search algorithm
-	PathFinder pathFinder;
+	PathFinder& pathFinder = GetPathFinder();
 	return pathFinder(pStartNode, searchNodes, skipArc, threshold);
 }
 
@@ -1388,7 +1734,7 @@ PathPlan* PathingGraph::FindPath(
 	PathingNode* pStartNode, PathingNode* pGoalNode, int skipArc, float threshold)
 {
 	// find the best path using an A* search algorithm
-	PathFinder pathFinder;
+	PathFinder& pathFinder = GetPathFinder();
 	return pathFinder(pStartNode, pGoalNode, skipArc, threshold);
 }
 
@@ -1427,7 +1773,12 @@ void PathingGraph::InsertNode(PathingNode* pNode)
 {
 	LogAssert(pNode, "Invalid node");
 
+	PathingNodeMap::iterator it = mNodes.find(pNode->GetId());
+	if (it != mNodes.end())
+		mNodeGrid.Remove((*it).second);
+
 	mNodes[pNode->GetId()] = pNode;
+	mNodeGrid.Insert(pNode);
 }
 
 void PathingGraph::InsertCluster(Cluster* pCluster)
@@ -1455,6 +1806,7 @@ void PathingGraph::RemoveNode(PathingNode* pNode)
 			(*itNode).second->RemoveArcs();
 			(*itNode).second->RemoveActors();
 			(*itNode).second->RemoveClusters();
+			mNodeGrid.Remove(pNode);
 			itNode = mNodes.erase(itNode);
 		}
 	}
@@ -67,9 +67,8 @@ typedef std::unordered_map<unsigned int, PathingActor*> PathingActorMap;
 typedef std::unordered_map<unsigned int, PathingArc*> PathingArcMap;
 typedef std::unordered_map<unsigned int, PathingNode*> PathingNodeMap;
 
-typedef std::list<PathPlanNode*> PathPlanNodeList;
+typedef std::vector<PathPlanNode*> PathPlanNodeVec;
 typedef std::map<PathingNode*, PathPlan*> PathPlanMap;
-typedef std::map<PathingNode*, PathPlanNode*> PathingNodeToPathPlanNodeMap;
 
 typedef std::vector<Cluster*> ClusterVec;
 typedef std::unordered_map<unsigned int, Cluster*> ClusterMap;
@@ -78,6 +77,9 @@ typedef std::map<ActorId, PathPlan*> ActorPlanMap;
 
 const float PATHING_DEFAULT_NODE_TOLERANCE = 4.0f;
 const float PATHING_MOVEMENT_NODE_TOLERANCE = 2.0f;
+const float PATHING_DEFAULT_GRID_CELL_SIZE = 64.0f;
+const unsigned int PATHING_PLAN_NODE_POOL_CHUNK = 1024;
+const unsigned int PATHING_INVALID_INDEX = 0xFFFFFFFF;
 
 
 //--------------------------------------------------------------------------------------------------------
@@ -351,14 +353,20 @@ public:
 //--------------------------------------------------------------------------------------------------------
 class PathPlanNode
 {
+	friend class PathFinder;
+
 	PathPlanNode* mPrevNode;  // node we just came from
 	PathingArc* mPathingArc;  // pointer to the pathing arc from the pathing graph
 	PathingNode* mPathingNode;  // pointer to the pathing node from the pathing graph
 	PathingNode* mGoalNode;  // pointer to the goal node
 	bool mClosed;  // the node is closed if it's already been processed
 	float mGoal;  // cost of the entire path up to this point (often called g)
+
+	int mOpenIndex;  // position in the open set heap, -1 if it isn't in the open set
+	unsigned int mSequence;  // open set insertion order, the latest inserted goes first on ties
 	
 public:
+	PathPlanNode(void);
 	explicit PathPlanNode(PathingArc* pArc, PathPlanNode* pPrevNode, PathingNode* pGoalNode);
 	explicit PathPlanNode(PathingNode* pNode, PathPlanNode* pPrevNode, PathingNode* pGoalNode);
 	PathPlanNode* GetPrev(void) const { return mPrevNode; }
@@ -369,7 +377,11 @@ public:
 	
 	void UpdateNode(PathingArc* pArc, PathPlanNode* pPrev);
 	void SetClosed(bool toClose = true) { mClosed = toClose; }
-	bool IsBetterChoiceThan(PathPlanNode* pRight) { return (mGoal < pRight->GetGoal()); }
+	bool IsBetterChoiceThan(PathPlanNode* pRight) 
+	{ 
+		return (mGoal < pRight->GetGoal()) || 
+			(mGoal == pRight->GetGoal() && mSequence > pRight->mSequence); 
+	}
 	
 private:
 	void UpdatePathCost(void);
@@ -382,10 +394,28 @@ private:
 //--------------------------------------------------------------------------------------------------------
 class PathFinder
 {
-	PathingNodeToPathPlanNodeMap mNodes;
+	// per pathing node search state, indexed by the node id. It only belongs to the current search
+	// if its generation matches, so the whole table is invalidated by bumping the generation.
+	struct SearchState
+	{
+		unsigned int mGeneration;
+		PathPlanNode* mPlanNode;
+	};
+
+	std::vector<SearchState> mSearchStates;
+	unsigned int mGeneration;
+
+	// plan nodes are pooled in fixed size chunks so their addresses stay valid while the pool
+	// grows and the memory is reused by the following searches
+	std::vector<std::unique_ptr<PathPlanNode[]>> mPlanNodePool;
+	unsigned int mPlanNodeCount;
+
 	PathingNode* mStartNode;
 	PathingNode* mGoalNode;
-	PathPlanNodeList mOpenSet;
+	PathPlanNodeVec mOpenSet; // binary heap, the best choice is at the front
+	unsigned int mSequence;
+
+	PathingArcVec mNeighbors;
 	
 public:
 	PathFinder(void);
@@ -404,15 +434,63 @@ public:
 	void operator()(PathingNode* pStartNode, PathingNodeVec& searchNodes,
 		PathPlanMap& plans, int skipArc = -1, float threshold = FLT_MAX);
 private:
+	void Reset(void);
+	PathPlanNode* FindPlanNode(PathingNode* pNode);
+	PathPlanNode* CreatePlanNode(PathingNode* pNode);
 	PathPlanNode* AddToOpenSet(PathingArc* pArc, PathPlanNode* pPrevNode);
 	PathPlanNode* AddToOpenSet(PathingNode* pNode, PathPlanNode* pPrevNode);
 	void AddToClosedSet(PathPlanNode* pNode);
 	void InsertNode(PathPlanNode* pNode);
 	void ReinsertNode(PathPlanNode* pNode);
+	void PopNode(void);
+	void SiftUp(int index);
+	void SiftDown(int index);
 	PathPlan* RebuildPath(PathPlanNode* pGoalNode);
 };
 
 
+//--------------------------------------------------------------------------------------------------------
+// class PathingNodeGrid
+// This class is a uniform grid spatial index over the pathing nodes. Nodes are bucketed by the cell
+// which contains their position, so nearest and radius queries only visit the cells around the query
+// position instead of the whole graph. Node positions never change once created, so the grid only
+// needs to be maintained on insertion and removal.
+//--------------------------------------------------------------------------------------------------------
+class PathingNodeGrid
+{
+	typedef std::unordered_map<long long, PathingNodeVec> CellMap;
+
+	float mCellSize;
+	CellMap mCells;
+
+	Vector3<int> mMinCell; // bounds of the occupied cells
+	Vector3<int> mMaxCell;
+
+public:
+	explicit PathingNodeGrid(float cellSize = PATHING_DEFAULT_GRID_CELL_SIZE);
+
+	float GetCellSize(void) const { return mCellSize; }
+
+	void Insert(PathingNode* pNode);
+	void Remove(PathingNode* pNode);
+	void Clear(void);
+
+	PathingNode* FindClosestNode(const Vector3<float>& pos, bool skipIsolated) const;
+	void FindClosestNodes(PathingNodeVec& nodes,
+		const Vector3<float>& pos, unsigned int count, bool skipIsolated) const;
+	void FindNodes(PathingNodeVec& nodes,
+		const Vector3<float>& pos, float radius, bool skipIsolated) const;
+
+private:
+	Vector3<int> GetCell(const Vector3<float>& pos) const;
+	long long GetCellKey(const Vector3<int>& cell) const;
+	float GetCellDistance(const Vector3<float>& pos, const Vector3<int>& cell) const;
+
+	template <typename Visitor>
+	void VisitShell(const Vector3<int>& center, int radius, Visitor visitor) const;
+};
+
+
 //--------------------------------------------------------------------------------------------------------
 // class PathingGraph					- Chapter 18, 636
 // This class is the main interface into the pathing system.  It holds the pathing graph itself and owns
@@ -426,6 +504,7 @@ public:
 	void DestroyGraph(void);
 
 	void FindNodes(PathingNodeVec&, const Vector3<float>& pos, float radius, bool skipIsolated);
+	void FindClosestNodes(PathingNodeVec&, const Vector3<float>& pos, unsigned int count, bool skipIsolated);
 	PathingNode* FindClosestNode(const Vector3<float>& pos, bool skipIsolated);
 	PathingNode* FindFurthestNode(const Vector3<float>& pos, bool skipIsolated);
 	PathingNode* FindNode(unsigned int nodeId);
@@ -469,6 +548,8 @@ private:
 
 	PathingNodeMap mNodes; // master list of all nodes
 	ClusterMap mClusters; // master list of all clusters
+
+	PathingNodeGrid mNodeGrid; // spatial index of all nodes
 };
 
 
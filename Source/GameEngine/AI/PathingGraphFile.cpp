@@ -0,0 +1,599 @@
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "PathingGraphFile.h"
+
+#include "Core/Utility/StringUtil.h"
+
+#include <zlib/zlib.h>
+
+#if !defined(_WINDOWS_API_)
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+static_assert(sizeof(PathingNodeRecord) == 60, "Unexpected node record size");
+static_assert(sizeof(PathingArcRecord) == 24, "Unexpected arc record size");
+static_assert(sizeof(PathingTransitionRecord) == 20, "Unexpected transition record size");
+
+template <typename Record>
+static void AppendSection(std::vector<unsigned char>& data,
+	PathingGraphSectionRecord& section, const std::vector<Record>& records)
+{
+	section.offset = (unsigned int)data.size();
+	section.count = (unsigned int)records.size();
+	if (records.size())
+	{
+		const unsigned char* recordData = reinterpret_cast<const unsigned char*>(records.data());
+		data.insert(data.end(), recordData, recordData + records.size() * sizeof(Record));
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------
+// PathingGraphFile
+//--------------------------------------------------------------------------------------------------------
+PathingGraphFile::PathingGraphFile(void) : mData(NULL), mSize(0)
+{
+#if defined(_WINDOWS_API_)
+	mFile = INVALID_HANDLE_VALUE;
+	mMapping = NULL;
+#else
+	mFile = -1;
+#endif
+}
+
+PathingGraphFile::~PathingGraphFile(void)
+{
+	Close();
+}
+
+bool PathingGraphFile::GetSourceStamp(const std::wstring& sourcePath, unsigned int& size, unsigned long long& time)
+{
+	if (sourcePath.empty())
+		return false;
+
+#if defined(_WINDOWS_API_)
+	WIN32_FILE_ATTRIBUTE_DATA fileData;
+	if (!GetFileAttributesExW(sourcePath.c_str(), GetFileExInfoStandard, &fileData))
+		return false;
+
+	size = fileData.nFileSizeLow;
+	time = (unsigned long long)fileData.ftLastWriteTime.dwHighDateTime << 32 |
+		fileData.ftLastWriteTime.dwLowDateTime;
+#else
+	struct stat fileStat;
+	if (stat(ToString(sourcePath).c_str(), &fileStat) == -1)
+		return false;
+
+	size = (unsigned int)fileStat.st_size;
+	time = (unsigned long long)fileStat.st_mtime;
+#endif
+	return true;
+}
+
+bool PathingGraphFile::Save(const std::string& path, PathingGraph* pGraph, const std::wstring& sourcePath)
+{
+	LogAssert(pGraph, "Invalid graph");
+
+	// nodes are sorted by id so that the same graph always gives the same file
+	PathingNodeVec nodes;
+	for (auto const& node : pGraph->GetNodes())
+		nodes.push_back(node.second);
+	std::sort(nodes.begin(), nodes.end(),
+		[](PathingNode* pNode, PathingNode* pOther) { return pNode->GetId() < pOther->GetId(); });
+
+	std::unordered_map<PathingNode*, unsigned int> nodeIndices;
+	for (unsigned int node = 0; node < nodes.size(); node++)
+		nodeIndices[nodes[node]] = node;
+
+	auto GetNodeIndex = [&nodeIndices](PathingNode* pNode)
+	{
+		auto itNode = nodeIndices.find(pNode);
+		return itNode != nodeIndices.end() ? itNode->second : PATHING_INVALID_INDEX;
+	};
+
+	std::vector<PathingNodeRecord> nodeRecords;
+	std::vector<PathingArcRecord> arcRecords;
+	std::vector<PathingTransitionRecord> transitionRecords;
+	std::vector<PathingVisibleRecord> visibleRecords;
+	std::vector<PathingClusterLinkRecord> clusterLinkRecords;
+	std::vector<PathingActorLinkRecord> actorLinkRecords;
+	nodeRecords.reserve(nodes.size());
+	for (PathingNode* pNode : nodes)
+	{
+		PathingNodeRecord nodeRecord;
+		nodeRecord.id = pNode->GetId();
+		nodeRecord.actorId = pNode->GetActorId();
+		nodeRecord.clusterId = pNode->GetCluster();
+		nodeRecord.tolerance = pNode->GetTolerance();
+		for (int i = 0; i < 3; i++)
+			nodeRecord.position[i] = pNode->GetPosition()[i];
+
+		nodeRecord.arcBegin = (unsigned int)arcRecords.size();
+		for (auto const& arc : pNode->GetArcs())
+		{
+			PathingArc* pArc = arc.second;
+
+			PathingArcRecord arcRecord;
+			arcRecord.id = pArc->GetId();
+			arcRecord.type = pArc->GetType();
+			arcRecord.node = GetNodeIndex(pArc->GetNode());
+			arcRecord.weight = pArc->GetWeight();
+			arcRecord.transitionBegin = (unsigned int)transitionRecords.size();
+			if (PathingTransition* pTransition = pArc->GetTransition())
+			{
+				const PathingNodeVec& transitionNodes = pTransition->GetNodes();
+				const std::vector<float>& transitionWeights = pTransition->GetWeights();
+				const std::vector<Vector3<float>>& transitionPositions = pTransition->GetPositions();
+				for (unsigned int step = 0; step < transitionNodes.size(); step++)
+				{
+					Vector3<float> position = step < transitionPositions.size() ?
+						transitionPositions[step] : transitionNodes[step]->GetPosition();
+
+					PathingTransitionRecord transitionRecord;
+					transitionRecord.node = GetNodeIndex(transitionNodes[step]);
+					transitionRecord.weight = step < transitionWeights.size() ? transitionWeights[step] : 0.f;
+					for (int i = 0; i < 3; i++)
+						transitionRecord.position[i] = position[i];
+					transitionRecords.push_back(transitionRecord);
+				}
+			}
+			arcRecord.transitionCount = (unsigned int)transitionRecords.size() - arcRecord.transitionBegin;
+			arcRecords.push_back(arcRecord);
+		}
+		nodeRecord.arcCount = (unsigned int)arcRecords.size() - nodeRecord.arcBegin;
+
+		nodeRecord.visibleBegin = (unsigned int)visibleRecords.size();
+		for (auto const& visibleNode : pNode->GetVisibileNodes())
+		{
+			PathingVisibleRecord visibleRecord;
+			visibleRecord.node = GetNodeIndex(visibleNode.first);
+			visibleRecord.value = visibleNode.second;
+			if (visibleRecord.node != PATHING_INVALID_INDEX)
+				visibleRecords.push_back(visibleRecord);
+		}
+		nodeRecord.visibleCount = (unsigned int)visibleRecords.size() - nodeRecord.visibleBegin;
+
+		nodeRecord.clusterLinkBegin = (unsigned int)clusterLinkRecords.size();
+		for (auto const& cluster : pNode->GetClusters())
+		{
+			PathingClusterLinkRecord clusterLinkRecord;
+			clusterLinkRecord.type = cluster.second->GetType();
+			clusterLinkRecord.node = GetNodeIndex(cluster.second->GetNode());
+			clusterLinkRecord.target = GetNodeIndex(cluster.second->GetTarget());
+			clusterLinkRecords.push_back(clusterLinkRecord);
+		}
+		nodeRecord.clusterLinkCount = (unsigned int)clusterLinkRecords.size() - nodeRecord.clusterLinkBegin;
+
+		nodeRecord.actorLinkBegin = (unsigned int)actorLinkRecords.size();
+		for (auto const& actor : pNode->GetActors())
+		{
+			PathingActorLinkRecord actorLinkRecord;
+			actorLinkRecord.type = actor.second->GetType();
+			actorLinkRecord.actorId = actor.second->GetActor();
+			actorLinkRecord.node = GetNodeIndex(actor.second->GetNode());
+			actorLinkRecord.target = GetNodeIndex(actor.second->GetTarget());
+			actorLinkRecords.push_back(actorLinkRecord);
+		}
+		nodeRecord.actorLinkCount = (unsigned int)actorLinkRecords.size() - nodeRecord.actorLinkBegin;
+
+		nodeRecords.push_back(nodeRecord);
+	}
+
+	std::vector<Cluster*> clusters;
+	for (auto const& cluster : pGraph->GetClusters())
+		clusters.push_back(cluster.second);
+	std::sort(clusters.begin(), clusters.end(),
+		[](Cluster* pCluster, Cluster* pOther) { return pCluster->GetId() < pOther->GetId(); });
+
+	std::vector<PathingClusterRecord> clusterRecords;
+	std::vector<unsigned int> clusterNodeRecords;
+	std::vector<PathingClusterActorRecord> clusterActorRecords;
+	std::vector<PathingClusterVisibleRecord> clusterVisibleRecords;
+	for (Cluster* pCluster : clusters)
+	{
+		PathingClusterRecord clusterRecord;
+		clusterRecord.id = pCluster->GetId();
+		clusterRecord.node = GetNodeIndex(pCluster->GetNode());
+
+		clusterRecord.nodeBegin = (unsigned int)clusterNodeRecords.size();
+		for (auto const& clusterNode : pCluster->GetNodes())
+		{
+			unsigned int node = GetNodeIndex(clusterNode.second);
+			if (node != PATHING_INVALID_INDEX)
+				clusterNodeRecords.push_back(node);
+		}
+		clusterRecord.nodeCount = (unsigned int)clusterNodeRecords.size() - clusterRecord.nodeBegin;
+
+		clusterRecord.actorBegin = (unsigned int)clusterActorRecords.size();
+		for (auto const& nodeActor : pCluster->GetNodeActors())
+			clusterActorRecords.push_back({ nodeActor.first, GetNodeIndex(nodeActor.second) });
+		clusterRecord.actorCount = (unsigned int)clusterActorRecords.size() - clusterRecord.actorBegin;
+
+		clusterRecord.visibleBegin = (unsigned int)clusterVisibleRecords.size();
+		for (auto const& visibleCluster : pCluster->GetVisibileClusters())
+			clusterVisibleRecords.push_back({ visibleCluster.first, GetNodeIndex(visibleCluster.second) });
+		clusterRecord.visibleCount = (unsigned int)clusterVisibleRecords.size() - clusterRecord.visibleBegin;
+
+		clusterRecords.push_back(clusterRecord);
+	}
+
+	// the sections are laid out right after the header in the order of the enumeration
+	PathingGraphHeaderRecord header;
+	std::vector<unsigned char> data(sizeof(PathingGraphHeaderRecord));
+	AppendSection(data, header.sections[PGS_NODES], nodeRecords);
+	AppendSection(data, header.sections[PGS_ARCS], arcRecords);
+	AppendSection(data, header.sections[PGS_TRANSITIONS], transitionRecords);
+	AppendSection(data, header.sections[PGS_VISIBLES], visibleRecords);
+	AppendSection(data, header.sections[PGS_CLUSTER_LINKS], clusterLinkRecords);
+	AppendSection(data, header.sections[PGS_ACTOR_LINKS], actorLinkRecords);
+	AppendSection(data, header.sections[PGS_CLUSTERS], clusterRecords);
+	AppendSection(data, header.sections[PGS_CLUSTER_NODES], clusterNodeRecords);
+	AppendSection(data, header.sections[PGS_CLUSTER_ACTORS], clusterActorRecords);
+	AppendSection(data, header.sections[PGS_CLUSTER_VISIBLES], clusterVisibleRecords);
+
+	header.magic = PATHING_GRAPH_FILE_MAGIC;
+	header.version = PATHING_GRAPH_FILE_VERSION;
+	header.headerSize = sizeof(PathingGraphHeaderRecord);
+	header.fileSize = (unsigned int)data.size();
+
+	unsigned int sourceSize = 0;
+	unsigned long long sourceTime = 0;
+	GetSourceStamp(sourcePath, sourceSize, sourceTime);
+	header.sourceSize = sourceSize;
+	header.sourceTime[0] = (unsigned int)sourceTime;
+	header.sourceTime[1] = (unsigned int)(sourceTime >> 32);
+
+	header.checksum = crc32(0L, data.data() + header.headerSize, header.fileSize - header.headerSize);
+	memcpy(data.data(), &header, sizeof(PathingGraphHeaderRecord));
+
+	std::ofstream os(path.c_str(), std::ios::binary);
+	if (os.fail())
+	{
+		LogError("Failed to save pathing graph " + path);
+		return false;
+	}
+	os.write(reinterpret_cast<const char*>(data.data()), data.size());
+	return !os.fail();
+}
+
+bool PathingGraphFile::Open(const std::wstring& path)
+{
+	Close();
+
+#if defined(_WINDOWS_API_)
+	mFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+		NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (mFile == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(mFile, &fileSize) || fileSize.QuadPart == 0)
+	{
+		Close();
+		return false;
+	}
+	mSize = (size_t)fileSize.QuadPart;
+
+	mMapping = CreateFileMapping(mFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mMapping == NULL)
+	{
+		Close();
+		return false;
+	}
+	mData = (const unsigned char*)MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+#else
+	mFile = open(ToString(path).c_str(), O_RDONLY);
+	if (mFile == -1)
+		return false;
+
+	struct stat fileStat;
+	if (fstat(mFile, &fileStat) == -1 || fileStat.st_size == 0)
+	{
+		Close();
+		return false;
+	}
+	mSize = (size_t)fileStat.st_size;
+
+	void* data = mmap(NULL, mSize, PROT_READ, MAP_PRIVATE, mFile, 0);
+	mData = data != MAP_FAILED ? (const unsigned char*)data : NULL;
+#endif
+
+	if (!mData || !Validate())
+	{
+		LogWarning("Invalid pathing graph " + ToString(path));
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void PathingGraphFile::Close(void)
+{
+#if defined(_WINDOWS_API_)
+	if (mData)
+		UnmapViewOfFile(mData);
+	if (mMapping != NULL)
+		CloseHandle(mMapping);
+	if (mFile != INVALID_HANDLE_VALUE)
+		CloseHandle(mFile);
+
+	mMapping = NULL;
+	mFile = INVALID_HANDLE_VALUE;
+#else
+	if (mData)
+		munmap((void*)mData, mSize);
+	if (mFile != -1)
+		close(mFile);
+
+	mFile = -1;
+#endif
+
+	mData = NULL;
+	mSize = 0;
+}
+
+bool PathingGraphFile::Validate(void) const
+{
+	if (mSize < sizeof(PathingGraphHeaderRecord))
+		return false;
+
+	const PathingGraphHeaderRecord* pHeader = GetHeader();
+	if (pHeader->magic != PATHING_GRAPH_FILE_MAGIC ||
+		pHeader->version != PATHING_GRAPH_FILE_VERSION ||
+		pHeader->headerSize != sizeof(PathingGraphHeaderRecord) ||
+		pHeader->fileSize != mSize)
+	{
+		return false;
+	}
+
+	static const size_t recordSizes[PGS_COUNT] =
+	{
+		sizeof(PathingNodeRecord), sizeof(PathingArcRecord), sizeof(PathingTransitionRecord),
+		sizeof(PathingVisibleRecord), sizeof(PathingClusterLinkRecord), sizeof(PathingActorLinkRecord),
+		sizeof(PathingClusterRecord), sizeof(unsigned int), sizeof(PathingClusterActorRecord),
+		sizeof(PathingClusterVisibleRecord)
+	};
+	for (unsigned int section = 0; section < PGS_COUNT; section++)
+	{
+		const PathingGraphSectionRecord& sectionRecord = pHeader->sections[section];
+		if (sectionRecord.offset < pHeader->headerSize || sectionRecord.offset % 4 != 0 ||
+			sectionRecord.offset + (size_t)sectionRecord.count * recordSizes[section] > mSize)
+		{
+			return false;
+		}
+	}
+
+	if (pHeader->checksum != crc32(0L, mData + pHeader->headerSize, (uInt)(mSize - pHeader->headerSize)))
+		return false;
+
+	return ValidateRecords();
+}
+
+bool PathingGraphFile::ValidateRecords(void) const
+{
+	// every index read from the file is checked here once, so that Hydrate and the
+	// in place readers never index out of the sections of a corrupted file
+	const unsigned int nodeCount = GetCount(PGS_NODES);
+	auto IsNode = [nodeCount](unsigned int node) { return node < nodeCount; };
+	auto IsNodeOrNone = [nodeCount](unsigned int node)
+	{
+		return node < nodeCount || node == PATHING_INVALID_INDEX;
+	};
+	auto IsRange = [this](PathingGraphSection section, unsigned int begin, unsigned int count)
+	{
+		return (unsigned long long)begin + count <= GetCount(section);
+	};
+
+	const PathingNodeRecord* nodeRecords = GetNodes();
+	for (unsigned int node = 0; node < nodeCount; node++)
+	{
+		const PathingNodeRecord& nodeRecord = nodeRecords[node];
+		if (!IsRange(PGS_ARCS, nodeRecord.arcBegin, nodeRecord.arcCount) ||
+			!IsRange(PGS_VISIBLES, nodeRecord.visibleBegin, nodeRecord.visibleCount) ||
+			!IsRange(PGS_CLUSTER_LINKS, nodeRecord.clusterLinkBegin, nodeRecord.clusterLinkCount) ||
+			!IsRange(PGS_ACTOR_LINKS, nodeRecord.actorLinkBegin, nodeRecord.actorLinkCount))
+		{
+			return false;
+		}
+	}
+
+	const PathingArcRecord* arcRecords = GetArcs();
+	for (unsigned int arc = 0; arc < GetCount(PGS_ARCS); arc++)
+	{
+		if (!IsNodeOrNone(arcRecords[arc].node) ||
+			!IsRange(PGS_TRANSITIONS, arcRecords[arc].transitionBegin, arcRecords[arc].transitionCount))
+		{
+			return false;
+		}
+	}
+
+	const PathingTransitionRecord* transitionRecords = GetTransitions();
+	for (unsigned int transition = 0; transition < GetCount(PGS_TRANSITIONS); transition++)
+		if (!IsNodeOrNone(transitionRecords[transition].node))
+			return false;
+
+	const PathingVisibleRecord* visibleRecords = GetVisibles();
+	for (unsigned int visible = 0; visible < GetCount(PGS_VISIBLES); visible++)
+		if (!IsNode(visibleRecords[visible].node))
+			return false;
+
+	const PathingClusterLinkRecord* clusterLinkRecords = GetClusterLinks();
+	for (unsigned int link = 0; link < GetCount(PGS_CLUSTER_LINKS); link++)
+		if (!IsNodeOrNone(clusterLinkRecords[link].node) || !IsNodeOrNone(clusterLinkRecords[link].target))
+			return false;
+
+	const PathingActorLinkRecord* actorLinkRecords = GetActorLinks();
+	for (unsigned int link = 0; link < GetCount(PGS_ACTOR_LINKS); link++)
+		if (!IsNodeOrNone(actorLinkRecords[link].node) || !IsNodeOrNone(actorLinkRecords[link].target))
+			return false;
+
+	const PathingClusterRecord* clusterRecords = GetClusters();
+	for (unsigned int cluster = 0; cluster < GetCount(PGS_CLUSTERS); cluster++)
+	{
+		const PathingClusterRecord& clusterRecord = clusterRecords[cluster];
+		if (!IsNodeOrNone(clusterRecord.node) ||
+			!IsRange(PGS_CLUSTER_NODES, clusterRecord.nodeBegin, clusterRecord.nodeCount) ||
+			!IsRange(PGS_CLUSTER_ACTORS, clusterRecord.actorBegin, clusterRecord.actorCount) ||
+			!IsRange(PGS_CLUSTER_VISIBLES, clusterRecord.visibleBegin, clusterRecord.visibleCount))
+		{
+			return false;
+		}
+	}
+
+	const unsigned int* clusterNodeRecords = GetClusterNodes();
+	for (unsigned int member = 0; member < GetCount(PGS_CLUSTER_NODES); member++)
+		if (!IsNode(clusterNodeRecords[member]))
+			return false;
+
+	const PathingClusterActorRecord* clusterActorRecords = GetClusterActors();
+	for (unsigned int actor = 0; actor < GetCount(PGS_CLUSTER_ACTORS); actor++)
+		if (!IsNodeOrNone(clusterActorRecords[actor].node))
+			return false;
+
+	const PathingClusterVisibleRecord* clusterVisibleRecords = GetClusterVisibles();
+	for (unsigned int visible = 0; visible < GetCount(PGS_CLUSTER_VISIBLES); visible++)
+		if (!IsNodeOrNone(clusterVisibleRecords[visible].node))
+			return false;
+
+	return true;
+}
+
+bool PathingGraphFile::IsSourceCurrent(const std::wstring& sourcePath) const
+{
+	LogAssert(IsOpen(), "Graph file not open");
+
+	unsigned int sourceSize = 0;
+	unsigned long long sourceTime = 0;
+	if (!GetSourceStamp(sourcePath, sourceSize, sourceTime))
+		return true;
+
+	const PathingGraphHeaderRecord* pHeader = GetHeader();
+	return pHeader->sourceSize == sourceSize &&
+		pHeader->sourceTime[0] == (unsigned int)sourceTime &&
+		pHeader->sourceTime[1] == (unsigned int)(sourceTime >> 32);
+}
+
+void PathingGraphFile::Hydrate(PathingGraph* pGraph, float weightConversion) const
+{
+	LogAssert(pGraph && IsOpen(), "Invalid graph");
+
+	const PathingNodeRecord* nodeRecords = GetNodes();
+	const PathingArcRecord* arcRecords = GetArcs();
+	const PathingTransitionRecord* transitionRecords = GetTransitions();
+	const PathingVisibleRecord* visibleRecords = GetVisibles();
+	const PathingClusterLinkRecord* clusterLinkRecords = GetClusterLinks();
+	const PathingActorLinkRecord* actorLinkRecords = GetActorLinks();
+
+	unsigned int nodeCount = GetCount(PGS_NODES);
+	PathingNodeVec nodes(nodeCount);
+	for (unsigned int node = 0; node < nodeCount; node++)
+	{
+		const PathingNodeRecord& nodeRecord = nodeRecords[node];
+		Vector3<float> position{ nodeRecord.position[0], nodeRecord.position[1], nodeRecord.position[2] };
+
+		nodes[node] = new PathingNode(nodeRecord.id, nodeRecord.actorId, position, nodeRecord.tolerance);
+		nodes[node]->SetCluster(nodeRecord.clusterId);
+		pGraph->InsertNode(nodes[node]);
+	}
+
+	auto GetNode = [&nodes](unsigned int node)
+	{
+		return node != PATHING_INVALID_INDEX ? nodes[node] : NULL;
+	};
+
+	for (unsigned int node = 0; node < nodeCount; node++)
+	{
+		const PathingNodeRecord& nodeRecord = nodeRecords[node];
+		PathingNode* pNode = nodes[node];
+
+		for (unsigned int visible = 0; visible < nodeRecord.visibleCount; visible++)
+		{
+			const PathingVisibleRecord& visibleRecord = visibleRecords[nodeRecord.visibleBegin + visible];
+			pNode->AddVisibleNode(nodes[visibleRecord.node], visibleRecord.value);
+		}
+
+		for (unsigned int arc = 0; arc < nodeRecord.arcCount; arc++)
+		{
+			const PathingArcRecord& arcRecord = arcRecords[nodeRecord.arcBegin + arc];
+			PathingArc* pArc = new PathingArc(
+				arcRecord.id, arcRecord.type, GetNode(arcRecord.node), arcRecord.weight * weightConversion);
+			pNode->AddArc(pArc);
+
+			if (arcRecord.transitionCount)
+			{
+				PathingNodeVec transitionNodes(arcRecord.transitionCount);
+				std::vector<float> transitionWeights(arcRecord.transitionCount);
+				std::vector<Vector3<float>> transitionPositions(arcRecord.transitionCount);
+				for (unsigned int step = 0; step < arcRecord.transitionCount; step++)
+				{
+					const PathingTransitionRecord& transitionRecord =
+						transitionRecords[arcRecord.transitionBegin + step];
+					transitionNodes[step] = GetNode(transitionRecord.node);
+					transitionWeights[step] = transitionRecord.weight * weightConversion;
+					transitionPositions[step] = Vector3<float>{
+						transitionRecord.position[0], transitionRecord.position[1], transitionRecord.position[2] };
+				}
+				pArc->AddTransition(new PathingTransition(transitionNodes, transitionWeights, transitionPositions));
+			}
+		}
+
+		for (unsigned int link = 0; link < nodeRecord.clusterLinkCount; link++)
+		{
+			const PathingClusterLinkRecord& linkRecord = clusterLinkRecords[nodeRecord.clusterLinkBegin + link];
+			PathingCluster* pCluster = new PathingCluster(linkRecord.type);
+			pCluster->LinkClusters(GetNode(linkRecord.node), GetNode(linkRecord.target));
+			pNode->AddCluster(pCluster);
+		}
+
+		for (unsigned int link = 0; link < nodeRecord.actorLinkCount; link++)
+		{
+			const PathingActorLinkRecord& linkRecord = actorLinkRecords[nodeRecord.actorLinkBegin + link];
+			PathingActor* pActor = new PathingActor(linkRecord.type, linkRecord.actorId);
+			pActor->LinkActors(GetNode(linkRecord.node), GetNode(linkRecord.target));
+			pNode->AddActor(pActor);
+		}
+	}
+
+	const PathingClusterRecord* clusterRecords = GetClusters();
+	const unsigned int* clusterNodeRecords = GetClusterNodes();
+	const PathingClusterActorRecord* clusterActorRecords = GetClusterActors();
+	const PathingClusterVisibleRecord* clusterVisibleRecords = GetClusterVisibles();
+	for (unsigned int cluster = 0; cluster < GetCount(PGS_CLUSTERS); cluster++)
+	{
+		const PathingClusterRecord& clusterRecord = clusterRecords[cluster];
+		Cluster* pCluster = new Cluster(clusterRecord.id, GetNode(clusterRecord.node));
+
+		for (unsigned int member = 0; member < clusterRecord.nodeCount; member++)
+			pCluster->AddNode(nodes[clusterNodeRecords[clusterRecord.nodeBegin + member]]);
+
+		for (unsigned int actor = 0; actor < clusterRecord.actorCount; actor++)
+		{
+			const PathingClusterActorRecord& actorRecord = clusterActorRecords[clusterRecord.actorBegin + actor];
+			pCluster->AddNodeActor(actorRecord.actorId, GetNode(actorRecord.node));
+		}
+
+		for (unsigned int visible = 0; visible < clusterRecord.visibleCount; visible++)
+		{
+			const PathingClusterVisibleRecord& visibleRecord =
+				clusterVisibleRecords[clusterRecord.visibleBegin + visible];
+			pCluster->AddVisibleCluster(visibleRecord.clusterId, GetNode(visibleRecord.node));
+		}
+
+		pGraph->InsertCluster(pCluster);
+	}
+}
@@ -0,0 +1,212 @@
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef PATHINGGRAPHFILE_H
+#define PATHINGGRAPHFILE_H
+
+#include "Pathing.h"
+
+const unsigned int PATHING_GRAPH_FILE_MAGIC = 0x48505247; // "GRPH"
+const unsigned int PATHING_GRAPH_FILE_VERSION = 2;
+
+//--------------------------------------------------------------------------------------------------------
+// Pathing graph file records
+// Every record is made of 4 byte fields so that the sections can be read in place from the mapped
+// file. Records never hold pointers, they refer to each other by their index in the section.
+//--------------------------------------------------------------------------------------------------------
+enum PathingGraphSection
+{
+	PGS_NODES,
+	PGS_ARCS,
+	PGS_TRANSITIONS,
+	PGS_VISIBLES,
+	PGS_CLUSTER_LINKS,
+	PGS_ACTOR_LINKS,
+	PGS_CLUSTERS,
+	PGS_CLUSTER_NODES,
+	PGS_CLUSTER_ACTORS,
+	PGS_CLUSTER_VISIBLES,
+
+	PGS_COUNT
+};
+
+struct PathingGraphSectionRecord
+{
+	unsigned int offset; // from the beginning of the file
+	unsigned int count;
+};
+
+struct PathingGraphHeaderRecord
+{
+	unsigned int magic;
+	unsigned int version;
+	unsigned int headerSize;
+	unsigned int fileSize;
+	unsigned int checksum; // crc32 of everything after the header
+	unsigned int sourceSize; // size and modification time of the graph archive it was built from
+	unsigned int sourceTime[2];
+	PathingGraphSectionRecord sections[PGS_COUNT];
+};
+
+struct PathingNodeRecord
+{
+	unsigned int id;
+	unsigned int actorId;
+	unsigned int clusterId;
+	float tolerance;
+	float position[3];
+
+	unsigned int arcBegin, arcCount;
+	unsigned int visibleBegin, visibleCount;
+	unsigned int clusterLinkBegin, clusterLinkCount;
+	unsigned int actorLinkBegin, actorLinkCount;
+};
+
+struct PathingArcRecord
+{
+	unsigned int id;
+	unsigned int type;
+	unsigned int node;
+	float weight;
+
+	unsigned int transitionBegin, transitionCount;
+};
+
+struct PathingTransitionRecord
+{
+	unsigned int node;
+	float weight;
+	float position[3];
+};
+
+struct PathingVisibleRecord
+{
+	unsigned int node;
+	float value;
+};
+
+struct PathingClusterLinkRecord
+{
+	unsigned int type;
+	unsigned int node;
+	unsigned int target;
+};
+
+struct PathingActorLinkRecord
+{
+	unsigned int type;
+	unsigned int actorId;
+	unsigned int node;
+	unsigned int target;
+};
+
+struct PathingClusterRecord
+{
+	unsigned int id;
+	unsigned int node; // PATHING_INVALID_INDEX if the cluster has no representative
+
+	unsigned int nodeBegin, nodeCount;
+	unsigned int actorBegin, actorCount;
+	unsigned int visibleBegin, visibleCount;
+};
+
+struct PathingClusterActorRecord
+{
+	unsigned int actorId;
+	unsigned int node;
+};
+
+struct PathingClusterVisibleRecord
+{
+	unsigned int clusterId;
+	unsigned int node;
+};
+
+//--------------------------------------------------------------------------------------------------------
+// class PathingGraphFile
+// This class reads and writes the pathing graph in a versioned binary layout made of fixed width
+// records. Opening the file maps it in memory and only checks the header and the checksum, the
+// records can then be walked in place or hydrated into a PathingGraph in a single pass, which avoids
+// the per arc containers and allocations of the archive based format.
+//--------------------------------------------------------------------------------------------------------
+class PathingGraphFile
+{
+public:
+	PathingGraphFile(void);
+	~PathingGraphFile(void);
+
+	static bool Save(const std::string& path, PathingGraph* pGraph, const std::wstring& sourcePath = L"");
+
+	bool Open(const std::wstring& path);
+	void Close(void);
+	bool IsOpen(void) const { return mData != NULL; }
+
+	// false if the source the file was built from has changed since. A file whose source
+	// doesn't exist anymore is considered current.
+	bool IsSourceCurrent(const std::wstring& sourcePath) const;
+
+	void Hydrate(PathingGraph* pGraph, float weightConversion = 1.0f) const;
+
+	// records
+	unsigned int GetCount(PathingGraphSection section) const { return GetHeader()->sections[section].count; }
+	const PathingNodeRecord* GetNodes(void) const { return GetSection<PathingNodeRecord>(PGS_NODES); }
+	const PathingArcRecord* GetArcs(void) const { return GetSection<PathingArcRecord>(PGS_ARCS); }
+	const PathingTransitionRecord* GetTransitions(void) const
+	{ return GetSection<PathingTransitionRecord>(PGS_TRANSITIONS); }
+	const PathingVisibleRecord* GetVisibles(void) const
+	{ return GetSection<PathingVisibleRecord>(PGS_VISIBLES); }
+	const PathingClusterLinkRecord* GetClusterLinks(void) const
+	{ return GetSection<PathingClusterLinkRecord>(PGS_CLUSTER_LINKS); }
+	const PathingActorLinkRecord* GetActorLinks(void) const
+	{ return GetSection<PathingActorLinkRecord>(PGS_ACTOR_LINKS); }
+	const PathingClusterRecord* GetClusters(void) const
+	{ return GetSection<PathingClusterRecord>(PGS_CLUSTERS); }
+	const unsigned int* GetClusterNodes(void) const
+	{ return GetSection<unsigned int>(PGS_CLUSTER_NODES); }
+	const PathingClusterActorRecord* GetClusterActors(void) const
+	{ return GetSection<PathingClusterActorRecord>(PGS_CLUSTER_ACTORS); }
+	const PathingClusterVisibleRecord* GetClusterVisibles(void) const
+	{ return GetSection<PathingClusterVisibleRecord>(PGS_CLUSTER_VISIBLES); }
+
+private:
+
+	const PathingGraphHeaderRecord* GetHeader(void) const
+	{
+		return reinterpret_cast<const PathingGraphHeaderRecord*>(mData);
+	}
+
+	template <typename Record>
+	const Record* GetSection(PathingGraphSection section) const
+	{
+		return reinterpret_cast<const Record*>(mData + GetHeader()->sections[section].offset);
+	}
+
+	static bool GetSourceStamp(const std::wstring& sourcePath, unsigned int& size, unsigned long long& time);
+
+	bool Validate(void) const;
+	bool ValidateRecords(void) const;
+
+	const unsigned char* mData;
+	size_t mSize;
+
+#if defined(_WINDOWS_API_)
+	HANDLE mFile;
+	HANDLE mMapping;
+#else
+	int mFile;
+#endif
+};
+
+#endif
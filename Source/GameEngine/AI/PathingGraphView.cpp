@@ -0,0 +1,426 @@
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "PathingGraphView.h"
+
+//--------------------------------------------------------------------------------------------------------
+// PathingGraphView
+//--------------------------------------------------------------------------------------------------------
+PathingGraphView::PathingGraphView(void)
+{
+	Clear();
+}
+
+PathingGraphView::PathingGraphView(const std::shared_ptr<PathingGraph>& graph)
+{
+	Build(graph);
+}
+
+void PathingGraphView::Clear(void)
+{
+	mGraph.reset();
+
+	mNodes.clear();
+	mNodeIndices.clear();
+	mPositions.clear();
+	mNodeClusters.clear();
+	mNodeActors.clear();
+
+	mArcOffsets.assign(1, 0);
+	mArcNodes.clear();
+	mArcTypes.clear();
+	mArcWeights.clear();
+	mArcIndices.clear();
+	mArcs.clear();
+
+	mTransitionOffsets.assign(1, 0);
+	mTransitionNodes.clear();
+	mTransitionWeights.clear();
+	mTransitionPositions.clear();
+
+	mVisibleOffsets.assign(1, 0);
+	mVisibleNodes.clear();
+	mVisibleDistances.clear();
+
+	mClusterLinkOffsets.assign(1, 0);
+	mClusterLinkKeys.clear();
+	mClusterLinkNodes.clear();
+	mClusterLinks.clear();
+
+	mClusterIds.clear();
+	mClusterRepresentatives.clear();
+	mClusterNodeOffsets.assign(1, 0);
+	mClusterNodes.clear();
+}
+
+void PathingGraphView::Build(const std::shared_ptr<PathingGraph>& graph)
+{
+	LogAssert(graph, "Invalid graph");
+
+	Clear();
+	mGraph = graph;
+
+	// nodes are sorted by id so that the baked layout doesn't depend on the hash map order
+	const PathingNodeMap& nodes = mGraph->GetNodes();
+	mNodes.reserve(nodes.size());
+	for (auto const& node : nodes)
+		mNodes.push_back(node.second);
+	std::sort(mNodes.begin(), mNodes.end(),
+		[](PathingNode* pNode, PathingNode* pOther) { return pNode->GetId() < pOther->GetId(); });
+
+	unsigned int nodeCount = (unsigned int)mNodes.size();
+	if (nodeCount)
+		mNodeIndices.assign(mNodes.back()->GetId() + 1, PATHING_INVALID_INDEX);
+
+	mPositions.reserve(nodeCount);
+	mNodeClusters.reserve(nodeCount);
+	mNodeActors.reserve(nodeCount);
+	for (unsigned int node = 0; node < nodeCount; node++)
+	{
+		PathingNode* pNode = mNodes[node];
+		mNodeIndices[pNode->GetId()] = node;
+		mPositions.push_back(pNode->GetPosition());
+		mNodeClusters.push_back(pNode->GetCluster());
+		mNodeActors.push_back(pNode->GetActorId());
+	}
+
+	mArcOffsets.reserve(nodeCount + 1);
+	mVisibleOffsets.reserve(nodeCount + 1);
+	mClusterLinkOffsets.reserve(nodeCount + 1);
+	for (PathingNode* pNode : mNodes)
+	{
+		// arcs and their transitions, sorted by id
+		PathingArcVec arcs;
+		for (auto const& arc : pNode->GetArcs())
+			arcs.push_back(arc.second);
+		std::sort(arcs.begin(), arcs.end(),
+			[](PathingArc* pArc, PathingArc* pOther) { return pArc->GetId() < pOther->GetId(); });
+
+		for (PathingArc* pArc : arcs)
+		{
+			mArcNodes.push_back(GetNodeIndex(pArc->GetNode()));
+			mArcTypes.push_back(pArc->GetType());
+			mArcWeights.push_back(pArc->GetWeight());
+			mArcs.push_back(pArc);
+
+			if (PathingTransition* pTransition = pArc->GetTransition())
+			{
+				const PathingNodeVec& transitionNodes = pTransition->GetNodes();
+				const std::vector<float>& transitionWeights = pTransition->GetWeights();
+				const std::vector<Vector3<float>>& transitionPositions = pTransition->GetPositions();
+				for (unsigned int step = 0; step < transitionNodes.size(); step++)
+				{
+					unsigned int transitionNode = GetNodeIndex(transitionNodes[step]);
+					if (transitionNode == PATHING_INVALID_INDEX)
+						continue;
+
+					mTransitionNodes.push_back(transitionNode);
+					mTransitionWeights.push_back(step < transitionWeights.size() ? transitionWeights[step] : 0.f);
+					mTransitionPositions.push_back(step < transitionPositions.size() ?
+						transitionPositions[step] : transitionNodes[step]->GetPosition());
+				}
+			}
+			mTransitionOffsets.push_back((unsigned int)mTransitionNodes.size());
+		}
+		mArcOffsets.push_back((unsigned int)mArcNodes.size());
+
+		// visible nodes, sorted by node index for the binary search in IsVisibleNode
+		std::vector<std::pair<unsigned int, float>> visibleNodes;
+		for (auto const& visibleNode : pNode->GetVisibileNodes())
+		{
+			unsigned int visible = GetNodeIndex(visibleNode.first);
+			if (visible != PATHING_INVALID_INDEX)
+				visibleNodes.push_back({ visible, visibleNode.second });
+		}
+		std::sort(visibleNodes.begin(), visibleNodes.end());
+
+		for (auto const& visibleNode : visibleNodes)
+		{
+			mVisibleNodes.push_back(visibleNode.first);
+			mVisibleDistances.push_back(visibleNode.second);
+		}
+		mVisibleOffsets.push_back((unsigned int)mVisibleNodes.size());
+
+		// cluster links, sorted by key for the binary search in FindClusterLink
+		std::vector<std::pair<unsigned long long, PathingCluster*>> clusterLinks;
+		for (auto const& clusterLink : pNode->GetClusters())
+		{
+			unsigned int target = GetNodeIndex(clusterLink.second->GetTarget());
+			if (target != PATHING_INVALID_INDEX)
+			{
+				clusterLinks.push_back({ 
+					(unsigned long long)target << 32 | clusterLink.second->GetType(), clusterLink.second });
+			}
+		}
+		std::sort(clusterLinks.begin(), clusterLinks.end(),
+			[](auto const& link, auto const& other) { return link.first < other.first; });
+
+		for (auto const& clusterLink : clusterLinks)
+		{
+			mClusterLinkKeys.push_back(clusterLink.first);
+			mClusterLinkNodes.push_back(GetNodeIndex(clusterLink.second->GetNode()));
+			mClusterLinks.push_back(clusterLink.second);
+		}
+		mClusterLinkOffsets.push_back((unsigned int)mClusterLinkKeys.size());
+	}
+
+	// arc ids are unique across the graph
+	unsigned int arcCount = (unsigned int)mArcs.size();
+	unsigned int maxArcId = 0;
+	for (PathingArc* pArc : mArcs)
+		maxArcId = std::max(maxArcId, pArc->GetId());
+	if (arcCount)
+		mArcIndices.assign(maxArcId + 1, PATHING_INVALID_INDEX);
+	for (unsigned int arc = 0; arc < arcCount; arc++)
+		mArcIndices[mArcs[arc]->GetId()] = arc;
+
+	// cluster membership
+	std::vector<Cluster*> clusters;
+	for (auto const& cluster : mGraph->GetClusters())
+		clusters.push_back(cluster.second);
+	std::sort(clusters.begin(), clusters.end(),
+		[](Cluster* pCluster, Cluster* pOther) { return pCluster->GetId() < pOther->GetId(); });
+
+	for (Cluster* pCluster : clusters)
+	{
+		mClusterIds.push_back(pCluster->GetId());
+		mClusterRepresentatives.push_back(GetNodeIndex(pCluster->GetNode()));
+
+		for (auto const& clusterNode : pCluster->GetNodes())
+		{
+			unsigned int node = GetNodeIndex(clusterNode.second);
+			if (node != PATHING_INVALID_INDEX)
+				mClusterNodes.push_back(node);
+		}
+		std::sort(mClusterNodes.begin() + mClusterNodeOffsets.back(), mClusterNodes.end());
+		mClusterNodeOffsets.push_back((unsigned int)mClusterNodes.size());
+	}
+}
+
+unsigned int PathingGraphView::GetNodeIndex(const PathingNode* pNode) const
+{
+	if (!pNode || pNode->GetId() >= mNodeIndices.size())
+		return PATHING_INVALID_INDEX;
+
+	// the node may come from another graph which reuses the same ids
+	unsigned int node = mNodeIndices[pNode->GetId()];
+	if (node == PATHING_INVALID_INDEX || mNodes[node] != pNode)
+		return PATHING_INVALID_INDEX;
+
+	return node;
+}
+
+unsigned int PathingGraphView::GetArcIndex(const PathingArc* pArc) const
+{
+	if (!pArc || pArc->GetId() >= mArcIndices.size())
+		return PATHING_INVALID_INDEX;
+
+	unsigned int arc = mArcIndices[pArc->GetId()];
+	if (arc == PATHING_INVALID_INDEX || mArcs[arc] != pArc)
+		return PATHING_INVALID_INDEX;
+
+	return arc;
+}
+
+unsigned int PathingGraphView::FindArc(unsigned int node, unsigned int linkedNode) const
+{
+	for (unsigned int arc = GetArcBegin(node); arc < GetArcEnd(node); arc++)
+		if (mArcNodes[arc] == linkedNode)
+			return arc;
+
+	return PATHING_INVALID_INDEX;
+}
+
+bool PathingGraphView::IsVisibleNode(unsigned int node, unsigned int otherNode) const
+{
+	std::vector<unsigned int>::const_iterator itBegin = mVisibleNodes.begin() + mVisibleOffsets[node];
+	std::vector<unsigned int>::const_iterator itEnd = mVisibleNodes.begin() + mVisibleOffsets[node + 1];
+	return std::binary_search(itBegin, itEnd, otherNode);
+}
+
+bool PathingGraphView::IsVisibleNode(PathingNode* pNode, PathingNode* pOtherNode) const
+{
+	unsigned int node = GetNodeIndex(pNode);
+	unsigned int otherNode = GetNodeIndex(pOtherNode);
+	if (node == PATHING_INVALID_INDEX || otherNode == PATHING_INVALID_INDEX)
+	{
+		// the nodes don't belong to the baked graph
+		return pNode->IsVisibleNode(pOtherNode);
+	}
+
+	return IsVisibleNode(node, otherNode);
+}
+
+unsigned int PathingGraphView::FindClusterLink(
+	unsigned int node, unsigned int pathingType, unsigned int targetNode) const
+{
+	std::vector<unsigned long long>::const_iterator itBegin = mClusterLinkKeys.begin() + mClusterLinkOffsets[node];
+	std::vector<unsigned long long>::const_iterator itEnd = mClusterLinkKeys.begin() + mClusterLinkOffsets[node + 1];
+
+	unsigned long long key = (unsigned long long)targetNode << 32 | pathingType;
+	std::vector<unsigned long long>::const_iterator it = std::lower_bound(itBegin, itEnd, key);
+	if (it == itEnd || *it != key)
+		return PATHING_INVALID_INDEX;
+
+	return (unsigned int)(it - mClusterLinkKeys.begin());
+}
+
+unsigned int PathingGraphView::GetClusterIndex(unsigned int clusterId) const
+{
+	std::vector<unsigned int>::const_iterator it =
+		std::lower_bound(mClusterIds.begin(), mClusterIds.end(), clusterId);
+	if (it == mClusterIds.end() || *it != clusterId)
+		return PATHING_INVALID_INDEX;
+
+	return (unsigned int)(it - mClusterIds.begin());
+}
+
+PathingArc* PathingGraphView::FindArc(PathingNode* pNode, unsigned int arcId) const
+{
+	unsigned int node = GetNodeIndex(pNode);
+	if (node == PATHING_INVALID_INDEX)
+		return pNode->FindArc(arcId);
+
+	if (arcId >= mArcIndices.size())
+		return NULL;
+
+	// the arc must leave from the node
+	unsigned int arc = mArcIndices[arcId];
+	if (arc == PATHING_INVALID_INDEX || arc < GetArcBegin(node) || arc >= GetArcEnd(node))
+		return NULL;
+
+	return mArcs[arc];
+}
+
+PathingCluster* PathingGraphView::FindCluster(
+	PathingNode* pNode, unsigned int pathingType, unsigned int clusterId) const
+{
+	unsigned int node = GetNodeIndex(pNode);
+	if (node == PATHING_INVALID_INDEX)
+		return pNode->FindCluster(pathingType, clusterId);
+
+	for (unsigned int link = GetClusterLinkBegin(node); link < GetClusterLinkEnd(node); link++)
+	{
+		if (GetClusterLinkType(link) == pathingType &&
+			mNodeClusters[GetClusterLinkTarget(link)] == clusterId)
+		{
+			return mClusterLinks[link];
+		}
+	}
+	return NULL;
+}
+
+PathingNode* PathingGraphView::FindClusterNode(unsigned int clusterId) const
+{
+	unsigned int cluster = GetClusterIndex(clusterId);
+	if (cluster == PATHING_INVALID_INDEX || mClusterRepresentatives[cluster] == PATHING_INVALID_INDEX)
+		return NULL;
+
+	return mNodes[mClusterRepresentatives[cluster]];
+}
+
+bool PathingGraphView::GetClusterPath(
+	unsigned int node, unsigned int link, float& weight, PathingArcVec* path) const
+{
+	unsigned int pathingType = GetClusterLinkType(link);
+	unsigned int targetNode = GetClusterLinkTarget(link);
+
+	weight = 0.f;
+	unsigned int currentNode = node;
+	while (currentNode != targetNode)
+	{
+		unsigned int currentLink = FindClusterLink(currentNode, pathingType, targetNode);
+		if (currentLink == PATHING_INVALID_INDEX)
+			return false;
+
+		unsigned int currentArc = FindArc(currentNode, mClusterLinkNodes[currentLink]);
+		if (currentArc == PATHING_INVALID_INDEX || mArcNodes[currentArc] == PATHING_INVALID_INDEX)
+			return false;
+
+		if (path)
+			path->push_back(mArcs[currentArc]);
+		weight += mArcWeights[currentArc];
+
+		currentNode = mArcNodes[currentArc];
+	}
+	return true;
+}
+
+void PathingGraphView::GetClusterPaths(unsigned int node, unsigned int pathingType, unsigned int clusterLimit,
+	std::vector<std::pair<float, unsigned int>>& clusterPathWeights) const
+{
+	for (unsigned int link = GetClusterLinkBegin(node); link < GetClusterLinkEnd(node); link++)
+	{
+		if (GetClusterLinkType(link) != pathingType)
+			continue;
+
+		float clusterPathWeight;
+		if (GetClusterPath(node, link, clusterPathWeight, NULL))
+			clusterPathWeights.push_back({ clusterPathWeight, link });
+	}
+
+	// only the paths of the lightest clusters are built
+	if (clusterPathWeights.size() > clusterLimit)
+	{
+		std::partial_sort(clusterPathWeights.begin(), 
+			clusterPathWeights.begin() + clusterLimit, clusterPathWeights.end());
+		clusterPathWeights.resize(clusterLimit);
+	}
+	else std::sort(clusterPathWeights.begin(), clusterPathWeights.end());
+}
+
+void PathingGraphView::GetClusters(PathingNode* pNode, unsigned int pathingType, unsigned int clusterLimit,
+	std::map<PathingCluster*, PathingArcVec>& clusterPaths, std::multimap<float, PathingCluster*>& clusterPathWeights) const
+{
+	unsigned int node = GetNodeIndex(pNode);
+	if (node == PATHING_INVALID_INDEX)
+	{
+		pNode->GetClusters(pathingType, clusterLimit, clusterPaths, clusterPathWeights);
+		return;
+	}
+
+	std::vector<std::pair<float, unsigned int>> clusterLinkWeights;
+	GetClusterPaths(node, pathingType, clusterLimit, clusterLinkWeights);
+	for (auto const& clusterLinkWeight : clusterLinkWeights)
+	{
+		float clusterPathWeight;
+		PathingArcVec& clusterPath = clusterPaths[mClusterLinks[clusterLinkWeight.second]];
+		clusterPath.clear();
+		GetClusterPath(node, clusterLinkWeight.second, clusterPathWeight, &clusterPath);
+		clusterPathWeights.insert({ clusterLinkWeight.first, mClusterLinks[clusterLinkWeight.second] });
+	}
+}
+
+void PathingGraphView::GetClusters(PathingNode* pNode, unsigned int pathingType, unsigned int clusterLimit,
+	std::map<PathingCluster*, PathingArcVec>& clusterPaths, std::map<PathingCluster*, float>& clusterPathWeights) const
+{
+	unsigned int node = GetNodeIndex(pNode);
+	if (node == PATHING_INVALID_INDEX)
+	{
+		pNode->GetClusters(pathingType, clusterLimit, clusterPaths, clusterPathWeights);
+		return;
+	}
+
+	std::vector<std::pair<float, unsigned int>> clusterLinkWeights;
+	GetClusterPaths(node, pathingType, clusterLimit, clusterLinkWeights);
+	for (auto const& clusterLinkWeight : clusterLinkWeights)
+	{
+		float clusterPathWeight;
+		PathingArcVec& clusterPath = clusterPaths[mClusterLinks[clusterLinkWeight.second]];
+		clusterPath.clear();
+		GetClusterPath(node, clusterLinkWeight.second, clusterPathWeight, &clusterPath);
+		clusterPathWeights[mClusterLinks[clusterLinkWeight.second]] = clusterLinkWeight.first;
+	}
+}
@@ -0,0 +1,158 @@
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef PATHINGGRAPHVIEW_H
+#define PATHINGGRAPHVIEW_H
+
+#include "Pathing.h"
+
+//--------------------------------------------------------------------------------------------------------
+// class PathingGraphView
+// This class is an immutable snapshot of a pathing graph baked in compressed sparse row form. Nodes
+// are addressed by a dense index and every per node relation (arcs, arc transitions, visible nodes,
+// cluster links) is stored as a contiguous range of the flat arrays below, so the AI simulations can
+// walk the graph without chasing pointers through the hash maps of the editable PathingGraph. The
+// view holds the graph it was baked from, so publishing the view atomically publishes the pair and
+// the arcs and clusters it points back to stay alive while a simulation uses it. Since the view is
+// never modified after Build it can be shared freely between the AI worker threads.
+// It must be rebuilt whenever the source graph changes.
+//--------------------------------------------------------------------------------------------------------
+class PathingGraphView
+{
+public:
+	PathingGraphView(void);
+	explicit PathingGraphView(const std::shared_ptr<PathingGraph>& graph);
+
+	void Build(const std::shared_ptr<PathingGraph>& graph);
+	void Clear(void);
+
+	const std::shared_ptr<PathingGraph>& GetGraph(void) const { return mGraph; }
+
+	// nodes
+	unsigned int GetNodeCount(void) const { return (unsigned int)mNodes.size(); }
+	unsigned int GetNodeIndex(const PathingNode* pNode) const;
+	PathingNode* GetNode(unsigned int node) const { return mNodes[node]; }
+	const Vector3<float>& GetPosition(unsigned int node) const { return mPositions[node]; }
+	unsigned short GetCluster(unsigned int node) const { return mNodeClusters[node]; }
+	ActorId GetActorId(unsigned int node) const { return mNodeActors[node]; }
+
+	// arcs of a node are in the range [GetArcBegin, GetArcEnd), sorted by id
+	unsigned int GetArcCount(void) const { return (unsigned int)mArcs.size(); }
+	unsigned int GetArcBegin(unsigned int node) const { return mArcOffsets[node]; }
+	unsigned int GetArcEnd(unsigned int node) const { return mArcOffsets[node + 1]; }
+	unsigned int GetArcIndex(const PathingArc* pArc) const;
+	unsigned int GetArcNode(unsigned int arc) const { return mArcNodes[arc]; }
+	unsigned int GetArcType(unsigned int arc) const { return mArcTypes[arc]; }
+	float GetArcWeight(unsigned int arc) const { return mArcWeights[arc]; }
+	PathingArc* GetArc(unsigned int arc) const { return mArcs[arc]; }
+	unsigned int FindArc(unsigned int node, unsigned int linkedNode) const;
+
+	// transition steps of an arc are in the range [GetTransitionBegin, GetTransitionEnd)
+	unsigned int GetTransitionBegin(unsigned int arc) const { return mTransitionOffsets[arc]; }
+	unsigned int GetTransitionEnd(unsigned int arc) const { return mTransitionOffsets[arc + 1]; }
+	unsigned int GetTransitionNode(unsigned int step) const { return mTransitionNodes[step]; }
+	float GetTransitionWeight(unsigned int step) const { return mTransitionWeights[step]; }
+	const Vector3<float>& GetTransitionPosition(unsigned int step) const { return mTransitionPositions[step]; }
+
+	// visible nodes of a node are in the range [GetVisibleBegin, GetVisibleEnd), sorted by node index
+	unsigned int GetVisibleBegin(unsigned int node) const { return mVisibleOffsets[node]; }
+	unsigned int GetVisibleEnd(unsigned int node) const { return mVisibleOffsets[node + 1]; }
+	unsigned int GetVisibleNode(unsigned int visible) const { return mVisibleNodes[visible]; }
+	float GetVisibleDistance(unsigned int visible) const { return mVisibleDistances[visible]; }
+	bool IsVisibleNode(unsigned int node, unsigned int otherNode) const;
+	bool IsVisibleNode(PathingNode* pNode, PathingNode* pOtherNode) const;
+
+	// cluster links of a node are in the range [GetClusterLinkBegin, GetClusterLinkEnd), sorted by
+	// target node and pathing type
+	unsigned int GetClusterLinkBegin(unsigned int node) const { return mClusterLinkOffsets[node]; }
+	unsigned int GetClusterLinkEnd(unsigned int node) const { return mClusterLinkOffsets[node + 1]; }
+	unsigned int GetClusterLinkType(unsigned int link) const { return (unsigned int)(mClusterLinkKeys[link] & 0xFFFFFFFF); }
+	unsigned int GetClusterLinkTarget(unsigned int link) const { return (unsigned int)(mClusterLinkKeys[link] >> 32); }
+	unsigned int GetClusterLinkNode(unsigned int link) const { return mClusterLinkNodes[link]; }
+	PathingCluster* GetClusterLink(unsigned int link) const { return mClusterLinks[link]; }
+	unsigned int FindClusterLink(unsigned int node, unsigned int pathingType, unsigned int targetNode) const;
+
+	// cluster members are in the range [GetClusterNodeBegin, GetClusterNodeEnd)
+	unsigned int GetClusterCount(void) const { return (unsigned int)mClusterIds.size(); }
+	unsigned int GetClusterIndex(unsigned int clusterId) const;
+	unsigned int GetClusterId(unsigned int cluster) const { return mClusterIds[cluster]; }
+	unsigned int GetClusterRepresentative(unsigned int cluster) const { return mClusterRepresentatives[cluster]; }
+	unsigned int GetClusterNodeBegin(unsigned int cluster) const { return mClusterNodeOffsets[cluster]; }
+	unsigned int GetClusterNodeEnd(unsigned int cluster) const { return mClusterNodeOffsets[cluster + 1]; }
+	unsigned int GetClusterNode(unsigned int member) const { return mClusterNodes[member]; }
+
+	// searches of the PathingNode and PathingGraph interfaces run on the baked arrays. They return the
+	// arcs and clusters of the baked graph, so the plans built from them keep their usual types. Nodes
+	// which don't belong to the baked graph are searched through the PathingNode instead.
+	PathingArc* FindArc(PathingNode* pNode, unsigned int arcId) const;
+	PathingCluster* FindCluster(PathingNode* pNode, unsigned int pathingType, unsigned int clusterId) const;
+	PathingNode* FindClusterNode(unsigned int clusterId) const;
+	void GetClusters(PathingNode* pNode, unsigned int pathingType, unsigned int clusterLimit,
+		std::map<PathingCluster*, PathingArcVec>& clusterPaths,
+		std::multimap<float, PathingCluster*>& clusterPathWeights) const;
+	void GetClusters(PathingNode* pNode, unsigned int pathingType, unsigned int clusterLimit,
+		std::map<PathingCluster*, PathingArcVec>& clusterPaths,
+		std::map<PathingCluster*, float>& clusterPathWeights) const;
+
+private:
+
+	// follows the cluster links from the node to the target of the link, returns false if they are broken
+	bool GetClusterPath(unsigned int node, unsigned int link, float& weight, PathingArcVec* path) const;
+	// the cluster links of the pathing type with the lightest paths, sorted by path weight
+	void GetClusterPaths(unsigned int node, unsigned int pathingType, unsigned int clusterLimit,
+		std::vector<std::pair<float, unsigned int>>& clusterPathWeights) const;
+
+	std::shared_ptr<PathingGraph> mGraph;
+
+	// nodes, sorted by id
+	PathingNodeVec mNodes;
+	std::vector<unsigned int> mNodeIndices; // node id to node index
+	std::vector<Vector3<float>> mPositions;
+	std::vector<unsigned short> mNodeClusters;
+	std::vector<ActorId> mNodeActors;
+
+	// arcs
+	std::vector<unsigned int> mArcOffsets;
+	std::vector<unsigned int> mArcNodes;
+	std::vector<unsigned int> mArcTypes;
+	std::vector<float> mArcWeights;
+	std::vector<unsigned int> mArcIndices; // arc id to arc index
+	PathingArcVec mArcs;
+
+	// arc transitions
+	std::vector<unsigned int> mTransitionOffsets;
+	std::vector<unsigned int> mTransitionNodes;
+	std::vector<float> mTransitionWeights;
+	std::vector<Vector3<float>> mTransitionPositions;
+
+	// visibility
+	std::vector<unsigned int> mVisibleOffsets;
+	std::vector<unsigned int> mVisibleNodes;
+	std::vector<float> mVisibleDistances;
+
+	// cluster links, keyed by target node index << 32 | pathing type
+	std::vector<unsigned int> mClusterLinkOffsets;
+	std::vector<unsigned long long> mClusterLinkKeys;
+	std::vector<unsigned int> mClusterLinkNodes;
+	PathingClusterVec mClusterLinks;
+
+	// cluster membership, sorted by cluster id
+	std::vector<unsigned int> mClusterIds;
+	std::vector<unsigned int> mClusterRepresentatives;
+	std::vector<unsigned int> mClusterNodeOffsets;
+	std::vector<unsigned int> mClusterNodes;
+};
+
+#endif
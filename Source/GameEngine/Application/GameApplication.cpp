@@ -44,6 +44,9 @@
 
 #endif
 
+#include "Graphic/Renderer/Null/NullRenderer.h"
+#include "Graphic/Renderer/Null/NullProgramFactory.h"
+
 //----------------------------------------------------------------------------
 GameApplication::GameApplication(const char* windowTitle, int xPosition,
     int yPosition, int width, int height, const SColorF& clearColor)
@@ -123,28 +126,6 @@ bool GameApplication::OnInitialize()
 
 	mSystem = std::make_shared<WindowsSystem>(mWidth, mHeight);
 	mSystem->SetEventListener(this);
-	HWND handle = reinterpret_cast<HWND>(mSystem->GetID());
-
-#ifdef USE_DX11
-
-	mRenderer = std::make_shared<Dx11Renderer>(
-		handle, mWidth, mHeight, D3D_FEATURE_LEVEL_11_0);
-	mProgramFactory = std::make_shared<HLSLProgramFactory>();
-
-	if (mRenderer == 0)
-	{
-		LogError("Failed to initialize the rendering system");
-		return false;
-	}
-
-#elif _OPENGL_
-
-	mRenderer = std::make_shared<WGLRenderer>(handle);
-	mProgramFactory = std::make_shared<GLSLProgramFactory>();
-
-	if (mRenderer == 0) return false; // initialization failed
-
-#endif
 
 	if (mSystem == 0)
 	{
@@ -169,8 +150,6 @@ bool GameApplication::OnInitialize()
 
 #endif
 
-	mRenderer->SetClearColor(mClearColor);
-
 	std::wstring gametitle(GetGameTitle());
 	//mSystem->SetWindowCaption(gametitle.c_str());
 	//mRenderer->SetBackgroundColor(255, 20, 20, 200);
@@ -233,6 +212,45 @@ bool GameApplication::OnInitialize()
     Settings::CreateLayer(SL_DEFAULTS);
     Settings::Get()->Init(SL_DEFAULTS, L"Config/GameSettings.xml");
 
+	// The renderer is created once the settings are loaded. The null video driver
+	// runs the game without a graphics device, e.g. for dedicated servers.
+	if (Settings::Get()->Exists("video_driver") && Settings::Get()->Get("video_driver") == "null")
+	{
+		std::shared_ptr<NullRenderer> nullRenderer = std::make_shared<NullRenderer>(mWidth, mHeight);
+		if (Settings::Get()->Exists("null_command_log") && !Settings::Get()->Get("null_command_log").empty())
+			nullRenderer->SetCommandLog(Settings::Get()->Get("null_command_log"));
+		mRenderer = nullRenderer;
+		mProgramFactory = std::make_shared<NullProgramFactory>();
+	}
+	else
+	{
+#ifdef _WINDOWS_API_
+
+		HWND handle = reinterpret_cast<HWND>(mSystem->GetID());
+
+#ifdef USE_DX11
+
+		mRenderer = std::make_shared<Dx11Renderer>(
+			handle, mWidth, mHeight, D3D_FEATURE_LEVEL_11_0);
+		mProgramFactory = std::make_shared<HLSLProgramFactory>();
+
+#elif _OPENGL_
+
+		mRenderer = std::make_shared<WGLRenderer>(handle);
+		mProgramFactory = std::make_shared<GLSLProgramFactory>();
+
+#endif
+
+#endif
+	}
+
+	if (mRenderer == 0)
+	{
+		LogError("Failed to initialize the rendering system");
+		return false;
+	}
+	mRenderer->SetClearColor(mClearColor);
+
 	// The event manager should be created next so that subsystems can hook in as desired.
 	mEventManager = std::make_shared<EventManager>("GameEngine EventMgr", true);
 	if (!mEventManager)
@@ -705,6 +705,8 @@ void Settings::Init(SettingsLayer sl, const wchar_t* xmlFileName)
                 GetLayer(sl)->Set("fov", pNode->Attribute("fov"));
             if (pNode->Attribute("video_driver"))
                 GetLayer(sl)->Set("video_driver", pNode->Attribute("video_driver"));
+            if (pNode->Attribute("null_command_log"))
+                GetLayer(sl)->Set("null_command_log", pNode->Attribute("null_command_log"));
             if (pNode->Attribute("high_precision_fpu"))
                 GetLayer(sl)->Set("high_precision_fpu", pNode->Attribute("high_precision_fpu"));
             if (pNode->Attribute("enable_console"))
@@ -878,12 +880,16 @@ void Settings::Init(SettingsLayer sl, const wchar_t* xmlFileName)
                 GetLayer(sl)->Set("fixed_map_seed", pNode->Attribute("fixed_map_seed"));
             if (pNode->Attribute("enable_mapgen_debug_info"))
                 GetLayer(sl)->Set("enable_mapgen_debug_info", pNode->Attribute("enable_mapgen_debug_info"));
+            if (pNode->Attribute("mapgen_parallel_noise"))
+                GetLayer(sl)->Set("mapgen_parallel_noise", pNode->Attribute("mapgen_parallel_noise"));
             if (pNode->Attribute("enable_mesh_cache"))
                 GetLayer(sl)->Set("enable_mesh_cache", pNode->Attribute("enable_mesh_cache"));
             if (pNode->Attribute("mesh_generation_interval"))
                 GetLayer(sl)->Set("mesh_generation_interval", pNode->Attribute("mesh_generation_interval"));
             if (pNode->Attribute("meshgen_block_cache_size"))
                 GetLayer(sl)->Set("meshgen_block_cache_size", pNode->Attribute("meshgen_block_cache_size"));
+            if (pNode->Attribute("mesh_generation_threads"))
+                GetLayer(sl)->Set("mesh_generation_threads", pNode->Attribute("mesh_generation_threads"));
             if (pNode->Attribute("enable_vbo"))
                 GetLayer(sl)->Set("enable_vbo", pNode->Attribute("enable_vbo"));
         }
@@ -901,6 +907,8 @@ void Settings::Init(SettingsLayer sl, const wchar_t* xmlFileName)
                 GetLayer(sl)->Set("sound_volume", pNode->Attribute("sound_volume"));
             if (pNode->Attribute("mute_sound"))
                 GetLayer(sl)->Set("mute_sound", pNode->Attribute("mute_sound"));
+            if (pNode->Attribute("sound_stream_threshold"))
+                GetLayer(sl)->Set("sound_stream_threshold", pNode->Attribute("sound_stream_threshold"));
 		}
 
 		pNode = mRoot->FirstChildElement("Network"); 
@@ -929,6 +937,14 @@ void Settings::Init(SettingsLayer sl, const wchar_t* xmlFileName)
                 GetLayer(sl)->Set("full_block_send_enable_min_time_from_building", pNode->Attribute("full_block_send_enable_min_time_from_building"));
             if (pNode->Attribute("profiler_print_interval"))
                 GetLayer(sl)->Set("profiler_print_interval", pNode->Attribute("profiler_print_interval"));
+            if (pNode->Attribute("profiler_trace_file"))
+                GetLayer(sl)->Set("profiler_trace_file", pNode->Attribute("profiler_trace_file"));
+            if (pNode->Attribute("snapshot_replication"))
+                GetLayer(sl)->Set("snapshot_replication", pNode->Attribute("snapshot_replication"));
+            if (pNode->Attribute("snapshot_budget"))
+                GetLayer(sl)->Set("snapshot_budget", pNode->Attribute("snapshot_budget"));
+            if (pNode->Attribute("snapshot_interval"))
+                GetLayer(sl)->Set("snapshot_interval", pNode->Attribute("snapshot_interval"));
             if (pNode->Attribute("max_block_send_distance"))
                 GetLayer(sl)->Set("max_block_send_distance", pNode->Attribute("max_block_send_distance"));
             if (pNode->Attribute("block_send_optimize_distance"))
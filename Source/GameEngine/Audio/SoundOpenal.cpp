@@ -38,8 +38,6 @@
 
 #include "SoundOpenal.h"
 
-#include "SoundResource.h"
-
 #include "Core/OS/OS.h"
 #include "Core/Utility/StringUtil.h"
 #include "Core/Logger/Logger.h"
@@ -145,6 +143,9 @@ bool OpenALSoundSystem::Init()
 OpenALSoundManager::OpenALSoundManager(OpenALSoundSystem* smg, OnDemandSoundFetcher* fetcher) :
 	BaseSoundManager(), mFetcher(fetcher), mDevice(smg->mDevice.get()), mContext(smg->mContext.get()), mNextId(1)
 {
+	mStreamThread = new OpenALStreamThread(this);
+	mStreamThread->Start();
+
 	LogInformation("Audio: Initialized: OpenAL ");
 }
 
@@ -152,6 +153,10 @@ OpenALSoundManager::~OpenALSoundManager()
 {
 	LogInformation("Audio: Deinitializing...");
 
+	mStreamThread->Stop();
+	mStreamThread->Wait();
+	delete mStreamThread;
+
 	std::unordered_set<int> sourceDelList;
 	for (auto const& sp : mSoundsPlaying)
 		sourceDelList.insert(sp.first);
@@ -171,6 +176,17 @@ OpenALSoundManager::~OpenALSoundManager()
 	LogInformation("Audio: Deinitialized.");
 }
 
+void* OpenALStreamThread::Run()
+{
+	// a buffer lasts over 300 ms even for 48 kHz stereo, polling every 10 ms keeps the ring full
+	while (!StopRequested())
+	{
+		mSoundMgr->UpdateStreams();
+		Timer::Sleep(10);
+	}
+	return nullptr;
+}
+
 void OpenALSoundManager::Step(float dTime)
 {
 	DoFades(dTime);
@@ -207,11 +223,10 @@ PlayingSound* OpenALSoundManager::CreatePlayingSound(SoundBuffer* buf, bool loop
     LogAssert(sound, "invalid sound");
 	WarnIfError(alGetError(), "before CreatePlayingSound");
 	alGenSources(1, &sound->sourceId);
-	alSourcei(sound->sourceId, AL_BUFFER, buf->bufferId);
+	AttachBuffer(sound, buf, loop);
 	alSourcei(sound->sourceId, AL_SOURCE_RELATIVE, true);
 	alSource3f(sound->sourceId, AL_POSITION, 0, 0, 0);
 	alSource3f(sound->sourceId, AL_VELOCITY, 0, 0, 0);
-	alSourcei(sound->sourceId, AL_LOOPING, loop ? AL_TRUE : AL_FALSE);
 	volume = std::fmax(0.0f, volume);
 	alSourcef(sound->sourceId, AL_GAIN, volume);
 	alSourcef(sound->sourceId, AL_PITCH, pitch);
@@ -229,7 +244,7 @@ PlayingSound* OpenALSoundManager::CreatePlayingSoundAt(SoundBuffer* buf, bool lo
     LogAssert(sound, "invalid sound");
 	WarnIfError(alGetError(), "before CreatePlayingSoundAt");
 	alGenSources(1, &sound->sourceId);
-	alSourcei(sound->sourceId, AL_BUFFER, buf->bufferId);
+	AttachBuffer(sound, buf, loop);
 	alSourcei(sound->sourceId, AL_SOURCE_RELATIVE, false);
 	alSource3f(sound->sourceId, AL_POSITION, pos[0], pos[1], pos[2]);
 	alSource3f(sound->sourceId, AL_VELOCITY, 0, 0, 0);
@@ -237,7 +252,6 @@ PlayingSound* OpenALSoundManager::CreatePlayingSoundAt(SoundBuffer* buf, bool lo
 	// distance to clamp gain at <1 node distance, to avoid excessive
 	// volume when closer
 	alSourcef(sound->sourceId, AL_REFERENCE_DISTANCE, 10.0f);
-	alSourcei(sound->sourceId, AL_LOOPING, loop ? AL_TRUE : AL_FALSE);
 	// Multiply by 3 to compensate for reducing AL_REFERENCE_DISTANCE from
 	// the previous value of 30 to the new value of 10
 	volume = std::fmax(0.0f, volume * 3.0f);
@@ -248,6 +262,104 @@ PlayingSound* OpenALSoundManager::CreatePlayingSoundAt(SoundBuffer* buf, bool lo
 	return sound;
 }
 
+void OpenALSoundManager::AttachBuffer(PlayingSound* sound, SoundBuffer* buf, bool loop)
+{
+	sound->loop = loop;
+	sound->stream = nullptr;
+	if (!buf->stream)
+	{
+		alSourcei(sound->sourceId, AL_BUFFER, buf->bufferId);
+		alSourcei(sound->sourceId, AL_LOOPING, loop ? AL_TRUE : AL_FALSE);
+		return;
+	}
+
+	// the stream loops by rewinding its decoder, the source never loops
+	StreamingSound* stream = new StreamingSound();
+	stream->resource = buf->stream;
+	stream->format = buf->format;
+	stream->loop = loop;
+	stream->finished = false;
+	stream->bytesPlayed = 0;
+	stream->decoder.Open(buf->stream->Buffer(), buf->stream->Size());
+	alGenBuffers(STREAM_BUFFERS, stream->bufferIds);
+
+	std::vector<char> data;
+	for (unsigned int i = 0; i < STREAM_BUFFERS; ++i)
+	{
+		if (!FillStreamBuffer(stream, stream->bufferIds[i], data))
+			break;
+		alSourceQueueBuffers(sound->sourceId, 1, &stream->bufferIds[i]);
+	}
+	alSourcei(sound->sourceId, AL_LOOPING, AL_FALSE);
+	sound->stream = stream;
+}
+
+bool OpenALSoundManager::FillStreamBuffer(StreamingSound* stream, ALuint bufferId, std::vector<char>& data)
+{
+	if (stream->finished)
+		return false;
+
+	data.resize(STREAM_BUFFER_SIZE);
+	unsigned int size = 0;
+	bool rewound = false;
+	while (size < STREAM_BUFFER_SIZE)
+	{
+		unsigned int read = stream->decoder.Read(&data[size], STREAM_BUFFER_SIZE - size);
+		if (read > 0)
+		{
+			size += read;
+			rewound = false;
+			continue;
+		}
+
+		// a looping sound starts over, unless nothing could be decoded since the last rewind
+		if (!stream->loop || rewound || !stream->decoder.Rewind())
+		{
+			stream->finished = true;
+			break;
+		}
+		rewound = true;
+	}
+	if (size == 0)
+		return false;
+
+	alBufferData(bufferId, stream->format, &data[0], size, stream->decoder.GetRate());
+	return true;
+}
+
+void OpenALSoundManager::UpdateStreams()
+{
+	MutexAutoLock lock(mStreamMutex);
+	for (auto const& ss : mSoundsStreaming)
+	{
+		PlayingSound* sound = ss.second;
+		StreamingSound* stream = sound->stream;
+
+		ALint processed = 0;
+		alGetSourcei(sound->sourceId, AL_BUFFERS_PROCESSED, &processed);
+		while (processed-- > 0)
+		{
+			ALuint bufferId;
+			alSourceUnqueueBuffers(sound->sourceId, 1, &bufferId);
+
+			ALint size = 0;
+			alGetBufferi(bufferId, AL_SIZE, &size);
+			stream->bytesPlayed += size;
+
+			if (FillStreamBuffer(stream, bufferId, mStreamData))
+				alSourceQueueBuffers(sound->sourceId, 1, &bufferId);
+		}
+
+		// the source stops when it runs out of buffers, resume it if there is more to play
+		ALint state, queued = 0;
+		alGetSourcei(sound->sourceId, AL_SOURCE_STATE, &state);
+		alGetSourcei(sound->sourceId, AL_BUFFERS_QUEUED, &queued);
+		if (state == AL_STOPPED && queued > 0)
+			alSourcePlay(sound->sourceId);
+	}
+	WarnIfError(alGetError(), "UpdateStreams");
+}
+
 int OpenALSoundManager::PlaySoundRaw(SoundBuffer* buf, bool loop, float volume, float pitch)
 {
 	LogAssert(buf, "invalid sound buffer");
@@ -256,6 +368,11 @@ int OpenALSoundManager::PlaySoundRaw(SoundBuffer* buf, bool loop, float volume,
 		return -1;
 	int id = mNextId++;
 	mSoundsPlaying[id] = sound;
+	if (sound->stream)
+	{
+		MutexAutoLock lock(mStreamMutex);
+		mSoundsStreaming[id] = sound;
+	}
 	return id;
 }
 
@@ -267,6 +384,11 @@ int OpenALSoundManager::PlaySoundRawAt(SoundBuffer* buf, bool loop, float volume
 		return -1;
 	int id = mNextId++;
 	mSoundsPlaying[id] = sound;
+	if (sound->stream)
+	{
+		MutexAutoLock lock(mStreamMutex);
+		mSoundsStreaming[id] = sound;
+	}
 	return id;
 }
 
@@ -277,8 +399,21 @@ void OpenALSoundManager::DeleteSound(int id)
 		return;
 	PlayingSound* sound = i->second;
 
+	if (sound->stream)
+	{
+		MutexAutoLock lock(mStreamMutex);
+		mSoundsStreaming.erase(id);
+	}
+
 	alDeleteSources(1, &sound->sourceId);
 
+	if (sound->stream)
+	{
+		// the buffers are released from the source once it is deleted
+		alDeleteBuffers(STREAM_BUFFERS, sound->stream->bufferIds);
+		delete sound->stream;
+	}
+
 	delete sound;
 	mSoundsPlaying.erase(id);
 }
@@ -319,7 +454,8 @@ void OpenALSoundManager::Maintain()
 		{
 			ALint state;
 			alGetSourcei(sound->sourceId, AL_SOURCE_STATE, &state);
-			if(state != AL_PLAYING)
+			// a stream which ran out of buffers is resumed by the stream thread
+			if(state != AL_PLAYING && (!sound->stream || sound->stream->finished))
 				delList.insert(id);
 		}
 	}
@@ -369,9 +505,6 @@ bool OpenALSoundManager::LoadSound(const std::string& name, const std::string& f
 				return false;
 		}//end switch
 
-		long bytes = resHandle->Size();
-		char* array = (char*)resHandle->WritableBuffer();
-
 		SoundBuffer* snd = new SoundBuffer;
 
 		// Check the number of channels... always use 16-bit samples
@@ -383,6 +516,18 @@ bool OpenALSoundManager::LoadSound(const std::string& name, const std::string& f
 		// The frequency of the sampling rate
 		snd->freq = extra->GetFormat()->nSamplesPerSec;
 
+		// Long sounds keep the compressed data, each playing sound decodes its own stream
+		if (extra->IsStreamed())
+		{
+			snd->bufferId = 0;
+			snd->stream = resHandle;
+			AddBuffer(name, snd);
+			return true;
+		}
+
+		long bytes = resHandle->Size();
+		char* array = (char*)resHandle->WritableBuffer();
+
 		// Append to end of buffer
 		snd->buffer.insert(snd->buffer.end(), array, array + bytes);
 
@@ -561,6 +706,18 @@ float OpenALSoundManager::GetSoundProgress(int id)
 		return 0;
 
 	PlayingSound* sound = i->second;
+	if (sound->stream)
+	{
+		// the byte offset is relative to the oldest queued buffer
+		MutexAutoLock lock(mStreamMutex);
+		ALint offset = 0;
+		alGetSourcei(sound->sourceId, AL_BYTE_OFFSET, &offset);
+		unsigned int size = sound->stream->decoder.GetSize();
+		if (size == 0)
+			return 0;
+		return (float)((sound->stream->bytesPlayed + offset) % size) / size;
+	}
+
 	ALfloat offset, size;
 	alGetSourcef(sound->sourceId, AL_BYTE_OFFSET, &offset);
 	alGetSourcef(sound->sourceId, AL_SIZE, &size);
@@ -62,11 +62,34 @@
 #include "GameEngineStd.h"
 
 #include "Sound.h"
+#include "SoundResource.h"
+
+#include "Core/Threading/Thread.h"
+
+// buffers queued ahead on a streaming source and their size in bytes
+#define STREAM_BUFFERS 4
+#define STREAM_BUFFER_SIZE (64 * 1024)
+
+/*
+	StreamingSound decodes a long sound while it plays. Its source has a small ring of
+	buffers queued, the stream thread refills the buffers which have been played.
+*/
+struct StreamingSound
+{
+    OggDecoder decoder;
+    std::shared_ptr<ResHandle> resource; // keeps the compressed sound alive
+    ALuint bufferIds[STREAM_BUFFERS];
+    ALenum format;
+    bool loop;
+    std::atomic<bool> finished; // the decoder reached the end of a non looping sound
+    std::atomic<unsigned int> bytesPlayed; // decoded bytes of the buffers already played
+};
 
 struct PlayingSound
 {
     ALuint sourceId;
     bool loop;
+    StreamingSound* stream; // null for the sounds played from a single buffer
 };
 
 struct BufferSource
@@ -82,6 +105,7 @@ struct SoundBuffer
     ALsizei freq;
     ALuint bufferId;
     std::vector<char> buffer;
+    std::shared_ptr<ResHandle> stream; // compressed sound decoded while it plays, if any
 };
 
 typedef std::unique_ptr<ALCdevice, void(*)(ALCdevice* p)> unique_ptr_alcdevice;
@@ -101,8 +125,26 @@ public:
     virtual bool Init();
 };
 
+class OpenALSoundManager;
+
+class OpenALStreamThread : public Thread
+{
+public:
+    OpenALStreamThread(OpenALSoundManager* soundMgr) : Thread("OpenALStream"), mSoundMgr(soundMgr)
+    {
+
+    }
+
+    virtual void* Run();
+
+private:
+    OpenALSoundManager* mSoundMgr;
+};
+
 class OpenALSoundManager : public BaseSoundManager
 {
+    friend class OpenALStreamThread;
+
 public:
     OpenALSoundManager(OpenALSoundSystem* ss, OnDemandSoundFetcher* fetcher);
 
@@ -155,6 +197,12 @@ public:
     float GetSoundProgress(int id);
 
 private:
+    void AttachBuffer(PlayingSound* sound, SoundBuffer* buf, bool loop);
+    bool FillStreamBuffer(StreamingSound* stream, ALuint bufferId, std::vector<char>& data);
+
+    // Refill the played buffers of the streaming sounds, called from the stream thread
+    void UpdateStreams();
+
     OnDemandSoundFetcher* mFetcher;
     ALCdevice* mDevice;
     ALCcontext* mContext;
@@ -174,6 +222,12 @@ private:
 
     std::unordered_map<int, FadeState> mSoundsFading;
 
+    // streaming sounds are shared with the stream thread
+    std::mutex mStreamMutex;
+    std::unordered_map<int, PlayingSound*> mSoundsStreaming;
+    std::vector<char> mStreamData;
+    OpenALStreamThread* mStreamThread;
+
 };
 
 #endif
\ No newline at end of file
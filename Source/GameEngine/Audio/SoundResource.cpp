@@ -49,6 +49,8 @@
 #include "SoundResource.h"
 #include "Sound.h"
 
+#include "Application/Settings.h"
+
 	
 //
 // SoundResource::SoundResource			- Chapter X, page 362
@@ -56,6 +58,7 @@
 SoundResourceExtraData::SoundResourceExtraData()
 :	mSoundType(SOUND_TYPE_UNKNOWN),
 	mIsInitialized(false),
+	mIsStreamed(false),
 	mLength(0)
 {	
 	// don't do anything yet - timing sound Initialization is important!
@@ -384,6 +387,24 @@ long VorbisTell(void *data_src)
 	return static_cast<long>(pVorbisData->dataRead);
 }
 
+//
+// GetOggStreamThreshold
+//
+//   Decoded size in bytes from which an ogg sound is kept compressed and streamed,
+//   zero decodes every sound at load time
+//
+static unsigned int GetOggStreamThreshold()
+{
+	return Settings::Get()->Exists("sound_stream_threshold") ?
+		Settings::Get()->GetUInt("sound_stream_threshold") : 0;
+}
+
+static bool IsOggStreamed(unsigned long decodedSize)
+{
+	unsigned int threshold = GetOggStreamThreshold();
+	return threshold > 0 && decodedSize > threshold;
+}
+
 std::shared_ptr<BaseResourceLoader> CreateWAVResourceLoader()
 {
 	return std::shared_ptr<BaseResourceLoader>(new WaveResourceLoader());
@@ -431,6 +452,10 @@ unsigned int OggResourceLoader::GetLoadedResourceSize(void *rawBuffer, unsigned
 
 	delete vorbisMemoryFile;
 
+	// long sounds keep the compressed data
+	if (IsOggStreamed(bytes))
+		return rawSize;
+
 	return bytes;
 }
 
@@ -506,6 +531,18 @@ bool OggResourceLoader::ParseOgg(char *oggStream, size_t length, std::shared_ptr
 	DWORD bytes = (DWORD)ov_pcm_total(&vf, -1);
 	bytes *= 2 * vi->channels;
 
+	if (IsOggStreamed(bytes) && handle->Size() == length)
+	{
+		// the sound manager decodes it while it plays
+		memcpy(handle->WritableBuffer(), oggStream, length);
+		extra->mIsStreamed = true;
+		extra->mLength = (int)(1000.f * ov_time_total(&vf, -1));
+
+		ov_clear(&vf);
+		delete vorbisMemoryFile;
+		return true;
+	}
+
 	if (handle->Size() != bytes)
 	{
 		LogAssert(0, "The Ogg size does not match the memory buffer size!");
@@ -530,4 +567,78 @@ bool OggResourceLoader::ParseOgg(char *oggStream, size_t length, std::shared_ptr
 	ov_clear(&vf);
 	delete vorbisMemoryFile;
 	return true;
-}
\ No newline at end of file
+}
+
+
+OggDecoder::OggDecoder() : mMemoryFile(nullptr), mChannels(0), mRate(0), mSize(0)
+{
+
+}
+
+OggDecoder::~OggDecoder()
+{
+	Close();
+}
+
+bool OggDecoder::Open(const void* oggStream, size_t length)
+{
+	Close();
+
+	mMemoryFile = new OggMemoryFile();
+	mMemoryFile->dataRead = 0;
+	mMemoryFile->dataSize = length;
+	mMemoryFile->dataPtr = (unsigned char *)oggStream;
+
+	ov_callbacks oggCallbacks;
+	oggCallbacks.read_func = VorbisRead;
+	oggCallbacks.close_func = VorbisClose;
+	oggCallbacks.seek_func = VorbisSeek;
+	oggCallbacks.tell_func = VorbisTell;
+
+	if (ov_open_callbacks(mMemoryFile, &mVorbisFile, NULL, 0, oggCallbacks) < 0)
+	{
+		LogWarning("Failed to open the ogg stream");
+		delete mMemoryFile;
+		mMemoryFile = nullptr;
+		return false;
+	}
+
+	vorbis_info *vi = ov_info(&mVorbisFile, -1);
+	mChannels = vi->channels;
+	mRate = vi->rate;
+	mSize = (unsigned int)ov_pcm_total(&mVorbisFile, -1) * 2 * mChannels;
+	return true;
+}
+
+void OggDecoder::Close()
+{
+	if (mMemoryFile)
+	{
+		ov_clear(&mVorbisFile);
+		delete mMemoryFile;
+		mMemoryFile = nullptr;
+	}
+}
+
+unsigned int OggDecoder::Read(char* buffer, unsigned int size)
+{
+	if (!mMemoryFile)
+		return 0;
+
+	// ov_read returns at most one vorbis packet per call
+	unsigned int pos = 0;
+	int sec = 0;
+	while (pos < size)
+	{
+		long ret = ov_read(&mVorbisFile, buffer + pos, size - pos, 0, 2, 1, &sec);
+		if (ret <= 0)
+			break;
+		pos += ret;
+	}
+	return pos;
+}
+
+bool OggDecoder::Rewind()
+{
+	return mMemoryFile && ov_pcm_seek(&mVorbisFile, 0) == 0;
+}
@@ -44,6 +44,7 @@
 #include "Core/IO/ResourceCache.h"
 
 #include <mmsystem.h>
+#include <vorbis/vorbisfile.h>
 
 /*
 	A Resource encapsulates sound data, presumably loaded from a file or resource cache.
@@ -80,10 +81,12 @@ public:
 	enum SoundType GetSoundType() { return mSoundType; }
 	WAVEFORMATEX const *GetFormat() { return &mWavFormatEx; }
 	int GetLength() const { return mLength; }
+	bool IsStreamed() const { return mIsStreamed; }
 
 protected:
 	enum SoundType mSoundType; // is this an Ogg, WAV, etc.?
 	bool mIsInitialized; // has the sound been initialized
+	bool mIsStreamed; // the buffer keeps the compressed sound, it is decoded while it plays
 	WAVEFORMATEX mWavFormatEx; // description of the PCM format
 	int mLength; // how long the sound is in milliseconds
 };
@@ -123,7 +126,9 @@ protected:
 	OGG (and MP3) files are compressed sound file formats which can achieve certain compression
 	ratio with only a barely perceptible loss in sound quality.
 	ParseOgg() method decompresses an OGG memory buffer using the Vorbis API. The method will
-	decompress the OGG stream into a PCM buffer.
+	decompress the OGG stream into a PCM buffer. Long sounds such as music, whose decoded size is
+	over the "sound_stream_threshold" setting, stay compressed in the cache instead and are decoded
+	a few buffers ahead of the playing position by the sound manager.
 */
 class OggResourceLoader : public BaseResourceLoader
 {
@@ -142,4 +147,35 @@ protected:
 	bool ParseOgg(char *oggStream, size_t length, std::shared_ptr<ResHandle> handle);
 };
 
+struct OggMemoryFile;
+
+/*
+	OggDecoder decodes an OGG memory buffer progressively, so that a streamed sound only needs
+	the compressed data and the few PCM buffers being played.
+*/
+class OggDecoder
+{
+public:
+	OggDecoder();
+	~OggDecoder();
+
+	bool Open(const void* oggStream, size_t length);
+	void Close();
+
+	// decodes up to size bytes of 16 bit PCM, returns 0 at the end of the sound
+	unsigned int Read(char* buffer, unsigned int size);
+	bool Rewind();
+
+	unsigned int GetChannels() const { return mChannels; }
+	unsigned int GetRate() const { return mRate; }
+	unsigned int GetSize() const { return mSize; }
+
+private:
+	OggVorbis_File mVorbisFile;
+	OggMemoryFile* mMemoryFile;
+	unsigned int mChannels;
+	unsigned int mRate;
+	unsigned int mSize; // decoded size in bytes
+};
+
 #endif
\ No newline at end of file
@@ -53,6 +53,7 @@ const BaseEventType EventDataNewRenderComponent::skEventType(0xaf4aff75);
 const BaseEventType EventDataModifiedRenderComponent::skEventType(0x80fe9766);
 const BaseEventType EventDataRequestStartGame::skEventType(0x11f2b19d);
 const BaseEventType EventDataRemoteClient::skEventType(0x301693d5);
+const BaseEventType EventDataSnapshotAck::skEventType(0x5c2e81b7);
 const BaseEventType EventDataNetworkPlayerActorAssignment::skEventType(0xa7c92f11);
 const BaseEventType EventDataUpdateTick::skEventType(0xf0f5d183);
 const BaseEventType EventDataDecompressRequest::skEventType(0xc128a129);
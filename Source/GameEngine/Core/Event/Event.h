@@ -42,6 +42,8 @@
 #include "EventManager.h"
 
 #include "Core/Logger/Logger.h"
+#include "Core/Utility/Serialize.h"
+#include "Core/Utility/StringUtil.h"
 #include "Graphic/Scene/Hierarchy/Node.h"
 #include "Mathematic/Algebra/Transform.h"
 
@@ -90,6 +92,18 @@ public:
 		out << mViewId << " ";
 	}
 
+	virtual void SerializeBinary(std::ostream& out) const
+	{
+		WriteUInt32(out, mActorId);
+		WriteUInt32(out, mViewId);
+	}
+
+	virtual void DeserializeBinary(std::istream& in)
+	{
+		mActorId = ReadUInt32(in);
+		mViewId = ReadUInt32(in);
+	}
+
 
     virtual const char* GetName(void) const
     {
@@ -144,6 +158,16 @@ public:
         in >> mId;
     }
 
+	virtual void SerializeBinary(std::ostream& out) const
+	{
+		WriteUInt32(out, mId);
+	}
+
+	virtual void DeserializeBinary(std::istream& in)
+	{
+		mId = ReadUInt32(in);
+	}
+
     virtual const char* GetName(void) const
     {
         return "EventDataDestroyActor";
@@ -198,9 +222,21 @@ public:
 				in >> transform(i, j);
 	}
 
+	virtual void SerializeBinary(std::ostream& out) const
+	{
+		WriteUInt32(out, mId);
+		WriteTransform(out, mTransform);
+	}
+
+	virtual void DeserializeBinary(std::istream& in)
+	{
+		mId = ReadUInt32(in);
+		mTransform = ReadTransform(in);
+	}
+
 	virtual BaseEventDataPtr Copy() const
 	{
-		return BaseEventDataPtr(new EventDataSyncActor(mId, mTransform));
+		return MakeEvent<EventDataSyncActor>(mId, mTransform);
 	}
 
 	virtual const char* GetName(void) const
@@ -313,6 +349,16 @@ public:
         in >> mId;
     }
 
+	virtual void SerializeBinary(std::ostream& out) const
+	{
+		WriteUInt32(out, mId);
+	}
+
+	virtual void DeserializeBinary(std::istream& in)
+	{
+		mId = ReadUInt32(in);
+	}
+
 	virtual BaseEventDataPtr Copy() const
 	{
 		return BaseEventDataPtr(new EventDataModifiedRenderComponent(mId));
@@ -445,6 +491,18 @@ public:
         in >> mIPAddress;
     }
 
+	virtual void SerializeBinary(std::ostream& out) const
+	{
+		WriteInt32(out, mSocketId);
+		WriteInt32(out, mIPAddress);
+	}
+
+	virtual void DeserializeBinary(std::istream& in)
+	{
+		mSocketId = ReadInt32(in);
+		mIPAddress = ReadInt32(in);
+	}
+
     int GetSocketId(void) const
     {
         return mSocketId;
@@ -457,6 +515,79 @@ public:
 };
 
 
+//---------------------------------------------------------------------------------------------------------------------
+// EventDataSnapshotAck - sent by the server socket when a client acknowledges an actor snapshot
+//---------------------------------------------------------------------------------------------------------------------
+class EventDataSnapshotAck : public EventData
+{
+	int mSocketId;
+	unsigned int mSequence;
+
+public:
+	static const BaseEventType skEventType;
+
+	EventDataSnapshotAck(void)
+	{
+		mSocketId = 0;
+		mSequence = 0;
+	}
+
+	EventDataSnapshotAck(const int socketId, const unsigned int sequence)
+		: mSocketId(socketId), mSequence(sequence)
+	{
+	}
+
+	virtual const BaseEventType& GetEventType(void) const
+	{
+		return skEventType;
+	}
+
+	virtual BaseEventDataPtr Copy() const
+	{
+		return BaseEventDataPtr(new EventDataSnapshotAck(mSocketId, mSequence));
+	}
+
+	virtual const char* GetName(void) const
+	{
+		return "EventDataSnapshotAck";
+	}
+
+	virtual void Serialize(std::ostrstream& out) const
+	{
+		out << mSocketId << " ";
+		out << mSequence;
+	}
+
+	virtual void Deserialize(std::istrstream& in)
+	{
+		in >> mSocketId;
+		in >> mSequence;
+	}
+
+	virtual void SerializeBinary(std::ostream& out) const
+	{
+		WriteInt32(out, mSocketId);
+		WriteUInt32(out, mSequence);
+	}
+
+	virtual void DeserializeBinary(std::istream& in)
+	{
+		mSocketId = ReadInt32(in);
+		mSequence = ReadUInt32(in);
+	}
+
+	int GetSocketId(void) const
+	{
+		return mSocketId;
+	}
+
+	unsigned int GetSequence(void) const
+	{
+		return mSequence;
+	}
+};
+
+
 //---------------------------------------------------------------------------------------------------------------------
 // EventDataUpdateTick - sent by the game logic each game tick
 //---------------------------------------------------------------------------------------------------------------------
@@ -545,6 +676,18 @@ public:
         in >> mSocketId;
     }
 
+	virtual void SerializeBinary(std::ostream& out) const
+	{
+		WriteUInt32(out, mActorId);
+		WriteInt32(out, mSocketId);
+	}
+
+	virtual void DeserializeBinary(std::istream& in)
+	{
+		mActorId = ReadUInt32(in);
+		mSocketId = ReadInt32(in);
+	}
+
     ActorId GetActorId(void) const
     {
         return mActorId;
@@ -733,6 +876,26 @@ public:
 		out << mViewId << " ";
 	}
 
+	virtual void SerializeBinary(std::ostream& out) const
+	{
+		out << SerializeString16(mActorResource);
+		WriteUInt8(out, mIsInitialTransform);
+		if (mIsInitialTransform)
+			WriteTransform(out, mInitialTransform);
+		WriteUInt32(out, mServerActorId);
+		WriteUInt32(out, mViewId);
+	}
+
+	virtual void DeserializeBinary(std::istream& in)
+	{
+		mActorResource = DeserializeString16(in);
+		mIsInitialTransform = ReadUInt8(in) != 0;
+		if (mIsInitialTransform)
+			mInitialTransform = ReadTransform(in);
+		mServerActorId = ReadUInt32(in);
+		mViewId = ReadUInt32(in);
+	}
+
     virtual const char* GetName(void) const { return "EventDataRequestNewActor";  }
 
     const std::string &GetActorResource(void) const { return mActorResource;  }
@@ -782,6 +945,16 @@ public:
         out << mActorId;
     }
 
+    virtual void SerializeBinary(std::ostream& out) const
+    {
+        WriteUInt32(out, mActorId);
+    }
+
+    virtual void DeserializeBinary(std::istream& in)
+    {
+        mActorId = ReadUInt32(in);
+    }
+
     virtual const char* GetName(void) const
     {
         return "EventDataRequestDestroyActor";
@@ -818,6 +991,16 @@ public:
         return BaseEventDataPtr(new EventDataChatMessage(mMessage));
     }
 
+    virtual void SerializeBinary(std::ostream& out) const
+    {
+        out << SerializeString32(ToString(mMessage));
+    }
+
+    virtual void DeserializeBinary(std::istream& in)
+    {
+        mMessage = ToWideString(DeserializeString32(in));
+    }
+
     const std::wstring& GetResource(void) const
     {
         return mMessage;
@@ -868,6 +1051,18 @@ public:
         //out << mNote << " ";
     }
 
+    virtual void SerializeBinary(std::ostream& out) const
+    {
+        WriteUInt32(out, mActor);
+        out << SerializeString32(ToString(mNote));
+    }
+
+    virtual void DeserializeBinary(std::istream& in)
+    {
+        mActor = ReadUInt32(in);
+        mNote = ToWideString(DeserializeString32(in));
+    }
+
     ActorId GetActorId(void) const
     {
         return mActor;
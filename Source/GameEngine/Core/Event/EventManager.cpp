@@ -39,6 +39,7 @@
 #include "EventManager.h"
 
 #include "Core/Logger/Logger.h"
+#include "Core/Utility/Serialize.h"
 
 BaseEventManager* BaseEventManager::mEventMgr = NULL;
 GenericObjectFactory<BaseEventData, BaseEventType> mEventFactory;
@@ -73,11 +74,125 @@ BaseEventManager::~BaseEventManager(void)
 }
 
 
+//---------------------------------------------------------------------------------------------------------------------
+// EventData
+//---------------------------------------------------------------------------------------------------------------------
+void EventData::SerializeBinary(std::ostream& out) const
+{
+	std::ostrstream text;
+	Serialize(text);
+
+	out << SerializeString32(std::string(text.str(), text.pcount()));
+	text.freeze(false);
+}
+
+void EventData::DeserializeBinary(std::istream& in)
+{
+	std::string text = DeserializeString32(in);
+	std::istrstream textIn(text.c_str(), text.size());
+	Deserialize(textIn);
+}
+
+
+//---------------------------------------------------------------------------------------------------------------------
+// EventQueue
+//---------------------------------------------------------------------------------------------------------------------
+EventQueue::EventQueue(void) : mHead(0), mSize(0)
+{
+	mEvents.resize(64);
+}
+
+void EventQueue::Grow(void)
+{
+	// the events are moved to the start of a ring twice as big
+	std::vector<BaseEventDataPtr> events(mEvents.size() * 2);
+	for (size_t index = 0; index < mSize; index++)
+		events[index] = std::move(At(index));
+
+	mEvents.swap(events);
+	mHead = 0;
+}
+
+void EventQueue::PushBack(const BaseEventDataPtr& pEvent)
+{
+	if (mSize == mEvents.size())
+		Grow();
+
+	At(mSize) = pEvent;
+	mSize++;
+}
+
+void EventQueue::PushFront(const BaseEventDataPtr& pEvent)
+{
+	if (mSize == mEvents.size())
+		Grow();
+
+	mHead = (mHead + mEvents.size() - 1) & (mEvents.size() - 1);
+	At(0) = pEvent;
+	mSize++;
+}
+
+bool EventQueue::PopFront(BaseEventDataPtr& pEvent)
+{
+	if (mSize == 0)
+		return false;
+
+	pEvent = std::move(At(0));
+	At(0).reset();
+	mHead = (mHead + 1) & (mEvents.size() - 1);
+	mSize--;
+	return true;
+}
+
+bool EventQueue::PopBack(BaseEventDataPtr& pEvent)
+{
+	if (mSize == 0)
+		return false;
+
+	pEvent = std::move(At(mSize - 1));
+	At(mSize - 1).reset();
+	mSize--;
+	return true;
+}
+
+void EventQueue::Clear(void)
+{
+	for (size_t index = 0; index < mSize; index++)
+		At(index).reset();
+
+	mHead = 0;
+	mSize = 0;
+}
+
+bool EventQueue::Remove(const BaseEventType& type, bool allOfType)
+{
+	// the events which are kept are compacted towards the front, keeping their order
+	size_t kept = 0;
+	bool removed = false;
+	for (size_t index = 0; index < mSize; index++)
+	{
+		if ((!removed || allOfType) && At(index)->GetEventType() == type)
+		{
+			At(index).reset();
+			removed = true;
+			continue;
+		}
+
+		if (kept != index)
+			At(kept) = std::move(At(index));
+		kept++;
+	}
+
+	mSize = kept;
+	return removed;
+}
+
+
 //---------------------------------------------------------------------------------------------------------------------
 // EventManager::EventManager
 //---------------------------------------------------------------------------------------------------------------------
 EventManager::EventManager(const char* pName, bool setAsGlobal)
-	: BaseEventManager(pName, setAsGlobal)
+	: BaseEventManager(pName, setAsGlobal), mRealtimeEventQueue(EVENTMANAGER_REALTIME_QUEUE_SIZE)
 {
 	mActiveQueue = 0;
 }
@@ -162,10 +277,11 @@ bool EventManager::TriggerEvent(const BaseEventDataPtr& pEvent) const
 	auto findIt = mEventListeners.find(pEvent->GetEventType());
 	if (findIt != mEventListeners.end())
 	{
+		// listeners may be added while the event is sent, so they are walked by index
 		const EventListenerList& eventListenerList = findIt->second;
-		for (EventListenerList::const_iterator it = eventListenerList.begin(); it != eventListenerList.end(); ++it)
+		for (size_t index = 0; index < eventListenerList.size(); ++index)
 		{
-			EventListenerDelegate listener = (*it);
+			EventListenerDelegate listener = eventListenerList[index];
 			//LogInformation("Events " + std::string("Sending Event ") + std::string(pEvent->GetName()) + std::string(" to delegate."));
 			listener(pEvent);  // call the delegate
 			processed = true;
@@ -197,7 +313,7 @@ bool EventManager::QueueEvent(const BaseEventDataPtr& pEvent)
 	if (findIt != mEventListeners.end())
 	{
 		MutexAutoLock lock(mMutex);
-		mQueues[mActiveQueue].push_back(pEvent);
+		mQueues[mActiveQueue].PushBack(pEvent);
 		//LogInformation("Events " + std::string("Successfully queued event: ") + std::string(pEvent->GetName()));
 		return true;
 	}
@@ -211,22 +327,15 @@ bool EventManager::QueueEvent(const BaseEventDataPtr& pEvent)
 void EventManager::ClearQueue(int queueToClear)
 {
 	MutexAutoLock lock(mMutex);
-	mQueues[mActiveQueue].clear();
+	mQueues[mActiveQueue].Clear();
 }
 
 bool EventManager::ProccessQueue(BaseEventDataPtr& pEvent, int queueToProcess)
 {
 	MutexAutoLock lock(mMutex);
 
-	if (!mQueues[queueToProcess].empty())
-	{
-		// pop the front of the queue
-		pEvent = mQueues[queueToProcess].front();
-		mQueues[queueToProcess].pop_front();
-		return true;
-	}
-
-	return false;
+	// pop the front of the queue
+	return mQueues[queueToProcess].PopFront(pEvent);
 }
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -234,7 +343,11 @@ bool EventManager::ProccessQueue(BaseEventDataPtr& pEvent, int queueToProcess)
 //---------------------------------------------------------------------------------------------------------------------
 bool EventManager::ThreadSafeQueueEvent(const BaseEventDataPtr& pEvent)
 {
-	mRealtimeEventQueue.Push(pEvent);
+	if (!mRealtimeEventQueue.Push(pEvent))
+	{
+		LogError("The realtime event queue is full, the event " + std::string(pEvent->GetName()) + " is dropped");
+		return false;
+	}
 	return true;
 }
 
@@ -254,23 +367,7 @@ bool EventManager::AbortEvent(const BaseEventType& inType, bool allOfType)
 	if (findIt != mEventListeners.end())
 	{
 		MutexAutoLock lock(mMutex);
-		EventQueue& eventQueue = mQueues[mActiveQueue];
-		auto it = eventQueue.begin();
-		while (it != eventQueue.end())
-		{
-			// Removing an item from the queue will invalidate the iterator, so have it point to the next member.  All
-			// work inside this loop will be done using thisIt.
-			auto thisIt = it;
-			++it;
-
-			if ((*thisIt)->GetEventType() == inType)
-			{
-				eventQueue.erase(thisIt);
-				success = true;
-				if (!allOfType)
-					break;
-			}
-		}
+		success = mQueues[mActiveQueue].Remove(inType, allOfType);
 	}
 
 	return success;
@@ -332,9 +429,9 @@ bool EventManager::Update(unsigned long maxTime)
 				+ std::string(" delegates"));
 			*/
 			// call each listener
-			for (auto it = eventListeners.begin(); it != eventListeners.end(); ++it)
+			for (size_t index = 0; index < eventListeners.size(); ++index)
 			{
-				EventListenerDelegate listener = (*it);
+				EventListenerDelegate listener = eventListeners[index];
 				/*
 				LogInformation("EventLoop " + std::string("\t\tSending event ") + std::string(pEvent->GetName())
 					+ std::string(" to delegate"));
@@ -355,15 +452,12 @@ bool EventManager::Update(unsigned long maxTime)
 	// If we couldn't process all of the events, push the remaining events to the new active queue.
 	// Note: To preserve sequencing, go back-to-front, inserting them at the head of the active queue
 	MutexAutoLock lock(mMutex);
-	bool queueFlushed = (mQueues[queueToProcess].empty());
+	bool queueFlushed = (mQueues[queueToProcess].Empty());
 	if (!queueFlushed)
 	{
-		while (!mQueues[queueToProcess].empty())
-		{
-			BaseEventDataPtr pEvent = mQueues[queueToProcess].back();
-			mQueues[queueToProcess].pop_back();
-			mQueues[mActiveQueue].push_front(pEvent);
-		}
+		BaseEventDataPtr pEvent;
+		while (mQueues[queueToProcess].PopBack(pEvent))
+			mQueues[mActiveQueue].PushFront(pEvent);
 	}
 
 	return queueFlushed;
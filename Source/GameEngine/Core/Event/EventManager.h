@@ -42,9 +42,10 @@
 
 #include "GameEngineStd.h"
 
-#include "Core/Process/CriticalSection.h"
 #include "Core/Threading/Thread.h"
+#include "Core/Threading/MpscQueue.h"
 
+#include <mutex>
 #include <strstream>
 
 /*
@@ -98,7 +99,7 @@ class BaseEventData;
 typedef unsigned long BaseEventType;
 typedef std::shared_ptr<BaseEventData> BaseEventDataPtr;
 typedef fastdelegate::FastDelegate1<BaseEventDataPtr> EventListenerDelegate;
-typedef ConcurrentQueue<BaseEventDataPtr> ThreadSafeEventQueue;
+typedef MpscQueue<BaseEventDataPtr> ThreadSafeEventQueue;
 
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -122,6 +123,8 @@ public:
 	virtual float GetTimeStamp(void) const = 0;
 	virtual void Serialize(std::ostrstream& out) const = 0;
     virtual void Deserialize(std::istrstream& in) = 0;
+	virtual void SerializeBinary(std::ostream& out) const = 0;
+	virtual void DeserializeBinary(std::istream& in) = 0;
 	virtual BaseEventDataPtr Copy(void) const = 0;
     virtual const char* GetName(void) const = 0;
 };
@@ -145,8 +148,112 @@ public:
 	// Serializing for network input / output
 	virtual void Serialize(std::ostrstream &out) const	{ }
     virtual void Deserialize(std::istrstream& in) { }
+
+	// Compact binary form sent by the network layer. Events which don't override it are sent as their
+	// text serialization prefixed by its length
+	virtual void SerializeBinary(std::ostream& out) const;
+	virtual void DeserializeBinary(std::istream& in);
+};
+
+
+//---------------------------------------------------------------------------------------------------------------------
+// EventPool
+// Free list of memory blocks of the same size, shared by the events which fit in them. The blocks are allocated in
+// pages and reused as soon as the events are released, so the events created every frame don't go to the heap.
+//---------------------------------------------------------------------------------------------------------------------
+const unsigned int EVENTPOOL_PAGE_BLOCKS = 64;
+
+template <size_t Size>
+class EventPool
+{
+public:
+
+	// the pool is never destroyed, events may still be released while the statics are being destroyed
+	static EventPool* Get(void)
+	{
+		static EventPool* pool = new EventPool();
+		return pool;
+	}
+
+	void* Allocate(void)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (!mFreeBlocks)
+		{
+			Block* page = new Block[EVENTPOOL_PAGE_BLOCKS];
+			for (unsigned int block = 0; block < EVENTPOOL_PAGE_BLOCKS; block++)
+				page[block].mNext = block + 1 < EVENTPOOL_PAGE_BLOCKS ? &page[block + 1] : NULL;
+			mFreeBlocks = page;
+		}
+
+		Block* block = mFreeBlocks;
+		mFreeBlocks = block->mNext;
+		return block;
+	}
+
+	void Release(void* pointer)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		Block* block = static_cast<Block*>(pointer);
+		block->mNext = mFreeBlocks;
+		mFreeBlocks = block;
+	}
+
+private:
+
+	union alignas(16) Block
+	{
+		Block* mNext;
+		char mData[Size];
+	};
+
+	EventPool(void) : mFreeBlocks(NULL) { }
+
+	Block* mFreeBlocks;
+	std::mutex mMutex;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+// EventAllocator
+// Allocator for std::allocate_shared which takes the memory from the event pools. The event and its reference count
+// are allocated together in a single block of the pool.
+//---------------------------------------------------------------------------------------------------------------------
+template <typename Type>
+class EventAllocator
+{
+public:
+	typedef Type value_type;
+
+	EventAllocator(void) { }
+	template <typename Other> EventAllocator(const EventAllocator<Other>&) { }
+
+	Type* allocate(size_t count)
+	{
+		if (count != 1)
+			return static_cast<Type*>(::operator new(count * sizeof(Type)));
+		return static_cast<Type*>(EventPool<sizeof(Type)>::Get()->Allocate());
+	}
+
+	void deallocate(Type* pointer, size_t count)
+	{
+		if (count != 1)
+			::operator delete(pointer);
+		else
+			EventPool<sizeof(Type)>::Get()->Release(pointer);
+	}
+
+	template <typename Other> bool operator==(const EventAllocator<Other>&) const { return true; }
+	template <typename Other> bool operator!=(const EventAllocator<Other>&) const { return false; }
 };
 
+// Creates an event from the event pools. It should be preferred over std::make_shared for the events which are sent
+// often, such as the actor updates of every frame.
+template <typename Type, typename... Arguments>
+std::shared_ptr<Type> MakeEvent(Arguments&&... arguments)
+{
+	return std::allocate_shared<Type>(EventAllocator<Type>(), std::forward<Arguments>(arguments)...);
+}
+
 
 //---------------------------------------------------------------------------------------------------------------------
 // BaseEventManager Description                        Chapter 11, page 314
@@ -215,6 +322,40 @@ protected:
 };
 
 const unsigned int EVENTMANAGER_NUM_QUEUES = 2;
+const unsigned int EVENTMANAGER_REALTIME_QUEUE_SIZE = 16384;
+
+//---------------------------------------------------------------------------------------------------------------------
+// EventQueue
+// Ring buffer of events. It grows when it is full and never shrinks, so once the game reaches its usual event load
+// queueing events doesn't allocate memory anymore.
+//---------------------------------------------------------------------------------------------------------------------
+class EventQueue
+{
+public:
+	EventQueue(void);
+
+	bool Empty(void) const { return mSize == 0; }
+	size_t Size(void) const { return mSize; }
+
+	void PushBack(const BaseEventDataPtr& pEvent);
+	void PushFront(const BaseEventDataPtr& pEvent);
+	bool PopFront(BaseEventDataPtr& pEvent);
+	bool PopBack(BaseEventDataPtr& pEvent);
+	void Clear(void);
+
+	// removes the first event of the given type or all of them, returns true if any event was removed
+	bool Remove(const BaseEventType& type, bool allOfType);
+
+private:
+	void Grow(void);
+
+	BaseEventDataPtr& At(size_t index) { return mEvents[(mHead + index) & (mEvents.size() - 1)]; }
+
+	std::vector<BaseEventDataPtr> mEvents;
+	size_t mHead;
+	size_t mSize;
+};
+
 
 /*
 	The implementation of EventManager manages two sets of objects: event data and listener delegates. As events
@@ -226,13 +367,11 @@ const unsigned int EVENTMANAGER_NUM_QUEUES = 2;
 class EventManager : public BaseEventManager
 {
 	/*
-		The defined data structure are used to register listener delegate functions. Each event has a list of
-		delegates to call when the event is triggered. The EventQueue defines a list of smart pointers to
-		BaseEventData objects.
+		The defined data structure are used to register listener delegate functions. Each event type has an
+		array of delegates to call when the event is triggered, found by hashing the event type.
 	*/
-	typedef std::list<EventListenerDelegate> EventListenerList;
-	typedef std::map<BaseEventType, EventListenerList> EventListenerMap;
-	typedef std::list<BaseEventDataPtr> EventQueue;
+	typedef std::vector<EventListenerDelegate> EventListenerList;
+	typedef std::unordered_map<BaseEventType, EventListenerList> EventListenerMap;
 
 	/*
 		There are two event queues here so that delegate methods can safely queue up new events. It is necessary
@@ -11,6 +11,8 @@
 class BaseReadFile
 {
 public:
+	virtual ~BaseReadFile() {}
+
 	//! Reads an amount of bytes from the file.
 	/** \param buffer Pointer to buffer where read bytes are written to.
 	\param sizeToRead Amount of bytes to read from the file.
@@ -53,7 +53,8 @@ BaseResource::BaseResource(const std::wstring& resourceName)
 //
 ResHandle::ResHandle(BaseResource& resource, void* buffer, 
 	unsigned int size, bool isRawBuffer, ResCache* resCache)
-: mResource(resource)
+: mResource(resource), mPrev(nullptr), mNext(nullptr), 
+	mLoaderPrev(nullptr), mLoaderNext(nullptr), mLoader(nullptr), mCached(false)
 {
 	mBuffer = buffer;
 	mIsRawBuffer = isRawBuffer;
@@ -72,6 +73,8 @@ ResHandle::~ResHandle()
 	else
 		delete[] mBuffer;
 	
+	if (mLoader)
+		mLoader->mAllocated -= mSize;
 	mResCache->MemoryHasBeenFreed(mSize);
 }
 
@@ -88,6 +91,7 @@ ResCache* ResCache::Get(void)
 // ResCache::ResCache							- Chapter 8, page 227
 //
 ResCache::ResCache(const unsigned int sizeInMb, BaseResourceFile* resFile )
+	: mFirst(nullptr), mLast(nullptr), mQuit(false), mHits(0), mMisses(0), mEvictions(0)
 {
 	mCacheSize = sizeInMb * 1024 * 1024; // total memory size
 	mAllocated = 0; // total memory allocated
@@ -108,10 +112,14 @@ ResCache::ResCache(const unsigned int sizeInMb, BaseResourceFile* resFile )
 //
 ResCache::~ResCache()
 {
-	while (!mLRU.empty())
+	StopLoaders();
+
+	MutexAutoLock lock(mMutex);
+	while (mLast)
 	{
-		FreeOneResource();
+		FreeOneResource(mLast);
 	}
+	lock.unlock();
 	delete mFile;
 
 	if (ResCache::mResCache == this)
@@ -139,30 +147,168 @@ bool ResCache::Init()
 //    The loaders are discussed on the page refereced above - this method simply adds the loader
 //    to the resource cache.
 //
-void ResCache::RegisterLoader(const std::shared_ptr<BaseResourceLoader>& loader )
+void ResCache::RegisterLoader(const std::shared_ptr<BaseResourceLoader>& loader, unsigned int budgetInMb)
 {
-	mResourceLoaders.push_front(loader);
+	MutexAutoLock lock(mMutex);
+	mResourceLoaders.emplace_front(loader, budgetInMb * 1024 * 1024);
 }
 
 
 //
 // ResCache::GetHandle							- Chapter 8, page 227
 //
+//    A resource which is already being loaded by another thread or by an asynchronous request 
+//    is waited for rather than loaded a second time.
+//
 std::shared_ptr<ResHandle> ResCache::GetHandle(BaseResource* r)
 {
-	std::shared_ptr<ResHandle> handle = Find(r);
-	if (handle==NULL)
+	MutexAutoLock lock(mMutex);
+
+	ResHandleMap::iterator itRes = mResources.find(r->mName);
+	if (itRes != mResources.end())
+	{
+		mHits++;
+		std::shared_ptr<ResHandle> handle = itRes->second;
+		Unlink(handle.get());
+		LinkFront(handle.get());
+		return handle;
+	}
+
+	ResHandlePromise promise;
+	ResHandleRequests::iterator itRequest = mRequests.find(r->mName);
+	if (itRequest != mRequests.end())
 	{
-		handle = Load(r);
-		//LogAssert(handle);
+		// A request which no loader has started yet is loaded here. Loaders which get the 
+		// resources they depend on would otherwise wait for requests queued behind them
+		auto itQueue = std::find_if(mQueue.begin(), mQueue.end(),
+			[r](const std::pair<BaseResource, ResHandlePromise>& request)
+			{
+				return request.first.mName == r->mName;
+			});
+		if (itQueue == mQueue.end())
+		{
+			ResHandleFuture future = itRequest->second;
+			lock.unlock();
+			return future.get();
+		}
+
+		promise = itQueue->second;
+		mQueue.erase(itQueue);
 	}
 	else
 	{
-		Update(handle);
+		promise = std::make_shared<std::promise<std::shared_ptr<ResHandle>>>();
+		mRequests[r->mName] = promise->get_future().share();
 	}
+	lock.unlock();
+
+	std::shared_ptr<ResHandle> handle = Load(r);
+
+	lock.lock();
+	mRequests.erase(r->mName);
+	lock.unlock();
+
+	promise->set_value(handle);
 	return handle;
 }
 
+//
+// ResCache::RequestAsync						- not described in the book
+//
+//    Queues the resource for the loader threads and returns right away, so that a cache miss
+//    doesn't stall the calling thread. The handle is shared with any other request for the 
+//    same resource made while it loads.
+//
+ResHandleFuture ResCache::RequestAsync(const BaseResource& r)
+{
+	MutexAutoLock lock(mMutex);
+
+	ResHandleMap::iterator itRes = mResources.find(r.mName);
+	if (itRes != mResources.end())
+	{
+		mHits++;
+		Unlink(itRes->second.get());
+		LinkFront(itRes->second.get());
+
+		std::promise<std::shared_ptr<ResHandle>> promise;
+		promise.set_value(itRes->second);
+		return promise.get_future().share();
+	}
+
+	ResHandleRequests::iterator itRequest = mRequests.find(r.mName);
+	if (itRequest != mRequests.end())
+		return itRequest->second;
+
+	if (mLoaders.empty())
+		StartLoaders();
+
+	ResHandlePromise promise = 
+		std::make_shared<std::promise<std::shared_ptr<ResHandle>>>();
+	ResHandleFuture future = promise->get_future().share();
+	mRequests[r.mName] = future;
+	mQueue.push_back({ r, promise });
+	lock.unlock();
+
+	mWakeUp.notify_one();
+	return future;
+}
+
+void ResCache::StartLoaders(void)
+{
+	// loading is mostly waiting on the disk, half of the hardware threads keep it busy
+	unsigned int loaderCount = std::max(std::thread::hardware_concurrency() / 2, 2u);
+	mQuit = false;
+	for (unsigned int loader = 0; loader < loaderCount; loader++)
+		mLoaders.push_back(std::thread(&ResCache::LoaderThread, this));
+}
+
+void ResCache::StopLoaders(void)
+{
+	MutexAutoLock lock(mMutex);
+	mQuit = true;
+	lock.unlock();
+	mWakeUp.notify_all();
+
+	for (auto& loader : mLoaders)
+		loader.join();
+	mLoaders.clear();
+
+	// requests which never started get an empty handle
+	lock.lock();
+	for (auto& request : mQueue)
+	{
+		mRequests.erase(request.first.mName);
+		request.second->set_value(nullptr);
+	}
+	mQueue.clear();
+}
+
+void ResCache::LoaderThread(void)
+{
+	MutexAutoLock lock(mMutex);
+	while (true)
+	{
+		mWakeUp.wait(lock, [this]() { return mQuit || !mQueue.empty(); });
+		if (mQuit)
+			break;
+
+		BaseResource resource = mQueue.front().first;
+		ResHandlePromise promise = mQueue.front().second;
+		mQueue.pop_front();
+		lock.unlock();
+
+		std::shared_ptr<ResHandle> handle = Load(&resource);
+
+		lock.lock();
+		mRequests.erase(resource.mName);
+		lock.unlock();
+
+		promise->set_value(handle);
+
+		lock.lock();
+	}
+}
+
 /*
 	Load a resource. First it is located the right resource loader using its name as identifier.
 	If a loader isn't found an empty ResHandle is returned. Then the method grabas the size of the raw
@@ -176,21 +322,26 @@ std::shared_ptr<ResHandle> ResCache::GetHandle(BaseResource* r)
 	amount of memory in cache, and finally copies the processed resource into the new buffer.
 	After the resource is loaded, the newly created ResHandle is pushed onto the LRU list, and the 
 	resource name is entered into the resource name map.
+	The cache mutex is only held to pick the loader and to make room, so several threads can load
+	at the same time.
 */
 std::shared_ptr<ResHandle> ResCache::Load(BaseResource* r)
 {
+	mMisses++;
+
 	// Create a new resource and add it to the lru list and map
-	BaseResourceLoader* loader = 0;
+	ResLoader* loader = 0;
 	std::shared_ptr<ResHandle> handle = 0;
 
-	for (ResourceLoaders::iterator it = mResourceLoaders.begin(); it != mResourceLoaders.end(); ++it)
 	{
-		BaseResourceLoader* testLoader = (*it).get();
-
-		if (testLoader->MatchResourceFormat(r->mName))
+		MutexAutoLock lock(mMutex);
+		for (ResourceLoaders::iterator it = mResourceLoaders.begin(); it != mResourceLoaders.end(); ++it)
 		{
-			loader = testLoader;
-			break;
+			if ((*it).mLoader->MatchResourceFormat(r->mName))
+			{
+				loader = &(*it);
+				break;
+			}
 		}
 	}
 
@@ -211,28 +362,38 @@ std::shared_ptr<ResHandle> ResCache::Load(BaseResource* r)
 
 	void *buffer = rawBuffer;
 	unsigned int size = rawSize;
-	if (loader->UseRawFile())
+	if (loader->mLoader->UseRawFile())
 	{
 		BaseReadFile* file = (BaseReadFile*)rawBuffer;
 
 		rawBuffer = new char[file->GetSize()];
 		memset(rawBuffer, 0, file->GetSize());
 		rawSize = file->Read(rawBuffer, file->GetSize());
+		delete file;
 
-		size = loader->GetLoadedResourceSize(rawBuffer, rawSize);
-		buffer = Allocate(size);
+		size = loader->mLoader->GetLoadedResourceSize(rawBuffer, rawSize);
+		buffer = Allocate(size, loader);
+	}
+	else
+	{
+		// the loader keeps the file, its size still counts against the budgets
+		MutexAutoLock lock(mMutex);
+		MakeRoom(size, loader);
+		mAllocated += size;
+		loader->mAllocated += size;
 	}
 
 	if (buffer)
 	{
 		handle = std::shared_ptr<ResHandle>(new ResHandle(*r, buffer, size, true, this));
-		bool success = loader->LoadResource(rawBuffer, rawSize, handle);
+		handle->mLoader = loader;
+		bool success = loader->mLoader->LoadResource(rawBuffer, rawSize, handle);
 
 		// This was added after the chapter went to copy edit. It is used for those
 		// resources that are converted to a useable format upon load, such as a compressed
 		// file. If the raw buffer from the resource file isn't needed, it shouldn't take up
 		// any additional memory, so we release it.
-		if (loader->DiscardRawBufferAfterLoad())
+		if (loader->mLoader->DiscardRawBufferAfterLoad())
 		{
 			delete[] rawBuffer;
 		}
@@ -248,8 +409,8 @@ std::shared_ptr<ResHandle> ResCache::Load(BaseResource* r)
 	{
 		MutexAutoLock lock(mMutex);
 
-		mLRU.push_front(std::shared_ptr<ResHandle>(handle));
-		mResources[r->mName] = mLRU.front();
+		LinkFront(handle.get());
+		mResources[r->mName] = handle;
 	}
 
 	LogAssert(loader, "Default resource loader not found!");
@@ -264,6 +425,16 @@ bool ResCache::ExistResource(BaseResource* r)
 	return mFile->ExistFile(r->mName);
 }
 
+bool ResCache::ExistLoader(BaseResource* r)
+{
+	MutexAutoLock lock(mMutex);
+	for (ResourceLoaders::iterator it = mResourceLoaders.begin(); it != mResourceLoaders.end(); ++it)
+		if ((*it).mLoader->MatchResourceFormat(r->mName))
+			return true;
+
+	return false;
+}
+
 bool ResCache::ExistDirectory(const std::wstring& dirname) 
 { 
 	return mFile->ExistDirectory(dirname);
@@ -303,24 +474,85 @@ void ResCache::Update(const std::shared_ptr<ResHandle>& handle)
 {
 	MutexAutoLock lock(mMutex);
 
-	mLRU.remove(handle);
-	mLRU.push_front(handle);
+	// the handle may have been evicted since it was found
+	if (!handle->mCached)
+		return;
+
+	Unlink(handle.get());
+	LinkFront(handle.get());
+}
+
+/*
+	LinkFront puts the handle at the front of the cache lru list and of the lru list of its loader.
+	Unlink takes it out of both lists. Both are called with the mutex held
+*/
+void ResCache::LinkFront(ResHandle* handle)
+{
+	handle->mPrev = nullptr;
+	handle->mNext = mFirst;
+	if (mFirst)
+		mFirst->mPrev = handle;
+	else
+		mLast = handle;
+	mFirst = handle;
+
+	ResLoader* loader = handle->mLoader;
+	if (loader)
+	{
+		handle->mLoaderPrev = nullptr;
+		handle->mLoaderNext = loader->mFirst;
+		if (loader->mFirst)
+			loader->mFirst->mLoaderPrev = handle;
+		else
+			loader->mLast = handle;
+		loader->mFirst = handle;
+	}
+	handle->mCached = true;
+}
+
+void ResCache::Unlink(ResHandle* handle)
+{
+	if (handle->mPrev)
+		handle->mPrev->mNext = handle->mNext;
+	else
+		mFirst = handle->mNext;
+	if (handle->mNext)
+		handle->mNext->mPrev = handle->mPrev;
+	else
+		mLast = handle->mPrev;
+	handle->mPrev = handle->mNext = nullptr;
+
+	ResLoader* loader = handle->mLoader;
+	if (loader)
+	{
+		if (handle->mLoaderPrev)
+			handle->mLoaderPrev->mLoaderNext = handle->mLoaderNext;
+		else
+			loader->mFirst = handle->mLoaderNext;
+		if (handle->mLoaderNext)
+			handle->mLoaderNext->mLoaderPrev = handle->mLoaderPrev;
+		else
+			loader->mLast = handle->mLoaderPrev;
+		handle->mLoaderPrev = handle->mLoaderNext = nullptr;
+	}
+	handle->mCached = false;
 }
 
 /*
 	Allocate makes room in the cache when it is needed
 */
-char* ResCache::Allocate(unsigned int size)
+char* ResCache::Allocate(unsigned int size, ResLoader* loader)
 {
 	MutexAutoLock lock(mMutex);
 
-	if (!MakeRoom(size))
+	if (!MakeRoom(size, loader))
 		return NULL;
 
 	char *mem = new char[size];
 	if (mem)
 	{
 		mAllocated += size;
+		loader->mAllocated += size;
 	}
 
 	return mem;
@@ -328,19 +560,18 @@ char* ResCache::Allocate(unsigned int size)
 
 
 /*
-	FreeOneResource removes the oldest resource and updates the cache data members. Note that the memory
-	used by the cache isn't actually modified here, that's because any active shared_ptr<ResHandle> in
-	use will need the bits until it actually goes out of scope.
+	FreeOneResource removes the resource from the cache and updates the cache data members. Note that
+	the memory used by the cache isn't actually modified here, that's because any active shared_ptr<ResHandle>
+	in use will need the bits until it actually goes out of scope.
 */
-void ResCache::FreeOneResource()
+void ResCache::FreeOneResource(ResHandle* gonner)
 {
-	ResHandleList::iterator gonner = mLRU.end();
-	gonner--;
-
-	std::shared_ptr<ResHandle> handle = *gonner;
+	Unlink(gonner);
+	mEvictions++;
 
-	mLRU.pop_back();							
-	mResources.erase(handle->mResource.mName);
+	// erasing the map entry may release the handle, the name must be copied first
+	std::wstring name = gonner->mResource.mName;
+	mResources.erase(name);
 	// Note - you can't change the resource cache size yet - the resource bits could still actually be
 	// used by some sybsystem holding onto the ResHandle. Only when it goes out of scope can the memory
 	// be actually free again.
@@ -359,10 +590,11 @@ void ResCache::Flush()
 {
 	MutexAutoLock lock(mMutex);
 
-	while (!mLRU.empty())
+	while (mFirst)
 	{
-		Free(*(mLRU.begin()));
-		mLRU.pop_front();
+		ResHandle* handle = mFirst;
+		Unlink(handle);
+		mResources.erase(handle->mResource.mName);
 	}
 }
 
@@ -370,21 +602,39 @@ void ResCache::Flush()
 //
 // ResCache::MakeRoom									- Chapter 8, page 231
 //
-bool ResCache::MakeRoom(unsigned int size)
+//    A loader over its budget drops its own least recently used resources first, then the least
+//    recently used resources of the whole cache are dropped until the size fits.
+//
+bool ResCache::MakeRoom(unsigned int size, ResLoader* loader)
 {
 	if (size > mCacheSize)
 	{
 		return false;
 	}
 
+	if (loader->mBudget)
+	{
+		if (size > loader->mBudget)
+			return false;
+
+		while (loader->mAllocated + size > loader->mBudget)
+		{
+			// The loader has nothing cached, and there's still not enough room.
+			if (!loader->mLast)
+				return false;
+
+			FreeOneResource(loader->mLast);
+		}
+	}
+
 	// return null if there's no possible way to allocate the memory
-	while (size > (mCacheSize - mAllocated))
+	while (mAllocated + size > mCacheSize)
 	{
 		// The cache is empty, and there's still not enough room.
-		if (mLRU.empty())
+		if (!mLast)
 			return false;
 
-		FreeOneResource();
+		FreeOneResource(mLast);
 	}
 
 	return true;
@@ -395,7 +645,8 @@ bool ResCache::MakeRoom(unsigned int size)
 //
 void ResCache::Free(const std::shared_ptr<ResHandle>& gonner)
 {
-	mLRU.remove(gonner);
+	if (gonner->mCached)
+		Unlink(gonner.get());
 	mResources.erase(gonner->mResource.mName);
 	// Note - the resource might still be in use by something,
 	// so the cache can't actually count the memory freed until the
@@ -408,13 +659,30 @@ void ResCache::Free(const std::shared_ptr<ResHandle>& gonner)
 //
 //  ResCache::MemoryHasBeenFreed					- not described in the book
 //
-//     This is called whenever the memory associated with a resource is actually freed
+//     This is called whenever the memory associated with a resource is actually freed. It may be
+//     called while the cache mutex is held, so the counters are atomic rather than locked
 //
 void ResCache::MemoryHasBeenFreed(unsigned int size)
 {
 	mAllocated -= size;
 }
 
+//
+//  ResCache::GetStats								- not described in the book
+//
+ResCacheStats ResCache::GetStats(void) const
+{
+	MutexAutoLock lock(mMutex);
+
+	ResCacheStats stats;
+	stats.mHits = mHits;
+	stats.mMisses = mMisses;
+	stats.mEvictions = mEvictions;
+	stats.mAllocated = mAllocated;
+	stats.mCached = (unsigned int)mResources.size();
+	return stats;
+}
+
 //
 // ResCache::Match									- not described in the book
 //
@@ -441,29 +709,35 @@ std::vector<std::wstring> ResCache::Match(const std::wstring pattern)
 //
 // ResCache::Preload								- Chapter 8, page 236
 //
+//    The matching resources are requested ahead of the one being waited for, so the loader threads 
+//    work on them in parallel. Only a few requests are kept in flight, a pending request holds its
+//    handle and would keep the memory of the resource from being reclaimed.
+//
 int ResCache::Preload(const std::wstring pattern, void (*progressCallback)(int, bool &))
 {
 	if (mFile==NULL)
 		return 0;
 
-	int numFiles = mFile->GetNumResources();
+	std::vector<std::wstring> names = Match(pattern);
+	unsigned int window = 4 * std::max(std::thread::hardware_concurrency(), 1u);
+
+	std::deque<ResHandleFuture> requests;
+	unsigned int requested = 0;
 	int loaded = 0;
 	bool cancel = false;
-
-	for (int i=0; i<numFiles; ++i)
+	for (unsigned int i = 0; i < names.size() && !cancel; ++i)
 	{
-		BaseResource resource(mFile->GetResourceName(i));
+		for (; requested < names.size() && requested < i + window; ++requested)
+			requests.push_back(RequestAsync(BaseResource(names[requested])));
 
-		if (WildcardMatch(pattern.c_str(), resource.mName.c_str()))
-		{
-			const std::shared_ptr<ResHandle>& handle = ResCache::Get()->GetHandle(&resource);
+		if (requests.front().get())
 			++loaded;
-		}
+		requests.pop_front();
 
 		if (progressCallback != NULL)
 		{
-			progressCallback(i * 100/numFiles, cancel);
+			progressCallback((i + 1) * 100 / (int)names.size(), cancel);
 		}
 	}
 	return loaded;
-}
+}
\ No newline at end of file
@@ -48,6 +48,11 @@
 
 #include "Core/Threading/MutexAutolock.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <thread>
+
 //
 // class BaseResourceExtraData		- Chapter 8, page 224 (see notes below)
 //
@@ -61,6 +66,28 @@ public:
 	virtual std::wstring ToString()=0;
 };
 
+class ResCache;
+class ResHandle;
+
+/*
+	ResLoader is a loader registered in the cache. Besides the loader it keeps the memory budget of the
+	loader, the memory allocated by the resources it loaded and the lru list of those resources, so that
+	a loader which runs over its budget gives up its own least recently used resources first.
+*/
+struct ResLoader
+{
+	ResLoader(const std::shared_ptr<BaseResourceLoader>& loader, unsigned int budget)
+		: mLoader(loader), mBudget(budget), mAllocated(0), mFirst(nullptr), mLast(nullptr)
+	{
+	}
+
+	std::shared_ptr<BaseResourceLoader> mLoader;
+	unsigned int mBudget;	// memory budget, 0 means the loader is limited by the cache size only
+	std::atomic<unsigned int> mAllocated;
+	ResHandle* mFirst;		// most recently used resource of the loader
+	ResHandle* mLast;		// least recently used resource of the loader
+};
+
 /*
 	ResHandle tracks loaded resources. It is important for the cache to keep track of all the loaded
 	resources. The ResHandle encapsulates the resource identified with the loaded resource data, when
@@ -100,6 +127,16 @@ protected:
 	BaseResource mResource;
 	std::shared_ptr<BaseResourceExtraData> mExtra;
 
+private:
+
+	// Intrusive links of the cache lru lists, guarded by the cache mutex. A handle is linked
+	// as long as the cache holds it, so touching or evicting it never searches the lists
+	ResHandle* mPrev;
+	ResHandle* mNext;
+	ResHandle* mLoaderPrev;
+	ResHandle* mLoaderNext;
+	ResLoader* mLoader;
+	bool mCached;
 };
 
 //
@@ -121,16 +158,30 @@ public:
 /*
 	Resource Cache definitions. 
 	While the resource is in memory, a pointer to the ResHandle exists in several data structures.
-	1) ResHandleList, is a linked list which is managed such that the nodes appear in the order in
-	which the resource was last used. Every time a resource is used, it is moved to the front of the list,
-	so it can be found the most and least recently used resources.
-	2) ResHandleMap is a map which provides a way to quickly find resource data with the unique resource
-	identifier.
+	1) The lru list, is an intrusive linked list through the handles which is managed such that the nodes
+	appear in the order in which the resource was last used. Every time a resource is used, it is moved
+	to the front of the list, so it can be found the most and least recently used resources.
+	2) ResHandleMap is a hash map which provides a way to quickly find resource data with the unique
+	resource identifier.
 	3) ResourceLoaders is a list containing loaders
+	4) ResHandleRequests maps the identifiers of the resources being loaded to the result of the load,
+	so that a resource requested again while it loads is loaded only once.
 */
-typedef std::list<std::shared_ptr<ResHandle>> ResHandleList;					// lru list
-typedef std::map<std::wstring, std::shared_ptr<ResHandle>> ResHandleMap;		// maps indentifiers to resource data
-typedef std::list<std::shared_ptr<BaseResourceLoader>> ResourceLoaders;
+typedef std::unordered_map<std::wstring, std::shared_ptr<ResHandle>> ResHandleMap;	// maps indentifiers to resource data
+typedef std::list<ResLoader> ResourceLoaders;
+typedef std::shared_future<std::shared_ptr<ResHandle>> ResHandleFuture;
+typedef std::shared_ptr<std::promise<std::shared_ptr<ResHandle>>> ResHandlePromise;
+typedef std::unordered_map<std::wstring, ResHandleFuture> ResHandleRequests;
+
+// Counters of the cache activity since it was created
+struct ResCacheStats
+{
+	unsigned int mHits;			// requests served from the cache
+	unsigned int mMisses;		// requests which had to load the resource
+	unsigned int mEvictions;	// resources dropped to make room
+	unsigned int mAllocated;	// memory allocated by the loaded resources
+	unsigned int mCached;		// resources in the cache
+};
 
 /*
 	Resource Cache manage memory and the process of loading resources, even predict resource requirements
@@ -152,19 +203,30 @@ public:
 
 	bool Init(); 
 	
-	void RegisterLoader(const std::shared_ptr<BaseResourceLoader>& loader );
+	// The budget limits the memory of the resources of the loader, 0 means no other limit than the
+	// cache size. Loaders must not use the renderer as they may run on the loader threads
+	void RegisterLoader(const std::shared_ptr<BaseResourceLoader>& loader, unsigned int budgetInMb = 0);
 	
 	bool ExistDirectory(const std::wstring& dirname);
 
 	bool ExistResource(BaseResource* r);
+	bool ExistLoader(BaseResource* r);
 	int GetResource(BaseResource* r, void** buffer);
 	std::shared_ptr<ResHandle> GetHandle(BaseResource* r);
 
+	// Loads the resource on a loader thread. The future holds the handle once the resource
+	// is loaded, or an empty handle if it can't be loaded
+	ResHandleFuture RequestAsync(const BaseResource& r);
+
+	// Loads the matching resources in parallel on the loader threads. The progress callback is
+	// called from the calling thread while the loads complete
 	int Preload(const std::wstring pattern, void (*progressCallback)(int, bool &));
 	std::vector<std::wstring> Match(const std::wstring pattern);
 
 	void Flush(void);
 
+	ResCacheStats GetStats(void) const;
+
     bool IsUsingDevelopmentDirectories(void) const 
 	{ 
 		LogAssert(mFile, "Invalid file"); 
@@ -180,30 +242,49 @@ protected:
 
 	static ResCache* mResCache;
 
-	bool MakeRoom(unsigned int size);
-	char* Allocate(unsigned int size);
+	bool MakeRoom(unsigned int size, ResLoader* loader);
+	char* Allocate(unsigned int size, ResLoader* loader);
 	void Free(const std::shared_ptr<ResHandle>& gonner);
 
 	std::shared_ptr<ResHandle> Load(BaseResource* r);
 	std::shared_ptr<ResHandle> Find(BaseResource* r);
 	void Update(const std::shared_ptr<ResHandle>& handle);
 
-	void FreeOneResource();
+	void FreeOneResource(ResHandle* gonner);
 	void MemoryHasBeenFreed(unsigned int size);
 
 private:
 
-	std::mutex mMutex;
+	void LinkFront(ResHandle* handle);
+	void Unlink(ResHandle* handle);
+
+	void StartLoaders(void);
+	void StopLoaders(void);
+	void LoaderThread(void);
+
+	mutable std::mutex mMutex;
 
 	//lru (least recently used) list to track which resources are less frequently used than others
-	ResHandleList mLRU;
+	ResHandle* mFirst;
+	ResHandle* mLast;
 	ResHandleMap mResources;
 	ResourceLoaders mResourceLoaders;
 
+	// resources being loaded and the queue of the asynchronous requests
+	ResHandleRequests mRequests;
+	std::deque<std::pair<BaseResource, ResHandlePromise>> mQueue;
+	std::vector<std::thread> mLoaders;
+	std::condition_variable mWakeUp;
+	bool mQuit;
+
 	BaseResourceFile* mFile;
 
 	unsigned int mCacheSize;	// total memory size
-	unsigned int mAllocated;	// total memory allocated
+	std::atomic<unsigned int> mAllocated;	// total memory allocated
+
+	std::atomic<unsigned int> mHits;
+	std::atomic<unsigned int> mMisses;
+	std::atomic<unsigned int> mEvictions;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,473 @@
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef CONCURRENTCONTAINERS_H
+#define CONCURRENTCONTAINERS_H
+
+#include "GameEngineStd.h"
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+
+//--------------------------------------------------------------------------------------------------------
+// class ConcurrentVector
+// Growable array which can be appended to and read from several threads at the same time. Elements
+// live in segments of doubling size which are never reallocated, so pointers, references and
+// iterators stay valid while other threads keep appending. Appends are serialized, reads are not.
+// As in any concurrent container, clear, assignment and destruction must not race with other calls.
+//--------------------------------------------------------------------------------------------------------
+template <typename Element>
+class ConcurrentVector
+{
+	static const size_t FIRST_SEGMENT_SIZE = 8;
+	static const size_t SEGMENT_COUNT = 48;
+
+public:
+
+	template <bool Const>
+	class Iterator
+	{
+	public:
+		typedef std::random_access_iterator_tag iterator_category;
+		typedef Element value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef typename std::conditional<Const, const Element*, Element*>::type pointer;
+		typedef typename std::conditional<Const, const Element&, Element&>::type reference;
+		typedef typename std::conditional<Const, const ConcurrentVector*, ConcurrentVector*>::type container;
+
+		Iterator(void) : mVector(NULL), mIndex(0) { }
+		Iterator(container pVector, size_t index) : mVector(pVector), mIndex(index) { }
+		Iterator(const Iterator<false>& it) : mVector(it.mVector), mIndex(it.mIndex) { }
+
+		reference operator*(void) const { return (*mVector)[mIndex]; }
+		pointer operator->(void) const { return &(*mVector)[mIndex]; }
+		reference operator[](difference_type offset) const { return (*mVector)[mIndex + offset]; }
+
+		Iterator& operator++(void) { ++mIndex; return *this; }
+		Iterator operator++(int) { Iterator it(*this); ++mIndex; return it; }
+		Iterator& operator--(void) { --mIndex; return *this; }
+		Iterator operator--(int) { Iterator it(*this); --mIndex; return it; }
+		Iterator& operator+=(difference_type offset) { mIndex += offset; return *this; }
+		Iterator& operator-=(difference_type offset) { mIndex -= offset; return *this; }
+		Iterator operator+(difference_type offset) const { return Iterator(mVector, mIndex + offset); }
+		Iterator operator-(difference_type offset) const { return Iterator(mVector, mIndex - offset); }
+		difference_type operator-(const Iterator& it) const { return (difference_type)mIndex - (difference_type)it.mIndex; }
+
+		bool operator==(const Iterator& it) const { return mIndex == it.mIndex; }
+		bool operator!=(const Iterator& it) const { return mIndex != it.mIndex; }
+		bool operator<(const Iterator& it) const { return mIndex < it.mIndex; }
+		bool operator>(const Iterator& it) const { return mIndex > it.mIndex; }
+		bool operator<=(const Iterator& it) const { return mIndex <= it.mIndex; }
+		bool operator>=(const Iterator& it) const { return mIndex >= it.mIndex; }
+
+	private:
+		friend class ConcurrentVector;
+		friend class Iterator<true>;
+
+		container mVector;
+		size_t mIndex;
+	};
+
+	typedef Element value_type;
+	typedef size_t size_type;
+	typedef Element& reference;
+	typedef const Element& const_reference;
+	typedef Iterator<false> iterator;
+	typedef Iterator<true> const_iterator;
+
+	ConcurrentVector(void) : mSize(0)
+	{
+		for (size_t segment = 0; segment < SEGMENT_COUNT; segment++)
+			mSegments[segment] = NULL;
+	}
+
+	ConcurrentVector(const ConcurrentVector& other) : ConcurrentVector()
+	{
+		for (const Element& element : other)
+			push_back(element);
+	}
+
+	template <typename InputIterator>
+	ConcurrentVector(InputIterator first, InputIterator last) : ConcurrentVector()
+	{
+		for (; first != last; ++first)
+			push_back(*first);
+	}
+
+	~ConcurrentVector(void)
+	{
+		clear();
+	}
+
+	ConcurrentVector& operator=(const ConcurrentVector& other)
+	{
+		if (this != &other)
+		{
+			clear();
+			for (const Element& element : other)
+				push_back(element);
+		}
+		return *this;
+	}
+
+	iterator push_back(const Element& element) { return emplace_back(element); }
+	iterator push_back(Element&& element) { return emplace_back(std::move(element)); }
+
+	template <typename... Args>
+	iterator emplace_back(Args&&... args)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		size_t index = mSize.load(std::memory_order_relaxed);
+		size_t segment = GetSegment(index);
+		if (!mSegments[segment].load(std::memory_order_relaxed))
+		{
+			mSegments[segment].store(static_cast<Element*>(
+				::operator new(GetSegmentSize(segment) * sizeof(Element))), std::memory_order_release);
+		}
+		new (GetElement(index)) Element(std::forward<Args>(args)...);
+
+		// the element is only visible to the readers once it has been constructed
+		mSize.store(index + 1, std::memory_order_release);
+		return iterator(this, index);
+	}
+
+	// not concurrency safe
+	void clear(void)
+	{
+		size_t size = mSize.load(std::memory_order_acquire);
+		for (size_t index = 0; index < size; index++)
+			GetElement(index)->~Element();
+
+		for (size_t segment = 0; segment < SEGMENT_COUNT; segment++)
+		{
+			::operator delete(mSegments[segment].load(std::memory_order_relaxed));
+			mSegments[segment].store(NULL, std::memory_order_relaxed);
+		}
+		mSize.store(0, std::memory_order_release);
+	}
+
+	size_t size(void) const { return mSize.load(std::memory_order_acquire); }
+	bool empty(void) const { return size() == 0; }
+
+	Element& operator[](size_t index) { return *GetElement(index); }
+	const Element& operator[](size_t index) const { return *GetElement(index); }
+
+	Element& at(size_t index)
+	{
+		if (index >= size())
+			throw std::out_of_range("ConcurrentVector index out of range");
+		return *GetElement(index);
+	}
+
+	const Element& at(size_t index) const
+	{
+		if (index >= size())
+			throw std::out_of_range("ConcurrentVector index out of range");
+		return *GetElement(index);
+	}
+
+	Element& front(void) { return *GetElement(0); }
+	const Element& front(void) const { return *GetElement(0); }
+	Element& back(void) { return *GetElement(size() - 1); }
+	const Element& back(void) const { return *GetElement(size() - 1); }
+
+	iterator begin(void) { return iterator(this, 0); }
+	iterator end(void) { return iterator(this, size()); }
+	const_iterator begin(void) const { return const_iterator(this, 0); }
+	const_iterator end(void) const { return const_iterator(this, size()); }
+	const_iterator cbegin(void) const { return begin(); }
+	const_iterator cend(void) const { return end(); }
+
+private:
+
+	// segment k holds FIRST_SEGMENT_SIZE * 2^k elements
+	static size_t GetSegment(size_t index)
+	{
+		size_t block = index / FIRST_SEGMENT_SIZE + 1;
+		size_t segment = 0;
+		while (block >>= 1)
+			segment++;
+		return segment;
+	}
+
+	static size_t GetSegmentSize(size_t segment) { return FIRST_SEGMENT_SIZE << segment; }
+	static size_t GetSegmentBase(size_t segment) { return FIRST_SEGMENT_SIZE * ((size_t(1) << segment) - 1); }
+
+	Element* GetElement(size_t index) const
+	{
+		size_t segment = GetSegment(index);
+		return mSegments[segment].load(std::memory_order_acquire) + (index - GetSegmentBase(segment));
+	}
+
+	std::atomic<Element*> mSegments[SEGMENT_COUNT];
+	std::atomic<size_t> mSize;
+	std::mutex mMutex;
+};
+
+//--------------------------------------------------------------------------------------------------------
+// class ConcurrentHashTable
+// Common implementation of the concurrent unordered maps. The key value pairs are stored in insertion
+// order in a ConcurrentVector and a hash index guarded by a reader writer lock maps every key to its
+// slot, so lookups and insertions can run from any number of threads while iterators and references
+// to the stored values stay valid. Like the containers it replaces there is no concurrency safe erase.
+//--------------------------------------------------------------------------------------------------------
+template <typename Key, typename Value, typename Hash, typename Index>
+class ConcurrentHashTable
+{
+public:
+
+	typedef Key key_type;
+	typedef Value mapped_type;
+	typedef std::pair<const Key, Value> value_type;
+	typedef size_t size_type;
+
+	template <bool Const>
+	class Iterator
+	{
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef typename ConcurrentHashTable::value_type value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef typename std::conditional<Const, const value_type*, value_type*>::type pointer;
+		typedef typename std::conditional<Const, const value_type&, value_type&>::type reference;
+		typedef typename std::conditional<Const,
+			const ConcurrentVector<value_type>*, ConcurrentVector<value_type>*>::type container;
+
+		Iterator(void) : mValues(NULL), mIndex(END) { }
+		Iterator(container pValues, size_t index) : mValues(pValues), mIndex(index) { }
+		Iterator(const Iterator<false>& it) : mValues(it.mValues), mIndex(it.mIndex) { }
+
+		reference operator*(void) const { return (*mValues)[mIndex]; }
+		pointer operator->(void) const { return &(*mValues)[mIndex]; }
+
+		// the end iterator is a sentinel so that it compares equal to any end taken earlier
+		Iterator& operator++(void)
+		{
+			if (++mIndex >= mValues->size())
+				mIndex = END;
+			return *this;
+		}
+		Iterator operator++(int) { Iterator it(*this); ++(*this); return it; }
+
+		bool operator==(const Iterator& it) const { return mIndex == it.mIndex; }
+		bool operator!=(const Iterator& it) const { return mIndex != it.mIndex; }
+
+	private:
+		friend class ConcurrentHashTable;
+		friend class Iterator<true>;
+
+		container mValues;
+		size_t mIndex;
+	};
+
+	typedef Iterator<false> iterator;
+	typedef Iterator<true> const_iterator;
+
+	ConcurrentHashTable(void) { }
+
+	ConcurrentHashTable(const ConcurrentHashTable& other)
+	{
+		Copy(other);
+	}
+
+	ConcurrentHashTable& operator=(const ConcurrentHashTable& other)
+	{
+		if (this != &other)
+		{
+			clear();
+			Copy(other);
+		}
+		return *this;
+	}
+
+	iterator find(const Key& key)
+	{
+		std::shared_lock<std::shared_mutex> lock(mMutex);
+		auto itIndex = mIndex.find(key);
+		return itIndex != mIndex.end() ? iterator(&mValues, itIndex->second) : end();
+	}
+
+	const_iterator find(const Key& key) const
+	{
+		std::shared_lock<std::shared_mutex> lock(mMutex);
+		auto itIndex = mIndex.find(key);
+		return itIndex != mIndex.end() ? const_iterator(&mValues, itIndex->second) : end();
+	}
+
+	size_t count(const Key& key) const
+	{
+		std::shared_lock<std::shared_mutex> lock(mMutex);
+		return mIndex.count(key);
+	}
+
+	// not concurrency safe
+	void clear(void)
+	{
+		std::unique_lock<std::shared_mutex> lock(mMutex);
+		mIndex.clear();
+		mValues.clear();
+	}
+
+	size_t size(void) const { return mValues.size(); }
+	bool empty(void) const { return mValues.empty(); }
+
+	iterator begin(void) { return mValues.size() ? iterator(&mValues, 0) : end(); }
+	iterator end(void) { return iterator(&mValues, END); }
+	const_iterator begin(void) const { return mValues.size() ? const_iterator(&mValues, 0) : end(); }
+	const_iterator end(void) const { return const_iterator(&mValues, END); }
+	const_iterator cbegin(void) const { return begin(); }
+	const_iterator cend(void) const { return end(); }
+
+protected:
+
+	static const size_t END = SIZE_MAX;
+
+	// the keys of the other table are already unique, so its pairs can be appended as they are
+	void Copy(const ConcurrentHashTable& other)
+	{
+		std::unique_lock<std::shared_mutex> lock(mMutex);
+		for (const value_type& value : other.mValues)
+		{
+			size_t index = mValues.push_back(value) - mValues.begin();
+			mIndex.insert({ value.first, index });
+		}
+	}
+
+	ConcurrentVector<value_type> mValues;
+	Index mIndex;
+	mutable std::shared_mutex mMutex;
+};
+
+//--------------------------------------------------------------------------------------------------------
+// class ConcurrentUnorderedMap
+//--------------------------------------------------------------------------------------------------------
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class ConcurrentUnorderedMap : public ConcurrentHashTable<Key, Value, Hash, std::unordered_map<Key, size_t, Hash>>
+{
+	typedef ConcurrentHashTable<Key, Value, Hash, std::unordered_map<Key, size_t, Hash>> Table;
+
+public:
+
+	typedef typename Table::value_type value_type;
+	typedef typename Table::iterator iterator;
+	typedef typename Table::const_iterator const_iterator;
+
+	ConcurrentUnorderedMap(void) { }
+
+	template <typename InputIterator>
+	ConcurrentUnorderedMap(InputIterator first, InputIterator last)
+	{
+		insert(first, last);
+	}
+
+	template <typename InputIterator>
+	void insert(InputIterator first, InputIterator last)
+	{
+		for (; first != last; ++first)
+			insert(*first);
+	}
+
+	std::pair<iterator, bool> insert(const value_type& value)
+	{
+		return Emplace(value.first, value.second);
+	}
+
+	template <typename Pair>
+	std::pair<iterator, bool> insert(Pair&& value)
+	{
+		return Emplace(std::forward<Pair>(value).first, std::forward<Pair>(value).second);
+	}
+
+	template <typename... Args>
+	std::pair<iterator, bool> emplace(const Key& key, Args&&... args)
+	{
+		return Emplace(key, std::forward<Args>(args)...);
+	}
+
+	Value& operator[](const Key& key)
+	{
+		return Emplace(key).first->second;
+	}
+
+	Value& at(const Key& key)
+	{
+		iterator it = this->find(key);
+		if (it == this->end())
+			throw std::out_of_range("ConcurrentUnorderedMap key not found");
+		return it->second;
+	}
+
+	const Value& at(const Key& key) const
+	{
+		const_iterator it = this->find(key);
+		if (it == this->end())
+			throw std::out_of_range("ConcurrentUnorderedMap key not found");
+		return it->second;
+	}
+
+private:
+
+	template <typename... Args>
+	std::pair<iterator, bool> Emplace(const Key& key, Args&&... args)
+	{
+		iterator it = this->find(key);
+		if (it != this->end())
+			return { it, false };
+
+		std::unique_lock<std::shared_mutex> lock(this->mMutex);
+		auto itIndex = this->mIndex.find(key);
+		if (itIndex != this->mIndex.end())
+			return { iterator(&this->mValues, itIndex->second), false };
+
+		size_t index = this->mValues.emplace_back(std::piecewise_construct,
+			std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...)) - this->mValues.begin();
+		this->mIndex[key] = index;
+		return { iterator(&this->mValues, index), true };
+	}
+};
+
+//--------------------------------------------------------------------------------------------------------
+// class ConcurrentUnorderedMultimap
+//--------------------------------------------------------------------------------------------------------
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class ConcurrentUnorderedMultimap : public ConcurrentHashTable<Key, Value, Hash, std::unordered_multimap<Key, size_t, Hash>>
+{
+	typedef ConcurrentHashTable<Key, Value, Hash, std::unordered_multimap<Key, size_t, Hash>> Table;
+
+public:
+
+	typedef typename Table::value_type value_type;
+	typedef typename Table::iterator iterator;
+
+	template <typename InputIterator>
+	void insert(InputIterator first, InputIterator last)
+	{
+		for (; first != last; ++first)
+			insert(*first);
+	}
+
+	iterator insert(const value_type& value)
+	{
+		std::unique_lock<std::shared_mutex> lock(this->mMutex);
+		size_t index = this->mValues.push_back(value) - this->mValues.begin();
+		this->mIndex.insert({ value.first, index });
+		return iterator(&this->mValues, index);
+	}
+};
+
+#endif
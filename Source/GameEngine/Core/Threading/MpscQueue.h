@@ -0,0 +1,117 @@
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include "GameEngineStd.h"
+
+#include <atomic>
+
+//--------------------------------------------------------------------------------------------------------
+// class MpscQueue
+// Bounded lock free queue with many producers and a single consumer. The elements live in a ring of
+// cells, each cell holds a sequence number which tells whether it is free for the producer of a given
+// position or ready for the consumer, so a push only needs to win the position with a compare and
+// swap and a pop doesn't need any atomic read-modify-write at all. Push fails when the queue is full.
+//--------------------------------------------------------------------------------------------------------
+template <typename Element>
+class MpscQueue
+{
+public:
+
+	// the capacity is rounded up to a power of two
+	explicit MpscQueue(size_t capacity)
+	{
+		size_t size = 2;
+		while (size < capacity)
+			size <<= 1;
+
+		mCells.reset(new Cell[size]);
+		mMask = size - 1;
+		for (size_t cell = 0; cell < size; cell++)
+			mCells[cell].mSequence.store(cell, std::memory_order_relaxed);
+
+		mPushPosition.store(0, std::memory_order_relaxed);
+		mPopPosition = 0;
+	}
+
+	// can be called from any thread
+	bool Push(const Element& element)
+	{
+		Cell* cell;
+		size_t position = mPushPosition.load(std::memory_order_relaxed);
+		while (true)
+		{
+			cell = &mCells[position & mMask];
+			size_t sequence = cell->mSequence.load(std::memory_order_acquire);
+			intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+			if (difference == 0)
+			{
+				if (mPushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (difference < 0)
+			{
+				// the consumer hasn't released this cell yet
+				return false;
+			}
+			else position = mPushPosition.load(std::memory_order_relaxed);
+		}
+
+		cell->mElement = element;
+		cell->mSequence.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	// must only be called from the consumer thread
+	bool TryPop(Element& element)
+	{
+		Cell* cell = &mCells[mPopPosition & mMask];
+		size_t sequence = cell->mSequence.load(std::memory_order_acquire);
+		if ((intptr_t)sequence - (intptr_t)(mPopPosition + 1) < 0)
+			return false;
+
+		element = std::move(cell->mElement);
+		cell->mElement = Element();
+		cell->mSequence.store(mPopPosition + mMask + 1, std::memory_order_release);
+		mPopPosition++;
+		return true;
+	}
+
+	bool Empty(void) const
+	{
+		const Cell* cell = &mCells[mPopPosition & mMask];
+		return (intptr_t)cell->mSequence.load(std::memory_order_acquire) - (intptr_t)(mPopPosition + 1) < 0;
+	}
+
+private:
+
+	struct Cell
+	{
+		std::atomic<size_t> mSequence;
+		Element mElement;
+	};
+
+	std::unique_ptr<Cell[]> mCells;
+	size_t mMask;
+
+	// producers and consumer positions are kept on different cache lines
+	alignas(64) std::atomic<size_t> mPushPosition;
+	alignas(64) size_t mPopPosition;
+};
+
+#endif
@@ -0,0 +1,226 @@
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "TaskScheduler.h"
+
+// index of the worker running on this thread, if any
+static thread_local unsigned int CurrentWorker = UINT_MAX;
+
+//--------------------------------------------------------------------------------------------------------
+// TaskScheduler
+//--------------------------------------------------------------------------------------------------------
+TaskScheduler::TaskScheduler(void) : mPendingTasks(0), mQuit(false)
+{
+	Start(0);
+}
+
+TaskScheduler::~TaskScheduler(void)
+{
+	Stop();
+}
+
+TaskScheduler* TaskScheduler::Get(void)
+{
+	static TaskScheduler scheduler;
+	return &scheduler;
+}
+
+void TaskScheduler::SetConcurrency(unsigned int concurrency)
+{
+	Stop();
+	Start(concurrency);
+}
+
+void TaskScheduler::Start(unsigned int concurrency)
+{
+	if (!concurrency)
+		concurrency = std::max(std::thread::hardware_concurrency(), 1u);
+
+	mQuit = false;
+
+	// the thread which waits for the tasks runs them too, so one thread less is needed
+	for (unsigned int worker = 0; worker + 1 < concurrency; worker++)
+		mWorkers.push_back(std::make_unique<Worker>());
+	for (unsigned int worker = 0; worker < mWorkers.size(); worker++)
+		mWorkers[worker]->mThread = std::thread(&TaskScheduler::WorkerLoop, this, worker);
+}
+
+void TaskScheduler::Stop(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(mWakeUpMutex);
+		mQuit = true;
+	}
+	mWakeUp.notify_all();
+
+	for (auto& worker : mWorkers)
+		worker->mThread.join();
+	mWorkers.clear();
+}
+
+void TaskScheduler::Submit(Task&& task)
+{
+	if (CurrentWorker < mWorkers.size())
+	{
+		Worker* pWorker = mWorkers[CurrentWorker].get();
+		std::lock_guard<std::mutex> lock(pWorker->mMutex);
+		pWorker->mTasks.push_back(std::move(task));
+	}
+	else
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mTasks.push_back(std::move(task));
+	}
+	mPendingTasks.fetch_add(1);
+
+	{
+		std::lock_guard<std::mutex> lock(mWakeUpMutex);
+	}
+	mWakeUp.notify_one();
+}
+
+bool TaskScheduler::PopTask(Task& task)
+{
+	// newest task of our own deque, it is the most likely to be in the cache
+	unsigned int workerCount = (unsigned int)mWorkers.size();
+	if (CurrentWorker < workerCount)
+	{
+		Worker* pWorker = mWorkers[CurrentWorker].get();
+		std::lock_guard<std::mutex> lock(pWorker->mMutex);
+		if (!pWorker->mTasks.empty())
+		{
+			task = std::move(pWorker->mTasks.back());
+			pWorker->mTasks.pop_back();
+			return true;
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (!mTasks.empty())
+		{
+			task = std::move(mTasks.front());
+			mTasks.pop_front();
+			return true;
+		}
+	}
+
+	// steal the oldest task of another worker, which is usually the biggest chunk of work left
+	unsigned int firstWorker = CurrentWorker < workerCount ? CurrentWorker + 1 : 0;
+	for (unsigned int worker = 0; worker < workerCount; worker++)
+	{
+		Worker* pVictim = mWorkers[(firstWorker + worker) % workerCount].get();
+		std::lock_guard<std::mutex> lock(pVictim->mMutex);
+		if (!pVictim->mTasks.empty())
+		{
+			task = std::move(pVictim->mTasks.front());
+			pVictim->mTasks.pop_front();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool TaskScheduler::RunPendingTask(void)
+{
+	Task task;
+	if (!PopTask(task))
+		return false;
+
+	mPendingTasks.fetch_sub(1);
+	RunTask(task);
+	return true;
+}
+
+void TaskScheduler::RunTask(Task& task)
+{
+	TaskGroup* pGroup = task.mGroup;
+	try
+	{
+		task.mFunction();
+	}
+	catch (...)
+	{
+		std::lock_guard<std::mutex> lock(pGroup->mMutex);
+		if (!pGroup->mException)
+			pGroup->mException = std::current_exception();
+	}
+	pGroup->mPendingTasks.fetch_sub(1, std::memory_order_release);
+}
+
+void TaskScheduler::WorkerLoop(unsigned int worker)
+{
+	CurrentWorker = worker;
+
+	while (true)
+	{
+		if (RunPendingTask())
+			continue;
+
+		std::unique_lock<std::mutex> lock(mWakeUpMutex);
+		if (mQuit)
+			break;
+
+		if (mPendingTasks.load())
+		{
+			// the pending task is being taken by another thread
+			lock.unlock();
+			std::this_thread::yield();
+			continue;
+		}
+		mWakeUp.wait(lock, [this]() { return mQuit || mPendingTasks.load() > 0; });
+	}
+
+	CurrentWorker = UINT_MAX;
+}
+
+//--------------------------------------------------------------------------------------------------------
+// TaskGroup
+//--------------------------------------------------------------------------------------------------------
+TaskGroup::TaskGroup(void) : mPendingTasks(0)
+{
+
+}
+
+TaskGroup::~TaskGroup(void)
+{
+	// the tasks may still reference the stack of the thread that is unwinding
+	TaskScheduler* pScheduler = TaskScheduler::Get();
+	while (mPendingTasks.load(std::memory_order_acquire))
+		if (!pScheduler->RunPendingTask())
+			std::this_thread::yield();
+}
+
+void TaskGroup::Run(const std::function<void()>& function)
+{
+	mPendingTasks.fetch_add(1);
+	TaskScheduler::Get()->Submit({ function, this });
+}
+
+void TaskGroup::Wait(void)
+{
+	TaskScheduler* pScheduler = TaskScheduler::Get();
+	while (mPendingTasks.load(std::memory_order_acquire))
+		if (!pScheduler->RunPendingTask())
+			std::this_thread::yield();
+
+	if (mException)
+	{
+		std::exception_ptr exception = mException;
+		mException = nullptr;
+		std::rethrow_exception(exception);
+	}
+}
@@ -0,0 +1,195 @@
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef TASKSCHEDULER_H
+#define TASKSCHEDULER_H
+
+#include "GameEngineStd.h"
+
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+class TaskGroup;
+
+//--------------------------------------------------------------------------------------------------------
+// class TaskScheduler
+// Pool of worker threads which run the tasks of the task groups. Every worker owns a deque of tasks:
+// it pushes and pops its own tasks at the back and, when it runs out of work, steals the oldest task
+// from the front of another worker deque. Tasks submitted from threads outside the pool go to a
+// shared queue. A thread waiting on a task group keeps running pending tasks instead of blocking, so
+// nested parallel loops never need more threads than the pool already has.
+//--------------------------------------------------------------------------------------------------------
+class TaskScheduler
+{
+	friend class TaskGroup;
+
+public:
+
+	~TaskScheduler(void);
+
+	static TaskScheduler* Get(void);
+
+	// number of threads taking part in the parallel loops, including the calling thread
+	unsigned int GetConcurrency(void) const { return (unsigned int)mWorkers.size() + 1; }
+
+	// restarts the pool with the given concurrency, 0 picks the number of hardware threads.
+	// It must not be called while tasks are running
+	void SetConcurrency(unsigned int concurrency);
+
+private:
+
+	struct Task
+	{
+		std::function<void()> mFunction;
+		TaskGroup* mGroup;
+	};
+
+	struct Worker
+	{
+		std::thread mThread;
+		std::deque<Task> mTasks;
+		std::mutex mMutex;
+	};
+
+	TaskScheduler(void);
+
+	void Start(unsigned int concurrency);
+	void Stop(void);
+
+	void Submit(Task&& task);
+	bool RunPendingTask(void);
+	bool PopTask(Task& task);
+	void RunTask(Task& task);
+	void WorkerLoop(unsigned int worker);
+
+	std::vector<std::unique_ptr<Worker>> mWorkers;
+
+	// tasks submitted from threads outside the pool
+	std::deque<Task> mTasks;
+	std::mutex mMutex;
+
+	std::atomic<unsigned int> mPendingTasks;
+	std::condition_variable mWakeUp;
+	std::mutex mWakeUpMutex;
+	bool mQuit;
+};
+
+//--------------------------------------------------------------------------------------------------------
+// class TaskGroup
+// Set of tasks which can be waited for together. Wait runs pending tasks until every task of the
+// group has finished and rethrows the first exception thrown by any of them.
+//--------------------------------------------------------------------------------------------------------
+class TaskGroup
+{
+	friend class TaskScheduler;
+
+public:
+	TaskGroup(void);
+	~TaskGroup(void);
+
+	void Run(const std::function<void()>& function);
+	void Wait(void);
+
+private:
+	std::atomic<unsigned int> mPendingTasks;
+	std::exception_ptr mException;
+	std::mutex mMutex;
+};
+
+//--------------------------------------------------------------------------------------------------------
+// Parallel algorithms
+// The range is split in chunks of grain elements which run as tasks of the scheduler. A zero grain
+// picks a chunk size which gives every thread of the pool a few chunks to balance the load.
+//--------------------------------------------------------------------------------------------------------
+template <typename Index, typename Function>
+void ParallelFor(Index first, Index last, const Function& function, size_t grain = 0)
+{
+	if (!(first < last))
+		return;
+
+	size_t count = (size_t)(last - first);
+	if (!grain)
+		grain = std::max(count / (4 * TaskScheduler::Get()->GetConcurrency()), size_t(1));
+
+	if (count <= grain)
+	{
+		for (Index index = first; index < last; ++index)
+			function(index);
+		return;
+	}
+
+	TaskGroup group;
+	for (size_t chunk = 0; chunk < count; chunk += grain)
+	{
+		Index chunkFirst = first + (Index)chunk;
+		Index chunkLast = first + (Index)std::min(chunk + grain, count);
+		group.Run([&function, chunkFirst, chunkLast]()
+		{
+			for (Index index = chunkFirst; index < chunkLast; ++index)
+				function(index);
+		});
+	}
+	group.Wait();
+}
+
+template <typename Iterator, typename Function>
+void ParallelForEach(Iterator first, Iterator last, const Function& function, size_t grain,
+	std::random_access_iterator_tag)
+{
+	ParallelFor(size_t(0), (size_t)(last - first),
+		[&first, &function](size_t index) { function(*(first + index)); }, grain);
+}
+
+template <typename Iterator, typename Function>
+void ParallelForEach(Iterator first, Iterator last, const Function& function, size_t grain,
+	std::forward_iterator_tag)
+{
+	// the iterators are gathered first so that the chunks can be addressed by index
+	std::vector<Iterator> iterators;
+	for (; first != last; ++first)
+		iterators.push_back(first);
+
+	ParallelFor(size_t(0), iterators.size(),
+		[&iterators, &function](size_t index) { function(*iterators[index]); }, grain);
+}
+
+template <typename Iterator, typename Function>
+void ParallelForEach(Iterator first, Iterator last, const Function& function, size_t grain = 0)
+{
+	ParallelForEach(first, last, function, grain,
+		typename std::iterator_traits<Iterator>::iterator_category());
+}
+
+template <typename Function>
+void ParallelInvoke(const Function& function)
+{
+	function();
+}
+
+template <typename Function, typename... Functions>
+void ParallelInvoke(const Function& function, const Functions&... functions)
+{
+	TaskGroup group;
+	group.Run([&function]() { function(); });
+	ParallelInvoke(functions...);
+	group.Wait();
+}
+
+#endif
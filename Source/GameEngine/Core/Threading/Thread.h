@@ -277,7 +277,7 @@ public:
  * Notes for RequestQueue usage
  * @param Key unique key to identify a request for a specific resource
  * @param T ?
- * @param Caller unique id of calling thread
+ * @param Caller id of calling thread, callers sharing an id are told apart by their result queue
  * @param CallerData data passed back to caller
  */
 template<typename Key, typename T, typename Caller, typename CallerData>
@@ -298,7 +298,8 @@ public:
             MutexAutoLock lock(mQueue.GetMutex());
 
             /*
-                If the caller is already on the list, only update CallerData
+                If the caller is already on the list with the same destination,
+                only update CallerData
             */
             for (i = mQueue.GetQueue().begin(); i != mQueue.GetQueue().end(); ++i) 
             {
@@ -309,7 +310,7 @@ public:
                 for (j = request.mCallers.begin(); j != request.mCallers.end(); ++j) 
                 {
                     CallerInfo<Caller, CallerData, Key, T>& ca = *j;
-                    if (ca.mCaller == caller) 
+                    if (ca.mCaller == caller && ca.mDest == dest) 
                     {
                         ca.mData = callerdata;
                         return;
@@ -21,6 +21,10 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #include "Core/Logger/Logger.h"
 
+#include <chrono>
+#include <climits>
+#include <fstream>
+
 
 static Profiler MainProfiler;
 
@@ -186,6 +190,8 @@ void Paging(unsigned int length,
 
 void Profiler::GetPage(GraphValues& graph, unsigned int page, unsigned int pagecount)
 {
+    ProfileTrace::Get()->Collect();
+
     MutexAutoLock lock(mMutex);
 
     unsigned int minindex, maxindex;
@@ -208,36 +214,474 @@ void Profiler::GetPage(GraphValues& graph, unsigned int page, unsigned int pagec
 }
 
 
-ScopeProfiler::ScopeProfiler(
-    Profiler* profiler, const std::string& name, ScopeProfilerType type) :
-    mProfiler(profiler), mName(name), mType(type)
+void Profiler::GraphGet(GraphValues& result)
+{
+    // the scopes which ended since the last call are still in the ring buffers
+    ProfileTrace::Get()->Collect();
+
+    MutexAutoLock lock(mMutex);
+    result = mGraphValues;
+    mGraphValues.clear();
+}
+
+
+static int64_t GetTraceTime()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+ProfileTrace::ProfileTrace() : mThreadCount(0), mPendingRings(0), mDroppedEvents(0),
+    mFrames(0), mFrameBegin(0), mFrameEnd(0), mCapturing(false)
+{
+    // zone 0 marks the frames and node 0 is the root of the call tree
+    RegisterZone("Frame");
+    mNodes.push_back({ UINT_MAX, UINT_MAX, 0, 0, 0, 0 });
+    mChildren.emplace_back();
+}
+
+ProfileTrace* ProfileTrace::Get()
+{
+    // never destroyed, threads may still record scopes while the statics go away
+    static ProfileTrace* trace = new ProfileTrace();
+    return trace;
+}
+
+unsigned int ProfileTrace::RegisterZone(
+    const std::string& name, Profiler* profiler, ScopeProfilerType type)
+{
+    MutexAutoLock lock(mZoneMutex);
+    auto zoneId = mZoneIds.find(std::make_tuple(name, profiler, (int)type));
+    if (zoneId != mZoneIds.end())
+        return zoneId->second;
+
+    unsigned int zone = (unsigned int)mZones.size();
+    mZones.push_back({ name, name + " [ms]", profiler, type });
+    mZoneIds[std::make_tuple(name, profiler, (int)type)] = zone;
+    return zone;
+}
+
+ProfileTrace::ThreadBuffer* ProfileTrace::GetThreadBuffer()
+{
+    struct ThreadHandle
+    {
+        ThreadBuffer* mBuffer = nullptr;
+
+        ~ThreadHandle()
+        {
+            if (mBuffer)
+                mBuffer->mRetired.store(true, std::memory_order_release);
+        }
+    };
+    static thread_local ThreadHandle handle;
+    if (handle.mBuffer)
+        return handle.mBuffer;
+
+    MutexAutoLock lock(mMutex);
+    for (auto& buffer : mThreads)
+    {
+        if (buffer->mRetired.load(std::memory_order_acquire))
+        {
+            // the scopes left open by the finished thread will never end
+            Drain(buffer.get());
+            buffer->mOpenScopes.clear();
+            buffer->mThread = mThreadCount++;
+            buffer->mRetired.store(false, std::memory_order_relaxed);
+            handle.mBuffer = buffer.get();
+            return handle.mBuffer;
+        }
+    }
+
+    std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer());
+    buffer->mRing.store(new Ring(), std::memory_order_relaxed);
+    buffer->mFullRings.store(nullptr, std::memory_order_relaxed);
+    buffer->mRetired.store(false, std::memory_order_relaxed);
+    buffer->mThread = mThreadCount++;
+    handle.mBuffer = buffer.get();
+    mThreads.push_back(std::move(buffer));
+    return handle.mBuffer;
+}
+
+void ProfileTrace::Record(unsigned int zone, EventType type)
+{
+    ThreadBuffer* buffer = GetThreadBuffer();
+    Ring* ring = buffer->mRing.load(std::memory_order_relaxed);
+    unsigned int write = ring->mWrite.load(std::memory_order_relaxed);
+    if (write - ring->mRead.load(std::memory_order_acquire) == PROFILE_RING_SIZE)
+    {
+        // nobody collected for a while, hand the full ring to the collector rather than
+        // waiting for it
+        if (mPendingRings.load(std::memory_order_relaxed) >= PROFILE_PENDING_RINGS)
+        {
+            mDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        mPendingRings.fetch_add(1, std::memory_order_relaxed);
+
+        ring->mNext = buffer->mFullRings.load(std::memory_order_relaxed);
+        while (!buffer->mFullRings.compare_exchange_weak(ring->mNext, ring,
+            std::memory_order_release, std::memory_order_relaxed));
+
+        ring = new Ring();
+        buffer->mRing.store(ring, std::memory_order_release);
+        write = 0;
+    }
+
+    Event& evt = ring->mEvents[write % PROFILE_RING_SIZE];
+    evt.mTime = GetTraceTime();
+    evt.mZone = zone;
+    evt.mType = type;
+    ring->mWrite.store(write + 1, std::memory_order_release);
+}
+
+void ProfileTrace::Collect()
+{
+    MutexAutoLock lock(mMutex);
+    for (auto& buffer : mThreads)
+        Drain(buffer.get());
+
+    unsigned int droppedEvents = mDroppedEvents.exchange(0);
+    if (droppedEvents)
+    {
+        LogWarning("Profiler dropped " + std::to_string(droppedEvents) +
+            " events, the trace was not collected for too long");
+    }
+}
+
+unsigned int ProfileTrace::GetNode(unsigned int parent, unsigned int zone)
+{
+    auto nodeId = mNodeIds.find(std::make_pair(parent, zone));
+    if (nodeId != mNodeIds.end())
+        return nodeId->second;
+
+    unsigned int node = (unsigned int)mNodes.size();
+    mNodes.push_back({ zone, parent, 0, 0, 0, 0 });
+    mChildren.emplace_back();
+    mChildren[parent].push_back(node);
+    mNodeIds[std::make_pair(parent, zone)] = node;
+    return node;
+}
+
+void ProfileTrace::Drain(ThreadBuffer* buffer)
+{
+    // the current ring is loaded first, if the thread hands it off afterwards it is
+    // among the full rings and drained with them
+    Ring* ring = buffer->mRing.load(std::memory_order_acquire);
+
+    std::vector<Ring*> fullRings;
+    for (Ring* fullRing = buffer->mFullRings.exchange(nullptr, std::memory_order_acquire);
+        fullRing; fullRing = fullRing->mNext)
+    {
+        fullRings.push_back(fullRing);
+    }
+
+    // oldest first, the thread does not touch them anymore
+    bool handedOff = false;
+    for (auto fullRing = fullRings.rbegin(); fullRing != fullRings.rend(); ++fullRing)
+    {
+        DrainRing(buffer, *fullRing);
+        if (*fullRing == ring)
+            handedOff = true;
+
+        delete *fullRing;
+        mPendingRings.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    if (!handedOff)
+        DrainRing(buffer, ring);
+}
+
+void ProfileTrace::DrainRing(ThreadBuffer* buffer, Ring* ring)
+{
+    unsigned int read = ring->mRead.load(std::memory_order_relaxed);
+    unsigned int write = ring->mWrite.load(std::memory_order_acquire);
+    if (read == write)
+        return;
+
+    MutexAutoLock zoneLock(mZoneMutex);
+    for (; read != write; read++)
+    {
+        const Event& evt = ring->mEvents[read % PROFILE_RING_SIZE];
+        if (mCapturing.load(std::memory_order_relaxed))
+        {
+            if (mCapture.size() < PROFILE_CAPTURE_SIZE)
+            {
+                mCapture.push_back({ evt.mTime, evt.mZone, 
+                    (unsigned short)evt.mType, (unsigned short)buffer->mThread });
+            }
+            else
+            {
+                LogWarning("Profiler trace capture is full, the capture is stopped");
+                mCapturing.store(false);
+            }
+        }
+
+        switch (evt.mType)
+        {
+            case ET_BEGIN:
+            {
+                unsigned int parent = 
+                    buffer->mOpenScopes.empty() ? 0 : buffer->mOpenScopes.back().mNode;
+                buffer->mOpenScopes.push_back({ GetNode(parent, evt.mZone), evt.mTime, 0 });
+                break;
+            }
+            case ET_END:
+            {
+                // the scope may have begun before the thread took over the buffer, and
+                // the end of a nested scope may have been dropped
+                auto openScope = std::find_if(buffer->mOpenScopes.rbegin(), buffer->mOpenScopes.rend(),
+                    [this, &evt](const OpenScope& scope) { return mNodes[scope.mNode].mZone == evt.mZone; });
+                if (openScope == buffer->mOpenScopes.rend())
+                    break;
+                buffer->mOpenScopes.erase(openScope.base(), buffer->mOpenScopes.end());
+
+                OpenScope scope = buffer->mOpenScopes.back();
+                buffer->mOpenScopes.pop_back();
+
+                int64_t duration = evt.mTime - scope.mBegin;
+                Node& node = mNodes[scope.mNode];
+                node.mCount++;
+                node.mTotal += duration;
+                node.mSelf += duration - scope.mChildren;
+                node.mMax = std::max(node.mMax, duration);
+                if (!buffer->mOpenScopes.empty())
+                    buffer->mOpenScopes.back().mChildren += duration;
+
+                const Zone& zone = mZones[evt.mZone];
+                if (zone.mProfiler)
+                {
+                    float durationMs = duration / 1000000.f;
+                    switch (zone.mType)
+                    {
+                        case SPT_ADD:
+                            zone.mProfiler->Add(zone.mLabel, durationMs);
+                            break;
+                        case SPT_AVG:
+                            zone.mProfiler->Avg(zone.mLabel, durationMs);
+                            break;
+                        case SPT_GRAPH_ADD:
+                            zone.mProfiler->GraphAdd(zone.mLabel, durationMs);
+                            break;
+                    }
+                }
+                break;
+            }
+            case ET_FRAME:
+            {
+                if (!mFrames)
+                    mFrameBegin = evt.mTime;
+                mFrameEnd = evt.mTime;
+                mFrames++;
+                break;
+            }
+        }
+    }
+    ring->mRead.store(write, std::memory_order_release);
+}
+
+void ProfileTrace::StartCapture()
+{
+    Collect();
+
+    MutexAutoLock lock(mMutex);
+    mCapture.clear();
+    mCapturing.store(true);
+}
+
+void ProfileTrace::StopCapture()
+{
+    Collect();
+    mCapturing.store(false);
+}
+
+static void WriteJsonString(std::ostream& o, const std::string& str)
+{
+    o << '"';
+    for (char c : str)
+    {
+        if (c == '"' || c == '\\')
+            o << '\\' << c;
+        else if ((unsigned char)c < 0x20)
+            o << ' ';
+        else
+            o << c;
+    }
+    o << '"';
+}
+
+bool ProfileTrace::ExportChromeTrace(const std::string& path)
+{
+    Collect();
+
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file.good())
+    {
+        LogWarning("Failed to open profiler trace file " + path);
+        return false;
+    }
+
+    MutexAutoLock lock(mMutex);
+    MutexAutoLock zoneLock(mZoneMutex);
+
+    int64_t start = mCapture.empty() ? 0 : mCapture.front().mTime;
+    char timeBuf[32];
+    bool first = true;
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (unsigned int thread = 0; thread < mThreadCount; thread++)
+    {
+        file << (first ? "\n" : ",\n");
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread <<
+            ",\"args\":{\"name\":\"Thread " << thread << "\"}}";
+        first = false;
+    }
+
+    for (const CaptureEvent& evt : mCapture)
+    {
+        // chrome traces count in microseconds
+        snprintf(timeBuf, sizeof(timeBuf), "%.3f", (evt.mTime - start) / 1000.0);
+
+        file << (first ? "\n" : ",\n") << "{\"name\":";
+        WriteJsonString(file, mZones[evt.mZone].mName);
+        switch (evt.mType)
+        {
+            case ET_BEGIN:
+                file << ",\"ph\":\"B\"";
+                break;
+            case ET_END:
+                file << ",\"ph\":\"E\"";
+                break;
+            case ET_FRAME:
+                file << ",\"ph\":\"i\",\"s\":\"g\"";
+                break;
+        }
+        file << ",\"ts\":" << timeBuf << ",\"pid\":0,\"tid\":" << evt.mThread << "}";
+        first = false;
+    }
+    file << "\n]}\n";
+
+    if (!file.good())
+    {
+        LogWarning("Failed to write profiler trace file " + path);
+        return false;
+    }
+    return true;
+}
+
+int ProfileTrace::PrintNode(std::ostream& o, unsigned int node, unsigned int depth)
+{
+    // slowest scopes first
+    std::vector<unsigned int> children = mChildren[node];
+    std::sort(children.begin(), children.end(), [this](unsigned int a, unsigned int b)
+    {
+        return mNodes[a].mTotal > mNodes[b].mTotal;
+    });
+
+    char numBuf[100];
+    int lines = 0;
+    for (unsigned int child : children)
+    {
+        const Node& childNode = mNodes[child];
+        if (!childNode.mCount)
+            continue;
+
+        std::string name = std::string(2 * depth, ' ') + mZones[childNode.mZone].mName;
+        o << "  " << name << " ";
+        int space = 44 - (int)name.size();
+        for (int j = 0; j < space; j++)
+        {
+            if ((j & 1) && j < space - 1)
+                o << ".";
+            else
+                o << " ";
+        }
+        snprintf(numBuf, sizeof(numBuf), "%8u % 10.3f % 10.3f % 8.3f % 8.3f",
+            childNode.mCount, childNode.mTotal / 1000000.0, childNode.mSelf / 1000000.0,
+            childNode.mTotal / 1000000.0 / childNode.mCount, childNode.mMax / 1000000.0);
+        o << numBuf << std::endl;
+
+        lines += 1 + PrintNode(o, child, depth + 1);
+    }
+    return lines;
+}
+
+int ProfileTrace::PrintSummary(std::ostream& o)
 {
-	mName.append(" [ms]");
-	if (mProfiler)
-		mTimer = new TimeTaker(mName, nullptr, PRECISION_MILLI);
+    Collect();
+
+    MutexAutoLock lock(mMutex);
+    MutexAutoLock zoneLock(mZoneMutex);
+
+    if (mFrames > 1)
+    {
+        o << "  Frames: " << mFrames << ", average frame " <<
+            (mFrameEnd - mFrameBegin) / 1000000.0 / (mFrames - 1) << " ms" << std::endl;
+    }
+    o << "  Scope" << std::string(40, ' ') << 
+        "   count  total[ms]   self[ms]  avg[ms]  max[ms]" << std::endl;
+    return 2 + PrintNode(o, 0, 0);
 }
 
-ScopeProfiler::~ScopeProfiler()
+void ProfileTrace::ClearSummary()
 {
-	if (!mTimer)
-		return;
+    Collect();
 
-	float durationMs = (float)mTimer->Stop(true);
-	float duration = durationMs;
-	if (mProfiler) 
+    MutexAutoLock lock(mMutex);
+    for (Node& node : mNodes)
     {
-		switch (mType) 
+        node.mCount = 0;
+        node.mTotal = 0;
+        node.mSelf = 0;
+        node.mMax = 0;
+    }
+    mFrames = 0;
+}
+
+
+struct CachedZone
+{
+    std::string mName;
+    Profiler* mProfiler;
+    ScopeProfilerType mType;
+    unsigned int mZone;
+};
+
+// zones seen by the thread, keyed by the hash of their name so a lookup allocates nothing
+static thread_local std::unordered_map<unsigned int, std::vector<CachedZone>> ZoneCache;
+
+static unsigned int HashZoneName(const char* name)
+{
+    // FNV-1a
+    unsigned int hash = 2166136261u;
+    for (; *name; name++)
+        hash = (hash ^ (unsigned char)*name) * 16777619u;
+    return hash;
+}
+
+ScopeProfiler::ScopeProfiler(
+    Profiler* profiler, const char* name, ScopeProfilerType type)
+{
+    auto& zones = ZoneCache[HashZoneName(name)];
+    auto zone = std::find_if(zones.begin(), zones.end(), 
+        [profiler, type, name](const CachedZone& z)
         {
-		    case SPT_ADD:
-			    mProfiler->Add(mName, duration);
-			    break;
-		    case SPT_AVG:
-			    mProfiler->Avg(mName, duration);
-			    break;
-		    case SPT_GRAPH_ADD:
-			    mProfiler->GraphAdd(mName, duration);
-			    break;
-		}
-	}
-	delete mTimer;
+            return z.mProfiler == profiler && z.mType == type && z.mName == name;
+        });
+    if (zone != zones.end())
+    {
+        mZone = zone->mZone;
+    }
+    else
+    {
+        mZone = ProfileTrace::Get()->RegisterZone(name, profiler, type);
+        zones.push_back({ name, profiler, type, mZone });
+    }
+    ProfileTrace::Get()->Record(mZone, ProfileTrace::ET_BEGIN);
+}
+
+ScopeProfiler::ScopeProfiler(
+    Profiler* profiler, const std::string& name, ScopeProfilerType type) :
+    mZone(ProfileTrace::Get()->RegisterZone(name, profiler, type))
+{
+    ProfileTrace::Get()->Record(mZone, ProfileTrace::ET_BEGIN);
 }
@@ -24,6 +24,9 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #include "Core/Threading/MutexAutolock.h"
 
+#include <atomic>
+#include <tuple>
+
 enum ScopeProfilerType
 {
     SPT_ADD,
@@ -64,12 +67,7 @@ public:
 			i->second += value;
 	}
 
-	void GraphGet(GraphValues& result)
-	{
-		MutexAutoLock lock(mMutex);
-		result = mGraphValues;
-		mGraphValues.clear();
-	}
+	void GraphGet(GraphValues& result);
 
 	void Remove(const std::string& name)
 	{
@@ -90,19 +88,205 @@ private:
 // Global profiler
 extern Profiler* Profiling;
 
+/*
+	Scope tracing. Every thread records the begin and end of its scopes in its own ring
+	buffer, so recording a scope takes no lock. A full ring is handed off to the collector
+	and the thread carries on in a new one. The collector drains the ring buffers, pairs the
+	nested scopes into a call tree, and feeds the durations to the profiler of each zone.
+	Scopes are named by zones, which are interned once.
+*/
+
+// Events a ring buffer holds
+#define PROFILE_RING_SIZE 16384
+
+// Full ring buffers waiting for the collector, events are dropped beyond that
+#define PROFILE_PENDING_RINGS 64
+
+// Events kept in memory while a trace is being captured
+#define PROFILE_CAPTURE_SIZE 4194304
+
+class ProfileTrace
+{
+public:
+
+	enum EventType
+	{
+		ET_BEGIN,
+		ET_END,
+		ET_FRAME
+	};
+
+	static ProfileTrace* Get();
+
+	// Returns the id of the zone, the same name, profiler and type give the same zone
+	unsigned int RegisterZone(const std::string& name,
+		Profiler* profiler = nullptr, ScopeProfilerType type = SPT_ADD);
+
+	// Records an event in the ring buffer of the calling thread
+	void Record(unsigned int zone, EventType type);
+
+	// Marks the end of a frame on the calling thread
+	void MarkFrame() { Record(0, ET_FRAME); }
+
+	// Drains the ring buffers of all threads
+	void Collect();
+
+	// Keeps the collected events until they are exported to a trace file
+	void StartCapture();
+	void StopCapture();
+	bool IsCapturing() const { return mCapturing; }
+
+	// Writes the captured events in the chrome trace format (chrome://tracing or Perfetto)
+	bool ExportChromeTrace(const std::string& path);
+
+	// Prints the call tree with the count, total, self and max time of every scope.
+	// Returns the line count
+	int PrintSummary(std::ostream& o);
+	void ClearSummary();
+
+private:
+
+	struct Event
+	{
+		int64_t mTime;
+		unsigned int mZone;
+		unsigned int mType;
+	};
+
+	struct Zone
+	{
+		std::string mName;
+		std::string mLabel;
+		Profiler* mProfiler;
+		ScopeProfilerType mType;
+	};
+
+	// scope which has begun but not ended yet
+	struct OpenScope
+	{
+		unsigned int mNode;
+		int64_t mBegin;
+		int64_t mChildren;
+	};
+
+	// node of the call tree, a zone reached through the same chain of parent zones
+	struct Node
+	{
+		unsigned int mZone;
+		unsigned int mParent;
+		unsigned int mCount;
+		int64_t mTotal;
+		int64_t mSelf;
+		int64_t mMax;
+	};
+
+	struct CaptureEvent
+	{
+		int64_t mTime;
+		unsigned int mZone;
+		unsigned short mType;
+		unsigned short mThread;
+	};
+
+	// Ring written by its thread only, the collector owns the read index
+	struct Ring
+	{
+		Ring() : mWrite(0), mRead(0), mNext(nullptr) { }
+
+		Event mEvents[PROFILE_RING_SIZE];
+		std::atomic<unsigned int> mWrite;
+		std::atomic<unsigned int> mRead;
+		Ring* mNext;
+	};
+
+	// Events of a thread. The full rings are stacked newest first until the collector
+	// takes them. The collector owns the open scopes, the buffer of a finished thread is
+	// reused by the next new thread
+	struct ThreadBuffer
+	{
+		std::atomic<Ring*> mRing;
+		std::atomic<Ring*> mFullRings;
+		std::atomic<bool> mRetired;
+		unsigned int mThread;
+		std::vector<OpenScope> mOpenScopes;
+	};
+
+	ProfileTrace();
+
+	ThreadBuffer* GetThreadBuffer();
+	void Drain(ThreadBuffer* buffer);
+	void DrainRing(ThreadBuffer* buffer, Ring* ring);
+	unsigned int GetNode(unsigned int parent, unsigned int zone);
+	int PrintNode(std::ostream& o, unsigned int node, unsigned int depth);
+
+	std::mutex mZoneMutex;
+	std::vector<Zone> mZones;
+	std::map<std::tuple<std::string, Profiler*, int>, unsigned int> mZoneIds;
+
+	// guards everything the collector owns
+	std::mutex mMutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> mThreads;
+	unsigned int mThreadCount;
+	std::atomic<unsigned int> mPendingRings;
+	std::atomic<unsigned int> mDroppedEvents;
+
+	std::vector<Node> mNodes;
+	std::vector<std::vector<unsigned int>> mChildren;
+	std::map<std::pair<unsigned int, unsigned int>, unsigned int> mNodeIds;
+	unsigned int mFrames;
+	int64_t mFrameBegin;
+	int64_t mFrameEnd;
+
+	std::vector<CaptureEvent> mCapture;
+	std::atomic<bool> mCapturing;
+};
+
+// Static zone, registered the first time the scope runs
+class ProfileZone
+{
+public:
+	ProfileZone(const char* name,
+		Profiler* profiler = nullptr, ScopeProfilerType type = SPT_ADD) :
+		mId(ProfileTrace::Get()->RegisterZone(name, profiler, type))
+	{
+	}
+
+	unsigned int GetId() const { return mId; }
+
+private:
+	unsigned int mId;
+};
+
 class ScopeProfiler
 {
 
 public:
+	// The name is looked up by its content in a cache of the calling thread, so names
+	// are interned without locking once the thread has seen them
+	ScopeProfiler(Profiler* profiler,
+		const char* name, ScopeProfilerType type = SPT_ADD);
 	ScopeProfiler(Profiler* profiler, 
         const std::string& name, ScopeProfilerType type = SPT_ADD);
-	~ScopeProfiler();
+	ScopeProfiler(const ProfileZone& zone) : mZone(zone.GetId())
+	{
+		ProfileTrace::Get()->Record(mZone, ProfileTrace::ET_BEGIN);
+	}
+
+	~ScopeProfiler()
+	{
+		ProfileTrace::Get()->Record(mZone, ProfileTrace::ET_END);
+	}
 
 private:
-    TimeTaker* mTimer = nullptr;
-	Profiler* mProfiler = nullptr;
-	std::string mName;
-    ScopeProfilerType mType;
+	unsigned int mZone;
 };
 
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+// Traces the rest of the enclosing scope under a static zone
+#define PROFILE_SCOPE(...) \
+	static const ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(__VA_ARGS__); \
+	ScopeProfiler PROFILE_CONCAT(profileScope, __LINE__)(PROFILE_CONCAT(profileZone, __LINE__))
+
 #endif
\ No newline at end of file
@@ -287,6 +287,59 @@ std::string DeserializeString16(std::istream& is)
 //// Long String
 ////
 
+void WriteTransform(std::ostream& os, const Transform& transform)
+{
+	uint8_t flags = 0;
+	if (transform.IsIdentity())
+		flags |= 0x01;
+	if (transform.IsRSMatrix())
+		flags |= 0x02;
+	if (transform.IsUniformScale())
+		flags |= 0x04;
+
+	WriteUInt8(os, flags);
+	if (flags & 0x01)
+		return;
+
+	const Matrix4x4<float>& matrix = 
+		(flags & 0x02) ? transform.GetRotation() : transform.GetMatrix();
+	for (int i = 0; i < 3; ++i)
+		for (int j = 0; j < 3; ++j)
+			WriteFloat(os, matrix(i, j));
+
+	if (flags & 0x04)
+		WriteFloat(os, transform.GetUniformScale());
+	else if (flags & 0x02)
+		WriteV3Float(os, transform.GetScale());
+	WriteV3Float(os, transform.GetTranslation());
+}
+
+Transform ReadTransform(std::istream& is)
+{
+	Transform transform;
+
+	uint8_t flags = ReadUInt8(is);
+	if (flags & 0x01)
+		return transform;
+
+	Matrix4x4<float> matrix = Matrix4x4<float>::Identity();
+	for (int i = 0; i < 3; ++i)
+		for (int j = 0; j < 3; ++j)
+			matrix(i, j) = ReadFloat(is);
+
+	if (flags & 0x02)
+	{
+		transform.SetRotation(matrix);
+		if (flags & 0x04)
+			transform.SetUniformScale(ReadFloat(is));
+		else
+			transform.SetScale(ReadV3Float(is));
+	}
+	else transform.SetMatrix(matrix);
+	transform.SetTranslation(ReadV3Float(is));
+	return transform;
+}
+
 std::string SerializeString32(const std::string& plain)
 {
 	std::string str;
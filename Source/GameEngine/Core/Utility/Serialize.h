@@ -24,6 +24,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #include "Mathematic/Algebra/Vector2.h"
 #include "Mathematic/Algebra/Vector3.h"
+#include "Mathematic/Algebra/Transform.h"
 #include "Mathematic/Arithmetic/IEEEFloat.h"
 
 #include "Graphic/Resource/Color.h"
@@ -379,6 +380,11 @@ MAKE_STREAM_WRITE_FXN(Vector3<float>, V3Float, 12);
 MAKE_STREAM_WRITE_FXN(Vector2<float>, V2Float, 8);
 MAKE_STREAM_WRITE_FXN(SColor, ARGB8, 4);
 
+// Writes the transform keeping its structure hints. Identity transforms take a single byte
+// and rotation-scale transforms send the scale instead of the whole matrix
+void WriteTransform(std::ostream& os, const Transform& transform);
+Transform ReadTransform(std::istream& is);
+
 
 ////
 //// More serialization stuff
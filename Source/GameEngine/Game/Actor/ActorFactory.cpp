@@ -185,4 +185,56 @@ void ActorFactory::ModifyActor(std::shared_ptr<Actor> pActor, tinyxml2::XMLEleme
 		}
 		else pComponent = CreateComponent(pActor, pNode);
 	}		
-}
\ No newline at end of file
+}
+// Requests the resources named in the text of the element and its children. The names are
+// taken the same way the components read them, so the requests load what they will look up
+static void RequestElementResources(tinyxml2::XMLElement* pElement, std::vector<ResHandleFuture>& requests)
+{
+	for (; pElement; pElement = pElement->NextSiblingElement())
+	{
+		std::vector<std::string> names;
+		if (pElement->Attribute("file"))
+			names.push_back(pElement->Attribute("file"));
+
+		if (pElement->FirstChildElement())
+		{
+			RequestElementResources(pElement->FirstChildElement(), requests);
+		}
+		else if (pElement->GetText())
+		{
+			std::string text = pElement->GetText();
+			text.erase(std::remove(text.begin(), text.end(), '\r'), text.end());
+			text.erase(std::remove(text.begin(), text.end(), '\n'), text.end());
+			text.erase(std::remove(text.begin(), text.end(), '\t'), text.end());
+			size_t nameBegin = 0, nameEnd = 0;
+			do
+			{
+				nameEnd = text.find(',', nameBegin);
+				names.push_back(text.substr(nameBegin, nameEnd - nameBegin));
+
+				nameBegin = nameEnd + 1;
+			} while (nameEnd != std::string::npos);
+		}
+
+		for (std::string const& name : names)
+		{
+			// most of the text are values, only files a loader knows are resources
+			BaseResource resource(ToWideString(name));
+			if (name.find('.') == std::string::npos || 
+				!ResCache::Get()->ExistLoader(&resource) || !ResCache::Get()->ExistResource(&resource))
+				continue;
+
+			requests.push_back(ResCache::Get()->RequestAsync(resource));
+		}
+	}
+}
+
+void ActorFactory::RequestResources(const wchar_t* actorResource,
+	tinyxml2::XMLElement* overrides, std::vector<ResHandleFuture>& requests)
+{
+	tinyxml2::XMLElement* pRoot = XmlResourceLoader::LoadAndReturnRootXMLElement(actorResource);
+	if (pRoot)
+		RequestElementResources(pRoot->FirstChildElement(), requests);
+	if (overrides)
+		RequestElementResources(overrides->FirstChildElement(), requests);
+}
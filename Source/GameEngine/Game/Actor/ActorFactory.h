@@ -43,6 +43,8 @@
 
 #include "Actor.h"
 
+#include "Core/IO/ResourceCache.h"
+
 #include "Mathematic/Algebra/Transform.h"
 
 /*
@@ -64,6 +66,11 @@ public:
 		const Transform* initialTransform, const ActorId serversActorId);
 	void ModifyActor(std::shared_ptr<Actor> pActor, tinyxml2::XMLElement* overrides);
 
+	// Queues the resources named by the actor and its overrides on the loader threads of the
+	// resource cache, so that creating the actor finds them loaded or loading
+	void RequestResources(const wchar_t* actorResource, 
+		tinyxml2::XMLElement* overrides, std::vector<ResHandleFuture>& requests);
+
 //protected:
     // This function can be overridden by a subclass so you can create game-specific 
 	// C++ components. If you do this, make sure you call the base-class version first.  
@@ -284,6 +284,22 @@ void GameLogic::ModifyActor(const ActorId actorId, tinyxml2::XMLElement* overrid
 	}
 }
 
+void GameLogic::RequestActorResources(
+	tinyxml2::XMLElement* pActorsNode, std::vector<ResHandleFuture>& requests)
+{
+	LogAssert(mActorFactory, "actor factory is not initialized");
+	if (!mActorFactory)
+		return;
+
+	tinyxml2::XMLElement* pNode = pActorsNode->FirstChildElement();
+	for (; pNode; pNode = pNode->NextSiblingElement())
+	{
+		const char* actorResource = pNode->Attribute("resource");
+		if (actorResource)
+			mActorFactory->RequestResources(ToWideString(actorResource).c_str(), pNode, requests);
+	}
+}
+
 void GameLogic::OnUpdate(float time, float elapsedTime)
 {
 	mLifetime += elapsedTime;
@@ -43,6 +43,7 @@
 
 #include "Core/Process/ProcessManager.h"
 #include "Core/Event/EventManager.h"
+#include "Core/IO/ResourceCache.h"
 #include "Game/Actor/Actor.h"
 
 #include "Mathematic/Algebra/Transform.h"
@@ -119,6 +120,10 @@ public:
 	virtual std::weak_ptr<Actor> GetActor(const ActorId actorId);
 	virtual void ModifyActor(const ActorId actorId, tinyxml2::XMLElement *overrides);
 
+	// Starts loading the resources of the actors listed under the node. The requests keep the
+	// resources in the cache until they are released
+	void RequestActorResources(tinyxml2::XMLElement* pActorsNode, std::vector<ResHandleFuture>& requests);
+
 	virtual void SyncActor(const ActorId id, Transform const &transform) {}
 
 	// editor functions
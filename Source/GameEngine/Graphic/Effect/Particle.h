@@ -48,5 +48,109 @@ struct GRAPHIC_ITEM Particle
 	Vector2<float> mStartSize;
 };
 
+//! Particles stored as one array per member of Particle.
+/** The affectors and the particle system node run over these arrays several
+particles at a time. Dead particles are removed by moving the last particle
+into their place, so the order of the particles is not kept. */
+struct GRAPHIC_ITEM ParticleArray
+{
+	ParticleArray() : mCount(0) {}
+
+	//! Amount of particles in the arrays.
+	unsigned int Size() const { return mCount; }
+
+	//! Removes all particles, the arrays keep their capacity.
+	void Clear() { mCount = 0; }
+
+	//! Appends a particle, growing the arrays when needed.
+	void Push(const Particle& particle)
+	{
+		if (mCount == mStartTime.size())
+		{
+			size_t capacity = std::max(mStartTime.size() * 2, (size_t)64);
+			ForEachArray([capacity](auto& values) { values.resize(capacity); });
+		}
+		Set(mCount++, particle);
+	}
+
+	//! Removes a particle by moving the last one into its place.
+	void Remove(unsigned int i)
+	{
+		const unsigned int last = --mCount;
+		if (i != last)
+			ForEachArray([i, last](auto& values) { values[i] = values[last]; });
+	}
+
+	//! Copies a particle into the arrays.
+	void Set(unsigned int i, const Particle& particle)
+	{
+		mPositionX[i] = particle.mPosition[0];
+		mPositionY[i] = particle.mPosition[1];
+		mPositionZ[i] = particle.mPosition[2];
+		mVectorX[i] = particle.mVector[0];
+		mVectorY[i] = particle.mVector[1];
+		mVectorZ[i] = particle.mVector[2];
+		mStartTime[i] = particle.mStartTime;
+		mEndTime[i] = particle.mEndTime;
+		mColorR[i] = particle.mColor.mRed;
+		mColorG[i] = particle.mColor.mGreen;
+		mColorB[i] = particle.mColor.mBlue;
+		mColorA[i] = particle.mColor.mAlpha;
+		mStartColorR[i] = particle.mStartColor.mRed;
+		mStartColorG[i] = particle.mStartColor.mGreen;
+		mStartColorB[i] = particle.mStartColor.mBlue;
+		mStartColorA[i] = particle.mStartColor.mAlpha;
+		mStartVectorX[i] = particle.mStartVector[0];
+		mStartVectorY[i] = particle.mStartVector[1];
+		mStartVectorZ[i] = particle.mStartVector[2];
+		mSizeX[i] = particle.mSize[0];
+		mSizeY[i] = particle.mSize[1];
+		mStartSizeX[i] = particle.mStartSize[0];
+		mStartSizeY[i] = particle.mStartSize[1];
+	}
+
+	//! Copies a particle out of the arrays.
+	Particle Get(unsigned int i) const
+	{
+		Particle particle;
+		particle.mPosition = Vector3<float>{ mPositionX[i], mPositionY[i], mPositionZ[i] };
+		particle.mVector = Vector3<float>{ mVectorX[i], mVectorY[i], mVectorZ[i] };
+		particle.mStartTime = mStartTime[i];
+		particle.mEndTime = mEndTime[i];
+		particle.mColor = SColorF(mColorR[i], mColorG[i], mColorB[i], mColorA[i]);
+		particle.mStartColor = SColorF(mStartColorR[i], mStartColorG[i], mStartColorB[i], mStartColorA[i]);
+		particle.mStartVector = Vector3<float>{ mStartVectorX[i], mStartVectorY[i], mStartVectorZ[i] };
+		particle.mSize = Vector2<float>{ mSizeX[i], mSizeY[i] };
+		particle.mStartSize = Vector2<float>{ mStartSizeX[i], mStartSizeY[i] };
+		return particle;
+	}
+
+	std::vector<float> mPositionX, mPositionY, mPositionZ;
+	std::vector<float> mVectorX, mVectorY, mVectorZ;
+	std::vector<unsigned int> mStartTime, mEndTime;
+	std::vector<float> mColorR, mColorG, mColorB, mColorA;
+	std::vector<float> mStartColorR, mStartColorG, mStartColorB, mStartColorA;
+	std::vector<float> mStartVectorX, mStartVectorY, mStartVectorZ;
+	std::vector<float> mSizeX, mSizeY;
+	std::vector<float> mStartSizeX, mStartSizeY;
+
+private:
+
+	template <typename Function>
+	void ForEachArray(const Function& function)
+	{
+		function(mPositionX); function(mPositionY); function(mPositionZ);
+		function(mVectorX); function(mVectorY); function(mVectorZ);
+		function(mStartTime); function(mEndTime);
+		function(mColorR); function(mColorG); function(mColorB); function(mColorA);
+		function(mStartColorR); function(mStartColorG); function(mStartColorB); function(mStartColorA);
+		function(mStartVectorX); function(mStartVectorY); function(mStartVectorZ);
+		function(mSizeX); function(mSizeY);
+		function(mStartSizeX); function(mStartSizeY);
+	}
+
+	unsigned int mCount;
+};
+
 #endif
 
@@ -0,0 +1,147 @@
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+#include "Core/Logger/Logger.h"
+#include "Core/IO/FileSystem.h"
+#include "Core/Utility/StringUtil.h"
+
+#include "NullProgramFactory.h"
+#include "NullShader.h"
+
+NullVisualProgram::NullVisualProgram(std::vector<std::string> const& sources, bool glsl)
+	:
+	mSources(sources),
+	mGLSL(glsl)
+{
+	SetVertexShader(std::make_shared<NullShader>(GE_VERTEX_SHADER, mSources, glsl));
+	SetPixelShader(std::make_shared<NullShader>(GE_PIXEL_SHADER, mSources, glsl));
+	if (mSources.size() > 2)
+		SetGeometryShader(std::make_shared<NullShader>(GE_GEOMETRY_SHADER, mSources, glsl));
+}
+
+//----------------------------------------------------------------------------
+NullProgramFactory::NullProgramFactory()
+{
+	version = "";
+	vsEntry = "main";
+	psEntry = "main";
+	gsEntry = "main";
+	csEntry = "main";
+	flags = 0;
+}
+
+int NullProgramFactory::GetAPI() const
+{
+#if defined(_OPENGL_)
+	return PF_GLSL;
+#else
+	return PF_HLSL;
+#endif
+}
+
+std::shared_ptr<VisualProgram> NullProgramFactory::CreateFromProgram(
+	std::shared_ptr<VisualProgram> const& program)
+{
+	NullVisualProgram* nullProgram = dynamic_cast<NullVisualProgram*>(program.get());
+	if (!nullProgram)
+	{
+		LogError("Null program doesn't exist.");
+		return nullptr;
+	}
+	return std::make_shared<NullVisualProgram>(nullProgram->GetSources(), nullProgram->IsGLSL());
+}
+
+bool NullProgramFactory::ReadSource(std::string const& fileName, std::string& source)
+{
+	BaseReadFile* file = FileSystem::Get()->CreateReadFile(
+		ToWideString(FileSystem::Get()->GetPath(fileName)));
+	if (file == nullptr)
+		return false;
+
+	source.resize(static_cast<size_t>(file->GetSize()));
+	if (!source.empty())
+		file->Read(&source[0], file->GetSize());
+	delete file;
+	return true;
+}
+
+std::shared_ptr<VisualProgram> NullProgramFactory::CreateFromNamedFiles(
+	std::string const& vsName, std::string const& vsFile,
+	std::string const& psName, std::string const& psFile,
+	std::string const& gsName, std::string const& gsFile,
+	ProgramDefines const& customDefines)
+{
+	std::string vsSource, psSource, gsSource;
+	if (!ReadSource(vsFile, vsSource))
+	{
+		LogError("A program must have a vertex shader");
+		return nullptr;
+	}
+	if (!ReadSource(psFile, psSource))
+	{
+		LogError("A program must have a pixel shader.");
+		return nullptr;
+	}
+	if (gsFile != "")
+		ReadSource(gsFile, gsSource);
+
+	return CreateFromNamedSources(vsName, vsSource, psName, psSource, gsName, gsSource, customDefines);
+}
+
+std::shared_ptr<VisualProgram> NullProgramFactory::CreateFromNamedSources(
+	std::string const&, std::string const& vsSource,
+	std::string const&, std::string const& psSource,
+	std::string const&, std::string const& gsSource,
+	ProgramDefines const&)
+{
+	if (vsSource == "" || psSource == "")
+	{
+		LogError("A program must have a vertex shader and a pixel shader.");
+		return nullptr;
+	}
+
+	std::vector<std::string> sources{ vsSource, psSource };
+	if (gsSource != "")
+		sources.push_back(gsSource);
+	return std::make_shared<NullVisualProgram>(sources, GetAPI() == PF_GLSL);
+}
+
+std::shared_ptr<ComputeProgram> NullProgramFactory::CreateFromNamedFile(
+	std::string const& csName, std::string const& csFile, ProgramDefines const& customDefines)
+{
+	std::string csSource;
+	if (!ReadSource(csFile, csSource))
+	{
+		LogError("A program must have a compute shader.");
+		return nullptr;
+	}
+	return CreateFromNamedSource(csName, csSource, customDefines);
+}
+
+std::shared_ptr<ComputeProgram> NullProgramFactory::CreateFromNamedSource(
+	std::string const&, std::string const& csSource, ProgramDefines const&)
+{
+	if (csSource == "")
+	{
+		LogError("A program must have a compute shader.");
+		return nullptr;
+	}
+
+	std::shared_ptr<ComputeProgram> program = std::make_shared<ComputeProgram>();
+	program->SetComputeShader(std::make_shared<NullShader>(
+		GE_COMPUTE_SHADER, std::vector<std::string>{ csSource }, GetAPI() == PF_GLSL));
+	return program;
+}
@@ -0,0 +1,84 @@
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+#ifndef NULLPROGRAMFACTORY_H
+#define NULLPROGRAMFACTORY_H
+
+#include "Graphic/Shader/ProgramFactory.h"
+
+// Program of the null renderer. It keeps the stage sources so that the
+// shaders of a copied program can be created again.
+class GRAPHIC_ITEM NullVisualProgram : public VisualProgram
+{
+public:
+	NullVisualProgram(std::vector<std::string> const& sources, bool glsl);
+
+	inline std::vector<std::string> const& GetSources() const
+	{
+		return mSources;
+	}
+
+	inline bool IsGLSL() const
+	{
+		return mGLSL;
+	}
+
+private:
+	std::vector<std::string> mSources;
+	bool mGLSL;
+};
+
+// Program factory of the null renderer. Nothing is compiled, the shaders take
+// their resource names and buffer layouts from the sources (see NullShader).
+// The sources are the ones of the shading language the engine is built for,
+// GLSL for _OPENGL_ and HLSL otherwise.
+class GRAPHIC_ITEM NullProgramFactory : public ProgramFactory
+{
+public:
+	NullProgramFactory();
+
+	virtual int GetAPI() const override;
+
+	// Create new shader program from the sources of a created one
+	virtual std::shared_ptr<VisualProgram> CreateFromProgram(
+		std::shared_ptr<VisualProgram> const& program) override;
+
+private:
+
+	virtual std::shared_ptr<VisualProgram> CreateFromNamedFiles(
+		std::string const& vsName, std::string const& vsFile,
+		std::string const& psName, std::string const& psFile,
+		std::string const& gsName, std::string const& gsFile,
+		ProgramDefines const& customDefines) override;
+
+	virtual std::shared_ptr<VisualProgram> CreateFromNamedSources(
+		std::string const& vsName, std::string const& vsSource,
+		std::string const& psName, std::string const& psSource,
+		std::string const& gsName, std::string const& gsSource,
+		ProgramDefines const& customDefines) override;
+
+	virtual std::shared_ptr<ComputeProgram> CreateFromNamedFile(
+		std::string const& csName, std::string const& csFile,
+		ProgramDefines const& customDefines) override;
+
+	virtual std::shared_ptr<ComputeProgram> CreateFromNamedSource(
+		std::string const& csName, std::string const& csSource,
+		ProgramDefines const& customDefines) override;
+
+	bool ReadSource(std::string const& fileName, std::string& source);
+};
+
+#endif
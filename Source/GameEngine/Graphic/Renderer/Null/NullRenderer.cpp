@@ -0,0 +1,511 @@
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+#include "Graphic/Graphic.h"
+
+#include "NullRenderer.h"
+
+// Bridge objects of the null renderer. They carry no device data, the bridge
+// maps are kept so that Bind, Get and Unbind behave as on the other renderers.
+class NullGraphicObject : public CustomGraphicObject
+{
+public:
+	NullGraphicObject(GraphicObject const* gObject) : CustomGraphicObject(gObject) { }
+
+	static std::shared_ptr<CustomGraphicObject> Create(void*, GraphicObject const* object)
+	{
+		return std::make_shared<NullGraphicObject>(object);
+	}
+
+	virtual void SetName(std::string const& name) override
+	{
+		mName = name;
+	}
+};
+
+class NullDrawTarget : public CustomDrawTarget
+{
+public:
+	NullDrawTarget(DrawTarget const* target) : CustomDrawTarget(target) { }
+
+	static std::shared_ptr<CustomDrawTarget> Create(DrawTarget const* target,
+		std::vector<CustomGraphicObject*>&, CustomGraphicObject*)
+	{
+		return std::make_shared<NullDrawTarget>(target);
+	}
+};
+
+class NullInputLayoutManager : public InputLayoutManager
+{
+public:
+	virtual bool Unbind(VertexBuffer const*) override { return false; }
+	virtual bool Unbind(Shader const*) override { return false; }
+	virtual void UnbindAll() override { }
+	virtual bool HasElements() const override { return false; }
+};
+
+static char const* GetTopologyName(IPType type)
+{
+	switch (type)
+	{
+		case IP_POLYPOINT: return "points";
+		case IP_POLYSEGMENT_DISJOINT: return "lines";
+		case IP_POLYSEGMENT_CONTIGUOUS: return "linestrip";
+		case IP_TRIMESH: return "triangles";
+		case IP_TRISTRIP: return "tristrip";
+		case IP_POLYSEGMENT_DISJOINT_ADJ: return "linesadj";
+		case IP_POLYSEGMENT_CONTIGUOUS_ADJ: return "linestripadj";
+		case IP_TRIMESH_ADJ: return "trianglesadj";
+		case IP_TRISTRIP_ADJ: return "tristripadj";
+		default: return "none";
+	}
+}
+
+//----------------------------------------------------------------------------
+NullRenderer::Statistics::Statistics()
+	:
+	numDrawCalls(0),
+	numPrimitives(0),
+	numVertices(0),
+	numStateChanges(0),
+	numTargetChanges(0),
+	numClears(0),
+	numBytesUploaded(0),
+	numBytesDownloaded(0)
+{
+}
+
+void NullRenderer::Statistics::Add(Statistics const& statistics)
+{
+	numDrawCalls += statistics.numDrawCalls;
+	numPrimitives += statistics.numPrimitives;
+	numVertices += statistics.numVertices;
+	numStateChanges += statistics.numStateChanges;
+	numTargetChanges += statistics.numTargetChanges;
+	numClears += statistics.numClears;
+	numBytesUploaded += statistics.numBytesUploaded;
+	numBytesDownloaded += statistics.numBytesDownloaded;
+}
+
+//----------------------------------------------------------------------------
+NullRenderer::NullRenderer(unsigned int width, unsigned int height)
+	:
+	Renderer(),
+	mViewportX(0), mViewportY(0), mViewportW(width), mViewportH(height),
+	mDepthMin(0.0f), mDepthMax(1.0f),
+	mNumFrames(0)
+{
+	mScreenSize[0] = width;
+	mScreenSize[1] = height;
+
+	mInputLayouts = std::make_unique<NullInputLayoutManager>();
+
+	// Every concrete graphic object gets a null bridge object.
+	mCreateGraphicObject.fill(&NullGraphicObject::Create);
+	mCreateDrawTarget = &NullDrawTarget::Create;
+
+	CreateDefaultGlobalState();
+}
+
+NullRenderer::~NullRenderer()
+{
+	// The render state objects (and fonts) are destroyed first so that the
+	// render state objects are removed from the bridges before they are
+	// cleared.
+	mDefaultFont = nullptr;
+	mActiveFont = nullptr;
+	DestroyDefaultGlobalState();
+
+	GraphicObject::UnsubscribeForDestruction(mGOListener);
+	mGOListener = nullptr;
+
+	DrawTarget::UnsubscribeForDestruction(mDTListener);
+	mDTListener = nullptr;
+
+	if (mGraphicObjects.size())
+	{
+		if (mWarnOnNonemptyBridges)
+			LogWarning("Bridge map is nonempty on destruction.");
+		mGraphicObjects.clear();
+	}
+
+	if (mDrawTargets.size())
+	{
+		if (mWarnOnNonemptyBridges)
+			LogWarning("Draw target map nonempty on destruction.");
+		mDrawTargets.clear();
+	}
+	mInputLayouts = nullptr;
+}
+
+bool NullRenderer::SetCommandLog(std::string const& fileName)
+{
+	if (mCommandLog.is_open())
+		mCommandLog.close();
+
+	if (fileName.empty())
+		return true;
+
+	mCommandLog.open(fileName.c_str(), std::ios::out | std::ios::trunc);
+	if (!mCommandLog.is_open())
+	{
+		LogError("Failed to open command log " + fileName + ".");
+		return false;
+	}
+	mCommandLog << "frame " << mNumFrames << '\n';
+	return true;
+}
+
+//----------------------------------------------------------------------------
+void NullRenderer::SetViewport(int x, int y, int w, int h)
+{
+	mViewportX = x;
+	mViewportY = y;
+	mViewportW = w;
+	mViewportH = h;
+
+	if (mCommandLog.is_open())
+		mCommandLog << "viewport " << x << ' ' << y << ' ' << w << ' ' << h << '\n';
+}
+
+void NullRenderer::GetViewport(int& x, int& y, int& w, int& h) const
+{
+	x = mViewportX;
+	y = mViewportY;
+	w = mViewportW;
+	h = mViewportH;
+}
+
+void NullRenderer::SetDepthRange(float zmin, float zmax)
+{
+	mDepthMin = zmin;
+	mDepthMax = zmax;
+}
+
+void NullRenderer::GetDepthRange(float& zmin, float& zmax) const
+{
+	zmin = mDepthMin;
+	zmax = mDepthMax;
+}
+
+bool NullRenderer::Resize(unsigned int w, unsigned int h)
+{
+	mScreenSize[0] = w;
+	mScreenSize[1] = h;
+	mViewportW = static_cast<int>(w);
+	mViewportH = static_cast<int>(h);
+
+	if (mCommandLog.is_open())
+		mCommandLog << "resize " << w << ' ' << h << '\n';
+	return true;
+}
+
+void NullRenderer::ClearColorBuffer()
+{
+	++mFrame.numClears;
+	if (mCommandLog.is_open())
+		mCommandLog << "clear color\n";
+}
+
+void NullRenderer::ClearDepthBuffer()
+{
+	++mFrame.numClears;
+	if (mCommandLog.is_open())
+		mCommandLog << "clear depth\n";
+}
+
+void NullRenderer::ClearStencilBuffer()
+{
+	++mFrame.numClears;
+	if (mCommandLog.is_open())
+		mCommandLog << "clear stencil\n";
+}
+
+void NullRenderer::ClearBuffers()
+{
+	++mFrame.numClears;
+	if (mCommandLog.is_open())
+		mCommandLog << "clear all\n";
+}
+
+void NullRenderer::DisplayColorBuffer(unsigned int)
+{
+	// end of frame
+	mLastFrame = mFrame;
+	mTotal.Add(mFrame);
+	mFrame = Statistics();
+	++mNumFrames;
+
+	if (mCommandLog.is_open())
+	{
+		mCommandLog << "present " << mLastFrame.numDrawCalls << ' ' << mLastFrame.numPrimitives <<
+			' ' << mLastFrame.numStateChanges << ' ' << mLastFrame.numBytesUploaded << '\n';
+		mCommandLog << "frame " << mNumFrames << '\n';
+	}
+}
+
+void NullRenderer::SetBlendState(std::shared_ptr<BlendState> const& state)
+{
+	if (state)
+	{
+		if (state != mActiveBlendState)
+		{
+			Bind(state);
+			mActiveBlendState = state;
+			++mFrame.numStateChanges;
+			if (mCommandLog.is_open())
+				mCommandLog << "state blend\n";
+		}
+	}
+	else
+	{
+		LogError("Input state is null.");
+	}
+}
+
+void NullRenderer::SetDepthStencilState(std::shared_ptr<DepthStencilState> const& state)
+{
+	if (state)
+	{
+		if (state != mActiveDepthStencilState)
+		{
+			Bind(state);
+			mActiveDepthStencilState = state;
+			++mFrame.numStateChanges;
+			if (mCommandLog.is_open())
+				mCommandLog << "state depthstencil\n";
+		}
+	}
+	else
+	{
+		LogError("Input state is null.");
+	}
+}
+
+void NullRenderer::SetRasterizerState(std::shared_ptr<RasterizerState> const& state)
+{
+	if (state)
+	{
+		if (state != mActiveRasterizerState)
+		{
+			Bind(state);
+			mActiveRasterizerState = state;
+			++mFrame.numStateChanges;
+			if (mCommandLog.is_open())
+				mCommandLog << "state rasterizer\n";
+		}
+	}
+	else
+	{
+		LogError("Input state is null.");
+	}
+}
+
+void NullRenderer::Enable(std::shared_ptr<DrawTarget> const& target)
+{
+	Bind(target);
+	++mFrame.numTargetChanges;
+	if (mCommandLog.is_open())
+		mCommandLog << "target enable " << target->GetWidth() << ' ' << target->GetHeight() << '\n';
+}
+
+void NullRenderer::Disable(std::shared_ptr<DrawTarget> const& target)
+{
+	if (Get(target))
+	{
+		++mFrame.numTargetChanges;
+		if (mCommandLog.is_open())
+			mCommandLog << "target disable\n";
+	}
+}
+
+//----------------------------------------------------------------------------
+bool NullRenderer::Upload(std::shared_ptr<Resource> const& resource, unsigned int numBytes, char const* command)
+{
+	if (!resource->GetData())
+	{
+		LogWarning("Resource does not have system memory, creating it.");
+		resource->CreateStorage();
+	}
+
+	Bind(resource);
+	mFrame.numBytesUploaded += numBytes;
+	if (mCommandLog.is_open())
+		mCommandLog << command << ' ' << numBytes << '\n';
+	return true;
+}
+
+bool NullRenderer::Download(std::shared_ptr<Resource> const& resource, unsigned int numBytes, char const* command)
+{
+	if (!resource->GetData())
+	{
+		LogWarning("Resource does not have system memory, creating it.");
+		resource->CreateStorage();
+	}
+
+	Bind(resource);
+	mFrame.numBytesDownloaded += numBytes;
+	if (mCommandLog.is_open())
+		mCommandLog << command << ' ' << numBytes << '\n';
+	return true;
+}
+
+bool NullRenderer::Update(std::shared_ptr<Buffer> const& buffer)
+{
+	return Upload(buffer, buffer->GetNumActiveBytes(), "update buffer");
+}
+
+bool NullRenderer::Update(std::shared_ptr<TextureSingle> const& texture)
+{
+	return Upload(texture, texture->GetNumBytes(), "update texture");
+}
+
+bool NullRenderer::Update(std::shared_ptr<TextureSingle> const& texture, unsigned int level)
+{
+	return Upload(texture, texture->GetNumBytesFor(level), "update texture");
+}
+
+bool NullRenderer::Update(std::shared_ptr<TextureArray> const& textureArray)
+{
+	return Upload(textureArray, textureArray->GetNumBytes(), "update texturearray");
+}
+
+bool NullRenderer::Update(std::shared_ptr<TextureArray> const& textureArray, unsigned int, unsigned int level)
+{
+	return Upload(textureArray, textureArray->GetNumBytesFor(level), "update texturearray");
+}
+
+bool NullRenderer::CopyCpuToGpu(std::shared_ptr<Buffer> const& buffer)
+{
+	return Upload(buffer, buffer->GetNumActiveBytes(), "copy buffer");
+}
+
+bool NullRenderer::CopyCpuToGpu(std::shared_ptr<TextureSingle> const& texture)
+{
+	return Upload(texture, texture->GetNumBytes(), "copy texture");
+}
+
+bool NullRenderer::CopyCpuToGpu(std::shared_ptr<TextureSingle> const& texture, unsigned int level)
+{
+	return Upload(texture, texture->GetNumBytesFor(level), "copy texture");
+}
+
+bool NullRenderer::CopyCpuToGpu(std::shared_ptr<TextureArray> const& textureArray)
+{
+	return Upload(textureArray, textureArray->GetNumBytes(), "copy texturearray");
+}
+
+bool NullRenderer::CopyCpuToGpu(std::shared_ptr<TextureArray> const& textureArray, unsigned int, unsigned int level)
+{
+	return Upload(textureArray, textureArray->GetNumBytesFor(level), "copy texturearray");
+}
+
+bool NullRenderer::CopyGpuToCpu(std::shared_ptr<Buffer> const& buffer)
+{
+	return Download(buffer, buffer->GetNumActiveBytes(), "read buffer");
+}
+
+bool NullRenderer::CopyGpuToCpu(std::shared_ptr<TextureSingle> const& texture)
+{
+	return Download(texture, texture->GetNumBytes(), "read texture");
+}
+
+bool NullRenderer::CopyGpuToCpu(std::shared_ptr<TextureSingle> const& texture, unsigned int level)
+{
+	return Download(texture, texture->GetNumBytesFor(level), "read texture");
+}
+
+bool NullRenderer::CopyGpuToCpu(std::shared_ptr<TextureArray> const& textureArray)
+{
+	return Download(textureArray, textureArray->GetNumBytes(), "read texturearray");
+}
+
+bool NullRenderer::CopyGpuToCpu(std::shared_ptr<TextureArray> const& textureArray, unsigned int, unsigned int level)
+{
+	return Download(textureArray, textureArray->GetNumBytesFor(level), "read texturearray");
+}
+
+void NullRenderer::CopyGpuToGpu(
+	std::shared_ptr<Buffer> const&,
+	std::shared_ptr<Buffer> const&)
+{
+	if (mCommandLog.is_open())
+		mCommandLog << "copy gpu buffer\n";
+}
+
+void NullRenderer::CopyGpuToGpu(
+	std::shared_ptr<TextureSingle> const&,
+	std::shared_ptr<TextureSingle> const&)
+{
+	if (mCommandLog.is_open())
+		mCommandLog << "copy gpu texture\n";
+}
+
+void NullRenderer::CopyGpuToGpu(
+	std::shared_ptr<TextureSingle> const&,
+	std::shared_ptr<TextureSingle> const&,
+	unsigned int)
+{
+	if (mCommandLog.is_open())
+		mCommandLog << "copy gpu texture\n";
+}
+
+void NullRenderer::CopyGpuToGpu(
+	std::shared_ptr<TextureArray> const&,
+	std::shared_ptr<TextureArray> const&)
+{
+	if (mCommandLog.is_open())
+		mCommandLog << "copy gpu texturearray\n";
+}
+
+void NullRenderer::CopyGpuToGpu(
+	std::shared_ptr<TextureArray> const&,
+	std::shared_ptr<TextureArray> const&,
+	unsigned int, unsigned int)
+{
+	if (mCommandLog.is_open())
+		mCommandLog << "copy gpu texturearray\n";
+}
+
+//----------------------------------------------------------------------------
+uint64_t NullRenderer::DrawPrimitive(std::shared_ptr<VertexBuffer> const& vbuffer,
+	std::shared_ptr<IndexBuffer> const& ibuffer, std::shared_ptr<VisualEffect> const& effect)
+{
+	if (!effect->GetProgram())
+	{
+		LogError("Effect program doesn't exist.");
+		return 0;
+	}
+
+	// The buffers are bound as a device renderer does before drawing.
+	if (vbuffer->StandardUsage())
+		Bind(vbuffer);
+	if (ibuffer->IsIndexed())
+		Bind(ibuffer);
+
+	unsigned int const numPrimitives = ibuffer->GetNumActivePrimitives();
+	unsigned int const numVertices = vbuffer->GetNumActiveElements();
+	++mFrame.numDrawCalls;
+	mFrame.numPrimitives += numPrimitives;
+	mFrame.numVertices += numVertices;
+
+	if (mCommandLog.is_open())
+	{
+		mCommandLog << "draw " << GetTopologyName(ibuffer->GetPrimitiveType()) << ' ' <<
+			numPrimitives << ' ' << numVertices << '\n';
+	}
+	return 0;
+}
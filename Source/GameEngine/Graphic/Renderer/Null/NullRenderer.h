@@ -0,0 +1,169 @@
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+#ifndef NULLRENDERER_H
+#define NULLRENDERER_H
+
+#include "Graphic/Renderer/Renderer.h"
+
+#include <fstream>
+
+/*
+	Renderer without a graphics device, selected with the "null" video driver.
+	Every call is accepted so that the game logic and views run on machines
+	without a GPU, such as dedicated servers or AI training boxes. Graphic
+	objects are still bound to the bridge maps and the calls are counted per
+	frame, which makes the renderer a deterministic measure of the CPU side
+	of rendering. Optionally every command is written to a log, one compact
+	line each, to compare the command streams of two builds.
+*/
+class GRAPHIC_ITEM NullRenderer : public Renderer
+{
+public:
+	// Construction and destruction.
+	virtual ~NullRenderer();
+	NullRenderer(unsigned int width, unsigned int height);
+
+	// Counters of the commands issued in a frame, which ends on
+	// DisplayColorBuffer. A draw call is issued per visual drawn and per text.
+	struct Statistics
+	{
+		Statistics();
+
+		void Add(Statistics const& statistics);
+
+		unsigned int numDrawCalls;
+		unsigned int numPrimitives;
+		unsigned int numVertices;
+		unsigned int numStateChanges;
+		unsigned int numTargetChanges;
+		unsigned int numClears;
+		uint64_t numBytesUploaded;
+		uint64_t numBytesDownloaded;
+	};
+
+	// Statistics of the last completed frame and of all completed frames.
+	inline Statistics const& GetFrameStatistics() const;
+	inline Statistics const& GetTotalStatistics() const;
+	inline unsigned int GetNumFrames() const;
+
+	// Write the commands to the file. An empty file name stops the log.
+	bool SetCommandLog(std::string const& fileName);
+
+	// Viewport management.
+	virtual void SetViewport(int x, int y, int w, int h) override;
+	virtual void GetViewport(int& x, int& y, int& w, int& h) const override;
+	virtual void SetDepthRange(float zmin, float zmax) override;
+	virtual void GetDepthRange(float& zmin, float& zmax) const override;
+
+	// Window resizing.
+	virtual bool Resize(unsigned int w, unsigned int h) override;
+
+	// Support for clearing the color, depth, and stencil back buffers.
+	virtual void ClearColorBuffer() override;
+	virtual void ClearDepthBuffer() override;
+	virtual void ClearStencilBuffer() override;
+	virtual void ClearBuffers() override;
+	virtual void DisplayColorBuffer(unsigned int syncInterval) override;
+
+	// Global drawing state.
+	virtual void SetBlendState(std::shared_ptr<BlendState> const& state) override;
+	virtual void SetDepthStencilState(std::shared_ptr<DepthStencilState> const& state) override;
+	virtual void SetRasterizerState(std::shared_ptr<RasterizerState> const& state) override;
+
+	// Support for drawing to offscreen memory.
+	virtual void Enable(std::shared_ptr<DrawTarget> const& target) override;
+	virtual void Disable(std::shared_ptr<DrawTarget> const& target) override;
+
+	// Support for copying from CPU to GPU via mapped memory.
+	virtual bool Update(std::shared_ptr<Buffer> const& buffer) override;
+	virtual bool Update(std::shared_ptr<TextureSingle> const& texture) override;
+	virtual bool Update(std::shared_ptr<TextureSingle> const& texture, unsigned int level) override;
+	virtual bool Update(std::shared_ptr<TextureArray> const& textureArray) override;
+	virtual bool Update(std::shared_ptr<TextureArray> const& textureArray, unsigned int item, unsigned int level) override;
+
+	// Support for copying from CPU to GPU via staging memory.
+	virtual bool CopyCpuToGpu(std::shared_ptr<Buffer> const& buffer) override;
+	virtual bool CopyCpuToGpu(std::shared_ptr<TextureSingle> const& texture) override;
+	virtual bool CopyCpuToGpu(std::shared_ptr<TextureSingle> const& texture, unsigned int level) override;
+	virtual bool CopyCpuToGpu(std::shared_ptr<TextureArray> const& textureArray) override;
+	virtual bool CopyCpuToGpu(std::shared_ptr<TextureArray> const& textureArray, unsigned int item, unsigned int level) override;
+
+	// Support for copying from GPU to CPU via staging memory. There is no
+	// GPU copy, the system memory is left as is.
+	virtual bool CopyGpuToCpu(std::shared_ptr<Buffer> const& buffer) override;
+	virtual bool CopyGpuToCpu(std::shared_ptr<TextureSingle> const& texture) override;
+	virtual bool CopyGpuToCpu(std::shared_ptr<TextureSingle> const& texture, unsigned int level) override;
+	virtual bool CopyGpuToCpu(std::shared_ptr<TextureArray> const& textureArray) override;
+	virtual bool CopyGpuToCpu(std::shared_ptr<TextureArray> const& textureArray, unsigned int item, unsigned int level) override;
+
+	// Support for copying from GPU to GPU directly.
+	virtual void CopyGpuToGpu(
+		std::shared_ptr<Buffer> const& buffer0,
+		std::shared_ptr<Buffer> const& buffer1) override;
+	virtual void CopyGpuToGpu(
+		std::shared_ptr<TextureSingle> const& texture0,
+		std::shared_ptr<TextureSingle> const& texture1) override;
+	virtual void CopyGpuToGpu(
+		std::shared_ptr<TextureSingle> const& texture0,
+		std::shared_ptr<TextureSingle> const& texture1, unsigned int level) override;
+	virtual void CopyGpuToGpu(
+		std::shared_ptr<TextureArray> const& textureArray0,
+		std::shared_ptr<TextureArray> const& textureArray1) override;
+	virtual void CopyGpuToGpu(
+		std::shared_ptr<TextureArray> const& textureArray0,
+		std::shared_ptr<TextureArray> const& textureArray1,
+		unsigned int item, unsigned int level) override;
+
+protected:
+	// Support for drawing. No samples are drawn, the function returns 0.
+	virtual uint64_t DrawPrimitive(
+		std::shared_ptr<VertexBuffer> const& vbuffer,
+		std::shared_ptr<IndexBuffer> const& ibuffer,
+		std::shared_ptr<VisualEffect> const& effect) override;
+
+private:
+	// Count and log the bytes copied between CPU and GPU.
+	bool Upload(std::shared_ptr<Resource> const& resource, unsigned int numBytes, char const* command);
+	bool Download(std::shared_ptr<Resource> const& resource, unsigned int numBytes, char const* command);
+
+	int mViewportX, mViewportY, mViewportW, mViewportH;
+	float mDepthMin, mDepthMax;
+
+	Statistics mFrame;
+	Statistics mLastFrame;
+	Statistics mTotal;
+	unsigned int mNumFrames;
+
+	std::ofstream mCommandLog;
+};
+
+inline NullRenderer::Statistics const& NullRenderer::GetFrameStatistics() const
+{
+	return mLastFrame;
+}
+
+inline NullRenderer::Statistics const& NullRenderer::GetTotalStatistics() const
+{
+	return mTotal;
+}
+
+inline unsigned int NullRenderer::GetNumFrames() const
+{
+	return mNumFrames;
+}
+
+#endif
@@ -0,0 +1,395 @@
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+#include "NullShader.h"
+
+#include "Core/Logger/Logger.h"
+
+//----------------------------------------------------------------------------
+// Splits the source into identifiers, numbers and single punctuation
+// characters. Comments and preprocessor lines are skipped.
+static void Tokenize(std::string const& source, std::vector<std::string>& tokens)
+{
+	size_t const size = source.size();
+	size_t i = 0;
+	bool lineStart = true;
+	while (i < size)
+	{
+		char const c = source[i];
+		if (c == '\n')
+		{
+			lineStart = true;
+			++i;
+		}
+		else if (isspace(static_cast<unsigned char>(c)))
+		{
+			++i;
+		}
+		else if (c == '#' && lineStart)
+		{
+			while (i < size && source[i] != '\n')
+				++i;
+		}
+		else if (c == '/' && i + 1 < size && source[i + 1] == '/')
+		{
+			while (i < size && source[i] != '\n')
+				++i;
+		}
+		else if (c == '/' && i + 1 < size && source[i + 1] == '*')
+		{
+			size_t end = source.find("*/", i + 2);
+			i = (end == std::string::npos) ? size : end + 2;
+		}
+		else if (isalnum(static_cast<unsigned char>(c)) || c == '_')
+		{
+			size_t start = i;
+			while (i < size && (isalnum(static_cast<unsigned char>(source[i])) || source[i] == '_'))
+				++i;
+			tokens.push_back(source.substr(start, i - start));
+			lineStart = false;
+		}
+		else
+		{
+			tokens.push_back(std::string(1, c));
+			lineStart = false;
+			++i;
+		}
+	}
+}
+
+//----------------------------------------------------------------------------
+// Number of vectors and components per vector of a member type, matrices
+// being stored as one vector per column.
+static bool GetTypeShape(std::string const& type, bool glsl, unsigned int& numVectors, unsigned int& vectorSize)
+{
+	numVectors = 1;
+	vectorSize = 1;
+	if (glsl)
+	{
+		if (type == "float" || type == "int" || type == "uint" || type == "bool")
+			return true;
+
+		size_t prefix = type.find("vec");
+		if (prefix != std::string::npos && prefix <= 1 && type.size() == prefix + 4)
+		{
+			vectorSize = type.back() - '0';
+			return vectorSize >= 2 && vectorSize <= 4;
+		}
+
+		if (type.compare(0, 3, "mat") == 0 && type.size() >= 4)
+		{
+			// matC or matCxR
+			numVectors = type[3] - '0';
+			vectorSize = (type.size() == 6 && type[4] == 'x') ? type[5] - '0' : numVectors;
+			return numVectors >= 2 && numVectors <= 4 && vectorSize >= 2 && vectorSize <= 4;
+		}
+	}
+	else
+	{
+		if (type == "matrix")
+		{
+			numVectors = 4;
+			vectorSize = 4;
+			return true;
+		}
+
+		static char const* scalars[] = { "float", "int", "uint", "bool", "half", "dword" };
+		for (char const* scalar : scalars)
+		{
+			size_t length = strlen(scalar);
+			if (type.compare(0, length, scalar) != 0)
+				continue;
+
+			// scalar, scalarN or scalarRxC
+			if (type.size() == length)
+				return true;
+			if (type.size() == length + 1)
+			{
+				vectorSize = type[length] - '0';
+				return vectorSize >= 1 && vectorSize <= 4;
+			}
+			if (type.size() == length + 3 && type[length + 1] == 'x')
+			{
+				vectorSize = type[length] - '0';
+				numVectors = type[length + 2] - '0';
+				return numVectors >= 1 && numVectors <= 4 && vectorSize >= 1 && vectorSize <= 4;
+			}
+		}
+	}
+	return false;
+}
+
+//----------------------------------------------------------------------------
+NullShader::NullShader(GraphicObjectType type, std::vector<std::string> const& sources, bool glsl)
+	:
+	Shader(type),
+	mGLSL(glsl)
+{
+	for (auto const& source : sources)
+		Parse(source);
+}
+
+void NullShader::Parse(std::string const& source)
+{
+	std::vector<std::string> tokens;
+	Tokenize(source, tokens);
+
+	size_t const numTokens = tokens.size();
+	for (size_t i = 0; i < numTokens; ++i)
+	{
+		std::string const& token = tokens[i];
+		if (mGLSL)
+		{
+			if (token != "uniform" || i + 2 >= numTokens)
+				continue;
+
+			if (tokens[i + 2] == "{")
+			{
+				// uniform Name { members } [instance];
+				auto begin = tokens.begin() + i + 3;
+				auto end = std::find(begin, tokens.end(), "}");
+				AddConstantBuffer(tokens[i + 1], begin, end);
+				i = end - tokens.begin();
+			}
+			else if (tokens[i + 1].find("sampler") != std::string::npos)
+			{
+				// uniform samplerXX name;
+				AddTexture(tokens[i + 1], tokens[i + 2]);
+			}
+		}
+		else
+		{
+			if (token == "cbuffer" && i + 1 < numTokens)
+			{
+				// cbuffer Name [: register(bN)] { members };
+				auto begin = std::find(tokens.begin() + i + 1, tokens.end(), "{");
+				if (begin == tokens.end())
+					break;
+				auto end = std::find(++begin, tokens.end(), "}");
+				AddConstantBuffer(tokens[i + 1], begin, end);
+				i = end - tokens.begin();
+			}
+			else if (token.compare(0, 7, "Texture") == 0 && token != "TextureBuffer")
+			{
+				// TextureXX[<type>] name
+				size_t next = i + 1;
+				if (next < numTokens && tokens[next] == "<")
+				{
+					while (next < numTokens && tokens[next] != ">")
+						++next;
+					++next;
+				}
+				if (next < numTokens)
+					AddTexture(token, tokens[next]);
+			}
+			else if ((token == "SamplerState" || token == "SamplerComparisonState") && i + 1 < numTokens)
+			{
+				AddSampler(tokens[i + 1], GE_TEXTURE2);
+			}
+		}
+	}
+}
+
+void NullShader::AddConstantBuffer(std::string const& name,
+	std::vector<std::string>::const_iterator begin, std::vector<std::string>::const_iterator end)
+{
+	if (HasData(ConstantBuffer::mShaderDataLookup, name))
+		return;
+
+	BufferLayout layout;
+	unsigned int offset = 0;
+	while (begin != end)
+	{
+		auto declEnd = std::find(begin, end, ";");
+
+		// The member name is the last identifier before an array size or an
+		// HLSL semantic, its type the identifier before the name.
+		auto nameIt = std::find_if(begin, declEnd,
+			[](std::string const& t) { return t == "[" || t == ":"; });
+		unsigned int numElements = 0;
+		if (nameIt != declEnd && *nameIt == "[" && nameIt + 1 != declEnd)
+			numElements = static_cast<unsigned int>(atoi((nameIt + 1)->c_str()));
+		if (nameIt - begin >= 2)
+		{
+			std::string const& memberName = *(nameIt - 1);
+			std::string const& memberType = *(nameIt - 2);
+
+			unsigned int numVectors, vectorSize;
+			if (!GetTypeShape(memberType, mGLSL, numVectors, vectorSize))
+			{
+				LogWarning("Unknown type " + memberType + " of member " + memberName +
+					" in " + name + ", assuming a 4-component vector.");
+				numVectors = 1;
+				vectorSize = 4;
+			}
+
+			unsigned int const count = numElements > 0 ? numElements : 1;
+			unsigned int size;
+			if (numVectors > 1 || numElements > 0)
+			{
+				// Matrices and arrays store each vector in a 16-byte slot.
+				// HLSL does not pad the last vector.
+				offset = (offset + 15) & ~15u;
+				size = mGLSL ? 16 * numVectors * count :
+					16 * (numVectors * count - 1) + 4 * vectorSize;
+			}
+			else
+			{
+				size = 4 * vectorSize;
+				if (mGLSL)
+				{
+					// std140 aligns vec3 as vec4
+					unsigned int align = vectorSize == 1 ? 4 : (vectorSize == 2 ? 8 : 16);
+					offset = (offset + align - 1) & ~(align - 1);
+				}
+				else if ((offset & 15) + size > 16)
+				{
+					// cbuffer members do not straddle a 16-byte boundary
+					offset = (offset + 15) & ~15u;
+				}
+			}
+
+			MemberLayout item;
+			item.name = memberName;
+			item.offset = offset;
+			item.numElements = numElements;
+			layout.push_back(item);
+			offset += size;
+		}
+
+		begin = (declEnd == end) ? end : declEnd + 1;
+	}
+
+	int32_t numBytes = static_cast<int32_t>((offset + 15) & ~15u);
+	int32_t bindPoint = static_cast<int32_t>(mData[ConstantBuffer::mShaderDataLookup].size());
+	mData[ConstantBuffer::mShaderDataLookup].push_back(
+		Data(GE_CONSTANT_BUFFER, name, bindPoint, numBytes, 0, false));
+	mCBufferLayouts.push_back(layout);
+}
+
+void NullShader::AddTexture(std::string const& type, std::string const& name)
+{
+	uint32_t dims = 2;
+	if (type.find("1D") != std::string::npos)
+		dims = 1;
+	else if (type.find("3D") != std::string::npos)
+		dims = 3;
+
+	// cube maps are texture arrays of 6 items
+	bool const isArray = type.find("Array") != std::string::npos || type.find("Cube") != std::string::npos;
+	uint32_t textureType;
+	if (type.find("Cube") != std::string::npos)
+		textureType = type.find("Array") != std::string::npos ? GE_TEXTURE_CUBE_ARRAY : GE_TEXTURE_CUBE;
+	else if (isArray)
+		textureType = dims == 1 ? GE_TEXTURE1_ARRAY : GE_TEXTURE2_ARRAY;
+	else
+		textureType = dims == 1 ? GE_TEXTURE1 : (dims == 2 ? GE_TEXTURE2 : GE_TEXTURE3);
+
+	int lookup = isArray ? TextureArray::mShaderDataLookup : TextureSingle::mShaderDataLookup;
+	if (!HasData(lookup, name))
+	{
+		int32_t bindPoint = static_cast<int32_t>(mData[lookup].size());
+		mData[lookup].push_back(Data(isArray ? GE_TEXTURE_ARRAY : GE_TEXTURE_SINGLE,
+			name, bindPoint, 0, dims, false));
+	}
+
+	// a GLSL sampler is both the texture and its sampler state
+	if (mGLSL)
+		AddSampler(name, textureType);
+}
+
+void NullShader::AddSampler(std::string const& name, uint32_t textureType)
+{
+	if (HasData(SamplerState::mShaderDataLookup, name))
+		return;
+
+	int32_t bindPoint = static_cast<int32_t>(mData[SamplerState::mShaderDataLookup].size());
+	mData[SamplerState::mShaderDataLookup].push_back(
+		Data(GE_SAMPLER_STATE, name, bindPoint, 0, textureType, false));
+}
+
+bool NullShader::HasData(int lookup, std::string const& name) const
+{
+	for (auto const& data : mData[lookup])
+	{
+		if (data.name == name)
+			return true;
+	}
+	return false;
+}
+
+//----------------------------------------------------------------------------
+void NullShader::Set(std::string const& textureName,
+	std::shared_ptr<TextureSingle> const& texture,
+	std::string const& samplerName,
+	std::shared_ptr<SamplerState> const& state)
+{
+	// as GLSLShader, the sampler name is the texture name in GLSL
+	Shader::Set(mGLSL ? samplerName : textureName, texture);
+	Shader::Set(samplerName, state);
+}
+
+void NullShader::Set(std::string const& textureName,
+	std::shared_ptr<TextureArray> const& texture,
+	std::string const& samplerName,
+	std::shared_ptr<SamplerState> const& state)
+{
+	Shader::Set(mGLSL ? samplerName : textureName, texture);
+	Shader::Set(samplerName, state);
+}
+
+bool NullShader::IsValid(Data const& goal, ConstantBuffer* resource) const
+{
+	if (!resource || goal.type != GE_CONSTANT_BUFFER)
+		return false;
+
+	if (resource->GetNumBytes() < static_cast<unsigned int>(goal.numBytes))
+	{
+		LogError("Invalid number of bytes for constant buffer " + goal.name + ".");
+		return false;
+	}
+	return true;
+}
+
+bool NullShader::IsValid(Data const& goal, TextureBuffer* resource) const
+{
+	return resource && goal.type == GE_TEXTURE_BUFFER;
+}
+
+bool NullShader::IsValid(Data const& goal, StructuredBuffer* resource) const
+{
+	return resource && goal.type == GE_STRUCTURED_BUFFER;
+}
+
+bool NullShader::IsValid(Data const& goal, RawBuffer* resource) const
+{
+	return resource && goal.type == GE_RAW_BUFFER;
+}
+
+bool NullShader::IsValid(Data const& goal, TextureSingle* resource) const
+{
+	return resource && goal.type == GE_TEXTURE_SINGLE;
+}
+
+bool NullShader::IsValid(Data const& goal, TextureArray* resource) const
+{
+	return resource && goal.type == GE_TEXTURE_ARRAY;
+}
+
+bool NullShader::IsValid(Data const& goal, SamplerState* state) const
+{
+	return state && goal.type == GE_SAMPLER_STATE;
+}
@@ -0,0 +1,65 @@
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+#ifndef NULLSHADER_H
+#define NULLSHADER_H
+
+#include "Graphic/Shader/Shader.h"
+
+// Shader for the null renderer. Without a device to reflect the compiled
+// program, the uniform blocks and textures are taken from the shader sources:
+// GLSL uniform blocks and samplers, or HLSL cbuffers, textures and samplers.
+// The member layouts follow the std140 packing for GLSL and the cbuffer
+// packing for HLSL, so constant buffer members are set as on a real device.
+class GRAPHIC_ITEM NullShader : public Shader
+{
+public:
+	// The sources are all the stages of the program. Each stage gets the
+	// names of the whole program, as the GLSL reflection does for a linked
+	// program.
+	NullShader(GraphicObjectType type, std::vector<std::string> const& sources, bool glsl);
+
+	virtual void Set(std::string const& textureName,
+		std::shared_ptr<TextureSingle> const& texture,
+		std::string const& samplerName,
+		std::shared_ptr<SamplerState> const& state) override;
+
+	virtual void Set(std::string const& textureName,
+		std::shared_ptr<TextureArray> const& texture,
+		std::string const& samplerName,
+		std::shared_ptr<SamplerState> const& state) override;
+
+	virtual bool IsValid(Data const& goal, ConstantBuffer* resource) const override;
+	virtual bool IsValid(Data const& goal, TextureBuffer* resource) const override;
+	virtual bool IsValid(Data const& goal, StructuredBuffer* resource) const override;
+	virtual bool IsValid(Data const& goal, RawBuffer* resource) const override;
+	virtual bool IsValid(Data const& goal, TextureSingle* resource) const override;
+	virtual bool IsValid(Data const& goal, TextureArray* resource) const override;
+	virtual bool IsValid(Data const& goal, SamplerState* state) const override;
+
+private:
+	void Parse(std::string const& source);
+	void AddConstantBuffer(std::string const& name,
+		std::vector<std::string>::const_iterator begin, std::vector<std::string>::const_iterator end);
+	void AddTexture(std::string const& type, std::string const& name);
+	void AddSampler(std::string const& name, uint32_t textureType);
+
+	bool HasData(int lookup, std::string const& name) const;
+
+	bool mGLSL;
+};
+
+#endif
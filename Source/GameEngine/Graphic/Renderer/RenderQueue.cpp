@@ -0,0 +1,259 @@
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+
+#include "Graphic/Graphic.h"
+
+#include "RenderQueue.h"
+#include "Renderer.h"
+
+#include "Core/OS/OS.h"
+
+//----------------------------------------------------------------------------
+RenderQueue::Statistics::Statistics()
+	:
+	numVisuals(0),
+	numBindsUnsorted(0),
+	numBinds(0),
+	sortTime(0),
+	submitTime(0)
+{
+}
+//----------------------------------------------------------------------------
+RenderQueue::RenderQueue()
+	:
+	mRecording(false)
+{
+}
+//----------------------------------------------------------------------------
+void RenderQueue::Begin()
+{
+	mRecording = true;
+}
+//----------------------------------------------------------------------------
+void RenderQueue::ResetStatistics()
+{
+	mStatistics = Statistics();
+}
+//----------------------------------------------------------------------------
+uint64_t RenderQueue::Fold(uint64_t hash, unsigned int numBits)
+{
+	uint64_t folded = 0;
+	for (; hash; hash >>= numBits)
+		folded ^= hash;
+	return folded & ((1ull << numBits) - 1);
+}
+//----------------------------------------------------------------------------
+void RenderQueue::Add(std::shared_ptr<Visual> const& visual,
+	std::shared_ptr<BlendState> const& blendState,
+	std::shared_ptr<DepthStencilState> const& depthStencilState,
+	std::shared_ptr<RasterizerState> const& rasterizerState,
+	float depth, unsigned int layer, bool sortByDepth)
+{
+	if (!visual || !visual->GetEffect())
+	{
+		LogError("Null input to RenderQueue.");
+		return;
+	}
+
+	if (!mRecording)
+	{
+		Renderer::Get()->SetBlendState(blendState);
+		Renderer::Get()->SetDepthStencilState(depthStencilState);
+		Renderer::Get()->SetRasterizerState(rasterizerState);
+
+		Renderer::Get()->Draw(visual);
+
+		Renderer::Get()->SetDefaultBlendState();
+		Renderer::Get()->SetDefaultDepthStencilState();
+		Renderer::Get()->SetDefaultRasterizerState();
+		return;
+	}
+
+	auto Combine = [](uint64_t hash, void const* value)
+	{
+		return hash ^ (std::hash<void const*>()(value) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2));
+	};
+
+	Item item;
+	item.visual = visual;
+	item.blendState = blendState;
+	item.depthStencilState = depthStencilState;
+	item.rasterizerState = rasterizerState;
+	item.vbuffer = visual->GetVertexBuffer().get();
+
+	// Effects of the same class share their shader program source, even
+	// though every effect links a program of its own.
+	VisualEffect const& effect = *visual->GetEffect();
+	std::type_index effectType(typeid(effect));
+	auto effectId = std::find(mEffectTypes.begin(), mEffectTypes.end(), effectType);
+	if (effectId == mEffectTypes.end())
+		effectId = mEffectTypes.insert(mEffectTypes.end(), effectType);
+	item.effectId = std::min((unsigned int)(effectId - mEffectTypes.begin()), 0xFFFu);
+
+	uint64_t textureSet = 0;
+	if (std::shared_ptr<Shader> const& pshader = effect.GetPixelShader())
+	{
+		for (auto const& data : pshader->GetData(TextureSingle::mShaderDataLookup))
+			textureSet = Combine(textureSet, data.object.get());
+		for (auto const& data : pshader->GetData(TextureArray::mShaderDataLookup))
+			textureSet = Combine(textureSet, data.object.get());
+	}
+	item.textureSet = textureSet;
+
+	uint64_t states = Combine(Combine(Combine(0,
+		blendState.get()), depthStencilState.get()), rasterizerState.get());
+
+	// The bits of a non-negative float sort like the float.
+	float distance = std::max(depth, 0.f);
+	uint32_t depthBits;
+	std::memcpy(&depthBits, &distance, sizeof(depthBits));
+	depthBits >>= 7;
+
+	uint64_t key = (uint64_t)std::min(layer, 15u) << 60;
+	if (sortByDepth)
+	{
+		key |= (uint64_t)(0xFFFFFF - depthBits) << 36;
+	}
+	else
+	{
+		key |= (uint64_t)item.effectId << 48;
+		key |= Fold(textureSet, 14) << 34;
+		key |= Fold(states, 10) << 24;
+		key |= depthBits;
+	}
+
+	mItems.push_back(item);
+	mKeys.push_back(key);
+}
+//----------------------------------------------------------------------------
+unsigned int RenderQueue::CountBinds(std::vector<unsigned int> const& order) const
+{
+	unsigned int numBinds = 0;
+	Item const* previous = nullptr;
+	for (unsigned int index : order)
+	{
+		Item const* item = &mItems[index];
+		if (!previous || item->effectId != previous->effectId)
+			numBinds++;
+		if (!previous || item->textureSet != previous->textureSet)
+			numBinds++;
+		if (!previous || item->blendState != previous->blendState)
+			numBinds++;
+		if (!previous || item->depthStencilState != previous->depthStencilState)
+			numBinds++;
+		if (!previous || item->rasterizerState != previous->rasterizerState)
+			numBinds++;
+		if (!previous || item->vbuffer != previous->vbuffer)
+			numBinds++;
+		previous = item;
+	}
+	return numBinds;
+}
+//----------------------------------------------------------------------------
+void RenderQueue::Sort()
+{
+	unsigned int numItems = (unsigned int)mItems.size();
+	mSortKeys.resize(numItems);
+	mSortOrder.resize(numItems);
+
+	// Histograms of all the bytes in a single pass over the keys.
+	unsigned int counts[8][256] = {};
+	for (uint64_t key : mKeys)
+		for (unsigned int byte = 0; byte < 8; ++byte)
+			counts[byte][(key >> (byte * 8)) & 0xFF]++;
+
+	for (unsigned int byte = 0; byte < 8; ++byte)
+	{
+		unsigned int* count = counts[byte];
+		unsigned int shift = byte * 8;
+		if (count[(mKeys[0] >> shift) & 0xFF] == numItems)
+			continue;
+
+		unsigned int offset = 0;
+		for (unsigned int digit = 0; digit < 256; ++digit)
+		{
+			unsigned int digitCount = count[digit];
+			count[digit] = offset;
+			offset += digitCount;
+		}
+
+		for (unsigned int i = 0; i < numItems; ++i)
+		{
+			unsigned int position = count[(mKeys[i] >> shift) & 0xFF]++;
+			mSortKeys[position] = mKeys[i];
+			mSortOrder[position] = mOrder[i];
+		}
+		mKeys.swap(mSortKeys);
+		mOrder.swap(mSortOrder);
+	}
+}
+//----------------------------------------------------------------------------
+void RenderQueue::Submit()
+{
+	mRecording = false;
+	if (mItems.empty())
+		return;
+
+	mOrder.resize(mItems.size());
+	for (unsigned int i = 0; i < mOrder.size(); ++i)
+		mOrder[i] = i;
+	mStatistics.numBindsUnsorted += CountBinds(mOrder);
+
+	{
+		TimeTaker sortTime("RenderQueue sort", &mStatistics.sortTime, PRECISION_MICRO);
+		Sort();
+	}
+	mStatistics.numBinds += CountBinds(mOrder);
+	mStatistics.numVisuals += (unsigned int)mItems.size();
+
+	{
+		TimeTaker submitTime("RenderQueue submit", &mStatistics.submitTime, PRECISION_MICRO);
+
+		Renderer* renderer = Renderer::Get();
+		BlendState const* blendState = nullptr;
+		DepthStencilState const* depthStencilState = nullptr;
+		RasterizerState const* rasterizerState = nullptr;
+		for (unsigned int index : mOrder)
+		{
+			Item const& item = mItems[index];
+			if (item.blendState.get() != blendState)
+			{
+				renderer->SetBlendState(item.blendState);
+				blendState = item.blendState.get();
+			}
+			if (item.depthStencilState.get() != depthStencilState)
+			{
+				renderer->SetDepthStencilState(item.depthStencilState);
+				depthStencilState = item.depthStencilState.get();
+			}
+			if (item.rasterizerState.get() != rasterizerState)
+			{
+				renderer->SetRasterizerState(item.rasterizerState);
+				rasterizerState = item.rasterizerState.get();
+			}
+
+			renderer->Draw(item.visual);
+		}
+
+		renderer->SetDefaultBlendState();
+		renderer->SetDefaultDepthStencilState();
+		renderer->SetDefaultRasterizerState();
+	}
+
+	mItems.clear();
+	mKeys.clear();
+}
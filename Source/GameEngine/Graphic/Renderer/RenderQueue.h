@@ -0,0 +1,140 @@
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include "Graphic/Scene/Hierarchy/Visual.h"
+
+#include "Graphic/State/BlendState.h"
+#include "Graphic/State/DepthStencilState.h"
+#include "Graphic/State/RasterizerState.h"
+
+#include <typeindex>
+
+/*
+	Render queue of a scene pass. Instead of drawing each visual as it is
+	visited, the nodes add their visuals together with the states they are
+	drawn with. On Submit the visuals are sorted by a 64-bit key and drawn
+	in key order, binding a state only when it differs from the previous
+	visual's, so that visuals sharing effect, textures and states are drawn
+	back to back.
+
+	Key layout, from the most significant bit:
+		opaque:      layer(4) | effect(12) | textures(14) | states(10) | depth(24)
+		transparent: layer(4) | inverted depth(24) | 0(36)
+	Opaque visuals are grouped by effect type, texture set and state objects
+	and drawn front to back within a group. Transparent visuals are drawn
+	back to front, and in submission order when their depths are equal. The
+	effect field is a small id assigned in the order the effect classes are
+	first seen. The texture and state fields are folded hashes of the
+	texture and state pointers; a collision only interleaves two groups.
+	The keys are radix sorted.
+
+	Every scene node drawing in a pass adds its visuals to the queue. A
+	visual drawn directly during a pass would not be ordered with the queued
+	ones and break the back to front order of the transparent visuals.
+	Outside of Begin/Submit the visuals are drawn right away, so nodes
+	rendered outside of a scene pass behave as before.
+*/
+class GRAPHIC_ITEM RenderQueue
+{
+public:
+	// Construction.
+	RenderQueue();
+
+	// Counters of the submitted visuals. The binds are the changes of
+	// effect, texture set, blend, depth-stencil and rasterizer state and
+	// vertex buffer between consecutive visuals, in submission order and in
+	// the sorted order that is drawn. Times are in microseconds.
+	struct Statistics
+	{
+		Statistics();
+
+		unsigned int numVisuals;
+		unsigned int numBindsUnsorted;
+		unsigned int numBinds;
+		uint64_t sortTime;
+		uint64_t submitTime;
+	};
+
+	// Start collecting the visuals of a pass.
+	void Begin();
+	inline bool IsRecording() const;
+
+	// Add a visual drawn with the states. Layers are drawn in increasing
+	// order. Depth is the distance to the camera, sortByDepth selects the
+	// back to front order of transparent visuals.
+	void Add(std::shared_ptr<Visual> const& visual,
+		std::shared_ptr<BlendState> const& blendState,
+		std::shared_ptr<DepthStencilState> const& depthStencilState,
+		std::shared_ptr<RasterizerState> const& rasterizerState,
+		float depth = 0.f, unsigned int layer = 0, bool sortByDepth = false);
+
+	// Sort and draw the collected visuals and stop collecting. The default
+	// states are restored afterwards.
+	void Submit();
+
+	// Statistics accumulated since the last reset.
+	inline Statistics const& GetStatistics() const;
+	void ResetStatistics();
+
+private:
+	struct Item
+	{
+		std::shared_ptr<Visual> visual;
+		std::shared_ptr<BlendState> blendState;
+		std::shared_ptr<DepthStencilState> depthStencilState;
+		std::shared_ptr<RasterizerState> rasterizerState;
+		VertexBuffer const* vbuffer;
+		uint64_t textureSet;
+		unsigned int effectId;
+	};
+
+	// Fold the hash into the low bits.
+	static uint64_t Fold(uint64_t hash, unsigned int numBits);
+
+	// Changes between consecutive items when drawn in the order.
+	unsigned int CountBinds(std::vector<unsigned int> const& order) const;
+
+	// Stable LSD radix sort of mOrder by mKeys, a byte per pass. The passes
+	// where all keys share the byte are skipped.
+	void Sort();
+
+	std::vector<Item> mItems;
+	std::vector<uint64_t> mKeys, mSortKeys;
+	std::vector<unsigned int> mOrder, mSortOrder;
+
+	// There are a few effect classes, a linear search beats hashing the
+	// type names.
+	std::vector<std::type_index> mEffectTypes;
+
+	bool mRecording;
+	Statistics mStatistics;
+};
+
+inline bool RenderQueue::IsRecording() const
+{
+	return mRecording;
+}
+
+inline RenderQueue::Statistics const& RenderQueue::GetStatistics() const
+{
+	return mStatistics;
+}
+
+#endif
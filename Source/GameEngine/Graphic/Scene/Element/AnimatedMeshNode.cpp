@@ -23,8 +23,6 @@ AnimatedMeshNode::AnimatedMeshNode(const ActorId actorId, PVWUpdater* updater,
 {
 	mPVWUpdater = updater;
 
-	mRasterizerState = std::make_shared<RasterizerState>();
-
 	SetMesh(mesh);
 }
 
@@ -74,6 +72,7 @@ void AnimatedMeshNode::SetMesh(const std::shared_ptr<BaseAnimatedMesh>& mesh)
 		{
 			mBlendStates.push_back(std::make_shared<BlendState>());
 			mDepthStencilStates.push_back(std::make_shared<DepthStencilState>());
+			mRasterizerStates.push_back(std::make_shared<RasterizerState>());
 
 			std::shared_ptr<Texture2> textureDiffuse = meshBuffer->GetMaterial()->GetTexture(TT_DIFFUSE);
 			if (textureDiffuse)
@@ -413,12 +412,12 @@ void AnimatedMeshNode::Render(unsigned int& visual, bool isTransparentPass,
 						Renderer::Get()->Unbind(mBlendStates[i]);
 					if (material->Update(mDepthStencilStates[i]))
 						Renderer::Get()->Unbind(mDepthStencilStates[i]);
-					if (material->Update(mRasterizerState))
-						Renderer::Get()->Unbind(mRasterizerState);
+					if (material->Update(mRasterizerStates[i]))
+						Renderer::Get()->Unbind(mRasterizerStates[i]);
 
 					Renderer::Get()->SetBlendState(mBlendStates[i]);
 					Renderer::Get()->SetDepthStencilState(mDepthStencilStates[i]);
-					Renderer::Get()->SetRasterizerState(mRasterizerState);
+					Renderer::Get()->SetRasterizerState(mRasterizerStates[i]);
 
 					std::shared_ptr<ConstantBuffer> cbuffer;
 					Matrix4x4<float> pvMatrix = pScene->GetActiveCamera()->Get()->GetProjectionViewMatrix();
@@ -500,20 +499,12 @@ bool AnimatedMeshNode::Render(Scene* pScene)
 						Renderer::Get()->Unbind(mBlendStates[i]);
 					if (material->Update(mDepthStencilStates[i]))
 						Renderer::Get()->Unbind(mDepthStencilStates[i]);
-					if (material->Update(mRasterizerState))
-						Renderer::Get()->Unbind(mRasterizerState);
-
-					Renderer::Get()->SetBlendState(mBlendStates[i]);
-					Renderer::Get()->SetDepthStencilState(mDepthStencilStates[i]);
-					Renderer::Get()->SetRasterizerState(mRasterizerState);
-
-					Renderer* renderer = Renderer::Get();
-					renderer->Update(meshBuffer->GetVertice());
-					renderer->Draw(mVisuals[i]);
+					if (material->Update(mRasterizerStates[i]))
+						Renderer::Get()->Unbind(mRasterizerStates[i]);
 
-					Renderer::Get()->SetDefaultBlendState();
-					Renderer::Get()->SetDefaultDepthStencilState();
-					Renderer::Get()->SetDefaultRasterizerState();
+					Renderer::Get()->Update(meshBuffer->GetVertice());
+					pScene->GetRenderQueue()->Add(mVisuals[i], mBlendStates[i], mDepthStencilStates[i],
+						mRasterizerStates[i], pScene->GetCameraDepth(this), 0, transparent);
 				}
 			}
 		}
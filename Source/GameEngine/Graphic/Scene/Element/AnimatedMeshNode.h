@@ -214,7 +214,7 @@ private:
 
 	std::vector<std::shared_ptr<BlendState>> mBlendStates;
 	std::vector<std::shared_ptr<DepthStencilState>> mDepthStencilStates;
-	std::shared_ptr<RasterizerState> mRasterizerState;
+	std::vector<std::shared_ptr<RasterizerState>> mRasterizerStates;
 
 	std::vector<std::shared_ptr<Visual>> mVisuals;
 	std::shared_ptr<BaseMesh> mCurrentFrameMesh;
@@ -188,17 +188,9 @@ bool CloudSystemNode::Render(Scene *pScene)
             Renderer::Get()->Unbind(mRasterizerState);
     }
 
-    Renderer::Get()->SetBlendState(mBlendState);
-    Renderer::Get()->SetDepthStencilState(mDepthStencilState);
-    Renderer::Get()->SetRasterizerState(mRasterizerState);
-
-    Renderer* renderer = Renderer::Get();
-    renderer->Update(mVisual->GetVertexBuffer());
-    renderer->Draw(mVisual);
-
-    Renderer::Get()->SetDefaultBlendState();
-    Renderer::Get()->SetDefaultDepthStencilState();
-    Renderer::Get()->SetDefaultRasterizerState();
+    Renderer::Get()->Update(mVisual->GetVertexBuffer());
+    pScene->GetRenderQueue()->Add(mVisual, mBlendState, mDepthStencilState, mRasterizerState,
+        pScene->GetCameraDepth(this), 0, pScene->GetCurrentRenderPass() == RP_TRANSPARENT);
 
     return Node::Render(pScene);
 }
@@ -16,8 +16,6 @@ MeshNode::MeshNode(const ActorId actorId, PVWUpdater* updater, const std::shared
 {
 	mPVWUpdater = updater;
 
-	mRasterizerState = std::make_shared<RasterizerState>();
-
 	SetMesh(mesh);
 }
 
@@ -49,6 +47,7 @@ void MeshNode::SetMesh(const std::shared_ptr<BaseMesh>& mesh)
 		{
 			mBlendStates.push_back(std::make_shared<BlendState>());
 			mDepthStencilStates.push_back(std::make_shared<DepthStencilState>());
+			mRasterizerStates.push_back(std::make_shared<RasterizerState>());
 
 			std::shared_ptr<Texture2> textureDiffuse = meshBuffer->GetMaterial()->GetTexture(TT_DIFFUSE);
 			if (textureDiffuse)
@@ -175,19 +174,12 @@ bool MeshNode::Render(Scene *pScene)
 				Renderer::Get()->Unbind(mBlendStates[i]);
 			if (GetMaterial(i)->Update(mDepthStencilStates[i]))
 				Renderer::Get()->Unbind(mDepthStencilStates[i]);
-			if (GetMaterial(i)->Update(mRasterizerState))
-				Renderer::Get()->Unbind(mRasterizerState);
-
-			Renderer::Get()->SetBlendState(mBlendStates[i]);
-			Renderer::Get()->SetDepthStencilState(mDepthStencilStates[i]);
-			Renderer::Get()->SetRasterizerState(mRasterizerState);
+			if (GetMaterial(i)->Update(mRasterizerStates[i]))
+				Renderer::Get()->Unbind(mRasterizerStates[i]);
 
 			Renderer::Get()->Update(mVisuals[i]->GetVertexBuffer());
-			Renderer::Get()->Draw(mVisuals[i]);
-
-			Renderer::Get()->SetDefaultBlendState();
-			Renderer::Get()->SetDefaultDepthStencilState();
-			Renderer::Get()->SetDefaultRasterizerState();
+			pScene->GetRenderQueue()->Add(mVisuals[i], mBlendStates[i], mDepthStencilStates[i],
+				mRasterizerStates[i], pScene->GetCameraDepth(this), 0, transparent);
 		}
 	}
 
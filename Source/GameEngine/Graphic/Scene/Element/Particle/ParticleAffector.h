@@ -7,6 +7,11 @@
 
 #include "Graphic/Effect/Particle.h"
 
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define PARTICLE_SSE2
+#endif
+
 //! Types of built in particle affectors
 enum GRAPHIC_ITEM ParticleAffectorType
 {
@@ -35,6 +40,23 @@ public:
 	\param count Amount of particles in array. */
 	virtual void Affect(unsigned int now, Particle* particlearray, unsigned int count) = 0;
 
+	//! Affects the particles of a particle system.
+	/** The built in affectors work on the arrays directly, others get the
+	particles copied into a Particle array for Affect() and back.
+	\param now Current time. (Same as ITimer::getTime() would return)
+	\param particles Particles of the system. */
+	virtual void AffectArray(unsigned int now, ParticleArray& particles)
+	{
+		std::vector<Particle> particlearray(particles.Size());
+		for (unsigned int i = 0; i < particles.Size(); ++i)
+			particlearray[i] = particles.Get(i);
+
+		Affect(now, particlearray.data(), particles.Size());
+
+		for (unsigned int i = 0; i < particles.Size(); ++i)
+			particles.Set(i, particlearray[i]);
+	}
+
 	//! Sets whether or not the affector is currently enabled.
 	virtual void SetEnabled(bool enabled) { mEnabled = enabled; }
 
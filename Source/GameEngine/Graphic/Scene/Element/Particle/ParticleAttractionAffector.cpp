@@ -47,4 +47,91 @@ void ParticleAttractionAffector::Affect(unsigned int now, Particle* particlearra
 		if( mAffectZ )
 			particlearray[i].mPosition[2] += direction[2];
 	}
+}
+
+void ParticleAttractionAffector::AffectArray(unsigned int now, ParticleArray& particles)
+{
+	if( mLastTime == 0 )
+	{
+		mLastTime = now;
+		return;
+	}
+
+	float timeDelta = ( now - mLastTime ) / 1000.0f;
+	mLastTime = now;
+
+	if( !mEnabled )
+		return;
+
+	const float step = mSpeed * timeDelta;
+	const unsigned int count = particles.Size();
+	unsigned int i = 0;
+
+#if defined(PARTICLE_SSE2)
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 speed = _mm_set1_ps(step);
+	const __m128 pointX = _mm_set1_ps(mPoint[0]);
+	const __m128 pointY = _mm_set1_ps(mPoint[1]);
+	const __m128 pointZ = _mm_set1_ps(mPoint[2]);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 positionX = _mm_loadu_ps(&particles.mPositionX[i]);
+		__m128 positionY = _mm_loadu_ps(&particles.mPositionY[i]);
+		__m128 positionZ = _mm_loadu_ps(&particles.mPositionZ[i]);
+		__m128 directionX = _mm_sub_ps(pointX, positionX);
+		__m128 directionY = _mm_sub_ps(pointY, positionY);
+		__m128 directionZ = _mm_sub_ps(pointZ, positionZ);
+
+		// Normalize, a zero length direction stays zero
+		const __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(directionX, directionX), _mm_mul_ps(directionY, directionY)),
+			_mm_mul_ps(directionZ, directionZ)));
+		const __m128 valid = _mm_cmpgt_ps(length, zero);
+		directionX = _mm_mul_ps(_mm_and_ps(valid, _mm_div_ps(directionX, length)), speed);
+		directionY = _mm_mul_ps(_mm_and_ps(valid, _mm_div_ps(directionY, length)), speed);
+		directionZ = _mm_mul_ps(_mm_and_ps(valid, _mm_div_ps(directionZ, length)), speed);
+
+		if( mAttract )
+		{
+			positionX = _mm_add_ps(positionX, directionX);
+			positionY = _mm_add_ps(positionY, directionY);
+			positionZ = _mm_add_ps(positionZ, directionZ);
+		}
+		else
+		{
+			positionX = _mm_sub_ps(positionX, directionX);
+			positionY = _mm_sub_ps(positionY, directionY);
+			positionZ = _mm_sub_ps(positionZ, directionZ);
+		}
+
+		if( mAffectX )
+			_mm_storeu_ps(&particles.mPositionX[i], positionX);
+
+		if( mAffectY )
+			_mm_storeu_ps(&particles.mPositionY[i], positionY);
+
+		if( mAffectZ )
+			_mm_storeu_ps(&particles.mPositionZ[i], positionZ);
+	}
+#endif
+
+	for(; i<count; ++i)
+	{
+		Vector3<float> direction{ mPoint[0] - particles.mPositionX[i],
+			mPoint[1] - particles.mPositionY[i], mPoint[2] - particles.mPositionZ[i] };
+		Normalize(direction);
+		direction *= step;
+
+		if( !mAttract )
+			direction *= -1.0f;
+
+		if( mAffectX )
+			particles.mPositionX[i] += direction[0];
+
+		if( mAffectY )
+			particles.mPositionY[i] += direction[1];
+
+		if( mAffectZ )
+			particles.mPositionZ[i] += direction[2];
+	}
 }
\ No newline at end of file
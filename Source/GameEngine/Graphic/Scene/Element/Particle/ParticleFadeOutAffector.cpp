@@ -32,4 +32,64 @@ void ParticleFadeOutAffector::Affect(unsigned int now, Particle* particlearray,
                 Function<float>::Lerp(particlearray[i].mStartColor.ToArray(), mTargetColor.ToArray(), d));
 		}
 	}
+}
+
+//! Affects the particles of a particle system.
+void ParticleFadeOutAffector::AffectArray(unsigned int now, ParticleArray& particles)
+{
+	if (!mEnabled)
+		return;
+
+	const std::array<float, 4U> target = mTargetColor.ToArray();
+	const unsigned int count = particles.Size();
+	unsigned int i = 0;
+
+#if defined(PARTICLE_SSE2)
+	// A particle past its end time has a negative remaining time here, it
+	// wraps around to a huge value in Affect() and is not faded either.
+	const __m128i nowTime = _mm_set1_epi32((int)now);
+	const __m128 fadeOutTime = _mm_set1_ps(mFadeOutTime);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 targetR = _mm_set1_ps(target[0]);
+	const __m128 targetG = _mm_set1_ps(target[1]);
+	const __m128 targetB = _mm_set1_ps(target[2]);
+	const __m128 targetA = _mm_set1_ps(target[3]);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i left = _mm_sub_epi32(
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(&particles.mEndTime[i])), nowTime);
+		const __m128 leftTime = _mm_cvtepi32_ps(left);
+		const __m128 fading = _mm_and_ps(_mm_cmplt_ps(leftTime, fadeOutTime),
+			_mm_castsi128_ps(_mm_cmpgt_epi32(left, _mm_set1_epi32(-1))));
+		if (!_mm_movemask_ps(fading))
+			continue;
+
+		const __m128 d = _mm_div_ps(leftTime, fadeOutTime);
+		const __m128 inv = _mm_sub_ps(one, d);
+
+		float* colors[4] = { &particles.mColorR[i], &particles.mColorG[i], &particles.mColorB[i], &particles.mColorA[i] };
+		const float* startColors[4] = {
+			&particles.mStartColorR[i], &particles.mStartColorG[i], &particles.mStartColorB[i], &particles.mStartColorA[i] };
+		const __m128 targets[4] = { targetR, targetG, targetB, targetA };
+		for (int c = 0; c < 4; ++c)
+		{
+			__m128 faded = _mm_add_ps(_mm_mul_ps(targets[c], inv), _mm_mul_ps(_mm_loadu_ps(startColors[c]), d));
+			__m128 color = _mm_or_ps(_mm_and_ps(fading, faded), _mm_andnot_ps(fading, _mm_loadu_ps(colors[c])));
+			_mm_storeu_ps(colors[c], color);
+		}
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		if (particles.mEndTime[i] - now < mFadeOutTime)
+		{
+			const float d = (particles.mEndTime[i] - now) / mFadeOutTime;
+			const float inv = 1.0f - d;
+			particles.mColorR[i] = target[0] * inv + particles.mStartColorR[i] * d;
+			particles.mColorG[i] = target[1] * inv + particles.mStartColorG[i] * d;
+			particles.mColorB[i] = target[2] * inv + particles.mStartColorB[i] * d;
+			particles.mColorA[i] = target[3] * inv + particles.mStartColorA[i] * d;
+		}
+	}
 }
\ No newline at end of file
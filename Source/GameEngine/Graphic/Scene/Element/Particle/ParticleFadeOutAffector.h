@@ -17,6 +17,9 @@ public:
 	//! Affects a particle.
 	virtual void Affect(unsigned int now, Particle* particlearray, unsigned int count);
 
+	//! Affects the particles of a particle system.
+	virtual void AffectArray(unsigned int now, ParticleArray& particles);
+
 	//! Sets the targetColor, i.e. the color the particles will interpolate
 	//! to over time.
 	virtual void SetTargetColor( const SColorF& targetColor ) { mTargetColor = targetColor; }
@@ -34,4 +34,56 @@ void ParticleGravityAffector::Affect(unsigned int now, Particle* particlearray,
 
 		particlearray[i].mVector = Function<float>::Lerp(particlearray[i].mStartVector, mGravity, d);
 	}
+}
+
+//! Affects the particles of a particle system.
+void ParticleGravityAffector::AffectArray(unsigned int now, ParticleArray& particles)
+{
+	if (!mEnabled)
+		return;
+
+	const unsigned int count = particles.Size();
+	unsigned int i = 0;
+
+#if defined(PARTICLE_SSE2)
+	// Same operations as Affect() four particles at a time, the ages are
+	// converted as signed values which is exact below 2^31 milliseconds.
+	const __m128i nowTime = _mm_set1_epi32((int)now);
+	const __m128 timeForceLost = _mm_set1_ps(mTimeForceLost);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 gravityX = _mm_set1_ps(mGravity[0]);
+	const __m128 gravityY = _mm_set1_ps(mGravity[1]);
+	const __m128 gravityZ = _mm_set1_ps(mGravity[2]);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i age = _mm_sub_epi32(nowTime,
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(&particles.mStartTime[i])));
+		__m128 d = _mm_div_ps(_mm_cvtepi32_ps(age), timeForceLost);
+		d = _mm_sub_ps(one, _mm_max_ps(_mm_min_ps(d, one), zero));
+		const __m128 inv = _mm_sub_ps(one, d);
+
+		_mm_storeu_ps(&particles.mVectorX[i], _mm_add_ps(_mm_mul_ps(gravityX, inv),
+			_mm_mul_ps(_mm_loadu_ps(&particles.mStartVectorX[i]), d)));
+		_mm_storeu_ps(&particles.mVectorY[i], _mm_add_ps(_mm_mul_ps(gravityY, inv),
+			_mm_mul_ps(_mm_loadu_ps(&particles.mStartVectorY[i]), d)));
+		_mm_storeu_ps(&particles.mVectorZ[i], _mm_add_ps(_mm_mul_ps(gravityZ, inv),
+			_mm_mul_ps(_mm_loadu_ps(&particles.mStartVectorZ[i]), d)));
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		float d = (now - particles.mStartTime[i]) / mTimeForceLost;
+		if (d > 1.0f)
+			d = 1.0f;
+		if (d < 0.0f)
+			d = 0.0f;
+		d = 1.0f - d;
+
+		const float inv = 1.0f - d;
+		particles.mVectorX[i] = mGravity[0] * inv + particles.mStartVectorX[i] * d;
+		particles.mVectorY[i] = mGravity[1] * inv + particles.mStartVectorY[i] * d;
+		particles.mVectorZ[i] = mGravity[2] * inv + particles.mStartVectorZ[i] * d;
+	}
 }
\ No newline at end of file
@@ -19,6 +19,9 @@ public:
 	//! Affects a particle.
 	virtual void Affect(unsigned int now, Particle* particlearray, unsigned int count);
 
+	//! Affects the particles of a particle system.
+	virtual void AffectArray(unsigned int now, ParticleArray& particles);
+
 	//! Set the time in milliseconds when the gravity force is totally
 	//! lost and the particle does not move any more.
 	virtual void SetTimeForceLost( float timeForceLost ) { mTimeForceLost = timeForceLost; }
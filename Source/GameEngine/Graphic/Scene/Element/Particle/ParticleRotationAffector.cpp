@@ -61,3 +61,79 @@ void ParticleRotationAffector::Affect(unsigned int now, Particle* particlearray,
 		}
 	}
 }
+
+void ParticleRotationAffector::AffectArray(unsigned int now, ParticleArray& particles)
+{
+	if( mLastTime == 0 )
+	{
+		mLastTime = now;
+		return;
+	}
+
+	float timeDelta = ( now - mLastTime ) / 1000.0f;
+	mLastTime = now;
+
+	if( !mEnabled )
+		return;
+
+	// Every particle gets the same rotations, so they are combined once by
+	// rotating the unit axes as Affect() rotates each particle.
+	Vector3<float> axes[3] = { Vector3<float>::Unit(0), Vector3<float>::Unit(1), Vector3<float>::Unit(2) };
+	for (Vector3<float>& axis : axes)
+	{
+		if (mSpeed[0] != 0.0f)
+		{
+			Quaternion<float> tgt = Rotation<3, float>(
+				AxisAngle<3, float>(Vector3<float>::Unit(0), timeDelta * mSpeed[0] * (float)GE_C_DEG_TO_RAD));
+			axis = HProject(Rotate(tgt, HLift(axis, 0.f)));
+		}
+
+		if (mSpeed[1] != 0.0f)
+		{
+			Quaternion<float> tgt = Rotation<3, float>(
+				AxisAngle<3, float>(-Vector3<float>::Unit(1), timeDelta * mSpeed[1] * (float)GE_C_DEG_TO_RAD));
+			axis = HProject(Rotate(tgt, HLift(axis, 0.f)));
+		}
+
+		if (mSpeed[2] != 0.0f)
+		{
+			Quaternion<float> tgt = Rotation<3, float>(
+				AxisAngle<3, float>(Vector3<float>::Unit(2), timeDelta * mSpeed[2] * (float)GE_C_DEG_TO_RAD));
+			axis = HProject(Rotate(tgt, HLift(axis, 0.f)));
+		}
+	}
+
+	const unsigned int count = particles.Size();
+	unsigned int i = 0;
+
+#if defined(PARTICLE_SSE2)
+	__m128 rotation[3][3];
+	for (int r = 0; r < 3; ++r)
+		for (int c = 0; c < 3; ++c)
+			rotation[r][c] = _mm_set1_ps(axes[c][r]);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 positionX = _mm_loadu_ps(&particles.mPositionX[i]);
+		const __m128 positionY = _mm_loadu_ps(&particles.mPositionY[i]);
+		const __m128 positionZ = _mm_loadu_ps(&particles.mPositionZ[i]);
+		float* positions[3] = { &particles.mPositionX[i], &particles.mPositionY[i], &particles.mPositionZ[i] };
+		for (int r = 0; r < 3; ++r)
+		{
+			_mm_storeu_ps(positions[r], _mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(rotation[r][0], positionX), _mm_mul_ps(rotation[r][1], positionY)),
+				_mm_mul_ps(rotation[r][2], positionZ)));
+		}
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		const float x = particles.mPositionX[i];
+		const float y = particles.mPositionY[i];
+		const float z = particles.mPositionZ[i];
+		particles.mPositionX[i] = axes[0][0] * x + axes[1][0] * y + axes[2][0] * z;
+		particles.mPositionY[i] = axes[0][1] * x + axes[1][1] * y + axes[2][1] * z;
+		particles.mPositionZ[i] = axes[0][2] * x + axes[1][2] * y + axes[2][2] * z;
+	}
+}
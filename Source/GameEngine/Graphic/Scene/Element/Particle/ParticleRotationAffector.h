@@ -20,6 +20,9 @@ public:
 	//! Affects a particle.
 	virtual void Affect(unsigned int now, Particle* particlearray, unsigned int count);
 
+	//! Affects the particles of a particle system.
+	virtual void AffectArray(unsigned int now, ParticleArray& particles);
+
 	//! Set the point that particles will attract to
 	virtual void SetPivotPoint( const Vector3<float>& point ) { mPivotPoint = point; }
 
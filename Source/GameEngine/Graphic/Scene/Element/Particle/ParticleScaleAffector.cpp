@@ -21,3 +21,35 @@ void ParticleScaleAffector::Affect (unsigned int now, Particle *particlearray, u
 	}
 }
 
+void ParticleScaleAffector::AffectArray(unsigned int now, ParticleArray& particles)
+{
+	const unsigned int count = particles.Size();
+	unsigned int i = 0;
+
+#if defined(PARTICLE_SSE2)
+	const __m128i nowTime = _mm_set1_epi32((int)now);
+	const __m128 scaleToX = _mm_set1_ps(mScaleTo[0]);
+	const __m128 scaleToY = _mm_set1_ps(mScaleTo[1]);
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128i startTime = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&particles.mStartTime[i]));
+		const __m128i endTime = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&particles.mEndTime[i]));
+		const __m128 newscale = _mm_div_ps(_mm_cvtepi32_ps(_mm_sub_epi32(nowTime, startTime)),
+			_mm_cvtepi32_ps(_mm_sub_epi32(endTime, startTime)));
+		_mm_storeu_ps(&particles.mSizeX[i],
+			_mm_add_ps(_mm_loadu_ps(&particles.mStartSizeX[i]), _mm_mul_ps(scaleToX, newscale)));
+		_mm_storeu_ps(&particles.mSizeY[i],
+			_mm_add_ps(_mm_loadu_ps(&particles.mStartSizeY[i]), _mm_mul_ps(scaleToY, newscale)));
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		const unsigned int maxdiff = particles.mEndTime[i] - particles.mStartTime[i];
+		const unsigned int curdiff = now - particles.mStartTime[i];
+		const float newscale = (float)curdiff / maxdiff;
+		particles.mSizeX[i] = particles.mStartSizeX[i] + mScaleTo[0] * newscale;
+		particles.mSizeY[i] = particles.mStartSizeY[i] + mScaleTo[1] * newscale;
+	}
+}
+
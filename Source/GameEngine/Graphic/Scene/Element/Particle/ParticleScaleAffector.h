@@ -16,6 +16,9 @@ public:
 
 	virtual void Affect(unsigned int now, Particle *particlearray, unsigned int count);
 
+	//! Affects the particles of a particle system.
+	virtual void AffectArray(unsigned int now, ParticleArray& particles);
+
 	//! Get affector type
 	virtual ParticleAffectorType GetType() const { return PAT_SCALE; }
 
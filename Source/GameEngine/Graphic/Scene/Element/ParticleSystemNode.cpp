@@ -18,7 +18,7 @@
 //! constructor
 ParticleSystemNode::ParticleSystemNode(const ActorId actorId, PVWUpdater* updater, bool createDefaultEmitter)
 :	Node(actorId, NT_PARTICLE),
-	mEmitter(0), mParticleSize(Vector2<float>{5.f, 5.f}), mLastEmitTime(0),
+	mEmitter(0), mParticleSize(Vector2<float>{5.f, 5.f}), mLastEmitTime(0), mTimeDiff(0),
 	mMaxParticles(0xffff), mParticlesAreGlobal(true)
 {
 	mPVWUpdater = updater;
@@ -91,14 +91,19 @@ bool ParticleSystemNode::PreRender(Scene *pScene)
 {
 	if (IsVisible())
 	{
-		UpdateParticles(Timer::GetTime());
+		// The scene normally updates its particle systems before the traversal,
+		// see Scene::UpdateParticleSystems
+		if (mLastEmitTime != Timer::GetTime())
+		{
+			UpdateParticles(Timer::GetTime());
 
-		// reallocate arrays, if they are too small
-		ReallocateParticleBuffers();
+			// reallocate arrays, if they are too small
+			ReallocateParticleBuffers();
 
-		UpdateParticleBuffers(pScene);
+			UpdateParticleBuffers(pScene);
+		}
 
-		if (mParticles.size() != 0)
+		if (mParticles.Size() != 0)
 		{
 			int transparentCount = 0;
 			int solidCount = 0;
@@ -147,17 +152,9 @@ bool ParticleSystemNode::Render(Scene *pScene)
 			Renderer::Get()->Unbind(mRasterizerState);
 	}
 
-	Renderer::Get()->SetBlendState(mBlendState);
-	Renderer::Get()->SetDepthStencilState(mDepthStencilState);
-	Renderer::Get()->SetRasterizerState(mRasterizerState);
-
-	Renderer* renderer = Renderer::Get();
-	renderer->Update(mVisual->GetVertexBuffer());
-	renderer->Draw(mVisual);
-
-	Renderer::Get()->SetDefaultBlendState();
-	Renderer::Get()->SetDefaultDepthStencilState();
-	Renderer::Get()->SetDefaultRasterizerState();
+	Renderer::Get()->Update(mVisual->GetVertexBuffer());
+	pScene->GetRenderQueue()->Add(mVisual, mBlendState, mDepthStencilState, mRasterizerState,
+		pScene->GetCameraDepth(this), 0, pScene->GetCurrentRenderPass() == RP_TRANSPARENT);
 
 	return Node::Render(pScene);
 }
@@ -169,15 +166,25 @@ BoundingBox<float>& ParticleSystemNode::GetBoundingBox()
 }
 
 void ParticleSystemNode::UpdateParticles(unsigned int time)
+{
+	if (EmitParticles(time))
+		AnimateParticles(time);
+}
+
+bool ParticleSystemNode::EmitParticles(unsigned int time)
 {
 	if (mLastEmitTime==0)
 	{
 		mLastEmitTime = time;
-		return;
+		return false;
 	}
 
+	// already updated at this time
+	if (mLastEmitTime == time)
+		return false;
+
 	unsigned int now = time;
-	unsigned int timediff = time - mLastEmitTime;
+	mTimeDiff = time - mLastEmitTime;
 	mLastEmitTime = time;
 
 	// run emitter
@@ -185,67 +192,106 @@ void ParticleSystemNode::UpdateParticles(unsigned int time)
 	if (mEmitter)
 	{
 		Particle* array = 0;
-		int newParticles = mEmitter->Emitt(now, timediff, array);
+		int newParticles = mEmitter->Emitt(now, mTimeDiff, array);
 
 		if (newParticles && array)
 		{
-			int j = (int)mParticles.size();
+			int j = (int)mParticles.Size();
 			if (newParticles > 16250 - j)
 				newParticles = 16250 - j;
 
-			mParticles.resize(j + newParticles);
-			for (int i = j; i<j + newParticles; ++i)
+			for (int i = 0; i<newParticles; ++i)
 			{
-				mParticles[i] = array[i - j];
+				Particle particle = array[i];
 
-				Vector4<float> startVector = HLift(mParticles[i].mStartVector, 0.f);
+				Vector4<float> startVector = HLift(particle.mStartVector, 0.f);
 				GetAbsoluteTransform().GetRotation().Transformation(startVector);
-				mParticles[i].mStartVector = HProject(startVector);
+				particle.mStartVector = HProject(startVector);
 				if (mParticlesAreGlobal)
 				{
-					Vector4<float> positionVector = HLift(mParticles[i].mPosition, 0.f);
+					Vector4<float> positionVector = HLift(particle.mPosition, 0.f);
 					GetAbsoluteTransform().GetRotation().Transformation(positionVector);
                     positionVector += GetAbsoluteTransform().GetTranslationW0();
-					mParticles[i].mPosition = HProject(positionVector);
+					particle.mPosition = HProject(positionVector);
 				}
+				mParticles.Push(particle);
 			}
 		}
 	}
+	return true;
+}
+
+void ParticleSystemNode::AnimateParticles(unsigned int time)
+{
+	unsigned int now = time;
 
 	// run affectors
 	std::list<std::shared_ptr<BaseParticleAffector>>::iterator ait = mAffectorList.begin();
 	for (; ait != mAffectorList.end(); ++ait)
-		(*ait)->Affect(now, mParticles.data(), (unsigned int)mParticles.size());
+		(*ait)->AffectArray(now, mParticles);
 
-    BoundingBox<float> bBox;
-    if (mParticlesAreGlobal)
-        bBox.Reset(GetAbsoluteTransform().GetTranslation());
-    else
-        bBox.Reset(Vector3<float>::Zero());
+	// Particle order does not seem to matter.
+	// So we can delete by switching with last particle and deleting that one.
+	for (unsigned int i = 0; i<mParticles.Size();)
+	{
+		if (now > mParticles.mEndTime[i])
+			mParticles.Remove(i);
+		else
+			++i;
+	}
+
+	Vector3<float> origin = Vector3<float>::Zero();
+	if (mParticlesAreGlobal)
+		origin = GetAbsoluteTransform().GetTranslation();
+	Vector3<float> minEdge = origin;
+	Vector3<float> maxEdge = origin;
 
 	// animate all particles
-	float scale = (float)timediff;
+	float scale = (float)mTimeDiff;
 
-	for (unsigned int i=0; i<mParticles.size();)
+	float* positions[3] = { mParticles.mPositionX.data(), mParticles.mPositionY.data(), mParticles.mPositionZ.data() };
+	const float* vectors[3] = { mParticles.mVectorX.data(), mParticles.mVectorY.data(), mParticles.mVectorZ.data() };
+	const unsigned int count = mParticles.Size();
+	for (int axis = 0; axis < 3; ++axis)
 	{
-		// erase is pretty expensive!
-		if (now > mParticles[i].mEndTime)
+		float* position = positions[axis];
+		const float* vector = vectors[axis];
+		unsigned int i = 0;
+		float minValue = minEdge[axis];
+		float maxValue = maxEdge[axis];
+
+#if defined(PARTICLE_SSE2)
+		const __m128 timeScale = _mm_set1_ps(scale);
+		__m128 minValues = _mm_set1_ps(minValue);
+		__m128 maxValues = _mm_set1_ps(maxValue);
+		for (; i + 4 <= count; i += 4)
 		{
-			// Particle order does not seem to matter.
-			// So we can delete by switching with last particle and deleting that one.
-			// This is a lot faster and speed is very important here as the erase otherwise
-			// can cause noticable freezes.
-			mParticles[i] = mParticles[mParticles.size()-1];
-			mParticles.pop_back();
+			__m128 value = _mm_add_ps(_mm_loadu_ps(position + i), _mm_mul_ps(_mm_loadu_ps(vector + i), timeScale));
+			_mm_storeu_ps(position + i, value);
+			minValues = _mm_min_ps(minValues, value);
+			maxValues = _mm_max_ps(maxValues, value);
 		}
-		else
+		float lanes[4];
+		_mm_storeu_ps(lanes, minValues);
+		minValue = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+		_mm_storeu_ps(lanes, maxValues);
+		maxValue = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+#endif
+
+		for (; i < count; ++i)
 		{
-			mParticles[i].mPosition += (mParticles[i].mVector * scale);
-            bBox.GrowToContain(mParticles[i].mPosition);
-			++i;
+			position[i] += vector[i] * scale;
+			minValue = std::min(minValue, position[i]);
+			maxValue = std::max(maxValue, position[i]);
 		}
+		minEdge[axis] = minValue;
+		maxEdge[axis] = maxValue;
 	}
 
+    BoundingBox<float> bBox;
+    bBox.mMinEdge = minEdge;
+    bBox.mMaxEdge = maxEdge;
+
     const float m = (mParticleSize[0] > mParticleSize[1] ? mParticleSize[0] : mParticleSize[1]) * 0.5f;
     bBox.mMaxEdge += Vector3<float>{m, m, m};
     bBox.mMinEdge -= Vector3<float>{m, m, m};
@@ -258,13 +304,21 @@ void ParticleSystemNode::UpdateParticles(unsigned int time)
 
 void ParticleSystemNode::ReallocateParticleBuffers()
 {
-	if (mParticles.size() * 4 != mMeshBuffer->GetVertice()->GetNumElements() ||
-		mParticles.size() * 2 != mMeshBuffer->GetIndice()->GetNumPrimitives())
+	// The buffers only grow, the vertices and triangles beyond the
+	// particle count are left out of the draw with the active counts.
+	const unsigned int particles = mParticles.Size();
+	if (particles * 4 > mMeshBuffer->GetVertice()->GetNumElements() ||
+		particles * 2 > mMeshBuffer->GetIndice()->GetNumPrimitives())
 	{
+		unsigned int capacity = 64;
+		while (capacity < particles)
+			capacity *= 2;
+
 		MeshBuffer* meshBuffer = new MeshBuffer(mMeshBuffer->GetVertice()->GetFormat(),
-			(unsigned int)mParticles.size() * 4, (unsigned int)mParticles.size() * 2, sizeof(unsigned int));
+			capacity * 4, capacity * 2, sizeof(unsigned int));
 		for (unsigned int i = 0; i < GetMaterialCount(); ++i)
 			meshBuffer->GetMaterial() = GetMaterial(i);
+		meshBuffer->GetBoundingBox() = mMeshBuffer->GetBoundingBox();
 		mMeshBuffer.reset(meshBuffer);
 
 		// fill vertices
@@ -300,34 +354,44 @@ void ParticleSystemNode::UpdateParticleBuffers(Scene *pScene)
 
 	if (!cameraNode) return;
 
-	//fill vertices
-	if (mParticles.size() != 0)
+	const std::shared_ptr<VertexBuffer>& vertexBuffer = mMeshBuffer->GetVertice();
+	const unsigned int count = mParticles.Size();
+	vertexBuffer->SetNumActiveElements(count * 4);
+	mMeshBuffer->GetIndice()->SetNumActivePrimitives(count * 2);
+
+	//fill vertices, straight into the vertex buffer memory
+	if (count != 0)
 	{
-		int idx = 0;
-		for (unsigned int i = 0; i < mParticles.size(); ++i)
+		const Vector3<float> right = HProject(cameraNode->Get()->GetRVector());
+		const Vector3<float> up = HProject(cameraNode->Get()->GetUVector());
+
+		char* vertices = vertexBuffer->GetChannel(VA_POSITION, 0, std::set<DFType>());
+		char* colors = vertexBuffer->GetChannel(VA_COLOR, 0, std::set<DFType>());
+		const unsigned int vertexSize = vertexBuffer->GetFormat().GetVertexSize();
+		char* positions = vertices;
+		for (unsigned int i = 0; i < count; ++i)
 		{
-			const Particle& particle = mParticles[i];
-
-			float f = 0.5f * particle.mSize[0];
-			const Vector4<float> horizontal = cameraNode->Get()->GetRVector() * f;
-
-			f = 0.5f * particle.mSize[1];
-			const Vector4<float> vertical = cameraNode->Get()->GetUVector() * f;
-
-			mMeshBuffer->Position(0 + idx) = particle.mPosition + HProject(horizontal + vertical);
-			mMeshBuffer->Color(0, 0 + idx) = particle.mColor.ToArray();
-			mMeshBuffer->Position(1 + idx) = particle.mPosition + HProject(horizontal - vertical);
-			mMeshBuffer->Color(0, 1 + idx) = particle.mColor.ToArray();
-			mMeshBuffer->Position(2 + idx) = particle.mPosition + HProject(-horizontal - vertical);
-			mMeshBuffer->Color(0, 2 + idx) = particle.mColor.ToArray();
-			mMeshBuffer->Position(3 + idx) = particle.mPosition + HProject(-horizontal + vertical);
-			mMeshBuffer->Color(0, 3 + idx) = particle.mColor.ToArray();
-
-			idx += 4;
+			const float h = 0.5f * mParticles.mSizeX[i];
+			const float v = 0.5f * mParticles.mSizeY[i];
+			const float corners[4][2] = { { h, v }, { h, -v }, { -h, -v }, { -h, v } };
+			const float color[4] = {
+				mParticles.mColorR[i], mParticles.mColorG[i], mParticles.mColorB[i], mParticles.mColorA[i] };
+			for (int corner = 0; corner < 4; ++corner)
+			{
+				float* position = reinterpret_cast<float*>(positions);
+				position[0] = mParticles.mPositionX[i] + right[0] * corners[corner][0] + up[0] * corners[corner][1];
+				position[1] = mParticles.mPositionY[i] + right[1] * corners[corner][0] + up[1] * corners[corner][1];
+				position[2] = mParticles.mPositionZ[i] + right[2] * corners[corner][0] + up[2] * corners[corner][1];
+				memcpy(colors, color, sizeof(color));
+
+				positions += vertexSize;
+				colors += vertexSize;
+			}
 		}
-	}
 
-	mVisual->UpdateModelBound();
+		// bound the active vertices only
+		mVisual->mModelBound.ComputeFromData(count * 4, vertexSize, vertices);
+	}
 }
 
 //! Sets if the particles should be global. If it is, the particles are affected by
@@ -341,7 +405,7 @@ void ParticleSystemNode::SetParticlesAreGlobal(bool global)
 //! Remove all currently visible particles
 void ParticleSystemNode::ClearParticles()
 {
-	mParticles.clear();
+	mParticles.Clear();
 }
 
 //! Gets the particle emitter, which creates the particles.
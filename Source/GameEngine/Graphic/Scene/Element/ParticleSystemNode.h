@@ -81,6 +81,21 @@ public:
 	//! as the node will care about this otherwise automatically.
 	void UpdateParticles(unsigned int time);
 
+	//! Runs the emitter for the elapsed time. Returns false if the particles
+	//! were already updated at this time and don't need to be animated.
+	//! The emitters share the global randomizer so this is not thread safe.
+	bool EmitParticles(unsigned int time);
+
+	//! Runs the affectors, removes dead particles and moves the rest.
+	//! It only touches this node, so different nodes may animate in parallel.
+	void AnimateParticles(unsigned int time);
+
+	//! Grows the vertex and index buffers to hold the current particles.
+	void ReallocateParticleBuffers();
+
+	//! Writes the camera facing particle quads into the vertex buffer.
+	void UpdateParticleBuffers(Scene *pScene);
+
 	//! Returns type of the scene node
 	virtual NodeType GetType() const { return NT_PARTICLE; }
 
@@ -214,9 +229,6 @@ public:
 
 private:
 
-	void ReallocateParticleBuffers();
-	void UpdateParticleBuffers(Scene *pScene);
-
 	std::shared_ptr<BlendState> mBlendState;
 	std::shared_ptr<DepthStencilState> mDepthStencilState;
 	std::shared_ptr<RasterizerState> mRasterizerState;
@@ -226,9 +238,10 @@ private:
 	std::shared_ptr<VisualEffect> mEffect;
 	std::list<std::shared_ptr<BaseParticleAffector>> mAffectorList;
 	std::shared_ptr<BaseParticleEmitter> mEmitter;
-	std::vector<Particle> mParticles;
+	ParticleArray mParticles;
 	Vector2<float> mParticleSize;
 	unsigned int mLastEmitTime;
+	unsigned int mTimeDiff;
 	int mMaxParticles;
 
 	enum GRAPHIC_ITEM ParticlePrimitive
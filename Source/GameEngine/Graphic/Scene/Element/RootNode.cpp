@@ -61,6 +61,8 @@ bool RootNode::RenderChildren(Scene *pScene)
 		if (pScene->GetLightManager())
 			pScene->GetLightManager()->OnRenderPassPreRender((RenderPass)pass);
 
+		pScene->GetRenderQueue()->Begin();
+
 		// This code creates fine control of the render passes.
 		for (; itNode != end; ++itNode)
 		{
@@ -77,6 +79,9 @@ bool RootNode::RenderChildren(Scene *pScene)
 
 		}
 
+		// The visuals queued by the nodes are drawn in state order at the end of the pass
+		pScene->GetRenderQueue()->Submit();
+
 		if (pScene->GetLightManager())
 			pScene->GetLightManager()->OnRenderPassPostRender((RenderPass)pass);
 	}
@@ -16,8 +16,6 @@ StaticMeshNode::StaticMeshNode(const ActorId actorId, PVWUpdater* updater, const
 {
 	mPVWUpdater = updater;
 
-	mRasterizerState = std::make_shared<RasterizerState>();
-
 	SetMesh(mesh);
 }
 
@@ -165,6 +163,7 @@ void StaticMeshNode::SetMesh(const std::shared_ptr<BaseMesh>& mesh)
 		mMaterials.push_back(material);
 		mBlendStates.push_back(std::make_shared<BlendState>());
 		mDepthStencilStates.push_back(std::make_shared<DepthStencilState>());
+		mRasterizerStates.push_back(std::make_shared<RasterizerState>());
 
 		std::vector<std::string> path;
 #if defined(_OPENGL_)
@@ -262,6 +261,7 @@ void StaticMeshNode::SetMesh(const std::shared_ptr<BaseMesh>& mesh)
 		mMaterials.push_back(material);
 		mBlendStates.push_back(std::make_shared<BlendState>());
 		mDepthStencilStates.push_back(std::make_shared<DepthStencilState>());
+		mRasterizerStates.push_back(std::make_shared<RasterizerState>());
 
 		std::vector<std::string> path;
 #if defined(_OPENGL_)
@@ -337,6 +337,7 @@ void StaticMeshNode::SetMesh(const std::shared_ptr<BaseMesh>& mesh)
 		mMaterials.push_back(material);
 		mBlendStates.push_back(std::make_shared<BlendState>());
 		mDepthStencilStates.push_back(std::make_shared<DepthStencilState>());
+		mRasterizerStates.push_back(std::make_shared<RasterizerState>());
 
 		std::vector<std::string> path;
 #if defined(_OPENGL_)
@@ -429,18 +430,11 @@ bool StaticMeshNode::Render(Scene *pScene)
 				Renderer::Get()->Unbind(mBlendStates[i]);
 			if (mMaterials[i]->Update(mDepthStencilStates[i]))
 				Renderer::Get()->Unbind(mDepthStencilStates[i]);
-			if (mMaterials[i]->Update(mRasterizerState))
-				Renderer::Get()->Unbind(mRasterizerState);
-
-			Renderer::Get()->SetBlendState(mBlendStates[i]);
-			Renderer::Get()->SetDepthStencilState(mDepthStencilStates[i]);
-			Renderer::Get()->SetRasterizerState(mRasterizerState);
-
-			Renderer::Get()->Draw(mVisuals[i]);
+			if (mMaterials[i]->Update(mRasterizerStates[i]))
+				Renderer::Get()->Unbind(mRasterizerStates[i]);
 
-			Renderer::Get()->SetDefaultBlendState();
-			Renderer::Get()->SetDefaultDepthStencilState();
-			Renderer::Get()->SetDefaultRasterizerState();
+			pScene->GetRenderQueue()->Add(mVisuals[i], mBlendStates[i], mDepthStencilStates[i],
+				mRasterizerStates[i], pScene->GetCameraDepth(this), 0, transparent);
 		}
 	}
 
@@ -85,7 +85,7 @@ protected:
 	std::vector<std::shared_ptr<Material>> mMaterials;
 	std::vector<std::shared_ptr<BlendState>> mBlendStates;
 	std::vector<std::shared_ptr<DepthStencilState>> mDepthStencilStates;
-	std::shared_ptr<RasterizerState> mRasterizerState;
+	std::vector<std::shared_ptr<RasterizerState>> mRasterizerStates;
 
 	std::vector<std::shared_ptr<Visual>> mVisuals;
 	std::shared_ptr<BaseMesh> mMesh;
@@ -7,6 +7,8 @@
 
 #include "BoundingSphere.h"
 
+#include "Mathematic/Algebra/MatrixBatch.h"
+
 BoundingSphere::~BoundingSphere()
 {
 }
@@ -99,6 +101,17 @@ void BoundingSphere::TransformBy(Transform const& transform, BoundingSphere& sph
     sphere.SetRadius(transform.GetNorm() * GetRadius());
 }
 
+void BoundingSphere::TransformBy(Transform const& transform, int numSpheres,
+    BoundingSphere const* input, BoundingSphere* output)
+{
+    // The (center, radius) tuple is the only member, so the arrays are
+    // arrays of (c0, c1, c2, r).  The scaled radius is nonnegative, as
+    // SetRadius requires.
+    static_assert(sizeof(BoundingSphere) == sizeof(Vector4<float>),
+        "BoundingSphere must only store its tuple.");
+    BatchTransformSpheres(transform, &input->mTuple, &output->mTuple, numSpheres);
+}
+
 void BoundingSphere::ComputeFromData(int numVertices, int vertexSize, char const* data)
 {
     // The center is the average of the positions.
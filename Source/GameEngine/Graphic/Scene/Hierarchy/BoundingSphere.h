@@ -48,6 +48,12 @@ public:
     // the ellipsoid.
     void TransformBy(Transform const& transform, BoundingSphere& sphere) const;
 
+    // Transform an array of spheres by the same transform.  The results are
+    // identical to calling TransformBy on each sphere.  The arrays may be
+    // the same.
+    static void TransformBy(Transform const& transform, int numSpheres,
+        BoundingSphere const* input, BoundingSphere* output);
+
     // This function is valid only for 3-channel points (x,y,z) or 4-channel
     // vectors (x,y,z,0) or 4-channel points (x,y,z,1).  In all cases, the
     // function accesses only the (x,y,z) values.  The stride allows you to
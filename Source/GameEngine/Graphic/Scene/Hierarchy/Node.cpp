@@ -300,15 +300,20 @@ void Node::UpdateWorldData()
 
 void Node::UpdateWorldBound()
 {
-    // Start with visual bound.
+    // Start with visual bound. The model bounds are transformed by blocks.
     mWorldBound.SetCenter(Vector4<float>::Zero());
 	mWorldBound.SetRadius(0.f);
-	for (unsigned int v = 0; v < GetVisualCount(); v++)
+	BoundingSphere modelBounds[16], worldBounds[16];
+	unsigned int visualCount = (unsigned int)GetVisualCount();
+	for (unsigned int v = 0; v < visualCount; v += 16)
 	{
-		BoundingSphere worldBound;
-		BoundingSphere modelBound = GetVisual(v)->mModelBound;
-		modelBound.TransformBy(mWorldTransform, worldBound);
-		mWorldBound.GrowToContain(worldBound);
+		unsigned int count = std::min(visualCount - v, 16u);
+		for (unsigned int i = 0; i < count; i++)
+			modelBounds[i] = GetVisual(v + i)->mModelBound;
+
+		BoundingSphere::TransformBy(mWorldTransform, count, modelBounds, worldBounds);
+		for (unsigned int i = 0; i < count; i++)
+			mWorldBound.GrowToContain(worldBounds[i]);
 	}
 
     for (auto& child : mChildren)
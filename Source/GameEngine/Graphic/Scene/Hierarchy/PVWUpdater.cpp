@@ -7,6 +7,8 @@
 
 #include "PVWUpdater.h"
 
+#include "Mathematic/Algebra/MatrixBatch.h"
+
 PVWUpdater::~PVWUpdater()
 {
 }
@@ -66,19 +68,24 @@ void PVWUpdater::Update()
 {
     // The function is called knowing that mCamera is not null.
     Matrix4x4<float> pvMatrix = mCamera->GetProjectionViewMatrix();
+
+    // Compute the new projection-view-world matrices in one batch.  The
+    // matrix *element.first is the model-to-world matrix for the associated
+    // object.
+    mWorldMatrices.clear();
+    for (auto const& element : mSubscribers)
+    {
+        mWorldMatrices.push_back(*element.first);
+    }
+    mPVWMatrices.resize(mWorldMatrices.size());
+    BatchMultiply(pvMatrix, mWorldMatrices.data(), mPVWMatrices.data(), mWorldMatrices.size());
+
+    size_t index = 0;
     for (auto& element : mSubscribers)
     {
-        // Compute the new projection-view-world matrix.  The matrix
-        // *element.first is the model-to-world matrix for the associated
-        // object.
-#if defined(GE_USE_MAT_VEC)
-        Matrix4x4<float> pvwMatrix = pvMatrix * (*element.first);
-#else
-        Matrix4x4<float> pvwMatrix = (*element.first) * pvMatrix;
-#endif
         // Copy the source matrix into the system memory of the constant
         // buffer.
-        element.second.first->SetMember(element.second.second, pvwMatrix);
+        element.second.first->SetMember(element.second.second, mPVWMatrices[index++]);
 
         // Allow the caller to update GPU memory as desired.
         mBufferUpdater(element.second.first);
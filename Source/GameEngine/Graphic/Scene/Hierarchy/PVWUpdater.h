@@ -60,6 +60,10 @@ protected:
     typedef std::pair<std::shared_ptr<ConstantBuffer>, std::string> PVWValue;
 	typedef std::multimap<PVWKey, PVWValue>::iterator PVWIterator;
 	std::multimap<PVWKey, PVWValue> mSubscribers;
+
+    // Scratch arrays for the batched products, kept to avoid allocations.
+    std::vector<Matrix4x4<float>> mWorldMatrices;
+    std::vector<Matrix4x4<float>> mPVWMatrices;
 };
 
 
@@ -11,6 +11,16 @@
 #include "Graphic/Scene/Element/BoneNode.h"
 #include "Graphic/Scene/Element/AnimatedMeshNode.h"
 
+#include "Core/Threading/TaskScheduler.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define SKINNEDMESH_SSE2
+#endif
+
+// number of vertices skinned by one task
+static const unsigned int SKINNING_BLOCK_SIZE = 1024;
+
 //! constructor
 SkinnedMesh::SkinnedMesh()
 : mAnimationFrames(0.f), mFramesPerSecond(25.f), mLastAnimatedFrame(-1), 
@@ -214,30 +224,38 @@ void SkinnedMesh::BuildAllLocalAnimatedMatrices()
 	mSkinnedLastFrame=false;
 }
 
-void SkinnedMesh::BuildAllGlobalAnimatedMatrices(Joint *joint, Joint *parentJoint)
+void SkinnedMesh::BuildAllGlobalAnimatedMatrices()
 {
-	if (!joint)
-	{
-		for (unsigned int i = 0; i<mRootJoints.size(); ++i)
-			BuildAllGlobalAnimatedMatrices(mRootJoints[i], 0);
-		return;
-	}
-	else
+	// The joints are ordered parents first, so the global transform of the
+	// parent is already built when a joint is reached. The palette entry of
+	// every joint is the transform from its bind pose to its animated pose.
+	for (unsigned int i = 0; i < mSkinningJoints.size(); ++i)
 	{
-		// Find global matrix...
-		if (!parentJoint || joint->mGlobalSkinningSpace)
+		Joint* joint = mSkinningJoints[i];
+		if (mSkinningParents[i] < 0 || joint->mGlobalSkinningSpace)
 		{
 			joint->mGlobalAnimatedTransform = joint->mLocalAnimatedTransform;
 		}
 		else
 		{
 			joint->mGlobalAnimatedTransform =
-				parentJoint->mGlobalAnimatedTransform * joint->mLocalAnimatedTransform;
+				mSkinningJoints[mSkinningParents[i]]->mGlobalAnimatedTransform *
+				joint->mLocalAnimatedTransform;
 		}
-	}
 
-	for (unsigned int j = 0; j<joint->mChildren.size(); ++j)
-		BuildAllGlobalAnimatedMatrices(joint->mChildren[j], joint);
+		if (joint->mWeights.size())
+		{
+			Transform jointTransform =
+				joint->mGlobalAnimatedTransform * joint->mGlobalInversedTransform;
+			Matrix4x4<float> const& rotation = jointTransform.GetRotation();
+			Vector3<float> translation = jointTransform.GetTranslation();
+
+			Vector4<float>* entry = &mSkinningPalette[4 * i];
+			for (int r = 0; r < 3; ++r)
+				entry[r] = { rotation(r, 0), rotation(r, 1), rotation(r, 2), rotation(r, 3) };
+			entry[3] = { translation[0], translation[1], translation[2], 0.f };
+		}
+	}
 }
 
 void SkinnedMesh::GetFrameData(float frame, Joint *joint,
@@ -480,121 +498,113 @@ void SkinnedMesh::SkinMesh()
 			}
 		}
 
-		//clear skinning helper array
-		for (i=0; i<mVerticesMoved.size(); ++i)
-			for (unsigned int j=0; j<mVerticesMoved[i].size(); ++j)
-				mVerticesMoved[i][j]=false;
-
-		//skin starting with the root joints
-		for (i=0; i<mRootJoints.size(); ++i)
-			SkinJoint(mRootJoints[i], 0);
+		//every vertex is written by a single block, so the blocks of all the
+		//mesh buffers are skinned in parallel
+		ParallelFor(size_t(0), mSkinningBlocks.size(), [this](size_t block)
+		{
+			unsigned int layoutId = mSkinningBlocks[block].first;
+			unsigned int first = mSkinningBlocks[block].second;
+			unsigned int last = std::min(first + SKINNING_BLOCK_SIZE,
+				(unsigned int)mSkinningLayouts[layoutId].mVertexIds.size());
+			SkinVertices(layoutId, first, last);
+		}, 1);
+
+		for (i=0; i<mSkinningLayouts.size(); ++i)
+			mSkinningBuffers[mSkinningLayouts[i].mBufferId]->BoundingBoxNeedsRecalculated();
 	}
 
     UpdateBoundingBox();
 }
 
 
-void SkinnedMesh::SkinJoint(Joint *joint, Joint *parentJoint)
+// Blends the palette entries of the joints with the weights and moves the
+// position and the normal with the blended transform. The result has the Y
+// and Z axis swapped, as the mesh buffers expect.
+inline static void SkinVertex(const float* joints[4], const float weights[4],
+	const float* position, const float* normal, float* outPosition, float* outNormal)
 {
-	if (joint->mWeights.size())
+#if defined(SKINNEDMESH_SSE2)
+	__m128 rows[4];
+	for (int r = 0; r < 4; ++r)
 	{
-		//Find this joints pull on vertices...
-		Transform jointTransform = 
-			joint->mGlobalAnimatedTransform * joint->mGlobalInversedTransform;
-
-		float* vertexPostion = 
-			reinterpret_cast<float*>(&jointTransform.GetTranslation());
-		Matrix4x4<float> jointVertexPull = jointTransform.GetRotation();
-		float* vertexRotation = reinterpret_cast<float*>(&jointVertexPull);
-
-		Vector4<float> jointVertexMove;
-		Vector4<float> jointNormalMove;
-		Vector4<float> jointWeightNormal;
-		Vector4<float> jointWeightPosition;
-		float* vertexMove = reinterpret_cast<float*>(&jointVertexMove);
-		float* normalMove = reinterpret_cast<float*>(&jointNormalMove);
-		float* weightNormal = reinterpret_cast<float*>(&jointWeightNormal);
-		float* weightPosition = reinterpret_cast<float*>(&jointWeightPosition);
-
-		//Skin Vertices Positions and Normals...
-		for (unsigned int i=0; i<joint->mWeights.size(); ++i)
+		rows[r] = _mm_mul_ps(_mm_loadu_ps(joints[0] + 4 * r), _mm_set1_ps(weights[0]));
+		for (int k = 1; k < 4; ++k)
 		{
-			Weight& weight = joint->mWeights[i];
-			float* position = reinterpret_cast<float*>(&weight.mStaticPos);
-			weightPosition[0] = position[0];
-			weightPosition[1] = position[1];
-			weightPosition[2] = position[2];
-			weightPosition[3] = 0;
-
-			// Pull this vertex...
-			jointVertexPull.Transformation(jointWeightPosition, jointVertexMove);
-			vertexMove[0] += vertexPostion[0];
-			vertexMove[1] += vertexPostion[1];
-			vertexMove[2] += vertexPostion[2];
-
-			//swapping Y and Z axis
-			std::swap(vertexMove[2], vertexMove[1]);
-
-			if (mAnimateNormals)
-			{
-				float* normal = reinterpret_cast<float*>(&weight.mStaticNormal);
-				weightNormal[0] = normal[0];
-				weightNormal[1] = normal[1];
-				weightNormal[2] = normal[2];
-				weightNormal[3] = 0;
+			rows[r] = _mm_add_ps(rows[r],
+				_mm_mul_ps(_mm_loadu_ps(joints[k] + 4 * r), _mm_set1_ps(weights[k])));
+		}
+	}
 
-				jointVertexPull.Transformation(jointWeightNormal, jointNormalMove);
+	float move[4];
+	_mm_storeu_ps(move, _mm_add_ps(_mm_add_ps(_mm_add_ps(
+		_mm_mul_ps(_mm_set1_ps(position[0]), rows[0]),
+		_mm_mul_ps(_mm_set1_ps(position[1]), rows[1])),
+		_mm_mul_ps(_mm_set1_ps(position[2]), rows[2])), rows[3]));
+	outPosition[0] = move[0];
+	outPosition[1] = move[2];
+	outPosition[2] = move[1];
 
-				//swapping Y and Z axis
-				std::swap(normalMove[2], normalMove[1]);
-			}
+	if (outNormal)
+	{
+		_mm_storeu_ps(move, _mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(_mm_set1_ps(normal[0]), rows[0]),
+			_mm_mul_ps(_mm_set1_ps(normal[1]), rows[1])),
+			_mm_mul_ps(_mm_set1_ps(normal[2]), rows[2])));
+		outNormal[0] = move[0];
+		outNormal[1] = move[2];
+		outNormal[2] = move[1];
+	}
+#else
+	float rows[16];
+	for (int e = 0; e < 16; ++e)
+	{
+		rows[e] = joints[0][e] * weights[0];
+		for (int k = 1; k < 4; ++k)
+			rows[e] += joints[k][e] * weights[k];
+	}
 
-			if (!*weight.mMoved)
-			{
-				*weight.mMoved = true;
+	float move[3];
+	for (int c = 0; c < 3; ++c)
+		move[c] = position[0] * rows[c] + position[1] * rows[4 + c] + position[2] * rows[8 + c] + rows[12 + c];
+	outPosition[0] = move[0];
+	outPosition[1] = move[2];
+	outPosition[2] = move[1];
 
-				float* target = reinterpret_cast<float*>(
-					&mSkinningBuffers[weight.mBufferId]->Position(weight.mVertexId));
-				target[0] = vertexMove[0] * weight.mStrength;
-				target[1] = vertexMove[1] * weight.mStrength;
-				target[2] = vertexMove[2] * weight.mStrength;
+	if (outNormal)
+	{
+		for (int c = 0; c < 3; ++c)
+			move[c] = normal[0] * rows[c] + normal[1] * rows[4 + c] + normal[2] * rows[8 + c];
+		outNormal[0] = move[0];
+		outNormal[1] = move[2];
+		outNormal[2] = move[1];
+	}
+#endif
+}
 
-				if (mAnimateNormals)
-				{
-					target = reinterpret_cast<float*>(
-						&mSkinningBuffers[weight.mBufferId]->Normal(weight.mVertexId));
-					target[0] = normalMove[0] * weight.mStrength;
-					target[1] = normalMove[1] * weight.mStrength;
-					target[2] = normalMove[2] * weight.mStrength;
-				}
-				//*(weight.mPos) = thisVertexMove * weight.mStrength;
-			}
-			else
-			{
-				float* target = reinterpret_cast<float*>(
-					&mSkinningBuffers[weight.mBufferId]->Position(weight.mVertexId));
-				target[0] += vertexMove[0] * weight.mStrength;
-				target[1] += vertexMove[1] * weight.mStrength;
-				target[2] += vertexMove[2] * weight.mStrength;
 
-				if (mAnimateNormals)
-				{
-					target = reinterpret_cast<float*>(
-						&mSkinningBuffers[weight.mBufferId]->Normal(weight.mVertexId));
-					target[0] += normalMove[0] * weight.mStrength;
-					target[1] += normalMove[1] * weight.mStrength;
-					target[2] += normalMove[2] * weight.mStrength;
-				}
-				//*(weight.mPos) += thisVertexMove * weight.mStrength;
-			}
+void SkinnedMesh::SkinVertices(unsigned int layoutId, unsigned int first, unsigned int last)
+{
+	const SkinningLayout& layout = mSkinningLayouts[layoutId];
+	SkinMeshBuffer* buffer = mSkinningBuffers[layout.mBufferId];
+	const float* palette = reinterpret_cast<const float*>(mSkinningPalette.data());
 
-            mSkinningBuffers[weight.mBufferId]->BoundingBoxNeedsRecalculated();
+	const float* joints[4];
+	float weights[4];
+	for (unsigned int v = first; v < last; ++v)
+	{
+		for (int k = 0; k < 4; ++k)
+		{
+			joints[k] = palette + 16 * layout.mJoints[k][v];
+			weights[k] = layout.mWeights[k][v];
 		}
-	}
 
-	//Skin all children
-	for (unsigned int j=0; j<joint->mChildren.size(); ++j)
-		SkinJoint(joint->mChildren[j], joint);
+		unsigned int vertexId = layout.mVertexIds[v];
+		SkinVertex(joints, weights,
+			reinterpret_cast<const float*>(&layout.mStaticPositions[v]),
+			reinterpret_cast<const float*>(&layout.mStaticNormals[v]),
+			reinterpret_cast<float*>(&buffer->Position(vertexId)),
+			mAnimateNormals ? reinterpret_cast<float*>(&buffer->Normal(vertexId)) : nullptr);
+	}
 }
 
 
@@ -878,12 +888,6 @@ void SkinnedMesh::CheckForAnimation()
 			}
 		}
 
-		//An array used in skinning
-
-		for (i=0; i<mVerticesMoved.size(); ++i)
-			for (j=0; j<mVerticesMoved[i].size(); ++j)
-				mVerticesMoved[i][j] = false;
-
 		// For skinning: cache weight values for speed
 
 		for (i=0; i<mAllJoints.size(); ++i)
@@ -893,7 +897,6 @@ void SkinnedMesh::CheckForAnimation()
 			{
 				const unsigned int bufferId=joint->mWeights[j].mBufferId;
 				const unsigned int vertexId=joint->mWeights[j].mVertexId;
-				joint->mWeights[j].mMoved = &mVerticesMoved[bufferId][vertexId];
 
 				Vector3<float>& position = mLocalBuffers[bufferId]->Position(vertexId);
 				Vector3<float>& normal = mLocalBuffers[bufferId]->Normal(vertexId);
@@ -906,6 +909,8 @@ void SkinnedMesh::CheckForAnimation()
 
 		// normalize weights
 		NormalizeWeights();
+
+		BuildSkinningLayouts();
 	}
 	mSkinnedLastFrame=false;
 }
@@ -941,10 +946,7 @@ void SkinnedMesh::Finalize()
 	for(i=0; i < mAllJoints.size(); ++i)
 		mAllJoints[i]->mUseAnimationFrom=mAllJoints[i];
 
-	//Set array sizes...
-
-	for (i=0; i<mLocalBuffers.size(); ++i)
-		mVerticesMoved.push_back(std::map<int, bool>());
+	BuildSkinningJoints();
 
 	//Todo: optimise keys here...
 
@@ -1275,6 +1277,122 @@ void SkinnedMesh::NormalizeWeights()
 }
 
 
+void SkinnedMesh::BuildSkinningJoints()
+{
+	// depth first from the root joints, the same joints the recursive
+	// traversal used to reach
+	mSkinningJoints.clear();
+	mSkinningParents.clear();
+	std::vector<std::pair<Joint*, int>> stack;
+	for (unsigned int i = (unsigned int)mRootJoints.size(); i-- > 0;)
+		stack.push_back({ mRootJoints[i], -1 });
+
+	while (!stack.empty())
+	{
+		Joint* joint = stack.back().first;
+		int parent = stack.back().second;
+		stack.pop_back();
+
+		int index = (int)mSkinningJoints.size();
+		mSkinningJoints.push_back(joint);
+		mSkinningParents.push_back(parent);
+		for (unsigned int j = (unsigned int)joint->mChildren.size(); j-- > 0;)
+			stack.push_back({ joint->mChildren[j], index });
+	}
+	mSkinningPalette.resize(4 * mSkinningJoints.size());
+}
+
+
+void SkinnedMesh::BuildSkinningLayouts()
+{
+	struct Influence
+	{
+		unsigned short mJoint;
+		float mWeight;
+		Vector3<float> mStaticPos;
+		Vector3<float> mStaticNormal;
+	};
+
+	// gather the weights per vertex
+	std::vector<std::vector<std::vector<Influence>>> influences(mLocalBuffers.size());
+	for (unsigned int i = 0; i < mLocalBuffers.size(); ++i)
+		influences[i].resize(mLocalBuffers[i]->GetVertice()->GetNumElements());
+
+	for (unsigned int i = 0; i < mSkinningJoints.size(); ++i)
+	{
+		for (Weight const& weight : mSkinningJoints[i]->mWeights)
+		{
+			Influence influence = { (unsigned short)i, weight.mStrength,
+				weight.mStaticPos, weight.mStaticNormal };
+			influences[weight.mBufferId][weight.mVertexId].push_back(influence);
+		}
+	}
+
+	bool truncated = false;
+	mSkinningLayouts.clear();
+	mSkinningBlocks.clear();
+	for (unsigned int i = 0; i < influences.size(); ++i)
+	{
+		SkinningLayout layout;
+		layout.mBufferId = i;
+		for (unsigned int v = 0; v < influences[i].size(); ++v)
+		{
+			std::vector<Influence>& vertex = influences[i][v];
+			if (vertex.empty())
+				continue;
+
+			// keep the 4 strongest influences, scaled to the same total weight
+			float total = 0.f;
+			for (Influence const& influence : vertex)
+				total += influence.mWeight;
+			if (vertex.size() > 4)
+			{
+				truncated = true;
+				std::partial_sort(vertex.begin(), vertex.begin() + 4, vertex.end(),
+					[](Influence const& a, Influence const& b) { return a.mWeight > b.mWeight; });
+				vertex.resize(4);
+
+				float kept = 0.f;
+				for (Influence const& influence : vertex)
+					kept += influence.mWeight;
+				if (kept > 0.f)
+				{
+					for (Influence& influence : vertex)
+						influence.mWeight *= total / kept;
+				}
+				else
+				{
+					// the strongest influences carry no weight, bind the vertex to the first one
+					for (Influence& influence : vertex)
+						influence.mWeight = 0.f;
+					vertex[0].mWeight = 1.f;
+				}
+			}
+
+			layout.mVertexIds.push_back(v);
+			layout.mStaticPositions.push_back(vertex[0].mStaticPos);
+			layout.mStaticNormals.push_back(vertex[0].mStaticNormal);
+			for (unsigned int k = 0; k < 4; ++k)
+			{
+				// the unused slots repeat the first joint with no weight
+				bool used = k < vertex.size();
+				layout.mJoints[k].push_back(vertex[used ? k : 0].mJoint);
+				layout.mWeights[k].push_back(used ? vertex[k].mWeight : 0.f);
+			}
+		}
+
+		if (layout.mVertexIds.empty())
+			continue;
+
+		for (unsigned int first = 0; first < layout.mVertexIds.size(); first += SKINNING_BLOCK_SIZE)
+			mSkinningBlocks.push_back({ (unsigned int)mSkinningLayouts.size(), first });
+		mSkinningLayouts.push_back(std::move(layout));
+	}
+
+	if (truncated)
+		LogWarning("Skinned Mesh: vertices with more than 4 weights keep their 4 strongest joints");
+}
+
 void SkinnedMesh::RecoverJointsFromMesh(std::vector<std::shared_ptr<BoneNode>> &jointChildSceneNodes)
 {
 	for (unsigned int i=0; i<mAllJoints.size(); ++i)
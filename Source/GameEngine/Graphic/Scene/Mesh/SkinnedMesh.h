@@ -92,7 +92,6 @@ public:
 		private:
 			//! Internal members used by SkinnedMesh
 			friend class SkinnedMesh;
-			bool* mMoved;
 			Vector3<float> mStaticPos;
 			Vector3<float> mStaticNormal;
 	};
@@ -348,7 +347,7 @@ private:
 	void NormalizeWeights();
 
 	void BuildAllLocalAnimatedMatrices();
-	void BuildAllGlobalAnimatedMatrices(Joint *joint = 0, Joint *parentJoint = 0);
+	void BuildAllGlobalAnimatedMatrices();
 
 	void CalculateGlobalMatrices(Joint *joint, Joint *parentJoint);
 
@@ -357,7 +356,9 @@ private:
 		Vector3<float> &scale, int &scaleHint,
 		Quaternion<float> &rotation, int &rotationHint);
 
-	void SkinJoint(Joint *joint, Joint *parentJoint);
+	void BuildSkinningJoints();
+	void BuildSkinningLayouts();
+	void SkinVertices(unsigned int layoutId, unsigned int first, unsigned int last);
 
 	void CalculateTangents(Vector3<float>& normal,
 		Vector3<float>& tangent, Vector3<float>& binormal,
@@ -371,7 +372,31 @@ private:
 	std::vector<Joint*> mAllJoints;
 	std::vector<Joint*> mRootJoints;
 
-	std::vector<std::map<int, bool>> mVerticesMoved;
+	//! Joints reachable from the root joints, parents first, and the index of
+	//! their parent in this array (-1 for the root joints)
+	std::vector<Joint*> mSkinningJoints;
+	std::vector<int> mSkinningParents;
+
+	//! Skinning palette, for every skinning joint the three rotation rows and
+	//! the translation of its animated transform relative to the bind pose
+	std::vector<Vector4<float>> mSkinningPalette;
+
+	//! Vertex-major skinning data of one mesh buffer. Every skinned vertex
+	//! blends up to 4 palette entries, each attribute is stored in its own
+	//! array
+	struct SkinningLayout
+	{
+		unsigned int mBufferId;
+		std::vector<unsigned int> mVertexIds;
+		std::vector<Vector3<float>> mStaticPositions;
+		std::vector<Vector3<float>> mStaticNormals;
+		std::vector<unsigned short> mJoints[4];
+		std::vector<float> mWeights[4];
+	};
+	std::vector<SkinningLayout> mSkinningLayouts;
+
+	//! Blocks of vertices (layout id, first vertex) skinned in parallel
+	std::vector<std::pair<unsigned int, unsigned int>> mSkinningBlocks;
 
     BoundingBox<float> mBoundingBox;
 
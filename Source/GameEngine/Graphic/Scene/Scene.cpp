@@ -42,8 +42,11 @@
 #include "Element/MeshNode.h"
 #include "Element/BillboardNode.h"
 #include "Element/AnimatedMeshNode.h"
+#include "Element/CameraNode.h"
+#include "Element/ParticleSystemNode.h"
 
 #include "Core/OS/Os.h"
+#include "Core/Threading/TaskScheduler.h"
 
 #include "Core/Event/EventManager.h"
 #include "Core/Event/Event.h"
@@ -125,8 +128,12 @@ bool Scene::OnRender()
 {
 	if (mRoot && mPVWUpdater.GetCamera())
 	{
+		UpdateParticleSystems();
+
 		if (mRoot->PreRender(this)==true)
 		{
+			mRenderQueue.ResetStatistics();
+
 			mPVWUpdater.Update();
 			mCuller.ComputeVisibleSet(mPVWUpdater.GetCamera(), mRoot);
 
@@ -145,6 +152,51 @@ bool Scene::OnRender()
 	return true;
 }	
 
+//
+// Scene::UpdateParticleSystems				- not in the book
+//
+//    Updates the visible particle systems ahead of the PreRender traversal. The emitters
+//    run serially, since they share the randomizer, and the affectors, integration and
+//    vertex writes of the different systems run in parallel.
+//
+void Scene::UpdateParticleSystems()
+{
+	unsigned int time = Timer::GetTime();
+
+	std::vector<ParticleSystemNode*> particleSystems;
+	for (auto it = mParticleSystems.begin(); it != mParticleSystems.end();)
+	{
+		std::shared_ptr<ParticleSystemNode> particleSystem = it->lock();
+		if (!particleSystem)
+		{
+			it = mParticleSystems.erase(it);
+			continue;
+		}
+		++it;
+
+		bool visible = true;
+		for (Spatial* spatial = particleSystem.get(); spatial && visible; spatial = spatial->GetParent())
+			visible = spatial->IsVisible();
+
+		if (visible && particleSystem->EmitParticles(time))
+			particleSystems.push_back(particleSystem.get());
+	}
+
+	ParallelFor(size_t(0), particleSystems.size(), [time, &particleSystems](size_t i)
+	{
+		particleSystems[i]->AnimateParticles(time);
+	}, 1);
+
+	// resizing the buffers creates renderer objects, keep it on this thread
+	for (ParticleSystemNode* particleSystem : particleSystems)
+		particleSystem->ReallocateParticleBuffers();
+
+	ParallelFor(size_t(0), particleSystems.size(), [this, &particleSystems](size_t i)
+	{
+		particleSystems[i]->UpdateParticleBuffers(this);
+	}, 1);
+}
+
 //
 // Scene::OnLostDevice						- not in the book
 //
@@ -180,6 +232,20 @@ void Scene::AddToRenderQueue(RenderPass pass, const std::shared_ptr<Node>& node)
 }
 
 
+//! Depth of the node along the view direction of the active camera, the depth of its
+//! queued visuals.
+float Scene::GetCameraDepth(Node* node) const
+{
+	if (!mCamera || !node)
+		return 0.f;
+
+	Vector4<float> cameraPosition = mCamera->Get()->GetPosition();
+	Vector4<float> cameraDirection = mCamera->Get()->GetDVector();
+	return Dot(HProject(cameraDirection), 
+		node->GetAbsoluteTransform().GetTranslation() - HProject(cameraPosition));
+}
+
+
 //! clears the render list
 void Scene::ClearRenderList()
 {
@@ -377,8 +443,11 @@ std::shared_ptr<BillboardNode> Scene::AddBillboardNode(const std::shared_ptr<Nod
 std::shared_ptr<Node> Scene::AddParticleSystemNode(
 	const std::shared_ptr<Node>& parent, int id, bool withDefaultEmitter)
 {
-	std::shared_ptr<Node> node(
+	std::shared_ptr<ParticleSystemNode> particleSystem(
 		new ParticleSystemNode(id, &mPVWUpdater, withDefaultEmitter));
+	mParticleSystems.push_back(particleSystem);
+
+	std::shared_ptr<Node> node = particleSystem;
 
 	if (!parent) 
 		AddSceneNode(id, node);
@@ -45,6 +45,7 @@
 #include "Hierarchy/Light.h"
 
 #include "Graphic/ScreenElement.h"
+#include "Graphic/Renderer/RenderQueue.h"
 
 #include "Mathematic/Mathematic.h"
 #include "Core/Event/EventManager.h"
@@ -59,6 +60,7 @@ class MeshNode;
 class CameraNode;
 class BillboardNode;
 class AnimatedMeshNode;
+class ParticleSystemNode;
 class BaseDummyTransformationNode;
 
 class LightManager;
@@ -473,9 +475,19 @@ public:
 	//! Adds a scene node to the render queue.
 	void AddToRenderQueue(RenderPass renderPass, const std::shared_ptr<Node>& node);
 
+	//! Queue of the visuals drawn in the current render pass.
+	RenderQueue* GetRenderQueue() { return &mRenderQueue; }
+
+	//! Depth of the node along the view direction of the active camera, the depth of its
+	//! queued visuals.
+	float GetCameraDepth(Node* node) const;
+
 	//! clears the render list
 	void ClearRenderList();
 
+	//! Updates the particles of the visible particle systems before rendering.
+	void UpdateParticleSystems();
+
 	//! Adds a scene node to the deletion queue.
 	void AddToDeletionQueue(Node* node);
 
@@ -496,6 +508,11 @@ protected:
 	//! scene node lists
 	SceneNodeRenderList mRenderList[RP_LAST];
 
+	RenderQueue mRenderQueue;
+
+	//! particle systems created by the scene, updated together before rendering
+	std::vector<std::weak_ptr<ParticleSystemNode>> mParticleSystems;
+
 	void RemoveAll();
 	void Clear();
 
@@ -0,0 +1,292 @@
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+
+#include "MatrixBatch.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define MATRIXBATCH_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define MATRIXBATCH_NEON
+#endif
+
+// The kernels below compute out = c0*v0 + c1*v1 + c2*v2 + c3*v3 for the four
+// basis tuples c of a matrix. With row-major storage the rows are the basis of
+// a matrix-matrix product and of V*M, the columns are the basis of M*V. The
+// sum starts from zero and adds the terms in index order, which is the exact
+// sequence of operations of the scalar operators.
+
+#if defined(MATRIXBATCH_SSE2)
+
+typedef __m128 Basis[4];
+
+inline static void LoadRows(float const* m, Basis basis)
+{
+	basis[0] = _mm_loadu_ps(m + 0);
+	basis[1] = _mm_loadu_ps(m + 4);
+	basis[2] = _mm_loadu_ps(m + 8);
+	basis[3] = _mm_loadu_ps(m + 12);
+}
+
+inline static void LoadColumns(float const* m, Basis basis)
+{
+	LoadRows(m, basis);
+	_MM_TRANSPOSE4_PS(basis[0], basis[1], basis[2], basis[3]);
+}
+
+inline static __m128 Combine(Basis const basis, float v0, float v1, float v2, float v3)
+{
+	__m128 result = _mm_setzero_ps();
+	result = _mm_add_ps(result, _mm_mul_ps(basis[0], _mm_set1_ps(v0)));
+	result = _mm_add_ps(result, _mm_mul_ps(basis[1], _mm_set1_ps(v1)));
+	result = _mm_add_ps(result, _mm_mul_ps(basis[2], _mm_set1_ps(v2)));
+	result = _mm_add_ps(result, _mm_mul_ps(basis[3], _mm_set1_ps(v3)));
+	return result;
+}
+
+inline static void Store4(float* out, __m128 value)
+{
+	_mm_storeu_ps(out, value);
+}
+
+inline static void Store3(float* out, __m128 value)
+{
+	_mm_storel_pi(reinterpret_cast<__m64*>(out), value);
+	_mm_store_ss(out + 2, _mm_movehl_ps(value, value));
+}
+
+#elif defined(MATRIXBATCH_NEON)
+
+typedef float32x4_t Basis[4];
+
+inline static void LoadRows(float const* m, Basis basis)
+{
+	basis[0] = vld1q_f32(m + 0);
+	basis[1] = vld1q_f32(m + 4);
+	basis[2] = vld1q_f32(m + 8);
+	basis[3] = vld1q_f32(m + 12);
+}
+
+inline static void LoadColumns(float const* m, Basis basis)
+{
+	float32x4x4_t columns = vld4q_f32(m);
+	basis[0] = columns.val[0];
+	basis[1] = columns.val[1];
+	basis[2] = columns.val[2];
+	basis[3] = columns.val[3];
+}
+
+// vmlaq_f32 may be fused on some targets, the separate multiply and add keep
+// the rounding of the scalar path
+inline static float32x4_t Combine(Basis const basis, float v0, float v1, float v2, float v3)
+{
+	float32x4_t result = vdupq_n_f32(0.f);
+	result = vaddq_f32(result, vmulq_n_f32(basis[0], v0));
+	result = vaddq_f32(result, vmulq_n_f32(basis[1], v1));
+	result = vaddq_f32(result, vmulq_n_f32(basis[2], v2));
+	result = vaddq_f32(result, vmulq_n_f32(basis[3], v3));
+	return result;
+}
+
+inline static void Store4(float* out, float32x4_t value)
+{
+	vst1q_f32(out, value);
+}
+
+inline static void Store3(float* out, float32x4_t value)
+{
+	vst1_f32(out, vget_low_f32(value));
+	out[2] = vgetq_lane_f32(value, 2);
+}
+
+#else
+
+struct Tuple
+{
+	float v[4];
+};
+typedef Tuple Basis[4];
+
+inline static void LoadRows(float const* m, Basis basis)
+{
+	for (int r = 0; r < 4; ++r)
+		for (int c = 0; c < 4; ++c)
+			basis[r].v[c] = m[r * 4 + c];
+}
+
+inline static void LoadColumns(float const* m, Basis basis)
+{
+	for (int r = 0; r < 4; ++r)
+		for (int c = 0; c < 4; ++c)
+			basis[c].v[r] = m[r * 4 + c];
+}
+
+inline static Tuple Combine(Basis const basis, float v0, float v1, float v2, float v3)
+{
+	Tuple result;
+	for (int i = 0; i < 4; ++i)
+	{
+		result.v[i] = 0.f;
+		result.v[i] += basis[0].v[i] * v0;
+		result.v[i] += basis[1].v[i] * v1;
+		result.v[i] += basis[2].v[i] * v2;
+		result.v[i] += basis[3].v[i] * v3;
+	}
+	return result;
+}
+
+inline static void Store4(float* out, Tuple const& value)
+{
+	for (int i = 0; i < 4; ++i)
+		out[i] = value.v[i];
+}
+
+inline static void Store3(float* out, Tuple const& value)
+{
+	for (int i = 0; i < 3; ++i)
+		out[i] = value.v[i];
+}
+
+#endif
+
+// out = a*b for row-major 4x4 matrices, row r of the product is the
+// combination of the rows of b weighted by row r of a
+inline static void Multiply(float const* a, Basis const rowsB, float* out)
+{
+	for (int r = 0; r < 4; ++r)
+	{
+		float const* row = a + r * 4;
+		Store4(out + r * 4, Combine(rowsB, row[0], row[1], row[2], row[3]));
+	}
+}
+
+// the basis that applies M to a vector for the current multiplication convention
+inline static void LoadTransformBasis(Matrix4x4<float> const& M, Basis basis)
+{
+	float const* m = reinterpret_cast<float const*>(&M);
+#if defined(GE_USE_MAT_VEC)
+	LoadColumns(m, basis);
+#else
+	LoadRows(m, basis);
+#endif
+}
+
+//----------------------------------------------------------------------------
+void BatchMultiply(Matrix4x4<float> const& A, Matrix4x4<float> const* B,
+	Matrix4x4<float>* out, size_t count)
+{
+	float const* a = reinterpret_cast<float const*>(&A);
+	Basis basis;
+#if defined(GE_USE_MAT_VEC)
+	for (size_t i = 0; i < count; ++i)
+	{
+		LoadRows(reinterpret_cast<float const*>(&B[i]), basis);
+		Multiply(a, basis, reinterpret_cast<float*>(&out[i]));
+	}
+#else
+	LoadRows(a, basis);
+	for (size_t i = 0; i < count; ++i)
+		Multiply(reinterpret_cast<float const*>(&B[i]), basis, reinterpret_cast<float*>(&out[i]));
+#endif
+}
+
+//----------------------------------------------------------------------------
+void BatchMultiply(Matrix4x4<float> const* A, Matrix4x4<float> const* B,
+	Matrix4x4<float>* out, size_t count)
+{
+	Basis basis;
+	for (size_t i = 0; i < count; ++i)
+	{
+		LoadRows(reinterpret_cast<float const*>(&B[i]), basis);
+		Multiply(reinterpret_cast<float const*>(&A[i]), basis, reinterpret_cast<float*>(&out[i]));
+	}
+}
+
+//----------------------------------------------------------------------------
+void BatchTransform(Matrix4x4<float> const& M, Vector4<float> const* in,
+	Vector4<float>* out, size_t count)
+{
+	Basis basis;
+	LoadTransformBasis(M, basis);
+	for (size_t i = 0; i < count; ++i)
+	{
+		float const* v = reinterpret_cast<float const*>(&in[i]);
+		Store4(reinterpret_cast<float*>(&out[i]), Combine(basis, v[0], v[1], v[2], v[3]));
+	}
+}
+
+//----------------------------------------------------------------------------
+void BatchTransformPoints(Matrix4x4<float> const& M, Vector3<float> const* in,
+	Vector3<float>* out, size_t count)
+{
+	Basis basis;
+	LoadTransformBasis(M, basis);
+	for (size_t i = 0; i < count; ++i)
+	{
+		float const* v = reinterpret_cast<float const*>(&in[i]);
+		Store3(reinterpret_cast<float*>(&out[i]), Combine(basis, v[0], v[1], v[2], 1.f));
+	}
+}
+
+//----------------------------------------------------------------------------
+void BatchTransformVectors(Matrix4x4<float> const& M, Vector3<float> const* in,
+	Vector3<float>* out, size_t count)
+{
+	Basis basis;
+	LoadTransformBasis(M, basis);
+	for (size_t i = 0; i < count; ++i)
+	{
+		float const* v = reinterpret_cast<float const*>(&in[i]);
+		Store3(reinterpret_cast<float*>(&out[i]), Combine(basis, v[0], v[1], v[2], 0.f));
+	}
+}
+
+//----------------------------------------------------------------------------
+void BatchCompose(Transform const& A, Transform const* B,
+	Transform* out, size_t count)
+{
+	// The composition branches on the rotation-scale flags of both operands
+	// and rebuilds the cached homogeneous matrices, which is where its cost
+	// is. It stays scalar so that the flags and the factorization match
+	// operator* exactly.
+	for (size_t i = 0; i < count; ++i)
+	{
+#if defined(GE_USE_MAT_VEC)
+		out[i] = A * B[i];
+#else
+		out[i] = B[i] * A;
+#endif
+	}
+}
+
+//----------------------------------------------------------------------------
+void BatchTransformSpheres(Transform const& transform, Vector4<float> const* in,
+	Vector4<float>* out, size_t count)
+{
+	Basis basis;
+	LoadTransformBasis(transform.GetHMatrix(), basis);
+	float norm = transform.GetNorm();
+	for (size_t i = 0; i < count; ++i)
+	{
+		float const* v = reinterpret_cast<float const*>(&in[i]);
+		float* result = reinterpret_cast<float*>(&out[i]);
+		float radius = norm * v[3];
+		Store3(result, Combine(basis, v[0], v[1], v[2], 1.f));
+		result[3] = radius;
+	}
+}
@@ -0,0 +1,65 @@
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+
+#ifndef MATRIXBATCH_H
+#define MATRIXBATCH_H
+
+#include "Mathematic/Algebra/Transform.h"
+
+// Batched versions of the Matrix4x4, Vector and Transform products for the
+// loops that apply them to many elements per frame (pvw matrices, bounds,
+// skinning).  The kernels use SSE2 on x86/x64, NEON on ARM and a scalar loop
+// elsewhere.  Every output element is accumulated in the same order as the
+// scalar operators (starting from zero, no fused multiply-add), so a batch
+// result is bit-identical to the corresponding operator* result.  The input
+// and output arrays may not overlap unless they are the same array.
+
+// out[i] = A*B[i] for GE_USE_MAT_VEC and out[i] = B[i]*A for GE_USE_VEC_MAT,
+// i.e. A is applied after B[i].  This is the projection-view-world product
+// when A is the projection-view matrix and B[i] are world matrices.
+void BatchMultiply(Matrix4x4<float> const& A, Matrix4x4<float> const* B,
+    Matrix4x4<float>* out, size_t count);
+
+// out[i] = A[i]*B[i].
+void BatchMultiply(Matrix4x4<float> const* A, Matrix4x4<float> const* B,
+    Matrix4x4<float>* out, size_t count);
+
+// out[i] = M*in[i] for GE_USE_MAT_VEC and out[i] = in[i]*M for
+// GE_USE_VEC_MAT.
+void BatchTransform(Matrix4x4<float> const& M, Vector4<float> const* in,
+    Vector4<float>* out, size_t count);
+
+// The 3-tuple versions treat the inputs as points (x,y,z,1) or as vectors
+// (x,y,z,0) and return the (x,y,z) channels of the product.
+void BatchTransformPoints(Matrix4x4<float> const& M, Vector3<float> const* in,
+    Vector3<float>* out, size_t count);
+void BatchTransformVectors(Matrix4x4<float> const& M, Vector3<float> const* in,
+    Vector3<float>* out, size_t count);
+
+// out[i] = A*B[i] for GE_USE_MAT_VEC and out[i] = B[i]*A for GE_USE_VEC_MAT
+// using the Transform composition, so the rotation-scale factorization is
+// kept whenever operator* keeps it.
+void BatchCompose(Transform const& A, Transform const* B,
+    Transform* out, size_t count);
+
+// Transform spheres stored as (c0,c1,c2,r).  The center is transformed as a
+// point and the radius is scaled by transform.GetNorm(), the same as
+// BoundingSphere::TransformBy.
+void BatchTransformSpheres(Transform const& transform, Vector4<float> const* in,
+    Vector4<float>* out, size_t count);
+
+#endif
@@ -44,6 +44,9 @@
 #include "Core/OS/Os.h"
 #include "Core/Event/Event.h"
 #include "Core/Event/EventManager.h"
+#include "Core/Utility/Serialize.h"
+
+#include "Application/Settings.h"
 
 #pragma comment(lib, "Ws2_32")
 
@@ -119,6 +122,8 @@ NetSocket::NetSocket()
 	mRecvOfs = mRecvBegin = 0;
 	mInternal = 0;
 	mIsBinaryProtocol = 1;
+	mSkipLine = false;
+	mPollEvents = 0;
 }
 
 //
@@ -131,9 +136,11 @@ NetSocket::NetSocket(SOCKET new_sock, unsigned int hostIP)
 	mTimeOut = 0;
 
 	mIsBinaryProtocol = 1;
+	mSkipLine = false;
 
 	mRecvOfs = mRecvBegin = 0;
 	mInternal = 0;
+	mPollEvents = 0;
 
 	mTimeCreated = Timer::GetTime();
 
@@ -211,6 +218,9 @@ void NetSocket::Send(std::shared_ptr<BasePacket> pkt, bool clearTimeOut)
 	if (clearTimeOut)
 		mTimeOut = 0;
 
+	// the socket manager flushes the sockets which had nothing to send before
+	if (mOutList.empty() && BaseSocketManager::SocketMngr)
+		BaseSocketManager::SocketMngr->AddToOutput(this);
 	mOutList.push_back(pkt);
 }
 
@@ -223,164 +233,190 @@ void NetSocket::SetBlocking(bool blocking)
 		unsigned long val = blocking ? 0 : 1;
 		ioctlsocket(mSock, FIONBIO, &val);
 	#else
-		int val = fcntl(m_sock, F_GETFL, 0);
+		int val = fcntl(mSock, F_GETFL, 0);
 		if (blocking)
 			val &= ~(O_NONBLOCK);
 		else
 			val |= O_NONBLOCK;
 
-		fcntl(m_sock, F_SETFL, val);
+		fcntl(mSock, F_SETFL, val);
 	#endif
 }
 
 //
 // NetSocket::HandleOutput						- Chapter 19, page 670
 //
+//   The queued packets are gathered in a single send, as many as the socket takes
+//
 void NetSocket::HandleOutput() 
 {
-	int fSent = 0;
-	do 
+	while (!mOutList.empty())
 	{
-		LogAssert(!mOutList.empty(), "output is empty");
-		PacketList::iterator i = mOutList.begin();
-
-		std::shared_ptr<BasePacket> pkt = *i;
-		const char *buf = pkt->GetData();
-		int len = static_cast<int>(pkt->GetSize());
+		WSABUF buffers[MAX_SEND_BUFFERS];
+		DWORD count = 0;
+		u_long size = 0;
 
-		int rc = send(mSock, buf+mSendOfs, len-mSendOfs, 0);
-		if (rc > 0) 
-		{
-			BaseSocketManager::SocketMngr->AddToOutbound(rc);
-			mSendOfs += rc;
-			fSent = 1;
-		}
-		else if (WSAGetLastError() != WSAEWOULDBLOCK)
+		for (PacketList::iterator i = mOutList.begin(); 
+			i != mOutList.end() && count < MAX_SEND_BUFFERS; ++i, ++count)
 		{
-			HandleException();
-			fSent = 0;
+			u_long offset = count ? 0 : mSendOfs;
+			buffers[count].buf = const_cast<char*>((*i)->GetData()) + offset;
+			buffers[count].len = (*i)->GetSize() - offset;
+			size += buffers[count].len;
 		}
-		else
+
+		DWORD sent = 0;
+		if (WSASend(mSock, buffers, count, &sent, 0, NULL, NULL) == SOCKET_ERROR)
 		{
-			fSent = 0;
+			if (WSAGetLastError() != WSAEWOULDBLOCK)
+				HandleException();
+			return;
 		}
 
-		if (mSendOfs == pkt->GetSize()) 
+		BaseSocketManager::SocketMngr->AddToOutbound(sent);
+		mSendOfs += sent;
+		while (!mOutList.empty() && mSendOfs >= static_cast<int>(mOutList.front()->GetSize()))
 		{
+			mSendOfs -= static_cast<int>(mOutList.front()->GetSize());
 			mOutList.pop_front();
-			mSendOfs = 0;
 		}
 
-	} while ( fSent && !mOutList.empty() );
+		// the socket buffer is full, the rest waits for the socket to be writable
+		if (sent < size)
+			return;
+	}
+}
+
+//
+// NetSocket::CopyRecvData						- not described in the book
+//
+//   Copies the received data at the given offset from the beginning of the ring buffer
+//
+void NetSocket::CopyRecvData(char* dest, unsigned int offset, unsigned int size) const
+{
+	unsigned int begin = (mRecvBegin + offset) % RECV_BUFFER_SIZE;
+	unsigned int tail = std::min(size, RECV_BUFFER_SIZE - begin);
+	memcpy(dest, mRecvBuf + begin, tail);
+	memcpy(dest + tail, mRecvBuf, size - tail);
 }
 
 //
 // NetSocket::HandleInput						- Chapter 19, page 671
 //
+//   The receive buffer is a ring, the free space is filled with at most two buffers: up to the
+//   end of the ring and from its beginning. Packets which wrap around are copied in two parts.
+//
 void NetSocket::HandleInput() 
 {
 	bool bPktRecieved = false;
 	u_long packetSize = 0;
-	int rc = recv(mSock, mRecvBuf+mRecvBegin+mRecvOfs, RECV_BUFFER_SIZE-(mRecvBegin+mRecvOfs), 0);
 
-	char metrics[1024];
-	sprintf_s(metrics, 1024, "Incoming: %6d bytes. Begin %6d Offset %4d\n", rc, mRecvBegin, mRecvOfs);
-    LogInformation(metrics);
+	WSABUF buffers[2];
+	DWORD count = 1;
 
-	if (rc==0)
+	unsigned int end = (mRecvBegin + mRecvOfs) % RECV_BUFFER_SIZE;
+	unsigned int space = RECV_BUFFER_SIZE - mRecvOfs;
+	buffers[0].buf = mRecvBuf + end;
+	buffers[0].len = std::min(space, RECV_BUFFER_SIZE - end);
+	if (space > buffers[0].len)
 	{
+		buffers[1].buf = mRecvBuf;
+		buffers[1].len = space - buffers[0].len;
+		count = 2;
+	}
+
+	DWORD received = 0, flags = 0;
+	if (WSARecv(mSock, buffers, count, &received, &flags, NULL, NULL) == SOCKET_ERROR)
+	{
+		if (WSAGetLastError() != WSAEWOULDBLOCK)
+			mDeleteFlag = 1;
 		return;
 	}
 
-	if (rc==SOCKET_ERROR)
+	if (received == 0)
 	{
-		mDeleteFlag = 1;
+		// the connection was closed by the other side
+		HandleException();
 		return;
 	}
 
-	const int hdrSize = sizeof(u_long);
-	unsigned int newData = mRecvOfs + rc;
-	int processedData = 0;
+	BaseSocketManager::SocketMngr->AddToInbound(received);
+	mRecvOfs += received;
 
-	while (newData > hdrSize)
+	const unsigned int hdrSize = sizeof(u_long);
+	while (mRecvOfs > hdrSize)
 	{
 		// There are two types of packets at the lowest level of our design:
 		// BinaryPacket - Sends the size as a positive 4 byte integer
 		// TextPacket - Sends 0 for the size, the parser will search for a CR
 
-		packetSize = *(reinterpret_cast<u_long*>(mRecvBuf+mRecvBegin));
-		packetSize = ntohl(packetSize);
-
 		if (mIsBinaryProtocol)
 		{
-			// we don't have enough new data to grab the next packet
-			if (newData < packetSize)
-				break;
+			CopyRecvData(reinterpret_cast<char*>(&packetSize), 0, hdrSize);
+			packetSize = ntohl(packetSize);
 
-			if (packetSize > MAX_PACKET_SIZE)
+			if (packetSize > MAX_PACKET_SIZE || packetSize < hdrSize)
 			{
 				// prevent nasty buffer overruns!
 				HandleException();
 				return;
 			}
 
-			if (newData >= packetSize)
-			{
-				// we know how big the packet is...and we have the whole thing
-				//
-				//[mrmike] - a little code to aid debugging network packets here!
-				//char test[1024];
-				//memcpy(test, &m_recvBuf[m_recvBegin+hdrSize], packetSize);
-				//test[packetSize+1]='\r';
-				//test[packetSize+2]='\n';
-				//test[packetSize+3]=0;
-                //LogInformation(test);
-				std::shared_ptr<BinaryPacket> pkt(
-					new BinaryPacket(&mRecvBuf[mRecvBegin+hdrSize], packetSize-hdrSize));
-				mInList.push_back(pkt);
-				bPktRecieved = true;
-				processedData += packetSize;
-				newData -= packetSize;
-				mRecvBegin += packetSize;
-			}
+			// we don't have enough new data to grab the next packet
+			if (mRecvOfs < packetSize)
+				break;
+
+			// we know how big the packet is...and we have the whole thing
+			std::shared_ptr<BinaryPacket> pkt(new BinaryPacket(packetSize - hdrSize));
+			CopyRecvData(const_cast<char*>(pkt->GetData()) + hdrSize, hdrSize, packetSize - hdrSize);
+			mInList.push_back(pkt);
 		}
 		else
 		{
 			// the text protocol waits for a carraige return and creates a string
-			char *cr = static_cast<char *>(memchr(&mRecvBuf[mRecvBegin], 0x0a, rc));
-			if (cr)
+			packetSize = 0;
+			for (unsigned int ofs = 0; ofs < mRecvOfs && !packetSize; ++ofs)
+				if (mRecvBuf[(mRecvBegin + ofs) % RECV_BUFFER_SIZE] == 0x0a)
+					packetSize = ofs + 1;
+
+			if (mSkipLine)
 			{
-				*(cr+1) = 0;
-				std::shared_ptr<TextPacket> pkt(new TextPacket(&mRecvBuf[mRecvBegin]));
-				mInList.push_back(pkt);
-				packetSize = cr - &mRecvBuf[mRecvBegin];
-				bPktRecieved = true;
-
-				processedData += packetSize;
-				newData -= packetSize;
-				mRecvBegin += packetSize;
+				// drop the rest of the oversized line up to its end
+				unsigned int skipped = packetSize ? packetSize : mRecvOfs;
+				mRecvBegin = (mRecvBegin + skipped) % RECV_BUFFER_SIZE;
+				mRecvOfs -= skipped;
+				mSkipLine = !packetSize;
+				continue;
 			}
-		}
-	}
 
-	BaseSocketManager::SocketMngr->AddToInbound(rc);
-	mRecvOfs = newData;
+			if (!packetSize)
+			{
+				if (mRecvOfs == RECV_BUFFER_SIZE)
+				{
+					// the line can't fit in the ring, which is an error of the peer and not
+					// a closed connection
+					LogError("Text packet longer than " + std::to_string(RECV_BUFFER_SIZE) + 
+						" bytes from socket " + std::to_string(mID) + ", the line is dropped");
+					mRecvOfs = mRecvBegin = 0;
+					mSkipLine = true;
+				}
+				break;
+			}
 
-	if (bPktRecieved)
-	{
-		if (mRecvOfs == 0)
-		{
-			mRecvBegin = 0;
-		}
-		else if (mRecvBegin + mRecvOfs + MAX_PACKET_SIZE > RECV_BUFFER_SIZE)
-		{
-			// we don't want to overrun the buffer - so we copy the leftover bits 
-			// to the beginning of the recieve buffer and start over
-			int leftover = mRecvOfs;
-			memcpy(mRecvBuf, &mRecvBuf[mRecvBegin], mRecvOfs);
-			mRecvBegin = 0;
+			std::string text(packetSize, 0);
+			CopyRecvData(&text[0], 0, packetSize);
+			std::shared_ptr<TextPacket> pkt(new TextPacket(text.c_str()));
+			mInList.push_back(pkt);
 		}
-	}	
+
+		bPktRecieved = true;
+		mRecvBegin = (mRecvBegin + packetSize) % RECV_BUFFER_SIZE;
+		mRecvOfs -= packetSize;
+	}
+
+	// an empty ring restarts from the beginning so that most packets are contiguous
+	if (bPktRecieved && mRecvOfs == 0)
+		mRecvBegin = 0;
 }
 
 
@@ -403,7 +439,7 @@ void NetListenSocket::Init(int portnum)
 	int value = 1;
 
 	mSock = socket(PF_INET, SOCK_STREAM, 0);
-	LogAssert(mSock == INVALID_SOCKET, "NetListenSocket Error: Init failed to create socket handle");
+	LogAssert(mSock != INVALID_SOCKET, "NetListenSocket Error: Init failed to create socket handle");
 
 	if (setsockopt(mSock, SOL_SOCKET, SO_REUSEADDR, (char *)&value, sizeof(value))== SOCKET_ERROR) 
 	{
@@ -562,9 +598,14 @@ void BaseSocketManager::Shutdown()
 	// Get rid of all those pesky kids...
 	while (!mSockList.empty())
 	{
-		delete *mSockList.begin();
+		NetSocket *pSock = *mSockList.begin();
+		if (pSock->mSock != INVALID_SOCKET)
+			mPoller.Remove(pSock->mSock);
+		delete pSock;
 		mSockList.pop_front();
 	}
+	mSockMap.clear();
+	mOutputSockets.clear();
 
 	WSACleanup();
 }
@@ -582,6 +623,15 @@ int BaseSocketManager::AddSocket(NetSocket *socket)
 	if (mSockList.size() > mMaxOpenSockets)
 		++mMaxOpenSockets;
 
+	// the sockets never block, the poller tells when they are ready
+	if (socket->mSock != INVALID_SOCKET)
+	{
+		socket->SetBlocking(false);
+		socket->mPollEvents = SocketPoller::SP_INPUT;
+		if (!mPoller.Add(socket->mSock, socket, socket->mPollEvents))
+			LogError("Socket " + std::to_string(socket->mID) + " couldn't be added to the poller");
+	}
+
 	return socket->mID; 
 }
 
@@ -592,11 +642,37 @@ int BaseSocketManager::AddSocket(NetSocket *socket)
 //
 void BaseSocketManager::RemoveSocket(NetSocket *socket) 
 { 
+	if (socket->mSock != INVALID_SOCKET)
+		mPoller.Remove(socket->mSock);
+
+	mOutputSockets.erase(
+		std::remove(mOutputSockets.begin(), mOutputSockets.end(), socket), mOutputSockets.end());
 	mSockList.remove(socket); 
 	mSockMap.erase(socket->mID);
 	delete socket;
 }
 
+//
+// BaseSocketManager::UpdatePollEvents				- not described in the book
+//
+//   Only the sockets which couldn't send everything wait to be writable
+//
+void BaseSocketManager::UpdatePollEvents(NetSocket *socket)
+{
+	if (socket->mSock == INVALID_SOCKET)
+		return;
+
+	unsigned int pollEvents = SocketPoller::SP_INPUT;
+	if (socket->HasOutput())
+		pollEvents |= SocketPoller::SP_OUTPUT;
+
+	if (pollEvents != socket->mPollEvents)
+	{
+		socket->mPollEvents = pollEvents;
+		mPoller.Modify(socket->mSock, socket, pollEvents);
+	}
+}
+
 //
 // BaseSocketManager::FindSocket					- Chapter 19, page 679
 //
@@ -646,78 +722,55 @@ bool BaseSocketManager::Send(int sockId, std::shared_ptr<BasePacket> packet)
 //
 // BaseSocketManager::DoSelect					- Chapter 19, page 679
 //
+//   The sockets stay registered in the poller, so only the ready ones are visited. New output is
+//   sent right away and the sockets wait to be writable only when the send would block.
+//
 void BaseSocketManager::DoSelect(int pauseMicroSecs, bool handleInput) 
 {
-	timeval tv;
-	tv.tv_sec = 0;
-	tv.tv_usec = pauseMicroSecs;    // 100 microseconds is 0.1 milliseconds or .0001 seconds
-
-	fd_set inp_set, out_set, exc_set;
-	int maxdesc;
-
-	FD_ZERO(&inp_set);
-	FD_ZERO(&out_set);
-	FD_ZERO(&exc_set);
-
-	maxdesc = 0;
-
-	// set everything up for the select
-	for (SocketList::iterator i = mSockList.begin(); i != mSockList.end(); ++i)
+	// send what was queued since the last select
+	for (unsigned int i = 0; i < mOutputSockets.size(); ++i)
 	{
-		NetSocket *pSock = *i;
-		if ((pSock->mDeleteFlag&1) || pSock->mSock == INVALID_SOCKET)
-			continue;
-
-		if (handleInput)
-			FD_SET(pSock->mSock, &inp_set);
-
-		FD_SET(pSock->mSock, &exc_set);
-
-		if (pSock->HasOutput())
-			FD_SET(pSock->mSock, &out_set);
-
-		if ((int)pSock->mSock > maxdesc)
-			maxdesc = (int)pSock->mSock;
+		NetSocket *pSock = mOutputSockets[i];
+		if (!(pSock->mDeleteFlag&1) && pSock->mSock != INVALID_SOCKET && pSock->HasOutput())
+			pSock->HandleOutput();
 
-	 }
-  
-	int selRet = 0;
+		UpdatePollEvents(pSock);
+	}
+	mOutputSockets.clear();
 
-	// do the select (duration passed in as tv, NULL to block until event)
-	selRet = select(maxdesc+1, &inp_set, &out_set, &exc_set, &tv) ;
-	if (selRet == SOCKET_ERROR)
+	// wait for the ready sockets (duration passed in as microseconds)
+	if (mPoller.Wait(pauseMicroSecs, mPollerEvents) < 0)
 	{
 		PrintError();
 		return;
 	}
 
 	// handle input, output, and exceptions
-
-	if (selRet)
+	for (SocketPoller::Event const& pollerEvent : mPollerEvents)
 	{
-		for (SocketList::iterator i = mSockList.begin(); i != mSockList.end(); ++i)
-		{
-			NetSocket *pSock = *i;
+		NetSocket *pSock = pollerEvent.mSocket;
 
-			if ((pSock->mDeleteFlag&1) || pSock->mSock == INVALID_SOCKET)
-				continue;
+		if ((pSock->mDeleteFlag&1) || pSock->mSock == INVALID_SOCKET)
+			continue;
 
-			if (FD_ISSET(pSock->mSock, &exc_set))
-			{
-				pSock->HandleException();
-			}
+		if (pollerEvent.mEvents & SocketPoller::SP_ERROR)
+		{
+			pSock->HandleException();
+		}
 
-			if (!(pSock->mDeleteFlag&1) && FD_ISSET(pSock->mSock, &out_set))
-			{
+		if (!(pSock->mDeleteFlag&1) && (pollerEvent.mEvents & SocketPoller::SP_OUTPUT))
+		{
+			if (pSock->HasOutput())
 				pSock->HandleOutput();
-			}
 
-			if (   handleInput
-				&& !(pSock->mDeleteFlag&1) && FD_ISSET(pSock->mSock, &inp_set))
-			{
-				pSock->HandleInput();
-			}
-		 }	
+			UpdatePollEvents(pSock);
+		}
+
+		if (   handleInput
+			&& !(pSock->mDeleteFlag&1) && (pollerEvent.mEvents & SocketPoller::SP_INPUT))
+		{
+			pSock->HandleInput();
+		}
 	}
 
 	unsigned int timeNow = Timer::GetTime();
@@ -727,6 +780,8 @@ void BaseSocketManager::DoSelect(int pauseMicroSecs, bool handleInput)
 	while (i != mSockList.end())
 	{
 		NetSocket *pSock = *i;
+		++i;
+
 		if (pSock->mTimeOut) 
 		{
 			if (pSock->mTimeOut < timeNow)
@@ -739,25 +794,22 @@ void BaseSocketManager::DoSelect(int pauseMicroSecs, bool handleInput)
 		{
 			switch (pSock->mDeleteFlag) 
 			{
-			  case 1:
+				case 1:
 					SocketMngr->RemoveSocket(pSock);
-					i = mSockList.begin();
 					break;
 				case 3:
 					pSock->mDeleteFlag = 2;
 					if (pSock->mSock != INVALID_SOCKET) 
 					{
+						mPoller.Remove(pSock->mSock);
 						closesocket(pSock->mSock);
 						pSock->mSock = INVALID_SOCKET;
 					}
 					break;
 			}
 		}
-
-		++i;
-
-	 }
- }
+	}
+}
 
 
 //
@@ -886,6 +938,8 @@ void GameServerListenSocket::HandleInput()
 //
 // RemoteEventSocket::HandleInput				- Chapter 19, page 688
 //
+//   Messages are binary: the message type as a byte followed by its fields
+//
 void RemoteEventSocket::HandleInput()
 {
 	NetSocket::HandleInput();
@@ -902,8 +956,7 @@ void RemoteEventSocket::HandleInput()
 
 			std::istrstream in(buf+sizeof(u_long), (size-sizeof(u_long)));
 			
-			int type;
-			in >> type;
+			int type = ReadUInt8(in);
 			switch(type)
 			{
 				case NMS_EVENT:
@@ -912,17 +965,26 @@ void RemoteEventSocket::HandleInput()
 
 				case NMS_PLAYERLOGINOK:
 				{
-					int serverSockId, actorId;
-					in >> serverSockId;
-					in >> actorId;
-					std::string level;
-					in >> level;			// [mrmike] This was the best spot to set the level !
+					int serverSockId = ReadInt32(in);
+					ActorId actorId = ReadUInt32(in);
                     std::shared_ptr<EventDataNetworkPlayerActorAssignment> pEvent(
 						new EventDataNetworkPlayerActorAssignment(actorId, serverSockId));
                     BaseEventManager::Get()->QueueEvent(pEvent);
 					break;
 				}
 
+				case NMS_SNAPSHOT:
+					ReadSnapshot(in);
+					break;
+
+				case NMS_SNAPSHOTACK:
+				{
+					unsigned int sequence = ReadUInt32(in);
+					std::shared_ptr<EventDataSnapshotAck> pEvent(new EventDataSnapshotAck(mID, sequence));
+					BaseEventManager::Get()->QueueEvent(pEvent);
+					break;
+				}
+
 				default:
 					LogError("Unknown message type.");
 			}
@@ -938,17 +1000,35 @@ void RemoteEventSocket::HandleInput()
 //
 // RemoteEventSocket::CreateEvent				- Chapter 19, page 689
 //
-void RemoteEventSocket::CreateEvent(std::istrstream &in)
+void RemoteEventSocket::CreateEvent(std::istream &in)
 {
-	// Note:  We can improve the efficiency of this by comparing the hash values instead of strings.
-	// But strings are easier to debug!
-	BaseEventType eventType;
-	in >> eventType;
+	BaseEventType eventType = ReadUInt32(in);
+	if (in.fail())
+	{
+		LogError("ERROR Truncated event type from remote");
+		return;
+	}
 
     BaseEventDataPtr pEvent(CREATE_EVENT(eventType));
     if (pEvent)
     {
-        pEvent->Deserialize(in);
+		try
+		{
+			pEvent->DeserializeBinary(in);
+		}
+		catch (SerializationError& e)
+		{
+			LogError("ERROR Malformed event " + std::string(pEvent->GetName()) + 
+				" from remote: " + std::string(e.what()));
+			return;
+		}
+
+		// the stream readers fill a short read with zeros instead of throwing
+		if (in.fail())
+		{
+			LogError("ERROR Truncated event " + std::string(pEvent->GetName()) + " from remote");
+			return;
+		}
         BaseEventManager::Get()->QueueEvent(pEvent);
     }
     else
@@ -959,20 +1039,41 @@ void RemoteEventSocket::CreateEvent(std::istrstream &in)
 
 
 
+//
+// RemoteEventSocket::ReadSnapshot				- not described in the book
+//
+//   Applies an actor snapshot from the server and acknowledges it, so the next 
+//   ones are delta encoded against it
+//
+void RemoteEventSocket::ReadSnapshot(std::istream &in)
+{
+	unsigned int sequence = mSnapshotReader.Read(in);
+	if (!sequence)
+		return;
+
+	std::ostringstream out(std::ios_base::binary);
+	WriteUInt8(out, NMS_SNAPSHOTACK);
+	WriteUInt32(out, sequence);
+
+	const std::string& msg = out.str();
+	Send(std::shared_ptr<BinaryPacket>(new BinaryPacket(msg.c_str(), (u_long)msg.size())));
+}
+
+
+
 //
 // NetworkEventForwarder::ForwardEvent			- Chapter 19, page 690
 //
 void NetworkEventForwarder::ForwardEvent(BaseEventDataPtr pEventData)
 {
-	std::ostrstream out;
+	std::ostringstream out(std::ios_base::binary);
 
-	out << static_cast<int>(RemoteEventSocket::NMS_EVENT) << " ";
-	out << pEventData->GetEventType() << " ";
-	pEventData->Serialize(out);
-	out << "\r\n";
+	WriteUInt8(out, RemoteEventSocket::NMS_EVENT);
+	WriteUInt32(out, pEventData->GetEventType());
+	pEventData->SerializeBinary(out);
 
-	std::shared_ptr<BinaryPacket> eventMsg(
-		new BinaryPacket(out.rdbuf()->str(), (u_long)out.pcount()));
+	const std::string& msg = out.str();
+	std::shared_ptr<BinaryPacket> eventMsg(new BinaryPacket(msg.c_str(), (u_long)msg.size()));
 
 	BaseSocketManager::SocketMngr->Send(mSockId, eventMsg);
 }
@@ -988,6 +1089,30 @@ NetworkGameView::NetworkGameView()
 	mActorId = INVALID_ACTOR_ID;
 	BaseEventManager::Get()->AddListener(
 		MakeDelegate(this, &NetworkGameView::NewActorDelegate), EventDataNewActor::skEventType);
+
+	mSnapshotBudget = 0;
+	mSnapshotInterval = 0;
+	mSnapshotElapsed = 0;
+}
+
+NetworkGameView::~NetworkGameView()
+{
+	BaseEventManager::Get()->RemoveListener(
+		MakeDelegate(this, &NetworkGameView::NewActorDelegate), EventDataNewActor::skEventType);
+	if (mSnapshotWriter)
+	{
+		BaseEventManager::Get()->RemoveListener(
+			MakeDelegate(this, &NetworkGameView::SnapshotAckDelegate), EventDataSnapshotAck::skEventType);
+	}
+}
+
+//
+// NetworkGameView::IsSnapshotReplicationEnabled	- not described in the book
+//
+bool NetworkGameView::IsSnapshotReplicationEnabled()
+{
+	return Settings::Get()->Exists("snapshot_replication") && 
+		Settings::Get()->GetBool("snapshot_replication");
 }
 
 //
@@ -1001,16 +1126,27 @@ void NetworkGameView::AttachRemotePlayer(int sockID)
 	// which is how each client can be uniquely identified from other
 	// clients attached to the server.
 
-	std::ostrstream out;
+	std::ostringstream out(std::ios_base::binary);
 
-	out << static_cast<int>(RemoteEventSocket::NMS_PLAYERLOGINOK) << " ";
-	out << mSockId << " ";
-	out << mActorId << " ";
-	out << "\r\n";
+	WriteUInt8(out, RemoteEventSocket::NMS_PLAYERLOGINOK);
+	WriteInt32(out, mSockId);
+	WriteUInt32(out, mActorId);
 
-	std::shared_ptr<BinaryPacket> gvidMsg(
-		new BinaryPacket(out.rdbuf()->str(), (u_long)out.pcount()));
+	const std::string& msg = out.str();
+	std::shared_ptr<BinaryPacket> gvidMsg(new BinaryPacket(msg.c_str(), (u_long)msg.size()));
 	BaseSocketManager::SocketMngr->Send(mSockId, gvidMsg);
+
+	if (IsSnapshotReplicationEnabled() && !mSnapshotWriter)
+	{
+		mSnapshotBudget = Settings::Get()->Exists("snapshot_budget") ? 
+			Settings::Get()->GetUInt("snapshot_budget") : 1200;
+		mSnapshotInterval = Settings::Get()->Exists("snapshot_interval") ? 
+			Settings::Get()->GetUInt("snapshot_interval") : 50;
+		mSnapshotWriter.reset(new SnapshotWriter());
+
+		BaseEventManager::Get()->AddListener(
+			MakeDelegate(this, &NetworkGameView::SnapshotAckDelegate), EventDataSnapshotAck::skEventType);
+	}
 }
 
 //
@@ -1030,8 +1166,44 @@ void NetworkGameView::OnUpdate(unsigned int timeMs, unsigned long deltaMs)
 		BaseEventManager::Get()->RemoveListener(
 			MakeDelegate(this, &NetworkGameView::NewActorDelegate), EventDataNewActor::skEventType);
 	}
+
+	if (mSnapshotWriter)
+	{
+		mSnapshotElapsed += deltaMs;
+		if (mSnapshotElapsed >= mSnapshotInterval)
+		{
+			mSnapshotElapsed = 0;
+			SendSnapshot();
+		}
+	}
 };
 
+//
+// NetworkGameView::SendSnapshot				- not described in the book
+//
+//   Sends the client the actors which changed since the last snapshot it acknowledged,
+//   most relevant to its player first and within the snapshot budget
+//
+void NetworkGameView::SendSnapshot()
+{
+	std::ostringstream out(std::ios_base::binary);
+	WriteUInt8(out, RemoteEventSocket::NMS_SNAPSHOT);
+	if (!mSnapshotWriter->Write(out, mActorId, mSnapshotBudget))
+		return;
+
+	const std::string& msg = out.str();
+	std::shared_ptr<BinaryPacket> snapshotMsg(new BinaryPacket(msg.c_str(), (u_long)msg.size()));
+	BaseSocketManager::SocketMngr->Send(mSockId, snapshotMsg);
+}
+
+void NetworkGameView::SnapshotAckDelegate(BaseEventDataPtr pEventData)
+{
+	std::shared_ptr<EventDataSnapshotAck> pCastEventData =
+		std::static_pointer_cast<EventDataSnapshotAck>(pEventData);
+	if (pCastEventData->GetSocketId() == mSockId)
+		mSnapshotWriter->Acknowledge(pCastEventData->GetSequence());
+}
+
 void NetworkGameView::NewActorDelegate(BaseEventDataPtr pEventData)
 {
     std::shared_ptr<EventDataNewActor> pCastEventData = 
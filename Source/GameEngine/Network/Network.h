@@ -46,11 +46,15 @@
 #include "Core/Event/EventManager.h"
 #include "Core/OS/Os.h"
 
+#include "SocketPoller.h"
+#include "Snapshot.h"
+
 #include <sys/types.h>
 #include <Winsock2.h>
 
-#define MAX_PACKET_SIZE (256)
-#define RECV_BUFFER_SIZE (MAX_PACKET_SIZE * 512)
+#define MAX_PACKET_SIZE (16384)
+#define RECV_BUFFER_SIZE (MAX_PACKET_SIZE * 8)
+#define MAX_SEND_BUFFERS (64)
 #define MAX_QUEUE_PER_PLAYER (10000)
 
 #define MAGIC_NUMBER (0x1f2e3d4c)
@@ -93,7 +97,7 @@ protected:
 public:
 	inline BinaryPacket(char const * const data, u_long size);
 	inline BinaryPacket(u_long size);
-	virtual ~BinaryPacket() { delete mData; }
+	virtual ~BinaryPacket() { delete[] mData; }
 	virtual char const * const GetType() const { return Type; }
 	virtual char const * const GetData() const { return mData; }
 	virtual u_long GetSize() const { return ntohl(*(u_long *)mData); }
@@ -152,7 +156,7 @@ public:
 class NetSocket 
 {
 	friend class BaseSocketManager;
-	typedef std::list<std::shared_ptr<BasePacket>> PacketList;
+	typedef std::deque<std::shared_ptr<BasePacket>> PacketList;
 
 public:
 	NetSocket();											// clients use this to initialize a NetSocket prior to calling Connect.
@@ -175,6 +179,8 @@ public:
 	int GetIpAddress() { return mIPAddr; }
 
 protected:
+	void CopyRecvData(char* dest, unsigned int offset, unsigned int size) const;
+
     SOCKET mSock;
 	int mID;				// a unique ID given by the socket manager
 
@@ -185,10 +191,17 @@ protected:
 	PacketList mOutList;
 	PacketList mInList;
 
+	// ring buffer of the received data, mRecvOfs bytes are pending from mRecvBegin
 	char mRecvBuf[RECV_BUFFER_SIZE];
 	unsigned int mRecvOfs, mRecvBegin;
 	bool mIsBinaryProtocol;
 
+	// set while the rest of a text line too long for the ring buffer is dropped
+	bool mSkipLine;
+
+	// events the socket is registered for in the poller of the socket manager
+	unsigned int mPollEvents;
+
     int mSendOfs;
 	unsigned int mTimeOut;
 	unsigned int mIPAddr;
@@ -212,6 +225,12 @@ protected:
 	SocketList mSockList;
 	SocketIdMap mSockMap;
 
+	// sockets which got packets to send since the last select, they are flushed before waiting
+	std::vector<NetSocket*> mOutputSockets;
+
+	SocketPoller mPoller;
+	std::vector<SocketPoller::Event> mPollerEvents;
+
 	int mNextSocketId;
 	unsigned int mInbound;
 	unsigned int mOutbound;
@@ -220,6 +239,7 @@ protected:
 	unsigned int mSubNet;
 
 	NetSocket *FindSocket(int sockId);
+	void UpdatePollEvents(NetSocket *socket);
 
 public:
 
@@ -253,6 +273,7 @@ public:
 
 	void AddToOutbound(int rc) { mOutbound += rc; }
 	void AddToInbound(int rc) { mInbound += rc; }
+	void AddToOutput(NetSocket *socket) { mOutputSockets.push_back(socket); }
 
 };
 
@@ -317,6 +338,8 @@ public:
 	{
 		NMS_EVENT,
 		NMS_PLAYERLOGINOK,
+		NMS_SNAPSHOT,
+		NMS_SNAPSHOTACK,
 	};
 
 	// server accepting a client
@@ -331,7 +354,10 @@ public:
 	virtual void HandleInput();
 
 protected:
-	void CreateEvent(std::istrstream &in);
+	void CreateEvent(std::istream &in);
+	void ReadSnapshot(std::istream &in);
+
+	SnapshotReader mSnapshotReader;
 };
 
 
@@ -379,18 +405,30 @@ public:
 	virtual bool OnMsgProc(const Event& evt) { return false; }
 
 	void NewActorDelegate(BaseEventDataPtr pEventData);
+	void SnapshotAckDelegate(BaseEventDataPtr pEventData);
 
 	void SetPlayerActorId(ActorId actorId) { mActorId = actorId; }
 	void AttachRemotePlayer(int sockID);
 
 	int HasRemotePlayerAttached() { return mSockId != INVALID_SOCKET_ID; }
 
+	// actor transforms are sent as per client snapshots instead of forwarding their sync events
+	static bool IsSnapshotReplicationEnabled();
+
 	NetworkGameView();
+	virtual ~NetworkGameView();
 
 protected:
+	void SendSnapshot();
+
 	GameViewId mViewId;
 	ActorId mActorId;
 	int mSockId;
+
+	std::unique_ptr<SnapshotWriter> mSnapshotWriter;
+	unsigned int mSnapshotBudget;
+	unsigned int mSnapshotInterval;
+	unsigned long mSnapshotElapsed;
 };
 
 #endif
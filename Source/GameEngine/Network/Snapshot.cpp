@@ -0,0 +1,581 @@
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+
+#include "Snapshot.h"
+#include "Network.h"
+
+#include "Core/Logger/Logger.h"
+#include "Core/Event/Event.h"
+#include "Core/Utility/Serialize.h"
+
+#include "Game/GameLogic.h"
+
+#include "Mathematic/Algebra/Rotation.h"
+#include "Mathematic/Function/Constants.h"
+
+// per entry flags telling which fields follow the actor id
+enum SnapshotEntryFlags
+{
+	SEF_POSITION_X = 0x01,
+	SEF_POSITION_Y = 0x02,
+	SEF_POSITION_Z = 0x04,
+	SEF_ROTATION = 0x08,
+	SEF_NEW = 0x10,
+	SEF_SCALE = 0x20,
+	SEF_VELOCITY = 0x40,
+	SEF_DESTROY = 0x80
+};
+
+// packet length, message type, sequence, baseline sequence and entry count
+const unsigned int SNAPSHOT_HEADER_SIZE = 4 + 1 + 4 + 4 + 2;
+
+static void WriteVarUInt(std::string& out, unsigned int value)
+{
+	while (value >= 0x80)
+	{
+		out.push_back((char)((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	out.push_back((char)value);
+}
+
+static void WriteVarInt(std::string& out, int value)
+{
+	WriteVarUInt(out, ((unsigned int)value << 1) ^ (unsigned int)(value >> 31));
+}
+
+static unsigned int ReadVarUInt(std::istream& in)
+{
+	unsigned int value = 0;
+	for (unsigned int shift = 0; shift < 35; shift += 7)
+	{
+		int byte = in.get();
+		if (byte == EOF)
+			throw SerializationError("ReadVarUInt: unexpected end of snapshot");
+
+		value |= (unsigned int)(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+			return value;
+	}
+	throw SerializationError("ReadVarUInt: malformed value");
+}
+
+static int ReadVarInt(std::istream& in)
+{
+	unsigned int value = ReadVarUInt(in);
+	return (int)(value >> 1) ^ -(int)(value & 1);
+}
+
+static void WriteRotation(std::string& out, unsigned int rotation)
+{
+	char buf[4];
+	WriteUInt32((uint8_t*)buf, rotation);
+	out.append(buf, sizeof(buf));
+}
+
+static bool CompareActorId(const ActorSnapshot& actor, ActorId id)
+{
+	return actor.mId < id;
+}
+
+
+void ActorSnapshot::Quantize(const Transform& transform, const Vector3<float>& velocity)
+{
+	Vector3<float> translation = transform.GetTranslation();
+	Vector3<float> scale = transform.IsRSMatrix() ? transform.GetScale() : Vector3<float>{ 1.f, 1.f, 1.f };
+	for (int i = 0; i < 3; ++i)
+	{
+		mPosition[i] = (int)floorf(translation[i] * SNAPSHOT_POSITION_SCALE + 0.5f);
+		mScale[i] = (int)floorf(scale[i] * SNAPSHOT_SCALE_PRECISION + 0.5f);
+		mVelocity[i] = (int)floorf(velocity[i] * SNAPSHOT_VELOCITY_SCALE + 0.5f);
+	}
+
+	Quaternion<float> rotation = Rotation<4, float>(
+		transform.IsRSMatrix() ? transform.GetRotation() : transform.GetMatrix());
+	Normalize(rotation);
+
+	// the largest component is dropped and rebuilt from the unit length, the others
+	// lie within [-1/sqrt(2), 1/sqrt(2)] and are stored in ten bits each
+	int largest = 0;
+	for (int i = 1; i < 4; ++i)
+		if (fabs(rotation[i]) > fabs(rotation[largest]))
+			largest = i;
+	float sign = rotation[largest] < 0.f ? -1.f : 1.f;
+
+	mRotation = largest;
+	for (int i = 0, shift = 2; i < 4; ++i)
+	{
+		if (i == largest)
+			continue;
+
+		float value = (sign * rotation[i] * (float)GE_C_SQRT_2 + 1.f) * 0.5f;
+		int bits = (int)(value * 1023.f + 0.5f);
+		mRotation |= (unsigned int)std::min(std::max(bits, 0), 1023) << shift;
+		shift += 10;
+	}
+}
+
+Transform ActorSnapshot::GetTransform(void) const
+{
+	Quaternion<float> rotation;
+	int largest = mRotation & 3;
+	float sum = 0.f;
+	for (int i = 0, shift = 2; i < 4; ++i)
+	{
+		if (i == largest)
+			continue;
+
+		float value = (float)((mRotation >> shift) & 1023) / 1023.f;
+		rotation[i] = (value * 2.f - 1.f) * (float)GE_C_INV_SQRT_2;
+		sum += rotation[i] * rotation[i];
+		shift += 10;
+	}
+	rotation[largest] = sqrtf(std::max(1.f - sum, 0.f));
+
+	Transform transform;
+	transform.SetRotation(rotation);
+	transform.SetScale(
+		mScale[0] / SNAPSHOT_SCALE_PRECISION,
+		mScale[1] / SNAPSHOT_SCALE_PRECISION,
+		mScale[2] / SNAPSHOT_SCALE_PRECISION);
+	transform.SetTranslation(
+		mPosition[0] / SNAPSHOT_POSITION_SCALE, 
+		mPosition[1] / SNAPSHOT_POSITION_SCALE, 
+		mPosition[2] / SNAPSHOT_POSITION_SCALE);
+	return transform;
+}
+
+Vector3<float> ActorSnapshot::GetVelocity(void) const
+{
+	return Vector3<float>{
+		mVelocity[0] / SNAPSHOT_VELOCITY_SCALE,
+		mVelocity[1] / SNAPSHOT_VELOCITY_SCALE,
+		mVelocity[2] / SNAPSHOT_VELOCITY_SCALE };
+}
+
+
+SnapshotWorld::SnapshotWorld(bool followEvents) : mFollowEvents(followEvents)
+{
+	if (mFollowEvents)
+	{
+		BaseEventManager::Get()->AddListener(
+			MakeDelegate(this, &SnapshotWorld::SyncActorDelegate), EventDataSyncActor::skEventType);
+		BaseEventManager::Get()->AddListener(
+			MakeDelegate(this, &SnapshotWorld::DestroyActorDelegate), EventDataDestroyActor::skEventType);
+	}
+}
+
+SnapshotWorld::~SnapshotWorld(void)
+{
+	if (mFollowEvents)
+	{
+		BaseEventManager::Get()->RemoveListener(
+			MakeDelegate(this, &SnapshotWorld::SyncActorDelegate), EventDataSyncActor::skEventType);
+		BaseEventManager::Get()->RemoveListener(
+			MakeDelegate(this, &SnapshotWorld::DestroyActorDelegate), EventDataDestroyActor::skEventType);
+	}
+}
+
+std::shared_ptr<SnapshotWorld> SnapshotWorld::Get(void)
+{
+	// alive while any network view replicates snapshots
+	static std::weak_ptr<SnapshotWorld> world;
+
+	std::shared_ptr<SnapshotWorld> pWorld = world.lock();
+	if (!pWorld)
+	{
+		pWorld.reset(new SnapshotWorld(true));
+		world = pWorld;
+	}
+	return pWorld;
+}
+
+void SnapshotWorld::SetActor(ActorId actorId, const Transform& transform, const Vector3<float>& velocity)
+{
+	ActorSnapshot& actor = mActors[actorId];
+	actor.mId = actorId;
+	actor.Quantize(transform, velocity);
+}
+
+void SnapshotWorld::RemoveActor(ActorId actorId)
+{
+	mActors.erase(actorId);
+
+	// the writers stop waiting to send it
+	for (SnapshotWriter* pWriter : mWriters)
+		pWriter->RemoveActor(actorId);
+}
+
+void SnapshotWorld::AddWriter(SnapshotWriter* pWriter)
+{
+	mWriters.push_back(pWriter);
+}
+
+void SnapshotWorld::RemoveWriter(SnapshotWriter* pWriter)
+{
+	mWriters.erase(std::remove(mWriters.begin(), mWriters.end(), pWriter), mWriters.end());
+}
+
+void SnapshotWorld::SyncActorDelegate(BaseEventDataPtr pEventData)
+{
+	std::shared_ptr<EventDataSyncActor> pCastEventData =
+		std::static_pointer_cast<EventDataSyncActor>(pEventData);
+
+	Vector3<float> velocity = Vector3<float>::Zero();
+	std::shared_ptr<BaseGamePhysic> gamePhysics = GameLogic::Get()->GetGamePhysics();
+	if (gamePhysics)
+		velocity = gamePhysics->GetVelocity(pCastEventData->GetId());
+
+	SetActor(pCastEventData->GetId(), pCastEventData->GetTransform(), velocity);
+}
+
+void SnapshotWorld::DestroyActorDelegate(BaseEventDataPtr pEventData)
+{
+	std::shared_ptr<EventDataDestroyActor> pCastEventData =
+		std::static_pointer_cast<EventDataDestroyActor>(pEventData);
+	RemoveActor(pCastEventData->GetId());
+}
+
+
+SnapshotWriter::SnapshotWriter(void) : SnapshotWriter(SnapshotWorld::Get())
+{
+
+}
+
+SnapshotWriter::SnapshotWriter(const std::shared_ptr<SnapshotWorld>& world)
+{
+	mWorld = world;
+	mWorld->AddWriter(this);
+	mAcknowledged.mSequence = 0;
+	mSequence = 0;
+}
+
+SnapshotWriter::~SnapshotWriter(void)
+{
+	mWorld->RemoveWriter(this);
+}
+
+void SnapshotWriter::Acknowledge(unsigned int sequence)
+{
+	while (!mPending.empty() && mPending.front().mSequence <= sequence)
+	{
+		if (mPending.front().mSequence == sequence)
+			mAcknowledged = std::move(mPending.front());
+		mPending.pop_front();
+	}
+}
+
+bool SnapshotWriter::Write(std::ostream& out, ActorId viewerId, unsigned int budget)
+{
+	// the client is not keeping up, wait for its acknowledgments
+	if (mPending.size() >= SNAPSHOT_MAX_PENDING)
+		return false;
+
+	const std::map<ActorId, ActorSnapshot>& actors = mWorld->GetActors();
+	std::map<ActorId, ActorSnapshot>::const_iterator itViewer = actors.find(viewerId);
+	const float invRelevanceDistance = 1.f / 
+		(SNAPSHOT_RELEVANCE_DISTANCE * SNAPSHOT_RELEVANCE_DISTANCE * SNAPSHOT_POSITION_SCALE * SNAPSHOT_POSITION_SCALE);
+
+	// collect the actors the client does not know about yet and the ones it holds which were destroyed,
+	// both in id order
+	mCandidates.clear();
+	std::vector<ActorSnapshot>::const_iterator itBaseline = mAcknowledged.mActors.begin();
+	std::map<ActorId, ActorSnapshot>::const_iterator it = actors.begin();
+	while (it != actors.end() || itBaseline != mAcknowledged.mActors.end())
+	{
+		if (it == actors.end() || 
+			(itBaseline != mAcknowledged.mActors.end() && itBaseline->mId < it->first))
+		{
+			// the client drops destroyed actors before anything else is sent
+			Candidate candidate;
+			candidate.mActor = NULL;
+			candidate.mBaseline = &(*itBaseline);
+			candidate.mPriority = FLT_MAX;
+			candidate.mSelected = false;
+			mCandidates.push_back(candidate);
+
+			++itBaseline;
+			continue;
+		}
+
+		const ActorSnapshot* baseline = NULL;
+		if (itBaseline != mAcknowledged.mActors.end() && itBaseline->mId == it->first)
+		{
+			baseline = &(*itBaseline);
+			++itBaseline;
+			if (*baseline == it->second)
+			{
+				++it;
+				continue;
+			}
+		}
+
+		float relevance = 1.f;
+		if (itViewer != actors.end())
+		{
+			float distance = 0.f;
+			for (int i = 0; i < 3; ++i)
+			{
+				float delta = (float)(it->second.mPosition[i] - itViewer->second.mPosition[i]);
+				distance += delta * delta;
+			}
+			relevance = 1.f / (1.f + distance * invRelevanceDistance);
+		}
+
+		float& priority = mPriorities[it->first];
+		priority += relevance;
+
+		Candidate candidate;
+		candidate.mActor = &it->second;
+		candidate.mBaseline = baseline;
+		candidate.mPriority = priority;
+		candidate.mSelected = false;
+		mCandidates.push_back(candidate);
+
+		++it;
+	}
+	if (mCandidates.empty())
+		return false;
+
+	mOrder.clear();
+	for (Candidate& candidate : mCandidates)
+		mOrder.push_back(&candidate);
+	std::sort(mOrder.begin(), mOrder.end(), [](const Candidate* a, const Candidate* b)
+		{ return a->mPriority > b->mPriority; });
+
+	// write the most urgent entries which fit within the budget
+	budget = std::max(budget, (unsigned int)SNAPSHOT_MIN_BUDGET);
+	std::string entries, entry;
+	unsigned short count = 0;
+	for (Candidate* candidate : mOrder)
+	{
+		entry.clear();
+		if (!candidate->mActor)
+		{
+			WriteVarUInt(entry, candidate->mBaseline->mId);
+			entry.push_back((char)SEF_DESTROY);
+		}
+		else if (candidate->mBaseline)
+		{
+			const ActorSnapshot& actor = *candidate->mActor;
+			const ActorSnapshot& baseline = *candidate->mBaseline;
+
+			unsigned char flags = 0;
+			for (int i = 0; i < 3; ++i)
+			{
+				if (actor.mPosition[i] != baseline.mPosition[i])
+					flags |= SEF_POSITION_X << i;
+				if (actor.mScale[i] != baseline.mScale[i])
+					flags |= SEF_SCALE;
+				if (actor.mVelocity[i] != baseline.mVelocity[i])
+					flags |= SEF_VELOCITY;
+			}
+			if (actor.mRotation != baseline.mRotation)
+				flags |= SEF_ROTATION;
+
+			WriteVarUInt(entry, actor.mId);
+			entry.push_back((char)flags);
+			for (int i = 0; i < 3; ++i)
+				if (flags & (SEF_POSITION_X << i))
+					WriteVarInt(entry, actor.mPosition[i] - baseline.mPosition[i]);
+			if (flags & SEF_ROTATION)
+				WriteRotation(entry, actor.mRotation);
+			if (flags & SEF_SCALE)
+				for (int i = 0; i < 3; ++i)
+					WriteVarInt(entry, actor.mScale[i] - baseline.mScale[i]);
+			if (flags & SEF_VELOCITY)
+				for (int i = 0; i < 3; ++i)
+					WriteVarInt(entry, actor.mVelocity[i] - baseline.mVelocity[i]);
+		}
+		else
+		{
+			const ActorSnapshot& actor = *candidate->mActor;
+
+			WriteVarUInt(entry, actor.mId);
+			entry.push_back((char)SEF_NEW);
+			for (int i = 0; i < 3; ++i)
+				WriteVarInt(entry, actor.mPosition[i]);
+			WriteRotation(entry, actor.mRotation);
+			for (int i = 0; i < 3; ++i)
+				WriteVarInt(entry, actor.mScale[i]);
+			for (int i = 0; i < 3; ++i)
+				WriteVarInt(entry, actor.mVelocity[i]);
+		}
+
+		if (SNAPSHOT_HEADER_SIZE + entries.size() + entry.size() > budget || count == USHRT_MAX)
+			continue;
+
+		entries += entry;
+		candidate->mSelected = true;
+		if (candidate->mActor)
+			mPriorities.erase(candidate->mActor->mId);
+		count++;
+	}
+
+	// the state the client holds once it applies this snapshot
+	Snapshot snapshot;
+	snapshot.mSequence = ++mSequence;
+	snapshot.mActors.reserve(actors.size());
+	std::vector<Candidate>::const_iterator itCandidate = mCandidates.begin();
+	it = actors.begin();
+	while (it != actors.end() || itCandidate != mCandidates.end())
+	{
+		if (itCandidate != mCandidates.end() && !itCandidate->mActor &&
+			(it == actors.end() || itCandidate->mBaseline->mId < it->first))
+		{
+			// destroyed actors stay with the client until it is told
+			if (!itCandidate->mSelected)
+				snapshot.mActors.push_back(*itCandidate->mBaseline);
+			++itCandidate;
+		}
+		else if (itCandidate != mCandidates.end() && itCandidate->mActor == &it->second)
+		{
+			if (itCandidate->mSelected)
+				snapshot.mActors.push_back(it->second);
+			else if (itCandidate->mBaseline)
+				snapshot.mActors.push_back(*itCandidate->mBaseline);
+			++itCandidate;
+			++it;
+		}
+		else
+		{
+			snapshot.mActors.push_back(it->second);
+			++it;
+		}
+	}
+
+	WriteUInt32(out, snapshot.mSequence);
+	WriteUInt32(out, mAcknowledged.mSequence);
+	WriteUInt16(out, count);
+	out.write(entries.data(), entries.size());
+
+	mPending.push_back(std::move(snapshot));
+	return true;
+}
+
+
+unsigned int SnapshotReader::Read(std::istream& in)
+{
+	unsigned int sequence = ReadUInt32(in);
+	unsigned int baselineSequence = ReadUInt32(in);
+	unsigned short count = ReadUInt16(in);
+
+	// the server never goes back to an older baseline
+	while (!mReceived.empty() && mReceived.front().mSequence < baselineSequence)
+		mReceived.pop_front();
+
+	Snapshot snapshot;
+	snapshot.mSequence = sequence;
+	if (baselineSequence)
+	{
+		if (mReceived.empty() || mReceived.front().mSequence != baselineSequence)
+		{
+			LogError("Snapshot " + std::to_string(sequence) + 
+				" refers to unknown baseline " + std::to_string(baselineSequence));
+			return 0;
+		}
+		snapshot.mActors = mReceived.front().mActors;
+	}
+
+	std::vector<ActorId> changed;
+	changed.reserve(count);
+	try
+	{
+		for (unsigned short entry = 0; entry < count; ++entry)
+		{
+			ActorId actorId = ReadVarUInt(in);
+			int flags = in.get();
+			if (flags == EOF)
+				throw SerializationError("Snapshot: unexpected end of entry");
+
+			std::vector<ActorSnapshot>::iterator itActor = std::lower_bound(
+				snapshot.mActors.begin(), snapshot.mActors.end(), actorId, CompareActorId);
+			bool known = itActor != snapshot.mActors.end() && itActor->mId == actorId;
+			if (flags & SEF_DESTROY)
+			{
+				// the actor itself is destroyed by the forwarded destroy event
+				if (known)
+					snapshot.mActors.erase(itActor);
+				continue;
+			}
+			else if (flags & SEF_NEW)
+			{
+				if (!known)
+				{
+					ActorSnapshot actor;
+					actor.mId = actorId;
+					itActor = snapshot.mActors.insert(itActor, actor);
+				}
+				for (int i = 0; i < 3; ++i)
+					itActor->mPosition[i] = ReadVarInt(in);
+				itActor->mRotation = ReadUInt32(in);
+				for (int i = 0; i < 3; ++i)
+					itActor->mScale[i] = ReadVarInt(in);
+				for (int i = 0; i < 3; ++i)
+					itActor->mVelocity[i] = ReadVarInt(in);
+			}
+			else
+			{
+				if (!known)
+					throw SerializationError("Snapshot: delta for unknown actor " + std::to_string(actorId));
+
+				for (int i = 0; i < 3; ++i)
+					if (flags & (SEF_POSITION_X << i))
+						itActor->mPosition[i] += ReadVarInt(in);
+				if (flags & SEF_ROTATION)
+					itActor->mRotation = ReadUInt32(in);
+				if (flags & SEF_SCALE)
+					for (int i = 0; i < 3; ++i)
+						itActor->mScale[i] += ReadVarInt(in);
+				if (flags & SEF_VELOCITY)
+					for (int i = 0; i < 3; ++i)
+						itActor->mVelocity[i] += ReadVarInt(in);
+			}
+			changed.push_back(actorId);
+		}
+		if (!in)
+			throw SerializationError("Snapshot: unexpected end of snapshot");
+	}
+	catch (SerializationError& e)
+	{
+		LogError("Malformed snapshot " + std::to_string(sequence) + ": " + std::string(e.what()));
+		return 0;
+	}
+
+	if (mSyncActors)
+	{
+		std::shared_ptr<BaseGamePhysic> gamePhysics = GameLogic::Get()->GetGamePhysics();
+		for (ActorId actorId : changed)
+		{
+			std::vector<ActorSnapshot>::const_iterator itActor = std::lower_bound(
+				snapshot.mActors.begin(), snapshot.mActors.end(), actorId, CompareActorId);
+			if (itActor == snapshot.mActors.end() || itActor->mId != actorId)
+				continue;
+
+			std::shared_ptr<EventDataSyncActor> pEvent(
+				new EventDataSyncActor(actorId, itActor->GetTransform()));
+			BaseEventManager::Get()->QueueEvent(pEvent);
+
+			if (gamePhysics)
+				gamePhysics->SetVelocity(actorId, itActor->GetVelocity());
+		}
+	}
+
+	mReceived.push_back(std::move(snapshot));
+	return sequence;
+}
+
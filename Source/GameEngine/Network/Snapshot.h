@@ -0,0 +1,176 @@
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "GameEngineStd.h"
+
+#include "Game/GameStd.h"
+#include "Core/Event/EventManager.h"
+
+#include "Mathematic/Algebra/Transform.h"
+
+#define SNAPSHOT_POSITION_SCALE (16.f)
+#define SNAPSHOT_SCALE_PRECISION (256.f)
+#define SNAPSHOT_VELOCITY_SCALE (16.f)
+#define SNAPSHOT_RELEVANCE_DISTANCE (500.f)
+#define SNAPSHOT_MAX_PENDING (32)
+#define SNAPSHOT_MIN_BUDGET (64)
+
+//--------------------------------------------------------------------------------------------------------
+// struct ActorSnapshot
+// The quantized transform and linear velocity of an actor as they are replicated to the clients. The
+// position is stored in 1/SNAPSHOT_POSITION_SCALE units, the scale in 1/SNAPSHOT_SCALE_PRECISION and
+// the velocity in 1/SNAPSHOT_VELOCITY_SCALE units per second. The rotation is kept as the smallest three
+// components of its unit quaternion, ten bits each, plus the index of the dropped one.
+//--------------------------------------------------------------------------------------------------------
+struct ActorSnapshot
+{
+	ActorId mId;
+	int mPosition[3];
+	int mScale[3];
+	int mVelocity[3];
+	unsigned int mRotation;
+
+	void Quantize(const Transform& transform, const Vector3<float>& velocity);
+	Transform GetTransform(void) const;
+	Vector3<float> GetVelocity(void) const;
+
+	bool operator==(const ActorSnapshot& other) const
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			if (mPosition[i] != other.mPosition[i] || mScale[i] != other.mScale[i] || 
+				mVelocity[i] != other.mVelocity[i])
+				return false;
+		}
+		return mRotation == other.mRotation;
+	}
+	bool operator!=(const ActorSnapshot& other) const { return !(*this == other); }
+};
+
+//--------------------------------------------------------------------------------------------------------
+// struct Snapshot
+// The actor states a client holds after it has applied the snapshot with the given sequence, sorted by
+// actor id. Both ends keep them so later snapshots can be delta encoded against an acknowledged one.
+//--------------------------------------------------------------------------------------------------------
+struct Snapshot
+{
+	unsigned int mSequence;
+	std::vector<ActorSnapshot> mActors;
+};
+
+class SnapshotWriter;
+
+//--------------------------------------------------------------------------------------------------------
+// class SnapshotWorld
+// The latest quantized state of every actor moved on the server. The shared world follows the actor sync 
+// and destroy events once for every network view writing snapshots for its client. A world which does
+// not follow the events is filled through SetActor and RemoveActor instead.
+//--------------------------------------------------------------------------------------------------------
+class SnapshotWorld
+{
+public:
+	SnapshotWorld(bool followEvents);
+	~SnapshotWorld(void);
+
+	static std::shared_ptr<SnapshotWorld> Get(void);
+
+	const std::map<ActorId, ActorSnapshot>& GetActors(void) const { return mActors; }
+
+	void SetActor(ActorId actorId, const Transform& transform, const Vector3<float>& velocity);
+	void RemoveActor(ActorId actorId);
+
+	void AddWriter(SnapshotWriter* pWriter);
+	void RemoveWriter(SnapshotWriter* pWriter);
+
+	void SyncActorDelegate(BaseEventDataPtr pEventData);
+	void DestroyActorDelegate(BaseEventDataPtr pEventData);
+
+private:
+	bool mFollowEvents;
+	std::map<ActorId, ActorSnapshot> mActors;
+	std::vector<SnapshotWriter*> mWriters;
+};
+
+//--------------------------------------------------------------------------------------------------------
+// class SnapshotWriter
+// Builds the snapshots of a single client. Each one only carries the actors which differ from the last
+// snapshot the client acknowledged, delta encoded against it. The pending actors accumulate a priority
+// from their relevance to the client's player every tick they wait, and the most urgent are written
+// first until the byte budget is spent, after the actors the client must forget because they were
+// destroyed. Nothing is written while too many snapshots are unacknowledged.
+//--------------------------------------------------------------------------------------------------------
+class SnapshotWriter
+{
+	friend class SnapshotWorld;
+
+public:
+	SnapshotWriter(void);
+	SnapshotWriter(const std::shared_ptr<SnapshotWorld>& world);
+	~SnapshotWriter(void);
+
+	// writes the next snapshot for the client viewing from the given actor. Returns false when there 
+	// is nothing to send
+	bool Write(std::ostream& out, ActorId viewerId, unsigned int budget);
+	void Acknowledge(unsigned int sequence);
+
+private:
+	void RemoveActor(ActorId actorId) { mPriorities.erase(actorId); }
+
+	// the actor is null when it was destroyed since the baseline
+	struct Candidate
+	{
+		const ActorSnapshot* mActor;
+		const ActorSnapshot* mBaseline;
+		float mPriority;
+		bool mSelected;
+	};
+
+	std::shared_ptr<SnapshotWorld> mWorld;
+	std::deque<Snapshot> mPending;
+	Snapshot mAcknowledged;
+	unsigned int mSequence;
+
+	std::unordered_map<ActorId, float> mPriorities;
+	std::vector<Candidate> mCandidates;
+	std::vector<Candidate*> mOrder;
+};
+
+//--------------------------------------------------------------------------------------------------------
+// class SnapshotReader
+// Applies the snapshots received by a client against the baselines it keeps. Unless told otherwise, it
+// queues a sync event and sets the physics velocity of each actor they changed.
+//--------------------------------------------------------------------------------------------------------
+class SnapshotReader
+{
+public:
+	SnapshotReader(bool syncActors = true) : mSyncActors(syncActors) { }
+
+	// reads a snapshot and returns its sequence to acknowledge, or 0 if it could not be applied
+	unsigned int Read(std::istream& in);
+
+	// the actor states after the last snapshot read, or null if none was
+	const Snapshot* GetLatest(void) const { return mReceived.empty() ? NULL : &mReceived.back(); }
+
+private:
+	bool mSyncActors;
+	std::deque<Snapshot> mReceived;
+};
+
+#endif
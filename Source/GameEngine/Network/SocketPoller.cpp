@@ -0,0 +1,213 @@
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+#include "SocketPoller.h"
+
+#include "Core/Logger/Logger.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+
+const unsigned int EPOLL_MIN_EVENTS = 64;
+
+static unsigned int ToEpollEvents(unsigned int events)
+{
+	unsigned int epollEvents = 0;
+	if (events & SocketPoller::SP_INPUT)
+		epollEvents |= EPOLLIN;
+	if (events & SocketPoller::SP_OUTPUT)
+		epollEvents |= EPOLLOUT;
+	return epollEvents;
+}
+
+SocketPoller::SocketPoller(void) : mSockets(0)
+{
+	mEpoll = epoll_create1(0);
+	if (mEpoll < 0)
+		LogError("SocketPoller failed to create the epoll instance");
+}
+
+SocketPoller::~SocketPoller(void)
+{
+	if (mEpoll >= 0)
+		close(mEpoll);
+}
+
+bool SocketPoller::Add(SOCKET sock, NetSocket* socket, unsigned int events)
+{
+	epoll_event event;
+	event.events = ToEpollEvents(events);
+	event.data.ptr = socket;
+	if (epoll_ctl(mEpoll, EPOLL_CTL_ADD, sock, &event) < 0)
+		return false;
+
+	++mSockets;
+	return true;
+}
+
+bool SocketPoller::Modify(SOCKET sock, NetSocket* socket, unsigned int events)
+{
+	epoll_event event;
+	event.events = ToEpollEvents(events);
+	event.data.ptr = socket;
+	return epoll_ctl(mEpoll, EPOLL_CTL_MOD, sock, &event) == 0;
+}
+
+void SocketPoller::Remove(SOCKET sock)
+{
+	epoll_event event = {};
+	if (epoll_ctl(mEpoll, EPOLL_CTL_DEL, sock, &event) == 0)
+		--mSockets;
+}
+
+int SocketPoller::Wait(int timeoutMicroSecs, std::vector<Event>& events)
+{
+	events.clear();
+
+	// the buffer grows with the registered sockets so that a single wait can report all of them
+	size_t capacity = std::max((size_t)mSockets, (size_t)EPOLL_MIN_EVENTS);
+	if (mEpollEvents.size() < capacity)
+		mEpollEvents.resize(capacity);
+
+	int timeoutMs = timeoutMicroSecs > 0 ? (timeoutMicroSecs + 999) / 1000 : 0;
+	int count = epoll_wait(mEpoll, mEpollEvents.data(), (int)mEpollEvents.size(), timeoutMs);
+	if (count < 0)
+		return errno == EINTR ? 0 : -1;
+
+	for (int i = 0; i < count; ++i)
+	{
+		const epoll_event& epollEvent = mEpollEvents[i];
+
+		Event event;
+		event.mSocket = (NetSocket*)epollEvent.data.ptr;
+		event.mEvents = 0;
+		// a hang up is reported as input so that the pending data is read before the socket closes
+		if (epollEvent.events & (EPOLLIN | EPOLLHUP))
+			event.mEvents |= SP_INPUT;
+		if (epollEvent.events & EPOLLOUT)
+			event.mEvents |= SP_OUTPUT;
+		if (epollEvent.events & EPOLLERR)
+			event.mEvents |= SP_ERROR;
+		events.push_back(event);
+	}
+	return count;
+}
+
+#else
+
+#if defined(_WIN32)
+#define SOCKET_POLL WSAPoll
+#else
+#define SOCKET_POLL poll
+#endif
+
+static short ToPollEvents(unsigned int events)
+{
+	short pollEvents = 0;
+	if (events & SocketPoller::SP_INPUT)
+		pollEvents |= POLLIN;
+	if (events & SocketPoller::SP_OUTPUT)
+		pollEvents |= POLLOUT;
+	return pollEvents;
+}
+
+SocketPoller::SocketPoller(void)
+{
+}
+
+SocketPoller::~SocketPoller(void)
+{
+}
+
+bool SocketPoller::Add(SOCKET sock, NetSocket* socket, unsigned int events)
+{
+	if (mPollIndex.find(sock) != mPollIndex.end())
+		return false;
+
+	PollFd pollFd;
+	pollFd.fd = sock;
+	pollFd.events = ToPollEvents(events);
+	pollFd.revents = 0;
+
+	mPollIndex[sock] = mPollFds.size();
+	mPollFds.push_back(pollFd);
+	mPollSockets.push_back(socket);
+	return true;
+}
+
+bool SocketPoller::Modify(SOCKET sock, NetSocket* socket, unsigned int events)
+{
+	std::unordered_map<SOCKET, size_t>::iterator itIndex = mPollIndex.find(sock);
+	if (itIndex == mPollIndex.end())
+		return false;
+
+	mPollFds[itIndex->second].events = ToPollEvents(events);
+	mPollSockets[itIndex->second] = socket;
+	return true;
+}
+
+void SocketPoller::Remove(SOCKET sock)
+{
+	std::unordered_map<SOCKET, size_t>::iterator itIndex = mPollIndex.find(sock);
+	if (itIndex == mPollIndex.end())
+		return;
+
+	// the last entry takes the place of the removed one
+	size_t index = itIndex->second;
+	mPollIndex.erase(itIndex);
+	if (index + 1 != mPollFds.size())
+	{
+		mPollFds[index] = mPollFds.back();
+		mPollSockets[index] = mPollSockets.back();
+		mPollIndex[mPollFds[index].fd] = index;
+	}
+	mPollFds.pop_back();
+	mPollSockets.pop_back();
+}
+
+int SocketPoller::Wait(int timeoutMicroSecs, std::vector<Event>& events)
+{
+	events.clear();
+	if (mPollFds.empty())
+		return 0;
+
+	int timeoutMs = timeoutMicroSecs > 0 ? (timeoutMicroSecs + 999) / 1000 : 0;
+	int count = SOCKET_POLL(mPollFds.data(), (unsigned long)mPollFds.size(), timeoutMs);
+	if (count < 0)
+		return -1;
+
+	for (size_t index = 0; index < mPollFds.size() && (int)events.size() < count; ++index)
+	{
+		short revents = mPollFds[index].revents;
+		if (!revents)
+			continue;
+
+		Event event;
+		event.mSocket = mPollSockets[index];
+		event.mEvents = 0;
+		// a hang up is reported as input so that the pending data is read before the socket closes
+		if (revents & (POLLIN | POLLHUP))
+			event.mEvents |= SP_INPUT;
+		if (revents & POLLOUT)
+			event.mEvents |= SP_OUTPUT;
+		if (revents & (POLLERR | POLLNVAL))
+			event.mEvents |= SP_ERROR;
+		events.push_back(event);
+	}
+	return (int)events.size();
+}
+
+#endif
@@ -0,0 +1,90 @@
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+#ifndef SOCKETPOLLER_H
+#define SOCKETPOLLER_H
+
+#include "GameEngineStd.h"
+
+#if defined(_WIN32)
+#include <Winsock2.h>
+#else
+#include <sys/socket.h>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#else
+#include <poll.h>
+#endif
+
+typedef int SOCKET;
+#endif
+
+class NetSocket;
+
+//--------------------------------------------------------------------------------------------------------
+// class SocketPoller
+// Readiness notification for the sockets of the socket manager. The sockets are registered once with
+// the events they are interested in, and a wait only returns the sockets which are ready. The cost of
+// a frame grows with the active sockets instead of the open ones, unlike select which rebuilds and
+// scans every descriptor set each call. Linux uses epoll, other platforms keep a persistent pollfd
+// array for WSAPoll or poll.
+//--------------------------------------------------------------------------------------------------------
+class SocketPoller
+{
+public:
+
+	enum
+	{
+		SP_INPUT = 0x01,
+		SP_OUTPUT = 0x02,
+		SP_ERROR = 0x04
+	};
+
+	struct Event
+	{
+		NetSocket* mSocket;
+		unsigned int mEvents;
+	};
+
+	SocketPoller(void);
+	~SocketPoller(void);
+
+	bool Add(SOCKET sock, NetSocket* socket, unsigned int events);
+	bool Modify(SOCKET sock, NetSocket* socket, unsigned int events);
+	void Remove(SOCKET sock);
+
+	// waits up to the given time for ready sockets and returns how many, or -1 on error
+	int Wait(int timeoutMicroSecs, std::vector<Event>& events);
+
+private:
+
+#if defined(__linux__)
+	int mEpoll;
+	std::vector<epoll_event> mEpollEvents;
+	unsigned int mSockets;
+#else
+#if defined(_WIN32)
+	typedef WSAPOLLFD PollFd;
+#else
+	typedef pollfd PollFd;
+#endif
+	std::vector<PollFd> mPollFds;
+	std::vector<NetSocket*> mPollSockets;
+	std::unordered_map<SOCKET, size_t> mPollIndex;
+#endif
+};
+
+#endif
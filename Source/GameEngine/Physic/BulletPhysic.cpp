@@ -264,9 +264,15 @@ static Transform btTransformToTransform( btTransform const & trans )
 struct ActorMotionState : public btMotionState
 {
 	Transform mWorldToPositionTransform;
+
+	// set once the body is synced with its actor
+	BulletPhysics* mPhysics;
+	ActorId mActorId;
+	BulletPhysics::SyncObject* mSyncObject;
 	
 	ActorMotionState(Transform const & startingTransform)
-	  : mWorldToPositionTransform( startingTransform ) 
+	  : mWorldToPositionTransform( startingTransform ), mPhysics(NULL), 
+		mActorId(INVALID_ACTOR_ID), mSyncObject(NULL)
 	{
 
 	}
@@ -280,6 +286,10 @@ struct ActorMotionState : public btMotionState
 	virtual void setWorldTransform( const btTransform& worldTrans )
 	{ 
 		mWorldToPositionTransform = btTransformToTransform( worldTrans ); 
+
+		// bullet only calls this for the active bodies it has moved
+		if (mSyncObject)
+			mPhysics->MarkMoved(mActorId, mSyncObject);
 	}
 };
 
@@ -702,41 +712,86 @@ void BulletPhysics::SyncVisibleScene()
 {
 	// Keep physics & graphics in sync
 
-	// check all the existing actor's collision object for changes. 
+	// character controllers move their ghost objects without a motion state
+	for (ActorIDToBulletActionMap::const_iterator it = mActorIdToAction.begin(); it != mActorIdToAction.end(); ++it)
+		MarkMoved(it->first);
+
+	// check the collision objects moved since the last sync for changes. 
 	//  If there is a change, send the appropriate event for the game system.
-	for (	ActorIDToBulletCollisionObjectMap::const_iterator it = mActorIdToCollisionObject.begin();
-			it != mActorIdToCollisionObject.end(); ++it )
-	{ 
-		ActorId const id = it->first;
-		btCollisionObject* actorCollisionObject = it->second;
-		
-		std::shared_ptr<Actor> pGameActor(GameLogic::Get()->GetActor(id).lock());
-		if (pGameActor)
+	mSyncActors.swap(mMovedActors);
+	for (ActorId const id : mSyncActors)
+	{
+		// the actor might have been removed since it moved
+		ActorIDToSyncObjectMap::iterator itSync = mActorIdToSyncObject.find(id);
+		if (itSync == mActorIdToSyncObject.end())
+			continue;
+
+		SyncObject& syncObject = itSync->second;
+		syncObject.mMoved = false;
+
+		std::shared_ptr<TransformComponent> pTransformComponent(syncObject.mTransformComponent.lock());
+		if (pTransformComponent)
 		{
-            std::shared_ptr<TransformComponent> pTransformComponent(
-				pGameActor->GetComponent<TransformComponent>(TransformComponent::Name).lock());
-            if (pTransformComponent)
-            {
-				Transform actorTransform = 
-					btTransformToTransform(actorCollisionObject->getWorldTransform());
-
-			    if (pTransformComponent->GetTransform().GetMatrix() != actorTransform.GetMatrix() ||
-					pTransformComponent->GetTransform().GetTranslation() != actorTransform.GetTranslation())
-                {
-                    // Bullet has moved the actor's physics object. Sync and inform
-					// about game actor transform 
-					//pTransformComponent->SetTransform(actorTransform);
-/*
-					LogInformation("x = " + std::to_string(actorTransform.GetTranslation()[0]) +
-									" y = " + std::to_string(actorTransform.GetTranslation()[1]) +
-									" z = " + std::to_string(actorTransform.GetTranslation()[2]));
-*/
-                    std::shared_ptr<EventDataSyncActor> pEvent(new EventDataSyncActor(id, actorTransform));
-                    BaseEventManager::Get()->TriggerEvent(pEvent);
-			    }
-            }
+			Transform actorTransform = 
+				btTransformToTransform(syncObject.mCollisionObject->getWorldTransform());
+
+			if (pTransformComponent->GetTransform().GetMatrix() != actorTransform.GetMatrix() ||
+				pTransformComponent->GetTransform().GetTranslation() != actorTransform.GetTranslation())
+			{
+				// Bullet has moved the actor's physics object. Sync and inform
+				// about game actor transform 
+				std::shared_ptr<EventDataSyncActor> pEvent = MakeEvent<EventDataSyncActor>(id, actorTransform);
+				BaseEventManager::Get()->TriggerEvent(pEvent);
+			}
 		}
 	}
+	mSyncActors.clear();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// BulletPhysics::AddSyncObject					- not described in the book
+//
+//    Registers an actor body to be synced with the game. The body is checked on the 
+//    next sync and then only after it moves.
+//
+void BulletPhysics::AddSyncObject(std::shared_ptr<Actor> pGameActor, btCollisionObject* collisionObject)
+{
+	ActorId id = pGameActor->GetId();
+	SyncObject& syncObject = mActorIdToSyncObject[id];
+	syncObject.mCollisionObject = collisionObject;
+	syncObject.mTransformComponent = pGameActor->GetComponent<TransformComponent>(TransformComponent::Name);
+	syncObject.mMoved = false;
+	MarkMoved(id, &syncObject);
+
+	// all the actor rigid bodies are created with an ActorMotionState
+	if (btRigidBody* const body = btRigidBody::upcast(collisionObject))
+	{
+		ActorMotionState* const motionState = static_cast<ActorMotionState*>(body->getMotionState());
+		motionState->mPhysics = this;
+		motionState->mActorId = id;
+		motionState->mSyncObject = &syncObject;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// BulletPhysics::MarkMoved						- not described in the book
+//
+//    Queues an actor body to be checked on the next sync
+//
+void BulletPhysics::MarkMoved(ActorId id, SyncObject* syncObject)
+{
+	if (!syncObject->mMoved)
+	{
+		syncObject->mMoved = true;
+		mMovedActors.push_back(id);
+	}
+}
+
+void BulletPhysics::MarkMoved(ActorId id)
+{
+	ActorIDToSyncObjectMap::iterator found = mActorIdToSyncObject.find(id);
+	if (found != mActorIdToSyncObject.end())
+		MarkMoved(id, &found->second);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -788,6 +843,7 @@ void BulletPhysics::AddShape(std::shared_ptr<Actor> pGameActor, btCollisionShape
 	// add it to the collection to be checked for changes in SyncVisibleScene
 	mActorIdToCollisionObject[actorID] = body;
 	mCollisionObjectToActorId[body] = actorID;
+	AddSyncObject(pGameActor, body);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -925,6 +981,7 @@ void BulletPhysics::AddTrigger(const Vector3<float> &dimension,
 
 	mActorIdToCollisionObject[pStrongActor->GetId()] = body;
 	mCollisionObjectToActorId[body] = pStrongActor->GetId();
+	AddSyncObject(pStrongActor, body);
 }
 
 
@@ -1011,6 +1068,7 @@ void BulletPhysics::AddCharacterController(
 	mActorIdToAction[actorID] = controller;
 	mActorIdToCollisionObject[actorID] = ghostObject;
 	mCollisionObjectToActorId[ghostObject] = actorID;
+	AddSyncObject(pStrongActor, ghostObject);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -1137,6 +1195,7 @@ void BulletPhysics::AddConvexVertices(Plane3<float>* planes, int numPlanes, cons
 	// add it to the collection to be checked for changes in SyncVisibleScene
 	mActorIdToCollisionObject[pStrongActor->GetId()] = body;
 	mCollisionObjectToActorId[body] = pStrongActor->GetId();
+	AddSyncObject(pStrongActor, body);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -1223,6 +1282,7 @@ void BulletPhysics::RemoveActor(ActorId id)
 		RemoveCollisionObject(collisionObject);
 		mActorIdToCollisionObject.erase ( id );
 		mCollisionObjectToActorId.erase(collisionObject);
+		mActorIdToSyncObject.erase(id);
 	}
 }
 
@@ -1308,6 +1368,7 @@ void BulletPhysics::SetTransform(ActorId actorId, const Transform& trans)
 	{
 		// warp the body to the new position
 		collisionObject->setWorldTransform(TransformTobtTransform(trans));
+		MarkMoved(actorId);
 	}
 }
 
@@ -1832,6 +1893,7 @@ void BulletPhysics::Translate(ActorId actorId, const Vector3<float>& vec)
 	{
 		btVector3 btVec = Vector3TobtVector3(vec);
 		rigidBody->translate(btVec);
+		MarkMoved(actorId);
 	}
 }
 
@@ -1902,6 +1964,7 @@ void BulletPhysics::SetPosition(ActorId actorId, const Vector3<float>& pos)
 		btTransform transform = collisionObject->getWorldTransform();
 		transform.setOrigin(Vector3TobtVector3(pos));
 		collisionObject->setWorldTransform(transform);
+		MarkMoved(actorId);
 	}
 }
 
@@ -1914,6 +1977,7 @@ void BulletPhysics::SetRotation(ActorId actorId, const Transform& trans)
 		btTransform transform = TransformTobtTransform(trans);
 		transform.setOrigin(collisionObject->getWorldTransform().getOrigin());
 		collisionObject->setWorldTransform(transform);
+		MarkMoved(actorId);
 	}
 }
 
@@ -2045,8 +2109,8 @@ void BulletPhysics::SendCollisionPairAddEvent( btPersistentManifold const * mani
 		}
 		
 		// send the event for the game
-        std::shared_ptr<EventDataPhysCollision> pEvent(
-			new EventDataPhysCollision(id0, id1, sumNormalForce, sumFrictionForce, collisionPoints));
+        std::shared_ptr<EventDataPhysCollision> pEvent = MakeEvent<EventDataPhysCollision>(
+			id0, id1, sumNormalForce, sumFrictionForce, collisionPoints);
 		BaseEventManager::Get()->TriggerEvent(pEvent);
 	}
 }
@@ -2089,7 +2153,7 @@ void BulletPhysics::SendCollisionPairRemoveEvent(
 			return;
 		}
 
-        std::shared_ptr<EventDataPhysSeparation> pEvent(new EventDataPhysSeparation(id0, id1));
+        std::shared_ptr<EventDataPhysSeparation> pEvent = MakeEvent<EventDataPhysSeparation>(id0, id1);
 		BaseEventManager::Get()->TriggerEvent(pEvent);
 	}
 }
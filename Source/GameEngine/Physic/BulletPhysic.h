@@ -58,6 +58,7 @@
 
 // forward declaration
 class BspToBulletConverter;
+class TransformComponent;
 
 /////////////////////////////////////////////////////////////////////////////
 // BulletPhysics								- Chapter 17, page 590
@@ -69,6 +70,7 @@ class BspToBulletConverter;
 class BulletPhysics : public BaseGamePhysic
 {
 	friend class BspToBulletConverter;
+	friend struct ActorMotionState;
 
 public:
 
@@ -199,6 +201,24 @@ protected:
 	BulletCollisionObjectToActorIDMap mCollisionObjectToActorId;
 	ActorId FindActorID(btCollisionObject const*) const;
 
+	// the actor bodies which are synced with the game. The actor's transform component is 
+	//   cached and a body is only queued for SyncVisibleScene when its motion state or one 
+	//   of the transform setters moves it, so the bodies at rest are never visited.
+	struct SyncObject
+	{
+		btCollisionObject* mCollisionObject;
+		std::weak_ptr<TransformComponent> mTransformComponent;
+		bool mMoved;
+	};
+	typedef std::map<ActorId, SyncObject> ActorIDToSyncObjectMap;
+	ActorIDToSyncObjectMap mActorIdToSyncObject;
+	std::vector<ActorId> mMovedActors;
+	std::vector<ActorId> mSyncActors;
+
+	void AddSyncObject(std::shared_ptr<Actor> pGameActor, btCollisionObject* collisionObject);
+	void MarkMoved(ActorId id, SyncObject* syncObject);
+	void MarkMoved(ActorId id);
+
 	// data used to store which collision pair (bodies that are touching) need
 	//   Collision events sent.  When a new pair of touching bodies are detected,
 	//   they are added to mPreviousTickCollisionPairs and an event is sent.
@@ -683,6 +683,7 @@ bool PhysX::Initialize()
 	sceneDesc.gravity = Vector3ToPxVector3(Settings::Get()->GetVector3("default_gravity"));
 	sceneDesc.cpuDispatcher = mDispatcher;
 	sceneDesc.flags |= PxSceneFlag::eENABLE_CCD;
+	sceneDesc.flags |= PxSceneFlag::eENABLE_ACTIVE_ACTORS;
 	sceneDesc.filterShader = SimulationFilterShader;
 	sceneDesc.simulationEventCallback = new ContactReportCallback(this);
 	mScene = mPhysicsSystem->createScene(sceneDesc);
@@ -723,40 +724,86 @@ void PhysX::SyncVisibleScene()
 {
 	// Keep physics & graphics in sync
 
-	// check all the existing actor's collision object for changes. 
+	// the scene reports the actors its last simulation has moved
+	PxU32 numActiveActors = 0;
+	PxActor** activeActors = mScene->getActiveActors(numActiveActors);
+	for (PxU32 i = 0; i < numActiveActors; ++i)
+	{
+		ActorId id = FindActorID(static_cast<PxRigidActor*>(activeActors[i]));
+		if (id != INVALID_ACTOR_ID)
+			MarkMoved(id);
+	}
+
+	// character controllers are moved outside of the simulation
+	for (ActorIDToPhysXControllerMap::const_iterator it = mActorIdToController.begin(); it != mActorIdToController.end(); ++it)
+		MarkMoved(it->first);
+
+	// check the collision objects moved since the last sync for changes. 
 	//  If there is a change, send the appropriate event for the game system.
-	for (ActorIDToPhysXCollisionObjectMap::const_iterator it = mActorIdToCollisionObject.begin();
-		it != mActorIdToCollisionObject.end(); ++it)
+	mSyncActors.swap(mMovedActors);
+	for (ActorId const id : mSyncActors)
 	{
-		ActorId const id = it->first;
-		PxRigidActor* actorCollisionObject = it->second;
+		// the actor might have been removed since it moved
+		ActorIDToSyncObjectMap::iterator itSync = mActorIdToSyncObject.find(id);
+		if (itSync == mActorIdToSyncObject.end())
+			continue;
 
-		std::shared_ptr<Actor> pGameActor(GameLogic::Get()->GetActor(id).lock());
-		if (pGameActor)
+		SyncObject& syncObject = itSync->second;
+		syncObject.mMoved = false;
+
+		std::shared_ptr<TransformComponent> pTransformComponent(syncObject.mTransformComponent.lock());
+		if (pTransformComponent)
 		{
-			std::shared_ptr<TransformComponent> pTransformComponent(
-				pGameActor->GetComponent<TransformComponent>(TransformComponent::Name).lock());
-			if (pTransformComponent)
-			{
-				Transform actorTransform = PxTransformToTransform(actorCollisionObject->getGlobalPose());
+			Transform actorTransform = PxTransformToTransform(syncObject.mCollisionObject->getGlobalPose());
 
-				if (pTransformComponent->GetTransform().GetMatrix() != actorTransform.GetMatrix() ||
-					pTransformComponent->GetTransform().GetTranslation() != actorTransform.GetTranslation())
-				{
-					// Bullet has moved the actor's physics object. Sync and inform
-					// about game actor transform 
-					//pTransformComponent->SetTransform(actorTransform);
-/*
-					LogInformation("x = " + std::to_string(actorTransform.GetTranslation()[0]) +
-									" y = " + std::to_string(actorTransform.GetTranslation()[1]) +
-									" z = " + std::to_string(actorTransform.GetTranslation()[2]));
-*/
-					std::shared_ptr<EventDataSyncActor> pEvent(new EventDataSyncActor(id, actorTransform));
-					BaseEventManager::Get()->TriggerEvent(pEvent);
-				}
+			if (pTransformComponent->GetTransform().GetMatrix() != actorTransform.GetMatrix() ||
+				pTransformComponent->GetTransform().GetTranslation() != actorTransform.GetTranslation())
+			{
+				// PhysX has moved the actor's physics object. Sync and inform
+				// about game actor transform 
+				std::shared_ptr<EventDataSyncActor> pEvent = MakeEvent<EventDataSyncActor>(id, actorTransform);
+				BaseEventManager::Get()->TriggerEvent(pEvent);
 			}
 		}
 	}
+	mSyncActors.clear();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// PhysX::AddSyncObject
+//
+//    Registers an actor to be synced with the game. The actor is checked on the 
+//    next sync and then only after it moves.
+//
+void PhysX::AddSyncObject(std::shared_ptr<Actor> pGameActor, PxRigidActor* collisionObject)
+{
+	ActorId id = pGameActor->GetId();
+	SyncObject& syncObject = mActorIdToSyncObject[id];
+	syncObject.mCollisionObject = collisionObject;
+	syncObject.mTransformComponent = pGameActor->GetComponent<TransformComponent>(TransformComponent::Name);
+	syncObject.mMoved = false;
+	MarkMoved(id, &syncObject);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// PhysX::MarkMoved
+//
+//    Queues an actor to be checked on the next sync
+//
+void PhysX::MarkMoved(ActorId id, SyncObject* syncObject)
+{
+	if (!syncObject->mMoved)
+	{
+		syncObject->mMoved = true;
+		mMovedActors.push_back(id);
+	}
+}
+
+void PhysX::MarkMoved(ActorId id)
+{
+	ActorIDToSyncObjectMap::iterator found = mActorIdToSyncObject.find(id);
+	if (found != mActorIdToSyncObject.end())
+		MarkMoved(id, &found->second);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -811,6 +858,7 @@ void PhysX::AddShape(std::shared_ptr<Actor> pGameActor, PxGeometry& geometry,
 	// add it to the collection to be checked for changes in SyncVisibleScene
 	mActorIdToCollisionObject[actorID] = rigidDynamic;
 	mCollisionObjectToActorId[rigidDynamic] = actorID;
+	AddSyncObject(pGameActor, rigidDynamic);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -897,6 +945,7 @@ void PhysX::AddTrigger(const Vector3<float> &dimension,
 
 	mActorIdToCollisionObject[pStrongActor->GetId()] = rigidStatic;
 	mCollisionObjectToActorId[rigidStatic] = pStrongActor->GetId();
+	AddSyncObject(pStrongActor, rigidStatic);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -967,6 +1016,7 @@ void PhysX::AddCharacterController(
 	mActorIdToController[actorID] = controller;
 	mActorIdToCollisionObject[actorID] = controller->getActor();
 	mCollisionObjectToActorId[controller->getActor()] = actorID;
+	AddSyncObject(pStrongActor, controller->getActor());
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -1086,6 +1136,7 @@ void PhysX::AddConvexVertices(Plane3<float>* planes, int numPlanes, const Vector
 	// add it to the collection to be checked for changes in SyncVisibleScene
 	mActorIdToCollisionObject[pStrongActor->GetId()] = rigidStatic;
 	mCollisionObjectToActorId[rigidStatic] = pStrongActor->GetId();
+	AddSyncObject(pStrongActor, rigidStatic);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -1161,6 +1212,7 @@ void PhysX::AddPointCloud(Vector3<float> *verts, int numPoints, std::weak_ptr<Ac
 	// add it to the collection to be checked for changes in SyncVisibleScene
 	mActorIdToCollisionObject[pStrongActor->GetId()] = rigidDynamic;
 	mCollisionObjectToActorId[rigidDynamic] = pStrongActor->GetId();
+	AddSyncObject(pStrongActor, rigidDynamic);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -1245,6 +1297,7 @@ void PhysX::AddPointCloud(Plane3<float> *planes, int numPlanes, std::weak_ptr<Ac
 	// add it to the collection to be checked for changes in SyncVisibleScene
 	mActorIdToCollisionObject[pStrongActor->GetId()] = rigidDynamic;
 	mCollisionObjectToActorId[rigidDynamic] = pStrongActor->GetId();
+	AddSyncObject(pStrongActor, rigidDynamic);
 }
 
 
@@ -1261,6 +1314,7 @@ void PhysX::RemoveActor(ActorId id)
 		RemoveCollisionObject(collisionObject);
 		mActorIdToCollisionObject.erase(id);
 		mCollisionObjectToActorId.erase(collisionObject);
+		mActorIdToSyncObject.erase(id);
 	}
 }
 
@@ -1347,6 +1401,7 @@ void PhysX::SetTransform(ActorId actorId, const Transform& trans)
 		// warp the body to the new position
 		PxTransform transform = TransformToPxTransform(trans);
 		collisionObject->setGlobalPose(transform);
+		MarkMoved(actorId);
 	}
 }
 
@@ -1973,6 +2028,7 @@ void PhysX::SetPosition(ActorId actorId, const Vector3<float>& pos)
 		PxTransform transform = collisionObject->getGlobalPose();
 		transform.p = Vector3ToPxVector3(pos);
 		collisionObject->setGlobalPose(transform);
+		MarkMoved(actorId);
 	}
 }
 
@@ -1985,6 +2041,7 @@ void PhysX::SetRotation(ActorId actorId, const Transform& trans)
 		PxTransform transform = TransformToPxTransform(trans);
 		transform.p = collisionObject->getGlobalPose().p;
 		collisionObject->setGlobalPose(transform);
+		MarkMoved(actorId);
 	}
 }
 
@@ -2156,7 +2213,7 @@ void PhysX::SendCollisionPairRemoveEvent(
 		return;
 	}
 
-	std::shared_ptr<EventDataPhysSeparation> pEvent(new EventDataPhysSeparation(id0, id1));
+	std::shared_ptr<EventDataPhysSeparation> pEvent = MakeEvent<EventDataPhysSeparation>(id0, id1);
 	BaseEventManager::Get()->TriggerEvent(pEvent);
 }
 
@@ -2186,8 +2243,8 @@ void PhysX::SendCollisionPairAddEvent(const PxContactPair& pair)
 		collisionPoints.push_back(PxVector3ToVector3(contactPoints[pointIdx].position));
 
 	// send the event for the game
-	std::shared_ptr<EventDataPhysCollision> pEvent(
-		new EventDataPhysCollision(id0, id1, sumNormalForce, sumFrictionForce, collisionPoints));
+	std::shared_ptr<EventDataPhysCollision> pEvent = MakeEvent<EventDataPhysCollision>(
+		id0, id1, sumNormalForce, sumFrictionForce, collisionPoints);
 	BaseEventManager::Get()->TriggerEvent(pEvent);
 }
 
@@ -55,6 +55,7 @@ using namespace physx;
 // forward declaration
 class PhysX;
 class BspToPhysXConverter;
+class TransformComponent;
 
 class ContactReportCallback : public PxSimulationEventCallback
 {
@@ -235,6 +236,24 @@ protected:
 	PhysXCollisionObjectToActorIDMap mCollisionObjectToActorId;
 	ActorId FindActorID(PxRigidActor const*) const;
 
+	// the actors which are synced with the game. The actor's transform component is cached
+	//   and an actor is only queued for SyncVisibleScene when the scene reports it as active
+	//   or one of the transform setters moves it, so the actors at rest are never visited.
+	struct SyncObject
+	{
+		PxRigidActor* mCollisionObject;
+		std::weak_ptr<TransformComponent> mTransformComponent;
+		bool mMoved;
+	};
+	typedef std::map<ActorId, SyncObject> ActorIDToSyncObjectMap;
+	ActorIDToSyncObjectMap mActorIdToSyncObject;
+	std::vector<ActorId> mMovedActors;
+	std::vector<ActorId> mSyncActors;
+
+	void AddSyncObject(std::shared_ptr<Actor> pGameActor, PxRigidActor* collisionObject);
+	void MarkMoved(ActorId id, SyncObject* syncObject);
+	void MarkMoved(ActorId id);
+
 	// helpers for sending events relating to trigger pairs
 	void SendTriggerPairAddEvent(const PxTriggerPair& pair);
 	void SendTriggerPairRemoveEvent(PxRigidActor const* body0, PxRigidActor const* body1);
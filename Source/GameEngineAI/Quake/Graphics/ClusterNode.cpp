@@ -278,17 +278,9 @@ bool ClusterNode::Render(Scene* pScene)
 			if (GetMaterial(i)->Update(mRasterizerState))
 				Renderer::Get()->Unbind(mRasterizerState);
 
-			Renderer::Get()->SetBlendState(mBlendState);
-			Renderer::Get()->SetDepthStencilState(mDepthStencilState);
-			Renderer::Get()->SetRasterizerState(mRasterizerState);
-
-			Renderer* renderer = Renderer::Get();
-			renderer->Update(mVisual->GetVertexBuffer());
-			renderer->Draw(mVisual);
-
-			Renderer::Get()->SetDefaultBlendState();
-			Renderer::Get()->SetDefaultDepthStencilState();
-			Renderer::Get()->SetDefaultRasterizerState();
+			Renderer::Get()->Update(mVisual->GetVertexBuffer());
+			pScene->GetRenderQueue()->Add(mVisual, mBlendState, mDepthStencilState, mRasterizerState,
+				pScene->GetCameraDepth(this), 0, transparent);
 		}
 	}
 
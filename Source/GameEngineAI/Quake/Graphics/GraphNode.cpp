@@ -24,7 +24,6 @@ GraphNode::GraphNode(const ActorId actorId, PVWUpdater* updater,
 {
 	mPVWUpdater = updater;
 
-	mRasterizerState = std::make_shared<RasterizerState>();
 
 	const ClusterMap& clusters = pathingGraph->GetClusters();
 	for (ClusterMap::const_iterator it = clusters.begin(); it != clusters.end(); ++it)
@@ -54,6 +53,7 @@ void GraphNode::GenerateMesh(
 	mVisuals.clear();
 	mBlendStates.clear();
 	mDepthStencilStates.clear();
+	mRasterizerStates.clear();
 
 	VertexFormat vformat;
 	vformat.Bind(VA_POSITION, DF_R32G32B32_FLOAT, 0);
@@ -123,6 +123,7 @@ void GraphNode::GenerateMesh(
 
 		mBlendStates.push_back(std::make_shared<BlendState>());
 		mDepthStencilStates.push_back(std::make_shared<DepthStencilState>());
+		mRasterizerStates.push_back(std::make_shared<RasterizerState>());
 
 		std::vector<std::string> path;
 #if defined(_OPENGL_)
@@ -161,6 +162,7 @@ void GraphNode::GenerateMesh(
 	mVisuals.clear();
 	mBlendStates.clear();
 	mDepthStencilStates.clear();
+	mRasterizerStates.clear();
 
 	VertexFormat vformat;
 	vformat.Bind(VA_POSITION, DF_R32G32B32_FLOAT, 0);
@@ -230,6 +232,7 @@ void GraphNode::GenerateMesh(
 
 		mBlendStates.push_back(std::make_shared<BlendState>());
 		mDepthStencilStates.push_back(std::make_shared<DepthStencilState>());
+		mRasterizerStates.push_back(std::make_shared<RasterizerState>());
 
 		std::vector<std::string> path;
 #if defined(_OPENGL_)
@@ -435,18 +438,11 @@ bool GraphNode::Render(Scene* pScene)
 				Renderer::Get()->Unbind(mBlendStates[i]);
 			if (mMesh->GetMeshBuffer(i)->GetMaterial()->Update(mDepthStencilStates[i]))
 				Renderer::Get()->Unbind(mDepthStencilStates[i]);
-			if (mMesh->GetMeshBuffer(i)->GetMaterial()->Update(mRasterizerState))
-				Renderer::Get()->Unbind(mRasterizerState);
+			if (mMesh->GetMeshBuffer(i)->GetMaterial()->Update(mRasterizerStates[i]))
+				Renderer::Get()->Unbind(mRasterizerStates[i]);
 
-			Renderer::Get()->SetBlendState(mBlendStates[i]);
-			Renderer::Get()->SetDepthStencilState(mDepthStencilStates[i]);
-			Renderer::Get()->SetRasterizerState(mRasterizerState);
-
-			Renderer::Get()->Draw(mVisuals[i]);
-
-			Renderer::Get()->SetDefaultBlendState();
-			Renderer::Get()->SetDefaultDepthStencilState();
-			Renderer::Get()->SetDefaultRasterizerState();
+			pScene->GetRenderQueue()->Add(mVisuals[i], mBlendStates[i], mDepthStencilStates[i],
+				mRasterizerStates[i], pScene->GetCameraDepth(this), 0, transparent);
 		}
 	}
 
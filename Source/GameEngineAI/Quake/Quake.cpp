@@ -35,8 +35,7 @@
 #include "Games/Actors/LocationTarget.h"
 #include "Games/Actors/SpeakerTarget.h"
 
-#include <ppl.h>
-#include <ppltasks.h>
+#include <thread>
 
 #define	MAX_SPAWN_POINTS 128
 #define	DEFAULT_SHOTGUN_DAMAGE 10
@@ -533,6 +532,14 @@ QuakeLogic::~QuakeLogic()
 	delete mChatBackend;
 
 	// Stop threads
+	QuakeAIManager* aiManager = dynamic_cast<QuakeAIManager*>(mAIManager);
+	if (aiManager)
+		aiManager->StopDecisionMaking();
+	for (std::thread& gameAIThread : mGameAIThreads)
+		gameAIThread.join();
+	if (mSaveAIGameThread.joinable())
+		mSaveAIGameThread.join();
+
 	if (mThread)
 	{
 		Stop();
@@ -1998,33 +2005,21 @@ void QuakeLogic::SimulateAIGameDelegate(BaseEventDataPtr pEventData)
 		for (std::shared_ptr<PlayerActor> playerActor : playerActors)
 			aiManager->SpawnActor(playerActor->GetId());
 
-		Concurrency::create_task([&]
-		{
-			//guessing decision making
-			QuakeAIManager* aiManager = dynamic_cast<QuakeAIManager*>(mAIManager);
-			aiManager->RunAIGuessing();
-		});
+		// the decision making loops run for the whole game, so they get their own threads
+		// instead of holding workers of the task scheduler. They are joined on destruction
+		aiManager->StartDecisionMaking();
 
-		Concurrency::create_task([&]
-		{
-			//aware decision making
-			QuakeAIManager* aiManager = dynamic_cast<QuakeAIManager*>(mAIManager);
-			aiManager->RunAIAwareDecision();
-		});
+		//guessing decision making
+		mGameAIThreads.emplace_back([aiManager] { aiManager->RunAIGuessing(); });
 
-		Concurrency::create_task([&]
-		{
-			//guessing decision making
-			QuakeAIManager* aiManager = dynamic_cast<QuakeAIManager*>(mAIManager);
-			aiManager->RunHumanGuessing();
-		});
+		//aware decision making
+		mGameAIThreads.emplace_back([aiManager] { aiManager->RunAIAwareDecision(); });
 
-		Concurrency::create_task([&]
-		{
-			//aware decision making
-			QuakeAIManager* aiManager = dynamic_cast<QuakeAIManager*>(mAIManager);
-			aiManager->RunHumanAwareDecision();
-		});
+		//guessing decision making
+		mGameAIThreads.emplace_back([aiManager] { aiManager->RunHumanGuessing(); });
+
+		//aware decision making
+		mGameAIThreads.emplace_back([aiManager] { aiManager->RunHumanAwareDecision(); });
 
 		mGameAICombat = true;
 	}
@@ -2626,11 +2621,12 @@ void QuakeLogic::SaveAIGameDelegate(BaseEventDataPtr pEventData)
 	std::shared_ptr<EventDataSaveAIGame> pCastEventData =
 		std::static_pointer_cast<EventDataSaveAIGame>(pEventData);
 
-	Concurrency::create_task([&]
-	{
-		QuakeAIManager* aiManager = dynamic_cast<QuakeAIManager*>(mAIManager);
-		aiManager->SaveGameAnalysis();
-	});
+	// only one analysis is saved at a time
+	if (mSaveAIGameThread.joinable())
+		mSaveAIGameThread.join();
+
+	QuakeAIManager* aiManager = dynamic_cast<QuakeAIManager*>(mAIManager);
+	mSaveAIGameThread = std::thread([aiManager] { aiManager->SaveGameAnalysis(); });
 }
 
 void QuakeLogic::SaveAllDelegate(BaseEventDataPtr pEventData)
@@ -3232,9 +3228,11 @@ void QuakeLogic::CreateNetworkEventForwarder(const int socketId)
 	pGlobalEventManager->AddListener(
 		MakeDelegate(pNetworkEventForwarder, &NetworkEventForwarder::ForwardEvent),
 		EventDataNewActor::skEventType);
-	pGlobalEventManager->AddListener(
-		MakeDelegate(pNetworkEventForwarder, &NetworkEventForwarder::ForwardEvent),
-		EventDataSyncActor::skEventType);
+	// actor transforms are replicated through the network view snapshots when enabled
+	if (!NetworkGameView::IsSnapshotReplicationEnabled())
+		pGlobalEventManager->AddListener(
+			MakeDelegate(pNetworkEventForwarder, &NetworkEventForwarder::ForwardEvent),
+			EventDataSyncActor::skEventType);
 	pGlobalEventManager->AddListener(
 		MakeDelegate(pNetworkEventForwarder, &NetworkEventForwarder::ForwardEvent),
 		EventDataRequestNewActor::skEventType);
@@ -3579,14 +3577,28 @@ void QuakeLogic::LoadActors(BspLoader& bspLoader)
 	triggerResources["trigger_push"] = "actors/quake/trigger/push.xml";
 
 	std::map<std::string, BSPEntity> targets;
+	std::set<std::string> actorResources;
 	for (int i = 0; i < bspLoader.mNumEntities; i++)
 	{
 		const BSPEntity& entity = bspLoader.mEntities[i];
 		std::string target = bspLoader.GetValueForKey(&entity, "targetname");
 		if (!target.empty())
 			targets[target] = entity;
+
+		std::string className = bspLoader.GetValueForKey(&entity, "classname");
+		if (modelResources.find(className) != modelResources.end())
+			actorResources.insert(modelResources[className]);
+		else if (targetResources.find(className) != targetResources.end())
+			actorResources.insert(targetResources[className]);
+		else if (triggerResources.find(className) != triggerResources.end())
+			actorResources.insert(triggerResources[className]);
 	}
 
+	// the models of the map load on the loader threads while the actors are created
+	std::vector<ResHandleFuture> resourceRequests;
+	for (std::string const& actorResource : actorResources)
+		mActorFactory->RequestResources(ToWideString(actorResource).c_str(), nullptr, resourceRequests);
+
 	for (int i = 0; i < bspLoader.mNumEntities; i++)
 	{
 		const BSPEntity& entity = bspLoader.mEntities[i];
@@ -3888,6 +3900,13 @@ bool QuakeLogic::LoadGameAsync(tinyxml2::XMLElement* pRoot)
 	tinyxml2::XMLElement* pActorsNode = pRoot->FirstChildElement("StaticActors");
 	if (pActorsNode)
 	{
+		unsigned int loadTime = Timer::GetRealTime();
+
+		// the resources load on the loader threads while the actors are created, the level
+		// mesh and its physics mesh no longer load one after the other
+		std::vector<ResHandleFuture> resourceRequests;
+		RequestActorResources(pActorsNode, resourceRequests);
+
 		tinyxml2::XMLElement* pNode = pActorsNode->FirstChildElement();
 		for (; pNode; pNode = pNode->NextSiblingElement())
 		{
@@ -3919,6 +3938,11 @@ bool QuakeLogic::LoadGameAsync(tinyxml2::XMLElement* pRoot)
 				}
 			}
 		}
+
+		ResCacheStats resCacheStats = ResCache::Get()->GetStats();
+		LogInformation("Static actors loaded in " + std::to_string(Timer::GetRealTime() - loadTime) + 
+			" ms, resource cache hits " + std::to_string(resCacheStats.mHits) + 
+			" misses " + std::to_string(resCacheStats.mMisses));
 	}
 
 	// Send media
@@ -538,6 +538,8 @@ private:
 
 	bool mGameInit = false;
 	bool mGameAICombat = false;
+	std::vector<std::thread> mGameAIThreads;
+	std::thread mSaveAIGameThread;
 	bool mGameAISimulation = false;
 	AIGame::GameState mGameAIState;
 
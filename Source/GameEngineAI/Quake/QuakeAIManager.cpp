@@ -8,12 +8,15 @@
 
 #include "Core/OS/OS.h"
 #include "Core/Logger/Logger.h"
+#include "Core/Utility/Profiler.h"
 
 #include "Core/IO/XmlResource.h"
 
 #include "Core/Event/EventManager.h"
 #include "Core/Event/Event.h"
 
+#include "AI/PathingGraphFile.h"
+
 #include "Physic/PhysicEventListener.h"
 
 #include "Games/Actors/LocationTarget.h"
@@ -139,10 +142,10 @@ AIFinder::~AIFinder(void)
 void AIFinder::Destroy(void)
 {
 	// destroy all the AIPlanNode objects and clear the map
-	Concurrency::parallel_for_each(mNodes.begin(), mNodes.end(), [&](auto& plan)
+	ParallelForEach(mNodes.begin(), mNodes.end(), [&](auto& plan)
 	//for (ActorToAIPlanNodeMap::iterator it = mNodes.begin(); it != mNodes.end(); ++it)
 	{
-		Concurrency::parallel_for_each(plan.second.begin(), plan.second.end(), [&](auto& planNode)
+		ParallelForEach(plan.second.begin(), plan.second.end(), [&](auto& planNode)
 		//for (AIPlanNodeVector::iterator itPlan = (*it).second.begin(); itPlan != (*it).second.end(); itPlan++)
 		{
 			delete planNode;
@@ -169,8 +172,8 @@ void AIFinder::operator()(
 	while (!mOpenSet.empty())
 	{
 		// grab the most likely candidate
-		AIPlanNode* planNode;
-		mOpenSet.try_pop(planNode);
+		AIPlanNode* planNode = mOpenSet.front();
+		mOpenSet.pop_front();
 
 		if (planNode->GetPathingActor())
 		{
@@ -202,11 +205,17 @@ void AIFinder::operator()(
 		const PathingActorMap& neighbors = planNode->GetPathingActor() ?
 			planNode->GetPathingActor()->GetTarget()->GetActors() : planNode->GetPathingNode()->GetActors();
 
-		// loop though all the neighboring actors and evaluate each one
-		Concurrency::parallel_for_each(neighbors.begin(), neighbors.end(), [&](auto& neighbor)
-		//for (auto it = neighbors.begin(); it != neighbors.end(); ++it)
+		// loop though all the neighboring actors and evaluate each one. The accepted actors are
+		// added to the open set afterwards on this thread, the open set is not thread safe
+		PathingActorVec actorsToEvaluate;
+		for (auto const& neighbor : neighbors)
+			actorsToEvaluate.push_back(neighbor.second);
+
+		std::vector<PathingNode*> candidateNodes(actorsToEvaluate.size(), NULL);
+		ParallelFor(size_t(0), actorsToEvaluate.size(), [&](size_t neighbor)
+		//for (size_t neighbor = 0; neighbor < actorsToEvaluate.size(); ++neighbor)
 		{
-			PathingActor* pActorToEvaluate = neighbor.second;
+			PathingActor* pActorToEvaluate = actorsToEvaluate[neighbor];
 			if (pActorToEvaluate->GetType() != pathingType)
 				return;
 
@@ -224,10 +233,14 @@ void AIFinder::operator()(
 				if (costForThisPlan > costForActorPlan)
 					return;
 
-				AddToOpenSet(planNode->GetPathingActor()->GetTarget(), pActorToEvaluate, planNode);
+				candidateNodes[neighbor] = planNode->GetPathingActor()->GetTarget();
 			}
-			else AddToOpenSet(planNode->GetPathingNode(), pActorToEvaluate, planNode);
+			else candidateNodes[neighbor] = planNode->GetPathingNode();
 		});
+
+		for (size_t neighbor = 0; neighbor < actorsToEvaluate.size(); ++neighbor)
+			if (candidateNodes[neighbor])
+				AddToOpenSet(candidateNodes[neighbor], actorsToEvaluate[neighbor], planNode);
 	}
 	/*
 	QuakeAIManager* aiManager = dynamic_cast<QuakeAIManager*>(GameLogic::Get()->GetAIManager());
@@ -290,7 +303,7 @@ void AIFinder::AddToOpenSet(PathingNode* pNode, PathingActor* pActor, AIPlanNode
 		mNodes[pNode->GetActorId()].push_back(pThisNode);
 
 	// now insert it into the priority queue
-	mOpenSet.push(pThisNode);
+	mOpenSet.push_back(pThisNode);
 }
 
 void AIFinder::AddToClosedSet(AIPlanNode* pNode)
@@ -320,6 +333,7 @@ PathingActorVec AIFinder::RebuildPath(AIPlanNode* pGoalNode)
 QuakeAIManager::QuakeAIManager() : AIManager()
 {
 	mEnable = false;
+	mDecisionMaking = false;
 
 	mGameSimulation = nullptr;
 
@@ -481,12 +495,19 @@ void QuakeAIManager::SaveGameAnalysis()
 	}
 }
 
+// the memory mapped graph file is stored next to the graph archive
+static std::wstring GetGraphFilePath(const std::wstring& path)
+{
+	return path.substr(0, path.find_last_of(L'.')) + L".graph";
+}
+
 void QuakeAIManager::SaveGraph(const std::string& path)
 {
 	//set data
 	AIMap::Graph data;
 
-	const PathingNodeMap& pathingNodes = mPathingGraph->GetNodes();
+	std::shared_ptr<PathingGraph> graph = GetPathingGraph();
+	const PathingNodeMap& pathingNodes = graph->GetNodes();
 	for (PathingNodeMap::const_iterator it = pathingNodes.begin(); it != pathingNodes.end(); ++it)
 	{
 		PathingNode* pathNode = (*it).second;
@@ -563,7 +584,7 @@ void QuakeAIManager::SaveGraph(const std::string& path)
 		data.nodes.push_back(node);
 	}
 
-	const ClusterMap& clusters = mPathingGraph->GetClusters();
+	const ClusterMap& clusters = graph->GetClusters();
 	for (ClusterMap::const_iterator it = clusters.begin(); it != clusters.end(); ++it)
 	{
 		Cluster* pathCluster = (*it).second;
@@ -584,9 +605,14 @@ void QuakeAIManager::SaveGraph(const std::string& path)
 		data.clusters.push_back(cluster);
 	}
 
-	std::ofstream os(path.c_str(), std::ios::binary);
-	cereal::BinaryOutputArchive archive(os);
-	archive(data);
+	{
+		std::ofstream os(path.c_str(), std::ios::binary);
+		cereal::BinaryOutputArchive archive(os);
+		archive(data);
+	}
+
+	// the archive is closed first so that the graph file is stamped with its final size
+	PathingGraphFile::Save(ToString(GetGraphFilePath(ToWideString(path))), graph.get(), ToWideString(path));
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -697,9 +723,14 @@ void QuakeAIManager::SaveGraph(const std::string& path, std::shared_ptr<PathingG
 		data.clusters.push_back(cluster);
 	}
 
-	std::ofstream os(path.c_str(), std::ios::binary);
-	cereal::BinaryOutputArchive archive(os);
-	archive(data);
+	{
+		std::ofstream os(path.c_str(), std::ios::binary);
+		cereal::BinaryOutputArchive archive(os);
+		archive(data);
+	}
+
+	// the archive is closed first so that the graph file is stamped with its final size
+	PathingGraphFile::Save(ToString(GetGraphFilePath(ToWideString(path))), graph.get(), ToWideString(path));
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -709,143 +740,85 @@ void QuakeAIManager::SaveGraph(const std::string& path, std::shared_ptr<PathingG
 //
 void QuakeAIManager::LoadGraph(const std::wstring& path, float weightConversion)
 {
-	//set data
-	AIMap::Graph data;
+	TimeTaker loadTime("LoadGraph");
 
-	std::ifstream is(path.c_str(), std::ios::binary);
-	if (is.fail())
-	{
-		LogError(strerror(errno));
+	std::shared_ptr<PathingGraph> graph = std::make_shared<PathingGraph>();
+	if (!LoadGraphFile(path, graph, weightConversion) && !LoadGraphArchive(path, graph, weightConversion))
 		return;
-	}
-	cereal::BinaryInputArchive archive(is);
-	archive(data);
-
-	mLastArcId = 0;
-	mLastNodeId = 0;
-
-	mPathingGraph = std::make_shared<PathingGraph>();
-
-	std::map<unsigned int, PathingNode*> pathingGraph;
-	for (auto const& node : data.nodes)
-	{
-		unsigned short clusterId = node.clusterid;
-		unsigned short pathNodeId = node.id;
-		ActorId actorId = node.actorid;
-		float tolerance = node.tolerance;
-		Vector3<float> position{ node.position.x, node.position.y, node.position.z };
-		if (mLastNodeId < pathNodeId) mLastNodeId = pathNodeId;
 
-		PathingNode* pathNode = new PathingNode(pathNodeId, actorId, position, tolerance);
-		pathNode->SetCluster(clusterId);
-		mPathingGraph->InsertNode(pathNode);
-
-		pathingGraph[pathNodeId] = pathNode;
-	}
-
-	for (auto const& node : data.nodes)
-	{
-		unsigned short pathNodeId = node.id;
-		PathingNode* pathNode = pathingGraph[pathNodeId];
-
-		for (AIMap::VisibleNode visibleNode : node.visibles)
-		{
-			PathingNode* visibilityNode = pathingGraph[visibleNode.id];
-			pathNode->AddVisibleNode(
-				visibilityNode, Length(visibilityNode->GetPosition() - pathNode->GetPosition()));
-			
-		}
-
-		for (auto const& arc : node.arcs)
-		{
-			unsigned int arcId = arc.id;
-			unsigned short arcType = arc.type;
-			int arcNode = arc.nodeid;
-			float arcWeight = arc.weight * weightConversion;
-			if (mLastArcId < arcId) mLastArcId = arcId;
-
-			PathingArc* pathArc = new PathingArc(arcId, arcType, pathingGraph[arcNode], arcWeight);
-			pathNode->AddArc(pathArc);
+	BakePathingGraph(graph);
+}
 
-			std::vector<float> weights;
-			std::vector<PathingNode*> nodes;
-			std::vector<Vector3<float>> positions;
-			for (auto const& nodeid : arc.nodes)
-			{
-				nodes.push_back(pathingGraph[nodeid]);
-			}
-			for (auto const& weight : arc.weights)
-			{
-				weights.push_back(weight * weightConversion);
-			}
-			for (auto const& position : arc.positions)
-			{
-				positions.push_back(Vector3<float>{(float)position.x, (float)position.y, (float)position.z});
-			}
+/////////////////////////////////////////////////////////////////////////////
+// QuakeAIManager::LoadGraph
+//
+//    Loads graph information
+//
+void QuakeAIManager::LoadGraph(const std::wstring& path, std::shared_ptr<PathingGraph>& graph, float weightConversion)
+{
+	TimeTaker loadTime("LoadGraph");
 
-			if (nodes.size())
-			{
-				PathingTransition* pathTransition = new PathingTransition(nodes, weights, positions);
-				pathArc->AddTransition(pathTransition);
-			}
-		}
+	if (!LoadGraphFile(path, graph, weightConversion))
+		LoadGraphArchive(path, graph, weightConversion);
+}
 
-		for (auto const& cluster : node.clusters)
-		{
-			int pathingType = cluster.type;
-			int clusterNode = cluster.nodeid;
-			int clusterTarget = cluster.targetid;
+/////////////////////////////////////////////////////////////////////////////
+// QuakeAIManager::ConvertGraph
+//
+//    Converts the graph archive into the memory mapped graph file
+//
+bool QuakeAIManager::ConvertGraph(const std::wstring& path)
+{
+	std::shared_ptr<PathingGraph> graph = std::make_shared<PathingGraph>();
+	if (!LoadGraphArchive(path, graph, 1.0f))
+		return false;
 
-			PathingCluster* pathCluster = new PathingCluster(pathingType);
-			pathCluster->LinkClusters(pathingGraph[clusterNode], pathingGraph[clusterTarget]);
-			pathNode->AddCluster(pathCluster);
-		}
+	return PathingGraphFile::Save(ToString(GetGraphFilePath(path)), graph.get(), path);
+}
 
-		for (auto const& actor : node.actors)
-		{
-			int pathingType = actor.type;
-			int actorId = actor.actorid;
-			int actorNode = actor.nodeid;
-			int actorTarget = actor.targetid;
+/////////////////////////////////////////////////////////////////////////////
+// QuakeAIManager::LoadGraphFile
+//
+//    Loads graph information from the memory mapped graph file. Graph archives
+//    which weren't converted yet, or changed since, are converted on load
+//
+bool QuakeAIManager::LoadGraphFile(const std::wstring& path, std::shared_ptr<PathingGraph>& graph, float weightConversion)
+{
+	std::wstring graphFilePath = GetGraphFilePath(path);
 
-			PathingActor* pathActor = new PathingActor(pathingType, actorId);
-			pathActor->LinkActors(pathingGraph[actorNode], pathingGraph[actorTarget]);
-			pathNode->AddActor(pathActor);
-		}
+	PathingGraphFile graphFile;
+	if (graphFile.Open(graphFilePath) && !graphFile.IsSourceCurrent(path))
+	{
+		LogInformation("Rebuilding outdated pathing graph " + ToString(graphFilePath));
+		graphFile.Close();
 	}
-
-	std::map<unsigned int, Cluster*> clusterGraph;
-	for (auto const& cluster : data.clusters)
+	if (!graphFile.IsOpen())
 	{
-		Cluster* pCluster = new Cluster(cluster.id, pathingGraph[cluster.node]);
-
-		for (auto const& clusterNode : cluster.nodes)
-			pCluster->AddNode(pathingGraph[clusterNode]);
+		if (!ConvertGraph(path) || !graphFile.Open(graphFilePath))
+			return false;
+	}
+	graphFile.Hydrate(graph.get(), weightConversion);
 
-		for (auto const& nodeActor : cluster.nodeActors)
-			pCluster->AddNodeActor(nodeActor.first, pathingGraph[nodeActor.second]);
+	mLastArcId = 0;
+	mLastNodeId = 0;
 
-		mPathingGraph->InsertCluster(pCluster);
+	const PathingNodeRecord* nodes = graphFile.GetNodes();
+	for (unsigned int node = 0; node < graphFile.GetCount(PGS_NODES); node++)
+		if (mLastNodeId < nodes[node].id) mLastNodeId = nodes[node].id;
 
-		clusterGraph[pCluster->GetId()] = pCluster;
-	}
+	const PathingArcRecord* arcs = graphFile.GetArcs();
+	for (unsigned int arc = 0; arc < graphFile.GetCount(PGS_ARCS); arc++)
+		if (mLastArcId < arcs[arc].id) mLastArcId = arcs[arc].id;
 
-	for (auto const& cluster : data.clusters)
-	{
-		for (auto const& clusterVisible : cluster.visibles)
-		{
-			clusterGraph[cluster.id]->AddVisibleCluster(
-				clusterVisible.first, pathingGraph[clusterVisible.second]);
-		}
-	}
+	return true;
 }
 
 /////////////////////////////////////////////////////////////////////////////
-// QuakeAIManager::LoadGraph
+// QuakeAIManager::LoadGraphArchive
 //
-//    Loads graph information
+//    Loads graph information from the graph archive
 //
-void QuakeAIManager::LoadGraph(const std::wstring& path, std::shared_ptr<PathingGraph>& graph, float weightConversion)
+bool QuakeAIManager::LoadGraphArchive(const std::wstring& path, std::shared_ptr<PathingGraph>& graph, float weightConversion)
 {
 	//set data
 	AIMap::Graph data;
@@ -854,7 +827,7 @@ void QuakeAIManager::LoadGraph(const std::wstring& path, std::shared_ptr<Pathing
 	if (is.fail())
 	{
 		LogError(strerror(errno));
-		return;
+		return false;
 	}
 	cereal::BinaryInputArchive archive(is);
 	archive(data);
@@ -970,6 +943,8 @@ void QuakeAIManager::LoadGraph(const std::wstring& path, std::shared_ptr<Pathing
 		for (auto const& clusterVisible : cluster.visibles)
 			clusterGraph[cluster.id]->AddVisibleCluster(clusterVisible.first, pathingGraph[clusterVisible.second]);
 	}
+
+	return true;
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -994,7 +969,7 @@ void QuakeAIManager::LoadPathingMap(const std::wstring& path, float weightConver
 	mLastArcId = 0;
 	mLastNodeId = 0;
 
-	mPathingGraph = std::make_shared<PathingGraph>();
+	std::shared_ptr<PathingGraph> graph = std::make_shared<PathingGraph>();
 
 	std::map<unsigned int, PathingNode*> pathingGraph;
 	for (auto const& node : data.nodes)
@@ -1008,7 +983,7 @@ void QuakeAIManager::LoadPathingMap(const std::wstring& path, float weightConver
 
 		PathingNode* pathNode = new PathingNode(pathNodeId, actorId, position, tolerance);
 		pathNode->SetCluster(clusterId);
-		mPathingGraph->InsertNode(pathNode);
+		graph->InsertNode(pathNode);
 
 		pathingGraph[pathNodeId] = pathNode;
 	}
@@ -1063,8 +1038,10 @@ void QuakeAIManager::LoadPathingMap(const std::wstring& path, float weightConver
 		for (auto const& nodeActor : cluster.nodeActors)
 			pCluster->AddNodeActor(nodeActor.first, pathingGraph[nodeActor.second]);
 
-		mPathingGraph->InsertCluster(pCluster);
+		graph->InsertCluster(pCluster);
 	}
+
+	BakePathingGraph(graph);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -1183,23 +1160,28 @@ void QuakeAIManager::UpdateMap(ActorId playerId)
 {
 	mPlayerActor = std::dynamic_pointer_cast<PlayerActor>(GameLogic::Get()->GetActor(playerId).lock());
 
+	// the graph is completed in place while the map is built, so no simulation is running on it
+	std::shared_ptr<PathingGraph> graph = GetPathingGraph();
+
 	// we obtain visibility information from pathing graph 
-	SimulateVisibility(mPathingGraph);
+	SimulateVisibility(graph);
 
 	// create transitions associated to closest node
-	CreateTransitions(mPathingGraph);
+	CreateTransitions(graph);
 
 	// we group the graph nodes in clusters
-	CreateClusters(mPathingGraph, MAX_CLUSTERS);
+	CreateClusters(graph, MAX_CLUSTERS);
+
+	BakePathingGraph(graph);
 }
 
 void QuakeAIManager::RemovePlayerSimulations(AIAnalysis::GameEvaluation& gameEvaluation)
 {
-	Concurrency::parallel_for_each(begin(gameEvaluation.playerGuessings),
+	ParallelForEach(begin(gameEvaluation.playerGuessings),
 		end(gameEvaluation.playerGuessings), [&](auto& playerGuessing)
 	//for (auto playerGuessing : gameEvaluation.playerGuessings)
 	{
-		Concurrency::parallel_for_each(begin(playerGuessing->simulations),
+		ParallelForEach(begin(playerGuessing->simulations),
 			end(playerGuessing->simulations), [&](auto& simulation)
 		//for (auto simulation : playerGuessing->simulations)
 		{
@@ -1211,11 +1193,11 @@ void QuakeAIManager::RemovePlayerSimulations(AIAnalysis::GameEvaluation& gameEva
 	});
 	gameEvaluation.playerGuessings.clear();
 
-	Concurrency::parallel_for_each(begin(gameEvaluation.playerDecisions),
+	ParallelForEach(begin(gameEvaluation.playerDecisions),
 		end(gameEvaluation.playerDecisions), [&](auto& playerDecision)
 	//for (auto playerDecision : gameEvaluation.playerDecisions)
 	{
-		Concurrency::parallel_for_each(begin(playerDecision->simulations),
+		ParallelForEach(begin(playerDecision->simulations),
 			end(playerDecision->simulations), [&](auto& simulation)
 		//for (auto simulation : playerDecision->simulations)
 		{
@@ -1383,21 +1365,21 @@ void QuakeAIManager::Simulation(
 }
 
 bool QuakeAIManager::BuildPath(
-	std::shared_ptr<PathingGraph>& graph, PathingNode* clusterNodeStart, PathingNode* otherClusterNodeStart,
-	Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-	Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& clusterNodePathPlans,
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& otherClusterNodePathPlans)
+	const std::shared_ptr<PathingGraphView>& pathingGraphView, PathingNode* clusterNodeStart, PathingNode* otherClusterNodeStart,
+	ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+	ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& clusterNodePathPlans,
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& otherClusterNodePathPlans)
 {
 	std::unordered_map<unsigned int, PathingNode*> clusterNodes, otherClusterNodes;
 
 	std::map<PathingCluster*, PathingArcVec> clusterPaths, jumpClusterPaths;
 	std::map<PathingCluster*, float> clusterPathWeights, jumpClusterPathWeights;
-	clusterNodeStart->GetClusters(AT_MOVE, 100, clusterPaths, clusterPathWeights);
+	pathingGraphView->GetClusters(clusterNodeStart, AT_MOVE, 100, clusterPaths, clusterPathWeights);
 	for (auto& clusterPath : clusterPaths)
 		clusterNodes[clusterPath.first->GetTarget()->GetCluster()] = clusterPath.first->GetTarget();
 	//we will only consider jumps which are not reachable on moving
-	clusterNodeStart->GetClusters(AT_JUMP, 100, jumpClusterPaths, jumpClusterPathWeights);
+	pathingGraphView->GetClusters(clusterNodeStart, AT_JUMP, 100, jumpClusterPaths, jumpClusterPathWeights);
 	for (auto& jumpClusterPath : jumpClusterPaths)
 	{
 		if (clusterNodes.find(jumpClusterPath.first->GetTarget()->GetCluster()) == clusterNodes.end())
@@ -1412,12 +1394,17 @@ bool QuakeAIManager::BuildPath(
 	{
 		for (auto& clusterPathArc : clusterPath.second)
 		{
-			PathingTransition* clusterPathTransition = clusterPathArc->GetTransition();
 			pathingClusterNodes[clusterPathArc->GetNode()][clusterPath.first] =
 				clusterPath.first->GetType() << 28 | clusterPath.first->GetTarget()->GetId();
-			for (auto& clusterPathNode : clusterPathTransition->GetNodes())
+
+			unsigned int clusterPathArcIndex = pathingGraphView->GetArcIndex(clusterPathArc);
+			if (clusterPathArcIndex == PATHING_INVALID_INDEX)
+				continue;
+
+			for (unsigned int step = pathingGraphView->GetTransitionBegin(clusterPathArcIndex);
+				step < pathingGraphView->GetTransitionEnd(clusterPathArcIndex); step++)
 			{
-				pathingClusterNodes[clusterPathNode][clusterPath.first] =
+				pathingClusterNodes[pathingGraphView->GetNode(pathingGraphView->GetTransitionNode(step))][clusterPath.first] =
 					clusterPath.first->GetType() << 28 | clusterPath.first->GetTarget()->GetId();
 			}
 		}
@@ -1425,11 +1412,11 @@ bool QuakeAIManager::BuildPath(
 
 	std::map<PathingCluster*, PathingArcVec> otherClusterPaths, otherJumpClusterPaths;
 	std::map<PathingCluster*, float> otherClusterPathWeights, otherJumpClusterPathWeights;
-	otherClusterNodeStart->GetClusters(AT_MOVE, 100, otherClusterPaths, otherClusterPathWeights);
+	pathingGraphView->GetClusters(otherClusterNodeStart, AT_MOVE, 100, otherClusterPaths, otherClusterPathWeights);
 	for (auto& otherClusterPath : otherClusterPaths)
 		otherClusterNodes[otherClusterPath.first->GetTarget()->GetCluster()] = otherClusterPath.first->GetTarget();
 	//we will only consider jumps which are not reachable on moving
-	otherClusterNodeStart->GetClusters(AT_JUMP, 100, otherJumpClusterPaths, otherJumpClusterPathWeights);
+	pathingGraphView->GetClusters(otherClusterNodeStart, AT_JUMP, 100, otherJumpClusterPaths, otherJumpClusterPathWeights);
 	for (auto& otherJumpClusterPath : otherJumpClusterPaths)
 	{
 		if (otherClusterNodes.find(otherJumpClusterPath.first->GetTarget()->GetCluster()) == otherClusterNodes.end())
@@ -1444,25 +1431,30 @@ bool QuakeAIManager::BuildPath(
 	{
 		for (auto& otherClusterPathArc : otherClusterPath.second)
 		{
-			PathingTransition* otherClusterPathTransition = otherClusterPathArc->GetTransition();
 			otherPathingClusterNodes[otherClusterPathArc->GetNode()][otherClusterPath.first] =
 				otherClusterPath.first->GetType() << 28 | otherClusterPath.first->GetTarget()->GetId();
-			for (auto& otherClusterPathNode : otherClusterPathTransition->GetNodes())
+
+			unsigned int otherClusterPathArcIndex = pathingGraphView->GetArcIndex(otherClusterPathArc);
+			if (otherClusterPathArcIndex == PATHING_INVALID_INDEX)
+				continue;
+
+			for (unsigned int step = pathingGraphView->GetTransitionBegin(otherClusterPathArcIndex);
+				step < pathingGraphView->GetTransitionEnd(otherClusterPathArcIndex); step++)
 			{
-				otherPathingClusterNodes[otherClusterPathNode][otherClusterPath.first] =
+				otherPathingClusterNodes[pathingGraphView->GetNode(pathingGraphView->GetTransitionNode(step))][otherClusterPath.first] =
 					otherClusterPath.first->GetType() << 28 | otherClusterPath.first->GetTarget()->GetId();
 			}
 		}
 	}
 
-	Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>> visibleClusters;
-	Concurrency::parallel_for_each(begin(pathingClusterNodes), end(pathingClusterNodes), [&](auto& pathingClusterNode)
+	ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>> visibleClusters;
+	ParallelForEach(begin(pathingClusterNodes), end(pathingClusterNodes), [&](auto& pathingClusterNode)
 	//for (auto& pathingClusterNode : pathingClusterNodes)
 	{
-		Concurrency::parallel_for_each(begin(otherPathingClusterNodes), end(otherPathingClusterNodes), [&](auto& otherPathingClusterNode)
+		ParallelForEach(begin(otherPathingClusterNodes), end(otherPathingClusterNodes), [&](auto& otherPathingClusterNode)
 		//for (auto& otherPathingClusterNode : otherPathingClusterNodes)
 		{
-			if (pathingClusterNode.first->IsVisibleNode(otherPathingClusterNode.first))
+			if (pathingGraphView->IsVisibleNode(pathingClusterNode.first, otherPathingClusterNode.first))
 			{
 				for (auto& pathingCluster : pathingClusterNode.second)
 				{
@@ -1483,7 +1475,7 @@ bool QuakeAIManager::BuildPath(
 		for (auto& clusterPath : clusterPaths)
 		{
 			PathingCluster* pathingCluster = clusterPath.first;
-			PathingNode* pathingClusterNodeEnd = graph->FindClusterNode(pathingCluster->GetTarget()->GetCluster());
+			PathingNode* pathingClusterNodeEnd = pathingGraphView->FindClusterNode(pathingCluster->GetTarget()->GetCluster());
 
 			unsigned long long pathingClusterCode =
 				(unsigned long long)pathingCluster->GetType() << 60 | (unsigned long long)clusterNodeStart->GetId() << 46 |
@@ -1501,7 +1493,7 @@ bool QuakeAIManager::BuildPath(
 		for (auto& otherClusterPath : otherClusterPaths)
 		{
 			PathingCluster* otherPathingCluster = otherClusterPath.first;
-			PathingNode* otherPathingClusterNodeEnd = graph->FindClusterNode(otherPathingCluster->GetTarget()->GetCluster());
+			PathingNode* otherPathingClusterNodeEnd = pathingGraphView->FindClusterNode(otherPathingCluster->GetTarget()->GetCluster());
 
 			unsigned long long otherPathingClusterCode =
 				(unsigned long long)otherPathingCluster->GetType() << 60 | (unsigned long long)otherClusterNodeStart->GetId() << 46 |
@@ -1533,7 +1525,7 @@ bool QuakeAIManager::BuildPath(
 			if (closestClusterPaths.size() >= maxClosestClusters) 
 				break;
 		}
-		BuildExpandedPath(graph, maxPathingClusters, clusterNodeStart, 
+		BuildExpandedPath(pathingGraphView, maxPathingClusters, clusterNodeStart, 
 			clusterPaths, closestClusterPaths, clusterPathings, clusterNodePathPlans);
 
 		std::map<PathingCluster*, float> otherClosestClusterPaths;
@@ -1543,28 +1535,28 @@ bool QuakeAIManager::BuildPath(
 			if (otherClosestClusterPaths.size() >= maxClosestClusters)
 				break;
 		}
-		BuildExpandedPath(graph, maxPathingClusters, otherClusterNodeStart,
+		BuildExpandedPath(pathingGraphView, maxPathingClusters, otherClusterNodeStart,
 			otherClusterPaths, otherClosestClusterPaths, otherClusterPathings, otherClusterNodePathPlans);
 	}
 	 
 	return visibleClusters.size();
 }
 
-bool QuakeAIManager::BuildLongPath(std::shared_ptr<PathingGraph>& graph, PathingNode* clusterNodeStart,
-	Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& clusterNodePathPlans)
+bool QuakeAIManager::BuildLongPath(const std::shared_ptr<PathingGraphView>& pathingGraphView, PathingNode* clusterNodeStart,
+	ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& clusterNodePathPlans)
 {
 	std::unordered_map<unsigned int, PathingNode*> clusterNodes, otherClusterNodes;
 
 	std::map<PathingCluster*, PathingArcVec> clusterPaths, otherClusterPaths;
 	std::map<PathingCluster*, float> clusterPathWeights, otherClusterPathWeights;
-	clusterNodeStart->GetClusters(AT_MOVE, 260, clusterPaths, clusterPathWeights);
+	pathingGraphView->GetClusters(clusterNodeStart, AT_MOVE, 260, clusterPaths, clusterPathWeights);
 	for (auto& clusterPath : clusterPaths)
 		clusterNodes[clusterPath.first->GetTarget()->GetCluster()] = clusterPath.first->GetTarget();
 	//we will only consider jumps which are not reachable on moving
 	std::map<PathingCluster*, PathingArcVec> jumpClusterPaths, jumpOtherClusterPaths;
 	std::map<PathingCluster*, float> jumpClusterPathWeights, jumpOtherClusterPathWeights;
-	clusterNodeStart->GetClusters(AT_JUMP, 260, jumpClusterPaths, jumpClusterPathWeights);
+	pathingGraphView->GetClusters(clusterNodeStart, AT_JUMP, 260, jumpClusterPaths, jumpClusterPathWeights);
 	for (auto& jumpClusterPath : jumpClusterPaths)
 	{
 		if (clusterNodes.find(jumpClusterPath.first->GetTarget()->GetCluster()) == clusterNodes.end())
@@ -1577,7 +1569,7 @@ bool QuakeAIManager::BuildLongPath(std::shared_ptr<PathingGraph>& graph, Pathing
 	for (auto& clusterPath : clusterPaths)
 	{
 		PathingCluster* pathingCluster = clusterPath.first;
-		PathingNode* pathingClusterNodeEnd = graph->FindClusterNode(pathingCluster->GetTarget()->GetCluster());
+		PathingNode* pathingClusterNodeEnd = pathingGraphView->FindClusterNode(pathingCluster->GetTarget()->GetCluster());
 
 		unsigned long long pathingClusterCode =
 			(unsigned long long)pathingCluster->GetType() << 60 | (unsigned long long)clusterNodeStart->GetId() << 46 |
@@ -1592,21 +1584,21 @@ bool QuakeAIManager::BuildLongPath(std::shared_ptr<PathingGraph>& graph, Pathing
 }
 
 bool QuakeAIManager::BuildLongPath(
-	std::shared_ptr<PathingGraph>& graph, PathingNode* clusterNodeStart, PathingNode* otherClusterNodeStart,
-	Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-	Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& clusterNodePathPlans,
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& otherClusterNodePathPlans)
+	const std::shared_ptr<PathingGraphView>& pathingGraphView, PathingNode* clusterNodeStart, PathingNode* otherClusterNodeStart,
+	ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+	ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& clusterNodePathPlans,
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& otherClusterNodePathPlans)
 {
 	std::unordered_map<unsigned int, PathingNode*> clusterNodes, otherClusterNodes;
 
 	std::map<PathingCluster*, PathingArcVec> clusterPaths, jumpClusterPaths;
 	std::map<PathingCluster*, float> clusterPathWeights, jumpClusterPathWeights;
-	clusterNodeStart->GetClusters(AT_MOVE, 200, clusterPaths, clusterPathWeights);
+	pathingGraphView->GetClusters(clusterNodeStart, AT_MOVE, 200, clusterPaths, clusterPathWeights);
 	for (auto& clusterPath : clusterPaths)
 		clusterNodes[clusterPath.first->GetTarget()->GetCluster()] = clusterPath.first->GetTarget();
 	//we will only consider jumps which are not reachable on moving
-	clusterNodeStart->GetClusters(AT_JUMP, 200, jumpClusterPaths, jumpClusterPathWeights);
+	pathingGraphView->GetClusters(clusterNodeStart, AT_JUMP, 200, jumpClusterPaths, jumpClusterPathWeights);
 	for (auto& jumpClusterPath : jumpClusterPaths)
 	{
 		if (clusterNodes.find(jumpClusterPath.first->GetTarget()->GetCluster()) == clusterNodes.end())
@@ -1634,12 +1626,17 @@ bool QuakeAIManager::BuildLongPath(
 		PathingCluster* clusterPath = (*itCluster).second;
 		for (auto& clusterPathArc : clusterPaths[clusterPath])
 		{
-			PathingTransition* clusterPathTransition = clusterPathArc->GetTransition();
 			pathingClusterNodes[clusterPathArc->GetNode()][clusterPath] =
 				clusterPath->GetType() << 28 | clusterPath->GetTarget()->GetId();
-			for (auto& clusterPathNode : clusterPathTransition->GetNodes())
+
+			unsigned int clusterPathArcIndex = pathingGraphView->GetArcIndex(clusterPathArc);
+			if (clusterPathArcIndex == PATHING_INVALID_INDEX)
+				continue;
+
+			for (unsigned int step = pathingGraphView->GetTransitionBegin(clusterPathArcIndex);
+				step < pathingGraphView->GetTransitionEnd(clusterPathArcIndex); step++)
 			{
-				pathingClusterNodes[clusterPathNode][clusterPath] =
+				pathingClusterNodes[pathingGraphView->GetNode(pathingGraphView->GetTransitionNode(step))][clusterPath] =
 					clusterPath->GetType() << 28 | clusterPath->GetTarget()->GetId();
 			}
 		}
@@ -1647,11 +1644,11 @@ bool QuakeAIManager::BuildLongPath(
 
 	std::map<PathingCluster*, PathingArcVec> otherClusterPaths, jumpOtherClusterPaths;
 	std::map<PathingCluster*, float> otherClusterPathWeights, jumpOtherClusterPathWeights;
-	otherClusterNodeStart->GetClusters(AT_MOVE, 200, otherClusterPaths, otherClusterPathWeights);
+	pathingGraphView->GetClusters(otherClusterNodeStart, AT_MOVE, 200, otherClusterPaths, otherClusterPathWeights);
 	for (auto& otherClusterPath : otherClusterPaths)
 		otherClusterNodes[otherClusterPath.first->GetTarget()->GetCluster()] = otherClusterPath.first->GetTarget();
 	//we will only consider jumps which are not reachable on moving
-	otherClusterNodeStart->GetClusters(AT_JUMP, 200, jumpOtherClusterPaths, jumpOtherClusterPathWeights);
+	pathingGraphView->GetClusters(otherClusterNodeStart, AT_JUMP, 200, jumpOtherClusterPaths, jumpOtherClusterPathWeights);
 	for (auto& jumpOtherClusterPath : jumpOtherClusterPaths)
 	{
 		if (otherClusterNodes.find(jumpOtherClusterPath.first->GetTarget()->GetCluster()) == otherClusterNodes.end())
@@ -1678,25 +1675,30 @@ bool QuakeAIManager::BuildLongPath(
 		PathingCluster* otherClusterPath = (*itOtherCluster).second;
 		for (auto& otherClusterPathArc : otherClusterPaths[otherClusterPath])
 		{
-			PathingTransition* otherClusterPathTransition = otherClusterPathArc->GetTransition();
 			otherPathingClusterNodes[otherClusterPathArc->GetNode()][otherClusterPath] =
 				otherClusterPath->GetType() << 28 | otherClusterPath->GetTarget()->GetId();
-			for (auto& otherClusterPathNode : otherClusterPathTransition->GetNodes())
+
+			unsigned int otherClusterPathArcIndex = pathingGraphView->GetArcIndex(otherClusterPathArc);
+			if (otherClusterPathArcIndex == PATHING_INVALID_INDEX)
+				continue;
+
+			for (unsigned int step = pathingGraphView->GetTransitionBegin(otherClusterPathArcIndex);
+				step < pathingGraphView->GetTransitionEnd(otherClusterPathArcIndex); step++)
 			{
-				otherPathingClusterNodes[otherClusterPathNode][otherClusterPath] =
+				otherPathingClusterNodes[pathingGraphView->GetNode(pathingGraphView->GetTransitionNode(step))][otherClusterPath] =
 					otherClusterPath->GetType() << 28 | otherClusterPath->GetTarget()->GetId();
 			}
 		}
 	}
 
-	Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>> visibleClusters;
-	Concurrency::parallel_for_each(begin(pathingClusterNodes), end(pathingClusterNodes), [&](auto& pathingClusterNode)
+	ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>> visibleClusters;
+	ParallelForEach(begin(pathingClusterNodes), end(pathingClusterNodes), [&](auto& pathingClusterNode)
 	//for (auto& pathingClusterNode : pathingClusterNodes)
 	{
-		Concurrency::parallel_for_each(begin(otherPathingClusterNodes), end(otherPathingClusterNodes), [&](auto& otherPathingClusterNode)
+		ParallelForEach(begin(otherPathingClusterNodes), end(otherPathingClusterNodes), [&](auto& otherPathingClusterNode)
 		//for (auto& otherPathingClusterNode : otherPathingClusterNodes)
 		{
-			if (pathingClusterNode.first->IsVisibleNode(otherPathingClusterNode.first))
+			if (pathingGraphView->IsVisibleNode(pathingClusterNode.first, otherPathingClusterNode.first))
 			{
 				for (auto& pathingCluster : pathingClusterNode.second)
 				{
@@ -1717,7 +1719,7 @@ bool QuakeAIManager::BuildLongPath(
 		for (auto& clusterPath : clusterPaths)
 		{
 			PathingCluster* pathingCluster = clusterPath.first;
-			PathingNode* pathingClusterNodeEnd = graph->FindClusterNode(pathingCluster->GetTarget()->GetCluster());
+			PathingNode* pathingClusterNodeEnd = pathingGraphView->FindClusterNode(pathingCluster->GetTarget()->GetCluster());
 
 			unsigned long long pathingClusterCode =
 				(unsigned long long)pathingCluster->GetType() << 60 | (unsigned long long)clusterNodeStart->GetId() << 46 |
@@ -1735,7 +1737,7 @@ bool QuakeAIManager::BuildLongPath(
 		for (auto& otherClusterPath : otherClusterPaths)
 		{
 			PathingCluster* otherPathingCluster = otherClusterPath.first;
-			PathingNode* otherPathingClusterNodeEnd = graph->FindClusterNode(otherPathingCluster->GetTarget()->GetCluster());
+			PathingNode* otherPathingClusterNodeEnd = pathingGraphView->FindClusterNode(otherPathingCluster->GetTarget()->GetCluster());
 
 			unsigned long long otherPathingClusterCode =
 				(unsigned long long)otherPathingCluster->GetType() << 60 | (unsigned long long)otherClusterNodeStart->GetId() << 46 |
@@ -1768,7 +1770,7 @@ bool QuakeAIManager::BuildLongPath(
 			if (closestClusterPaths.size() >= maxClosestClusters)
 				break;
 		}
-		BuildExpandedPath(graph, maxPathingClusters, clusterNodeStart,
+		BuildExpandedPath(pathingGraphView, maxPathingClusters, clusterNodeStart,
 			clusterPaths, closestClusterPaths, clusterPathings, clusterNodePathPlans);
 
 		std::map<PathingCluster*, float> otherClosestClusterPaths;
@@ -1778,7 +1780,7 @@ bool QuakeAIManager::BuildLongPath(
 			if (otherClosestClusterPaths.size() >= maxClosestClusters)
 				break;
 		}
-		BuildExpandedPath(graph, maxPathingClusters, otherClusterNodeStart,
+		BuildExpandedPath(pathingGraphView, maxPathingClusters, otherClusterNodeStart,
 			otherClusterPaths, otherClosestClusterPaths, otherClusterPathings, otherClusterNodePathPlans);
 		return true;
 	}
@@ -1787,23 +1789,23 @@ bool QuakeAIManager::BuildLongPath(
 }
 
 bool QuakeAIManager::BuildLongestPath(
-	std::shared_ptr<PathingGraph>& graph, PathingNode* clusterNodeStart, PathingNode* otherClusterNodeStart,
-	Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-	Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& clusterNodePathPlans,
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& otherClusterNodePathPlans)
+	const std::shared_ptr<PathingGraphView>& pathingGraphView, PathingNode* clusterNodeStart, PathingNode* otherClusterNodeStart,
+	ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+	ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& clusterNodePathPlans,
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& otherClusterNodePathPlans)
 {
 	std::unordered_map<unsigned int, PathingNode*> clusterNodes, otherClusterNodes;
 
 	std::map<PathingCluster*, PathingArcVec> clusterPaths, otherClusterPaths;
 	std::map<PathingCluster*, float> clusterPathWeights, otherClusterPathWeights;
-	clusterNodeStart->GetClusters(AT_MOVE, 260, clusterPaths, clusterPathWeights);
+	pathingGraphView->GetClusters(clusterNodeStart, AT_MOVE, 260, clusterPaths, clusterPathWeights);
 	for (auto& clusterPath : clusterPaths)
 		clusterNodes[clusterPath.first->GetTarget()->GetCluster()] = clusterPath.first->GetTarget();
 	//we will only consider jumps which are not reachable on moving
 	std::map<PathingCluster*, PathingArcVec> jumpClusterPaths, jumpOtherClusterPaths;
 	std::map<PathingCluster*, float> jumpClusterPathWeights, jumpOtherClusterPathWeights;
-	clusterNodeStart->GetClusters(AT_JUMP, 260, jumpClusterPaths, jumpClusterPathWeights);
+	pathingGraphView->GetClusters(clusterNodeStart, AT_JUMP, 260, jumpClusterPaths, jumpClusterPathWeights);
 	for (auto& jumpClusterPath : jumpClusterPaths)
 	{
 		if (clusterNodes.find(jumpClusterPath.first->GetTarget()->GetCluster()) == clusterNodes.end())
@@ -1829,7 +1831,7 @@ bool QuakeAIManager::BuildLongestPath(
 	for (; itCluster != closestClusterPathWeights.end(); ++itCluster)
 	{
 		PathingCluster* pathingCluster = (*itCluster).second;
-		PathingNode* pathingClusterNodeEnd = graph->FindClusterNode(pathingCluster->GetTarget()->GetCluster());
+		PathingNode* pathingClusterNodeEnd = pathingGraphView->FindClusterNode(pathingCluster->GetTarget()->GetCluster());
 
 		unsigned long long pathingClusterCode =
 			(unsigned long long)pathingCluster->GetType() << 60 | (unsigned long long)clusterNodeStart->GetId() << 46 |
@@ -1840,11 +1842,11 @@ bool QuakeAIManager::BuildLongestPath(
 		clusterPathings[pathingClusterCode] = { pathingCluster, pathingCluster };
 	}
 
-	otherClusterNodeStart->GetClusters(AT_MOVE, 260, otherClusterPaths, otherClusterPathWeights);
+	pathingGraphView->GetClusters(otherClusterNodeStart, AT_MOVE, 260, otherClusterPaths, otherClusterPathWeights);
 	for (auto& otherClusterPath : otherClusterPaths)
 		otherClusterNodes[otherClusterPath.first->GetTarget()->GetCluster()] = otherClusterPath.first->GetTarget();
 	//we will only consider jumps which are not reachable on moving
-	otherClusterNodeStart->GetClusters(AT_JUMP, 260, jumpOtherClusterPaths, jumpOtherClusterPathWeights);
+	pathingGraphView->GetClusters(otherClusterNodeStart, AT_JUMP, 260, jumpOtherClusterPaths, jumpOtherClusterPathWeights);
 	for (auto& jumpOtherClusterPath : jumpOtherClusterPaths)
 	{
 		if (otherClusterNodes.find(jumpOtherClusterPath.first->GetTarget()->GetCluster()) == otherClusterNodes.end())
@@ -1869,7 +1871,7 @@ bool QuakeAIManager::BuildLongestPath(
 	for (; itOtherCluster != otherClosestClusterPathWeights.end(); ++itOtherCluster)
 	{
 		PathingCluster* otherPathingCluster = (*itOtherCluster).second;
-		PathingNode* otherPathingClusterNodeEnd = graph->FindClusterNode(otherPathingCluster->GetTarget()->GetCluster());
+		PathingNode* otherPathingClusterNodeEnd = pathingGraphView->FindClusterNode(otherPathingCluster->GetTarget()->GetCluster());
 
 		unsigned long long otherPathingClusterCode =
 			(unsigned long long)otherPathingCluster->GetType() << 60 | (unsigned long long)otherClusterNodeStart->GetId() << 46 |
@@ -1884,28 +1886,28 @@ bool QuakeAIManager::BuildLongestPath(
 }
 
 void QuakeAIManager::BuildExpandedPath(
-	std::shared_ptr<PathingGraph>& graph, unsigned int maxPathingClusters, PathingNode* clusterNodeStart,
+	const std::shared_ptr<PathingGraphView>& pathingGraphView, unsigned int maxPathingClusters, PathingNode* clusterNodeStart,
 	const std::map<PathingCluster*, PathingArcVec>& clusterPaths, const std::map<PathingCluster*, float>& expandClusterPathWeights,
-	Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& clusterNodePathPlans)
+	ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& clusterNodePathPlans)
 {
 	std::mutex mutex;
 
 	//we will expand only with move type clusters
 	unsigned int pathingClustersLimit = maxPathingClusters / (unsigned int)expandClusterPathWeights.size();
-	Concurrency::parallel_for_each(
+	ParallelForEach(
 		begin(expandClusterPathWeights), end(expandClusterPathWeights), [&](auto const& clusterPathWeight)
 	//for (auto& clusterPathWeight : expandClusterPathWeights)
 	{
-		PathingNode* clusterNodeEnd = graph->FindClusterNode(clusterPathWeight.first->GetTarget()->GetCluster());
+		PathingNode* clusterNodeEnd = pathingGraphView->FindClusterNode(clusterPathWeight.first->GetTarget()->GetCluster());
 
 		//lets try to add surrounding clusters
 		std::map<PathingCluster*, PathingArcVec> pathingClusters;
 		std::multimap<float, PathingCluster*, std::less<float>> pathingClusterWeights;
-		clusterPathWeight.first->GetTarget()->GetClusters(AT_MOVE, pathingClustersLimit, pathingClusters, pathingClusterWeights);
+		pathingGraphView->GetClusters(clusterPathWeight.first->GetTarget(), AT_MOVE, pathingClustersLimit, pathingClusters, pathingClusterWeights);
 		for (auto itCluster = pathingClusterWeights.begin(); itCluster != pathingClusterWeights.end(); ++itCluster)
 		{
-			PathingNode* pathingClusterNodeEnd = graph->FindClusterNode((*itCluster).second->GetTarget()->GetCluster());
+			PathingNode* pathingClusterNodeEnd = pathingGraphView->FindClusterNode((*itCluster).second->GetTarget()->GetCluster());
 			if (clusterNodeEnd == pathingClusterNodeEnd)
 				continue;
 
@@ -1926,21 +1928,21 @@ void QuakeAIManager::BuildExpandedPath(
 }
 
 void QuakeAIManager::BuildExpandedActorPath(
-	std::shared_ptr<PathingGraph>& graph, PathingNode* clusterNodeStart,
-	Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& actorPathPlanClusters,
-	Concurrency::concurrent_unordered_map<unsigned long long, float>& actorPathPlanClusterHeuristics)
+	const std::shared_ptr<PathingGraphView>& pathingGraphView, PathingNode* clusterNodeStart,
+	ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& actorPathPlanClusters,
+	ConcurrentUnorderedMap<unsigned long long, float>& actorPathPlanClusterHeuristics)
 {
 	//search surrounding clusters
 	std::multimap<float, PathingCluster*, std::greater<float>> clusterPathHeuristics;
 	std::map<PathingCluster*, PathingArcVec> clusterPaths;
 	std::map<PathingCluster*, float> clusterPathWeights;
-	clusterNodeStart->GetClusters(AT_MOVE, 100, clusterPaths, clusterPathWeights);
-	clusterNodeStart->GetClusters(AT_JUMP, 100, clusterPaths, clusterPathWeights);
+	pathingGraphView->GetClusters(clusterNodeStart, AT_MOVE, 100, clusterPaths, clusterPathWeights);
+	pathingGraphView->GetClusters(clusterNodeStart, AT_JUMP, 100, clusterPaths, clusterPathWeights);
 	for (auto& clusterPathWeight : clusterPathWeights)
 	{
 		unsigned int actionType = clusterPathWeight.first->GetType();
-		PathingNode* clusterNodeEnd = graph->FindClusterNode(clusterPathWeight.first->GetTarget()->GetCluster());
+		PathingNode* clusterNodeEnd = pathingGraphView->FindClusterNode(clusterPathWeight.first->GetTarget()->GetCluster());
 
 		unsigned long long clusterCode =
 			(unsigned long long)actionType << 60 | (unsigned long long)clusterNodeStart->GetId() << 46 |
@@ -1964,7 +1966,7 @@ void QuakeAIManager::BuildExpandedActorPath(
 			if (actionType != clusterPathHeuristic.second->GetType())
 				continue;
 			
-			PathingNode* clusterNodeEnd = graph->FindClusterNode(clusterPathHeuristic.second->GetTarget()->GetCluster());
+			PathingNode* clusterNodeEnd = pathingGraphView->FindClusterNode(clusterPathHeuristic.second->GetTarget()->GetCluster());
 
 			unsigned long long clusterCode =
 				(unsigned long long)actionType << 60 | (unsigned long long)clusterNodeStart->GetId() << 46 |
@@ -1980,21 +1982,21 @@ void QuakeAIManager::BuildExpandedActorPath(
 	std::mutex mutex;
 
 	//we will expand clusters
-	Concurrency::parallel_for_each(begin(bestClusterPaths), end(bestClusterPaths), [&](auto const& bestClusterPath)
+	ParallelForEach(begin(bestClusterPaths), end(bestClusterPaths), [&](auto const& bestClusterPath)
 	//for (auto& bestClusterPath : bestClusterPaths)
 	{
 		PathingNode* actorPathNode = actorPathPlanClusters[bestClusterPath.second].empty() ?
 			clusterNodeStart : actorPathPlanClusters[bestClusterPath.second].back()->GetNode();
-		PathingNode* clusterNodeEnd = graph->FindClusterNode(actorPathNode->GetCluster());
+		PathingNode* clusterNodeEnd = pathingGraphView->FindClusterNode(actorPathNode->GetCluster());
 
 		//lets try to add surrounding clusters
 		std::unordered_set<PathingNode*> pathingClusterNodes;
 		std::map<PathingCluster*, PathingArcVec> pathingClusters;
 		std::multimap<float, PathingCluster*, std::less<float>> pathingClusterWeights;
-		actorPathNode->GetClusters(AT_MOVE, 40, pathingClusters, pathingClusterWeights);
+		pathingGraphView->GetClusters(actorPathNode, AT_MOVE, 40, pathingClusters, pathingClusterWeights);
 		for (auto itCluster = pathingClusterWeights.begin(); itCluster != pathingClusterWeights.end(); ++itCluster)
 		{
-			PathingNode* pathingClusterNodeEnd = graph->FindClusterNode((*itCluster).second->GetTarget()->GetCluster());
+			PathingNode* pathingClusterNodeEnd = pathingGraphView->FindClusterNode((*itCluster).second->GetTarget()->GetCluster());
 			if (clusterNodeEnd == pathingClusterNodeEnd)
 				continue;
 
@@ -2017,10 +2019,10 @@ void QuakeAIManager::BuildExpandedActorPath(
 
 		pathingClusters.clear();
 		pathingClusterWeights.clear();
-		actorPathNode->GetClusters(AT_JUMP, 30, pathingClusters, pathingClusterWeights);
+		pathingGraphView->GetClusters(actorPathNode, AT_JUMP, 30, pathingClusters, pathingClusterWeights);
 		for (auto itCluster = pathingClusterWeights.begin(); itCluster != pathingClusterWeights.end(); ++itCluster)
 		{
-			PathingNode* pathingClusterNodeEnd = graph->FindClusterNode((*itCluster).second->GetTarget()->GetCluster());
+			PathingNode* pathingClusterNodeEnd = pathingGraphView->FindClusterNode((*itCluster).second->GetTarget()->GetCluster());
 			if (clusterNodeEnd == pathingClusterNodeEnd)
 				continue;
 
@@ -2045,21 +2047,21 @@ void QuakeAIManager::BuildExpandedActorPath(
 }
 
 void QuakeAIManager::BuildExpandedActorPath(
-	std::shared_ptr<PathingGraph>& graph, PathingNode* clusterNodeStart, float heuristicThreshold,
-	Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& actorPathPlanClusters,
-	Concurrency::concurrent_unordered_map<unsigned long long, float>& actorPathPlanClusterHeuristics)
+	const std::shared_ptr<PathingGraphView>& pathingGraphView, PathingNode* clusterNodeStart, float heuristicThreshold,
+	ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& actorPathPlanClusters,
+	ConcurrentUnorderedMap<unsigned long long, float>& actorPathPlanClusterHeuristics)
 {
 	//search surrounding clusters
 	std::multimap<float, PathingCluster*, std::greater<float>> clusterPathHeuristics;
 	std::map<PathingCluster*, PathingArcVec> clusterPaths;
 	std::map<PathingCluster*, float> clusterPathWeights;
-	clusterNodeStart->GetClusters(AT_MOVE, 100, clusterPaths, clusterPathWeights);
-	clusterNodeStart->GetClusters(AT_JUMP, 100, clusterPaths, clusterPathWeights);
+	pathingGraphView->GetClusters(clusterNodeStart, AT_MOVE, 100, clusterPaths, clusterPathWeights);
+	pathingGraphView->GetClusters(clusterNodeStart, AT_JUMP, 100, clusterPaths, clusterPathWeights);
 	for (auto& clusterPathWeight : clusterPathWeights)
 	{
 		unsigned int actionType = clusterPathWeight.first->GetType();
-		PathingNode* clusterNodeEnd = graph->FindClusterNode(clusterPathWeight.first->GetTarget()->GetCluster());
+		PathingNode* clusterNodeEnd = pathingGraphView->FindClusterNode(clusterPathWeight.first->GetTarget()->GetCluster());
 
 		unsigned long long clusterCode =
 			(unsigned long long)actionType << 60 | (unsigned long long)clusterNodeStart->GetId() << 46 |
@@ -2080,7 +2082,7 @@ void QuakeAIManager::BuildExpandedActorPath(
 			if (actionType != clusterPathHeuristic.second->GetType())
 				continue;
 			
-			PathingNode* clusterNodeEnd = graph->FindClusterNode(clusterPathHeuristic.second->GetTarget()->GetCluster());
+			PathingNode* clusterNodeEnd = pathingGraphView->FindClusterNode(clusterPathHeuristic.second->GetTarget()->GetCluster());
 
 			unsigned long long clusterCode =
 				(unsigned long long)actionType << 60 | (unsigned long long)clusterNodeStart->GetId() << 46 |
@@ -2095,21 +2097,21 @@ void QuakeAIManager::BuildExpandedActorPath(
 	std::mutex mutex;
 
 	//we will expand clusters
-	Concurrency::parallel_for_each(begin(bestClusterPaths), end(bestClusterPaths), [&](auto const& bestClusterPath)
+	ParallelForEach(begin(bestClusterPaths), end(bestClusterPaths), [&](auto const& bestClusterPath)
 	//for (auto& bestClusterPath : bestClusterPaths)
 	{
 		PathingNode* actorPathNode = actorPathPlanClusters[bestClusterPath.second].empty() ?
 			clusterNodeStart : actorPathPlanClusters[bestClusterPath.second].back()->GetNode();
-		PathingNode* clusterNodeEnd = graph->FindClusterNode(actorPathNode->GetCluster());
+		PathingNode* clusterNodeEnd = pathingGraphView->FindClusterNode(actorPathNode->GetCluster());
 
 		//lets try to add surrounding clusters
 		std::unordered_set<PathingNode*> pathingClusterNodes;
 		std::map<PathingCluster*, PathingArcVec> pathingClusters;
 		std::multimap<float, PathingCluster*, std::less<float>> pathingClusterWeights;
-		actorPathNode->GetClusters(AT_MOVE, 40, pathingClusters, pathingClusterWeights);
+		pathingGraphView->GetClusters(actorPathNode, AT_MOVE, 40, pathingClusters, pathingClusterWeights);
 		for (auto itCluster = pathingClusterWeights.begin(); itCluster != pathingClusterWeights.end(); ++itCluster)
 		{
-			PathingNode* pathingClusterNodeEnd = graph->FindClusterNode((*itCluster).second->GetTarget()->GetCluster());
+			PathingNode* pathingClusterNodeEnd = pathingGraphView->FindClusterNode((*itCluster).second->GetTarget()->GetCluster());
 			if (clusterNodeEnd == pathingClusterNodeEnd)
 				continue;
 
@@ -2132,10 +2134,10 @@ void QuakeAIManager::BuildExpandedActorPath(
 
 		pathingClusters.clear();
 		pathingClusterWeights.clear();
-		actorPathNode->GetClusters(AT_JUMP, 30, pathingClusters, pathingClusterWeights);
+		pathingGraphView->GetClusters(actorPathNode, AT_JUMP, 30, pathingClusters, pathingClusterWeights);
 		for (auto itCluster = pathingClusterWeights.begin(); itCluster != pathingClusterWeights.end(); ++itCluster)
 		{
-			PathingNode* pathingClusterNodeEnd = graph->FindClusterNode((*itCluster).second->GetTarget()->GetCluster());
+			PathingNode* pathingClusterNodeEnd = pathingGraphView->FindClusterNode((*itCluster).second->GetTarget()->GetCluster());
 			if (clusterNodeEnd == pathingClusterNodeEnd)
 				continue;
 
@@ -2159,13 +2161,13 @@ void QuakeAIManager::BuildExpandedActorPath(
 	});
 }
 
-void QuakeAIManager::BuildActorPath(std::shared_ptr<PathingGraph>& graph,
+void QuakeAIManager::BuildActorPath(const std::shared_ptr<PathingGraphView>& pathingGraphView,
 	unsigned int actionType, const std::map<ActorId, float>& gameItems, const std::map<ActorId, float>& searchItems,
 	const PlayerData& player, PathingNode* clusterNodeStart, const PathingArcVec& clusterPathStart, float clusterPathOffset,
-	Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-	const Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& clusterNodePathPlans,
-	Concurrency::concurrent_unordered_map<unsigned long long, float>& actorPathPlanClusterHeuristics,
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& actorPathPlanClusters)
+	ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+	const ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& clusterNodePathPlans,
+	ConcurrentUnorderedMap<unsigned long long, float>& actorPathPlanClusterHeuristics,
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& actorPathPlanClusters)
 {
 	// find the best path using an A* search algorithm
 	AIFinder aiFinder;
@@ -2173,7 +2175,7 @@ void QuakeAIManager::BuildActorPath(std::shared_ptr<PathingGraph>& graph,
 	aiFinder(clusterNodeStart, searchItems, actorsPathPlans, actionType);
 
 	unsigned short actorIndex = 0;
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingActorVec> actorPaths;
+	ConcurrentUnorderedMap<unsigned long long, PathingActorVec> actorPaths;
 	for (auto& actorsPathPlan : actorsPathPlans)
 	{
 		actorPaths[actorIndex] = std::move(actorsPathPlan.first);
@@ -2186,14 +2188,14 @@ void QuakeAIManager::BuildActorPath(std::shared_ptr<PathingGraph>& graph,
 
 	std::mutex mutex;
 
-	Concurrency::concurrent_unordered_map<unsigned int, 
-		Concurrency::concurrent_unordered_map<unsigned long long, float>> actorClustersHeuristics;
-	Concurrency::concurrent_unordered_map<unsigned int, 
-		Concurrency::concurrent_unordered_map<unsigned long long, unsigned long long>> actorClustersCodes;
-	Concurrency::concurrent_unordered_map<unsigned int, 
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>> actorClustersPaths;
-	Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>> actorClusters;
-	Concurrency::parallel_for_each(begin(actorPaths), end(actorPaths), [&](auto const& actorPath)
+	ConcurrentUnorderedMap<unsigned int, 
+		ConcurrentUnorderedMap<unsigned long long, float>> actorClustersHeuristics;
+	ConcurrentUnorderedMap<unsigned int, 
+		ConcurrentUnorderedMap<unsigned long long, unsigned long long>> actorClustersCodes;
+	ConcurrentUnorderedMap<unsigned int, 
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec>> actorClustersPaths;
+	ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>> actorClusters;
+	ParallelForEach(begin(actorPaths), end(actorPaths), [&](auto const& actorPath)
 	//for (auto const& actorPath : actorPaths)
 	{
 		std::map<ActorId, float> actors;
@@ -2217,7 +2219,7 @@ void QuakeAIManager::BuildActorPath(std::shared_ptr<PathingGraph>& graph,
 			actors[pathingActor->GetActor()] = actorPathWeight;
 		}
 
-		PathingNode* actorNodeEnd = graph->FindClusterNode(currentActorNode->GetCluster());
+		PathingNode* actorNodeEnd = pathingGraphView->FindClusterNode(currentActorNode->GetCluster());
 
 		unsigned long long clusterActorCode = 
 			(unsigned long long)actionType << 60 | (unsigned long long)clusterNodeStart->GetId() << 46 | 
@@ -2227,10 +2229,11 @@ void QuakeAIManager::BuildActorPath(std::shared_ptr<PathingGraph>& graph,
 		//printf("\ncluster code %u", clusterActorCode);
 		if (clusterNodePathPlans.find(clusterActorCode) == clusterNodePathPlans.end())
 		{
-			PathingCluster* pathingCluster = clusterNodeStart->FindCluster(actionType, currentActorNode->GetCluster());
+			PathingCluster* pathingCluster =
+				pathingGraphView->FindCluster(clusterNodeStart, actionType, currentActorNode->GetCluster());
 			if (pathingCluster)
 			{
-				PathingNode* clusterNodeEnd = graph->FindClusterNode(pathingCluster->GetTarget()->GetCluster());
+				PathingNode* clusterNodeEnd = pathingGraphView->FindClusterNode(pathingCluster->GetTarget()->GetCluster());
 
 				unsigned long long clusterCode =
 					(unsigned long long)actionType << 60 | (unsigned long long)clusterNodeStart->GetId() << 46 | 
@@ -2238,14 +2241,7 @@ void QuakeAIManager::BuildActorPath(std::shared_ptr<PathingGraph>& graph,
 					(unsigned long long)clusterNodeEnd->GetId() << 14 | (unsigned long long)clusterNodeEnd->GetId();
 				//printf("\ncluster code %u", clusterCode);
 
-				PathingNode* currentNode = clusterNodeStart;
-				while (currentNode != pathingCluster->GetTarget())
-				{
-					PathingCluster* currentCluster = currentNode->FindCluster(actionType, pathingCluster->GetTarget());
-					PathingArc* currentArc = currentNode->FindArc(currentCluster->GetNode());
-
-					currentNode = currentArc->GetNode();
-				}
+				PathingNode* currentNode = pathingCluster->GetTarget();
 
 				//make sure that all items can be taken
 				bool takeItems = true;
@@ -2342,10 +2338,12 @@ void QuakeAIManager::BuildActorPath(std::shared_ptr<PathingGraph>& graph,
 void QuakeAIManager::BuildPlayerPath(const AIAnalysis::PlayerSimulation& playerSimulation,
 	PathingNode* playerNode, float playerPathOffset, PathingArcVec& playerPathPlan)
 {
+	std::shared_ptr<PathingGraphView> pathingGraphView = GetPathingGraphView();
+
 	PathingNode* pathingNode = playerNode;
 	for (auto path : playerSimulation.planPath)
 	{
-		PathingArc* pathingArc = pathingNode->FindArc(path);
+		PathingArc* pathingArc = pathingGraphView->FindArc(pathingNode, path);
 		playerPathPlan.push_back(pathingArc);
 
 		pathingNode = pathingArc->GetNode();
@@ -2359,6 +2357,8 @@ bool QuakeAIManager::SimulatePlayerGuessingDecision(
 	const PlayerData& otherPlayerDataIn, PlayerData& otherPlayerDataOut,
 	const std::map<ActorId, float>& gameItems, AIAnalysis::GameEvaluation& gameEvaluation)
 {
+	std::shared_ptr<PathingGraphView> pathingGraphView = GetPathingGraphView();
+
 	PathingNode* clusterNodeStart = playerDataIn.plan.node;
 	PathingNode* otherClusterNodeStart = otherPlayerDataIn.plan.node;
 	if (!clusterNodeStart || !otherClusterNodeStart)
@@ -2387,8 +2387,8 @@ bool QuakeAIManager::SimulatePlayerGuessingDecision(
 		searchItems[actor] = 0.f;
 	CalculateWeightItems(playerDataIn, searchItems);
 
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> otherPlayerPaths;
-	Concurrency::concurrent_unordered_map<unsigned long long, std::pair<unsigned int, unsigned int>> otherPlayerClusters;
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec> otherPlayerPaths;
+	ConcurrentUnorderedMap<unsigned long long, std::pair<unsigned int, unsigned int>> otherPlayerClusters;
 
 	//PrintInfo("\nGuessing clusters: ");
 	if (otherClusterNodeStart)
@@ -2408,23 +2408,23 @@ bool QuakeAIManager::SimulatePlayerGuessingDecision(
 	clusterNodeStart = playerDataOut.plan.node;
 	otherClusterNodeStart = otherPlayerDataOut.plan.node;
 
-	Concurrency::concurrent_unordered_map<unsigned long long, 
+	ConcurrentUnorderedMap<unsigned long long, 
 		std::pair<PathingCluster*, PathingCluster*>> clusterPathings, otherClusterPathings;
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> clusterNodePathPlans;
-	Concurrency::concurrent_unordered_map<unsigned long long, float> actorPathPlanClusterHeuristics;
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> actorPathPlanClusters;
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec> clusterNodePathPlans;
+	ConcurrentUnorderedMap<unsigned long long, float> actorPathPlanClusterHeuristics;
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec> actorPathPlanClusters;
 
 	std::vector<unsigned int> actionTypes{ AT_MOVE, AT_JUMP };
-	Concurrency::parallel_for_each(begin(actionTypes), end(actionTypes), [&](unsigned int actionType)
+	ParallelForEach(begin(actionTypes), end(actionTypes), [&](unsigned int actionType)
 	//for (unsigned int actionType : actionTypes)
 	{
-		Concurrency::concurrent_unordered_map<unsigned long long,
+		ConcurrentUnorderedMap<unsigned long long,
 			std::pair<PathingCluster*, PathingCluster*>> localClusterPathings;
-		Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+		ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 		//player
-		BuildActorPath(mPathingGraph, actionType, gameItems, searchItems,
+		BuildActorPath(pathingGraphView, actionType, gameItems, searchItems,
 			playerDataIn, clusterNodeStart, playerPathPlanOffset, playerPathOffset, localClusterPathings,
 			clusterNodePathPlans, localActorPathPlanClusterHeuristics, localActorPathPlanClusters);
 
@@ -2451,11 +2451,11 @@ bool QuakeAIManager::SimulatePlayerGuessingDecision(
 		actorPathPlanClusterHeuristics.clear();
 		actorPathPlanClusters.clear();
 
-		BuildLongPath(mPathingGraph, clusterNodeStart, clusterPathings, clusterNodePathPlans);
+		BuildLongPath(pathingGraphView, clusterNodeStart, clusterPathings, clusterNodePathPlans);
 	}
 	else
 	{
-		BuildExpandedActorPath(mPathingGraph, clusterNodeStart, 
+		BuildExpandedActorPath(pathingGraphView, clusterNodeStart, 
 			heuristicThreshold, clusterPathings, actorPathPlanClusters, actorPathPlanClusterHeuristics);
 	}
 
@@ -2465,8 +2465,8 @@ bool QuakeAIManager::SimulatePlayerGuessingDecision(
 			for (auto it = playerPathPlanOffset.rbegin(); it != playerPathPlanOffset.rend(); it++)
 				clusterNodePathPlan.second.insert(clusterNodePathPlan.second.begin(), *it);
 
-	Concurrency::concurrent_vector<AIAnalysis::GameSimulation*> playerDecisions;
-	Concurrency::parallel_for(size_t(0), clusterPathings.size(), [&](size_t clusterIdx)
+	ConcurrentVector<AIAnalysis::GameSimulation*> playerDecisions;
+	ParallelFor(size_t(0), clusterPathings.size(), [&](size_t clusterIdx)
 	{
 		auto itCluster = clusterPathings.begin();
 		std::advance(itCluster, clusterIdx);
@@ -2476,13 +2476,13 @@ bool QuakeAIManager::SimulatePlayerGuessingDecision(
 
 		//cluster code
 		unsigned long long clusterCode = (*itCluster).first;
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
 		itClusterNodePathPlan = actorPathPlanClusters.find(clusterCode);
 		if (itClusterNodePathPlan == actorPathPlanClusters.end())
 			itClusterNodePathPlan = clusterNodePathPlans.find(clusterCode);
 
-		Concurrency::concurrent_vector<AIAnalysis::Simulation*> playerSimulations;
-		Concurrency::parallel_for_each(
+		ConcurrentVector<AIAnalysis::Simulation*> playerSimulations;
+		ParallelForEach(
 			begin(otherPlayerClusters), end(otherPlayerClusters), [&](auto const& otherPlayerCluster)
 		//for (auto const& otherPlayerCluster : otherPlayerClusters)
 		{
@@ -2524,8 +2524,8 @@ bool QuakeAIManager::SimulatePlayerGuessingDecision(
 
 	if (playerDataIn.valid)
 	{
-		Concurrency::concurrent_vector<AIAnalysis::Simulation*> playerSimulations;
-		Concurrency::parallel_for_each(
+		ConcurrentVector<AIAnalysis::Simulation*> playerSimulations;
+		ParallelForEach(
 			begin(otherPlayerClusters), end(otherPlayerClusters), [&](auto const& otherPlayerCluster)
 		//for (auto const& otherPathingClusterNode : otherPathingClusterNodes)
 		{
@@ -2604,7 +2604,7 @@ bool QuakeAIManager::SimulatePlayerGuessingDecision(
 		//cluster code
 		if (playerClusterCode != ULLONG_MAX)
 		{
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
 			itClusterNodePathPlan = actorPathPlanClusters.find(playerClusterCode);
 			if (itClusterNodePathPlan == actorPathPlanClusters.end())
 				itClusterNodePathPlan = clusterNodePathPlans.find(playerClusterCode);
@@ -2720,6 +2720,8 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 	const PlayerData& otherPlayerDataIn, PlayerData& otherPlayerDataOut,
 	const std::map<ActorId, float>& gameItems, AIAnalysis::GameEvaluation& gameEvaluation)
 {
+	std::shared_ptr<PathingGraphView> pathingGraphView = GetPathingGraphView();
+
 	PathingNode* clusterNodeStart = playerDataIn.plan.node;
 	PathingNode* otherClusterNodeStart = otherPlayerDataIn.plan.node;
 	if (!clusterNodeStart || !otherClusterNodeStart || clusterNodeStart == otherClusterNodeStart)
@@ -2761,29 +2763,29 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 	clusterNodeStart = playerDataOut.plan.node;
 	otherClusterNodeStart = otherPlayerDataOut.plan.node;
 
-	Concurrency::concurrent_unordered_map<unsigned long long,
+	ConcurrentUnorderedMap<unsigned long long,
 		std::pair<PathingCluster*, PathingCluster*>> clusterPathings, otherClusterPathings;
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> clusterNodePathPlans, otherClusterNodePathPlans;
-	Concurrency::concurrent_unordered_map<unsigned long long, float> actorPathPlanClusterHeuristics, otherActorPathPlanClusterHeuristics;
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> actorPathPlanClusters, otherActorPathPlanClusters;
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec> clusterNodePathPlans, otherClusterNodePathPlans;
+	ConcurrentUnorderedMap<unsigned long long, float> actorPathPlanClusterHeuristics, otherActorPathPlanClusterHeuristics;
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec> actorPathPlanClusters, otherActorPathPlanClusters;
 
-	if (BuildPath(mPathingGraph, clusterNodeStart, otherClusterNodeStart, 
+	if (BuildPath(pathingGraphView, clusterNodeStart, otherClusterNodeStart, 
 		clusterPathings, otherClusterPathings, clusterNodePathPlans, otherClusterNodePathPlans))
 	{
 		std::mutex mutex;
 
-		Concurrency::parallel_for_each(begin(actionTypes), end(actionTypes), [&](auto& actionType)
+		ParallelForEach(begin(actionTypes), end(actionTypes), [&](auto& actionType)
 		//for (auto& actionType : actionTypes)
 		{
 			if (actionType.first == playerDataIn.player)
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, searchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, searchItems,
 					playerDataIn, clusterNodeStart, playerPathPlanOffset, playerPathOffset, localClusterPathings,
 					clusterNodePathPlans, localActorPathPlanClusterHeuristics, localActorPathPlanClusters);
 
@@ -2797,13 +2799,13 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 			}
 			else
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localOtherClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//other player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, otherSearchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, otherSearchItems,
 					otherPlayerDataIn, otherClusterNodeStart, otherPlayerPathPlanOffset, otherPlayerPathOffset,
 					localOtherClusterPathings, otherClusterNodePathPlans, localActorPathPlanClusterHeuristics,
 					localActorPathPlanClusters);
@@ -2818,40 +2820,40 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 			}
 		});
 
-		Concurrency::parallel_invoke(
+		ParallelInvoke(
 			[&] {			
 				//player
-				BuildExpandedActorPath(mPathingGraph, clusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, clusterNodeStart,
 					clusterPathings, actorPathPlanClusters, actorPathPlanClusterHeuristics); },
 			[&] {
 				//other player
-				BuildExpandedActorPath(mPathingGraph, otherClusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, otherClusterNodeStart,
 					otherClusterPathings, otherActorPathPlanClusters, otherActorPathPlanClusterHeuristics);}
 		);
 	}
 	else
 	{
-		if (!BuildLongPath(mPathingGraph, clusterNodeStart, otherClusterNodeStart,
+		if (!BuildLongPath(pathingGraphView, clusterNodeStart, otherClusterNodeStart,
 			clusterPathings, otherClusterPathings, clusterNodePathPlans, otherClusterNodePathPlans))
 		{
-			BuildLongestPath(mPathingGraph, clusterNodeStart, otherClusterNodeStart,
+			BuildLongestPath(pathingGraphView, clusterNodeStart, otherClusterNodeStart,
 				clusterPathings, otherClusterPathings, clusterNodePathPlans, otherClusterNodePathPlans);
 		}
 
 		std::mutex mutex;
 
-		Concurrency::parallel_for_each(begin(actionTypes), end(actionTypes), [&](auto& actionType)
+		ParallelForEach(begin(actionTypes), end(actionTypes), [&](auto& actionType)
 		//for (auto& actionType : actionTypes)
 		{
 			if (actionType.first == playerDataIn.player)
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, searchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, searchItems,
 					playerDataIn, clusterNodeStart, playerPathPlanOffset, playerPathOffset, localClusterPathings,
 					clusterNodePathPlans, localActorPathPlanClusterHeuristics, localActorPathPlanClusters);
 
@@ -2865,13 +2867,13 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 			}
 			else
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localOtherClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//other player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, otherSearchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, otherSearchItems,
 					otherPlayerDataIn, otherClusterNodeStart, otherPlayerPathPlanOffset, otherPlayerPathOffset,
 					localOtherClusterPathings, otherClusterNodePathPlans, localActorPathPlanClusterHeuristics,
 					localActorPathPlanClusters);
@@ -2886,14 +2888,14 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 			}
 		});
 
-		Concurrency::parallel_invoke(
+		ParallelInvoke(
 			[&] {			
 				//player
-				BuildExpandedActorPath(mPathingGraph, clusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, clusterNodeStart,
 					clusterPathings, actorPathPlanClusters, actorPathPlanClusterHeuristics); },
 			[&] {
 				//other player
-				BuildExpandedActorPath(mPathingGraph, otherClusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, otherClusterNodeStart,
 					otherClusterPathings, otherActorPathPlanClusters, otherActorPathPlanClusterHeuristics);}
 		);
 	}
@@ -2908,8 +2910,8 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 			for (auto it = otherPlayerPathPlanOffset.rbegin(); it != otherPlayerPathPlanOffset.rend(); it++)
 				otherClusterNodePathPlan.second.insert(otherClusterNodePathPlan.second.begin(), *it);
 
-	Concurrency::concurrent_vector<AIAnalysis::GameSimulation*> playerGuessings;
-	Concurrency::parallel_for(size_t(0), clusterPathings.size(), [&](size_t clusterIdx)
+	ConcurrentVector<AIAnalysis::GameSimulation*> playerGuessings;
+	ParallelFor(size_t(0), clusterPathings.size(), [&](size_t clusterIdx)
 	{
 		auto itCluster = clusterPathings.begin();
 		std::advance(itCluster, clusterIdx);
@@ -2919,13 +2921,13 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 
 		//cluster code
 		unsigned long long clusterCode = (*itCluster).first;
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
 		itClusterNodePathPlan = actorPathPlanClusters.find(clusterCode);
 		if (itClusterNodePathPlan == actorPathPlanClusters.end())
 			itClusterNodePathPlan = clusterNodePathPlans.find(clusterCode);
 
-		Concurrency::concurrent_vector<AIAnalysis::Simulation*> playerSimulations;
-		Concurrency::parallel_for(size_t(0), otherClusterPathings.size(), [&](size_t otherClusterIdx)
+		ConcurrentVector<AIAnalysis::Simulation*> playerSimulations;
+		ParallelFor(size_t(0), otherClusterPathings.size(), [&](size_t otherClusterIdx)
 		{
 			auto itOtherCluster = otherClusterPathings.begin();
 			std::advance(itOtherCluster, otherClusterIdx);
@@ -2935,7 +2937,7 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 
 			//other cluster code
 			unsigned long long otherClusterCode = (*itOtherCluster).first;
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 			itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherClusterCode);
 			if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 				itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherClusterCode);
@@ -3007,8 +3009,8 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 	
 	if (playerDataIn.valid)
 	{
-		Concurrency::concurrent_vector<AIAnalysis::Simulation*> playerSimulations;
-		Concurrency::parallel_for(size_t(0), otherClusterPathings.size(), [&](size_t otherClusterIdx)
+		ConcurrentVector<AIAnalysis::Simulation*> playerSimulations;
+		ParallelFor(size_t(0), otherClusterPathings.size(), [&](size_t otherClusterIdx)
 		{
 			auto itOtherCluster = otherClusterPathings.begin();
 			std::advance(itOtherCluster, otherClusterIdx);
@@ -3018,7 +3020,7 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 
 			//other cluster code
 			unsigned long long otherClusterCode = (*itOtherCluster).first;
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 			itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherClusterCode);
 			if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 				itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherClusterCode);
@@ -3129,7 +3131,7 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 		//cluster code
 		if (playerClusterCode != ULLONG_MAX)
 		{
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
 			itClusterNodePathPlan = actorPathPlanClusters.find(playerClusterCode);
 			if (itClusterNodePathPlan == actorPathPlanClusters.end())
 				itClusterNodePathPlan = clusterNodePathPlans.find(playerClusterCode);
@@ -3137,7 +3139,7 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 			//other cluster code
 			if (otherPlayerClusterCode != ULLONG_MAX)
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 				itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherPlayerClusterCode);
 				if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 					itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherPlayerClusterCode);
@@ -3180,7 +3182,7 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 		}
 		else if (otherPlayerClusterCode != ULLONG_MAX)
 		{
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 			itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherPlayerClusterCode);
 			if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 				itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherPlayerClusterCode);
@@ -3248,6 +3250,8 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 	const PlayerData& otherPlayerDataIn, PlayerData& otherPlayerDataOut,
 	const std::map<ActorId, float>& gameItems, AIAnalysis::GameEvaluation& gameEvaluation)
 {
+	std::shared_ptr<PathingGraphView> pathingGraphView = GetPathingGraphView();
+
 	PathingNode* clusterNodeStart = playerDataIn.plan.node;
 	PathingNode* otherClusterNodeStart = otherPlayerDataIn.plan.node;
 	if (!clusterNodeStart || !otherClusterNodeStart || clusterNodeStart == otherClusterNodeStart)
@@ -3289,29 +3293,29 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 	clusterNodeStart = playerDataOut.plan.node;
 	otherClusterNodeStart = otherPlayerDataOut.plan.node;
 
-	Concurrency::concurrent_unordered_map<unsigned long long,
+	ConcurrentUnorderedMap<unsigned long long,
 		std::pair<PathingCluster*, PathingCluster*>> clusterPathings, otherClusterPathings;
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> clusterNodePathPlans, otherClusterNodePathPlans;
-	Concurrency::concurrent_unordered_map<unsigned long long, float> actorPathPlanClusterHeuristics, otherActorPathPlanClusterHeuristics;
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> actorPathPlanClusters, otherActorPathPlanClusters;
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec> clusterNodePathPlans, otherClusterNodePathPlans;
+	ConcurrentUnorderedMap<unsigned long long, float> actorPathPlanClusterHeuristics, otherActorPathPlanClusterHeuristics;
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec> actorPathPlanClusters, otherActorPathPlanClusters;
 
-	if (BuildPath(mPathingGraph, clusterNodeStart, otherClusterNodeStart, 
+	if (BuildPath(pathingGraphView, clusterNodeStart, otherClusterNodeStart, 
 		clusterPathings, otherClusterPathings, clusterNodePathPlans, otherClusterNodePathPlans))
 	{
 		std::mutex mutex;
 
-		Concurrency::parallel_for_each(begin(actionTypes), end(actionTypes), [&](auto& actionType)
+		ParallelForEach(begin(actionTypes), end(actionTypes), [&](auto& actionType)
 		//for (auto& actionType : actionTypes)
 		{
 			if (actionType.first == playerDataIn.player)
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, searchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, searchItems,
 					playerDataIn, clusterNodeStart, playerPathPlanOffset, playerPathOffset, localClusterPathings,
 					clusterNodePathPlans, localActorPathPlanClusterHeuristics, localActorPathPlanClusters);
 
@@ -3325,13 +3329,13 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 			}
 			else
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localOtherClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//other player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, otherSearchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, otherSearchItems,
 					otherPlayerDataIn, otherClusterNodeStart, otherPlayerPathPlanOffset, otherPlayerPathOffset,
 					localOtherClusterPathings, otherClusterNodePathPlans, localActorPathPlanClusterHeuristics,
 					localActorPathPlanClusters);
@@ -3346,40 +3350,40 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 			}
 		});
 
-		Concurrency::parallel_invoke(
+		ParallelInvoke(
 			[&] {			
 				//player
-				BuildExpandedActorPath(mPathingGraph, clusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, clusterNodeStart,
 					clusterPathings, actorPathPlanClusters, actorPathPlanClusterHeuristics); },
 			[&] {
 				//other player
-				BuildExpandedActorPath(mPathingGraph, otherClusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, otherClusterNodeStart,
 					otherClusterPathings, otherActorPathPlanClusters, otherActorPathPlanClusterHeuristics); }
 		);
 	}
 	else
 	{
-		if (!BuildLongPath(mPathingGraph, clusterNodeStart, otherClusterNodeStart,
+		if (!BuildLongPath(pathingGraphView, clusterNodeStart, otherClusterNodeStart,
 			clusterPathings, otherClusterPathings, clusterNodePathPlans, otherClusterNodePathPlans))
 		{
-			BuildLongestPath(mPathingGraph, clusterNodeStart, otherClusterNodeStart,
+			BuildLongestPath(pathingGraphView, clusterNodeStart, otherClusterNodeStart,
 				clusterPathings, otherClusterPathings, clusterNodePathPlans, otherClusterNodePathPlans);
 		}
 
 		std::mutex mutex;
 
-		Concurrency::parallel_for_each(begin(actionTypes), end(actionTypes), [&](auto& actionType)
+		ParallelForEach(begin(actionTypes), end(actionTypes), [&](auto& actionType)
 		//for (auto& actionType : actionTypes)
 		{
 			if (actionType.first == playerDataIn.player)
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, searchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, searchItems,
 					playerDataIn, clusterNodeStart, playerPathPlanOffset, playerPathOffset, localClusterPathings,
 					clusterNodePathPlans, localActorPathPlanClusterHeuristics, localActorPathPlanClusters);
 
@@ -3393,13 +3397,13 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 			}
 			else
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localOtherClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//other player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, otherSearchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, otherSearchItems,
 					otherPlayerDataIn, otherClusterNodeStart, otherPlayerPathPlanOffset, otherPlayerPathOffset,
 					localOtherClusterPathings, otherClusterNodePathPlans, localActorPathPlanClusterHeuristics,
 					localActorPathPlanClusters);
@@ -3414,14 +3418,14 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 			}
 		});
 
-		Concurrency::parallel_invoke(
+		ParallelInvoke(
 			[&] {			
 				//player
-				BuildExpandedActorPath(mPathingGraph, clusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, clusterNodeStart,
 					clusterPathings, actorPathPlanClusters, actorPathPlanClusterHeuristics); },
 			[&] {
 				//other player
-				BuildExpandedActorPath(mPathingGraph, otherClusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, otherClusterNodeStart,
 					otherClusterPathings, otherActorPathPlanClusters, otherActorPathPlanClusterHeuristics);}
 		);
 	}
@@ -3436,9 +3440,9 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 			for (auto it = otherPlayerPathPlanOffset.rbegin(); it != otherPlayerPathPlanOffset.rend(); it++)
 				otherClusterNodePathPlan.second.insert(otherClusterNodePathPlan.second.begin(), *it);
 
-	Concurrency::concurrent_vector<AIAnalysis::GameSimulation*> playerGuessings;
-	Concurrency::concurrent_unordered_map<size_t, Concurrency::concurrent_vector<AIAnalysis::Simulation*>> playerDecisions;
-	Concurrency::parallel_for(size_t(0), clusterPathings.size(), [&](size_t clusterIdx)
+	ConcurrentVector<AIAnalysis::GameSimulation*> playerGuessings;
+	ConcurrentUnorderedMap<size_t, ConcurrentVector<AIAnalysis::Simulation*>> playerDecisions;
+	ParallelFor(size_t(0), clusterPathings.size(), [&](size_t clusterIdx)
 	{
 		auto itCluster = clusterPathings.begin();
 		std::advance(itCluster, clusterIdx);
@@ -3448,13 +3452,13 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 
 		//cluster code
 		unsigned long long clusterCode = (*itCluster).first;
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
 		itClusterNodePathPlan = actorPathPlanClusters.find(clusterCode);
 		if (itClusterNodePathPlan == actorPathPlanClusters.end())
 			itClusterNodePathPlan = clusterNodePathPlans.find(clusterCode);
 
-		Concurrency::concurrent_vector<AIAnalysis::Simulation*> playerSimulations;
-		Concurrency::parallel_for(size_t(0), otherClusterPathings.size(), [&](size_t otherClusterIdx)
+		ConcurrentVector<AIAnalysis::Simulation*> playerSimulations;
+		ParallelFor(size_t(0), otherClusterPathings.size(), [&](size_t otherClusterIdx)
 		{
 			auto itOtherCluster = otherClusterPathings.begin();
 			std::advance(itOtherCluster, otherClusterIdx);
@@ -3464,7 +3468,7 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 
 			//other cluster code
 			unsigned long long otherClusterCode = (*itOtherCluster).first;
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 			itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherClusterCode);
 			if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 				itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherClusterCode);
@@ -3540,8 +3544,8 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 	
 	if (playerDataIn.valid)
 	{
-		Concurrency::concurrent_vector<AIAnalysis::Simulation*> playerSimulations;
-		Concurrency::parallel_for(size_t(0), otherClusterPathings.size(), [&](size_t otherClusterIdx)
+		ConcurrentVector<AIAnalysis::Simulation*> playerSimulations;
+		ParallelFor(size_t(0), otherClusterPathings.size(), [&](size_t otherClusterIdx)
 		{
 			auto itOtherCluster = otherClusterPathings.begin();
 			std::advance(itOtherCluster, otherClusterIdx);
@@ -3551,7 +3555,7 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 
 			//other cluster code
 			unsigned long long otherClusterCode = (*itOtherCluster).first;
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 			itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherClusterCode);
 			if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 				itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherClusterCode);
@@ -3708,14 +3712,14 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 		//cluster code
 		if (playerClusterCode != ULLONG_MAX)
 		{
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
 			itClusterNodePathPlan = actorPathPlanClusters.find(playerClusterCode);
 			if (itClusterNodePathPlan == actorPathPlanClusters.end())
 				itClusterNodePathPlan = clusterNodePathPlans.find(playerClusterCode);
 
 			if (otherPlayerClusterCode != ULLONG_MAX)
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 				itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherPlayerClusterCode);
 				if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 					itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherPlayerClusterCode);
@@ -3760,7 +3764,7 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 		}
 		else if (otherPlayerClusterCode != ULLONG_MAX)
 		{
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 			itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherPlayerClusterCode);
 			if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 				itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherPlayerClusterCode);
@@ -3837,6 +3841,8 @@ bool QuakeAIManager::SimulatePlayerDecision(
 	const PlayerData& otherPlayerDataIn, PlayerData& otherPlayerDataOut,
 	const std::map<ActorId, float>& gameItems, AIAnalysis::GameEvaluation& gameEvaluation)
 {
+	std::shared_ptr<PathingGraphView> pathingGraphView = GetPathingGraphView();
+
 	PathingNode* clusterNodeStart = playerDataIn.plan.node;
 	PathingNode* otherClusterNodeStart = otherPlayerDataIn.plan.node;
 	if (!clusterNodeStart || !otherClusterNodeStart || clusterNodeStart == otherClusterNodeStart)
@@ -3878,29 +3884,29 @@ bool QuakeAIManager::SimulatePlayerDecision(
 	clusterNodeStart = playerDataOut.plan.node;
 	otherClusterNodeStart = otherPlayerDataOut.plan.node;
 
-	Concurrency::concurrent_unordered_map<unsigned long long,
+	ConcurrentUnorderedMap<unsigned long long,
 		std::pair<PathingCluster*, PathingCluster*>> clusterPathings, otherClusterPathings;
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> clusterNodePathPlans, otherClusterNodePathPlans;
-	Concurrency::concurrent_unordered_map<unsigned long long, float> actorPathPlanClusterHeuristics, otherActorPathPlanClusterHeuristics;
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> actorPathPlanClusters, otherActorPathPlanClusters;
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec> clusterNodePathPlans, otherClusterNodePathPlans;
+	ConcurrentUnorderedMap<unsigned long long, float> actorPathPlanClusterHeuristics, otherActorPathPlanClusterHeuristics;
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec> actorPathPlanClusters, otherActorPathPlanClusters;
 
-	if (BuildPath(mPathingGraph, clusterNodeStart, otherClusterNodeStart, 
+	if (BuildPath(pathingGraphView, clusterNodeStart, otherClusterNodeStart, 
 		clusterPathings, otherClusterPathings, clusterNodePathPlans, otherClusterNodePathPlans))
 	{
 		std::mutex mutex;
 
-		Concurrency::parallel_for_each(begin(actionTypes), end(actionTypes), [&](auto& actionType)
+		ParallelForEach(begin(actionTypes), end(actionTypes), [&](auto& actionType)
 		//for (auto& actionType : actionTypes)
 		{
 			if (actionType.first == playerDataIn.player)
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, searchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, searchItems,
 					playerDataIn, clusterNodeStart, playerPathPlanOffset, playerPathOffset, localClusterPathings,
 					clusterNodePathPlans, localActorPathPlanClusterHeuristics, localActorPathPlanClusters);
 
@@ -3914,13 +3920,13 @@ bool QuakeAIManager::SimulatePlayerDecision(
 			}
 			else
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localOtherClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//other player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, otherSearchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, otherSearchItems,
 					otherPlayerDataIn, otherClusterNodeStart, otherPlayerPathPlanOffset, otherPlayerPathOffset,
 					localOtherClusterPathings, otherClusterNodePathPlans, localActorPathPlanClusterHeuristics,
 					localActorPathPlanClusters);
@@ -3935,40 +3941,40 @@ bool QuakeAIManager::SimulatePlayerDecision(
 			}
 		});
 
-		Concurrency::parallel_invoke(
+		ParallelInvoke(
 			[&] {			
 				//player
-				BuildExpandedActorPath(mPathingGraph, clusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, clusterNodeStart,
 					clusterPathings, actorPathPlanClusters, actorPathPlanClusterHeuristics); },
 			[&] {
 				//other player
-				BuildExpandedActorPath(mPathingGraph, otherClusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, otherClusterNodeStart,
 					otherClusterPathings, otherActorPathPlanClusters, otherActorPathPlanClusterHeuristics);}
 		);
 	}
 	else
 	{
-		if (!BuildLongPath(mPathingGraph, clusterNodeStart, otherClusterNodeStart,
+		if (!BuildLongPath(pathingGraphView, clusterNodeStart, otherClusterNodeStart,
 			clusterPathings, otherClusterPathings, clusterNodePathPlans, otherClusterNodePathPlans))
 		{
-			BuildLongestPath(mPathingGraph, clusterNodeStart, otherClusterNodeStart,
+			BuildLongestPath(pathingGraphView, clusterNodeStart, otherClusterNodeStart,
 				clusterPathings, otherClusterPathings, clusterNodePathPlans, otherClusterNodePathPlans);
 		}
 
 		std::mutex mutex;
 
-		Concurrency::parallel_for_each(begin(actionTypes), end(actionTypes), [&](auto& actionType)
+		ParallelForEach(begin(actionTypes), end(actionTypes), [&](auto& actionType)
 		//for (auto& actionType : actionTypes)
 		{
 			if (actionType.first == playerDataIn.player)
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, searchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, searchItems,
 					playerDataIn, clusterNodeStart, playerPathPlanOffset, playerPathOffset, localClusterPathings,
 					clusterNodePathPlans, localActorPathPlanClusterHeuristics, localActorPathPlanClusters);
 
@@ -3982,13 +3988,13 @@ bool QuakeAIManager::SimulatePlayerDecision(
 			}
 			else
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localOtherClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//other player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, otherSearchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, otherSearchItems,
 					otherPlayerDataIn, otherClusterNodeStart, otherPlayerPathPlanOffset, otherPlayerPathOffset,
 					localOtherClusterPathings, otherClusterNodePathPlans, localActorPathPlanClusterHeuristics,
 					localActorPathPlanClusters);
@@ -4003,14 +4009,14 @@ bool QuakeAIManager::SimulatePlayerDecision(
 			}
 		});
 
-		Concurrency::parallel_invoke(
+		ParallelInvoke(
 			[&] {			
 				//player
-				BuildExpandedActorPath(mPathingGraph, clusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, clusterNodeStart,
 					clusterPathings, actorPathPlanClusters, actorPathPlanClusterHeuristics); },
 			[&] {
 				//other player
-				BuildExpandedActorPath(mPathingGraph, otherClusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, otherClusterNodeStart,
 					otherClusterPathings, otherActorPathPlanClusters, otherActorPathPlanClusterHeuristics);}
 		);
 	}
@@ -4025,9 +4031,9 @@ bool QuakeAIManager::SimulatePlayerDecision(
 			for (auto it = otherPlayerPathPlanOffset.rbegin(); it != otherPlayerPathPlanOffset.rend(); it++)
 				otherClusterNodePathPlan.second.insert(otherClusterNodePathPlan.second.begin(), *it);
 
-	Concurrency::concurrent_vector<AIAnalysis::GameSimulation*> playerDecisions;
-	Concurrency::concurrent_unordered_map<size_t, Concurrency::concurrent_vector<AIAnalysis::Simulation*>> playerGuessings;
-	Concurrency::parallel_for(size_t(0), clusterPathings.size(), [&](size_t clusterIdx)
+	ConcurrentVector<AIAnalysis::GameSimulation*> playerDecisions;
+	ConcurrentUnorderedMap<size_t, ConcurrentVector<AIAnalysis::Simulation*>> playerGuessings;
+	ParallelFor(size_t(0), clusterPathings.size(), [&](size_t clusterIdx)
 	{
 		auto itCluster = clusterPathings.begin();
 		std::advance(itCluster, clusterIdx);
@@ -4037,13 +4043,13 @@ bool QuakeAIManager::SimulatePlayerDecision(
 
 		//cluster code
 		unsigned long long clusterCode = (*itCluster).first;
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
 		itClusterNodePathPlan = actorPathPlanClusters.find(clusterCode);
 		if (itClusterNodePathPlan == actorPathPlanClusters.end())
 			itClusterNodePathPlan = clusterNodePathPlans.find(clusterCode);
 
-		Concurrency::concurrent_vector<AIAnalysis::Simulation*> playerSimulations;
-		Concurrency::parallel_for(size_t(0), otherClusterPathings.size(), [&](size_t otherClusterIdx)
+		ConcurrentVector<AIAnalysis::Simulation*> playerSimulations;
+		ParallelFor(size_t(0), otherClusterPathings.size(), [&](size_t otherClusterIdx)
 		{
 			auto itOtherCluster = otherClusterPathings.begin();
 			std::advance(itOtherCluster, otherClusterIdx);
@@ -4053,7 +4059,7 @@ bool QuakeAIManager::SimulatePlayerDecision(
 
 			//other cluster code
 			unsigned long long otherClusterCode = (*itOtherCluster).first;
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 			itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherClusterCode);
 			if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 				itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherClusterCode);
@@ -4130,8 +4136,8 @@ bool QuakeAIManager::SimulatePlayerDecision(
 
 	if (playerDataIn.valid)
 	{
-		Concurrency::concurrent_vector<AIAnalysis::Simulation*> playerSimulations;
-		Concurrency::parallel_for(size_t(0), otherClusterPathings.size(), [&](size_t otherClusterIdx)
+		ConcurrentVector<AIAnalysis::Simulation*> playerSimulations;
+		ParallelFor(size_t(0), otherClusterPathings.size(), [&](size_t otherClusterIdx)
 		{
 			auto itOtherCluster = otherClusterPathings.begin();
 			std::advance(itOtherCluster, otherClusterIdx);
@@ -4141,7 +4147,7 @@ bool QuakeAIManager::SimulatePlayerDecision(
 
 			//other cluster code
 			unsigned long long otherClusterCode = (*itOtherCluster).first;
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 			itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherClusterCode);
 			if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 				itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherClusterCode);
@@ -4297,14 +4303,14 @@ bool QuakeAIManager::SimulatePlayerDecision(
 		//cluster code
 		if (playerClusterCode != ULLONG_MAX)
 		{
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
 			itClusterNodePathPlan = actorPathPlanClusters.find(playerClusterCode);
 			if (itClusterNodePathPlan == actorPathPlanClusters.end())
 				itClusterNodePathPlan = clusterNodePathPlans.find(playerClusterCode);
 
 			if (otherPlayerClusterCode != ULLONG_MAX)
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 				itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherPlayerClusterCode);
 				if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 					itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherPlayerClusterCode);
@@ -4349,7 +4355,7 @@ bool QuakeAIManager::SimulatePlayerDecision(
 		}
 		else if (otherPlayerClusterCode != ULLONG_MAX)
 		{
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 			itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherPlayerClusterCode);
 			if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 				itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherPlayerClusterCode);
@@ -4429,6 +4435,8 @@ bool QuakeAIManager::SimulatePlayerGuessingDecision(
 	const PlayerData& otherPlayerDataIn, PlayerData& otherPlayerDataOut,
 	const std::map<ActorId, float>& gameItems, ActorId playerEvaluation, EvaluationType evaluation)
 {
+	std::shared_ptr<PathingGraphView> pathingGraphView = GetPathingGraphView();
+
 	PathingNode* clusterNodeStart = playerDataIn.plan.node;
 	PathingNode* otherClusterNodeStart = otherPlayerDataIn.plan.node;
 	if (!clusterNodeStart || !otherClusterNodeStart)
@@ -4461,8 +4469,8 @@ bool QuakeAIManager::SimulatePlayerGuessingDecision(
 	if (evaluation != ET_AWARENESS && mPlayerEvaluations.at(playerEvaluation) == ET_AWARENESS)
 		return false;
 
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> otherPlayerPaths;
-	Concurrency::concurrent_unordered_map<unsigned long long, std::pair<unsigned int, unsigned int>> otherPlayerClusters;
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec> otherPlayerPaths;
+	ConcurrentUnorderedMap<unsigned long long, std::pair<unsigned int, unsigned int>> otherPlayerClusters;
 
 	//PrintInfo("\nGuessing clusters: ");
 	if (otherClusterNodeStart)
@@ -4486,23 +4494,23 @@ bool QuakeAIManager::SimulatePlayerGuessingDecision(
 	clusterNodeStart = playerDataOut.plan.node;
 	otherClusterNodeStart = otherPlayerDataOut.plan.node;
 
-	Concurrency::concurrent_unordered_map<unsigned long long,
+	ConcurrentUnorderedMap<unsigned long long,
 		std::pair<PathingCluster*, PathingCluster*>> clusterPathings, otherClusterPathings;
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> clusterNodePathPlans;
-	Concurrency::concurrent_unordered_map<unsigned long long, float> actorPathPlanClusterHeuristics;
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> actorPathPlanClusters;
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec> clusterNodePathPlans;
+	ConcurrentUnorderedMap<unsigned long long, float> actorPathPlanClusterHeuristics;
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec> actorPathPlanClusters;
 
 	std::vector<unsigned int> actionTypes{ AT_MOVE, AT_JUMP };
-	Concurrency::parallel_for_each(begin(actionTypes), end(actionTypes), [&](unsigned int actionType)
+	ParallelForEach(begin(actionTypes), end(actionTypes), [&](unsigned int actionType)
 	//for (unsigned int actionType : actionTypes)
 	{
-		Concurrency::concurrent_unordered_map<unsigned long long,
+		ConcurrentUnorderedMap<unsigned long long,
 			std::pair<PathingCluster*, PathingCluster*>> localClusterPathings;
-		Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+		ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 		//player
-		BuildActorPath(mPathingGraph, actionType, gameItems, searchItems,
+		BuildActorPath(pathingGraphView, actionType, gameItems, searchItems,
 			playerDataIn, clusterNodeStart, playerPathPlanOffset, playerPathOffset, localClusterPathings,
 			clusterNodePathPlans, localActorPathPlanClusterHeuristics, localActorPathPlanClusters);
 
@@ -4528,11 +4536,11 @@ bool QuakeAIManager::SimulatePlayerGuessingDecision(
 		actorPathPlanClusterHeuristics.clear();
 		actorPathPlanClusters.clear();
 
-		BuildLongPath(mPathingGraph, clusterNodeStart, clusterPathings, clusterNodePathPlans);
+		BuildLongPath(pathingGraphView, clusterNodeStart, clusterPathings, clusterNodePathPlans);
 	}
 	else
 	{
-		BuildExpandedActorPath(mPathingGraph, clusterNodeStart, 
+		BuildExpandedActorPath(pathingGraphView, clusterNodeStart, 
 			heuristicThreshold, clusterPathings, actorPathPlanClusters, actorPathPlanClusterHeuristics);
 	}
 
@@ -4546,25 +4554,25 @@ bool QuakeAIManager::SimulatePlayerGuessingDecision(
 			for (auto it = playerPathPlanOffset.rbegin(); it != playerPathPlanOffset.rend(); it++)
 				clusterNodePathPlan.second.insert(clusterNodePathPlan.second.begin(), *it);
 
-	Concurrency::concurrent_unordered_map<unsigned long long, 
-		Concurrency::concurrent_unordered_map<unsigned long long, float>> playerDecisions;
-	Concurrency::concurrent_unordered_map<unsigned long long,
-		Concurrency::concurrent_unordered_map<unsigned long long, unsigned short>> playerWeaponDecisions;
-	Concurrency::parallel_for(size_t(0), clusterPathings.size(), [&](size_t clusterIdx)
+	ConcurrentUnorderedMap<unsigned long long, 
+		ConcurrentUnorderedMap<unsigned long long, float>> playerDecisions;
+	ConcurrentUnorderedMap<unsigned long long,
+		ConcurrentUnorderedMap<unsigned long long, unsigned short>> playerWeaponDecisions;
+	ParallelFor(size_t(0), clusterPathings.size(), [&](size_t clusterIdx)
 	{
 		auto itCluster = clusterPathings.begin();
 		std::advance(itCluster, clusterIdx);
 
 		//cluster code
 		unsigned long long clusterCode = (*itCluster).first;
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
 		itClusterNodePathPlan = actorPathPlanClusters.find(clusterCode);
 		if (itClusterNodePathPlan == actorPathPlanClusters.end())
 			itClusterNodePathPlan = clusterNodePathPlans.find(clusterCode);
 
-		Concurrency::concurrent_unordered_map<unsigned long long, float> playerSimulations;
-		Concurrency::concurrent_unordered_map<unsigned long long, unsigned short> playerWeaponSimulations;
-		Concurrency::parallel_for_each(begin(otherPlayerClusters), end(otherPlayerClusters), [&](auto const& otherPlayerCluster)
+		ConcurrentUnorderedMap<unsigned long long, float> playerSimulations;
+		ConcurrentUnorderedMap<unsigned long long, unsigned short> playerWeaponSimulations;
+		ParallelForEach(begin(otherPlayerClusters), end(otherPlayerClusters), [&](auto const& otherPlayerCluster)
 		//for (auto const& otherPlayerCluster : otherPlayerClusters)
 		{
 			//we need to stop the simulation if an aware decision making has started
@@ -4587,9 +4595,9 @@ bool QuakeAIManager::SimulatePlayerGuessingDecision(
 
 	if (playerDataIn.valid)
 	{
-		Concurrency::concurrent_unordered_map<unsigned long long, float> playerSimulations;
-		Concurrency::concurrent_unordered_map<unsigned long long, unsigned short> playerWeaponSimulations;
-		Concurrency::parallel_for_each(begin(otherPlayerClusters), end(otherPlayerClusters), [&](auto const& otherPlayerCluster)
+		ConcurrentUnorderedMap<unsigned long long, float> playerSimulations;
+		ConcurrentUnorderedMap<unsigned long long, unsigned short> playerWeaponSimulations;
+		ParallelForEach(begin(otherPlayerClusters), end(otherPlayerClusters), [&](auto const& otherPlayerCluster)
 		//for (auto const& otherPathingClusterNode : otherPathingClusterNodes)
 		{
 			//we need to stop the simulation if an aware decision making has started
@@ -4635,7 +4643,7 @@ bool QuakeAIManager::SimulatePlayerGuessingDecision(
 		//cluster code
 		if (playerClusterCode != ULLONG_MAX)
 		{
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
 			itClusterNodePathPlan = actorPathPlanClusters.find(playerClusterCode);
 			if (itClusterNodePathPlan == actorPathPlanClusters.end())
 				itClusterNodePathPlan = clusterNodePathPlans.find(playerClusterCode);
@@ -4744,6 +4752,8 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 	const PlayerData& otherPlayerDataIn, PlayerData& otherPlayerDataOut,
 	const std::map<ActorId, float>& gameItems, ActorId playerEvaluation, EvaluationType evaluation)
 {
+	std::shared_ptr<PathingGraphView> pathingGraphView = GetPathingGraphView();
+
 	PathingNode* clusterNodeStart = playerDataIn.plan.node;
 	PathingNode* otherClusterNodeStart = otherPlayerDataIn.plan.node;
 	if (!clusterNodeStart || !otherClusterNodeStart || clusterNodeStart == otherClusterNodeStart)
@@ -4789,29 +4799,29 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 	clusterNodeStart = playerDataOut.plan.node;
 	otherClusterNodeStart = otherPlayerDataOut.plan.node;
 
-	Concurrency::concurrent_unordered_map<unsigned long long,
+	ConcurrentUnorderedMap<unsigned long long,
 		std::pair<PathingCluster*, PathingCluster*>> clusterPathings, otherClusterPathings;
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> clusterNodePathPlans, otherClusterNodePathPlans;
-	Concurrency::concurrent_unordered_map<unsigned long long, float> actorPathPlanClusterHeuristics, otherActorPathPlanClusterHeuristics;
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> actorPathPlanClusters, otherActorPathPlanClusters;
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec> clusterNodePathPlans, otherClusterNodePathPlans;
+	ConcurrentUnorderedMap<unsigned long long, float> actorPathPlanClusterHeuristics, otherActorPathPlanClusterHeuristics;
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec> actorPathPlanClusters, otherActorPathPlanClusters;
 
-	if (BuildPath(mPathingGraph, clusterNodeStart, otherClusterNodeStart, 
+	if (BuildPath(pathingGraphView, clusterNodeStart, otherClusterNodeStart, 
 		clusterPathings, otherClusterPathings, clusterNodePathPlans, otherClusterNodePathPlans))
 	{
 		std::mutex mutex;
 
-		Concurrency::parallel_for_each(begin(actionTypes), end(actionTypes), [&](auto& actionType)
+		ParallelForEach(begin(actionTypes), end(actionTypes), [&](auto& actionType)
 		//for (auto& actionType : actionTypes)
 		{
 			if (actionType.first == playerDataIn.player)
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, searchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, searchItems,
 					playerDataIn, clusterNodeStart, playerPathPlanOffset, playerPathOffset, localClusterPathings,
 					clusterNodePathPlans, localActorPathPlanClusterHeuristics, localActorPathPlanClusters);
 
@@ -4825,13 +4835,13 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 			}
 			else
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localOtherClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//other player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, otherSearchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, otherSearchItems,
 					otherPlayerDataIn, otherClusterNodeStart, otherPlayerPathPlanOffset, otherPlayerPathOffset,
 					localOtherClusterPathings, otherClusterNodePathPlans, localActorPathPlanClusterHeuristics,
 					localActorPathPlanClusters);
@@ -4846,40 +4856,40 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 			}
 		});
 
-		Concurrency::parallel_invoke(
+		ParallelInvoke(
 			[&] {			
 				//player
-				BuildExpandedActorPath(mPathingGraph, clusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, clusterNodeStart,
 					clusterPathings, actorPathPlanClusters, actorPathPlanClusterHeuristics); },
 			[&] {
 				//other player
-				BuildExpandedActorPath(mPathingGraph, otherClusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, otherClusterNodeStart,
 					otherClusterPathings, otherActorPathPlanClusters, otherActorPathPlanClusterHeuristics);}
 		);
 	}
 	else
 	{
-		if (!BuildLongPath(mPathingGraph, clusterNodeStart, otherClusterNodeStart,
+		if (!BuildLongPath(pathingGraphView, clusterNodeStart, otherClusterNodeStart,
 			clusterPathings, otherClusterPathings, clusterNodePathPlans, otherClusterNodePathPlans))
 		{
-			BuildLongestPath(mPathingGraph, clusterNodeStart, otherClusterNodeStart,
+			BuildLongestPath(pathingGraphView, clusterNodeStart, otherClusterNodeStart,
 				clusterPathings, otherClusterPathings, clusterNodePathPlans, otherClusterNodePathPlans);
 		}
 
 		std::mutex mutex;
 
-		Concurrency::parallel_for_each(begin(actionTypes), end(actionTypes), [&](auto& actionType)
+		ParallelForEach(begin(actionTypes), end(actionTypes), [&](auto& actionType)
 		//for (auto& actionType : actionTypes)
 		{
 			if (actionType.first == playerDataIn.player)
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, searchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, searchItems,
 					playerDataIn, clusterNodeStart, playerPathPlanOffset, playerPathOffset, localClusterPathings,
 					clusterNodePathPlans, localActorPathPlanClusterHeuristics, localActorPathPlanClusters);
 
@@ -4893,13 +4903,13 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 			}
 			else
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localOtherClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//other player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, otherSearchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, otherSearchItems,
 					otherPlayerDataIn, otherClusterNodeStart, otherPlayerPathPlanOffset, otherPlayerPathOffset,
 					localOtherClusterPathings, otherClusterNodePathPlans, localActorPathPlanClusterHeuristics,
 					localActorPathPlanClusters);
@@ -4914,14 +4924,14 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 			}
 		});
 
-		Concurrency::parallel_invoke(
+		ParallelInvoke(
 			[&] {			
 				//player
-				BuildExpandedActorPath(mPathingGraph, clusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, clusterNodeStart,
 					clusterPathings, actorPathPlanClusters, actorPathPlanClusterHeuristics); },
 			[&] {
 				//other player
-				BuildExpandedActorPath(mPathingGraph, otherClusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, otherClusterNodeStart,
 					otherClusterPathings, otherActorPathPlanClusters, otherActorPathPlanClusterHeuristics);}
 		);
 	}
@@ -4940,25 +4950,25 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 			for (auto it = otherPlayerPathPlanOffset.rbegin(); it != otherPlayerPathPlanOffset.rend(); it++)
 				otherClusterNodePathPlan.second.insert(otherClusterNodePathPlan.second.begin(), *it);
 
-	Concurrency::concurrent_unordered_map<unsigned long long, 
-		Concurrency::concurrent_unordered_map<unsigned long long, float>> playerGuessings;
-	Concurrency::concurrent_unordered_map<unsigned long long,
-		Concurrency::concurrent_unordered_map<unsigned long long, unsigned short>> playerWeaponGuessings;
-	Concurrency::parallel_for(size_t(0), clusterPathings.size(), [&](size_t clusterIdx)
+	ConcurrentUnorderedMap<unsigned long long, 
+		ConcurrentUnorderedMap<unsigned long long, float>> playerGuessings;
+	ConcurrentUnorderedMap<unsigned long long,
+		ConcurrentUnorderedMap<unsigned long long, unsigned short>> playerWeaponGuessings;
+	ParallelFor(size_t(0), clusterPathings.size(), [&](size_t clusterIdx)
 	{
 		auto itCluster = clusterPathings.begin();
 		std::advance(itCluster, clusterIdx);
 
 		//cluster code
 		unsigned long long clusterCode = (*itCluster).first;
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
 		itClusterNodePathPlan = actorPathPlanClusters.find(clusterCode);
 		if (itClusterNodePathPlan == actorPathPlanClusters.end())
 			itClusterNodePathPlan = clusterNodePathPlans.find(clusterCode);
 
-		Concurrency::concurrent_unordered_map<unsigned long long, float> playerSimulations;
-		Concurrency::concurrent_unordered_map<unsigned long long, unsigned short> playerWeaponSimulations;
-		Concurrency::parallel_for(size_t(0), otherClusterPathings.size(), [&](size_t otherClusterIdx)
+		ConcurrentUnorderedMap<unsigned long long, float> playerSimulations;
+		ConcurrentUnorderedMap<unsigned long long, unsigned short> playerWeaponSimulations;
+		ParallelFor(size_t(0), otherClusterPathings.size(), [&](size_t otherClusterIdx)
 		{
 			//we need to stop the simulation if an aware decision making has started
 			if (evaluation != ET_AWARENESS && mPlayerEvaluations.at(playerEvaluation) == ET_AWARENESS)
@@ -4969,7 +4979,7 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 
 			//other cluster code
 			unsigned long long otherClusterCode = (*itOtherCluster).first;
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 			itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherClusterCode);
 			if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 				itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherClusterCode);
@@ -5003,9 +5013,9 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 
 	if (playerDataIn.valid)
 	{
-		Concurrency::concurrent_unordered_map<unsigned long long, float> playerSimulations;
-		Concurrency::concurrent_unordered_map<unsigned long long, unsigned short> playerWeaponSimulations;
-		Concurrency::parallel_for(size_t(0), otherClusterPathings.size(), [&](size_t otherClusterIdx)
+		ConcurrentUnorderedMap<unsigned long long, float> playerSimulations;
+		ConcurrentUnorderedMap<unsigned long long, unsigned short> playerWeaponSimulations;
+		ParallelFor(size_t(0), otherClusterPathings.size(), [&](size_t otherClusterIdx)
 		{
 			//we need to stop the simulation if an aware decision making has started
 			if (evaluation != ET_AWARENESS && mPlayerEvaluations.at(playerEvaluation) == ET_AWARENESS)
@@ -5016,7 +5026,7 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 
 			//other cluster code
 			unsigned long long otherClusterCode = (*itOtherCluster).first;
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 			itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherClusterCode);
 			if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 				itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherClusterCode);
@@ -5065,7 +5075,7 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 		//cluster code
 		if (playerClusterCode != ULLONG_MAX)
 		{
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
 			itClusterNodePathPlan = actorPathPlanClusters.find(playerClusterCode);
 			if (itClusterNodePathPlan == actorPathPlanClusters.end())
 				itClusterNodePathPlan = clusterNodePathPlans.find(playerClusterCode);
@@ -5073,7 +5083,7 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 			//other cluster code
 			if (otherPlayerClusterCode != ULLONG_MAX)
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 				itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherPlayerClusterCode);
 				if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 					itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherPlayerClusterCode);
@@ -5116,7 +5126,7 @@ bool QuakeAIManager::SimulatePlayerGuessings(
 		}
 		else if (otherPlayerClusterCode != ULLONG_MAX)
 		{
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 			itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherPlayerClusterCode);
 			if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 				itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherPlayerClusterCode);
@@ -5184,6 +5194,8 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 	const PlayerData& otherPlayerDataIn, PlayerData& otherPlayerDataOut,
 	const std::map<ActorId, float>& gameItems, ActorId playerEvaluation, EvaluationType evaluation)
 {
+	std::shared_ptr<PathingGraphView> pathingGraphView = GetPathingGraphView();
+
 	PathingNode* clusterNodeStart = playerDataIn.plan.node;
 	PathingNode* otherClusterNodeStart = otherPlayerDataIn.plan.node;
 	if (!clusterNodeStart || !otherClusterNodeStart || clusterNodeStart == otherClusterNodeStart)
@@ -5229,29 +5241,29 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 	clusterNodeStart = playerDataOut.plan.node;
 	otherClusterNodeStart = otherPlayerDataOut.plan.node;
 
-	Concurrency::concurrent_unordered_map<unsigned long long,
+	ConcurrentUnorderedMap<unsigned long long,
 		std::pair<PathingCluster*, PathingCluster*>> clusterPathings, otherClusterPathings;
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> clusterNodePathPlans, otherClusterNodePathPlans;
-	Concurrency::concurrent_unordered_map<unsigned long long, float> actorPathPlanClusterHeuristics, otherActorPathPlanClusterHeuristics;
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> actorPathPlanClusters, otherActorPathPlanClusters;
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec> clusterNodePathPlans, otherClusterNodePathPlans;
+	ConcurrentUnorderedMap<unsigned long long, float> actorPathPlanClusterHeuristics, otherActorPathPlanClusterHeuristics;
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec> actorPathPlanClusters, otherActorPathPlanClusters;
 
-	if (BuildPath(mPathingGraph, clusterNodeStart, otherClusterNodeStart, 
+	if (BuildPath(pathingGraphView, clusterNodeStart, otherClusterNodeStart, 
 		clusterPathings, otherClusterPathings, clusterNodePathPlans, otherClusterNodePathPlans))
 	{
 		std::mutex mutex;
 
-		Concurrency::parallel_for_each(begin(actionTypes), end(actionTypes), [&](auto& actionType)
+		ParallelForEach(begin(actionTypes), end(actionTypes), [&](auto& actionType)
 		//for (auto& actionType : actionTypes)
 		{
 			if (actionType.first == playerDataIn.player)
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, searchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, searchItems,
 					playerDataIn, clusterNodeStart, playerPathPlanOffset, playerPathOffset, localClusterPathings,
 					clusterNodePathPlans, localActorPathPlanClusterHeuristics, localActorPathPlanClusters);
 
@@ -5265,13 +5277,13 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 			}
 			else
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localOtherClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//other player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, otherSearchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, otherSearchItems,
 					otherPlayerDataIn, otherClusterNodeStart, otherPlayerPathPlanOffset, otherPlayerPathOffset,
 					localOtherClusterPathings, otherClusterNodePathPlans, localActorPathPlanClusterHeuristics,
 					localActorPathPlanClusters);
@@ -5286,40 +5298,40 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 			}
 		});
 
-		Concurrency::parallel_invoke(
+		ParallelInvoke(
 			[&] {			
 				//player
-				BuildExpandedActorPath(mPathingGraph, clusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, clusterNodeStart,
 					clusterPathings, actorPathPlanClusters, actorPathPlanClusterHeuristics); },
 			[&] {
 				//other player
-				BuildExpandedActorPath(mPathingGraph, otherClusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, otherClusterNodeStart,
 					otherClusterPathings, otherActorPathPlanClusters, otherActorPathPlanClusterHeuristics);}
 		);
 	}
 	else
 	{
-		if (!BuildLongPath(mPathingGraph, clusterNodeStart, otherClusterNodeStart,
+		if (!BuildLongPath(pathingGraphView, clusterNodeStart, otherClusterNodeStart,
 			clusterPathings, otherClusterPathings, clusterNodePathPlans, otherClusterNodePathPlans))
 		{
-			BuildLongestPath(mPathingGraph, clusterNodeStart, otherClusterNodeStart,
+			BuildLongestPath(pathingGraphView, clusterNodeStart, otherClusterNodeStart,
 				clusterPathings, otherClusterPathings, clusterNodePathPlans, otherClusterNodePathPlans);
 		}
 
 		std::mutex mutex;
 
-		Concurrency::parallel_for_each(begin(actionTypes), end(actionTypes), [&](auto& actionType)
+		ParallelForEach(begin(actionTypes), end(actionTypes), [&](auto& actionType)
 		//for (auto& actionType : actionTypes)
 		{
 			if (actionType.first == playerDataIn.player)
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, searchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, searchItems,
 					playerDataIn, clusterNodeStart, playerPathPlanOffset, playerPathOffset, localClusterPathings,
 					clusterNodePathPlans, localActorPathPlanClusterHeuristics, localActorPathPlanClusters);
 
@@ -5333,13 +5345,13 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 			}
 			else
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localOtherClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//other player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, otherSearchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, otherSearchItems,
 					otherPlayerDataIn, otherClusterNodeStart, otherPlayerPathPlanOffset, otherPlayerPathOffset,
 					localOtherClusterPathings, otherClusterNodePathPlans, localActorPathPlanClusterHeuristics,
 					localActorPathPlanClusters);
@@ -5354,14 +5366,14 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 			}
 		});
 
-		Concurrency::parallel_invoke(
+		ParallelInvoke(
 			[&] {			
 				//player
-				BuildExpandedActorPath(mPathingGraph, clusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, clusterNodeStart,
 					clusterPathings, actorPathPlanClusters, actorPathPlanClusterHeuristics); },
 			[&] {
 				//other player
-				BuildExpandedActorPath(mPathingGraph, otherClusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, otherClusterNodeStart,
 					otherClusterPathings, otherActorPathPlanClusters, otherActorPathPlanClusterHeuristics);}
 		);
 	}
@@ -5380,25 +5392,25 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 			for (auto it = otherPlayerPathPlanOffset.rbegin(); it != otherPlayerPathPlanOffset.rend(); it++)
 				otherClusterNodePathPlan.second.insert(otherClusterNodePathPlan.second.begin(), *it);
 
-	Concurrency::concurrent_unordered_map<unsigned long long, 
-		Concurrency::concurrent_unordered_map<unsigned long long, float>> playerGuessings;
-	Concurrency::concurrent_unordered_map<unsigned long long,
-		Concurrency::concurrent_unordered_map<unsigned long long, unsigned short>> playerWeaponGuessings;
-	Concurrency::parallel_for(size_t(0), clusterPathings.size(), [&](size_t clusterIdx)
+	ConcurrentUnorderedMap<unsigned long long, 
+		ConcurrentUnorderedMap<unsigned long long, float>> playerGuessings;
+	ConcurrentUnorderedMap<unsigned long long,
+		ConcurrentUnorderedMap<unsigned long long, unsigned short>> playerWeaponGuessings;
+	ParallelFor(size_t(0), clusterPathings.size(), [&](size_t clusterIdx)
 	{
 		auto itCluster = clusterPathings.begin();
 		std::advance(itCluster, clusterIdx);
 
 		//cluster code
 		unsigned long long clusterCode = (*itCluster).first;
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
 		itClusterNodePathPlan = actorPathPlanClusters.find(clusterCode);
 		if (itClusterNodePathPlan == actorPathPlanClusters.end())
 			itClusterNodePathPlan = clusterNodePathPlans.find(clusterCode);
 
-		Concurrency::concurrent_unordered_map<unsigned long long, float> playerSimulations;
-		Concurrency::concurrent_unordered_map<unsigned long long, unsigned short> playerWeaponSimulations;
-		Concurrency::parallel_for(size_t(0), otherClusterPathings.size(), [&](size_t otherClusterIdx)
+		ConcurrentUnorderedMap<unsigned long long, float> playerSimulations;
+		ConcurrentUnorderedMap<unsigned long long, unsigned short> playerWeaponSimulations;
+		ParallelFor(size_t(0), otherClusterPathings.size(), [&](size_t otherClusterIdx)
 		{
 			//we need to stop the simulation if an aware decision making has started
 			if (evaluation != ET_AWARENESS && mPlayerEvaluations.at(playerEvaluation) == ET_AWARENESS)
@@ -5409,7 +5421,7 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 
 			//other cluster code
 			unsigned long long otherClusterCode = (*itOtherCluster).first;
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 			itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherClusterCode);
 			if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 				itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherClusterCode);
@@ -5444,9 +5456,9 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 
 	if (playerDataIn.valid)
 	{
-		Concurrency::concurrent_unordered_map<unsigned long long, float> playerSimulations;
-		Concurrency::concurrent_unordered_map<unsigned long long, unsigned short> playerWeaponSimulations;
-		Concurrency::parallel_for(size_t(0), otherClusterPathings.size(), [&](size_t otherClusterIdx)
+		ConcurrentUnorderedMap<unsigned long long, float> playerSimulations;
+		ConcurrentUnorderedMap<unsigned long long, unsigned short> playerWeaponSimulations;
+		ParallelFor(size_t(0), otherClusterPathings.size(), [&](size_t otherClusterIdx)
 		{
 			//we need to stop the simulation if an aware decision making has started
 			if (evaluation != ET_AWARENESS && mPlayerEvaluations.at(playerEvaluation) == ET_AWARENESS)
@@ -5457,7 +5469,7 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 
 			//other cluster code
 			unsigned long long otherClusterCode = (*itOtherCluster).first;
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 			itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherClusterCode);
 			if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 				itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherClusterCode);
@@ -5506,7 +5518,7 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 		//cluster code
 		if (playerClusterCode != ULLONG_MAX)
 		{
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
 			itClusterNodePathPlan = actorPathPlanClusters.find(playerClusterCode);
 			if (itClusterNodePathPlan == actorPathPlanClusters.end())
 				itClusterNodePathPlan = clusterNodePathPlans.find(playerClusterCode);
@@ -5514,7 +5526,7 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 			//other cluster code
 			if (otherPlayerClusterCode != ULLONG_MAX)
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 				itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherPlayerClusterCode);
 				if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 					itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherPlayerClusterCode);
@@ -5558,7 +5570,7 @@ bool QuakeAIManager::SimulatePlayerGuessing(
 		}
 		else if (otherPlayerClusterCode != ULLONG_MAX)
 		{
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 			itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherPlayerClusterCode);
 			if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 				itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherPlayerClusterCode);
@@ -5635,6 +5647,8 @@ bool QuakeAIManager::SimulatePlayerDecision(
 	const PlayerData& otherPlayerDataIn, PlayerData& otherPlayerDataOut,
 	const std::map<ActorId, float>& gameItems, ActorId playerEvaluation, EvaluationType evaluation)
 {
+	std::shared_ptr<PathingGraphView> pathingGraphView = GetPathingGraphView();
+
 	PathingNode* clusterNodeStart = playerDataIn.plan.node;
 	PathingNode* otherClusterNodeStart = otherPlayerDataIn.plan.node;
 	if (!clusterNodeStart || !otherClusterNodeStart || clusterNodeStart == otherClusterNodeStart)
@@ -5676,29 +5690,29 @@ bool QuakeAIManager::SimulatePlayerDecision(
 	clusterNodeStart = playerDataOut.plan.node;
 	otherClusterNodeStart = otherPlayerDataOut.plan.node;
 
-	Concurrency::concurrent_unordered_map<unsigned long long,
+	ConcurrentUnorderedMap<unsigned long long,
 		std::pair<PathingCluster*, PathingCluster*>> clusterPathings, otherClusterPathings;
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> clusterNodePathPlans, otherClusterNodePathPlans;
-	Concurrency::concurrent_unordered_map<unsigned long long, float> actorPathPlanClusterHeuristics, otherActorPathPlanClusterHeuristics;
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> actorPathPlanClusters, otherActorPathPlanClusters;
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec> clusterNodePathPlans, otherClusterNodePathPlans;
+	ConcurrentUnorderedMap<unsigned long long, float> actorPathPlanClusterHeuristics, otherActorPathPlanClusterHeuristics;
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec> actorPathPlanClusters, otherActorPathPlanClusters;
 
-	if (BuildPath(mPathingGraph, clusterNodeStart, otherClusterNodeStart, 
+	if (BuildPath(pathingGraphView, clusterNodeStart, otherClusterNodeStart, 
 		clusterPathings, otherClusterPathings, clusterNodePathPlans, otherClusterNodePathPlans))
 	{
 		std::mutex mutex;
 
-		Concurrency::parallel_for_each(begin(actionTypes), end(actionTypes), [&](auto& actionType)
+		ParallelForEach(begin(actionTypes), end(actionTypes), [&](auto& actionType)
 		//for (auto& actionType : actionTypes)
 		{
 			if (actionType.first == playerDataIn.player)
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, searchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, searchItems,
 					playerDataIn, clusterNodeStart, playerPathPlanOffset, playerPathOffset, localClusterPathings,
 					clusterNodePathPlans, localActorPathPlanClusterHeuristics, localActorPathPlanClusters);
 
@@ -5712,13 +5726,13 @@ bool QuakeAIManager::SimulatePlayerDecision(
 			}
 			else
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localOtherClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//other player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, otherSearchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, otherSearchItems,
 					otherPlayerDataIn, otherClusterNodeStart, otherPlayerPathPlanOffset, otherPlayerPathOffset,
 					localOtherClusterPathings, otherClusterNodePathPlans, localActorPathPlanClusterHeuristics,
 					localActorPathPlanClusters);
@@ -5733,40 +5747,40 @@ bool QuakeAIManager::SimulatePlayerDecision(
 			}
 		});
 
-		Concurrency::parallel_invoke(
+		ParallelInvoke(
 			[&] {			
 				//player
-				BuildExpandedActorPath(mPathingGraph, clusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, clusterNodeStart,
 					clusterPathings, actorPathPlanClusters, actorPathPlanClusterHeuristics); },
 			[&] {
 				//other player
-				BuildExpandedActorPath(mPathingGraph, otherClusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, otherClusterNodeStart,
 					otherClusterPathings, otherActorPathPlanClusters, otherActorPathPlanClusterHeuristics);}
 		);
 	}
 	else
 	{
-		if (!BuildLongPath(mPathingGraph, clusterNodeStart, otherClusterNodeStart,
+		if (!BuildLongPath(pathingGraphView, clusterNodeStart, otherClusterNodeStart,
 			clusterPathings, otherClusterPathings, clusterNodePathPlans, otherClusterNodePathPlans))
 		{
-			BuildLongestPath(mPathingGraph, clusterNodeStart, otherClusterNodeStart,
+			BuildLongestPath(pathingGraphView, clusterNodeStart, otherClusterNodeStart,
 				clusterPathings, otherClusterPathings, clusterNodePathPlans, otherClusterNodePathPlans);
 		}
 
 		std::mutex mutex;
 
-		Concurrency::parallel_for_each(begin(actionTypes), end(actionTypes), [&](auto& actionType)
+		ParallelForEach(begin(actionTypes), end(actionTypes), [&](auto& actionType)
 		//for (auto& actionType : actionTypes)
 		{
 			if (actionType.first == playerDataIn.player)
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, searchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, searchItems,
 					playerDataIn, clusterNodeStart, playerPathPlanOffset, playerPathOffset, localClusterPathings,
 					clusterNodePathPlans, localActorPathPlanClusterHeuristics, localActorPathPlanClusters);
 
@@ -5780,13 +5794,13 @@ bool QuakeAIManager::SimulatePlayerDecision(
 			}
 			else
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localOtherClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//other player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, otherSearchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, otherSearchItems,
 					otherPlayerDataIn, otherClusterNodeStart, otherPlayerPathPlanOffset, otherPlayerPathOffset,
 					localOtherClusterPathings, otherClusterNodePathPlans, localActorPathPlanClusterHeuristics,
 					localActorPathPlanClusters);
@@ -5801,14 +5815,14 @@ bool QuakeAIManager::SimulatePlayerDecision(
 			}
 		});
 
-		Concurrency::parallel_invoke(
+		ParallelInvoke(
 			[&] {			
 				//player
-				BuildExpandedActorPath(mPathingGraph, clusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, clusterNodeStart,
 					clusterPathings, actorPathPlanClusters, actorPathPlanClusterHeuristics); },
 			[&] {
 				//other player
-				BuildExpandedActorPath(mPathingGraph, otherClusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, otherClusterNodeStart,
 					otherClusterPathings, otherActorPathPlanClusters, otherActorPathPlanClusterHeuristics);}
 		);
 	}
@@ -5823,32 +5837,32 @@ bool QuakeAIManager::SimulatePlayerDecision(
 			for (auto it = otherPlayerPathPlanOffset.rbegin(); it != otherPlayerPathPlanOffset.rend(); it++)
 				otherClusterNodePathPlan.second.insert(otherClusterNodePathPlan.second.begin(), *it);
 
-	Concurrency::concurrent_unordered_map<unsigned long long, 
-		Concurrency::concurrent_unordered_map<unsigned long long, float>> playerDecisions;
-	Concurrency::concurrent_unordered_map<unsigned long long,
-		Concurrency::concurrent_unordered_map<unsigned long long, unsigned short>> playerWeaponDecisions;
-	Concurrency::parallel_for(size_t(0), clusterPathings.size(), [&](size_t clusterIdx)
+	ConcurrentUnorderedMap<unsigned long long, 
+		ConcurrentUnorderedMap<unsigned long long, float>> playerDecisions;
+	ConcurrentUnorderedMap<unsigned long long,
+		ConcurrentUnorderedMap<unsigned long long, unsigned short>> playerWeaponDecisions;
+	ParallelFor(size_t(0), clusterPathings.size(), [&](size_t clusterIdx)
 	{
 		auto itCluster = clusterPathings.begin();
 		std::advance(itCluster, clusterIdx);
 
 		//cluster code
 		unsigned long long clusterCode = (*itCluster).first;
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
 		itClusterNodePathPlan = actorPathPlanClusters.find(clusterCode);
 		if (itClusterNodePathPlan == actorPathPlanClusters.end())
 			itClusterNodePathPlan = clusterNodePathPlans.find(clusterCode);
 
-		Concurrency::concurrent_unordered_map<unsigned long long, float> playerSimulations;
-		Concurrency::concurrent_unordered_map<unsigned long long, unsigned short> playerWeaponSimulations;
-		Concurrency::parallel_for(size_t(0), otherClusterPathings.size(), [&](size_t otherClusterIdx)
+		ConcurrentUnorderedMap<unsigned long long, float> playerSimulations;
+		ConcurrentUnorderedMap<unsigned long long, unsigned short> playerWeaponSimulations;
+		ParallelFor(size_t(0), otherClusterPathings.size(), [&](size_t otherClusterIdx)
 		{
 			auto itOtherCluster = otherClusterPathings.begin();
 			std::advance(itOtherCluster, otherClusterIdx);
 
 			//other cluster code
 			unsigned long long otherClusterCode = (*itOtherCluster).first;
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 			itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherClusterCode);
 			if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 				itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherClusterCode);
@@ -5883,14 +5897,14 @@ bool QuakeAIManager::SimulatePlayerDecision(
 
 	if (playerDataIn.valid)
 	{
-		Concurrency::concurrent_unordered_map<unsigned long long, float> playerSimulations;
-		Concurrency::concurrent_unordered_map<unsigned long long, unsigned short> playerWeaponSimulations;
-		Concurrency::parallel_for_each(begin(otherClusterPathings), end(otherClusterPathings), [&](auto const& otherClusterPathing)
+		ConcurrentUnorderedMap<unsigned long long, float> playerSimulations;
+		ConcurrentUnorderedMap<unsigned long long, unsigned short> playerWeaponSimulations;
+		ParallelForEach(begin(otherClusterPathings), end(otherClusterPathings), [&](auto const& otherClusterPathing)
 		//for (auto const& otherClusterPathing : otherClusterPathings)
 		{
 			//other cluster code
 			unsigned long long otherClusterCode = otherClusterPathing.first;
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 			itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherClusterCode);
 			if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 				itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherClusterCode);
@@ -5935,7 +5949,7 @@ bool QuakeAIManager::SimulatePlayerDecision(
 		//cluster code
 		if (playerClusterCode != ULLONG_MAX)
 		{
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
 			itClusterNodePathPlan = actorPathPlanClusters.find(playerClusterCode);
 			if (itClusterNodePathPlan == actorPathPlanClusters.end())
 				itClusterNodePathPlan = clusterNodePathPlans.find(playerClusterCode);
@@ -5943,7 +5957,7 @@ bool QuakeAIManager::SimulatePlayerDecision(
 			//other cluster code
 			if (otherPlayerClusterCode != ULLONG_MAX)
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 				itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherPlayerClusterCode);
 				if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 					itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherPlayerClusterCode);
@@ -5986,7 +6000,7 @@ bool QuakeAIManager::SimulatePlayerDecision(
 		}
 		else if (otherPlayerClusterCode != ULLONG_MAX)
 		{
-			Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+			ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 			itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherPlayerClusterCode);
 			if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 				itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherPlayerClusterCode);
@@ -6068,6 +6082,8 @@ bool QuakeAIManager::SimulateClusterPathing(
 	std::unordered_set<PathingNode*>& otherPlayerClusterPathings, 
 	std::unordered_set<PathingNode*>& otherPlayerClusterExpandedPathings)
 {
+	std::shared_ptr<PathingGraphView> pathingGraphView = GetPathingGraphView();
+
 	PathingNode* clusterNodeStart = playerDataIn.plan.node;
 	PathingNode* otherClusterNodeStart = otherPlayerDataIn.plan.node;
 	if (!clusterNodeStart || !otherClusterNodeStart || clusterNodeStart == otherClusterNodeStart)
@@ -6109,29 +6125,29 @@ bool QuakeAIManager::SimulateClusterPathing(
 	clusterNodeStart = playerDataOut.plan.node;
 	otherClusterNodeStart = otherPlayerDataOut.plan.node;
 
-	Concurrency::concurrent_unordered_map<unsigned long long,
+	ConcurrentUnorderedMap<unsigned long long,
 		std::pair<PathingCluster*, PathingCluster*>> clusterPathings, otherClusterPathings;
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> clusterNodePathPlans, otherClusterNodePathPlans;
-	Concurrency::concurrent_unordered_map<unsigned long long, float> actorPathPlanClusterHeuristics, otherActorPathPlanClusterHeuristics;
-	Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> actorPathPlanClusters, otherActorPathPlanClusters;
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec> clusterNodePathPlans, otherClusterNodePathPlans;
+	ConcurrentUnorderedMap<unsigned long long, float> actorPathPlanClusterHeuristics, otherActorPathPlanClusterHeuristics;
+	ConcurrentUnorderedMap<unsigned long long, PathingArcVec> actorPathPlanClusters, otherActorPathPlanClusters;
 
-	if (BuildPath(mPathingGraph, clusterNodeStart, otherClusterNodeStart, 
+	if (BuildPath(pathingGraphView, clusterNodeStart, otherClusterNodeStart, 
 		clusterPathings, otherClusterPathings, clusterNodePathPlans, otherClusterNodePathPlans))
 	{
 		std::mutex mutex;
 
-		Concurrency::parallel_for_each(begin(actionTypes), end(actionTypes), [&](auto& actionType)
+		ParallelForEach(begin(actionTypes), end(actionTypes), [&](auto& actionType)
 		//for (auto& actionType : actionTypes)
 		{
 			if (actionType.first == playerDataIn.player)
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, searchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, searchItems,
 					playerDataIn, clusterNodeStart, playerPathPlanOffset, playerPathOffset, localClusterPathings,
 					clusterNodePathPlans, localActorPathPlanClusterHeuristics, localActorPathPlanClusters);
 
@@ -6145,13 +6161,13 @@ bool QuakeAIManager::SimulateClusterPathing(
 			}
 			else
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localOtherClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//other player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, otherSearchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, otherSearchItems,
 					otherPlayerDataIn, otherClusterNodeStart, otherPlayerPathPlanOffset, otherPlayerPathOffset,
 					localOtherClusterPathings, otherClusterNodePathPlans, localActorPathPlanClusterHeuristics,
 					localActorPathPlanClusters);
@@ -6166,40 +6182,40 @@ bool QuakeAIManager::SimulateClusterPathing(
 			}
 		});
 
-		Concurrency::parallel_invoke(
+		ParallelInvoke(
 			[&] {			
 				//player
-				BuildExpandedActorPath(mPathingGraph, clusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, clusterNodeStart,
 					clusterPathings, actorPathPlanClusters, actorPathPlanClusterHeuristics); },
 			[&] {
 				//other player
-				BuildExpandedActorPath(mPathingGraph, otherClusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, otherClusterNodeStart,
 					otherClusterPathings, otherActorPathPlanClusters, otherActorPathPlanClusterHeuristics);}
 		);
 	}
 	else
 	{
-		if (!BuildLongPath(mPathingGraph, clusterNodeStart, otherClusterNodeStart,
+		if (!BuildLongPath(pathingGraphView, clusterNodeStart, otherClusterNodeStart,
 			clusterPathings, otherClusterPathings, clusterNodePathPlans, otherClusterNodePathPlans))
 		{
-			BuildLongestPath(mPathingGraph, clusterNodeStart, otherClusterNodeStart,
+			BuildLongestPath(pathingGraphView, clusterNodeStart, otherClusterNodeStart,
 				clusterPathings, otherClusterPathings, clusterNodePathPlans, otherClusterNodePathPlans);
 		}
 
 		std::mutex mutex;
 
-		Concurrency::parallel_for_each(begin(actionTypes), end(actionTypes), [&](auto& actionType)
+		ParallelForEach(begin(actionTypes), end(actionTypes), [&](auto& actionType)
 		//for (auto& actionType : actionTypes)
 		{
 			if (actionType.first == playerDataIn.player)
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, searchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, searchItems,
 					playerDataIn, clusterNodeStart, playerPathPlanOffset, playerPathOffset, localClusterPathings,
 					clusterNodePathPlans, localActorPathPlanClusterHeuristics, localActorPathPlanClusters);
 
@@ -6213,13 +6229,13 @@ bool QuakeAIManager::SimulateClusterPathing(
 			}
 			else
 			{
-				Concurrency::concurrent_unordered_map<unsigned long long,
+				ConcurrentUnorderedMap<unsigned long long,
 					std::pair<PathingCluster*, PathingCluster*>> localOtherClusterPathings;
-				Concurrency::concurrent_unordered_map<unsigned long long, float> localActorPathPlanClusterHeuristics;
-				Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec> localActorPathPlanClusters;
+				ConcurrentUnorderedMap<unsigned long long, float> localActorPathPlanClusterHeuristics;
+				ConcurrentUnorderedMap<unsigned long long, PathingArcVec> localActorPathPlanClusters;
 
 				//other player
-				BuildActorPath(mPathingGraph, actionType.second, gameItems, otherSearchItems,
+				BuildActorPath(pathingGraphView, actionType.second, gameItems, otherSearchItems,
 					otherPlayerDataIn, otherClusterNodeStart, otherPlayerPathPlanOffset, otherPlayerPathOffset,
 					localOtherClusterPathings, otherClusterNodePathPlans, localActorPathPlanClusterHeuristics,
 					localActorPathPlanClusters);
@@ -6234,14 +6250,14 @@ bool QuakeAIManager::SimulateClusterPathing(
 			}
 		});
 
-		Concurrency::parallel_invoke(
+		ParallelInvoke(
 			[&] {			
 				//player
-				BuildExpandedActorPath(mPathingGraph, clusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, clusterNodeStart,
 					clusterPathings, actorPathPlanClusters, actorPathPlanClusterHeuristics); },
 			[&] {
 				//other player
-				BuildExpandedActorPath(mPathingGraph, otherClusterNodeStart,
+				BuildExpandedActorPath(pathingGraphView, otherClusterNodeStart,
 					otherClusterPathings, otherActorPathPlanClusters, otherActorPathPlanClusterHeuristics);}
 		);
 	}
@@ -6253,12 +6269,12 @@ bool QuakeAIManager::SimulateClusterPathing(
 
 		//cluster code
 		unsigned long long clusterCode = (*itCluster).first;
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itClusterNodePathPlan;
 		itClusterNodePathPlan = actorPathPlanClusters.find(clusterCode);
 		if (itClusterNodePathPlan == actorPathPlanClusters.end())
 			itClusterNodePathPlan = clusterNodePathPlans.find(clusterCode);
 
-		PathingNode* pathingClusterNodeEnd = mPathingGraph->FindClusterNode(playerClusterStart->GetTarget()->GetCluster());
+		PathingNode* pathingClusterNodeEnd = pathingGraphView->FindClusterNode(playerClusterStart->GetTarget()->GetCluster());
 		for (auto& itPathArc = itClusterNodePathPlan->second.begin(); itPathArc != itClusterNodePathPlan->second.end(); itPathArc++)
 		{
 			playerClusterPathings.insert((*itPathArc)->GetNode());
@@ -6277,12 +6293,12 @@ bool QuakeAIManager::SimulateClusterPathing(
 
 		//other cluster code
 		unsigned long long otherClusterCode = (*itOtherCluster).first;
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec>::iterator itOtherClusterNodePathPlan;
 		itOtherClusterNodePathPlan = otherActorPathPlanClusters.find(otherClusterCode);
 		if (itOtherClusterNodePathPlan == otherActorPathPlanClusters.end())
 			itOtherClusterNodePathPlan = otherClusterNodePathPlans.find(otherClusterCode);
 
-		PathingNode* otherPathingClusterNodeEnd = mPathingGraph->FindClusterNode(otherPlayerClusterStart->GetTarget()->GetCluster());
+		PathingNode* otherPathingClusterNodeEnd = pathingGraphView->FindClusterNode(otherPlayerClusterStart->GetTarget()->GetCluster());
 		for (auto& itOtherPathArc = itOtherClusterNodePathPlan->second.begin(); itOtherPathArc != itOtherClusterNodePathPlan->second.end(); itOtherPathArc++)
 		{
 			otherPlayerClusterPathings.insert((*itOtherPathArc)->GetNode());
@@ -6299,6 +6315,8 @@ bool QuakeAIManager::SimulateClusterPathing(
 
 bool QuakeAIManager::MakeAIGuessing(PlayerView& aiView)
 {
+	std::shared_ptr<PathingGraphView> pathingGraphView = GetPathingGraphView();
+
 	mMutex.lock();
 
 	GetPlayerView(mPlayers[GV_AI], aiView);
@@ -6367,7 +6385,7 @@ bool QuakeAIManager::MakeAIGuessing(PlayerView& aiView)
 		{
 			const AIAnalysis::ActorPickup* itemPickup = mGameActorPickups.at(aiGuessItem.first);
 			if (itemPickup)
-				if (!aiSimulation.data.plan.node->IsVisibleNode(itemPickup->GetNode()))
+				if (!pathingGraphView->IsVisibleNode(aiSimulation.data.plan.node, itemPickup->GetNode()))
 					gameItems[aiGuessItem.first] = aiGuessItem.second;
 		}
 
@@ -6376,7 +6394,7 @@ bool QuakeAIManager::MakeAIGuessing(PlayerView& aiView)
 		{
 			const AIAnalysis::ActorPickup* itemPickup = mGameActorPickups.at(humanGuessItem.first);
 			if (itemPickup)
-				if (!aiSimulation.data.plan.node->IsVisibleNode(itemPickup->GetNode()))
+				if (!pathingGraphView->IsVisibleNode(aiSimulation.data.plan.node, itemPickup->GetNode()))
 					gameItems[humanGuessItem.first] = humanGuessItem.second;
 		}
 	}
@@ -6433,6 +6451,8 @@ bool QuakeAIManager::MakeAIGuessing(PlayerView& aiView)
 
 bool QuakeAIManager::MakeAIFastDecision(PlayerView& aiView)
 {
+	std::shared_ptr<PathingGraphView> pathingGraphView = GetPathingGraphView();
+
 	mMutex.lock();
 
 	GetPlayerView(mPlayers[GV_AI], aiView);
@@ -6504,7 +6524,7 @@ bool QuakeAIManager::MakeAIFastDecision(PlayerView& aiView)
 		{
 			const AIAnalysis::ActorPickup* itemPickup = mGameActorPickups.at(aiGuessItem.first);
 			if (itemPickup)
-				if (!aiSimulation.data.plan.node->IsVisibleNode(itemPickup->GetNode()))
+				if (!pathingGraphView->IsVisibleNode(aiSimulation.data.plan.node, itemPickup->GetNode()))
 					gameItems[aiGuessItem.first] = aiGuessItem.second;
 		}
 
@@ -6513,7 +6533,7 @@ bool QuakeAIManager::MakeAIFastDecision(PlayerView& aiView)
 		{
 			const AIAnalysis::ActorPickup* itemPickup = mGameActorPickups.at(humanGuessItem.first);
 			if (itemPickup)
-				if (!aiSimulation.data.plan.node->IsVisibleNode(itemPickup->GetNode()))
+				if (!pathingGraphView->IsVisibleNode(aiSimulation.data.plan.node, itemPickup->GetNode()))
 					gameItems[humanGuessItem.first] = humanGuessItem.second;
 		}
 	}
@@ -6560,6 +6580,8 @@ bool QuakeAIManager::MakeAIFastDecision(PlayerView& aiView)
 
 bool QuakeAIManager::MakeAIGuessingDecision(PlayerView& aiView)
 {
+	std::shared_ptr<PathingGraphView> pathingGraphView = GetPathingGraphView();
+
 	mMutex.lock();
 
 	GetPlayerView(mPlayers[GV_AI], aiView);
@@ -6649,7 +6671,7 @@ bool QuakeAIManager::MakeAIGuessingDecision(PlayerView& aiView)
 		{
 			const AIAnalysis::ActorPickup* itemPickup = mGameActorPickups.at(guessItem.first);
 			if (itemPickup)
-				if (!playerGuessSimulation.data.plan.node->IsVisibleNode(itemPickup->GetNode()))
+				if (!pathingGraphView->IsVisibleNode(playerGuessSimulation.data.plan.node, itemPickup->GetNode()))
 					gameItems[guessItem.first] = guessItem.second;
 		}
 
@@ -6658,14 +6680,14 @@ bool QuakeAIManager::MakeAIGuessingDecision(PlayerView& aiView)
 		{
 			const AIAnalysis::ActorPickup* itemPickup = mGameActorPickups.at(humanGuessItem.first);
 			if (itemPickup)
-				if (!playerGuessSimulation.data.plan.node->IsVisibleNode(itemPickup->GetNode()))
+				if (!pathingGraphView->IsVisibleNode(playerGuessSimulation.data.plan.node, itemPickup->GetNode()))
 					gameItems[humanGuessItem.first] = humanGuessItem.second;
 		}
 		for (auto const& aiGuessItem : playerGuessView.guessItems[mPlayers[GV_AI]])
 		{
 			const AIAnalysis::ActorPickup* itemPickup = mGameActorPickups.at(aiGuessItem.first);
 			if (itemPickup)
-				if (!playerGuessSimulation.data.plan.node->IsVisibleNode(itemPickup->GetNode()))
+				if (!pathingGraphView->IsVisibleNode(playerGuessSimulation.data.plan.node, itemPickup->GetNode()))
 					gameItems[aiGuessItem.first] = aiGuessItem.second;
 		}
 	}
@@ -6682,7 +6704,7 @@ bool QuakeAIManager::MakeAIGuessingDecision(PlayerView& aiView)
 		{
 			const AIAnalysis::ActorPickup* itemPickup = mGameActorPickups.at(aiGuessItem.first);
 			if (itemPickup)
-				if (!aiDecisionSimulation.data.plan.node->IsVisibleNode(itemPickup->GetNode()))
+				if (!pathingGraphView->IsVisibleNode(aiDecisionSimulation.data.plan.node, itemPickup->GetNode()))
 					gameItems[aiGuessItem.first] = aiGuessItem.second;
 		}
 
@@ -6691,7 +6713,7 @@ bool QuakeAIManager::MakeAIGuessingDecision(PlayerView& aiView)
 		{
 			const AIAnalysis::ActorPickup* itemPickup = mGameActorPickups.at(humanGuessItem.first);
 			if (itemPickup)
-				if (!aiDecisionSimulation.data.plan.node->IsVisibleNode(itemPickup->GetNode()))
+				if (!pathingGraphView->IsVisibleNode(aiDecisionSimulation.data.plan.node, itemPickup->GetNode()))
 					gameItems[humanGuessItem.first] = humanGuessItem.second;
 		}
 	}
@@ -6769,6 +6791,8 @@ bool QuakeAIManager::MakeAIGuessingDecision(PlayerView& aiView)
 
 bool QuakeAIManager::MakeAIAwareDecision(PlayerView& aiView)
 {
+	std::shared_ptr<PathingGraphView> pathingGraphView = GetPathingGraphView();
+
 	mMutex.lock();
 
 	GetPlayerView(mPlayers[GV_AI], aiView);
@@ -6856,7 +6880,7 @@ bool QuakeAIManager::MakeAIAwareDecision(PlayerView& aiView)
 		{
 			const AIAnalysis::ActorPickup* itemPickup = mGameActorPickups.at(aiGuessItem.first);
 			if (itemPickup)
-				if (!aiDecisionSimulation.data.plan.node->IsVisibleNode(itemPickup->GetNode()))
+				if (!pathingGraphView->IsVisibleNode(aiDecisionSimulation.data.plan.node, itemPickup->GetNode()))
 					gameItems[aiGuessItem.first] = aiGuessItem.second;
 		}
 
@@ -6865,7 +6889,7 @@ bool QuakeAIManager::MakeAIAwareDecision(PlayerView& aiView)
 		{
 			const AIAnalysis::ActorPickup* itemPickup = mGameActorPickups.at(humanGuessItem.first);
 			if (itemPickup)
-				if (!aiDecisionSimulation.data.plan.node->IsVisibleNode(itemPickup->GetNode()))
+				if (!pathingGraphView->IsVisibleNode(aiDecisionSimulation.data.plan.node, itemPickup->GetNode()))
 					gameItems[humanGuessItem.first] = humanGuessItem.second;
 		}
 	}
@@ -6927,6 +6951,8 @@ bool QuakeAIManager::MakeAIAwareDecision(PlayerView& aiView)
 
 bool QuakeAIManager::MakeHumanGuessing(PlayerView& playerView)
 {
+	std::shared_ptr<PathingGraphView> pathingGraphView = GetPathingGraphView();
+
 	mMutex.lock();
 
 	GetPlayerView(mPlayers[GV_HUMAN], playerView);
@@ -6995,7 +7021,7 @@ bool QuakeAIManager::MakeHumanGuessing(PlayerView& playerView)
 		{
 			const AIAnalysis::ActorPickup* itemPickup = mGameActorPickups.at(humanGuessItem.first);
 			if (itemPickup)
-				if (!playerSimulation.data.plan.node->IsVisibleNode(itemPickup->GetNode()))
+				if (!pathingGraphView->IsVisibleNode(playerSimulation.data.plan.node, itemPickup->GetNode()))
 					gameItems[humanGuessItem.first] = humanGuessItem.second;
 		}
 
@@ -7004,7 +7030,7 @@ bool QuakeAIManager::MakeHumanGuessing(PlayerView& playerView)
 		{
 			const AIAnalysis::ActorPickup* itemPickup = mGameActorPickups.at(aiGuessItem.first);
 			if (itemPickup)
-				if (!playerSimulation.data.plan.node->IsVisibleNode(itemPickup->GetNode()))
+				if (!pathingGraphView->IsVisibleNode(playerSimulation.data.plan.node, itemPickup->GetNode()))
 					gameItems[aiGuessItem.first] = aiGuessItem.second;
 		}
 	}
@@ -7060,6 +7086,8 @@ bool QuakeAIManager::MakeHumanGuessing(PlayerView& playerView)
 
 bool QuakeAIManager::MakeHumanFastDecision(PlayerView& playerView)
 {
+	std::shared_ptr<PathingGraphView> pathingGraphView = GetPathingGraphView();
+
 	mMutex.lock();
 
 	GetPlayerView(mPlayers[GV_HUMAN], playerView);
@@ -7131,7 +7159,7 @@ bool QuakeAIManager::MakeHumanFastDecision(PlayerView& playerView)
 		{
 			const AIAnalysis::ActorPickup* itemPickup = mGameActorPickups.at(humanGuessItem.first);
 			if (itemPickup)
-				if (!playerSimulation.data.plan.node->IsVisibleNode(itemPickup->GetNode()))
+				if (!pathingGraphView->IsVisibleNode(playerSimulation.data.plan.node, itemPickup->GetNode()))
 					gameItems[humanGuessItem.first] = humanGuessItem.second;
 		}
 
@@ -7140,7 +7168,7 @@ bool QuakeAIManager::MakeHumanFastDecision(PlayerView& playerView)
 		{
 			const AIAnalysis::ActorPickup* itemPickup = mGameActorPickups.at(aiGuessItem.first);
 			if (itemPickup)
-				if (!playerSimulation.data.plan.node->IsVisibleNode(itemPickup->GetNode()))
+				if (!pathingGraphView->IsVisibleNode(playerSimulation.data.plan.node, itemPickup->GetNode()))
 					gameItems[aiGuessItem.first] = aiGuessItem.second;
 		}
 	}
@@ -7187,6 +7215,8 @@ bool QuakeAIManager::MakeHumanFastDecision(PlayerView& playerView)
 
 bool QuakeAIManager::MakeHumanGuessingDecision(PlayerView& playerView)
 {
+	std::shared_ptr<PathingGraphView> pathingGraphView = GetPathingGraphView();
+
 	mMutex.lock();
 
 	GetPlayerView(mPlayers[GV_HUMAN], playerView);
@@ -7276,7 +7306,7 @@ bool QuakeAIManager::MakeHumanGuessingDecision(PlayerView& playerView)
 		{
 			const AIAnalysis::ActorPickup* itemPickup = mGameActorPickups.at(guessItem.first);
 			if (itemPickup)
-				if (!aiGuessSimulation.data.plan.node->IsVisibleNode(itemPickup->GetNode()))
+				if (!pathingGraphView->IsVisibleNode(aiGuessSimulation.data.plan.node, itemPickup->GetNode()))
 					gameItems[guessItem.first] = guessItem.second;
 		}
 
@@ -7285,14 +7315,14 @@ bool QuakeAIManager::MakeHumanGuessingDecision(PlayerView& playerView)
 		{
 			const AIAnalysis::ActorPickup* itemPickup = mGameActorPickups.at(aiGuessItem.first);
 			if (itemPickup)
-				if (!aiGuessSimulation.data.plan.node->IsVisibleNode(itemPickup->GetNode()))
+				if (!pathingGraphView->IsVisibleNode(aiGuessSimulation.data.plan.node, itemPickup->GetNode()))
 					gameItems[aiGuessItem.first] = aiGuessItem.second;
 		}
 		for (auto const& humanGuessItem : aiGuessView.guessItems[mPlayers[GV_HUMAN]])
 		{
 			const AIAnalysis::ActorPickup* itemPickup = mGameActorPickups.at(humanGuessItem.first);
 			if (itemPickup)
-				if (!aiGuessSimulation.data.plan.node->IsVisibleNode(itemPickup->GetNode()))
+				if (!pathingGraphView->IsVisibleNode(aiGuessSimulation.data.plan.node, itemPickup->GetNode()))
 					gameItems[humanGuessItem.first] = humanGuessItem.second;
 		}
 	}
@@ -7309,7 +7339,7 @@ bool QuakeAIManager::MakeHumanGuessingDecision(PlayerView& playerView)
 		{
 			const AIAnalysis::ActorPickup* itemPickup = mGameActorPickups.at(humanGuessItem.first);
 			if (itemPickup)
-				if (!playerDecisionSimulation.data.plan.node->IsVisibleNode(itemPickup->GetNode()))
+				if (!pathingGraphView->IsVisibleNode(playerDecisionSimulation.data.plan.node, itemPickup->GetNode()))
 					gameItems[humanGuessItem.first] = humanGuessItem.second;
 		}
 
@@ -7318,7 +7348,7 @@ bool QuakeAIManager::MakeHumanGuessingDecision(PlayerView& playerView)
 		{
 			const AIAnalysis::ActorPickup* itemPickup = mGameActorPickups.at(aiGuessItem.first);
 			if (itemPickup)
-				if (!playerDecisionSimulation.data.plan.node->IsVisibleNode(itemPickup->GetNode()))
+				if (!pathingGraphView->IsVisibleNode(playerDecisionSimulation.data.plan.node, itemPickup->GetNode()))
 					gameItems[aiGuessItem.first] = aiGuessItem.second;
 		}
 	}
@@ -7396,6 +7426,8 @@ bool QuakeAIManager::MakeHumanGuessingDecision(PlayerView& playerView)
 
 bool QuakeAIManager::MakeHumanAwareDecision(PlayerView& playerView)
 {
+	std::shared_ptr<PathingGraphView> pathingGraphView = GetPathingGraphView();
+
 	mMutex.lock();
 
 	GetPlayerView(mPlayers[GV_HUMAN], playerView);
@@ -7483,7 +7515,7 @@ bool QuakeAIManager::MakeHumanAwareDecision(PlayerView& playerView)
 		{
 			const AIAnalysis::ActorPickup* itemPickup = mGameActorPickups.at(humanGuessItem.first);
 			if (itemPickup)
-				if (!playerDecisionSimulation.data.plan.node->IsVisibleNode(itemPickup->GetNode()))
+				if (!pathingGraphView->IsVisibleNode(playerDecisionSimulation.data.plan.node, itemPickup->GetNode()))
 					gameItems[humanGuessItem.first] = humanGuessItem.second;
 		}
 
@@ -7492,7 +7524,7 @@ bool QuakeAIManager::MakeHumanAwareDecision(PlayerView& playerView)
 		{
 			const AIAnalysis::ActorPickup* itemPickup = mGameActorPickups.at(aiGuessItem.first);
 			if (itemPickup)
-				if (!playerDecisionSimulation.data.plan.node->IsVisibleNode(itemPickup->GetNode()))
+				if (!pathingGraphView->IsVisibleNode(playerDecisionSimulation.data.plan.node, itemPickup->GetNode()))
 					gameItems[aiGuessItem.first] = aiGuessItem.second;
 		}
 	}
@@ -7556,7 +7588,7 @@ void QuakeAIManager::RunAIFastDecision()
 {
 	unsigned int iteration = 0;
 
-	while (true)
+	while (mDecisionMaking)
 	{
 		if (GameLogic::Get()->GetState() == BGS_RUNNING)
 		{
@@ -7610,7 +7642,7 @@ void QuakeAIManager::RunAIGuessing()
 {
 	unsigned int iteration = 0;
 
-	while (true)
+	while (mDecisionMaking)
 	{
 		if (GameLogic::Get()->GetState() == BGS_RUNNING)
 		{
@@ -7669,7 +7701,7 @@ void QuakeAIManager::RunAIAwareDecision()
 {
 	unsigned int iteration = 0;
 
-	while (true)
+	while (mDecisionMaking)
 	{
 		if (GameLogic::Get()->GetState() == BGS_RUNNING)
 		{
@@ -7731,7 +7763,7 @@ void QuakeAIManager::RunHumanFastDecision()
 {
 	unsigned int iteration = 0;
 
-	while (true)
+	while (mDecisionMaking)
 	{
 		if (GameLogic::Get()->GetState() == BGS_RUNNING)
 		{
@@ -7787,7 +7819,7 @@ void QuakeAIManager::RunHumanGuessing()
 {
 	unsigned int iteration = 0;
 
-	while (true)
+	while (mDecisionMaking)
 	{
 		if (GameLogic::Get()->GetState() == BGS_RUNNING)
 		{
@@ -7845,7 +7877,7 @@ void QuakeAIManager::RunHumanAwareDecision()
 {
 	unsigned int iteration = 0;
 
-	while (true)
+	while (mDecisionMaking)
 	{
 		if (GameLogic::Get()->GetState() == BGS_RUNNING)
 		{
@@ -7905,6 +7937,8 @@ void QuakeAIManager::RunHumanAwareDecision()
 
 void QuakeAIManager::GetPlayerInput(const AIAnalysis::PlayerInput& playerInput, PlayerData& playerData)
 {
+	std::shared_ptr<PathingGraphView> pathingGraphView = GetPathingGraphView();
+
 	playerData.player = playerInput.id;
 
 	playerData.weapon = playerInput.weapon;
@@ -7918,7 +7952,7 @@ void QuakeAIManager::GetPlayerInput(const AIAnalysis::PlayerInput& playerInput,
 		playerData.ammo[wp] = playerInput.ammo[wp];
 
 	playerData.plan.id = playerInput.planId;
-	playerData.plan.node = mPathingGraph->FindNode(playerInput.planNode);
+	playerData.plan.node = pathingGraphView->GetGraph()->FindNode(playerInput.planNode);
 
 	playerData.planWeight = playerInput.planWeight;
 	playerData.plan.weight = 0.f;
@@ -7926,7 +7960,7 @@ void QuakeAIManager::GetPlayerInput(const AIAnalysis::PlayerInput& playerInput,
 	PathingNode* pathingNode = playerData.plan.node;
 	for (int pathArc : playerInput.planPath)
 	{
-		PathingArc* pathingArc = pathingNode->FindArc(pathArc);
+		PathingArc* pathingArc = pathingGraphView->FindArc(pathingNode, pathArc);
 		playerData.plan.path.push_back(pathingArc);
 		playerData.plan.weight += pathingArc->GetWeight();
 
@@ -7939,6 +7973,8 @@ void QuakeAIManager::GetPlayerInput(const AIAnalysis::PlayerInput& playerInput,
 
 void QuakeAIManager::GetPlayerInput(const AIAnalysis::PlayerInput& playerInput, PlayerData& playerData, PlayerData& playerDataOffset)
 {
+	std::shared_ptr<PathingGraphView> pathingGraphView = GetPathingGraphView();
+
 	playerData.player = playerInput.id;
 
 	playerData.weapon = playerInput.weapon;
@@ -7952,7 +7988,7 @@ void QuakeAIManager::GetPlayerInput(const AIAnalysis::PlayerInput& playerInput,
 		playerData.ammo[wp] = playerInput.ammo[wp];
 
 	playerData.plan.id = playerInput.planId;
-	playerData.plan.node = mPathingGraph->FindNode(playerInput.planNode);
+	playerData.plan.node = pathingGraphView->GetGraph()->FindNode(playerInput.planNode);
 
 	playerData.planWeight = playerInput.planWeight;
 	playerData.plan.weight = 0.f;
@@ -7960,7 +7996,7 @@ void QuakeAIManager::GetPlayerInput(const AIAnalysis::PlayerInput& playerInput,
 	PathingNode* pathingNode = playerData.plan.node;
 	for (int pathArc : playerInput.planPath)
 	{
-		PathingArc* pathingArc = pathingNode->FindArc(pathArc);
+		PathingArc* pathingArc = pathingGraphView->FindArc(pathingNode, pathArc);
 		playerData.plan.path.push_back(pathingArc);
 		playerData.plan.weight += pathingArc->GetWeight();
 
@@ -7971,14 +8007,14 @@ void QuakeAIManager::GetPlayerInput(const AIAnalysis::PlayerInput& playerInput,
 	playerData.valid = playerInput.planPath.size() == playerInput.planPathOffset.size() ? false : true;
 
 	playerDataOffset = playerData;
-	playerDataOffset.plan.node = mPathingGraph->FindNode(playerInput.planNodeOffset);
+	playerDataOffset.plan.node = pathingGraphView->GetGraph()->FindNode(playerInput.planNodeOffset);
 	playerDataOffset.plan.weight = playerInput.planOffset;
 
 	playerDataOffset.plan.path.clear();
 	pathingNode = playerData.plan.node;
 	for (int pathArc : playerInput.planPathOffset)
 	{
-		PathingArc* pathingArc = pathingNode->FindArc(pathArc);
+		PathingArc* pathingArc = pathingGraphView->FindArc(pathingNode, pathArc);
 		playerDataOffset.plan.path.push_back(pathingArc);
 
 		pathingNode = pathingArc->GetNode();
@@ -7987,6 +8023,8 @@ void QuakeAIManager::GetPlayerInput(const AIAnalysis::PlayerInput& playerInput,
 
 void QuakeAIManager::GetPlayerOutput(const AIAnalysis::PlayerOutput& playerOutput, PlayerData& playerData)
 {
+	std::shared_ptr<PathingGraphView> pathingGraphView = GetPathingGraphView();
+
 	playerData.player = playerOutput.id;
 	playerData.heuristic = playerOutput.heuristic;
 
@@ -7998,13 +8036,13 @@ void QuakeAIManager::GetPlayerOutput(const AIAnalysis::PlayerOutput& playerOutpu
 	}
 
 	playerData.plan.id = playerOutput.planId;
-	playerData.plan.node = mPathingGraph->FindNode(playerOutput.planNode);
+	playerData.plan.node = pathingGraphView->GetGraph()->FindNode(playerOutput.planNode);
 
 	PathingArcVec pathPlan;
 	PathingNode* pathingNode = playerData.plan.node;
 	for (int pathArc : playerOutput.planPath)
 	{
-		PathingArc* pathingArc = pathingNode->FindArc(pathArc);
+		PathingArc* pathingArc = pathingGraphView->FindArc(pathingNode, pathArc);
 		pathPlan.push_back(pathingArc);
 		pathingNode = pathingArc->GetNode();
 	}
@@ -8015,6 +8053,8 @@ void QuakeAIManager::GetPlayerOutput(const AIAnalysis::PlayerOutput& playerOutpu
 
 void QuakeAIManager::GetPlayerSimulation(const AIAnalysis::PlayerSimulation& playerSimulation, PlayerData& playerData)
 {
+	std::shared_ptr<PathingGraphView> pathingGraphView = GetPathingGraphView();
+
 	playerData.heuristic = playerSimulation.heuristic;
 
 	playerData.target = playerSimulation.target;
@@ -8030,7 +8070,7 @@ void QuakeAIManager::GetPlayerSimulation(const AIAnalysis::PlayerSimulation& pla
 	PathingNode* pathingNode = playerData.plan.node;
 	for (int pathArc : playerSimulation.planPath)
 	{
-		PathingArc* pathingArc = pathingNode->FindArc(pathArc);
+		PathingArc* pathingArc = pathingGraphView->FindArc(pathingNode, pathArc);
 		pathPlan.push_back(pathingArc);
 		pathingNode = pathingArc->GetNode();
 	}
@@ -8242,15 +8282,16 @@ void QuakeAIManager::SpawnActor(ActorId playerId)
 			playerView.data = PlayerData(pPlayerActor);
 			playerView.simulation = PlayerData(pPlayerActor);
 
-			if (mPathingGraph)
+			std::shared_ptr<PathingGraph> pathingGraph = GetPathingGraph();
+			if (pathingGraph)
 			{
-				PathingNode* spawnNode = mPathingGraph->FindClosestNode(pPhysicComponent->GetPosition(), false);
+				PathingNode* spawnNode = pathingGraph->FindClosestNode(pPhysicComponent->GetPosition(), false);
 				playerView.data.plan = NodePlan(spawnNode, PathingArcVec());
 
 				//assuming the guessing players has no idea where our player is located, lets take a random spawn spot
 				Transform spawnTransform;
 				game->SelectRandomFurthestSpawnPoint(spawnNode->GetPosition(), spawnTransform, false);
-				spawnNode = mPathingGraph->FindClosestNode(spawnTransform.GetTranslation(), false);
+				spawnNode = pathingGraph->FindClosestNode(spawnTransform.GetTranslation(), false);
 
 				std::vector<std::shared_ptr<PlayerActor>> playerActors;
 				game->GetPlayerActors(playerActors);
@@ -8274,7 +8315,7 @@ void QuakeAIManager::SpawnActor(ActorId playerId)
 					//what the guessing player is guessing about the other.
 					Transform guessSpawnTransform;
 					game->SelectRandomFurthestSpawnPoint(spawnNode->GetPosition(), guessSpawnTransform, false);
-					PathingNode* guessSpawnNode = mPathingGraph->FindClosestNode(guessSpawnTransform.GetTranslation(), false);
+					PathingNode* guessSpawnNode = pathingGraph->FindClosestNode(guessSpawnTransform.GetTranslation(), false);
 					playerGuessView.guessPlayers[pPlayerActor->GetId()].plan = NodePlan(guessSpawnNode, PathingArcVec());
 					playerGuessView.guessSimulations[pPlayerActor->GetId()].plan = NodePlan(guessSpawnNode, PathingArcVec());
 
@@ -8331,7 +8372,8 @@ void QuakeAIManager::DetectActor(std::shared_ptr<PlayerActor> pPlayerActor, std:
 
 		std::shared_ptr<PhysicComponent> pPlayerPhysicComponent(
 			pPlayerActor->GetComponent<PhysicComponent>(PhysicComponent::Name).lock());
-		PathingNode* playerNode = mPathingGraph->FindClosestNode(pPlayerPhysicComponent->GetPosition(), false);
+		std::shared_ptr<PathingGraph> pathingGraph = GetPathingGraph();
+		PathingNode* playerNode = pathingGraph->FindClosestNode(pPlayerPhysicComponent->GetPosition(), false);
 
 		//if the noise is detected within a range then we reset the guess players status.
 		std::stringstream playerInfo;
@@ -8415,7 +8457,9 @@ void QuakeAIManager::DetectPlayer(std::shared_ptr<PlayerActor> pPlayerActor)
 			pPlayerActor->GetComponent<PhysicComponent>(PhysicComponent::Name).lock());
 		if (Length(pPlayerPhysicComponent->GetPosition() - playerGuessView.data.plan.node->GetPosition()) > 500.f)
 			continue;
-		PathingNode* playerNode = mPathingGraph->FindClosestNode(pPlayerPhysicComponent->GetPosition(), false);
+
+		std::shared_ptr<PathingGraph> pathingGraph = GetPathingGraph();
+		PathingNode* playerNode = pathingGraph->FindClosestNode(pPlayerPhysicComponent->GetPosition(), false);
 
 		//if the noise is detected within a range then we reset the guess players status.
 		std::stringstream playerInfo;
@@ -9922,6 +9966,8 @@ void QuakeAIManager::CalculateVisibility(
 	PathingNode* otherPlayerNode, float otherPlayerPathOffset, float otherPlayerVisibleTime,
 	const PathingArcVec& otherPlayerPathPlan, std::map<float, VisibilityData>& otherPlayerVisibility)
 {
+	std::shared_ptr<PathingGraphView> pathingGraphView = GetPathingGraphView();
+
 	float totalWeight = 0.f, totalArcWeight = 0.f;
 	unsigned int index = 0, otherIndex = 0, otherPathIndex = 0;
 
@@ -10006,7 +10052,7 @@ void QuakeAIManager::CalculateVisibility(
 			for (; index < transitionPositions.get().size(); index++)
 			{
 				float currentWeight = currentArc->GetTransition()->GetWeights()[index];
-				if (transitionNodes.get()[index]->IsVisibleNode(otherTransitionNodes.get()[otherIndex]))
+				if (pathingGraphView->IsVisibleNode(transitionNodes.get()[index], otherTransitionNodes.get()[otherIndex]))
 				//if (RayCollisionDetection(transitionPositions[index], otherTransitionPositions[otherIndex]) == NULL)
 				{
 					for (auto visIt = std::next(visibilityIt); visIt != playerVisibility.end(); visIt++)
@@ -10098,7 +10144,7 @@ void QuakeAIManager::CalculateVisibility(
 			for (; index < transitionPositions.size(); index++)
 			{
 				float currentWeight = currentArc->GetTransition()->GetWeights()[index];
-				if (transitionNodes[index]->IsVisibleNode(otherCurrentNode))
+				if (pathingGraphView->IsVisibleNode(transitionNodes[index], otherCurrentNode))
 					//if (RayCollisionDetection(transitionPositions[index], otherTransitionPositions[otherIndex]) == NULL)
 				{
 					for (auto visIt = std::next(visibilityIt); visIt != playerVisibility.end(); visIt++)
@@ -10158,7 +10204,7 @@ void QuakeAIManager::CalculateVisibility(
 	if (totalVisibleWeight < 1.5f)
 	{
 		//we need to add visible time if the total visible move time is short
-		if (currentNode->IsVisibleNode(otherCurrentNode))
+		if (pathingGraphView->IsVisibleNode(currentNode, otherCurrentNode))
 			/*if (RayCollisionDetection(currentNode->GetPosition(), otherCurrentNode->GetPosition()) == NULL)*/
 		{
 			float currentWeight = 0.5f;
@@ -10269,8 +10315,8 @@ Vector3<float> QuakeAIManager::CalculatePathingPosition(const PlayerData& player
 
 void QuakeAIManager::PerformGuessingMaking(
 	const AIAnalysis::GameEvaluation& gameEvaluation, const PlayerData& playerDataIn, const PlayerData& otherPlayerDataIn,
-	const Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-	const Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
+	const ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+	const ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
 	WeaponType& playerWeapon, WeaponType& otherPlayerWeapon, unsigned long long& playerClusterCode, unsigned long long& otherPlayerClusterCode)
 {
 	//lets filter guessings in which the opponent has weapon advantage against all the player actions
@@ -10545,10 +10591,10 @@ void QuakeAIManager::PerformGuessingMaking(
 }
 
 void QuakeAIManager::PerformDecisionMaking(const PlayerData& playerDataIn, const PlayerData& otherPlayerDataIn,
-	const Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-	const Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
-	const Concurrency::concurrent_unordered_map<unsigned long long, Concurrency::concurrent_unordered_map<unsigned long long, float>>& playerDecisions,
-	const Concurrency::concurrent_unordered_map<unsigned long long, Concurrency::concurrent_unordered_map<unsigned long long, unsigned short>>& playerWeaponDecisions,
+	const ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+	const ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
+	const ConcurrentUnorderedMap<unsigned long long, ConcurrentUnorderedMap<unsigned long long, float>>& playerDecisions,
+	const ConcurrentUnorderedMap<unsigned long long, ConcurrentUnorderedMap<unsigned long long, unsigned short>>& playerWeaponDecisions,
 	WeaponType& playerWeapon, WeaponType& otherPlayerWeapon, unsigned long long& playerClusterCode, unsigned long long& otherPlayerClusterCode)
 {
 	//lets filter decisions in which the opponent has weapon advantage against all the player actions
@@ -10846,10 +10892,10 @@ void QuakeAIManager::PerformDecisionMaking(const PlayerData& playerDataIn, const
 	}
 }
 void QuakeAIManager::PerformGuessingMaking(const PlayerData& playerDataIn, const PlayerData& otherPlayerDataIn,
-	const Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-	const Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
-	const Concurrency::concurrent_unordered_map<unsigned long long, Concurrency::concurrent_unordered_map<unsigned long long, float>>& playerGuessings,
-	const Concurrency::concurrent_unordered_map<unsigned long long, Concurrency::concurrent_unordered_map<unsigned long long, unsigned short>>& playerWeaponGuessings,
+	const ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+	const ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
+	const ConcurrentUnorderedMap<unsigned long long, ConcurrentUnorderedMap<unsigned long long, float>>& playerGuessings,
+	const ConcurrentUnorderedMap<unsigned long long, ConcurrentUnorderedMap<unsigned long long, unsigned short>>& playerWeaponGuessings,
 	WeaponType& playerWeapon, WeaponType& otherPlayerWeapon, unsigned long long& playerClusterCode, unsigned long long& otherPlayerClusterCode)
 {
 	//lets filter guessings in which the opponent has weapon advantage against all the player actions
@@ -11148,8 +11194,8 @@ void QuakeAIManager::PerformGuessingMaking(const PlayerData& playerDataIn, const
 
 void QuakeAIManager::PerformDecisionMaking(
 	const AIAnalysis::GameEvaluation& gameEvaluation, const PlayerData& playerDataIn, const PlayerData& otherPlayerDataIn,
-	const Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-	const Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
+	const ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+	const ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
 	WeaponType& playerWeapon, WeaponType& otherPlayerWeapon, unsigned long long& playerClusterCode, unsigned long long& otherPlayerClusterCode)
 {
 	//lets filter decisions in which the opponent has weapon advantage against all the player actions
@@ -11579,6 +11625,8 @@ void QuakeAIManager::PickupItems(PlayerData& playerData,
 PathingNode* QuakeAIManager::FindClosestNode(ActorId playerId, 
 	std::shared_ptr<PathingGraph>& graph, float closestDistance, bool skipIsolated)
 {
+	ScopeProfiler sp(Profiling, "QuakeAIManager::FindClosestNode()", SPT_AVG);
+
 	std::shared_ptr<BaseGamePhysic> gamePhysics = GameLogic::Get()->GetGamePhysics();
 
 	std::vector<std::pair<Transform, bool>> interpolations;
@@ -12016,7 +12064,8 @@ bool QuakeAIManager::CheckPlayerGuessItems(PathingNode* playerNode, PlayerGuessV
 			GameLogic::Get()->GetActor(playerGuessView.data.plan.node->GetActorId()).lock());
 		std::shared_ptr<TransformComponent> pItemTransform(
 			pItemActor->GetComponent<TransformComponent>(TransformComponent::Name).lock());
-		PathingNode* itemNode = mPathingGraph->FindClosestNode(pItemTransform->GetTransform().GetTranslation(), false);
+		std::shared_ptr<PathingGraph> pathingGraph = GetPathingGraph();
+		PathingNode* itemNode = pathingGraph->FindClosestNode(pItemTransform->GetTransform().GetTranslation(), false);
 
 		if (playerNode->IsVisibleNode(itemNode))
 		{
@@ -12076,7 +12125,8 @@ bool QuakeAIManager::CheckPlayerGuessItems(PathingNode* playerNode, PlayerGuessV
 			GameLogic::Get()->GetActor(playerGuessView.data.plan.node->GetActorId()).lock());
 		std::shared_ptr<TransformComponent> pItemTransform(
 			pItemActor->GetComponent<TransformComponent>(TransformComponent::Name).lock());
-		PathingNode* itemNode = mPathingGraph->FindClosestNode(pItemTransform->GetTransform().GetTranslation(), false);
+		std::shared_ptr<PathingGraph> pathingGraph = GetPathingGraph();
+		PathingNode* itemNode = pathingGraph->FindClosestNode(pItemTransform->GetTransform().GetTranslation(), false);
 		if (playerNode->IsVisibleNode(itemNode))
 		{
 			//check if the item is visible which means that the player couldn't possibly have taken it
@@ -12228,7 +12278,8 @@ void QuakeAIManager::UpdatePlayerGuessItems(unsigned long deltaMs, ActorId playe
 
 void QuakeAIManager::OnUpdate(unsigned long deltaMs)
 {
-	if (!mEnable || !mPathingGraph)
+	std::shared_ptr<PathingGraph> pathingGraph = GetPathingGraph();
+	if (!mEnable || !pathingGraph)
 		return;
 
 	GameApplication* gameApp = (GameApplication*)Application::App;
@@ -12255,7 +12306,7 @@ void QuakeAIManager::OnUpdate(unsigned long deltaMs)
 
 		std::shared_ptr<PhysicComponent> pPlayerPhysicComponent(
 			pPlayerActor->GetComponent<PhysicComponent>(PhysicComponent::Name).lock());
-		PathingNode* playerNode = mPathingGraph->FindClosestNode(pPlayerPhysicComponent->GetPosition(), false);
+		PathingNode* playerNode = pathingGraph->FindClosestNode(pPlayerPhysicComponent->GetPosition(), false);
 
 		PlayerView playerView;
 		GetPlayerView(pPlayerActor->GetId(), playerView);
@@ -12337,7 +12388,7 @@ void QuakeAIManager::OnUpdate(unsigned long deltaMs)
 					pOtherPlayerActor->GetComponent<PhysicComponent>(PhysicComponent::Name).lock());
 				if (pOtherPlayerPhysicComponent)
 				{
-					PathingNode* otherPlayerNode = mPathingGraph->FindClosestNode(pOtherPlayerPhysicComponent->GetPosition(), false);
+					PathingNode* otherPlayerNode = pathingGraph->FindClosestNode(pOtherPlayerPhysicComponent->GetPosition(), false);
 					bool resetOtherGuessItem = CheckPlayerGuessItems(otherPlayerNode, playerGuessView);
 
 					if (playerNode->IsVisibleNode(otherPlayerNode))
@@ -13314,7 +13365,7 @@ void QuakeAIManager::CreateTransitions(std::shared_ptr<PathingGraph>& graph)
 	// visibility since there are hundred of millions of pair transition combinations depending 
 	// on the size of the map which will take forever to simulate visibility. Thats why we have to 
 	// make an aproximation by associating every transition position to its neareast node
-	Concurrency::parallel_for_each(begin(graph->GetNodes()), end(graph->GetNodes()), [&](auto& node)
+	ParallelForEach(begin(graph->GetNodes()), end(graph->GetNodes()), [&](auto& node)
 	{
 		PathingNode* pathNode = node.second;
 
@@ -13385,7 +13436,7 @@ void QuakeAIManager::CreateClusters(std::shared_ptr<PathingGraph>& graph, unsign
 	kmeans.Run(points);
 
 	std::map<unsigned int, PathingNodeVec> clusterNodes;
-	for (Point point : points)
+	for (const Point& point : points)
 	{
 		PathingNode* pathNode = graph->FindNode(point.GetId());
 		pathNode->SetCluster(point.GetCluster());
@@ -13413,7 +13464,7 @@ void QuakeAIManager::CreateClusters(std::shared_ptr<PathingGraph>& graph, unsign
 	}
 
 	std::map<unsigned short, PathingNode*> searchClusters;
-	for (Clustering kCluster : kmeans.GetClusters())
+	for (const Clustering& kCluster : kmeans.GetClusters())
 	{
 		if (clusterNodes.find(kCluster.GetId()) == clusterNodes.end() || clusterNodes[kCluster.GetId()].empty())
 			continue;
@@ -13472,7 +13523,7 @@ void QuakeAIManager::CreateClusters(std::shared_ptr<PathingGraph>& graph, unsign
 
 	std::mutex mutex;
 
-	Concurrency::parallel_for_each(begin(graph->GetClusters()), end(graph->GetClusters()), [&](auto& cluster)
+	ParallelForEach(begin(graph->GetClusters()), end(graph->GetClusters()), [&](auto& cluster)
 	{
 		std::map<unsigned short, std::map<PathingNode*, unsigned short>> clustersVisibleNodes;
 		for (auto const& clusterNode : cluster.second->GetNodes())
@@ -13509,7 +13560,7 @@ void QuakeAIManager::CreateClusters(std::shared_ptr<PathingGraph>& graph, unsign
 		}
 	});
 
-	Concurrency::parallel_for_each(begin(graph->GetNodes()), end(graph->GetNodes()), [&](auto& node)
+	ParallelForEach(begin(graph->GetNodes()), end(graph->GetNodes()), [&](auto& node)
 	{
 		PathingNode* pathNode = node.second;
 
@@ -13566,7 +13617,7 @@ void QuakeAIManager::CreateClusters(std::shared_ptr<PathingGraph>& graph, unsign
 		mutex.unlock();
 	});
 
-	Concurrency::parallel_for_each(begin(graph->GetNodes()), end(graph->GetNodes()), [&](auto& node)
+	ParallelForEach(begin(graph->GetNodes()), end(graph->GetNodes()), [&](auto& node)
 	{
 		PathingNode* pathNode = node.second;
 
@@ -13622,7 +13673,7 @@ void QuakeAIManager::CreateClusters(std::shared_ptr<PathingGraph>& graph, unsign
 		mutex.unlock();
 	});
 
-	Concurrency::parallel_for_each(begin(graph->GetNodes()), end(graph->GetNodes()), [&](auto& node)
+	ParallelForEach(begin(graph->GetNodes()), end(graph->GetNodes()), [&](auto& node)
 	{
 		PathingNode* pathNode = node.second;
 
@@ -13673,7 +13724,7 @@ void QuakeAIManager::CreateClusters(std::shared_ptr<PathingGraph>& graph, unsign
 		mutex.unlock();
 	});
 
-	Concurrency::parallel_for_each(begin(graph->GetNodes()), end(graph->GetNodes()), [&](auto& node)
+	ParallelForEach(begin(graph->GetNodes()), end(graph->GetNodes()), [&](auto& node)
 	{
 		PathingNode* pathNode = node.second;
 
@@ -16906,7 +16957,7 @@ void QuakeAIManager::SimulateVisibility(std::shared_ptr<PathingGraph>& graph)
 		Vector3<float> origin = pathNode->GetPosition();
 		origin[AXIS_Y] += mPlayerActor->GetState().viewHeight;
 
-		Concurrency::parallel_for_each(begin(graph->GetNodes()), end(graph->GetNodes()), [&](auto& node)
+		ParallelForEach(begin(graph->GetNodes()), end(graph->GetNodes()), [&](auto& node)
 		{
 			PathingNode* visibleNode = node.second;
 			Vector3<float> end = visibleNode->GetPosition() +
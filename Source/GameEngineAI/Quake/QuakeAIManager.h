@@ -13,6 +13,8 @@
 #include "Games/Actors/PlayerActor.h"
 
 #include "Core/Event/EventManager.h"
+#include "Core/Threading/TaskScheduler.h"
+#include "Core/Threading/ConcurrentContainers.h"
 
 #include "Physic/PhysicEventListener.h"
 
@@ -25,20 +27,14 @@
 #include <cereal/archives/binary.hpp>
 #include <fstream>
 
-#include <ppl.h>
-#include <ppltasks.h>
-
 #include <mutex>
-#include <concurrent_queue.h>
-#include <concurrent_vector.h>
-#include <concurrent_unordered_map.h>
 
 class Transform;
 class AIPlanNode;
 
-typedef Concurrency::concurrent_queue<AIPlanNode*> AIPlanNodeList;
-typedef Concurrency::concurrent_vector<AIPlanNode*> AIPlanNodeVector;
-typedef Concurrency::concurrent_unordered_map<ActorId, AIPlanNodeVector> ActorToAIPlanNodeMap;
+typedef std::deque<AIPlanNode*> AIPlanNodeList;
+typedef ConcurrentVector<AIPlanNode*> AIPlanNodeVector;
+typedef ConcurrentUnorderedMap<ActorId, AIPlanNodeVector> ActorToAIPlanNodeMap;
 
 //
 // struct VisibilityData
@@ -1032,6 +1028,7 @@ public:
 	virtual void SaveGraph(const std::string& path, std::shared_ptr<PathingGraph>& graph);
 	virtual void LoadGraph(const std::wstring& path, float weightConversion = 1.0f);
 	virtual void LoadGraph(const std::wstring& path, std::shared_ptr<PathingGraph>& graph, float weightConversion = 1.0f);
+	bool ConvertGraph(const std::wstring& path);
 
 	void CreatePathingJump(ActorId playerId, NodePlan& pathPlan, std::shared_ptr<PathingGraph>& graph);
 	void CreatePathingFall(ActorId playerId, NodePlan& pathPlan, std::shared_ptr<PathingGraph>& graph);
@@ -1128,49 +1125,49 @@ protected:
 	void BuildPlayerPath(const AIAnalysis::PlayerSimulation& playerSimulation,
 		PathingNode* playerNode, float playerPathOffset, PathingArcVec& playerPathPlan);
 	void BuildExpandedPath(
-		std::shared_ptr<PathingGraph>& graph, unsigned int maxPathingClusters, PathingNode* clusterNodeStart,
+		const std::shared_ptr<PathingGraphView>& pathingGraphView, unsigned int maxPathingClusters, PathingNode* clusterNodeStart,
 		const std::map<PathingCluster*, PathingArcVec>& clusterPaths, const std::map<PathingCluster*, float>& expandClusterPathWeights,
-		Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& clusterNodePathPlans);
+		ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& clusterNodePathPlans);
 	void BuildExpandedActorPath(
-		std::shared_ptr<PathingGraph>& graph, PathingNode* clusterNodeStart,
-		Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& actorPathPlanClusters,
-		Concurrency::concurrent_unordered_map<unsigned long long, float>& actorPathPlanClusterHeuristics);
+		const std::shared_ptr<PathingGraphView>& pathingGraphView, PathingNode* clusterNodeStart,
+		ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& actorPathPlanClusters,
+		ConcurrentUnorderedMap<unsigned long long, float>& actorPathPlanClusterHeuristics);
 	void BuildExpandedActorPath(
-		std::shared_ptr<PathingGraph>& graph, PathingNode* clusterNodeStart, float heuristicThreshold,
-		Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& actorPathPlanClusters,
-		Concurrency::concurrent_unordered_map<unsigned long long, float>& actorPathPlanClusterHeuristics);
-	void BuildActorPath(std::shared_ptr<PathingGraph>& graph,
+		const std::shared_ptr<PathingGraphView>& pathingGraphView, PathingNode* clusterNodeStart, float heuristicThreshold,
+		ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& actorPathPlanClusters,
+		ConcurrentUnorderedMap<unsigned long long, float>& actorPathPlanClusterHeuristics);
+	void BuildActorPath(const std::shared_ptr<PathingGraphView>& pathingGraphView,
 		unsigned int actionType, const std::map<ActorId, float>& gameItems, const std::map<ActorId, float>& searchItems,
 		const PlayerData& player, PathingNode* clusterNodeStart, const PathingArcVec& clusterPathStart, float clusterPathOffset,
-		Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-		const Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& clusterNodePathPlans,
-		Concurrency::concurrent_unordered_map<unsigned long long, float>& actorPathPlanClusterHeuristics,
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& actorPathPlanClusters);
+		ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+		const ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& clusterNodePathPlans,
+		ConcurrentUnorderedMap<unsigned long long, float>& actorPathPlanClusterHeuristics,
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& actorPathPlanClusters);
 	bool BuildPath(
-		std::shared_ptr<PathingGraph>& graph, PathingNode* clusterNodeStart, PathingNode* otherClusterNodeStart,
-		Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-		Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& clusterNodePathPlans,
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& otherClusterNodePathPlans);
+		const std::shared_ptr<PathingGraphView>& pathingGraphView, PathingNode* clusterNodeStart, PathingNode* otherClusterNodeStart,
+		ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+		ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& clusterNodePathPlans,
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& otherClusterNodePathPlans);
 	bool BuildLongPath(
-		std::shared_ptr<PathingGraph>& graph, PathingNode* clusterNodeStart, PathingNode* otherClusterNodeStart,
-		Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-		Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& clusterNodePathPlans,
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& otherClusterNodePathPlans);
+		const std::shared_ptr<PathingGraphView>& pathingGraphView, PathingNode* clusterNodeStart, PathingNode* otherClusterNodeStart,
+		ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+		ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& clusterNodePathPlans,
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& otherClusterNodePathPlans);
 	bool BuildLongPath(
-		std::shared_ptr<PathingGraph>& graph, PathingNode* clusterNodeStart,
-		Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& clusterNodePathPlans);
+		const std::shared_ptr<PathingGraphView>& pathingGraphView, PathingNode* clusterNodeStart,
+		ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& clusterNodePathPlans);
 	bool BuildLongestPath(
-		std::shared_ptr<PathingGraph>& graph, PathingNode* clusterNodeStart, PathingNode* otherClusterNodeStart,
-		Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-		Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& clusterNodePathPlans,
-		Concurrency::concurrent_unordered_map<unsigned long long, PathingArcVec>& otherClusterNodePathPlans);
+		const std::shared_ptr<PathingGraphView>& pathingGraphView, PathingNode* clusterNodeStart, PathingNode* otherClusterNodeStart,
+		ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+		ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& clusterNodePathPlans,
+		ConcurrentUnorderedMap<unsigned long long, PathingArcVec>& otherClusterNodePathPlans);
 
 	PathingNode* FindClosestNode(ActorId playerId,
 		std::shared_ptr<PathingGraph>& graph, float closestDistance, bool skipIsolated = true);
@@ -1181,27 +1178,27 @@ protected:
 		PlayerData& otherPlayerData, const PathingArcVec& otherPlayerPathPlan, float otherPlayerPathOffset);
 
 	void PerformDecisionMaking(const PlayerData& playerDataIn, const PlayerData& otherPlayerDataIn,
-		const Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-		const Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
-		const Concurrency::concurrent_unordered_map<unsigned long long, Concurrency::concurrent_unordered_map<unsigned long long, float>>& playerDecisions,
-		const Concurrency::concurrent_unordered_map<unsigned long long, Concurrency::concurrent_unordered_map<unsigned long long, unsigned short>>& playerWeaponDecisions,
+		const ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+		const ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
+		const ConcurrentUnorderedMap<unsigned long long, ConcurrentUnorderedMap<unsigned long long, float>>& playerDecisions,
+		const ConcurrentUnorderedMap<unsigned long long, ConcurrentUnorderedMap<unsigned long long, unsigned short>>& playerWeaponDecisions,
 		WeaponType& playerWeapon, WeaponType& otherPlayerWeapon, unsigned long long& playerClusterCode, unsigned long long& otherPlayerClusterCode);
 	void PerformGuessingMaking(const PlayerData& playerDataIn, const PlayerData& otherPlayerDataIn,
-		const Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-		const Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
-		const Concurrency::concurrent_unordered_map<unsigned long long, Concurrency::concurrent_unordered_map<unsigned long long, float>>& playerGuessings,
-		const Concurrency::concurrent_unordered_map<unsigned long long, Concurrency::concurrent_unordered_map<unsigned long long, unsigned short>>& playerWeaponGuessings,
+		const ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+		const ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
+		const ConcurrentUnorderedMap<unsigned long long, ConcurrentUnorderedMap<unsigned long long, float>>& playerGuessings,
+		const ConcurrentUnorderedMap<unsigned long long, ConcurrentUnorderedMap<unsigned long long, unsigned short>>& playerWeaponGuessings,
 		WeaponType& playerWeapon, WeaponType& otherPlayerWeapon, unsigned long long& playerClusterCode, unsigned long long& otherPlayerClusterCode);
 
 	void PerformDecisionMaking(
 		const AIAnalysis::GameEvaluation& gameEvaluation, const PlayerData& playerDataIn, const PlayerData& otherPlayerDataIn,
-		const Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-		const Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
+		const ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+		const ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
 		WeaponType& playerWeapon, WeaponType& otherPlayerWeapon, unsigned long long& playerClusterCode, unsigned long long& otherPlayerClusterCode);
 	void PerformGuessingMaking(
 		const AIAnalysis::GameEvaluation& gameEvaluation, const PlayerData& playerDataIn, const PlayerData& otherPlayerDataIn,
-		const Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
-		const Concurrency::concurrent_unordered_map<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
+		const ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& clusterPathings,
+		const ConcurrentUnorderedMap<unsigned long long, std::pair<PathingCluster*, PathingCluster*>>& otherClusterPathings,
 		WeaponType& playerWeapon, WeaponType& otherPlayerWeapon, unsigned long long& playerClusterCode, unsigned long long& otherPlayerClusterCode);
 
 	// Analysis simulation
@@ -1265,6 +1262,10 @@ protected:
 	bool MakeHumanGuessingDecision(PlayerView& playerView);
 	bool MakeHumanAwareDecision(PlayerView& playerView);
 
+	// the decision making loops run until StopDecisionMaking is called
+	void StartDecisionMaking() { mDecisionMaking = true; }
+	void StopDecisionMaking() { mDecisionMaking = false; }
+
 	void RunAIGuessing();
 	void RunAIFastDecision();
 	void RunAIAwareDecision();
@@ -1310,6 +1311,9 @@ private:
 	void CreateTransitions(std::shared_ptr<PathingGraph>& graph);
 	void CreateClusters(std::shared_ptr<PathingGraph>& graph, unsigned int totalClusters);
 
+	bool LoadGraphFile(const std::wstring& path, std::shared_ptr<PathingGraph>& graph, float weightConversion);
+	bool LoadGraphArchive(const std::wstring& path, std::shared_ptr<PathingGraph>& graph, float weightConversion);
+
 	unsigned int GetNewArcID(void) { return ++mLastArcId; }
 	unsigned int GetNewNodeID(void) { return ++mLastNodeId; }
 
@@ -1344,6 +1348,7 @@ private:
 	void PrintPlayerData(const PlayerData& playerData);
 
 	bool mEnable;
+	std::atomic<bool> mDecisionMaking;
 
 	//logs
 	std::ofstream mLogError;
@@ -1359,7 +1364,7 @@ private:
 	AIAnalysis::GameEvaluation mGameEvaluation;
 	AIAnalysis::GameDecision mGameDecision;
 	AIAnalysis::Simulation* mGameSimulation;
-	Concurrency::concurrent_vector<AIAnalysis::GameDecision> mGameDecisions;
+	ConcurrentVector<AIAnalysis::GameDecision> mGameDecisions;
 
 	std::mutex mMutex;
 	std::map<ActorId, unsigned int> mAIStates;
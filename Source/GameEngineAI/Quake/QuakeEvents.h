@@ -1049,6 +1049,16 @@ public:
         in >> mId;
     }
 
+    virtual void SerializeBinary(std::ostream& out) const
+    {
+        WriteUInt32(out, mId);
+    }
+
+    virtual void DeserializeBinary(std::istream& in)
+    {
+        mId = ReadUInt32(in);
+    }
+
     virtual const char* GetName(void) const
     {
         return "EventDataFireWeapon";
@@ -1382,6 +1392,18 @@ public:
 			in >> mDirection[i];
 	}
 
+	virtual void SerializeBinary(std::ostream& out) const
+	{
+		WriteUInt32(out, mId);
+		WriteV3Float(out, mDirection);
+	}
+
+	virtual void DeserializeBinary(std::istream& in)
+	{
+		mId = ReadUInt32(in);
+		mDirection = ReadV3Float(in);
+	}
+
 	virtual BaseEventDataPtr Copy() const
 	{
 		return BaseEventDataPtr(new EventDataPushActor(mId, mDirection));
@@ -1449,6 +1471,20 @@ public:
 			in >> mFallDirection[i];
 	}
 
+	virtual void SerializeBinary(std::ostream& out) const
+	{
+		WriteUInt32(out, mId);
+		WriteV3Float(out, mDirection);
+		WriteV3Float(out, mFallDirection);
+	}
+
+	virtual void DeserializeBinary(std::istream& in)
+	{
+		mId = ReadUInt32(in);
+		mDirection = ReadV3Float(in);
+		mFallDirection = ReadV3Float(in);
+	}
+
 	virtual BaseEventDataPtr Copy() const
 	{
 		return BaseEventDataPtr(new EventDataJumpActor(mId, mDirection, mFallDirection));
@@ -1521,6 +1557,20 @@ public:
 			in >> mFallDirection[i];
 	}
 
+	virtual void SerializeBinary(std::ostream& out) const
+	{
+		WriteUInt32(out, mId);
+		WriteV3Float(out, mDirection);
+		WriteV3Float(out, mFallDirection);
+	}
+
+	virtual void DeserializeBinary(std::istream& in)
+	{
+		mId = ReadUInt32(in);
+		mDirection = ReadV3Float(in);
+		mFallDirection = ReadV3Float(in);
+	}
+
 	virtual BaseEventDataPtr Copy() const
 	{
 		return BaseEventDataPtr(new EventDataMoveActor(mId, mDirection, mFallDirection));
@@ -1588,6 +1638,18 @@ public:
 			in >> mDirection[i];
 	}
 
+	virtual void SerializeBinary(std::ostream& out) const
+	{
+		WriteUInt32(out, mId);
+		WriteV3Float(out, mDirection);
+	}
+
+	virtual void DeserializeBinary(std::istream& in)
+	{
+		mId = ReadUInt32(in);
+		mDirection = ReadV3Float(in);
+	}
+
 	virtual BaseEventDataPtr Copy() const
 	{
 		return BaseEventDataPtr(new EventDataFallActor(mId, mDirection));
@@ -1650,6 +1712,20 @@ public:
 		in >> mPitch;
 	}
 
+	virtual void SerializeBinary(std::ostream& out) const
+	{
+		WriteUInt32(out, mId);
+		WriteFloat(out, mYaw);
+		WriteFloat(out, mPitch);
+	}
+
+	virtual void DeserializeBinary(std::istream& in)
+	{
+		mId = ReadUInt32(in);
+		mYaw = ReadFloat(in);
+		mPitch = ReadFloat(in);
+	}
+
 	virtual BaseEventDataPtr Copy() const
 	{
 		return BaseEventDataPtr(new EventDataRotateActor(mId, mYaw, mPitch));
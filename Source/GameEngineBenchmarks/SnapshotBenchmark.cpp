@@ -0,0 +1,186 @@
+//========================================================================
+// SnapshotBenchmark.cpp : measures the snapshot replication
+//
+// Part of the GameEngine Application
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//========================================================================
+
+#include "Core/Logger/LogReporter.h"
+#include "Core/Event/Event.h"
+#include "Core/Utility/Serialize.h"
+
+#include "Network/Network.h"
+#include "Network/Snapshot.h"
+
+#include "Mathematic/Algebra/Rotation.h"
+
+#include <chrono>
+#include <sstream>
+
+// the transform of a simulated actor, moving on a circle of its own and growing now and then
+static Transform LoopbackTransform(ActorId actorId, unsigned int tick)
+{
+	float angle = (float)tick * 0.05f + (float)actorId;
+	float radius = 10.f + (float)(actorId % 50);
+
+	Transform transform;
+	transform.SetRotation(AxisAngle<4, float>(Vector4<float>::Unit(2), angle));
+	transform.SetScale(Vector3<float>{ 1.f, 1.f, 1.f + (float)((tick / 32 + actorId) % 4) * 0.25f });
+	transform.SetTranslation(radius * cosf(angle), radius * sinf(angle), (float)(actorId % 8));
+	return transform;
+}
+
+// Replicates a simulated world through a writer and a reader connected back to back, and compares the
+// bytes and the time per tick of the snapshots with forwarding a sync event per moved actor. Returns 
+// false if the client does not end up with the server state.
+static bool SnapshotLoopback(unsigned int actorCount, unsigned int movingCount, unsigned int ticks)
+{
+	const unsigned int budget = 1200;
+
+	std::shared_ptr<SnapshotWorld> world(new SnapshotWorld(false));
+	SnapshotWriter writer(world);
+	SnapshotReader reader(false);
+
+	std::vector<ActorId> alive;
+	ActorId nextId = 1;
+	for (; nextId <= actorCount; ++nextId)
+	{
+		alive.push_back(nextId);
+		world->SetActor(nextId, LoopbackTransform(nextId, 0), Vector3<float>::Zero());
+	}
+
+	unsigned long long eventBytes = 0, snapshotBytes = 0;
+	long long eventTime = 0, snapshotTime = 0;
+	unsigned int pending = 0;
+	for (unsigned int tick = 1; tick <= ticks + SNAPSHOT_MAX_PENDING * 4; ++tick)
+	{
+		bool simulating = tick <= ticks;
+		if (simulating)
+		{
+			// replace an actor now and then so destroy records are exercised
+			if (tick % 16 == 0 && !alive.empty())
+			{
+				world->RemoveActor(alive.back());
+				alive.pop_back();
+				alive.insert(alive.begin(), nextId);
+				world->SetActor(nextId, LoopbackTransform(nextId, tick), Vector3<float>::Zero());
+				nextId++;
+			}
+
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			for (unsigned int actor = 0; actor < movingCount && actor < alive.size(); ++actor)
+			{
+				// what forwarding the sync event of the actor would send
+				std::ostringstream out(std::ios_base::binary);
+				WriteUInt8(out, RemoteEventSocket::NMS_EVENT);
+				WriteUInt32(out, EventDataSyncActor::skEventType);
+				EventDataSyncActor(alive[actor], LoopbackTransform(alive[actor], tick)).SerializeBinary(out);
+				eventBytes += sizeof(u_long) + out.str().size();
+			}
+			std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+			eventTime += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+			start = std::chrono::steady_clock::now();
+			for (unsigned int actor = 0; actor < movingCount && actor < alive.size(); ++actor)
+			{
+				Transform previous = LoopbackTransform(alive[actor], tick - 1);
+				Transform current = LoopbackTransform(alive[actor], tick);
+				world->SetActor(alive[actor], current, 
+					(current.GetTranslation() - previous.GetTranslation()) * 35.f);
+			}
+			end = std::chrono::steady_clock::now();
+			snapshotTime += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		}
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		std::ostringstream out(std::ios_base::binary);
+		WriteUInt8(out, RemoteEventSocket::NMS_SNAPSHOT);
+		bool written = writer.Write(out, alive.empty() ? INVALID_ACTOR_ID : alive.front(), budget);
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+		if (simulating)
+			snapshotTime += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+		if (!written)
+		{
+			if (!simulating)
+				break;
+			continue;
+		}
+		if (simulating)
+			snapshotBytes += sizeof(u_long) + out.str().size();
+
+		// the client acknowledges each snapshot one tick after it was sent
+		std::istringstream in(out.str(), std::ios_base::binary);
+		ReadUInt8(in);
+		unsigned int sequence = reader.Read(in);
+		if (!sequence)
+		{
+			LogError("Snapshot loopback: the client could not apply a snapshot");
+			return false;
+		}
+		if (pending)
+			writer.Acknowledge(pending);
+		pending = sequence;
+	}
+	writer.Acknowledge(pending);
+
+	// once the actors stop, the client must hold the quantized state of the server
+	const std::map<ActorId, ActorSnapshot>& actors = world->GetActors();
+	const Snapshot* latest = reader.GetLatest();
+	bool converged = latest && latest->mActors.size() == actors.size();
+	if (converged)
+	{
+		std::vector<ActorSnapshot>::const_iterator itActor = latest->mActors.begin();
+		for (std::map<ActorId, ActorSnapshot>::const_iterator it = actors.begin(); it != actors.end(); ++it, ++itActor)
+			if (itActor->mId != it->first || *itActor != it->second)
+				converged = false;
+	}
+
+	float seconds = (float)ticks / 35.f;
+	LogInformation("Snapshot loopback, " + std::to_string(actorCount) + " actors, " + 
+		std::to_string(movingCount) + " moving, " + std::to_string(ticks) + " ticks at 35 Hz: events " +
+		std::to_string((unsigned long long)(eventBytes / seconds)) + " bytes/s " +
+		std::to_string(eventTime / (long long)ticks) + " ns/tick, snapshots " +
+		std::to_string((unsigned long long)(snapshotBytes / seconds)) + " bytes/s " +
+		std::to_string(snapshotTime / (long long)ticks) + " ns/tick, " +
+		(converged ? "converged" : "diverged"));
+	return converged;
+}
+
+//========================================================================
+// main - runs the snapshot loopback with the given actor count, moving actor count
+// and ticks, by default 1000 actors of which 200 move during 10 seconds at 35 Hz.
+// Returns 0 when the client converged to the server state.
+//========================================================================
+
+int main(int numArguments, char* arguments[])
+{
+	LogReporter reporter(
+		"",
+		Logger::Listener::LISTEN_FOR_NOTHING,
+		Logger::Listener::LISTEN_FOR_ALL);
+
+	unsigned int actorCount = numArguments > 1 ? (unsigned int)atoi(arguments[1]) : 1000;
+	unsigned int movingCount = numArguments > 2 ? (unsigned int)atoi(arguments[2]) : 200;
+	unsigned int ticks = numArguments > 3 ? (unsigned int)atoi(arguments[3]) : 350;
+	if (!ticks)
+	{
+		LogError("Snapshot loopback needs at least one tick");
+		return 1;
+	}
+
+	return SnapshotLoopback(actorCount, movingCount, ticks) ? 0 : 1;
+}
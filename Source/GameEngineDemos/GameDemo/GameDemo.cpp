@@ -571,9 +571,11 @@ void GameDemoLogic::CreateNetworkEventForwarder(const int socketId)
 	pGlobalEventManager->AddListener(
 		MakeDelegate(pNetworkEventForwarder, &NetworkEventForwarder::ForwardEvent), 
 		EventDataNewActor::skEventType);
-	pGlobalEventManager->AddListener(
-		MakeDelegate(pNetworkEventForwarder, &NetworkEventForwarder::ForwardEvent),
-		EventDataSyncActor::skEventType);
+	// actor transforms are replicated through the network view snapshots when enabled
+	if (!NetworkGameView::IsSnapshotReplicationEnabled())
+		pGlobalEventManager->AddListener(
+			MakeDelegate(pNetworkEventForwarder, &NetworkEventForwarder::ForwardEvent),
+			EventDataSyncActor::skEventType);
 	pGlobalEventManager->AddListener(
 		MakeDelegate(pNetworkEventForwarder, &NetworkEventForwarder::ForwardEvent),
 		EventDataJumpActor::skEventType);
@@ -682,6 +684,10 @@ bool GameDemoLogic::LoadGameAsync(tinyxml2::XMLElement* pRoot)
 	tinyxml2::XMLElement* pActorsNode = pRoot->FirstChildElement("StaticActors");
 	if (pActorsNode)
 	{
+		// the resources load on the loader threads while the actors are created
+		std::vector<ResHandleFuture> resourceRequests;
+		RequestActorResources(pActorsNode, resourceRequests);
+
 		tinyxml2::XMLElement* pNode = pActorsNode->FirstChildElement();
 		for (; pNode; pNode = pNode->NextSiblingElement())
 		{
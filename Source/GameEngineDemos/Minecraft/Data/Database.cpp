@@ -23,6 +23,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #include "../Games/Actors/PlayerLAO.h"
 
 #include "Core/Logger/Logger.h"
+#include "Core/Utility/Serialize.h"
 
 #include <fstream>
 
@@ -74,94 +75,479 @@ Vector3<short> MapDatabase::GetIntegerAsBlock(int64_t i)
 }
 
 
+/*
+    Map log layout: the log header followed by the block records. Every record starts with the
+    block position and the size of its data, a deleted block is a record without data
+*/
+static const uint32_t MAP_LOG_MAGIC = 0x4B4C424D; // "MBLK"
+static const uint32_t MAP_LOG_VERSION = 1;
+static const uint32_t MAP_LOG_HEADER_SIZE = 8;
+static const uint32_t MAP_RECORD_HEADER_SIZE = 12;
+static const uint32_t MAP_RECORD_DELETED = 0xFFFFFFFF;
+
+// buffered records are written as soon as they reach this size
+static const size_t MAP_LOG_FLUSH_SIZE = 4 * 1024 * 1024;
+
+// the log is compacted when it is bigger than this and most of it is outdated
+static const uint64_t MAP_LOG_COMPACTION_SIZE = 64 * 1024 * 1024;
+
+static void WriteRecordHeader(std::string& buffer, int64_t position, uint32_t size)
+{
+    uint8_t header[MAP_RECORD_HEADER_SIZE];
+    WriteInt64(header, position);
+    WriteUInt32(header + 8, size);
+    buffer.append((const char*)header, MAP_RECORD_HEADER_SIZE);
+}
+
+static std::string GetLogHeader()
+{
+    uint8_t header[MAP_LOG_HEADER_SIZE];
+    WriteUInt32(header, MAP_LOG_MAGIC);
+    WriteUInt32(header + 4, MAP_LOG_VERSION);
+    return std::string((const char*)header, MAP_LOG_HEADER_SIZE);
+}
+
+// moves the file over the destination, replacing it
+static bool ReplaceFile(const std::string& path, const std::string& destination)
+{
+#ifdef _WIN32
+    return MoveFileExA(path.c_str(), destination.c_str(),
+        MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(path.c_str(), destination.c_str()) == 0;
+#endif
+}
+
 MapDatabase::MapDatabase(const std::string& savedir, const std::string& dbname) :
     mSavedir(savedir), mDBname(dbname)
 {
 
 }
 
+MapDatabase::~MapDatabase()
+{
+    CloseLog();
+}
 
-bool MapDatabase::SaveBlock(const Vector3<short>& pos, const std::string& data)
+bool MapDatabase::OpenLog(const std::string& path)
 {
-    int64_t blockPos = GetBlockAsInteger(pos);
-    CerealTypes::Block block;
+    CloseLog();
+
+    mPath = path;
+    mLog.open(path, std::ios::in | std::ios::out | std::ios::binary);
+    if (!mLog.is_open())
+    {
+        // new map
+        std::ofstream os(path, std::ios::binary);
+        os << GetLogHeader();
+        os.close();
+        if (os.fail())
+        {
+            LogError("Failed to create map log " + path);
+            return false;
+        }
 
-    if (mLookupData.find(blockPos) != mLookupData.end())
+        mLog.open(path, std::ios::in | std::ios::out | std::ios::binary);
+        mLogSize = MAP_LOG_HEADER_SIZE;
+        return mLog.is_open();
+    }
+
+    mLog.seekg(0, std::ios::end);
+    uint64_t fileSize = mLog.tellg();
+    mLog.seekg(0);
+    if (fileSize == 0)
+    {
+        mLog << GetLogHeader();
+        mLogSize = MAP_LOG_HEADER_SIZE;
+        return mLog.good();
+    }
+
+    uint8_t header[MAP_RECORD_HEADER_SIZE];
+    if (fileSize < MAP_LOG_HEADER_SIZE ||
+        !mLog.read((char*)header, MAP_LOG_HEADER_SIZE) || ReadUInt32(header) != MAP_LOG_MAGIC)
+    {
+        // map saved as a single archive by older versions
+        mLog.close();
+        return ImportMap(path) && OpenLog(path);
+    }
+    if (ReadUInt32(header + 4) != MAP_LOG_VERSION)
+    {
+        LogError("Unsupported map log version in " + path);
+        mLog.close();
+        return false;
+    }
+
+    // only the record headers are read, the newest record of each block wins
+    uint64_t offset = MAP_LOG_HEADER_SIZE;
+    while (offset + MAP_RECORD_HEADER_SIZE <= fileSize)
     {
-        std::vector<CerealTypes::Block>::iterator itBlock;
-        for (itBlock = mData.blocks.begin(); itBlock != mData.blocks.end(); itBlock++)
+        mLog.seekg(offset);
+        if (!mLog.read((char*)header, MAP_RECORD_HEADER_SIZE))
+            break;
+
+        int64_t position = ReadInt64(header);
+        uint32_t size = ReadUInt32(header + 8);
+        uint64_t recordSize = MAP_RECORD_HEADER_SIZE + (size != MAP_RECORD_DELETED ? size : 0);
+        if (offset + recordSize > fileSize)
+            break;
+
+        BlockLocationMap::iterator itBlock = mBlocks.find(position);
+        if (itBlock != mBlocks.end())
         {
-            CerealTypes::Block& bl = (*itBlock);
-            if (bl.position == blockPos)
-                bl.blob = data;
+            mLiveSize -= MAP_RECORD_HEADER_SIZE + itBlock->second.size;
+            if (size == MAP_RECORD_DELETED)
+                mBlocks.erase(itBlock);
         }
+        if (size != MAP_RECORD_DELETED)
+        {
+            mBlocks[position] = { offset, size };
+            mLiveSize += recordSize;
+        }
+        offset += recordSize;
+    }
+    mLog.clear();
+    mLogSize = offset;
+
+    if (offset < fileSize)
+    {
+        // the last record was not completely written, the log is rewritten without it
+        LogWarning("Map log " + path + " is truncated, the last record is discarded");
+
+        BlockLocationMap locations;
+        if (!WriteLog(mLog, path + ".compact", mBlocks, locations, mLogSize))
+            return false;
+
+        mLog.close();
+        if (!ReplaceFile(path + ".compact", path))
+        {
+            LogError("Failed to replace map log " + path);
+            return false;
+        }
+        mBlocks = std::move(locations);
+        mLog.open(path, std::ios::in | std::ios::out | std::ios::binary);
+    }
+    return mLog.is_open();
+}
 
-        mLookupData[blockPos] = data;
+void MapDatabase::CloseLog()
+{
+    if (mCompaction.joinable())
+        FinishCompaction();
+
+    if (mLog.is_open())
+    {
+        Flush();
+        mLog.close();
+    }
+    mBlocks.clear();
+    mLogSize = 0;
+    mLiveSize = 0;
+}
+
+bool MapDatabase::ImportMap(const std::string& path)
+{
+    CerealTypes::Map map;
+    {
+        std::ifstream is(path, std::ios::binary);
+        if (is.fail())
+        {
+            LogError(strerror(errno));
+            return false;
+        }
+
+        try
+        {
+            cereal::BinaryInputArchive archive(is);
+            archive(map);
+        }
+        catch (const std::exception& e)
+        {
+            LogError("Failed to import map " + path + ": " + e.what());
+            return false;
+        }
+    }
+
+    std::string log = GetLogHeader();
+    for (const CerealTypes::Block& block : map.blocks)
+    {
+        WriteRecordHeader(log, block.position, (uint32_t)block.blob.size());
+        log.append(block.blob);
+    }
+
+    std::ofstream os(path + ".compact", std::ios::binary);
+    os << log;
+    os.close();
+    if (os.fail() || !ReplaceFile(path + ".compact", path))
+    {
+        LogError("Failed to write map log " + path);
+        return false;
+    }
+
+    LogInformation("Imported " + std::to_string(map.blocks.size()) + " blocks into map log " + path);
+    return true;
+}
+
+void MapDatabase::AppendRecord(int64_t position, const std::string* data)
+{
+    if (data)
+    {
+        WriteRecordHeader(mWriteBuffer, position, (uint32_t)data->size());
+        mWriteBuffer.append(*data);
+    }
+    else WriteRecordHeader(mWriteBuffer, position, MAP_RECORD_DELETED);
+
+    if (mWriteBuffer.size() >= MAP_LOG_FLUSH_SIZE)
+        Flush();
+}
+
+bool MapDatabase::ReadRecord(int64_t position, const BlockLocation& location, std::string* data)
+{
+    if (location.offset >= mLogSize)
+    {
+        // not written to the file yet
+        *data = mWriteBuffer.substr(
+            (size_t)(location.offset - mLogSize) + MAP_RECORD_HEADER_SIZE, location.size);
         return true;
     }
 
-    block.position = blockPos;
-    block.blob = data;
-    mData.blocks.push_back(block);
-    mLookupData[blockPos] = data;
+    uint8_t header[MAP_RECORD_HEADER_SIZE];
+    data->resize(location.size);
+    mLog.seekg(location.offset);
+    if (!mLog.read((char*)header, MAP_RECORD_HEADER_SIZE) ||
+        !mLog.read(&(*data)[0], location.size) || ReadInt64(header) != position)
+    {
+        mLog.clear();
+        data->clear();
+        return false;
+    }
     return true;
 }
 
-void MapDatabase::LoadBlock(const Vector3<short>& pos, std::string* block)
+void MapDatabase::Flush()
 {
-    int64_t blockPos = GetBlockAsInteger(pos);
+    if (mWriteBuffer.empty() || !mLog.is_open())
+        return;
 
-    *block = "";
-    std::map<int64_t, std::string>::iterator itData = mLookupData.find(blockPos);
-    if (itData != mLookupData.end())
-        *block = (*itData).second;
+    mLog.seekp(mLogSize);
+    mLog.write(mWriteBuffer.data(), mWriteBuffer.size());
+    mLog.flush();
+    if (mLog.fail())
+    {
+        LogError("Failed to write map log " + mPath);
+        mLog.clear();
+        return;
+    }
+
+    mLogSize += mWriteBuffer.size();
+    mWriteBuffer.clear();
 }
 
-void MapDatabase::SaveMap(const std::string& path)
+void MapDatabase::EndSave()
 {
-    std::ofstream os(path, std::ios::binary);
-    cereal::BinaryOutputArchive archive(os);
-    archive(mData);
+    Flush();
+
+    if (mCompaction.joinable())
+    {
+        if (mCompactionDone.load(std::memory_order_acquire))
+            FinishCompaction();
+    }
+    else if (mLogSize >= MAP_LOG_COMPACTION_SIZE && mLogSize > 2 * mLiveSize)
+    {
+        StartCompaction();
+    }
 }
 
-void MapDatabase::LoadMap(const std::string& path)
+void MapDatabase::StartCompaction()
 {
-    std::ifstream is(path, std::ios::binary);
-    if (is.fail())
+    mCompactionStart = mLogSize;
+    mCompactionDone.store(false);
+    mCompaction = std::thread(&MapDatabase::CompactLog, this, mBlocks);
+}
+
+void MapDatabase::CompactLog(BlockLocationMap blocks)
+{
+    // the compaction reads the part of the log written before it started, which doesn't change
+    std::ifstream is(mPath, std::ios::binary);
+    mCompactionSucceeded = is.good() &&
+        WriteLog(is, mPath + ".compact", blocks, mCompactedBlocks, mCompactedSize);
+    mCompactionDone.store(true, std::memory_order_release);
+}
+
+void MapDatabase::FinishCompaction()
+{
+    mCompaction.join();
+
+    std::string compactPath = mPath + ".compact";
+    if (!mCompactionSucceeded)
     {
-        LogError(strerror(errno));
+        LogWarning("Failed to compact map log " + mPath);
+        remove(compactPath.c_str());
+        mCompactedBlocks.clear();
         return;
     }
-    cereal::BinaryInputArchive archive(is);
-    archive(mData);
 
-    for (CerealTypes::Block block : mData.blocks)
-        mLookupData[block.position] = block.blob;
+    // the records written while the log was compacted are copied as they are
+    Flush();
+    uint64_t tailSize = mLogSize - mCompactionStart;
+    {
+        std::ofstream os(compactPath, std::ios::binary | std::ios::app);
+        std::vector<char> buffer(MAP_LOG_FLUSH_SIZE);
+        mLog.seekg(mCompactionStart);
+        for (uint64_t copied = 0; copied < tailSize; )
+        {
+            size_t size = (size_t)std::min<uint64_t>(buffer.size(), tailSize - copied);
+            mLog.read(buffer.data(), size);
+            os.write(buffer.data(), size);
+            copied += size;
+        }
+        os.close();
+
+        if (mLog.fail() || os.fail())
+        {
+            LogWarning("Failed to compact map log " + mPath);
+            mLog.clear();
+            remove(compactPath.c_str());
+            mCompactedBlocks.clear();
+            return;
+        }
+    }
+
+    mLog.close();
+    bool replaced = ReplaceFile(compactPath, mPath);
+    mLog.open(mPath, std::ios::in | std::ios::out | std::ios::binary);
+    if (!replaced)
+    {
+        LogWarning("Failed to replace map log " + mPath);
+        remove(compactPath.c_str());
+        mCompactedBlocks.clear();
+        return;
+    }
+
+    // blocks which were not saved again since the compaction started are in the compacted part
+    for (auto& block : mBlocks)
+    {
+        if (block.second.offset >= mCompactionStart)
+            block.second.offset = block.second.offset - mCompactionStart + mCompactedSize;
+        else
+            block.second.offset = mCompactedBlocks[block.first].offset;
+    }
+
+    LogInformation("Compacted map log " + mPath + " from " + std::to_string(mLogSize) +
+        " to " + std::to_string(mCompactedSize + tailSize) + " bytes");
+    mLogSize = mCompactedSize + tailSize;
+    mCompactedBlocks.clear();
 }
 
-bool MapDatabase::DeleteBlock(const Vector3<short>& pos)
+bool MapDatabase::WriteLog(std::istream& is, const std::string& path,
+    const BlockLocationMap& blocks, BlockLocationMap& locations, uint64_t& size)
 {
-    int64_t blockPos = GetBlockAsInteger(pos);
+    // the records are read in file order, so that the log is read sequentially
+    std::vector<std::pair<int64_t, BlockLocation>> records(blocks.begin(), blocks.end());
+    std::sort(records.begin(), records.end(),
+        [](const std::pair<int64_t, BlockLocation>& record, const std::pair<int64_t, BlockLocation>& other)
+        { return record.second.offset < other.second.offset; });
+
+    std::ofstream os(path, std::ios::binary);
+    std::string buffer = GetLogHeader();
+    uint64_t offset = 0;
 
-    std::vector<CerealTypes::Block>::iterator itBlock;
-    for (itBlock = mData.blocks.begin(); itBlock != mData.blocks.end(); itBlock++)
+    locations.clear();
+    locations.reserve(records.size());
+    for (const auto& record : records)
     {
-        CerealTypes::Block& bl = (*itBlock);
-        if (bl.position == blockPos)
+        uint64_t recordSize = MAP_RECORD_HEADER_SIZE + record.second.size;
+        size_t start = buffer.size();
+        buffer.resize(start + (size_t)recordSize);
+        is.seekg(record.second.offset);
+        if (!is.read(&buffer[start], recordSize))
         {
-            mData.blocks.erase(itBlock);
-            mLookupData.erase(blockPos);
-            return true;
+            is.clear();
+            return false;
+        }
+        locations[record.first] = { offset + start, record.second.size };
+
+        if (buffer.size() >= MAP_LOG_FLUSH_SIZE)
+        {
+            os.write(buffer.data(), buffer.size());
+            offset += buffer.size();
+            buffer.clear();
         }
     }
+    os.write(buffer.data(), buffer.size());
+    offset += buffer.size();
+    os.close();
 
-    return false;
+    size = offset;
+    return !os.fail();
+}
+
+bool MapDatabase::SaveBlock(const Vector3<short>& pos, const std::string& data)
+{
+    int64_t blockPos = GetBlockAsInteger(pos);
+
+    BlockLocationMap::iterator itBlock = mBlocks.find(blockPos);
+    if (itBlock != mBlocks.end())
+        mLiveSize -= MAP_RECORD_HEADER_SIZE + itBlock->second.size;
+
+    mBlocks[blockPos] = { mLogSize + mWriteBuffer.size(), (uint32_t)data.size() };
+    mLiveSize += MAP_RECORD_HEADER_SIZE + data.size();
+
+    AppendRecord(blockPos, &data);
+    return true;
+}
+
+void MapDatabase::LoadBlock(const Vector3<short>& pos, std::string* block)
+{
+    int64_t blockPos = GetBlockAsInteger(pos);
+
+    *block = "";
+    BlockLocationMap::iterator itBlock = mBlocks.find(blockPos);
+    if (itBlock != mBlocks.end())
+    {
+        if (!ReadRecord(blockPos, itBlock->second, block))
+            LogWarning("Failed to read block " + std::to_string(blockPos) + " from map log " + mPath);
+    }
+}
+
+void MapDatabase::SaveMap(const std::string& path)
+{
+    Flush();
+    if (path == mPath || !mLog.is_open())
+        return;
+
+    // writes a compacted copy of the log
+    BlockLocationMap locations;
+    uint64_t size;
+    if (!WriteLog(mLog, path, mBlocks, locations, size))
+        LogError("Failed to save map to " + path);
+}
+
+void MapDatabase::LoadMap(const std::string& path)
+{
+    if (!OpenLog(path))
+        LogError("Failed to load map from " + path);
+}
+
+bool MapDatabase::DeleteBlock(const Vector3<short>& pos)
+{
+    int64_t blockPos = GetBlockAsInteger(pos);
+
+    BlockLocationMap::iterator itBlock = mBlocks.find(blockPos);
+    if (itBlock == mBlocks.end())
+        return false;
+
+    mLiveSize -= MAP_RECORD_HEADER_SIZE + itBlock->second.size;
+    mBlocks.erase(itBlock);
+
+    AppendRecord(blockPos, nullptr);
+    return true;
 }
 
 void MapDatabase::ListAllLoadableBlocks(std::vector<Vector3<short>>& dst)
 {
-    for (CerealTypes::Block block : mData.blocks)
-        dst.push_back(GetIntegerAsBlock(block.position));
+    dst.reserve(dst.size() + mBlocks.size());
+    for (const auto& block : mBlocks)
+        dst.push_back(GetIntegerAsBlock(block.first));
 }
 
 void PlayerDatabase::SavePlayer(PlayerLAO* playerLAO)
@@ -25,6 +25,10 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #include "Mathematic/Algebra/Vector3.h"
 
+#include <atomic>
+#include <fstream>
+#include <thread>
+
 #include <cereal/types/vector.hpp>
 #include <cereal/types/memory.hpp>
 #include <cereal/archives/binary.hpp>
@@ -173,11 +177,20 @@ public:
 	virtual bool Initialized() const { return true; }
 };
 
+/*
+    The map blocks are stored in a log file. Every save or delete appends a record to the end of
+    the log and an index in memory keeps the location of the newest record of each block, so the
+    blocks are only read from the file when they are loaded. The records are buffered and written
+    to the file on EndSave. Once most of the log is made of outdated records, a compacted copy of
+    the live blocks is written by a background thread and replaces the log on a later EndSave.
+*/
 class MapDatabase : public Database
 {
 public:
     MapDatabase(const std::string& savedir, const std::string& dbname);
-	virtual ~MapDatabase() = default;
+	virtual ~MapDatabase();
+
+    virtual void EndSave();
 
 	virtual bool SaveBlock(const Vector3<short>& pos, const std::string& data);
 	virtual void LoadBlock(const Vector3<short>& pos, std::string* block);
@@ -192,12 +205,53 @@ public:
 
 private:
 
+    // location of the newest record of a block in the log
+    struct BlockLocation
+    {
+        uint64_t offset;
+        uint32_t size;
+    };
+
+    typedef std::unordered_map<int64_t, BlockLocation> BlockLocationMap;
+
+    bool OpenLog(const std::string& path);
+    void CloseLog();
+    bool ImportMap(const std::string& path);
+
+    void AppendRecord(int64_t position, const std::string* data);
+    bool ReadRecord(int64_t position, const BlockLocation& location, std::string* data);
+    void Flush();
+
+    void StartCompaction();
+    void FinishCompaction();
+    void CompactLog(BlockLocationMap blocks);
+
+    static bool WriteLog(std::istream& is, const std::string& path,
+        const BlockLocationMap& blocks, BlockLocationMap& locations, uint64_t& size);
+
     std::string mSavedir = "";
     std::string mDBname = "";
 
-    //set data
-    CerealTypes::Map mData;
-    std::map<int64_t, std::string> mLookupData;
+    std::string mPath;
+    std::fstream mLog;
+
+    // size of the log file, the buffered records are written from there on
+    uint64_t mLogSize = 0;
+    std::string mWriteBuffer;
+
+    // size of the records which are still referenced by the index
+    uint64_t mLiveSize = 0;
+
+    BlockLocationMap mBlocks;
+
+    // log size when the compaction started, the records written after it
+    // are appended to the compacted log once it is finished
+    std::thread mCompaction;
+    std::atomic<bool> mCompactionDone{ false };
+    bool mCompactionSucceeded = false;
+    uint64_t mCompactionStart = 0;
+    uint64_t mCompactedSize = 0;
+    BlockLocationMap mCompactedBlocks;
 };
 
 class PlayerDatabase
@@ -119,14 +119,21 @@ void LogicActiveObjectManager::Clear(const std::function<bool(LogicActiveObject*
 
     // Remove references from mActiveObjects
     for (uint16_t objId : objectsToRemove)
+    {
+        RemoveFromGrid(mActiveObjects[objId], objId);
         mActiveObjects.erase(objId);
+    }
 }
 
 void LogicActiveObjectManager::Step(float dTime, const std::function<void(LogicActiveObject *)>& f)
 {
     Profiling->Avg("ActiveObjectManager: LAO count [#]", (float)mActiveObjects.size());
     for (auto &ao_it : mActiveObjects)
+    {
         f(ao_it.second);
+        // objects may move themselves while stepping
+        UpdateObjectPosition(ao_it.second);
+    }
 }
 
 // clang-format off
@@ -170,6 +177,7 @@ bool LogicActiveObjectManager::RegisterObject(LogicActiveObject* obj)
     }
 
     mActiveObjects[obj->GetId()] = obj;
+    AddToGrid(obj);
 
     LogInformation(
         "ActiveObjectManager::AddActiveObjectRaw(): Added id=" + 
@@ -189,40 +197,103 @@ void LogicActiveObjectManager::RemoveObject(uint16_t id)
 
     LogInformation(
         "ActiveObjectManager::RemoveObject(): id=" + std::to_string(id));
+    RemoveFromGrid(obj, id);
     mActiveObjects.erase(id);
     delete obj;
 }
 
 // clang-format on
-void LogicActiveObjectManager::GetObjectsInsideRadius(const Vector3<float>& pos, float radius,
-    std::vector<LogicActiveObject *>& result, std::function<bool(LogicActiveObject *obj)> includeObjCB)
+Vector3<int> LogicActiveObjectManager::GetCellPosition(const Vector3<float>& pos)
 {
-    float r2 = radius * radius;
-    for (auto& activeObject : mActiveObjects) 
-    {
-        LogicActiveObject* obj = activeObject.second;
-        const Vector3<float>& objectPos = obj->GetBasePosition();
-        if (LengthSq(objectPos - pos) > r2)
-            continue;
+    // clamp before converting so that unbounded query boxes stay in range
+    Vector3<int> cell;
+    for (int i = 0; i < 3; i++)
+        cell[i] = (int)std::min(std::max(std::floor(pos[i] / CellSize), -32768.f), 32767.f);
+    return cell;
+}
 
-        if (!includeObjCB || includeObjCB(obj))
-            result.push_back(obj);
+uint64_t LogicActiveObjectManager::GetCellKey(int x, int y, int z)
+{
+    return ((uint64_t)(uint16_t)x << 32) | ((uint64_t)(uint16_t)y << 16) | (uint64_t)(uint16_t)z;
+}
+
+void LogicActiveObjectManager::AddToGrid(LogicActiveObject* obj)
+{
+    AddToCell(obj, GetCellPosition(obj->GetBasePosition()));
+    if (obj->GetType() == ACTIVEOBJECT_TYPE_PLAYER)
+        mPlayerObjects.push_back(obj);
+}
+
+void LogicActiveObjectManager::AddToCell(LogicActiveObject* obj, const Vector3<int>& cell)
+{
+    if (mCells.empty())
+    {
+        mMinCell = cell;
+        mMaxCell = cell;
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        mMinCell[i] = std::min(mMinCell[i], cell[i]);
+        mMaxCell[i] = std::max(mMaxCell[i], cell[i]);
     }
+
+    uint64_t key = GetCellKey(cell[0], cell[1], cell[2]);
+    mCells[key].push_back(obj);
+    mObjectCells[obj->GetId()] = key;
 }
 
-void LogicActiveObjectManager::GetObjectsInArea(const BoundingBox<float>& box,
-    std::vector<LogicActiveObject *>& result, std::function<bool(LogicActiveObject *obj)> includeObjCB)
+void LogicActiveObjectManager::RemoveFromGrid(LogicActiveObject* obj, uint16_t id)
 {
-    for (auto& activeObject : mActiveObjects) 
+    // obj may already be deleted here, it is only compared by address
+    auto objectCell = mObjectCells.find(id);
+    if (objectCell == mObjectCells.end())
+        return;
+
+    RemoveFromCell(obj, objectCell->second);
+    mObjectCells.erase(objectCell);
+
+    auto player = std::find(mPlayerObjects.begin(), mPlayerObjects.end(), obj);
+    if (player != mPlayerObjects.end())
     {
-        LogicActiveObject *obj = activeObject.second;
-        const Vector3<float>& objectPos = obj->GetBasePosition();
-        if (!box.IsPointInside(objectPos))
-            continue;
+        *player = mPlayerObjects.back();
+        mPlayerObjects.pop_back();
+    }
+}
+
+void LogicActiveObjectManager::RemoveFromCell(LogicActiveObject* obj, uint64_t key)
+{
+    auto cell = mCells.find(key);
+    if (cell == mCells.end())
+        return;
 
-        if (!includeObjCB || includeObjCB(obj))
-            result.push_back(obj);
+    std::vector<LogicActiveObject*>& objects = cell->second;
+    auto it = std::find(objects.begin(), objects.end(), obj);
+    if (it != objects.end())
+    {
+        *it = objects.back();
+        objects.pop_back();
     }
+    if (objects.empty())
+        mCells.erase(cell);
+}
+
+void LogicActiveObjectManager::UpdateObjectPosition(LogicActiveObject* obj)
+{
+    auto objectCell = mObjectCells.find(obj->GetId());
+    if (objectCell == mObjectCells.end())
+        return;
+
+    Vector3<int> cell = GetCellPosition(obj->GetBasePosition());
+    uint64_t key = GetCellKey(cell[0], cell[1], cell[2]);
+    if (key == objectCell->second)
+        return;
+
+    // an unregistered object may carry the id of a registered one
+    if (GetActiveObject(obj->GetId()) != obj)
+        return;
+
+    RemoveFromCell(obj, objectCell->second);
+    AddToCell(obj, cell);
 }
 
 void LogicActiveObjectManager::GetAddedActiveObjectsAroundPosition(
@@ -230,40 +301,45 @@ void LogicActiveObjectManager::GetAddedActiveObjectsAroundPosition(
     std::set<uint16_t>& currentObjects, std::queue<uint16_t>& addedObjects)
 {
     /*
-        Go through the object list,
+        Go through the objects around the player,
         - discard removed/deactivated objects,
         - discard objects that are too far away,
         - discard objects that are found in current_objects.
         - add remaining objects to added_objects
     */
-    for (auto& aoIt : mActiveObjects) 
+    auto AddObject = [&](LogicActiveObject* object)
     {
-        uint16_t id = aoIt.first;
-
-        // Get object
-        LogicActiveObject* object = aoIt.second;
-        if (!object)
-            continue;
-
         if (object->IsGone())
-            continue;
-
-        float distance = Length(object->GetBasePosition() - playerPos);
-        if (object->GetType() == ACTIVEOBJECT_TYPE_PLAYER) 
-        {
-            // Discard if too far
-            if (distance > playerRadius && playerRadius != 0)
-                continue;
-        }
-        else if (distance > radius)
-            continue;
+            return;
 
         // Discard if already on current_objects
-        auto obj = currentObjects.find(id);
-        if (obj != currentObjects.end())
-            continue;
+        if (currentObjects.find(object->GetId()) != currentObjects.end())
+            return;
 
         // Add to added_objects
-        addedObjects.push(id);
-    }
+        addedObjects.push(object->GetId());
+    };
+
+    // Players without a radius limit are not searched in the grid
+    float searchRadius = playerRadius != 0 ? std::max(radius, playerRadius) : radius;
+    Vector3<float> extent{ searchRadius, searchRadius, searchRadius };
+    ForEachObjectNearArea(BoundingBox<float>(playerPos - extent, playerPos + extent),
+        [&](LogicActiveObject* object)
+        {
+            float distance = Length(object->GetBasePosition() - playerPos);
+            if (object->GetType() == ACTIVEOBJECT_TYPE_PLAYER)
+            {
+                // Discard if too far
+                if (playerRadius == 0 || distance > playerRadius)
+                    return;
+            }
+            else if (distance > radius)
+                return;
+
+            AddObject(object);
+        });
+
+    if (playerRadius == 0)
+        for (LogicActiveObject* player : mPlayerObjects)
+            AddObject(player);
 }
\ No newline at end of file
@@ -83,15 +83,209 @@ public:
     bool RegisterObject(LogicActiveObject *obj) override;
     void RemoveObject(uint16_t id) override;
 
+    // Moves a registered object to the grid cell of its current base position
+    void UpdateObjectPosition(LogicActiveObject* obj);
+
+    template <typename Predicate>
+    void GetObjectsInsideRadius(const Vector3<float>& pos, float radius,
+        std::vector<LogicActiveObject *>& result, Predicate includeObj);
     void GetObjectsInsideRadius(const Vector3<float>& pos, float radius,
-        std::vector<LogicActiveObject *>& result,
-        std::function<bool(LogicActiveObject *obj)> includeObjCB);
+        std::vector<LogicActiveObject *>& result)
+    {
+        GetObjectsInsideRadius(pos, radius, result, [](LogicActiveObject*) { return true; });
+    }
+
+    template <typename Predicate>
     void GetObjectsInArea(const BoundingBox<float>& box,
-        std::vector<LogicActiveObject *>& result,
-        std::function<bool(LogicActiveObject *obj)> include_obj_cb);
+        std::vector<LogicActiveObject *>& result, Predicate includeObj);
+    void GetObjectsInArea(const BoundingBox<float>& box, std::vector<LogicActiveObject *>& result)
+    {
+        GetObjectsInArea(box, result, [](LogicActiveObject*) { return true; });
+    }
+
+    // Finds up to count objects nearest to pos, sorted by increasing distance
+    template <typename Predicate>
+    void GetNearestObjects(const Vector3<float>& pos, unsigned int count,
+        std::vector<LogicActiveObject *>& result, Predicate includeObj);
 
     void GetAddedActiveObjectsAroundPosition(const Vector3<float>& playerPos, float radius,
         float playerRadius, std::set<uint16_t>& currentObjects, std::queue<uint16_t>& addedObjects);
+
+private:
+    // Objects are bucketed into a loose grid of mapblock sized cells. An object
+    // only belongs to the cell holding its base position, so queries visit the
+    // cells overlapping the query volume instead of every active object.
+    static constexpr float CellSize = MAP_BLOCKSIZE * BS;
+
+    static Vector3<int> GetCellPosition(const Vector3<float>& pos);
+    static uint64_t GetCellKey(int x, int y, int z);
+
+    void AddToGrid(LogicActiveObject* obj);
+    void AddToCell(LogicActiveObject* obj, const Vector3<int>& cell);
+    void RemoveFromGrid(LogicActiveObject* obj, uint16_t id);
+    void RemoveFromCell(LogicActiveObject* obj, uint64_t key);
+
+    // Calls func for every object in the cells overlapping box, which may
+    // include objects outside of it. func does the exact test.
+    template <typename Function>
+    void ForEachObjectNearArea(const BoundingBox<float>& box, Function func);
+
+    std::unordered_map<uint64_t, std::vector<LogicActiveObject*>> mCells;
+    std::unordered_map<uint16_t, uint64_t> mObjectCells;
+    // Cell range that has been occupied since the grid was last empty
+    Vector3<int> mMinCell = Vector3<int>::Zero();
+    Vector3<int> mMaxCell = Vector3<int>::Zero();
+    // Players may be sent to the visuals from any distance
+    std::vector<LogicActiveObject*> mPlayerObjects;
 };
 
+template <typename Function>
+void LogicActiveObjectManager::ForEachObjectNearArea(const BoundingBox<float>& box, Function func)
+{
+    if (mCells.empty())
+        return;
+
+    Vector3<int> minCell = GetCellPosition(box.mMinEdge);
+    Vector3<int> maxCell = GetCellPosition(box.mMaxEdge);
+    int64_t volume = 1;
+    for (int i = 0; i < 3; i++)
+    {
+        minCell[i] = std::max(minCell[i], mMinCell[i]);
+        maxCell[i] = std::min(maxCell[i], mMaxCell[i]);
+        if (minCell[i] > maxCell[i])
+            return;
+        volume *= maxCell[i] - minCell[i] + 1;
+    }
+    if (volume > (int64_t)mCells.size())
+    {
+        // the box covers more cells than are occupied, scan all objects
+        for (auto& activeObject : mActiveObjects)
+            func(activeObject.second);
+        return;
+    }
+
+    for (int z = minCell[2]; z <= maxCell[2]; z++)
+    {
+        for (int y = minCell[1]; y <= maxCell[1]; y++)
+        {
+            for (int x = minCell[0]; x <= maxCell[0]; x++)
+            {
+                auto cell = mCells.find(GetCellKey(x, y, z));
+                if (cell == mCells.end())
+                    continue;
+
+                for (LogicActiveObject* obj : cell->second)
+                    func(obj);
+            }
+        }
+    }
+}
+
+template <typename Predicate>
+void LogicActiveObjectManager::GetObjectsInsideRadius(const Vector3<float>& pos, float radius,
+    std::vector<LogicActiveObject *>& result, Predicate includeObj)
+{
+    float r2 = radius * radius;
+    Vector3<float> extent{ radius, radius, radius };
+    ForEachObjectNearArea(BoundingBox<float>(pos - extent, pos + extent),
+        [&](LogicActiveObject* obj)
+        {
+            if (LengthSq(obj->GetBasePosition() - pos) <= r2 && includeObj(obj))
+                result.push_back(obj);
+        });
+}
+
+template <typename Predicate>
+void LogicActiveObjectManager::GetObjectsInArea(const BoundingBox<float>& box,
+    std::vector<LogicActiveObject *>& result, Predicate includeObj)
+{
+    ForEachObjectNearArea(box, [&](LogicActiveObject* obj)
+        {
+            if (box.IsPointInside(obj->GetBasePosition()) && includeObj(obj))
+                result.push_back(obj);
+        });
+}
+
+template <typename Predicate>
+void LogicActiveObjectManager::GetNearestObjects(const Vector3<float>& pos, unsigned int count,
+    std::vector<LogicActiveObject *>& result, Predicate includeObj)
+{
+    if (count == 0 || mActiveObjects.empty())
+        return;
+
+    std::vector<std::pair<float, LogicActiveObject*>> candidates;
+    auto AddCandidates = [&](const std::vector<LogicActiveObject*>& objects)
+    {
+        for (LogicActiveObject* obj : objects)
+            if (includeObj(obj))
+                candidates.emplace_back(LengthSq(obj->GetBasePosition() - pos), obj);
+    };
+    auto IsNearer = [](const std::pair<float, LogicActiveObject*>& a,
+        const std::pair<float, LogicActiveObject*>& b) { return a.first < b.first; };
+
+    // Visit the cells in growing shells around the cell of pos. Objects in
+    // the cells beyond a shell are at least as far as the nearest face of the
+    // visited cube, so the search is done once count candidates are closer.
+    Vector3<int> center = GetCellPosition(pos);
+    for (int r = 0; ; r++)
+    {
+        Vector3<int> minCell, maxCell;
+        int64_t volume = 1;
+        bool coversGrid = true;
+        float reach = std::numeric_limits<float>::max();
+        for (int i = 0; i < 3; i++)
+        {
+            minCell[i] = std::max(center[i] - r, mMinCell[i]);
+            maxCell[i] = std::min(center[i] + r, mMaxCell[i]);
+            volume *= std::max(maxCell[i] - minCell[i] + 1, 0);
+            coversGrid = coversGrid && center[i] - r <= mMinCell[i] && center[i] + r >= mMaxCell[i];
+            reach = std::min(reach, std::min(pos[i] - (center[i] - r) * CellSize,
+                (center[i] + r + 1) * CellSize - pos[i]));
+        }
+        if (volume > (int64_t)mCells.size())
+        {
+            // the shells cover more cells than are occupied, scan all objects
+            candidates.clear();
+            for (auto& activeObject : mActiveObjects)
+                if (includeObj(activeObject.second))
+                    candidates.emplace_back(LengthSq(activeObject.second->GetBasePosition() - pos), activeObject.second);
+            break;
+        }
+
+        for (int z = minCell[2]; z <= maxCell[2]; z++)
+        {
+            for (int y = minCell[1]; y <= maxCell[1]; y++)
+            {
+                bool face = std::abs(z - center[2]) == r || std::abs(y - center[1]) == r;
+                // the inside of the shell was visited by the previous rings
+                int step = face ? 1 : 2 * r;
+                for (int x = face ? minCell[0] : center[0] - r; x <= maxCell[0]; x += step)
+                {
+                    if (x < minCell[0])
+                        continue;
+
+                    auto cell = mCells.find(GetCellKey(x, y, z));
+                    if (cell != mCells.end())
+                        AddCandidates(cell->second);
+                }
+            }
+        }
+
+        if (coversGrid)
+            break;
+
+        if (candidates.size() >= count)
+        {
+            std::nth_element(candidates.begin(), candidates.begin() + (count - 1), candidates.end(), IsNearer);
+            if (candidates[count - 1].first <= reach * reach)
+                break;
+        }
+    }
+
+    size_t nearest = std::min((size_t)count, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + nearest, candidates.end(), IsNearer);
+    for (size_t i = 0; i < nearest; i++)
+        result.push_back(candidates[i].second);
+}
+
 #endif
\ No newline at end of file
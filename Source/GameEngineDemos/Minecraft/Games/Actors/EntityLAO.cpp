@@ -390,7 +390,7 @@ void EntityLAO::SetPosition(const Vector3<float> &pos)
 {
 	if(IsAttached())
 		return;
-	mBasePosition = pos;
+	SetBasePosition(pos);
 	SendPosition(false, true);
 }
 
@@ -398,7 +398,7 @@ void EntityLAO::MoveTo(Vector3<float> pos, bool continuous)
 {
 	if(IsAttached())
 		return;
-	mBasePosition = pos;
+	SetBasePosition(pos);
 	if(!continuous)
 		SendPosition(true, true);
 }
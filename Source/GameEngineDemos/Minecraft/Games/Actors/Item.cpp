@@ -360,7 +360,7 @@ public:
 			return CreateInventoryCachedDirect(name, env);
 
 		// We're gonna ask the result to be put into here
-		static ResultQueue<std::string, InventoryCached*, char, char> resultQueue;
+		static thread_local ResultQueue<std::string, InventoryCached*, char, char> resultQueue;
 
 		// Throw a request in
 		mGetInventoryCachedQueue.Add(name, 0, 0, &resultQueue);
@@ -21,6 +21,8 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #include "Inventory.h"
 
+#include "../Environment/LogicEnvironment.h"
+
 #include "Core/Utility/Serialize.h"
 
 LogicActiveObject::LogicActiveObject(LogicEnvironment* env, Vector3<float> pos) :
@@ -28,6 +30,14 @@ LogicActiveObject::LogicActiveObject(LogicEnvironment* env, Vector3<float> pos)
 {
 }
 
+void LogicActiveObject::SetBasePosition(Vector3<float> pos)
+{
+	mBasePosition = pos;
+	// keep the spatial lookup of the environment in sync
+	if (mEnvironment)
+		mEnvironment->UpdateActiveObjectPosition(this);
+}
+
 float LogicActiveObject::GetMinimumSavedMovement()
 {
 	return 2.0*BS;
@@ -76,7 +76,7 @@ public:
 		Some simple getters/setters
 	*/
 	Vector3<float> GetBasePosition() const { return mBasePosition; }
-	void SetBasePosition(Vector3<float> pos){ mBasePosition = pos; }
+	void SetBasePosition(Vector3<float> pos);
 	LogicEnvironment* GetEnvironment(){ return mEnvironment; }
 
 	/*
@@ -42,10 +42,12 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #include "Core/IO/FileSystem.h"
 #include "Core/Utility/Profiler.h"
+#include "Core/Threading/TaskScheduler.h"
 
 #include "../../MinecraftEvents.h"
 
 #include <random>
+#include <chrono>
 
 #define LBM_NAME_ALLOWED_CHARS "abcdefghijklmnopqrstuvwxyz0123456789_:"
 
@@ -127,7 +129,10 @@ void LBMContentMapping::AddLBM(LoadingBlockModifier* lbm, LogicEnvironment* env)
 		}
 
 		for (uint16_t contentId : contentIds)
+        {
 			map[contentId].push_back(lbm);
+			MapBlock::AddToContentsMask(contentsMask, contentId);
+        }
 	}
 }
 
@@ -280,6 +285,10 @@ void LBMManager::ApplyLBMs(LogicEnvironment* env, MapBlock* block, unsigned int
 	LBMLookupMap::const_iterator it = GetLBMsIntroducedAfter(stamp);
 	for (; it != mLBMLookup.end(); ++it) 
     {
+		// Skip the block if it has none of the trigger contents
+		if (!block->MayContain(it->second.contentsMask))
+			continue;
+
 		// Cache previous version to speedup lookup which has a very high performance
 		// penalty on each call
 		uint16_t previousContent{};
@@ -1637,10 +1646,31 @@ void LogicEnvironment::FadeSound(int handle, float step, float gain)
 
 struct ActiveABM
 {
-	ActiveBlockModifier* abm;
+	ABMWithState* abm;
 	int chance;
-	std::vector<uint16_t> requiredNeighbors;
 	bool checkRequiredNeighbors; // false if requiredNeighbors is known to be empty
+
+	// time spent in the triggers of the ABM and number of triggers during the interval
+	double time = 0.0;
+	unsigned int runs = 0;
+};
+
+struct ABMTrigger
+{
+	Vector3<short> position; // relative to the block
+	MapNode node;
+	unsigned int abm; // index of the active ABM
+};
+
+// Active block whose nodes are scanned for ABM triggers
+struct ABMBlock
+{
+	MapBlock* block;
+	// the block and its neighbors, indexed by (x + 1) + (y + 1) * 3 + (z + 1) * 9
+	MapBlock* neighbors[27];
+	std::vector<ABMTrigger> triggers;
+	bool cached;
+	bool scanned;
 };
 
 class ABMHandler
@@ -1652,7 +1682,6 @@ public:
 		if(dTime < 0.001)
 			return;
 
-		const NodeManager* nodeMgr = mEnvironment->GetNodeManager();
 		for (ABMWithState& abmws : abms) 
         {
 			ActiveBlockModifier* abm = abmws.activeBlockModifier;
@@ -1672,7 +1701,7 @@ public:
 			if(chance == 0)
 				chance = 1;
 			ActiveABM aabm;
-			aabm.abm = abm;
+			aabm.abm = &abmws;
 			if (abm->GetSimpleCatchUp()) 
             {
 				float intervals = actualInterval / triggerInterval;
@@ -1685,36 +1714,21 @@ public:
             else aabm.chance = chance;
 
 			// Trigger neighbors
-			const std::vector<std::string>& requiredNeighbors = abm->GetRequiredNeighbors();
-			for (const std::string& requiredNeighbor : requiredNeighbors)
-				nodeMgr->GetIds(requiredNeighbor, aabm.requiredNeighbors);
-
-			aabm.checkRequiredNeighbors = !requiredNeighbors.empty();
+			aabm.checkRequiredNeighbors = !abm->GetRequiredNeighbors().empty();
 
 			// Trigger contents
-			const std::vector<std::string> &contents = abm->GetTriggerContents();
-			for (const std::string& content : contents) 
+			unsigned int index = (unsigned int)mActiveABMs.size();
+			mActiveABMs.push_back(aabm);
+			for (uint16_t c : abmws.triggerContents) 
             {
-                std::vector<uint16_t> ids;
-				nodeMgr->GetIds(content, ids);
-				for (uint16_t c : ids) 
-                {
-					if (c >= mAABMs.size())
-						mAABMs.resize(c + 256, NULL);
-					if (!mAABMs[c])
-						mAABMs[c] = new std::vector<ActiveABM>;
-					mAABMs[c]->push_back(aabm);
-				}
+				if (c >= mAABMs.size())
+					mAABMs.resize(c + 256);
+				mAABMs[c].push_back(index);
+				MapBlock::AddToContentsMask(mContentsMask, c);
 			}
 		}
 	}
 
-	~ABMHandler()
-	{
-		for (auto& aabms : mAABMs)
-			delete aabms;
-	}
-
 	// Find out how many objects the given block and its neighbours contain.
 	// Returns the number of objects in the block, and also in 'wider' the
 	// number of objects in the block and all its neighbours. The latter
@@ -1749,41 +1763,50 @@ public:
 
 	}
 
-    void Apply(MapBlock* block, int& blocksScanned, int& abmsRun, int& blocksCached)
-    {
-        if (mAABMs.empty() || block->IsDummy())
-            return;
+	// Checks the contents bitmap of the block and collects its neighbors for the scan.
+	// Returns false if the block has no node to run the ABMs on
+	bool Prepare(ABMBlock& abmBlock)
+	{
+		MapBlock* block = abmBlock.block;
+		abmBlock.triggers.clear();
+		abmBlock.cached = false;
+		abmBlock.scanned = false;
+		if (mActiveABMs.empty() || block->IsDummy())
+			return false;
 
-        // Check the content type cache first
-        // to see whether there are any ABMs
-        // to be run at all for this block.
-        if (block->mContentsCached)
-        {
-            blocksCached++;
-            bool runABMs = false;
-            for (uint16_t content : block->mContents)
-            {
-                if (content < mAABMs.size() && mAABMs[content])
-                {
-                    runABMs = true;
-                    break;
-                }
-            }
-            if (!runABMs)
-                return;
-        }
-        else
-        {
-            // Clear any caching
-            block->mContents.clear();
-        }
-        blocksScanned++;
+		abmBlock.cached = block->mContentsCached;
 
-        std::shared_ptr<LogicMap> map = mEnvironment->GetLogicMap();
+		// Check the content type cache first
+		// to see whether there are any ABMs
+		// to be run at all for this block.
+		if (!block->MayContain(mContentsMask))
+			return false;
 
-        unsigned int activeObjectCountWider;
-        unsigned int activeObjectCount = this->CountObjects(block, map, activeObjectCountWider);
-        mEnvironment->mAddedObjects = 0;
+		std::shared_ptr<LogicMap> map = mEnvironment->GetLogicMap();
+		for (short z = -1; z <= 1; z++)
+		{
+			for (short y = -1; y <= 1; y++)
+			{
+				for (short x = -1; x <= 1; x++)
+				{
+					abmBlock.neighbors[(x + 1) + (y + 1) * 3 + (z + 1) * 9] = (x || y || z) ?
+						map->GetBlockNoCreateNoEx(block->GetPosition() + Vector3<short>{x, y, z}) : block;
+				}
+			}
+		}
+		abmBlock.scanned = true;
+		return true;
+	}
+
+	// Rolls the ABMs of every node of the block and collects the triggers. It only
+	// reads the nodes of the block and of its neighbors, so blocks can be scanned
+	// in parallel once they have been prepared
+	void Scan(ABMBlock& abmBlock)
+	{
+		MapBlock* block = abmBlock.block;
+		bool cacheContents = !block->mContentsCached;
+		if (cacheContents)
+			std::fill(std::begin(block->mContentsMask), std::end(block->mContentsMask), 0);
 
         Vector3<short> p0;
         PcgRandom pcgRand;
@@ -1796,88 +1819,139 @@ public:
                     const MapNode& node = block->GetNodeUnsafe(p0);
                     uint16_t c = node.GetContent();
                     // Cache content types as we go
-                    if (!block->mContentsCached && !block->mNoCachedContents) 
-                    {
-                        block->mContents.insert(c);
-                        if (block->mContents.size() > 64) 
-                        {
-                            // Too many different nodes... don't try to cache
-                            block->mNoCachedContents = true;
-                            block->mContents.clear();
-                        }
-                    }
+                    if (cacheContents)
+                        MapBlock::AddToContentsMask(block->mContentsMask, c);
 
-                    if (c >= mAABMs.size() || !mAABMs[c])
+                    if (c >= mAABMs.size() || mAABMs[c].empty())
                         continue;
 
-                    Vector3<short> p = p0 + block->GetRelativePosition();
-                    for (ActiveABM& aabm : *mAABMs[c])
+                    for (unsigned int index : mAABMs[c])
                     {
+                        const ActiveABM& aabm = mActiveABMs[index];
                         if (pcgRand.Next() % aabm.chance != 0)
                             continue;
 
                         // Check neighbors
-                        if (aabm.checkRequiredNeighbors) 
-                        {
-                            Vector3<short> p1;
-                            for (p1[0] = p0[0] - 1; p1[0] <= p0[0] + 1; p1[0]++)
-                            {
-                                for (p1[1] = p0[1] - 1; p1[1] <= p0[1] + 1; p1[1]++)
-                                {
-                                    for (p1[2] = p0[2] - 1; p1[2] <= p0[2] + 1; p1[2]++)
-                                    {
-                                        if (p1 == p0)
-                                            continue;
-                                        uint16_t content;
-                                        if (block->IsValidPosition(p1)) 
-                                        {
-                                            // if the neighbor is found on the same map block
-                                            // get it straight from there
-                                            const MapNode& node = block->GetNodeUnsafe(p1);
-                                            content = node.GetContent();
-                                        }
-                                        else 
-                                        {
-                                            // otherwise consult the map
-                                            MapNode node = map->GetNode(p1 + block->GetRelativePosition());
-                                            content = node.GetContent();
-                                        }
-                                        if (std::find(aabm.requiredNeighbors.begin(),
-                                            aabm.requiredNeighbors.end(), c) != aabm.requiredNeighbors.end())
-                                        {
-                                            goto neighborFound;
-                                        }
-                                    }
-                                }
-                            }
-                            // No required neighbor found
+                        if (aabm.checkRequiredNeighbors && 
+                            !HasRequiredNeighbor(abmBlock, p0, aabm.abm->requiredNeighbors))
                             continue;
-                        }
-
-						neighborFound:
 
-                        abmsRun++;
-                        // Call all the trigger variations
-                        aabm.abm->Trigger(mEnvironment, p, node);
-                        aabm.abm->Trigger(mEnvironment, p, node,
-                            activeObjectCount, activeObjectCountWider);
-
-                        // Count surrounding objects again if the abms added any
-                        if (mEnvironment->mAddedObjects > 0) 
-                        {
-                            activeObjectCount = CountObjects(block, map, activeObjectCountWider);
-                            mEnvironment->mAddedObjects = 0;
-                        }
+                        abmBlock.triggers.push_back({ p0, node, index });
                     }
                 }
             }
         }
-		block->mContentsCached = !block->mNoCachedContents;
-    }
+		block->mContentsCached = true;
+	}
+
+	// Runs the triggers collected by the scan of the block
+	void Apply(ABMBlock& abmBlock, int& blocksScanned, int& abmsRun, int& blocksCached)
+	{
+		if (abmBlock.cached)
+			blocksCached++;
+		if (!abmBlock.scanned)
+			return;
+		blocksScanned++;
+		if (abmBlock.triggers.empty())
+			return;
+
+		MapBlock* block = abmBlock.block;
+		std::shared_ptr<LogicMap> map = mEnvironment->GetLogicMap();
+
+		unsigned int activeObjectCountWider;
+		unsigned int activeObjectCount = this->CountObjects(block, map, activeObjectCountWider);
+		mEnvironment->mAddedObjects = 0;
+
+		for (const ABMTrigger& trigger : abmBlock.triggers)
+		{
+			// Skip the nodes which have been changed by a previous trigger
+			if (block->GetNodeUnsafe(trigger.position[0], trigger.position[1],
+				trigger.position[2]).GetContent() != trigger.node.GetContent())
+				continue;
+
+			ActiveABM& aabm = mActiveABMs[trigger.abm];
+			Vector3<short> p = trigger.position + block->GetRelativePosition();
+
+			abmsRun++;
+			auto start = std::chrono::steady_clock::now();
+
+			// Call all the trigger variations
+			aabm.abm->activeBlockModifier->Trigger(mEnvironment, p, trigger.node);
+			aabm.abm->activeBlockModifier->Trigger(mEnvironment, p, trigger.node,
+				activeObjectCount, activeObjectCountWider);
+
+			aabm.time += std::chrono::duration<double, std::milli>(
+				std::chrono::steady_clock::now() - start).count();
+			aabm.runs++;
+
+			// Count surrounding objects again if the abms added any
+			if (mEnvironment->mAddedObjects > 0) 
+			{
+				activeObjectCount = CountObjects(block, map, activeObjectCountWider);
+				mEnvironment->mAddedObjects = 0;
+			}
+		}
+	}
+
+	// Reports the time spent in the triggers of every ABM which ran this interval
+	void Report()
+	{
+		for (const ActiveABM& aabm : mActiveABMs)
+		{
+			Profiling->Avg("LogicEnv: " + aabm.abm->name + " time (ms)", (float)aabm.time);
+			Profiling->Avg("LogicEnv: " + aabm.abm->name + " runs", (float)aabm.runs);
+		}
+	}
 
 private:
+
+	bool HasRequiredNeighbor(const ABMBlock& abmBlock, Vector3<short> p0, 
+		const std::vector<uint16_t>& requiredNeighbors)
+	{
+		Vector3<short> p1;
+		for (p1[0] = p0[0] - 1; p1[0] <= p0[0] + 1; p1[0]++)
+		{
+			for (p1[1] = p0[1] - 1; p1[1] <= p0[1] + 1; p1[1]++)
+			{
+				for (p1[2] = p0[2] - 1; p1[2] <= p0[2] + 1; p1[2]++)
+				{
+					if (p1 == p0)
+						continue;
+
+					// find the block of the neighbor, the map returns ignore
+					// for the nodes of the blocks which are not loaded
+					int neighbor = 13;
+					Vector3<short> p2 = p1;
+					for (int i = 0, stride = 1; i < 3; i++, stride *= 3)
+					{
+						if (p2[i] < 0)
+						{
+							p2[i] += MAP_BLOCKSIZE;
+							neighbor -= stride;
+						}
+						else if (p2[i] >= MAP_BLOCKSIZE)
+						{
+							p2[i] -= MAP_BLOCKSIZE;
+							neighbor += stride;
+						}
+					}
+					MapBlock* block = abmBlock.neighbors[neighbor];
+					uint16_t content = (block && !block->IsDummy()) ?
+						block->GetNodeUnsafe(p2).GetContent() : CONTENT_IGNORE;
+					if (std::binary_search(requiredNeighbors.begin(), requiredNeighbors.end(), content))
+						return true;
+				}
+			}
+		}
+		// No required neighbor found
+		return false;
+	}
+
     LogicEnvironment* mEnvironment;
-    std::vector<std::vector<ActiveABM>*> mAABMs;
+	std::vector<ActiveABM> mActiveABMs;
+	// active ABMs indexed by trigger content
+	std::vector<std::vector<unsigned int>> mAABMs;
+	uint64_t mContentsMask[MapBlock::ContentsMaskBits / 64] = {};
 };
 
 void LogicEnvironment::ActivateBlock(MapBlock* block, unsigned int additionalDTime)
@@ -1937,6 +2011,42 @@ void LogicEnvironment::ActivateBlock(MapBlock* block, unsigned int additionalDTi
 void LogicEnvironment::AddActiveBlockModifier(ActiveBlockModifier *abm)
 {
 	mABMs.emplace_back(abm);
+	// resolve the contents of the new ABM at the next step
+	mABMsDefinitionsVersion = 0;
+}
+
+void LogicEnvironment::CompileABMs()
+{
+	unsigned int version = mNodeMgr->GetDefinitionsVersion();
+	if (version == mABMsDefinitionsVersion)
+		return;
+
+	for (unsigned int i = 0; i < mABMs.size(); i++)
+	{
+		ABMWithState& abmws = mABMs[i];
+		ActiveBlockModifier* abm = abmws.activeBlockModifier;
+
+		// Trigger neighbors
+		abmws.requiredNeighbors.clear();
+		for (const std::string& requiredNeighbor : abm->GetRequiredNeighbors())
+			mNodeMgr->GetIds(requiredNeighbor, abmws.requiredNeighbors);
+		std::sort(abmws.requiredNeighbors.begin(), abmws.requiredNeighbors.end());
+		abmws.requiredNeighbors.erase(std::unique(
+			abmws.requiredNeighbors.begin(), abmws.requiredNeighbors.end()), abmws.requiredNeighbors.end());
+
+		// Trigger contents
+		abmws.triggerContents.clear();
+		for (const std::string& content : abm->GetTriggerContents())
+			mNodeMgr->GetIds(content, abmws.triggerContents);
+		std::sort(abmws.triggerContents.begin(), abmws.triggerContents.end());
+		abmws.triggerContents.erase(std::unique(
+			abmws.triggerContents.begin(), abmws.triggerContents.end()), abmws.triggerContents.end());
+
+		abmws.name = "ABM " + std::to_string(i);
+		if (!abm->GetTriggerContents().empty())
+			abmws.name += " (" + abm->GetTriggerContents().front() + ")";
+	}
+	mABMsDefinitionsVersion = version;
 }
 
 void LogicEnvironment::AddLoadingBlockModifier(LoadingBlockModifier *lbm)
@@ -2393,6 +2503,7 @@ void LogicEnvironment::Step(float dTime)
 		TimeTaker timer("modify in active blocks per interval");
 
 		// Initialize handling of ActiveBlockModifiers
+		CompileABMs();
 		ABMHandler abmhandler(mABMs, mCacheAbmInterval, this, true);
 
         int abmsRun = 0;
@@ -2412,30 +2523,57 @@ void LogicEnvironment::Step(float dTime)
 		int i = 0;
 		// determine the time budget for ABMs
 		unsigned int maxTimeMs = (unsigned int)(mCacheAbmInterval * 1000 * mCacheAbmTimeBudget);
-		for (const Vector3<short>& bl : output) 
-        {
-			MapBlock* block = mMap->GetBlockNoCreateNoEx(bl);
-			if (!block)
-				continue;
 
-			i++;
+		// The blocks are scanned in parallel by batches, then the triggers of the
+		// batch are run on this thread in the shuffled order of the blocks.
+		size_t batchSize = 4 * TaskScheduler::Get()->GetConcurrency();
+		std::vector<ABMBlock> batch(batchSize);
+		std::vector<ABMBlock*> scans;
+		bool budgetExceeded = false;
+		for (size_t first = 0; first < output.size() && !budgetExceeded; first += batchSize)
+		{
+			size_t count = 0;
+			scans.clear();
+			for (size_t b = first; b < std::min(first + batchSize, output.size()); b++)
+			{
+				MapBlock* block = mMap->GetBlockNoCreateNoEx(output[b]);
+				if (!block)
+					continue;
 
-			// Set current time as timestamp
-			block->SetTimestampNoChangedFlag(mGameTime);
+				ABMBlock& abmBlock = batch[count++];
+				abmBlock.block = block;
+				if (abmhandler.Prepare(abmBlock))
+					scans.push_back(&abmBlock);
+			}
 
-			/* Handle ActiveBlockModifiers */
-			abmhandler.Apply(block, blocksScanned, abmsRun, blocksCached);
+			ParallelFor(size_t(0), scans.size(), [&scans, &abmhandler](size_t s)
+			{
+				abmhandler.Scan(*scans[s]);
+			}, 1);
+
+			for (size_t b = 0; b < count; b++)
+			{
+				i++;
 
-			uint64_t timeMs = timer.GetTimeElapsed();
+				// Set current time as timestamp
+				batch[b].block->SetTimestampNoChangedFlag(mGameTime);
 
-			if (timeMs > maxTimeMs) 
-            {
-				LogWarning("active block modifiers took " + std::to_string(timeMs) + 
-                    "ms (processed " + std::to_string(i) + " of " + 
-                    std::to_string(output.size()) + " active blocks)");
-				break;
+				/* Handle ActiveBlockModifiers */
+				abmhandler.Apply(batch[b], blocksScanned, abmsRun, blocksCached);
+
+				uint64_t timeMs = timer.GetTimeElapsed();
+
+				if (timeMs > maxTimeMs) 
+				{
+					LogWarning("active block modifiers took " + std::to_string(timeMs) + 
+						"ms (processed " + std::to_string(i) + " of " + 
+						std::to_string(output.size()) + " active blocks)");
+					budgetExceeded = true;
+					break;
+				}
 			}
 		}
+		abmhandler.Report();
 		Profiling->Avg("LogicEnv: active blocks", (float)mActiveBlocks.mABMList.size());
         Profiling->Avg("LogicEnv: active blocks cached", (float)blocksCached);
         Profiling->Avg("LogicEnv: active blocks scanned for ABMs", (float)blocksScanned);
@@ -2703,8 +2841,8 @@ void LogicEnvironment::GetSelectedActiveObjects(
 	const Line3<float>& shootlineOnMap, std::vector<PointedThing>& objects)
 {
 	std::vector<LogicActiveObject*> objs;
-	GetObjectsInsideRadius(objs, shootlineOnMap.mStart,
-		shootlineOnMap.GetLength() + 10.0f, nullptr);
+	mActiveObjectMgr.GetObjectsInsideRadius(shootlineOnMap.mStart,
+		shootlineOnMap.GetLength() + 10.0f, objs);
 	const Vector3<float> lineVector = shootlineOnMap.GetVector();
 
 	for (auto obj : objs) 
@@ -29,6 +29,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #include "../Map/MapNode.h"
 #include "../Map/Map.h"
+#include "../Map/MapBlock.h"
 
 #include "../../Utils/Util.h"
 
@@ -166,6 +167,13 @@ struct ABMWithState
 	ActiveBlockModifier* activeBlockModifier;
 	float timer = 0.0f;
 
+	// Content ids of the trigger contents and of the required neighbors (sorted),
+	// resolved by LogicEnvironment::CompileABMs when the node definitions change
+	std::vector<uint16_t> triggerContents;
+	std::vector<uint16_t> requiredNeighbors;
+	// Profiler name of the ABM
+	std::string name;
+
 	ABMWithState(ActiveBlockModifier* abm);
 };
 
@@ -204,6 +212,8 @@ struct LBMContentMapping
 {
 	typedef std::unordered_map<uint16_t, std::vector<LoadingBlockModifier *>> LBMMap;
 	LBMMap map;
+	// Bitmap of the trigger contents, see MapBlock::mContentsMask
+	uint64_t contentsMask[MapBlock::ContentsMaskBits / 64] = {};
 
 	std::vector<LoadingBlockModifier*> lbmList;
 
@@ -495,6 +505,8 @@ public:
 	*/
 
 	void AddActiveBlockModifier(ActiveBlockModifier* abm);
+	// Resolves the content ids of the ABMs, if the node definitions changed
+	void CompileABMs();
 	void AddLoadingBlockModifier(LoadingBlockModifier* lbm);
 
 	/*
@@ -511,17 +523,33 @@ public:
 	uint8_t FindSunlight(Vector3<short> pos);
 
 	// Find all active objects inside a radius around a point
+	template <typename Predicate>
 	void GetObjectsInsideRadius(std::vector<LogicActiveObject*>& objects, 
-        const Vector3<float>& pos, float radius, std::function<bool(LogicActiveObject *obj)> includeObjCB)
+        const Vector3<float>& pos, float radius, Predicate includeObj)
 	{
-		return mActiveObjectMgr.GetObjectsInsideRadius(pos, radius, objects, includeObjCB);
+		return mActiveObjectMgr.GetObjectsInsideRadius(pos, radius, objects, includeObj);
 	}
 
 	// Find all active objects inside a box
+	template <typename Predicate>
 	void GetObjectsInArea(std::vector<LogicActiveObject *>& objects,
-        const BoundingBox<float>& box, std::function<bool(LogicActiveObject *obj)> includeObjCB)
+        const BoundingBox<float>& box, Predicate includeObj)
+	{
+		return mActiveObjectMgr.GetObjectsInArea(box, objects, includeObj);
+	}
+
+	// Find the active objects nearest to a point, closest first
+	template <typename Predicate>
+	void GetNearestObjects(std::vector<LogicActiveObject*>& objects,
+        const Vector3<float>& pos, unsigned int count, Predicate includeObj)
+	{
+		return mActiveObjectMgr.GetNearestObjects(pos, count, objects, includeObj);
+	}
+
+	// Called when an active object changed its base position
+	void UpdateActiveObjectPosition(LogicActiveObject* obj)
 	{
-		return mActiveObjectMgr.GetObjectsInArea(box, objects, includeObjCB);
+		mActiveObjectMgr.UpdateObjectPosition(obj);
 	}
 
 	// Clear objects, loading and going through every MapBlock
@@ -760,6 +788,8 @@ private:
 	unsigned int mLastClearObjectsTime = 0;
 	// Active block modifiers
     std::vector<ABMWithState> mABMs;
+	// Node definitions version the ABM content ids were resolved for
+	unsigned int mABMsDefinitionsVersion = 0;
 	LBMManager mLBMMgr;
 	// An interval for generally sending object positions and stuff
 	float mRecommendedSendInterval = 0.1f;
@@ -55,7 +55,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 	VisualEnvironment
 */
 VisualEnvironment::VisualEnvironment(VisualMap* map, BaseTextureSource* textureSrc, BaseWritableShaderSource* shaderSrc) 
-    : Environment(), mMap(map), mTextureSrc(textureSrc), mShaderSrc(shaderSrc), mMeshUpdateThread(this)
+    : Environment(), mMap(map), mTextureSrc(textureSrc), mShaderSrc(shaderSrc), mMeshUpdateManager(this)
 {
     mItemMgr = CreateItemManager();
     mNodeMgr = CreateNodeManager();
@@ -66,13 +66,11 @@ VisualEnvironment::~VisualEnvironment()
     mShutdown = true;
 	mAOManager.Clear();
 
-    mMeshUpdateThread.Stop();
-    mMeshUpdateThread.Wait();
-    while (!mMeshUpdateThread.mQueueOut.Empty()) 
-    {
-        MeshUpdateResult r = mMeshUpdateThread.mQueueOut.PopFrontNoEx();
+    mMeshUpdateManager.Stop();
+    mMeshUpdateManager.Wait();
+    MeshUpdateResult r;
+    while (mMeshUpdateManager.GetNextResult(r))
         r.mesh.reset();
-    }
 
     //delete mInventoryFromLogic;
 
@@ -116,12 +114,12 @@ void VisualEnvironment::Stop()
     mShutdown = true;
 
     //request all visual managed threads to stop
-    mMeshUpdateThread.Stop();
+    mMeshUpdateManager.Stop();
 }
 
 bool VisualEnvironment::IsShutdown()
 {
-    return mShutdown || !mMeshUpdateThread.IsRunning();
+    return mShutdown || !mMeshUpdateManager.IsRunning();
 }
 
 
@@ -386,7 +384,7 @@ void VisualEnvironment::AddUpdateMeshTask(Vector3<short> position, bool ackToLog
     if (b == NULL)
         return;
 
-    mMeshUpdateThread.UpdateBlock(GetMap().get(), position, ackToLogic, urgent);
+    mMeshUpdateManager.UpdateBlock(GetMap().get(), position, ackToLogic, urgent);
 }
 
 void VisualEnvironment::AddUpdateMeshTaskWithEdge(Vector3<short> blockPos, bool ackToLogic, bool urgent)
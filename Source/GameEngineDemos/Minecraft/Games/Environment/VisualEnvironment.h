@@ -198,7 +198,7 @@ public:
 	void UpdateCameraOffset(const Vector3<short>& cameraOffset) 
     {
         mCameraOffset = cameraOffset; 
-        mMeshUpdateThread.mCameraOffset = cameraOffset;
+        mMeshUpdateManager.SetCameraOffset(cameraOffset);
     }
 	Vector3<short> GetCameraOffset() const { return mCameraOffset; }
 
@@ -206,7 +206,7 @@ public:
     void AddUpdateMeshTaskWithEdge(Vector3<short> blockPos, bool ackToLogic = false, bool urgent = false);
     void AddUpdateMeshTaskForNode(Vector3<short> nodePos, bool ackToLogic = false, bool urgent = false);
 
-    MeshUpdateThread mMeshUpdateThread;
+    MeshUpdateManager mMeshUpdateManager;
 
 private:
 
@@ -425,7 +425,7 @@ private:
     float mSongTimeNext = 10.f; // seconds
     float mSongPauseBetween = 7.f;
 
-    VectorAreaStore mAreaStore;
+    SpatialAreaStore mAreaStore;
     std::map<std::string, unsigned int> mAreasHuds;
 
 };
@@ -453,6 +453,20 @@ public:
         return mRefCount;
     }
 
+	////
+	//// Face connectivity (see mFaceConnections)
+	////
+
+	inline void SetFaceConnections(const uint8_t* connections)
+	{
+		memcpy(mFaceConnections, connections, sizeof(mFaceConnections));
+	}
+
+	inline bool IsFaceConnected(uint8_t from, uint8_t to) const
+	{
+		return (mFaceConnections[from] & (1 << to)) != 0;
+	}
+
 	////
 	//// Node Timers
 	////
@@ -532,12 +546,29 @@ public:
 	static const unsigned int NodeCount = MAP_BLOCKSIZE * MAP_BLOCKSIZE * MAP_BLOCKSIZE;
 
 	//// ABM optimizations ////
-	// Cache of content types
-	std::unordered_set<unsigned short> mContents;
-	// True if content types are cached
+	// Bitmap of the content types found in the block. Content ids are folded
+	// on ContentsMaskBits bits, a false positive only costs a scan of the block
+	static const unsigned int ContentsMaskBits = 256;
+	uint64_t mContentsMask[ContentsMaskBits / 64] = {};
+	// True if the content types bitmap is up to date
 	bool mContentsCached = false;
-	// True if we never want to cache content types for this block
-	bool mNoCachedContents = false;
+
+	static inline void AddToContentsMask(uint64_t* mask, uint16_t content)
+	{
+		content %= ContentsMaskBits;
+		mask[content / 64] |= (uint64_t)1 << (content % 64);
+	}
+
+	// False if the block is known not to contain any content type of the mask
+	inline bool MayContain(const uint64_t* mask) const
+	{
+		if (!mContentsCached)
+			return true;
+		for (unsigned int i = 0; i < ContentsMaskBits / 64; i++)
+			if (mContentsMask[i] & mask[i])
+				return true;
+		return false;
+	}
 
 private:
 	/*
@@ -619,6 +650,15 @@ private:
 		the list of blocks to be drawn.
 	*/
 	int mRefCount = 0;
+
+	/*
+		Which faces of the block can see each other through its transparent
+		nodes. Bit t of mFaceConnections[f] is set when face f connects to
+		face t, faces are ordered Z+, Y+, X+, Z-, Y-, X- so the opposite of
+		face f is (f + 3) % 6. Set by the visual when the block is meshed,
+		all faces connect until then.
+	*/
+	uint8_t mFaceConnections[6] = { 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F };
 };
 
 typedef std::vector<MapBlock*> MapBlockVec;
@@ -26,7 +26,6 @@ AnimatedObjectMeshNode::AnimatedObjectMeshNode(const ActorId actorId, unsigned i
 {
 	mPVWUpdater = updater;
 
-	mRasterizerState = std::make_shared<RasterizerState>();
 
 	SetMesh(mesh);
 }
@@ -57,6 +56,7 @@ void AnimatedObjectMeshNode::SetMesh(const std::shared_ptr<BaseAnimatedMesh>& me
 	mVisuals.clear();
 	mBlendStates.clear();
 	mDepthStencilStates.clear();
+	mRasterizerStates.clear();
 	for (unsigned int i = 0; i < meshBuffers.size(); ++i)
 	{
 		const std::shared_ptr<BaseMeshBuffer>& meshBuffer = meshBuffers[i];
@@ -64,6 +64,7 @@ void AnimatedObjectMeshNode::SetMesh(const std::shared_ptr<BaseAnimatedMesh>& me
 		{
 			mBlendStates.push_back(std::make_shared<BlendState>());
 			mDepthStencilStates.push_back(std::make_shared<DepthStencilState>());
+			mRasterizerStates.push_back(std::make_shared<RasterizerState>());
 
 			std::shared_ptr<Texture2> textureDiffuse = meshBuffer->GetMaterial()->GetTexture(TT_DIFFUSE);
 			if (!textureDiffuse)
@@ -334,21 +335,14 @@ bool AnimatedObjectMeshNode::Render(Scene* pScene)
 				Renderer::Get()->Unbind(mBlendStates[i]);
 			if (GetMaterial(i)->Update(mDepthStencilStates[i]))
 				Renderer::Get()->Unbind(mDepthStencilStates[i]);
-			if (GetMaterial(i)->Update(mRasterizerState))
-				Renderer::Get()->Unbind(mRasterizerState);
-
-			Renderer::Get()->SetBlendState(mBlendStates[i]);
-			Renderer::Get()->SetDepthStencilState(mDepthStencilStates[i]);
-			Renderer::Get()->SetRasterizerState(mRasterizerState);
+			if (GetMaterial(i)->Update(mRasterizerStates[i]))
+				Renderer::Get()->Unbind(mRasterizerStates[i]);
 
 			UpdateShaderConstants(i, pScene);
 
 			Renderer::Get()->Update(mVisuals[i]->GetVertexBuffer());
-			Renderer::Get()->Draw(mVisuals[i]);
-
-			Renderer::Get()->SetDefaultBlendState();
-			Renderer::Get()->SetDefaultDepthStencilState();
-			Renderer::Get()->SetDefaultRasterizerState();
+			pScene->GetRenderQueue()->Add(mVisuals[i], mBlendStates[i], mDepthStencilStates[i],
+				mRasterizerStates[i], pScene->GetCameraDepth(this), 0, transparent);
 		}
 	}
 
@@ -28,6 +28,8 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #include "../PlayerCamera.h"
 #include "../Hud.h"
 
+#include "Core/Utility/Profiler.h"
+
 DrawingCore::DrawingCore(BaseUI* ui, VisualEnvironment* vEnv, Scene* pScene, Hud* hud)
 	: mScene(pScene), mVisualEnv(vEnv), mHud(hud), mUI(ui)
 {
@@ -77,6 +79,14 @@ void DrawingCore::Draw(SColor skyColor,
 void DrawingCore::Render3D()
 {
 	mScene->OnRender();
+
+	const RenderQueue::Statistics& queueStats = mScene->GetRenderQueue()->GetStatistics();
+	Profiling->Avg("RenderQueue: visuals [#]", (float)queueStats.numVisuals);
+	Profiling->Avg("RenderQueue: binds unsorted [#]", (float)queueStats.numBindsUnsorted);
+	Profiling->Avg("RenderQueue: binds [#]", (float)queueStats.numBinds);
+	Profiling->Avg("RenderQueue: sort [us]", (float)queueStats.sortTime);
+	Profiling->Avg("RenderQueue: submit [us]", (float)queueStats.submitTime);
+
 	if (!mShowHud)
 		return;
 
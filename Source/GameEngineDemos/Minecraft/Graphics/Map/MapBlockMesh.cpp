@@ -1064,6 +1064,84 @@ static void UpdateAllFastFaceRows(MeshMakeData* data, std::vector<FastFace>& des
     }
 }
 
+/*
+	Flood fills the nodes of the block that light passes through and records
+	which faces of the block each of those regions touches. Two faces are
+	connected when a region touches both, see MapBlock::mFaceConnections.
+*/
+static void ComputeFaceConnections(MeshMakeData* data, uint8_t* connections)
+{
+	const NodeManager* nodeMgr = data->mEnvironment->GetNodeManager();
+	const Vector3<short> blockPosNodes = data->mBlockPos * (short)MAP_BLOCKSIZE;
+	const int nodeCount = MAP_BLOCKSIZE * MAP_BLOCKSIZE * MAP_BLOCKSIZE;
+
+	// Same criterion as the occlusion test of the map, ignore is not
+	// known to be solid so it lets the fill pass.
+	bool isOpen[nodeCount];
+	int index = 0;
+	for (int16_t z = 0; z < MAP_BLOCKSIZE; z++)
+		for (int16_t y = 0; y < MAP_BLOCKSIZE; y++)
+			for (int16_t x = 0; x < MAP_BLOCKSIZE; x++, index++)
+			{
+				const MapNode& node = data->mVManip.GetNodeRefUnsafeCheckFlags(
+					blockPosNodes + Vector3<short>{x, y, z});
+				isOpen[index] = node.GetContent() == CONTENT_IGNORE ||
+					nodeMgr->Get(node).lightPropagates;
+			}
+
+	memset(connections, 0, 6);
+
+	uint16_t stack[nodeCount];
+	for (int start = 0; start < nodeCount; start++)
+	{
+		if (!isOpen[start])
+			continue;
+
+		// Faces ordered Z+, Y+, X+, Z-, Y-, X-
+		uint8_t faces = 0;
+		int stackSize = 0;
+		isOpen[start] = false;
+		stack[stackSize++] = start;
+		while (stackSize > 0)
+		{
+			const int i = stack[--stackSize];
+			const int x = i % MAP_BLOCKSIZE;
+			const int y = (i / MAP_BLOCKSIZE) % MAP_BLOCKSIZE;
+			const int z = i / (MAP_BLOCKSIZE * MAP_BLOCKSIZE);
+			if (z == MAP_BLOCKSIZE - 1) faces |= 1 << 0;
+			if (y == MAP_BLOCKSIZE - 1) faces |= 1 << 1;
+			if (x == MAP_BLOCKSIZE - 1) faces |= 1 << 2;
+			if (z == 0) faces |= 1 << 3;
+			if (y == 0) faces |= 1 << 4;
+			if (x == 0) faces |= 1 << 5;
+
+			const int neighbors[6][2] = {
+				{ z < MAP_BLOCKSIZE - 1, i + MAP_BLOCKSIZE * MAP_BLOCKSIZE },
+				{ y < MAP_BLOCKSIZE - 1, i + MAP_BLOCKSIZE },
+				{ x < MAP_BLOCKSIZE - 1, i + 1 },
+				{ z > 0, i - MAP_BLOCKSIZE * MAP_BLOCKSIZE },
+				{ y > 0, i - MAP_BLOCKSIZE },
+				{ x > 0, i - 1 } };
+			for (const auto& neighbor : neighbors)
+			{
+				if (neighbor[0] && isOpen[neighbor[1]])
+				{
+					isOpen[neighbor[1]] = false;
+					stack[stackSize++] = neighbor[1];
+				}
+			}
+		}
+
+		for (int face = 0; face < 6; face++)
+			if (faces & (1 << face))
+				connections[face] |= faces;
+
+		// Nothing left to learn once every face sees every other one
+		if (faces == 0x3F)
+			break;
+	}
+}
+
 static void ApplyTileColor(PreMeshBuffer& pmb)
 {
 	SColor tileColor = pmb.layer.color;
@@ -1105,6 +1183,8 @@ MapBlockMesh::MapBlockMesh(MeshMakeData* data, Vector3<short> cameraOffset):
 			&data->mVManip, data->mBlockPos * (short)MAP_BLOCKSIZE);
 	}
 
+	ComputeFaceConnections(data, mFaceConnections);
+
 	// 4-21ms for MAP_BLOCKSIZE=16  (NOTE: probably outdated)
 	// 24-155ms for MAP_BLOCKSIZE=32  (NOTE: probably outdated)
 	//TimeTaker timer1("MapBlockMesh()");
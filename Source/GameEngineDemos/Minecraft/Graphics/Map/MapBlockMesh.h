@@ -116,6 +116,12 @@ public:
 		return p;
 	}
 
+	// Face to face connectivity of the block, see MapBlock::mFaceConnections
+	const uint8_t* GetFaceConnections() const
+	{
+		return mFaceConnections;
+	}
+
 	bool IsAnimationForced() const
 	{
 		return mAnimationForceTimer == 0;
@@ -139,6 +145,8 @@ private:
 	bool mEnableShaders;
 	bool mEnableVBO;
 
+	uint8_t mFaceConnections[6];
+
 	// Must animate() be called before rendering?
 	bool mHasAnimation;
 	int mAnimationForceTimer;
@@ -47,12 +47,16 @@ void VisualLayerList::Clear()
 		visualLayers[layer].clear();
 }
 
-void VisualLayerList::Add(std::shared_ptr<Visual> visual, const std::shared_ptr<Material>& material, uint8_t layer)
+void VisualLayerList::Add(std::shared_ptr<Visual> visual, const std::shared_ptr<Material>& material, uint8_t layer, float depth)
 {
 	// Append to the correct layer
 	VisualData visualData;
 	visualData.visual = visual;
 	visualData.material = material;
+	visualData.blendState = std::make_shared<BlendState>();
+	visualData.depthStencilState = std::make_shared<DepthStencilState>();
+	visualData.rasterizerState = std::make_shared<RasterizerState>();
+	visualData.depth = depth;
 	visualLayers[layer].push_back(visualData);
 }
 
@@ -204,130 +208,239 @@ void VisualMap::GetBlocksInViewRange(Vector3<short> camPosNodes,
         (short)(pNodesMax[2] / MAP_BLOCKSIZE + 1)};
 }
 
-void VisualMap::UpdateDrawList()
+/*
+	Faces of a block in the order of MapBlock::mFaceConnections,
+	the opposite of face f is (f + 3) % 6.
+*/
+static const Vector3<short> BlockFaceDirs[6] = {
+	Vector3<short>{0, 0, 1}, Vector3<short>{0, 1, 0}, Vector3<short>{1, 0, 0},
+	Vector3<short>{0, 0, -1}, Vector3<short>{0, -1, 0}, Vector3<short>{-1, 0, 0} };
+
+struct DrawListStep
 {
-	ScopeProfiler sp(Profiling, "VM::UpdateDrawList()", SPT_AVG);
+	Vector3<short> blockPos;
+	// Face the block was entered through, 6 for the camera block
+	uint8_t entryFace;
+	// Faces stepped through on the way from the camera block
+	uint8_t directions;
+	// Distance from the camera as given by IsBlockInsight
+	float distance;
+};
+
+static inline uint64_t GetDrawListKey(const Vector3<short>& p)
+{
+	return (uint64_t)(uint16_t)p[0] |
+		((uint64_t)(uint16_t)p[1] << 16) | ((uint64_t)(uint16_t)p[2] << 32);
+}
+
+/*
+	Selects the blocks to draw with a breadth first flood fill from the block
+	of the camera. The fill only moves away from the camera, never through a
+	face opposite to one it already stepped through, and leaves a block only
+	through faces connected to the one it entered by. Blocks out of range or
+	out of the view cone stop the fill, the remaining ones are then occlusion
+	tested as before.
+*/
+void VisualMap::SelectDrawBlocks(Vector3<short> camPosNodes,
+	float cameraFov, float range, bool occlusionCullingEnabled)
+{
+	ScopeProfiler sp(Profiling, "VM::SelectDrawBlocks()", SPT_AVG);
 
 	for (auto& blocks : mDrawBlocks)
     {
 		MapBlock* block = blocks.second;
 		block->RefDrop();
 	}
-
 	mDrawBlocks.clear();
-	mDrawMeshes.Clear();
-	mDrawVisuals.Clear();
 
 	const Vector3<float> cameraPosition = mCameraPosition;
 	const Vector3<float> cameraDirection = mCameraDirection;
 
-	// Use a higher fov to accomodate faster camera movements.
-	// Blocks are cropped better when they are drawn.
-	const float cameraFov = mCameraFov * 1.1f;
-
-    Vector3<short> camPosNodes;
-    camPosNodes[0] = (short)((cameraPosition[0] + (cameraPosition[0] > 0 ? BS / 2 : -BS / 2)) / BS);
-    camPosNodes[1] = (short)((cameraPosition[1] + (cameraPosition[1] > 0 ? BS / 2 : -BS / 2)) / BS);
-    camPosNodes[2] = (short)((cameraPosition[2] + (cameraPosition[2] > 0 ? BS / 2 : -BS / 2)) / BS);
-
-	Vector3<short> pBlocksMin;
-	Vector3<short> pBlocksMax;
-	GetBlocksInViewRange(camPosNodes, &pBlocksMin, &pBlocksMax);
-
-	// Read the vision range, unless unlimited range is enabled.
-	float range = mControl->rangeAll ? (float)1e7 : mControl->wantedRange;
-
-	// Number of blocks currently loaded by the visual
-	unsigned int blocksLoaded = 0;
+	// Number of blocks reached by the flood fill
+	unsigned int blocksVisited = 0;
 	// Number of blocks with mesh in rendering range
 	unsigned int blocksInRangeWithMesh = 0;
 	// Number of blocks occlusion culled
 	unsigned int blocksOcclusionCulled = 0;
 
-	// No occlusion culling when free_move is on and camera is
-	// inside ground
-	bool occlusionCullingEnabled = true;
-	if (Settings::Get()->GetBool("free_move") && Settings::Get()->GetBool("noclip"))
-    {
-		MapNode mapNode = GetNode(camPosNodes);
-        if (mapNode.GetContent() == CONTENT_IGNORE ||
-			mEnvironment->GetNodeManager()->Get(mapNode).solidness == 2)
-        {
-            occlusionCullingEnabled = false;
-        }
-	}
+	std::unordered_set<uint64_t> visited;
+	std::vector<DrawListStep> steps;
 
+	DrawListStep cameraStep;
+	cameraStep.blockPos = GetNodeBlockPosition(camPosNodes);
+	cameraStep.entryFace = 6;
+	cameraStep.directions = 0;
+	IsBlockInsight(cameraStep.blockPos, cameraPosition,
+		cameraDirection, cameraFov, range * BS, &cameraStep.distance);
+	steps.push_back(cameraStep);
+	visited.insert(GetDrawListKey(cameraStep.blockPos));
 
-	// Uncomment to debug occluded blocks in the wireframe mode
-	// TODO: Include this as a flag for an extended debugging setting
-	//if (occlusionCullingEnabled && mControl.showWireframe)
-	//    occlusionCullingEnabled = porting::getTimeS() & 1;
-	for (const auto& sectorIt : mSectors) 
-    {
-		MapSector* sector = sectorIt.second;
-		Vector2<short> sp = sector->GetPosition();
+	// The queue is the vector itself, steps are only ever appended
+	for (size_t next = 0; next < steps.size(); next++)
+	{
+		const DrawListStep step = steps[next];
+		blocksVisited++;
 
-		blocksLoaded += sector->Size();
-		if (!mControl->rangeAll) 
-        {
-			if (sp[0] < pBlocksMin[0] || sp[0] > pBlocksMax[0] ||
-                sp[1] < pBlocksMin[2] || sp[1] > pBlocksMax[2])
-				continue;
+		MapBlock* block = GetBlockNoCreateNoEx(step.blockPos);
+		if (block && block->mMesh)
+		{
+			// Keep the block alive as long as it is seen.
+			block->ResetUsageTimer();
+			blocksInRangeWithMesh++;
+
+			// Occlusion culling
+			if ((!mControl->rangeAll && step.distance > mControl->wantedRange * BS) ||
+				(occlusionCullingEnabled && IsBlockOccluded(block, camPosNodes)))
+			{
+				blocksOcclusionCulled++;
+			}
+			else
+			{
+				// Add to set
+				block->RefGrab();
+				mDrawBlocks[step.blockPos] = block;
+				mLastDrawnSectors.insert(Vector2<short>{step.blockPos[0], step.blockPos[2]});
+			}
 		}
 
-		MapBlockVec sectorblocks;
-		sector->GetBlocks(sectorblocks);
+		for (uint8_t face = 0; face < 6; face++)
+		{
+			// Never head back towards the camera
+			if (step.directions & (1 << ((face + 3) % 6)))
+				continue;
 
-		/*
-			Loop through blocks in sector
-		*/
-		unsigned int sectorBlocksDrawn = 0;
-		for (MapBlock* block : sectorblocks) 
-        {
-			/*
-				Compare block position to camera position, skip
-				if not seen on display
-			*/
-			if (!block->mMesh) 
-            {
-				// Ignore if mesh doesn't exist
+			// Blocks not loaded or not meshed yet connect all their faces
+			if (occlusionCullingEnabled && block && step.entryFace < 6 &&
+				!block->IsFaceConnected(step.entryFace, face))
 				continue;
-			}
 
-			Vector3<short> blockCoord = block->GetPosition();
-            Vector3<short> blockPosition = block->GetRelativePosition() + 
-                Vector3<short>{MAP_BLOCKSIZE / 2, MAP_BLOCKSIZE / 2, MAP_BLOCKSIZE / 2};
+			Vector3<short> blockCoord = step.blockPos + BlockFaceDirs[face];
+			if (!visited.insert(GetDrawListKey(blockCoord)).second)
+				continue;
 
 			// First, perform a simple distance check, with a padding of one extra block.
+			Vector3<short> blockPosition = blockCoord * (short)MAP_BLOCKSIZE +
+				Vector3<short>{MAP_BLOCKSIZE / 2, MAP_BLOCKSIZE / 2, MAP_BLOCKSIZE / 2};
 			if (!mControl->rangeAll && Length(blockPosition - camPosNodes) > range + MAP_BLOCKSIZE)
 				continue; // Out of range, skip.
 
-			// Keep the block alive as long as it is in range.
-			block->ResetUsageTimer();
-			blocksInRangeWithMesh++;
-
 			// Frustum culling
 			float d = 0.0;
 			if (!IsBlockInsight(blockCoord, cameraPosition, cameraDirection, cameraFov, range * BS, &d))
 				continue;
 
-			// Occlusion culling
-			if ((!mControl->rangeAll && d > mControl->wantedRange * BS) ||
-                (occlusionCullingEnabled && IsBlockOccluded(block, camPosNodes))) 
-            {
-				blocksOcclusionCulled++;
+			// With unlimited range only the loaded blocks bound the fill
+			if (mControl->rangeAll && !GetBlockNoCreateNoEx(blockCoord))
 				continue;
-			}
 
-			// Add to set
-			block->RefGrab();
-			mDrawBlocks[blockCoord] = block;
+			DrawListStep nextStep;
+			nextStep.blockPos = blockCoord;
+			nextStep.entryFace = (face + 3) % 6;
+			nextStep.directions = step.directions | (1 << face);
+			nextStep.distance = d;
+			steps.push_back(nextStep);
+		}
+	}
+
+	Profiling->Avg("MapBlocks visited [#]", (float)blocksVisited);
+	Profiling->Avg("MapBlock meshes in range [#]", (float)blocksInRangeWithMesh);
+	Profiling->Avg("MapBlocks occlusion culled [#]", (float)blocksOcclusionCulled);
+}
+
+void VisualMap::TouchBlocksInRange()
+{
+	Vector3<short> camPosNodes;
+	camPosNodes[0] = (short)((mCameraPosition[0] + (mCameraPosition[0] > 0 ? BS / 2 : -BS / 2)) / BS);
+	camPosNodes[1] = (short)((mCameraPosition[1] + (mCameraPosition[1] > 0 ? BS / 2 : -BS / 2)) / BS);
+	camPosNodes[2] = (short)((mCameraPosition[2] + (mCameraPosition[2] > 0 ? BS / 2 : -BS / 2)) / BS);
+
+	Vector3<short> pBlocksMin;
+	Vector3<short> pBlocksMax;
+	GetBlocksInViewRange(camPosNodes, &pBlocksMin, &pBlocksMax);
+
+	for (const auto& sectorIt : mSectors)
+	{
+		MapSector* sector = sectorIt.second;
+		Vector2<short> sp = sector->GetPosition();
+		if (!mControl->rangeAll)
+		{
+			if (sp[0] < pBlocksMin[0] || sp[0] > pBlocksMax[0] ||
+				sp[1] < pBlocksMin[2] || sp[1] > pBlocksMax[2])
+				continue;
+		}
+
+		MapBlockVec sectorblocks;
+		sector->GetBlocks(sectorblocks);
+		for (MapBlock* block : sectorblocks)
+		{
+			if (!block->mMesh)
+				continue;
 
-			sectorBlocksDrawn++;
-		} // foreach sectorblocks
+			Vector3<short> blockPosition = block->GetRelativePosition() +
+				Vector3<short>{MAP_BLOCKSIZE / 2, MAP_BLOCKSIZE / 2, MAP_BLOCKSIZE / 2};
+			if (!mControl->rangeAll &&
+				Length(blockPosition - camPosNodes) > mControl->wantedRange + MAP_BLOCKSIZE)
+				continue;
 
-		if (sectorBlocksDrawn != 0)
-			mLastDrawnSectors.insert(sp);
+			block->ResetUsageTimer();
+		}
+	}
+}
+
+void VisualMap::UpdateDrawList()
+{
+	ScopeProfiler sp(Profiling, "VM::UpdateDrawList()", SPT_AVG);
+
+	mDrawMeshes.Clear();
+	mDrawVisuals.Clear();
+
+	const Vector3<float> cameraPosition = mCameraPosition;
+	const Vector3<float> cameraDirection = mCameraDirection;
+
+	// Use a higher fov to accomodate faster camera movements.
+	// Blocks are cropped better when they are drawn.
+	const float cameraFov = mCameraFov * 1.1f;
+
+    Vector3<short> camPosNodes;
+    camPosNodes[0] = (short)((cameraPosition[0] + (cameraPosition[0] > 0 ? BS / 2 : -BS / 2)) / BS);
+    camPosNodes[1] = (short)((cameraPosition[1] + (cameraPosition[1] > 0 ? BS / 2 : -BS / 2)) / BS);
+    camPosNodes[2] = (short)((cameraPosition[2] + (cameraPosition[2] > 0 ? BS / 2 : -BS / 2)) / BS);
+
+	// Read the vision range, unless unlimited range is enabled.
+	float range = mControl->rangeAll ? (float)1e7 : mControl->wantedRange;
+
+	// No occlusion culling when free_move is on and camera is
+	// inside ground
+	bool occlusionCullingEnabled = true;
+	if (Settings::Get()->GetBool("free_move") && Settings::Get()->GetBool("noclip"))
+    {
+		MapNode mapNode = GetNode(camPosNodes);
+        if (mapNode.GetContent() == CONTENT_IGNORE ||
+			mEnvironment->GetNodeManager()->Get(mapNode).solidness == 2)
+        {
+            occlusionCullingEnabled = false;
+        }
+	}
+
+	// The selection only changes when the camera enters another block, turns
+	// or a mesh gets replaced, reuse the previous one otherwise.
+	const Vector3<short> cameraBlock = GetNodeBlockPosition(camPosNodes);
+	if (!mDrawListValid ||
+		mDrawListCameraBlock != cameraBlock ||
+		mDrawListCameraDirection != cameraDirection ||
+		mDrawListCameraOffset != mCameraOffset ||
+		mDrawListCameraFov != cameraFov || mDrawListRange != range ||
+		mDrawListOcclusionCulling != occlusionCullingEnabled)
+	{
+		SelectDrawBlocks(camPosNodes, cameraFov, range, occlusionCullingEnabled);
+
+		mDrawListValid = true;
+		mDrawListCameraBlock = cameraBlock;
+		mDrawListCameraDirection = cameraDirection;
+		mDrawListCameraOffset = mCameraOffset;
+		mDrawListCameraFov = cameraFov;
+		mDrawListRange = range;
+		mDrawListOcclusionCulling = occlusionCullingEnabled;
 	}
 
 	// Get animation parameters
@@ -341,6 +454,9 @@ void VisualMap::UpdateDrawList()
 	int meshAnimateCount = 0;
 	//int meshAnimateCountFar = 0;
 
+	// Camera space depth of the center of each block, the depth its visuals are queued with
+	std::map<Vector3<short>, float> blockDepths;
+
 	/*
 		Update the selected MapBlocks
 	*/
@@ -359,6 +475,7 @@ void VisualMap::UpdateDrawList()
 			Vector3<float>{ (float)pos[0], (float)pos[1], (float)pos[2] } *BS;
 		float distance = Length(cameraPosition - blockPosRelative);
 		distance = std::max(0.f, distance - BLOCK_MAX_RADIUS);
+		blockDepths[blockPos] = Dot(cameraDirection, blockPosRelative - cameraPosition);
 
 		// Mesh animation
 		{
@@ -420,6 +537,7 @@ void VisualMap::UpdateDrawList()
 		{
 			std::map<std::string, unsigned int> meshBufferVertices;
 			std::map<std::string, unsigned int> meshBufferPrimitives;
+			std::map<std::string, float> meshBufferDepths;
 			std::map<std::string, std::vector<std::pair<Vector3<short>, std::shared_ptr<BaseMeshBuffer>>>> meshBuffers;
 			for (auto buffer : bufferList.buffers)
 			{
@@ -432,14 +550,23 @@ void VisualMap::UpdateDrawList()
 					std::string tex =
 						std::to_string(textureDiffuse->GetWidth()) + " " + std::to_string(textureDiffuse->GetHeight());
 
+					// Transparent buffers are drawn back to front, each block gets a visual of its own
+					if (bufferList.material->IsTransparent())
+					{
+						tex += " " + std::to_string(blockPosition[0]) + " " + 
+							std::to_string(blockPosition[1]) + " " + std::to_string(blockPosition[2]);
+					}
+
 					meshBuffers[tex].emplace_back(blockPosition, meshBuffer);
 					if (meshBufferVertices.find(tex) == meshBufferVertices.end())
 					{
 						meshBufferVertices[tex] = 0;
 						meshBufferPrimitives[tex] = 0;
+						meshBufferDepths[tex] = FLT_MAX;
 					}
 					meshBufferVertices[tex] += meshBuffer->GetVertice()->GetNumElements();
 					meshBufferPrimitives[tex] += meshBuffer->GetIndice()->GetNumPrimitives();
+					meshBufferDepths[tex] = std::min(meshBufferDepths[tex], blockDepths[blockPosition]);
 				}
 			}
 
@@ -526,13 +653,17 @@ void VisualMap::UpdateDrawList()
 					textureArray, samplerfilter, samplerModeU, samplerModeV);
 
 				// Create the geometric object for drawing.
-				mDrawVisuals.Add(std::make_shared<Visual>(vBuffer, iBuffer, effect), bufferList.material, layer);
+				mDrawVisuals.Add(std::make_shared<Visual>(vBuffer, iBuffer, effect), 
+					bufferList.material, layer, meshBufferDepths[it->first]);
 			}
 		}
 	}
 
-	Profiling->Avg("MapBlock meshes in range [#]", (float)blocksInRangeWithMesh);
-    Profiling->Avg("MapBlocks occlusion culled [#]", (float)blocksOcclusionCulled);
+	// Number of blocks currently loaded by the visual
+	unsigned int blocksLoaded = 0;
+	for (const auto& sectorIt : mSectors)
+		blocksLoaded += sectorIt.second->Size();
+
     Profiling->Avg("MapBlocks drawn [#]", (float)mDrawBlocks.size());
     Profiling->Avg("MapBlocks loaded [#]", (float)blocksLoaded);
 }
@@ -577,27 +708,18 @@ bool VisualMap::Render(Scene* pScene)
 					return true;
 				}
 
-				auto blendState = std::make_shared<BlendState>();
-				auto depthStencilState = std::make_shared<DepthStencilState>();
-				auto rasterizerState = std::make_shared<RasterizerState>();
-				if (material->Update(blendState))
-					Renderer::Get()->Unbind(blendState);
-				if (material->Update(depthStencilState))
-					Renderer::Get()->Unbind(depthStencilState);
-				if (material->Update(rasterizerState))
-					Renderer::Get()->Unbind(rasterizerState);
-
-				Renderer::Get()->SetBlendState(blendState);
-				Renderer::Get()->SetDepthStencilState(depthStencilState);
-				Renderer::Get()->SetRasterizerState(rasterizerState);
+				if (material->Update(visualData.blendState))
+					Renderer::Get()->Unbind(visualData.blendState);
+				if (material->Update(visualData.depthStencilState))
+					Renderer::Get()->Unbind(visualData.depthStencilState);
+				if (material->Update(visualData.rasterizerState))
+					Renderer::Get()->Unbind(visualData.rasterizerState);
 
 				UpdateShaderConstants(visualData.visual, pScene);
 
-				Renderer::Get()->Draw(visualData.visual);
-
-				Renderer::Get()->SetDefaultBlendState();
-				Renderer::Get()->SetDefaultDepthStencilState();
-				Renderer::Get()->SetDefaultRasterizerState();
+				pScene->GetRenderQueue()->Add(visualData.visual, visualData.blendState,
+					visualData.depthStencilState, visualData.rasterizerState, 
+					visualData.depth, layer, isTransparentPass);
 
 				drawVertexCount += visualData.visual->GetVertexBuffer()->GetNumElements();
 				drawcallCount++;
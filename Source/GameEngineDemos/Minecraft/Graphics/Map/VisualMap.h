@@ -41,6 +41,13 @@ struct VisualData
 {
     std::shared_ptr<Material> material;
     std::shared_ptr<Visual> visual;
+
+    std::shared_ptr<BlendState> blendState;
+    std::shared_ptr<DepthStencilState> depthStencilState;
+    std::shared_ptr<RasterizerState> rasterizerState;
+
+    // camera space depth of the nearest block in the visual
+    float depth;
 };
 
 struct VisualLayerList
@@ -53,7 +60,7 @@ struct VisualLayerList
     std::vector<VisualData> visualLayers[MAX_TILE_LAYERS];
 
     void Clear();
-    void Add(std::shared_ptr<Visual> visual, const std::shared_ptr<Material>& material, uint8_t layer);
+    void Add(std::shared_ptr<Visual> visual, const std::shared_ptr<Material>& material, uint8_t layer, float depth);
 };
 
 struct MeshBufferList
@@ -125,6 +132,11 @@ public:
     void GetBlocksInViewRange(Vector3<short> camPosNodes,
         Vector3<short>* pBlocksMin, Vector3<short>* pBlocksMax);
     void UpdateDrawList();
+    // Forces the next UpdateDrawList() to select the blocks again
+    void InvalidateDrawList() { mDrawListValid = false; }
+    // Keeps the meshed blocks in view range from being unloaded,
+    // including the ones the draw list doesn't reach
+    void TouchBlocksInRange();
 
     int GetBackgroundBrightness(float maxD, unsigned int daylightFactor,
         int oldvalue, bool* sunlightSeenResult);
@@ -143,6 +155,9 @@ private:
 
     void UpdateShaderConstants(std::shared_ptr<Visual> visual, Scene* pScene);
 
+    void SelectDrawBlocks(Vector3<short> camPosNodes,
+        float cameraFov, float range, bool occlusionCullingEnabled);
+
     std::shared_ptr<VisualEffect> mEffect;
     std::shared_ptr<Visual> mVisual;
 
@@ -160,6 +175,14 @@ private:
     float mCameraFov;
 
 	std::map<Vector3<short>, MapBlock*> mDrawBlocks;
+    // State the blocks in mDrawBlocks were selected with
+    bool mDrawListValid = false;
+    Vector3<short> mDrawListCameraBlock;
+    Vector3<float> mDrawListCameraDirection;
+    Vector3<short> mDrawListCameraOffset;
+    float mDrawListCameraFov = 0.f;
+    float mDrawListRange = 0.f;
+    bool mDrawListOcclusionCulling = true;
     MeshBufferLayerList mDrawMeshes;
     VisualLayerList mDrawVisuals;
 
@@ -26,6 +26,8 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #include "Application/Settings.h"
 
+#include "Core/OS/OS.h"
+
 #include "Core/Utility/Profiler.h"
 
 
@@ -64,18 +66,30 @@ MeshUpdateQueue::~MeshUpdateQueue()
 {
 	MutexAutoLock lock(mMutex);
 
-	for (auto& c : mCache)
-		delete c.second;
+	for (CacheShard& shard : mCache)
+	{
+		MutexAutoLock shardLock(shard.mutex);
+		for (auto& c : shard.blocks)
+		{
+			c.second->refcountFromQueue = 0;
+			delete c.second;
+		}
+	}
 
 	for (QueuedMeshUpdate* q : mQueue)
 		delete q;
 
 }
 
-void MeshUpdateQueue::AddBlock(Map *map, Vector3<short> pos, bool ackBlockToLogic, bool urgent)
+MeshUpdateQueue::CacheShard& MeshUpdateQueue::GetCacheShard(const Vector3<short>& p)
 {
-	MutexAutoLock lock(mMutex);
+	unsigned int hash = (unsigned int)(p[0] * 73856093) ^ 
+		(unsigned int)(p[1] * 19349663) ^ (unsigned int)(p[2] * 83492791);
+	return mCache[hash & (MESH_CACHE_SHARDS - 1)];
+}
 
+void MeshUpdateQueue::AddBlock(Map *map, Vector3<short> pos, bool ackBlockToLogic, bool urgent)
+{
 	CleanupCache();
 
 	/*
@@ -105,6 +119,8 @@ void MeshUpdateQueue::AddBlock(Map *map, Vector3<short> pos, bool ackBlockToLogi
 	Profiling->Avg("MeshUpdateQueue: MapBlocks from cache [%]", 
         100.0f * cacheHitCounter / cachedBlocks.size());
 
+	MutexAutoLock lock(mMutex);
+
 	/*
 		Mark the block as urgent if requested
 	*/
@@ -115,18 +131,18 @@ void MeshUpdateQueue::AddBlock(Map *map, Vector3<short> pos, bool ackBlockToLogi
 		Find if block is already in queue.
 		If it is, update the data and quit.
 	*/
-	for (QueuedMeshUpdate* q : mQueue) 
-    {
-		if (q->position == pos) 
-        {
-			// NOTE: We are not adding a new position to the queue, thus
-			//       refcountFromQueue stays the same.
-			if(ackBlockToLogic)
-				q->ackBlockToLogic = true;
-			q->crackLevel = mEnvironment->GetCrackLevel();
-			q->crackPosition = mEnvironment->GetCrackPosition();
-			return;
-		}
+	auto it = mQueuedBlocks.find(pos);
+	if (it != mQueuedBlocks.end())
+	{
+		// NOTE: We are not adding a new position to the queue, thus
+		//       refcountFromQueue stays the same.
+		QueuedMeshUpdate* q = it->second;
+		if (ackBlockToLogic)
+			q->ackBlockToLogic = true;
+		q->crackLevel = mEnvironment->GetCrackLevel();
+		q->crackPosition = mEnvironment->GetCrackPosition();
+		q->cameraOffset = mCameraOffset;
+		return;
 	}
 
 	/*
@@ -137,40 +153,84 @@ void MeshUpdateQueue::AddBlock(Map *map, Vector3<short> pos, bool ackBlockToLogi
 	q->ackBlockToLogic = ackBlockToLogic;
 	q->crackLevel = mEnvironment->GetCrackLevel();
 	q->crackPosition = mEnvironment->GetCrackPosition();
+	q->cameraOffset = mCameraOffset;
 	mQueue.push_back(q);
+	mQueuedBlocks[pos] = q;
 
 	// This queue entry is a new reference to the cached blocks
 	for (CachedMapBlockData* cachedBlock : cachedBlocks)
+	{
+		MutexAutoLock shardLock(GetCacheShard(cachedBlock->position).mutex);
 		cachedBlock->refcountFromQueue++;
+	}
 }
 
 // Returned pointer must be deleted
 // Returns NULL if queue is empty
 QueuedMeshUpdate* MeshUpdateQueue::Pop()
 {
-	MutexAutoLock lock(mMutex);
+	QueuedMeshUpdate* q = NULL;
+	{
+		MutexAutoLock lock(mMutex);
+
+		// Take the urgent blocks first, then the closest block to the camera. A block which is
+		// being meshed by another worker waits, so that its results keep their order
+		bool bestUrgent = false;
+		int bestDistance = std::numeric_limits<int>::max();
+		size_t best = mQueue.size();
+		for (size_t i = 0; i < mQueue.size(); ++i)
+		{
+			const Vector3<short>& pos = mQueue[i]->position;
+			if (mInflightBlocks.count(pos) != 0)
+				continue;
+
+			bool urgent = mUrgents.count(pos) != 0;
+			if (bestUrgent && !urgent)
+				continue;
+
+			int dx = pos[0] - mCameraBlock[0];
+			int dy = pos[1] - mCameraBlock[1];
+			int dz = pos[2] - mCameraBlock[2];
+			int distance = dx * dx + dy * dy + dz * dz;
+			if ((urgent && !bestUrgent) || distance < bestDistance)
+			{
+				bestUrgent = urgent;
+				bestDistance = distance;
+				best = i;
+			}
+		}
+		if (best == mQueue.size())
+			return NULL;
 
-	bool mustBeUrgent = !mUrgents.empty();
-	for (std::vector<QueuedMeshUpdate*>::iterator i = mQueue.begin(); i != mQueue.end(); ++i) 
-    {
-		QueuedMeshUpdate* q = *i;
-		if(mustBeUrgent && mUrgents.count(q->position) == 0)
-			continue;
-		mQueue.erase(i);
+		q = mQueue[best];
+		mQueue[best] = mQueue.back();
+		mQueue.pop_back();
+		mQueuedBlocks.erase(q->position);
 		mUrgents.erase(q->position);
-		FillDataFromMapBlockCache(q);
-		return q;
+		mInflightBlocks.insert(q->position);
 	}
-	return NULL;
+
+	// The blocks are copied under the locks of their shards only
+	FillDataFromMapBlockCache(q);
+	return q;
+}
+
+void MeshUpdateQueue::Done(const Vector3<short>& pos)
+{
+	MutexAutoLock lock(mMutex);
+	mInflightBlocks.erase(pos);
 }
 
 CachedMapBlockData* MeshUpdateQueue::CacheBlock(Map* map, 
     Vector3<short> pos, UpdateMode mode, size_t* cacheHitCounter)
 {
+	CacheShard& shard = GetCacheShard(pos);
+	MutexAutoLock lock(shard.mutex);
+
 	CachedMapBlockData* cachedBlock = nullptr;
-	std::map<Vector3<short>, CachedMapBlockData*>::iterator it = mCache.find(pos);
+	std::map<Vector3<short>, CachedMapBlockData*>::iterator it = shard.blocks.find(pos);
 
-	if (it != mCache.end()) 
+	if (it != shard.blocks.end()) 
     {
 		cachedBlock = it->second;
 
@@ -186,7 +246,8 @@ CachedMapBlockData* MeshUpdateQueue::CacheBlock(Map* map,
     {
 		// Not yet in cache
 		cachedBlock = new CachedMapBlockData();
-		mCache[pos] = cachedBlock;
+		cachedBlock->position = pos;
+		shard.blocks[pos] = cachedBlock;
 	}
 
 	MapBlock* block = map->GetBlockNoCreateNoEx(pos);
@@ -205,15 +266,6 @@ CachedMapBlockData* MeshUpdateQueue::CacheBlock(Map* map,
 	return cachedBlock;
 }
 
-CachedMapBlockData* MeshUpdateQueue::GetCachedBlock(const Vector3<short>& pos)
-{
-	std::map<Vector3<short>, CachedMapBlockData*>::iterator it = mCache.find(pos);
-	if (it != mCache.end())
-		return it->second;
-
-	return NULL;
-}
-
 void MeshUpdateQueue::FillDataFromMapBlockCache(QueuedMeshUpdate* q)
 {
 	MeshMakeData* data = new MeshMakeData(mEnvironment, mCacheEnableShaders);
@@ -232,9 +284,13 @@ void MeshUpdateQueue::FillDataFromMapBlockCache(QueuedMeshUpdate* q)
             for (dp[2] = -1; dp[2] <= 1; dp[2]++) 
             {
                 Vector3<short> p = q->position + dp;
-                CachedMapBlockData* cachedBlock = GetCachedBlock(p);
-                if (cachedBlock) 
+                CacheShard& shard = GetCacheShard(p);
+                MutexAutoLock lock(shard.mutex);
+
+                std::map<Vector3<short>, CachedMapBlockData*>::iterator it = shard.blocks.find(p);
+                if (it != shard.blocks.end()) 
                 {
+                    CachedMapBlockData* cachedBlock = it->second;
                     cachedBlock->refcountFromQueue--;
                     cachedBlock->lastUsedTimestamp = tNow;
                     if (cachedBlock->data)
@@ -250,67 +306,143 @@ void MeshUpdateQueue::FillDataFromMapBlockCache(QueuedMeshUpdate* q)
 
 void MeshUpdateQueue::CleanupCache()
 {
+	size_t cacheSize = 0;
+	for (CacheShard& shard : mCache)
+	{
+		MutexAutoLock lock(shard.mutex);
+		cacheSize += shard.blocks.size();
+	}
+
 	const int mapBlockKB = MAP_BLOCKSIZE * MAP_BLOCKSIZE * MAP_BLOCKSIZE * sizeof(MapNode) / 1000;
-	Profiling->Avg("MeshUpdateQueue MapBlock cache size kB", (float)(mapBlockKB * mCache.size()));
+	Profiling->Avg("MeshUpdateQueue MapBlock cache size kB", (float)(mapBlockKB * cacheSize));
 
 	// The cache size is kept roughly below cacheSoftMaxSize, not letting
 	// anything get older than cacheSecondsMax or deleted before 2 seconds.
 	const int cacheSecondsMax = 10;
 	const int cacheSoftMaxSize = mMeshGeneratorBlockCacheSize * 1000 / mapBlockKB;
 	int cacheSeconds = std::max(2, cacheSecondsMax -
-			(int)mCache.size() / (cacheSoftMaxSize / cacheSecondsMax));
+			(int)cacheSize / (cacheSoftMaxSize / cacheSecondsMax));
 
 	int tNow = (int)time(0);
-    std::map<Vector3<short>, CachedMapBlockData*>::iterator it;
-	for (it = mCache.begin(); it != mCache.end(); ) 
-    {
-		CachedMapBlockData *cachedBlock = it->second;
-		if (cachedBlock->refcountFromQueue == 0 &&
-            cachedBlock->lastUsedTimestamp < tNow - cacheSeconds)
-        {
-			mCache.erase(it++);
-			delete cachedBlock;
+	for (CacheShard& shard : mCache)
+	{
+		MutexAutoLock lock(shard.mutex);
+
+		std::map<Vector3<short>, CachedMapBlockData*>::iterator it;
+		for (it = shard.blocks.begin(); it != shard.blocks.end(); )
+		{
+			CachedMapBlockData *cachedBlock = it->second;
+			if (cachedBlock->refcountFromQueue == 0 &&
+				cachedBlock->lastUsedTimestamp < tNow - cacheSeconds)
+			{
+				shard.blocks.erase(it++);
+				delete cachedBlock;
+			}
+			else ++it;
 		}
-        else ++it;
 	}
 }
 
 /*
-	MeshUpdateThread
+	MeshUpdateWorkerThread
 */
 
-MeshUpdateThread::MeshUpdateThread(VisualEnvironment* env) : UpdateThread("Mesh"), mQueueIn(env)
+MeshUpdateWorkerThread::MeshUpdateWorkerThread(MeshUpdateQueue* queueIn, MeshUpdateManager* manager) 
+	: UpdateThread("Mesh"), mQueueIn(queueIn), mManager(manager)
 {
 	mGenerationInterval = Settings::Get()->GetUInt16("mesh_generation_interval");
 	mGenerationInterval = std::clamp(mGenerationInterval, 0, 50);
 }
 
-void MeshUpdateThread::UpdateBlock(Map* map, Vector3<short> pos, bool ackBlockToLogic, bool urgent)
-{
-	// Allow the MeshUpdateQueue to do whatever it wants
-	mQueueIn.AddBlock(map, pos, ackBlockToLogic, urgent);
-	DeferUpdate();
-}
-
-void MeshUpdateThread::DoUpdate()
+void MeshUpdateWorkerThread::DoUpdate()
 {
 	QueuedMeshUpdate* q;
-	while ((q = mQueueIn.Pop())) 
+	while (!StopRequested() && (q = mQueueIn->Pop()))
     {
 		if (mGenerationInterval)
 			Sleep(mGenerationInterval);
 		ScopeProfiler sp(Profiling, "Mesh making (sum)");
 
 		std::shared_ptr<MapBlockMesh> meshNew = 
-            std::make_shared<MapBlockMesh>(q->data, mCameraOffset);
+            std::make_shared<MapBlockMesh>(q->data, q->cameraOffset);
 
 		MeshUpdateResult r;
 		r.position = q->position;
 		r.mesh = meshNew;
 		r.ackBlockToLogic = q->ackBlockToLogic;
 
-		mQueueOut.PushBack(r);
+		mManager->PushResult(r, this);
+		mQueueIn->Done(q->position);
 
 		delete q;
 	}
 }
+
+/*
+	MeshUpdateManager
+*/
+
+MeshUpdateManager::MeshUpdateManager(VisualEnvironment* env) : mQueueIn(env), mQueueOut(1024)
+{
+	// Keep a core for the main thread and one for the logic
+	int numThreads = Settings::Get()->Exists("mesh_generation_threads") ?
+		Settings::Get()->GetInt("mesh_generation_threads") : 0;
+	if (numThreads <= 0)
+		numThreads = (int)Thread::GetNumberOfProcessors() - 2;
+	numThreads = std::clamp(numThreads, 1, 8);
+
+	for (int i = 0; i < numThreads; i++)
+		mWorkers.push_back(std::make_unique<MeshUpdateWorkerThread>(&mQueueIn, this));
+}
+
+MeshUpdateManager::~MeshUpdateManager()
+{
+	Stop();
+	Wait();
+}
+
+void MeshUpdateManager::UpdateBlock(Map* map, Vector3<short> pos, bool ackBlockToLogic, bool urgent)
+{
+	// Allow the MeshUpdateQueue to do whatever it wants
+	mQueueIn.AddBlock(map, pos, ackBlockToLogic, urgent);
+	for (auto& worker : mWorkers)
+		worker->DeferUpdate();
+}
+
+void MeshUpdateManager::PushResult(const MeshUpdateResult& result, MeshUpdateWorkerThread* worker)
+{
+	// The main thread drains the results every frame, the mesh is dropped on shutdown
+	while (!mQueueOut.Push(result))
+	{
+		if (worker->StopRequested())
+			return;
+		Timer::Sleep(1);
+	}
+}
+
+void MeshUpdateManager::Start()
+{
+	for (auto& worker : mWorkers)
+		worker->Start();
+}
+
+void MeshUpdateManager::Stop()
+{
+	for (auto& worker : mWorkers)
+		worker->Stop();
+}
+
+void MeshUpdateManager::Wait()
+{
+	for (auto& worker : mWorkers)
+		worker->Wait();
+}
+
+bool MeshUpdateManager::IsRunning()
+{
+	for (auto& worker : mWorkers)
+		if (worker->IsRunning())
+			return true;
+
+	return false;
+}
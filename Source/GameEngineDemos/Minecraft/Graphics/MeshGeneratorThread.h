@@ -25,9 +25,13 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #include "Map/MapBlockMesh.h"
 
+#include "Core/Threading/MpscQueue.h"
 #include "Core/Threading/MutexAutolock.h"
 #include "Core/Threading/Thread.h"
 
+// number of shards of the block cache, must be a power of two
+#define MESH_CACHE_SHARDS 16
+
 struct CachedMapBlockData
 {
     Vector3<short> position = Vector3<short>{ -1337, -1337, -1337 };
@@ -45,6 +49,7 @@ struct QueuedMeshUpdate
 	bool ackBlockToLogic = false;
 	int crackLevel = -1;
 	Vector3<short> crackPosition = Vector3<short>::Zero();
+	Vector3<short> cameraOffset = Vector3<short>::Zero();
 	MeshMakeData* data = nullptr; // This is generated in MeshUpdateQueue::Pop()
 
 	QueuedMeshUpdate() = default;
@@ -52,7 +57,12 @@ struct QueuedMeshUpdate
 };
 
 /*
-	A thread-safe queue of mesh update tasks and a cache of MapBlock data
+	A thread-safe queue of mesh update tasks and a cache of MapBlock data.
+	A position is queued at most once and is never given to two workers at the same time.
+	The workers take the urgent blocks first, then the blocks closest to the camera.
+	The block cache is split in shards by position, each with its own mutex, so that the
+	workers copying the blocks of their meshes and the map thread caching new blocks rarely
+	wait on each other.
 */
 class MeshUpdateQueue
 {
@@ -75,6 +85,22 @@ public:
 	// Returns NULL if queue is empty
 	QueuedMeshUpdate* Pop();
 
+	// Releases a block returned by Pop() once its mesh is done
+	void Done(const Vector3<short>& pos);
+
+	void SetCameraBlock(const Vector3<short>& pos)
+	{
+		MutexAutoLock lock(mMutex);
+		mCameraBlock = pos;
+	}
+
+	// Queued updates are meshed relative to the offset current when they were added
+	void SetCameraOffset(const Vector3<short>& offset)
+	{
+		MutexAutoLock lock(mMutex);
+		mCameraOffset = offset;
+	}
+
 	unsigned int Size()
 	{
 		MutexAutoLock lock(mMutex);
@@ -83,21 +109,32 @@ public:
 
 private:
 
+	struct CacheShard
+	{
+		std::map<Vector3<short>, CachedMapBlockData*> blocks;
+		std::mutex mutex;
+	};
+
     VisualEnvironment* mEnvironment;
 
 	std::vector<QueuedMeshUpdate*> mQueue;
+	std::map<Vector3<short>, QueuedMeshUpdate*> mQueuedBlocks;
     std::set<Vector3<short>> mUrgents;
-    std::map<Vector3<short>, CachedMapBlockData*> mCache;
+	std::set<Vector3<short>> mInflightBlocks;
+	Vector3<short> mCameraBlock = Vector3<short>::Zero();
+	Vector3<short> mCameraOffset = Vector3<short>::Zero();
 	std::mutex mMutex;
 
+	CacheShard mCache[MESH_CACHE_SHARDS];
+
 	// TODO: Add callback to update these when g_settings changes
 	bool mCacheEnableShaders;
 	bool mCacheSmoothLighting;
 	int mMeshGeneratorBlockCacheSize;
 
+	CacheShard& GetCacheShard(const Vector3<short>& p);
 	CachedMapBlockData* CacheBlock(Map* map, Vector3<short> pos, 
         UpdateMode mode, size_t* cacheHitCounter = NULL);
-	CachedMapBlockData* GetCachedBlock(const Vector3<short>& p);
 	void FillDataFromMapBlockCache(QueuedMeshUpdate* q);
 	void CleanupCache();
 };
@@ -111,27 +148,64 @@ struct MeshUpdateResult
 	MeshUpdateResult() = default;
 };
 
-class MeshUpdateThread : public UpdateThread
+class MeshUpdateManager;
+
+class MeshUpdateWorkerThread : public UpdateThread
+{
+public:
+	MeshUpdateWorkerThread(MeshUpdateQueue* queueIn, MeshUpdateManager* manager);
+
+protected:
+	virtual void DoUpdate();
+
+private:
+
+	MeshUpdateQueue* mQueueIn;
+	MeshUpdateManager* mManager;
+
+	// TODO: Add callback to update these when g_settings changes
+	int mGenerationInterval;
+};
+
+/*
+	Builds the MapBlock meshes on a pool of worker threads. The number of workers is
+	given by the "mesh_generation_threads" setting, zero picks it from the number of
+	processors. The finished meshes are handed to the main thread through a lock free
+	queue.
+*/
+class MeshUpdateManager
 {
 public:
-	MeshUpdateThread(VisualEnvironment* env);
+	MeshUpdateManager(VisualEnvironment* env);
+
+	~MeshUpdateManager();
 
 	// Caches the block at p and its neighbors (if needed) and queues a mesh
 	// update for the block at p
 	void UpdateBlock(Map* map, Vector3<short> pos, bool ackBlockToLogic, bool urgent);
 
-	Vector3<short> mCameraOffset = Vector3<short>::Zero();
-	MutexedQueue<MeshUpdateResult> mQueueOut;
+	// Blocks closer to this one are meshed first
+	void SetCameraBlock(const Vector3<short>& pos) { mQueueIn.SetCameraBlock(pos); }
+
+	void SetCameraOffset(const Vector3<short>& offset) { mQueueIn.SetCameraOffset(offset); }
+
+	// Called by the workers, waits while the main thread is behind on the results
+	void PushResult(const MeshUpdateResult& result, MeshUpdateWorkerThread* worker);
+
+	// Called by the main thread, returns false when there is no mesh ready
+	bool GetNextResult(MeshUpdateResult& result) { return mQueueOut.TryPop(result); }
+
+	void Start();
+	void Stop();
+	void Wait();
+	bool IsRunning();
 
 private:
 
 	MeshUpdateQueue mQueueIn;
+	MpscQueue<MeshUpdateResult> mQueueOut;
 
-	// TODO: Add callback to update these when g_settings changes
-	int mGenerationInterval;
-
-protected:
-	virtual void DoUpdate();
+	std::vector<std::unique_ptr<MeshUpdateWorkerThread>> mWorkers;
 };
 
 #endif
\ No newline at end of file
@@ -1023,6 +1023,7 @@ void NodeManager::Clear()
     mNextId = 0;
     mSelectionBoxUnion.Reset(0, 0, 0);
     mSelectionBoxIntUnion.Reset(0, 0, 0);
+    mDefinitionsVersion++;
 
     ResetNodeResolveState();
 
@@ -1325,6 +1326,7 @@ uint16_t NodeManager::Set(const std::string& name, const ContentFeatures& cFeatu
         EraseIdFromGroups(id);
 
     mContentFeatures[id] = cFeatures;
+    mDefinitionsVersion++;
     LogInformation("NodeManager: registering content id \"" + 
         std::to_string(id) + "\": name=\"" + cFeatures.name + "\"");
 
@@ -1365,6 +1367,7 @@ void NodeManager::RemoveNode(const std::string& name)
     }
 
     EraseIdFromGroups(id);
+    mDefinitionsVersion++;
 }
 
 
@@ -1380,6 +1383,7 @@ void NodeManager::UpdateAliases(BaseItemManager* itemMgr)
         if (mNameId.GetId(convertTo, id)) 
             mNameIdWithAliases.insert(std::make_pair(name, id));
     }
+    mDefinitionsVersion++;
 }
 
 void NodeManager::ApplyTextureOverrides(const std::vector<TextureOverride>& overrides)
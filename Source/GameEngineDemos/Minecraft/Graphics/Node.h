@@ -576,6 +576,16 @@ public:
      */
     bool GetIds(const std::string& name, std::vector<uint16_t>& result) const;
 
+    /*!
+     * Returns a counter which changes whenever the node definitions, names,
+     * aliases or groups change, so that content IDs resolved from names can
+     * be cached until then.
+     */
+    inline unsigned int GetDefinitionsVersion() const
+    {
+        return mDefinitionsVersion;
+    }
+
     /*!
      * Returns the smallest box in integer node coordinates that
      * contains all nodes' selection boxes. The returned box might be larger
@@ -771,6 +781,9 @@ private:
     //! True if all nodes have been registered.
     bool mNodeRegistrationComplete;
 
+    //! Changed by every modification of the definitions, see \ref GetDefinitionsVersion().
+    unsigned int mDefinitionsVersion = 0;
+
     /*!
      * The union of all nodes' selection boxes.
      * Might be larger if big nodes are removed from the manager.
@@ -19,7 +19,6 @@ ObjectMeshNode::ObjectMeshNode(const ActorId actorId, unsigned int shaderId,
 {
 	mPVWUpdater = updater;
 
-	mRasterizerState = std::make_shared<RasterizerState>();
 
 	SetMesh(mesh);
 }
@@ -47,6 +46,7 @@ void ObjectMeshNode::SetMesh(const std::shared_ptr<BaseMesh>& mesh)
 	mVisuals.clear();
 	mBlendStates.clear();
 	mDepthStencilStates.clear();
+	mRasterizerStates.clear();
 	for (unsigned int i = 0; i < meshBuffers.size(); ++i)
 	{
 		const std::shared_ptr<BaseMeshBuffer>& meshBuffer = meshBuffers[i];
@@ -54,6 +54,7 @@ void ObjectMeshNode::SetMesh(const std::shared_ptr<BaseMesh>& mesh)
 		{
 			mBlendStates.push_back(std::make_shared<BlendState>());
 			mDepthStencilStates.push_back(std::make_shared<DepthStencilState>());
+			mRasterizerStates.push_back(std::make_shared<RasterizerState>());
 
 			std::shared_ptr<Texture2> textureDiffuse = meshBuffer->GetMaterial()->GetTexture(TT_DIFFUSE);
 			if (!textureDiffuse)
@@ -148,21 +149,14 @@ bool ObjectMeshNode::Render(Scene *pScene)
 				Renderer::Get()->Unbind(mBlendStates[i]);
 			if (GetMaterial(i)->Update(mDepthStencilStates[i]))
 				Renderer::Get()->Unbind(mDepthStencilStates[i]);
-			if (GetMaterial(i)->Update(mRasterizerState))
-				Renderer::Get()->Unbind(mRasterizerState);
-
-			Renderer::Get()->SetBlendState(mBlendStates[i]);
-			Renderer::Get()->SetDepthStencilState(mDepthStencilStates[i]);
-			Renderer::Get()->SetRasterizerState(mRasterizerState);
+			if (GetMaterial(i)->Update(mRasterizerStates[i]))
+				Renderer::Get()->Unbind(mRasterizerStates[i]);
 
 			UpdateShaderConstants(i, pScene);
 
 			Renderer::Get()->Update(mVisuals[i]->GetVertexBuffer());
-			Renderer::Get()->Draw(mVisuals[i]);
-
-			Renderer::Get()->SetDefaultBlendState();
-			Renderer::Get()->SetDefaultDepthStencilState();
-			Renderer::Get()->SetDefaultRasterizerState();
+			pScene->GetRenderQueue()->Add(mVisuals[i], mBlendStates[i], mDepthStencilStates[i],
+				mRasterizerStates[i], pScene->GetCameraDepth(this), 0, transparent);
 		}
 	}
 
@@ -254,7 +254,7 @@ unsigned int ShaderSource::GetShader(const std::string& name,
 
 	// We're gonna ask the result to be put into here
 
-	static ResultQueue<std::string, unsigned int, uint8_t, uint8_t> resultQueue;
+	static thread_local ResultQueue<std::string, unsigned int, uint8_t, uint8_t> resultQueue;
 
 	// Throw a request in
 	mGetShaderQueue.Add(name, 0, 0, &resultQueue);
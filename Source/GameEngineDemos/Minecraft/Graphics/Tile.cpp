@@ -335,7 +335,7 @@ unsigned int TextureSource::GetTextureId(const std::string& name)
 	LogInformation("GetTextureId(): Queued: name=\"" + name + "\"");
 
 	// We're gonna ask the result to be put into here
-	static ResultQueue<std::string, unsigned int, uint8_t, uint8_t> resultQueue;
+	static thread_local ResultQueue<std::string, unsigned int, uint8_t, uint8_t> resultQueue;
 
 	// Throw a request in
 	mGetTextureQueue.Add(name, 0, 0, &resultQueue);
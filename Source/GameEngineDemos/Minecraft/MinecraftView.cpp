@@ -1477,6 +1477,11 @@ MinecraftHumanView::MinecraftHumanView() : HumanView()
         Settings::Get()->RegisterChangedCallback(name,
             &MinecraftHumanView::SettingsChangedCallback, &mGameSettings);
     }
+
+    // The scopes are captured until shutdown, when they are written as a chrome trace
+    if (Settings::Get()->Exists("profiler_trace_file") &&
+        !Settings::Get()->Get("profiler_trace_file").empty())
+        ProfileTrace::Get()->StartCapture();
 }
 
 
@@ -1691,6 +1696,10 @@ void MinecraftHumanView::Step(float dTime)
         const float mapTimerAndUnloadDeltaTime = 5.25;
         if (mMapTimerAndUnloadInterval.Step(dTime, mapTimerAndUnloadDeltaTime))
         {
+            // The draw list only reaches the visible blocks, the rest
+            // of the view range has to stay loaded as well.
+            mEnvironment->GetVisualMap()->TouchBlocksInRange();
+
             std::vector<Vector3<short>> deletedBlocks;
             mEnvironment->GetMap()->TimerUpdate(mapTimerAndUnloadDeltaTime,
                 Settings::Get()->GetFloat("client_unload_unused_data_timeout"),
@@ -1797,14 +1806,14 @@ void MinecraftHumanView::Step(float dTime)
         {
             int numProcessedMeshes = 0;
             std::vector<Vector3<short>> blocksToAck;
-            while (!mEnvironment->mMeshUpdateThread.mQueueOut.Empty())
+            MeshUpdateResult r;
+            while (mEnvironment->mMeshUpdateManager.GetNextResult(r))
             {
                 numProcessedMeshes++;
 
                 MinimapMapblock *minimapMapBlock = NULL;
                 bool doMapperUpdate = true;
 
-                MeshUpdateResult r = mEnvironment->mMeshUpdateThread.mQueueOut.PopFrontNoEx();
                 MapBlock* block = mEnvironment->GetMap()->GetBlockNoCreateNoEx(r.position);
                 if (block)
                 {
@@ -1817,6 +1826,9 @@ void MinecraftHumanView::Step(float dTime)
                         if (minimapMapBlock == NULL)
                             doMapperUpdate = false;
 
+                        // Kept even if the mesh is empty, solid blocks have no faces
+                        block->SetFaceConnections(r.mesh->GetFaceConnections());
+
                         bool isEmpty = true;
                         for (int l = 0; l < MAX_TILE_LAYERS; l++)
                             if (r.mesh->GetMesh(l)->GetMeshBufferCount() != 0)
@@ -1855,7 +1867,10 @@ void MinecraftHumanView::Step(float dTime)
             }
 
             if (numProcessedMeshes > 0)
+            {
                 Profiling->GraphAdd("numProcessedMeshes", (float)numProcessedMeshes);
+                mEnvironment->GetVisualMap()->InvalidateDrawList();
+            }
         }
 
         /*
@@ -2219,6 +2234,8 @@ void MinecraftHumanView::SendPlayerPosition()
 void MinecraftHumanView::UpdateProfilers(
     const RunStats& stats, const FpsControl& updateTimes, float dTime)
 {
+    ProfileTrace::Get()->MarkFrame();
+
     float profilerPrintInterval = Settings::Get()->GetFloat("profiler_print_interval");
     bool printToLog = true;
 
@@ -2404,9 +2421,9 @@ void MinecraftHumanView::AfterContentReceived()
     textureUpdateArgs.textBase = L"Initializing nodes";
     mEnvironment->GetNodeManager()->UpdateTextures(mEnvironment.get(), TextureUpdateProgress, &textureUpdateArgs);
 
-    // Start mesh update thread after setting up content definitions
-    LogInformation("- Starting mesh update thread");
-    mEnvironment->mMeshUpdateThread.Start();
+    // Start mesh update threads after setting up content definitions
+    LogInformation("- Starting mesh update threads");
+    mEnvironment->mMeshUpdateManager.Start();
 
     text = L"Done!";
     DrawLoadScreen(text, mGameUI, mClouds, mVisual, mBlendState, mTextureSrc.get(), mCloudMgr.get(), 0, 100);
@@ -3944,9 +3961,9 @@ void MinecraftHumanView::HandleNodesDelegate(BaseEventDataPtr pEventData)
 
     LogInformation("Received node definitions:");
 
-    // Mesh update thread must be stopped while
+    // Mesh update threads must be stopped while
     // updating content definitions
-    LogAssert(!mEnvironment->mMeshUpdateThread.IsRunning(), "mesh update thread must be stopped");
+    LogAssert(!mEnvironment->mMeshUpdateManager.IsRunning(), "mesh update threads must be stopped");
 
     // Deserialize node definitions
     std::istringstream is(os.str());
@@ -3973,9 +3990,9 @@ void MinecraftHumanView::HandleItemsDelegate(BaseEventDataPtr pEventData)
 
         //LogInformation("Received item definitions: packet size: " + pkt->getSize());
 
-    // Mesh update thread must be stopped while
+    // Mesh update threads must be stopped while
     // updating content definitions
-    LogAssert(!mEnvironment->mMeshUpdateThread.IsRunning(), "mesh update thread must be stopped");
+    LogAssert(!mEnvironment->mMeshUpdateManager.IsRunning(), "mesh update threads must be stopped");
 
     // Decompress item definitions
     std::istringstream is(os.str());
@@ -4023,9 +4040,9 @@ void MinecraftHumanView::HandleMediaDelegate(BaseEventDataPtr pEventData)
     std::shared_ptr<EventDataHandleMedia> pCastEventData =
         std::static_pointer_cast<EventDataHandleMedia>(pEventData);
 
-    // Mesh update thread must be stopped while
+    // Mesh update threads must be stopped while
     // updating content definitions
-    LogAssert(!mEnvironment->mMeshUpdateThread.IsRunning(), "mesh update thread must be stopped");
+    LogAssert(!mEnvironment->mMeshUpdateManager.IsRunning(), "mesh update threads must be stopped");
 
     // Check media cache
     for (auto media : pCastEventData->GetMedia())
@@ -4936,6 +4953,17 @@ void MinecraftHumanView::Shutdown()
         }
     }
 
+    if (ProfileTrace::Get()->IsCapturing())
+    {
+        ProfileTrace::Get()->StopCapture();
+        ProfileTrace::Get()->ExportChromeTrace(Settings::Get()->Get("profiler_trace_file"));
+
+        std::stringstream infostream;
+        infostream << "Profiler summary:" << std::endl;
+        ProfileTrace::Get()->PrintSummary(infostream);
+        LogInformation(infostream.str());
+    }
+
     ExtendedResourceCleanup();
 }
 
@@ -5555,6 +5583,8 @@ void MinecraftHumanView::UpdatePlayerCamera(unsigned int busyTime, float dTime)
     if (!mFlags.disableCameraUpdate) 
     {
         mEnvironment->GetVisualMap()->UpdateCamera(cameraPosition, cameraDirection, cameraFov, cameraOffset);
+        mEnvironment->mMeshUpdateManager.SetCameraBlock(
+            GetNodeBlockPosition(FloatToInt(cameraPosition, BS)));
         if (mCameraOffsetChanged) 
         {
             mEnvironment->UpdateCameraOffset(cameraOffset);
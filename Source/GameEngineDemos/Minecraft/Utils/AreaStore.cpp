@@ -19,11 +19,12 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #include "AreaStore.h"
 
+#include "Core/Logger/Logger.h"
 #include "Core/Utility/Serialize.h"
 
 AreaStore* AreaStore::GetOptimalImplementation()
 {
-	return new VectorAreaStore();
+	return new SpatialAreaStore();
 }
 
 const Area* AreaStore::GetArea(const std::string& name) const
@@ -62,18 +63,27 @@ AreaParseEvent AreaStore::ParseObject(const std::string& line, std::string& name
 }
 
 
+void AreaStore::InsertAreas(std::vector<Area>& areas)
+{
+	for (Area& area : areas)
+		InsertArea(&area);
+}
+
 void AreaStore::Serialize(std::ostream& os) const
 {
-	/*
 	for (const auto& it : mAreasMap)
 	{
-		const Area& a = it.second;
-		WriteV3Short(os, a.minEdge);
-		WriteV3Short(os, a.maxEdge);
-		WriteUInt16(os, a.data.size());
-		os.write(a.data.data(), a.data.size());
+		const Area& area = it.second;
+		const Vector3<short>& minEdge = area.box.mMinEdge;
+		const Vector3<short>& maxEdge = area.box.mMaxEdge;
+		os << "{\n";
+		os << "\tname = " << area.name << "\n";
+		os << "\towner = " << area.owner << "\n";
+		os << "\thidden = " << (area.hidden ? "true" : "false") << "\n";
+		os << "\tpos1 = (" << minEdge[0] << "," << minEdge[1] << "," << minEdge[2] << ")\n";
+		os << "\tpos2 = (" << maxEdge[0] << "," << maxEdge[1] << "," << maxEdge[2] << ")\n";
+		os << "}\n";
 	}
-	*/
 }
 
 void AreaStore::Deserialize(std::istream& is)
@@ -95,6 +105,9 @@ void AreaStore::Deserialize(std::istream& is)
             case APE_COMMENT:
                 break;
             case APE_KVPAIR:
+				if (areas.empty())
+					break;
+
 				area = &areas.back();
 				if (name == "name")
 					area->name = value;
@@ -133,8 +146,10 @@ void AreaStore::Deserialize(std::istream& is)
         }
     }
 
-	for (auto area : areas)
-		InsertArea(&area);
+	// pos1 and pos2 may be any two opposite corners
+	for (Area& area : areas)
+		SortBoxVertices(area.box.mMinEdge, area.box.mMaxEdge);
+	InsertAreas(areas);
 }
 
 void AreaStore::InvalidateCache()
@@ -241,4 +256,456 @@ void VectorAreaStore::GetAreasInArea(std::vector<Area*>* result,
 	for (Area* area : mAreas) 
 		if (acceptOverlap ? area->box.Intersect(box) : area->box.IsFullInside(box))
 			result->push_back(area);
+}
+
+
+////
+// SpatialAreaStore
+////
+
+static int64_t GetBoxVolume(const BoundingBox<short>& box)
+{
+	return (int64_t)(box.mMaxEdge[0] - box.mMinEdge[0] + 1) *
+		(int64_t)(box.mMaxEdge[1] - box.mMinEdge[1] + 1) *
+		(int64_t)(box.mMaxEdge[2] - box.mMinEdge[2] + 1);
+}
+
+static int64_t GetBoxMargin(const BoundingBox<short>& box)
+{
+	return (int64_t)(box.mMaxEdge[0] - box.mMinEdge[0]) +
+		(int64_t)(box.mMaxEdge[1] - box.mMinEdge[1]) +
+		(int64_t)(box.mMaxEdge[2] - box.mMinEdge[2]);
+}
+
+static int64_t GetOverlapVolume(const BoundingBox<short>& a, const BoundingBox<short>& b)
+{
+	int64_t volume = 1;
+	for (int i = 0; i < 3; i++)
+	{
+		int extent = std::min(a.mMaxEdge[i], b.mMaxEdge[i]) - std::max(a.mMinEdge[i], b.mMinEdge[i]) + 1;
+		if (extent <= 0)
+			return 0;
+		volume *= extent;
+	}
+	return volume;
+}
+
+static BoundingBox<short> GetUnionBox(const BoundingBox<short>& a, const BoundingBox<short>& b)
+{
+	BoundingBox<short> box(a);
+	box.GrowToContain(b);
+	return box;
+}
+
+SpatialAreaStore::SpatialAreaStore() : mRoot(new Node())
+{
+}
+
+SpatialAreaStore::~SpatialAreaStore()
+{
+	DeleteNode(mRoot);
+}
+
+BoundingBox<short> SpatialAreaStore::GetNodeBox(const Node* node)
+{
+	BoundingBox<short> box(node->entries[0].box);
+	for (unsigned int i = 1; i < node->count; i++)
+		box.GrowToContain(node->entries[i].box);
+	return box;
+}
+
+bool SpatialAreaStore::InsertArea(Area* area)
+{
+	std::pair<AreaMap::iterator, bool> res =
+		mAreasMap.insert(std::make_pair(area->name, *area));
+	if (!res.second)
+	{
+		// ID is not unique
+		return false;
+	}
+
+	InsertLeafEntry(&res.first->second);
+	InvalidateCache();
+	return true;
+}
+
+void SpatialAreaStore::InsertAreas(std::vector<Area>& areas)
+{
+	for (Area& area : areas)
+		mAreasMap.insert(std::make_pair(area.name, area));
+
+	// repacking everything gives a better tree than inserting one by one
+	BulkLoad();
+	InvalidateCache();
+}
+
+bool SpatialAreaStore::RemoveArea(const std::string& name)
+{
+	AreaMap::iterator it = mAreasMap.find(name);
+	if (it == mAreasMap.end())
+		return false;
+
+	std::vector<Area*> orphans;
+	if (!RemoveEntry(mRoot, &it->second, orphans))
+		LogWarning("SpatialAreaStore: area " + name + " not found in tree");
+
+	// shrink the tree while the root has a single child
+	while (mRoot->level > 0 && mRoot->count <= 1)
+	{
+		Node* root = mRoot;
+		if (root->count == 0)
+		{
+			root->level = 0;
+			break;
+		}
+		mRoot = root->entries[0].child;
+		root->count = 0;
+		DeleteNode(root);
+	}
+
+	// put back the areas of the nodes that fell below the minimum fill
+	for (Area* area : orphans)
+		InsertLeafEntry(area);
+
+	mAreasMap.erase(it);
+	InvalidateCache();
+	return true;
+}
+
+void SpatialAreaStore::InsertLeafEntry(Area* area)
+{
+	Entry entry;
+	entry.box = area->box;
+	entry.area = area;
+	Node* sibling = InsertEntry(mRoot, entry, 0);
+	if (sibling)
+	{
+		// the root was split, grow the tree by one level
+		Node* root = new Node();
+		root->level = mRoot->level + 1;
+		root->count = 2;
+		root->entries[0].box = GetNodeBox(mRoot);
+		root->entries[0].child = mRoot;
+		root->entries[1].box = GetNodeBox(sibling);
+		root->entries[1].child = sibling;
+		mRoot = root;
+	}
+}
+
+SpatialAreaStore::Node* SpatialAreaStore::InsertEntry(
+	Node* node, const Entry& entry, unsigned int level)
+{
+	if (node->level == level)
+	{
+		node->entries[node->count++] = entry;
+	}
+	else
+	{
+		// pick the child needing the least overlap enlargement just above the
+		// leaves and the least volume enlargement further up, as R* does
+		unsigned int best = 0;
+		int64_t bestOverlap = 0, bestEnlargement = 0, bestVolume = 0;
+		for (unsigned int i = 0; i < node->count; i++)
+		{
+			const BoundingBox<short>& box = node->entries[i].box;
+			BoundingBox<short> grown = GetUnionBox(box, entry.box);
+			int64_t volume = GetBoxVolume(box);
+			int64_t enlargement = GetBoxVolume(grown) - volume;
+			int64_t overlap = 0;
+			if (node->level == 1)
+			{
+				for (unsigned int j = 0; j < node->count; j++)
+				{
+					if (j != i)
+					{
+						overlap += GetOverlapVolume(grown, node->entries[j].box) -
+							GetOverlapVolume(box, node->entries[j].box);
+					}
+				}
+			}
+
+			if (i == 0 || overlap < bestOverlap ||
+				(overlap == bestOverlap && (enlargement < bestEnlargement ||
+				(enlargement == bestEnlargement && volume < bestVolume))))
+			{
+				best = i;
+				bestOverlap = overlap;
+				bestEnlargement = enlargement;
+				bestVolume = volume;
+			}
+		}
+
+		Entry& child = node->entries[best];
+		Node* sibling = InsertEntry(child.child, entry, level);
+		if (sibling)
+		{
+			child.box = GetNodeBox(child.child);
+			node->entries[node->count].box = GetNodeBox(sibling);
+			node->entries[node->count].child = sibling;
+			node->count++;
+		}
+		else child.box.GrowToContain(entry.box);
+	}
+
+	return node->count > MaxEntries ? SplitNode(node) : nullptr;
+}
+
+SpatialAreaStore::Node* SpatialAreaStore::SplitNode(Node* node)
+{
+	// R* split: choose the axis whose distributions have the smallest
+	// margins, then the distribution along it with the least overlap
+	const unsigned int count = node->count;
+	Entry* entries = node->entries;
+	BoundingBox<short> lower[MaxEntries + 1], upper[MaxEntries + 1];
+	auto SortEntries = [entries, count](int axis, bool byMax)
+	{
+		std::sort(entries, entries + count, [axis, byMax](const Entry& a, const Entry& b)
+		{
+			return byMax ? a.box.mMaxEdge[axis] < b.box.mMaxEdge[axis] :
+				a.box.mMinEdge[axis] < b.box.mMinEdge[axis];
+		});
+	};
+	auto SweepEntries = [&]()
+	{
+		lower[0] = entries[0].box;
+		for (unsigned int i = 1; i < count; i++)
+			lower[i] = GetUnionBox(lower[i - 1], entries[i].box);
+		upper[count - 1] = entries[count - 1].box;
+		for (unsigned int i = count - 1; i-- > 0;)
+			upper[i] = GetUnionBox(upper[i + 1], entries[i].box);
+	};
+
+	int bestAxis = 0;
+	int64_t bestMargin = 0;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		int64_t margin = 0;
+		for (int byMax = 0; byMax < 2; byMax++)
+		{
+			SortEntries(axis, byMax != 0);
+			SweepEntries();
+			for (unsigned int k = MinEntries; k <= count - MinEntries; k++)
+				margin += GetBoxMargin(lower[k - 1]) + GetBoxMargin(upper[k]);
+		}
+		if (axis == 0 || margin < bestMargin)
+		{
+			bestAxis = axis;
+			bestMargin = margin;
+		}
+	}
+
+	bool bestByMax = false;
+	unsigned int bestSplit = MinEntries;
+	int64_t bestOverlap = -1, bestVolume = 0;
+	for (int byMax = 0; byMax < 2; byMax++)
+	{
+		SortEntries(bestAxis, byMax != 0);
+		SweepEntries();
+		for (unsigned int k = MinEntries; k <= count - MinEntries; k++)
+		{
+			int64_t overlap = GetOverlapVolume(lower[k - 1], upper[k]);
+			int64_t volume = GetBoxVolume(lower[k - 1]) + GetBoxVolume(upper[k]);
+			if (bestOverlap < 0 || overlap < bestOverlap ||
+				(overlap == bestOverlap && volume < bestVolume))
+			{
+				bestByMax = byMax != 0;
+				bestSplit = k;
+				bestOverlap = overlap;
+				bestVolume = volume;
+			}
+		}
+	}
+
+	SortEntries(bestAxis, bestByMax);
+	Node* sibling = new Node();
+	sibling->level = node->level;
+	for (unsigned int i = bestSplit; i < count; i++)
+		sibling->entries[sibling->count++] = entries[i];
+	node->count = bestSplit;
+	return sibling;
+}
+
+bool SpatialAreaStore::RemoveEntry(Node* node, Area* area, std::vector<Area*>& orphans)
+{
+	if (node->level == 0)
+	{
+		for (unsigned int i = 0; i < node->count; i++)
+		{
+			if (node->entries[i].area == area)
+			{
+				node->entries[i] = node->entries[--node->count];
+				return true;
+			}
+		}
+		return false;
+	}
+
+	for (unsigned int i = 0; i < node->count; i++)
+	{
+		Entry& child = node->entries[i];
+		if (!area->box.IsFullInside(child.box) || !RemoveEntry(child.child, area, orphans))
+			continue;
+
+		if (child.child->count < MinEntries)
+		{
+			// dissolve the underfull child, its areas are inserted again
+			CollectAreas(child.child, orphans);
+			DeleteNode(child.child);
+			node->entries[i] = node->entries[--node->count];
+		}
+		else child.box = GetNodeBox(child.child);
+		return true;
+	}
+	return false;
+}
+
+void SpatialAreaStore::BulkLoad()
+{
+	DeleteNode(mRoot);
+
+	std::vector<Entry> entries;
+	entries.reserve(mAreasMap.size());
+	for (auto& it : mAreasMap)
+	{
+		Entry entry;
+		entry.box = it.second.box;
+		entry.area = &it.second;
+		entries.push_back(entry);
+	}
+
+	// Sort-Tile-Recursive: tile the entries into slabs along x, the slabs
+	// into runs along y and pack each run in z order, one level at a time.
+	// Each axis gets a number of slices in proportion to its extent, so
+	// that areas spread over a flat world give square rather than slab
+	// shaped nodes.
+	unsigned int level = 0;
+	do
+	{
+		size_t nodeCount = (entries.size() + MaxEntries - 1) / MaxEntries;
+		double extent[3];
+		for (int i = 0; i < 3; i++)
+		{
+			int minCenter = INT_MAX, maxCenter = INT_MIN;
+			for (const Entry& entry : entries)
+			{
+				int center = entry.box.mMinEdge[i] + entry.box.mMaxEdge[i];
+				minCenter = std::min(minCenter, center);
+				maxCenter = std::max(maxCenter, center);
+			}
+			extent[i] = entries.empty() ? 1.0 : maxCenter - minCenter + 1.0;
+		}
+		double scale = std::cbrt(nodeCount / (extent[0] * extent[1] * extent[2]));
+		size_t slicesX = std::max((size_t)std::ceil(extent[0] * scale), (size_t)1);
+		size_t slicesY = std::max((size_t)std::ceil(extent[1] * scale), (size_t)1);
+		// slabs and runs hold whole nodes
+		auto RoundToNodes = [](size_t count, size_t slices)
+		{
+			size_t nodes = ((count + slices - 1) / slices + MaxEntries - 1) / MaxEntries;
+			return std::max(nodes, (size_t)1) * MaxEntries;
+		};
+		size_t slabSize = RoundToNodes(entries.size(), slicesX);
+		auto SortEntries = [](std::vector<Entry>::iterator first, std::vector<Entry>::iterator last, int axis)
+		{
+			std::sort(first, last, [axis](const Entry& a, const Entry& b)
+			{
+				return a.box.mMinEdge[axis] + a.box.mMaxEdge[axis] <
+					b.box.mMinEdge[axis] + b.box.mMaxEdge[axis];
+			});
+		};
+
+		std::vector<Entry> parents;
+		parents.reserve(nodeCount);
+		SortEntries(entries.begin(), entries.end(), 0);
+		for (size_t slab = 0; slab < entries.size(); slab += slabSize)
+		{
+			size_t slabEnd = std::min(slab + slabSize, entries.size());
+			size_t runSize = RoundToNodes(slabEnd - slab, slicesY);
+			SortEntries(entries.begin() + slab, entries.begin() + slabEnd, 1);
+			for (size_t run = slab; run < slabEnd; run += runSize)
+			{
+				size_t runEnd = std::min(run + runSize, slabEnd);
+				SortEntries(entries.begin() + run, entries.begin() + runEnd, 2);
+				for (size_t first = run; first < runEnd; first += MaxEntries)
+				{
+					Node* node = new Node();
+					node->level = level;
+					for (size_t i = first; i < std::min(first + MaxEntries, runEnd); i++)
+						node->entries[node->count++] = entries[i];
+
+					Entry parent;
+					parent.box = GetNodeBox(node);
+					parent.child = node;
+					parents.push_back(parent);
+				}
+			}
+		}
+		entries.swap(parents);
+		level++;
+	} while (entries.size() > 1);
+
+	mRoot = entries.empty() ? new Node() : entries[0].child;
+}
+
+void SpatialAreaStore::GetAreasForPositionImpl(std::vector<Area*>* result, Vector3<short> pos)
+{
+	SearchPosition(mRoot, pos, result);
+}
+
+void SpatialAreaStore::GetAreasInArea(std::vector<Area*>* result,
+	BoundingBox<short> box, bool acceptOverlap)
+{
+	SearchArea(mRoot, box, acceptOverlap, result);
+}
+
+void SpatialAreaStore::SearchPosition(
+	const Node* node, const Vector3<short>& pos, std::vector<Area*>* result)
+{
+	for (unsigned int i = 0; i < node->count; i++)
+	{
+		const Entry& entry = node->entries[i];
+		if (!entry.box.IsPointInside(pos))
+			continue;
+
+		if (node->level == 0)
+			result->push_back(entry.area);
+		else
+			SearchPosition(entry.child, pos, result);
+	}
+}
+
+void SpatialAreaStore::SearchArea(const Node* node, const BoundingBox<short>& box,
+	bool acceptOverlap, std::vector<Area*>* result)
+{
+	for (unsigned int i = 0; i < node->count; i++)
+	{
+		const Entry& entry = node->entries[i];
+		if (node->level > 0)
+		{
+			if (entry.box.Intersect(box))
+				SearchArea(entry.child, box, acceptOverlap, result);
+		}
+		else if (acceptOverlap ? entry.box.Intersect(box) : entry.box.IsFullInside(box))
+		{
+			result->push_back(entry.area);
+		}
+	}
+}
+
+void SpatialAreaStore::CollectAreas(const Node* node, std::vector<Area*>& areas)
+{
+	for (unsigned int i = 0; i < node->count; i++)
+	{
+		if (node->level == 0)
+			areas.push_back(node->entries[i].area);
+		else
+			CollectAreas(node->entries[i].child, areas);
+	}
+}
+
+void SpatialAreaStore::DeleteNode(Node* node)
+{
+	if (node->level > 0)
+		for (unsigned int i = 0; i < node->count; i++)
+			DeleteNode(node->entries[i].child);
+	delete node;
 }
\ No newline at end of file
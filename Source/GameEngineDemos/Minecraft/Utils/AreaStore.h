@@ -72,6 +72,10 @@ public:
 	/// @return Whether the area insertion was successful.
 	virtual bool InsertArea(Area* area) = 0;
 
+	/// Add several areas to the store at once, which lets implementations
+	/// build their index in bulk. Areas whose name is taken are skipped.
+	virtual void InsertAreas(std::vector<Area>& areas);
+
 	/// Removes an area from the store by ID.
 	/// @return Whether the area was in the store and removed.
 	virtual bool RemoveArea(const std::string& name) = 0;
@@ -93,7 +97,8 @@ public:
 	/// or NULL if it doesn't exist.
 	const Area* GetArea(const std::string& name) const;
 
-	/// Serializes the store's areas to a binary ostream.
+	/// Serializes the store's areas to an ostream, in the text format
+	/// read by Deserialize.
 	void Serialize(std::ostream& os) const;
 
 	/// Deserializes the Areas from a binary istream.
@@ -146,4 +151,66 @@ private:
 	std::vector<Area*> mAreas;
 };
 
+
+/// AreaStore indexed by an R*-tree. Areas added in bulk are packed with the
+/// Sort-Tile-Recursive algorithm, single insertions and removals update the
+/// tree in place.
+class SpatialAreaStore : public AreaStore
+{
+public:
+	SpatialAreaStore();
+	virtual ~SpatialAreaStore();
+
+	virtual bool InsertArea(Area* area);
+	virtual void InsertAreas(std::vector<Area>& areas);
+	virtual bool RemoveArea(const std::string& name);
+	virtual void GetAreasInArea(std::vector<Area*>* result,
+		BoundingBox<short> box, bool acceptOverlap);
+
+protected:
+	virtual void GetAreasForPositionImpl(std::vector<Area*>* result, Vector3<short> pos);
+
+private:
+	static const unsigned int MaxEntries = 16;
+	static const unsigned int MinEntries = 6;
+
+	struct Node;
+
+	struct Entry
+	{
+		BoundingBox<short> box;
+		union
+		{
+			Node* child;
+			Area* area;
+		};
+	};
+
+	struct Node
+	{
+		// leaves are at level 0 and hold the areas
+		unsigned int level = 0;
+		unsigned int count = 0;
+		// the spare entry holds the overflow until the node is split
+		Entry entries[MaxEntries + 1];
+	};
+
+	static BoundingBox<short> GetNodeBox(const Node* node);
+
+	void InsertLeafEntry(Area* area);
+	Node* InsertEntry(Node* node, const Entry& entry, unsigned int level);
+	Node* SplitNode(Node* node);
+	bool RemoveEntry(Node* node, Area* area, std::vector<Area*>& orphans);
+	void BulkLoad();
+
+	void SearchPosition(const Node* node, const Vector3<short>& pos, std::vector<Area*>* result);
+	void SearchArea(const Node* node, const BoundingBox<short>& box,
+		bool acceptOverlap, std::vector<Area*>* result);
+
+	void CollectAreas(const Node* node, std::vector<Area*>& areas);
+	void DeleteNode(Node* node);
+
+	Node* mRoot;
+};
+
 #endif
\ No newline at end of file
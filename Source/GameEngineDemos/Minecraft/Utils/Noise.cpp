@@ -28,23 +28,22 @@
 #include "Util.h"
 
 #include "Core/Logger/Logger.h"
+#include "Core/Threading/TaskScheduler.h"
 
 #include "Mathematic/Function/Functions.h"
 
+#include "Application/Settings.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define NOISE_SSE2
+#endif
+
 #define NOISE_MAGIC_X    1619
 #define NOISE_MAGIC_Y    31337
 #define NOISE_MAGIC_Z    52591
 #define NOISE_MAGIC_SEED 1013
 
-typedef float (*Interp2dFxn)(
-		float v00, float v10, float v01, float v11,
-		float x, float y);
-
-typedef float (*Interp3dFxn)(
-		float v000, float v100, float v010, float v110,
-		float v001, float v101, float v011, float v111,
-		float x, float y, float z);
-
 FlagDescription FlagdescNoiseparams[] = {
 	{"defaults",    NOISE_FLAG_DEFAULTS},
 	{"eased",       NOISE_FLAG_EASED},
@@ -59,23 +58,26 @@ float EaseCurve(float t)
     return t * t * t * (t * (6.f * t - 15.f) + 10.f);
 }
 
-float Noise2d(int x, int y, int seed)
+inline float NoiseHash(unsigned int n)
 {
-	unsigned int n = (NOISE_MAGIC_X * x + NOISE_MAGIC_Y * y
-			+ NOISE_MAGIC_SEED * seed) & 0x7fffffff;
+	n &= 0x7fffffff;
 	n = (n >> 13) ^ n;
 	n = (n * (n * n * 60493 + 19990303) + 1376312589) & 0x7fffffff;
 	return 1.f - (float)(int)n / 0x40000000;
 }
 
 
+float Noise2d(int x, int y, int seed)
+{
+	return NoiseHash(NOISE_MAGIC_X * (unsigned int)x + NOISE_MAGIC_Y * (unsigned int)y
+			+ NOISE_MAGIC_SEED * (unsigned int)seed);
+}
+
+
 float Noise3d(int x, int y, int z, int seed)
 {
-	unsigned int n = (NOISE_MAGIC_X * x + NOISE_MAGIC_Y * y + NOISE_MAGIC_Z * z
-			+ NOISE_MAGIC_SEED * seed) & 0x7fffffff;
-	n = (n >> 13) ^ n;
-	n = (n * (n * n * 60493 + 19990303) + 1376312589) & 0x7fffffff;
-	return 1.f - (float)(int)n / 0x40000000;
+	return NoiseHash(NOISE_MAGIC_X * (unsigned int)x + NOISE_MAGIC_Y * (unsigned int)y
+			+ NOISE_MAGIC_Z * (unsigned int)z + NOISE_MAGIC_SEED * (unsigned int)seed);
 }
 
 
@@ -137,6 +139,102 @@ float TriLinearInterpolationNoEase(
 	return LinearInterpolation(u, v, z);
 }
 
+/*
+ * Row kernels of the noise maps. They run the same float operations in the same
+ * order as Noise2d, Noise3d and the interpolation functions above, so the maps
+ * stay bit identical to the single point noise whichever path is taken.
+ */
+#if defined(NOISE_SSE2)
+inline __m128i MultiplyLow(__m128i a, __m128i b)
+{
+	__m128i even = _mm_mul_epu32(a, b);
+	__m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_unpacklo_epi32(
+		_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+		_mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+#endif
+
+// Fills count lattice points along x, n being the hash input of the first point
+void NoiseLatticeRow(float* dst, unsigned int count, unsigned int n)
+{
+	unsigned int i = 0;
+#if defined(NOISE_SSE2)
+	const __m128i mask = _mm_set1_epi32(0x7fffffff);
+	const __m128i stepX = _mm_set1_epi32(4 * NOISE_MAGIC_X);
+	__m128i hash = _mm_add_epi32(_mm_set1_epi32((int)n),
+		_mm_setr_epi32(0, NOISE_MAGIC_X, 2 * NOISE_MAGIC_X, 3 * NOISE_MAGIC_X));
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i h = _mm_and_si128(hash, mask);
+		h = _mm_xor_si128(_mm_srli_epi32(h, 13), h);
+		__m128i p = MultiplyLow(MultiplyLow(h, h), _mm_set1_epi32(60493));
+		p = MultiplyLow(h, _mm_add_epi32(p, _mm_set1_epi32(19990303)));
+		p = _mm_and_si128(_mm_add_epi32(p, _mm_set1_epi32(1376312589)), mask);
+
+		// dividing by 2^30 is exact, so is multiplying by its inverse
+		__m128 value = _mm_mul_ps(_mm_cvtepi32_ps(p), _mm_set1_ps(1.f / 0x40000000));
+		_mm_storeu_ps(dst + i, _mm_sub_ps(_mm_set1_ps(1.f), value));
+		hash = _mm_add_epi32(hash, stepX);
+	}
+	n += i * NOISE_MAGIC_X;
+#endif
+	for (; i < count; i++, n += NOISE_MAGIC_X)
+		dst[i] = NoiseHash(n);
+}
+
+// Interpolates a lattice row along x, every column has its lattice cell and weight
+void NoiseLine(float* dst, const float* lattice,
+	const unsigned int* cells, const float* tx, unsigned int count)
+{
+	for (unsigned int i = 0; i != count; i++)
+		dst[i] = LinearInterpolation(lattice[cells[i]], lattice[cells[i] + 1], tx[i]);
+}
+
+// Interpolates between two lines
+void NoiseRow(float* dst, const float* v0, const float* v1, float ty, unsigned int count)
+{
+	unsigned int i = 0;
+#if defined(NOISE_SSE2)
+	const __m128 t = _mm_set1_ps(ty);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 a = _mm_loadu_ps(v0 + i);
+		__m128 b = _mm_loadu_ps(v1 + i);
+		_mm_storeu_ps(dst + i, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t)));
+	}
+#endif
+	for (; i != count; i++)
+		dst[i] = LinearInterpolation(v0[i], v1[i], ty);
+}
+
+// Interpolates between four lines, along y first and then along z
+void NoiseRow(float* dst, const float* v00, const float* v10,
+	const float* v01, const float* v11, float ty, float tz, unsigned int count)
+{
+	unsigned int i = 0;
+#if defined(NOISE_SSE2)
+	const __m128 t = _mm_set1_ps(ty);
+	const __m128 s = _mm_set1_ps(tz);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 a = _mm_loadu_ps(v00 + i);
+		__m128 b = _mm_loadu_ps(v10 + i);
+		__m128 c = _mm_loadu_ps(v01 + i);
+		__m128 d = _mm_loadu_ps(v11 + i);
+		__m128 u = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+		__m128 v = _mm_add_ps(c, _mm_mul_ps(_mm_sub_ps(d, c), t));
+		_mm_storeu_ps(dst + i, _mm_add_ps(u, _mm_mul_ps(_mm_sub_ps(v, u), s)));
+	}
+#endif
+	for (; i != count; i++)
+	{
+		float u = LinearInterpolation(v00[i], v10[i], ty);
+		float v = LinearInterpolation(v01[i], v11[i], ty);
+		dst[i] = LinearInterpolation(u, v, tz);
+	}
+}
+
 float Noise2dGradient(float x, float y, int seed, bool eased)
 {
 	// Calculate the integer coordinates
@@ -332,6 +430,9 @@ Noise::Noise(const NoiseParams* np, int seed, unsigned int sx, unsigned int sy,
 	this->mSizeY = sy;
 	this->mSizeZ = sz;
 
+	if (Settings::Get()->Exists("mapgen_parallel_noise"))
+		mParallelSlabs = Settings::Get()->GetBool("mapgen_parallel_noise");
+
 	AllocBuffers();
 }
 
@@ -342,6 +443,9 @@ Noise::~Noise()
 	delete[] mPersistBuf;
 	delete[] mNoiseBuf;
 	delete[] mResult;
+	delete[] mLineBuf;
+	delete[] mStepBuf;
+	delete[] mCellBuf;
 }
 
 
@@ -360,13 +464,18 @@ void Noise::AllocBuffers()
 	delete[] mGradientBuf;
 	delete[] mPersistBuf;
 	delete[] mResult;
+	delete[] mStepBuf;
+	delete[] mCellBuf;
 
 	try
     {
 		size_t bufsize = mSizeX * mSizeY * mSizeZ;
+		size_t stepsize = mSizeX + mSizeY + mSizeZ;
 		this->mPersistBuf  = NULL;
 		this->mGradientBuf = new float[bufsize];
 		this->mResult = new float[bufsize];
+		this->mStepBuf = new float[stepsize];
+		this->mCellBuf = new unsigned int[stepsize];
 	} 
     catch (std::bad_alloc&) 
     {
@@ -436,9 +545,11 @@ void Noise::ResizeNoiseBuf(bool is3d)
 	size_t nlz = is3d ? (size_t)Function<float>::Ceil(numNoisePointsZ) + 3 : 1;
 
 	delete[] mNoiseBuf;
+	delete[] mLineBuf;
 	try 
     {
 		mNoiseBuf = new float[nlx * nly * nlz];
+		mLineBuf = new float[nly * nlz * mSizeX];
 	} 
     catch (std::bad_alloc&) 
     {
@@ -448,69 +559,62 @@ void Noise::ResizeNoiseBuf(bool is3d)
 
 
 /*
- * NB:  This algorithm is not optimal in terms of space complexity.  The entire
- * integer lattice of noise points could be done as 2 lines instead, and for 3D,
- * 2 lines + 2 planes.
- * However, this would require the noise calls to be interposed with the
- * interpolation loops, which may trash the icache, leading to lower overall
- * performance.
- * Another optimization that could save half as many noise calls is to carry over
- * values from the previous noise lattice as midpoints in the new lattice for the
- * next octave.
+ * The lattice cell and the interpolation weight of a column only depend on x, so
+ * every lattice row is interpolated along x once into a line of mSizeX values.
+ * The rows of the map then interpolate between the two (four in 3D) lines of their
+ * lattice cell, which are contiguous arrays the row kernels go through in SIMD.
+ * Every value still goes through the same operations, in the same order, as the
+ * per point interpolation functions did.
  */
-#define idx(x, y) ((y) * nlx + (x))
 void Noise::GradientMap2D(float x, float y, float stepX, float stepY, int seed)
 {
-	float v00, v01, v10, v11, u, v, origU;
-	unsigned int index, i, j, noisex, noisey;
+	float u, v;
+	unsigned int i, j, noisex, noisey;
 	unsigned int nlx, nly;
 	int x0, y0;
 
 	bool eased = mNoiseParams.flags & (NOISE_FLAG_DEFAULTS | NOISE_FLAG_EASED);
-	Interp2dFxn Interpolate = eased ?
-		BiLinearInterpolation : BiLinearInterpolationNoEase;
 
 	x0 = (int)Function<float>::Floor(x);
 	y0 = (int)Function<float>::Floor(y);
 	u = x - (float)x0;
 	v = y - (float)y0;
-	origU = u;
 
 	//calculate noise point lattice
 	nlx = (unsigned int)(u + mSizeX * stepX) + 2;
 	nly = (unsigned int)(v + mSizeY * stepY) + 2;
-	index = 0;
 	for (j = 0; j != nly; j++)
-		for (i = 0; i != nlx; i++)
-			mNoiseBuf[index++] = Noise2d(x0 + i, y0 + j, seed);
+	{
+		NoiseLatticeRow(&mNoiseBuf[j * nlx], nlx, NOISE_MAGIC_X * (unsigned int)x0 +
+			NOISE_MAGIC_Y * (unsigned int)(y0 + j) + NOISE_MAGIC_SEED * (unsigned int)seed);
+	}
+
+	//calculate column cells and weights
+	float* tx = mStepBuf;
+	unsigned int* cellx = mCellBuf;
+	noisex = 0;
+	for (i = 0; i != mSizeX; i++)
+	{
+		tx[i] = eased ? EaseCurve(u) : u;
+		cellx[i] = noisex;
+
+		u += stepX;
+		if (u >= 1.0)
+		{
+			u -= 1.0;
+			noisex++;
+		}
+	}
 
 	//calculate interpolations
-	index  = 0;
+	for (j = 0; j != nly; j++)
+		NoiseLine(&mLineBuf[j * mSizeX], &mNoiseBuf[j * nlx], cellx, tx, mSizeX);
+
 	noisey = 0;
 	for (j = 0; j != mSizeY; j++) 
     {
-		v00 = mNoiseBuf[idx(0, noisey)];
-		v10 = mNoiseBuf[idx(1, noisey)];
-		v01 = mNoiseBuf[idx(0, noisey + 1)];
-		v11 = mNoiseBuf[idx(1, noisey + 1)];
-
-		u = origU;
-		noisex = 0;
-		for (i = 0; i != mSizeX; i++) 
-        {
-			mGradientBuf[index++] = Interpolate(v00, v10, v01, v11, u, v);
-
-			u += stepX;
-			if (u >= 1.0) 
-            {
-				u -= 1.0;
-				noisex++;
-				v00 = v10;
-				v01 = v11;
-				v10 = mNoiseBuf[idx(noisex + 1, noisey)];
-				v11 = mNoiseBuf[idx(noisex + 1, noisey + 1)];
-			}
-		}
+		NoiseRow(&mGradientBuf[j * mSizeX], &mLineBuf[noisey * mSizeX],
+			&mLineBuf[(noisey + 1) * mSizeX], eased ? EaseCurve(v) : v, mSizeX);
 
 		v += stepY;
 		if (v >= 1.0) {
@@ -519,21 +623,16 @@ void Noise::GradientMap2D(float x, float y, float stepX, float stepY, int seed)
 		}
 	}
 }
-#undef idx
 
 
-#define idx(x, y, z) ((z) * nly * nlx + (y) * nlx + (x))
 void Noise::GradientMap3D(float x, float y, float z, float stepX, float stepY, float stepZ, int seed)
 {
-	float v000, v010, v100, v110;
-	float v001, v011, v101, v111;
-	float u, v, w, origU, origV;
-	unsigned int index, i, j, k, noisex, noisey, noisez;
+	float u, v, w;
+	unsigned int i, j, k, noisex, noisey, noisez;
 	unsigned int nlx, nly, nlz;
 	int x0, y0, z0;
 
-	Interp3dFxn Interpolate = (mNoiseParams.flags & NOISE_FLAG_EASED) ?
-		TriLinearInterpolation : TriLinearInterpolationNoEase;
+	bool eased = (mNoiseParams.flags & NOISE_FLAG_EASED) != 0;
 
 	x0 = (int)Function<float>::Floor(x);
 	y0 = (int)Function<float>::Floor(y);
@@ -541,80 +640,98 @@ void Noise::GradientMap3D(float x, float y, float z, float stepX, float stepY, f
 	u = x - (float)x0;
 	v = y - (float)y0;
 	w = z - (float)z0;
-	origU = u;
-	origV = v;
 
 	//calculate noise point lattice
 	nlx = (unsigned int)(u + mSizeX * stepX) + 2;
 	nly = (unsigned int)(v + mSizeY * stepY) + 2;
 	nlz = (unsigned int)(w + mSizeZ * stepZ) + 2;
-	index = 0;
 	for (k = 0; k != nlz; k++)
+	{
 		for (j = 0; j != nly; j++)
-			for (i = 0; i != nlx; i++)
-				mNoiseBuf[index++] = Noise3d(x0 + i, y0 + j, z0 + k, seed);
+		{
+			NoiseLatticeRow(&mNoiseBuf[(k * nly + j) * nlx], nlx,
+				NOISE_MAGIC_X * (unsigned int)x0 + NOISE_MAGIC_Y * (unsigned int)(y0 + j) +
+				NOISE_MAGIC_Z * (unsigned int)(z0 + k) + NOISE_MAGIC_SEED * (unsigned int)seed);
+		}
+	}
+
+	//calculate column, row and slab cells and weights
+	float* tx = mStepBuf;
+	float* ty = tx + mSizeX;
+	float* tz = ty + mSizeY;
+	unsigned int* cellx = mCellBuf;
+	unsigned int* celly = cellx + mSizeX;
+	unsigned int* cellz = celly + mSizeY;
+	noisex = 0;
+	for (i = 0; i != mSizeX; i++)
+	{
+		tx[i] = eased ? EaseCurve(u) : u;
+		cellx[i] = noisex;
+
+		u += stepX;
+		if (u >= 1.0)
+		{
+			u -= 1.0;
+			noisex++;
+		}
+	}
 
-	//calculate interpolations
-	index  = 0;
 	noisey = 0;
-	noisez = 0;
-	for (k = 0; k != mSizeZ; k++) 
-    {
-		v = origV;
-		noisey = 0;
-		for (j = 0; j != mSizeY; j++) 
-        {
-			v000 = mNoiseBuf[idx(0, noisey,     noisez)];
-			v100 = mNoiseBuf[idx(1, noisey,     noisez)];
-			v010 = mNoiseBuf[idx(0, noisey + 1, noisez)];
-			v110 = mNoiseBuf[idx(1, noisey + 1, noisez)];
-			v001 = mNoiseBuf[idx(0, noisey,     noisez + 1)];
-			v101 = mNoiseBuf[idx(1, noisey,     noisez + 1)];
-			v011 = mNoiseBuf[idx(0, noisey + 1, noisez + 1)];
-			v111 = mNoiseBuf[idx(1, noisey + 1, noisez + 1)];
-
-			u = origU;
-			noisex = 0;
-			for (i = 0; i != mSizeX; i++) 
-            {
-				mGradientBuf[index++] = Interpolate(
-					v000, v100, v010, v110,
-					v001, v101, v011, v111,
-					u, v, w);
-
-				u += stepX;
-				if (u >= 1.0) 
-                {
-					u -= 1.0;
-					noisex++;
-					v000 = v100;
-					v010 = v110;
-					v100 = mNoiseBuf[idx(noisex + 1, noisey,     noisez)];
-					v110 = mNoiseBuf[idx(noisex + 1, noisey + 1, noisez)];
-					v001 = v101;
-					v011 = v111;
-					v101 = mNoiseBuf[idx(noisex + 1, noisey,     noisez + 1)];
-					v111 = mNoiseBuf[idx(noisex + 1, noisey + 1, noisez + 1)];
-				}
-			}
+	for (j = 0; j != mSizeY; j++)
+	{
+		ty[j] = eased ? EaseCurve(v) : v;
+		celly[j] = noisey;
 
-			v += stepY;
-			if (v >= 1.0) 
-            {
-				v -= 1.0;
-				noisey++;
-			}
+		v += stepY;
+		if (v >= 1.0)
+		{
+			v -= 1.0;
+			noisey++;
 		}
+	}
+
+	noisez = 0;
+	for (k = 0; k != mSizeZ; k++)
+	{
+		tz[k] = eased ? EaseCurve(w) : w;
+		cellz[k] = noisez;
 
 		w += stepZ;
-		if (w >= 1.0) 
-        {
+		if (w >= 1.0)
+		{
 			w -= 1.0;
 			noisez++;
 		}
 	}
+
+	//calculate interpolations
+	for (j = 0; j != nly * nlz; j++)
+		NoiseLine(&mLineBuf[j * mSizeX], &mNoiseBuf[j * nlx], cellx, tx, mSizeX);
+
+	auto InterpolateSlab = [&](unsigned int slab)
+	{
+		const float* line0 = &mLineBuf[cellz[slab] * nly * mSizeX];
+		const float* line1 = line0 + nly * mSizeX;
+		for (unsigned int row = 0; row != mSizeY; row++)
+		{
+			size_t offset = celly[row] * mSizeX;
+			NoiseRow(&mGradientBuf[(slab * mSizeY + row) * mSizeX],
+				line0 + offset, line0 + offset + mSizeX,
+				line1 + offset, line1 + offset + mSizeX,
+				ty[row], tz[slab], mSizeX);
+		}
+	};
+
+	if (mParallelSlabs)
+	{
+		ParallelFor(0u, mSizeZ, InterpolateSlab);
+	}
+	else
+	{
+		for (k = 0; k != mSizeZ; k++)
+			InterpolateSlab(k);
+	}
 }
-#undef idx
 
 
 float* Noise::PerlinMap2D(float x, float y, float *persistenceMap)
@@ -83,6 +83,9 @@ public:
 	float* mPersistBuf = nullptr;
 	float* mResult = nullptr;
 
+	// evaluates the slabs of the 3D maps on the task scheduler (mapgen_parallel_noise)
+	bool mParallelSlabs = false;
+
 	Noise(const NoiseParams* np, int seed, 
         unsigned int sx, unsigned int sy, unsigned int sz=1);
 	~Noise();
@@ -121,6 +124,11 @@ private:
 	void ResizeNoiseBuf(bool is3d);
 	void UpdateResults(float g, float* gmap, const float* persistenceMap, size_t bufsize);
 
+	// lattice rows interpolated along x, one line of mSizeX values per lattice row
+	float* mLineBuf = nullptr;
+	// interpolation weights and lattice cells of the columns, rows and slabs of the map
+	float* mStepBuf = nullptr;
+	unsigned int* mCellBuf = nullptr;
 };
 
 float NoisePerlin2D(const NoiseParams* np, float x, float y, int seed);
@@ -1852,9 +1852,11 @@ void QuakeLogic::CreateNetworkEventForwarder(const int socketId)
 	pGlobalEventManager->AddListener(
 		MakeDelegate(pNetworkEventForwarder, &NetworkEventForwarder::ForwardEvent), 
 		EventDataNewActor::skEventType);
-	pGlobalEventManager->AddListener(
-		MakeDelegate(pNetworkEventForwarder, &NetworkEventForwarder::ForwardEvent),
-		EventDataSyncActor::skEventType);
+	// actor transforms are replicated through the network view snapshots when enabled
+	if (!NetworkGameView::IsSnapshotReplicationEnabled())
+		pGlobalEventManager->AddListener(
+			MakeDelegate(pNetworkEventForwarder, &NetworkEventForwarder::ForwardEvent),
+			EventDataSyncActor::skEventType);
 	pGlobalEventManager->AddListener(
 		MakeDelegate(pNetworkEventForwarder, &NetworkEventForwarder::ForwardEvent), 
 		EventDataRequestNewActor::skEventType);